@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExactPointMerger.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares vtkExactPointMerger against inserting the same points in order
+// into vtkMergePoints.
+
+#include "vtkExactPointMerger.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+
+namespace
+{
+int TestPoints(vtkPoints* points, const char* name)
+{
+  vtkNew<vtkPoints> expected;
+  expected->SetDataType(points->GetDataType());
+  vtkNew<vtkMergePoints> locator;
+  locator->InitPointInsertion(expected.GetPointer(), points->GetBounds());
+  vtkIdType numPts = points->GetNumberOfPoints();
+  vtkNew<vtkIdTypeArray> expectedMap;
+  expectedMap->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    vtkIdType id;
+    locator->InsertUniquePoint(points->GetPoint(i), id);
+    expectedMap->SetValue(i, id);
+    }
+
+  vtkNew<vtkExactPointMerger> merger;
+  vtkNew<vtkPoints> merged;
+  vtkNew<vtkIdTypeArray> map;
+  vtkIdType numUnique = merger->MergePoints(points, merged.GetPointer(),
+                                            map.GetPointer());
+  if (numUnique != expected->GetNumberOfPoints() ||
+      merged->GetNumberOfPoints() != numUnique ||
+      merged->GetDataType() != points->GetDataType() ||
+      map->GetNumberOfTuples() != numPts)
+    {
+    cerr << name << ": expected " << expected->GetNumberOfPoints()
+         << " unique points, got " << numUnique << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    if (map->GetValue(i) != expectedMap->GetValue(i))
+      {
+      cerr << name << ": point " << i << " maps to " << map->GetValue(i)
+           << " instead of " << expectedMap->GetValue(i) << endl;
+      return 0;
+      }
+    }
+  for (vtkIdType i = 0; i < numUnique; ++i)
+    {
+    double x[3], y[3];
+    merged->GetPoint(i, x);
+    expected->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      cerr << name << ": wrong coordinates for merged point " << i << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Points on a coarse lattice, so that most of them are repeated many times.
+void FillPoints(vtkPoints* points, vtkIdType numPts)
+{
+  points->SetNumberOfPoints(numPts);
+  unsigned int seed = 12345;
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+      {
+      seed = seed * 1103515245u + 12345u;
+      x[j] = 0.25 * static_cast<int>((seed >> 16) % 61) - 7.5;
+      }
+    points->SetPoint(i, x);
+    }
+}
+}
+
+int TestExactPointMerger(int, char*[])
+{
+  int success = 1;
+
+  vtkNew<vtkPoints> empty;
+  success &= TestPoints(empty.GetPointer(), "empty");
+
+  // +0 and -0 are the same point.
+  vtkNew<vtkPoints> zeros;
+  zeros->InsertNextPoint(1.0, -0.0, 2.0);
+  zeros->InsertNextPoint(1.0, 0.0, 2.0);
+  zeros->InsertNextPoint(1.0, 0.0, 2.5);
+  zeros->InsertNextPoint(1.0, -0.0, 2.0);
+  success &= TestPoints(zeros.GetPointer(), "signed zeros");
+
+  // Large enough to be sorted in several blocks and merge rounds.
+  vtkNew<vtkPoints> floats;
+  FillPoints(floats.GetPointer(), 300000);
+  success &= TestPoints(floats.GetPointer(), "float");
+
+  vtkNew<vtkPoints> doubles;
+  doubles->SetDataTypeToDouble();
+  FillPoints(doubles.GetPointer(), 150000);
+  success &= TestPoints(doubles.GetPointer(), "double");
+
+  vtkNew<vtkPoints> ints;
+  ints->SetDataTypeToInt();
+  FillPoints(ints.GetPointer(), 20000);
+  success &= TestPoints(ints.GetPointer(), "int");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,204 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitFunctionBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that evaluating an implicit function over an array of points
+// gives the same values as evaluating it one point at a time.
+
+#include "vtkBox.h"
+#include "vtkCylinder.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImplicitBoolean.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkQuadric.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+
+#include <cmath>
+#include <string>
+
+namespace {
+
+//----------------------------------------------------------------------------
+// Compare the batch values against the single-point values, for the given
+// types of input and output arrays.
+bool CompareBatch(vtkImplicitFunction *func, const char *name,
+                  vtkDataArray *points, vtkDataArray *input,
+                  vtkDataArray *output)
+{
+  vtkIdType n = points->GetNumberOfTuples();
+  input->SetNumberOfComponents(3);
+  input->SetNumberOfTuples(n);
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    input->SetTuple(i, points->GetTuple(i));
+    }
+
+  func->FunctionValue(input, output);
+  if (output->GetNumberOfTuples() != n ||
+      output->GetNumberOfComponents() != 1)
+    {
+    cerr << name << ": output has wrong size for input "
+         << input->GetClassName() << " and output "
+         << output->GetClassName() << "\n";
+    return false;
+    }
+
+  // Put the single-point value through the output array, so that the
+  // same conversion is applied to both values
+  vtkSmartPointer<vtkDataArray> expected;
+  expected.TakeReference(output->NewInstance());
+  expected->SetNumberOfTuples(1);
+
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    double x[3];
+    input->GetTuple(i, x);
+    expected->SetComponent(0, 0, func->FunctionValue(x));
+    double a = expected->GetComponent(0, 0);
+    double b = output->GetComponent(i, 0);
+    double tol = 1e-6*(1.0 + fabs(a));
+    if (fabs(a - b) > tol)
+      {
+      cerr << name << ": value " << b << " should be " << a
+           << " at point " << i << " for input " << input->GetClassName()
+           << " and output " << output->GetClassName() << "\n";
+      return false;
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestFunction(vtkImplicitFunction *func, const char *name,
+                  vtkDataArray *points)
+{
+  bool success = true;
+  for (int i = 0; i < 3; i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      vtkSmartPointer<vtkDataArray> input;
+      vtkSmartPointer<vtkDataArray> output;
+      switch (i)
+        {
+        case 0: input.TakeReference(vtkDoubleArray::New()); break;
+        case 1: input.TakeReference(vtkFloatArray::New()); break;
+        default: input.TakeReference(vtkIntArray::New()); break;
+        }
+      switch (j)
+        {
+        case 0: output.TakeReference(vtkDoubleArray::New()); break;
+        case 1: output.TakeReference(vtkFloatArray::New()); break;
+        default: output.TakeReference(vtkIntArray::New()); break;
+        }
+      success &= CompareBatch(func, name, points, input, output);
+      }
+    }
+  return success;
+}
+
+}
+
+int TestImplicitFunctionBatch(int, char *[])
+{
+  // Enough points for several blocks, with a partial block at the end
+  vtkMath::RandomSeed(7);
+  vtkNew<vtkDoubleArray> points;
+  points->SetNumberOfComponents(3);
+  points->SetNumberOfTuples(5000);
+  for (vtkIdType i = 0; i < 5000; i++)
+    {
+    double x[3];
+    x[0] = vtkMath::Random(-10.0, 10.0);
+    x[1] = vtkMath::Random(-10.0, 10.0);
+    x[2] = vtkMath::Random(-10.0, 10.0);
+    points->SetTuple(i, x);
+    }
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(1.0, 2.0, 3.0);
+  plane->SetNormal(0.5, -1.0, 2.0);
+
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(-1.0, 0.5, 2.0);
+  sphere->SetRadius(4.0);
+
+  vtkNew<vtkBox> box;
+  box->SetBounds(-3.0, 2.0, -4.0, 5.0, -1.0, 6.0);
+
+  vtkNew<vtkQuadric> quadric;
+  quadric->SetCoefficients(0.5, 1.0, 0.2, 0.0, 0.1, 0.0, 0.0, 0.2, 0.0, -1.0);
+
+  vtkNew<vtkCylinder> cylinder;
+  cylinder->SetCenter(0.5, 0.0, -0.5);
+  cylinder->SetRadius(3.0);
+
+  bool success = true;
+  success &= TestFunction(plane.GetPointer(), "vtkPlane", points.GetPointer());
+  success &= TestFunction(sphere.GetPointer(), "vtkSphere",
+                          points.GetPointer());
+  success &= TestFunction(box.GetPointer(), "vtkBox", points.GetPointer());
+  success &= TestFunction(quadric.GetPointer(), "vtkQuadric",
+                          points.GetPointer());
+  success &= TestFunction(cylinder.GetPointer(), "vtkCylinder",
+                          points.GetPointer());
+
+  // Each boolean operation without any functions, which gives zero
+  vtkNew<vtkImplicitBoolean> boolean;
+  for (int op = vtkImplicitBoolean::VTK_UNION;
+       op <= vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES; op++)
+    {
+    boolean->SetOperationType(op);
+    std::string name = "empty ";
+    name += boolean->GetOperationTypeAsString();
+    success &= TestFunction(boolean.GetPointer(), name.c_str(),
+                            points.GetPointer());
+    }
+
+  // Each boolean operation, with a mix of batch and non-batch functions
+  boolean->AddFunction(sphere.GetPointer());
+  boolean->AddFunction(box.GetPointer());
+  boolean->AddFunction(cylinder.GetPointer());
+  for (int op = vtkImplicitBoolean::VTK_UNION;
+       op <= vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES; op++)
+    {
+    boolean->SetOperationType(op);
+    success &= TestFunction(boolean.GetPointer(),
+                            boolean->GetOperationTypeAsString(),
+                            points.GetPointer());
+    }
+
+  // A transform must be applied to the whole batch
+  const double elements[16] = {
+    0.8, -0.6, 0.0, 1.0,
+    0.6, 0.8, 0.0, -2.0,
+    0.0, 0.0, 1.5, 0.5,
+    0.0, 0.0, 0.0, 1.0 };
+  sphere->SetTransform(elements);
+  box->SetTransform(elements);
+  success &= TestFunction(sphere.GetPointer(), "transformed vtkSphere",
+                          points.GetPointer());
+  success &= TestFunction(box.GetPointer(), "transformed vtkBox",
+                          points.GetPointer());
+  boolean->SetOperationTypeToDifference();
+  success &= TestFunction(boolean.GetPointer(), "transformed Difference",
+                          points.GetPointer());
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
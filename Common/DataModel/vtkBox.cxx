@@ -16,10 +16,101 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkBoundingBox.h"
+#include "vtkImplicitFunctionInternals.h"
 #include <cassert>
 
 vtkStandardNewMacro(vtkBox);
 
+namespace {
+
+//----------------------------------------------------------------------------
+// Evaluate box equation. This differs from the similar vtkPlanes
+// (with six planes) because of the "rounded" nature of the corners.
+struct vtkBoxFunction
+{
+  double MinPoint[3];
+  double MaxPoint[3];
+  double Length[3];
+
+  vtkBoxFunction(vtkBoundingBox *bbox)
+  {
+    bbox->GetMinPoint(this->MinPoint[0], this->MinPoint[1], this->MinPoint[2]);
+    bbox->GetMaxPoint(this->MaxPoint[0], this->MaxPoint[1], this->MaxPoint[2]);
+    for (int i=0; i<3; i++)
+      {
+      this->Length[i] = bbox->GetLength(i);
+      }
+  }
+
+  template<class T>
+  double operator()(const T *x) const
+  {
+    double p[3] = { x[0], x[1], x[2] };
+    double diff, dist, minDistance=(-VTK_DOUBLE_MAX), t, distance=0.0;
+    int inside=1;
+    const double *minP = this->MinPoint;
+    const double *maxP = this->MaxPoint;
+
+    for (int i=0; i<3; i++)
+      {
+      diff = this->Length[i];
+      if ( diff != 0.0 )
+        {
+        t = (p[i]-minP[i]) / diff;
+        if ( t < 0.0 )
+          {
+          inside = 0;
+          dist = minP[i] - p[i];
+          }
+        else if ( t > 1.0 )
+          {
+          inside = 0;
+          dist = p[i] - maxP[i];
+          }
+        else
+          {//want negative distance, we are inside
+          if ( t <= 0.5 )
+            {
+            dist = minP[i] - p[i];
+            }
+          else
+            {
+            dist = p[i] - maxP[i];
+            }
+          if ( dist > minDistance ) //remember, it's negative
+            {
+            minDistance = dist;
+            }
+          }//if inside
+        }
+      else
+        {
+        dist = fabs(p[i]-minP[i]);
+        if (dist)
+          {
+          inside = 0;
+          }
+        }
+      if ( dist > 0.0 )
+        {
+        distance += dist*dist;
+        }
+      }//for all coordinate directions
+
+    distance = sqrt(distance);
+    if ( inside )
+      {
+      return minDistance;
+      }
+    else
+      {
+      return distance;
+      }
+  }
+};
+
+}
+
 // Construct the box centered at the origin and each side length 1.0.
 //----------------------------------------------------------------------------
 vtkBox::vtkBox()
@@ -127,70 +218,19 @@ void vtkBox::AddBounds(const double bounds[6])
 
 
 //----------------------------------------------------------------------------
-// Evaluate box equation. This differs from the similar vtkPlanes
-// (with six planes) because of the "rounded" nature of the corners.
+// Evaluate box equation.
 double vtkBox::EvaluateFunction(double x[3])
 {
-  double diff, dist, minDistance=(-VTK_DOUBLE_MAX), t, distance=0.0;
-  int inside=1;
-  const double *minP = this->BBox->GetMinPoint();
-  const double *maxP = this->BBox->GetMaxPoint();
-
-  for (int i=0; i<3; i++)
-    {
-    diff = this->BBox->GetLength(i);
-    if ( diff != 0.0 )
-      {
-      t = (x[i]-minP[i]) / diff;
-      if ( t < 0.0 )
-        {
-        inside = 0;
-        dist = minP[i] - x[i];
-        }
-      else if ( t > 1.0 )
-        {
-        inside = 0;
-        dist = x[i] - maxP[i];
-        }
-      else
-        {//want negative distance, we are inside
-        if ( t <= 0.5 )
-          {
-          dist = minP[i] - x[i];
-          }
-        else
-          {
-          dist = x[i] - maxP[i];
-          }
-        if ( dist > minDistance ) //remember, it's negative
-          {
-          minDistance = dist;
-          }
-        }//if inside
-      }
-    else
-      {
-      dist = fabs(x[i]-minP[i]);
-      if (dist)
-        {
-        inside = 0;
-        }
-      }
-    if ( dist > 0.0 )
-      {
-      distance += dist*dist;
-      }
-    }//for all coordinate directions
+  vtkBoxFunction f(this->BBox);
+  return f(x);
+}
 
-  distance = sqrt(distance);
-  if ( inside )
-    {
-    return minDistance;
-    }
-  else
-    {
-    return distance;
-    }
+//----------------------------------------------------------------------------
+// Evaluate box equation for each point in an array.
+void vtkBox::EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkBoxFunction f(this->BBox);
+  vtkImplicitFunctionEvaluate(f, input, output);
 }
 
 //----------------------------------------------------------------------------
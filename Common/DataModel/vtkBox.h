@@ -43,10 +43,12 @@ public:
   static vtkBox *New();
 
   // Description
-  // Evaluate box defined by the two points (pMin,pMax).
+  // Evaluate box defined by the two points (pMin,pMax), for point x[3]
+  // or for each point in an array.
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); }
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output);
 
   // Description
   // Evaluate the gradient of the box.
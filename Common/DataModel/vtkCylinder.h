@@ -46,6 +46,8 @@ public:
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+    {this->vtkImplicitFunction::EvaluateFunction(input, output); } ;
 
   // Description
   // Evaluate cylinder function gradient.
@@ -0,0 +1,518 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkExactPointMerger.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkExactPointMerger.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+vtkStandardNewMacro(vtkExactPointMerger);
+
+namespace
+{
+// Number of points handled by one task.
+const vtkIdType VTK_MERGER_BLOCK_SIZE = 65536;
+
+// The keys are sorted with a least significant digit radix sort on digits
+// of VTK_MERGER_RADIX_BITS bits.
+const int VTK_MERGER_RADIX_BITS = 12;
+const int VTK_MERGER_RADIX_SIZE = 1 << VTK_MERGER_RADIX_BITS;
+
+// The bit pattern of a coordinate, with -0 folded onto +0. Only equality
+// matters for merging, so the keys are ordered on the raw bits.
+template <class TBits, class TValue>
+inline TBits CoordinateBits(TValue value)
+{
+  TBits bits;
+  if (value == 0)
+    {
+    value = 0;
+    }
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Key of a point with any coordinate type. The coordinates form one
+// integer with X[0] as its most significant word.
+template <class TBits>
+struct PointKey
+{
+  TBits X[3];
+  vtkIdType Id;
+
+  static int GetNumberOfDigits()
+  {
+    return (24 * sizeof(TBits) + VTK_MERGER_RADIX_BITS - 1) /
+      VTK_MERGER_RADIX_BITS;
+  }
+
+  template <class TValue>
+  void Set(const TValue *x, vtkIdType id)
+  {
+    this->X[0] = CoordinateBits<TBits>(x[0]);
+    this->X[1] = CoordinateBits<TBits>(x[1]);
+    this->X[2] = CoordinateBits<TBits>(x[2]);
+    this->Id = id;
+  }
+
+  vtkIdType GetId() const
+  {
+    return this->Id;
+  }
+
+  unsigned int GetDigit(int digit) const
+  {
+    const int wordBits = 8 * sizeof(TBits);
+    int bit = digit * VTK_MERGER_RADIX_BITS;
+    int word = 2 - bit / wordBits;
+    int shift = bit % wordBits;
+    TBits value = this->X[word] >> shift;
+    if (shift + VTK_MERGER_RADIX_BITS > wordBits && word > 0)
+      {
+      value |= this->X[word - 1] << (wordBits - shift);
+      }
+    return static_cast<unsigned int>(value) & (VTK_MERGER_RADIX_SIZE - 1);
+  }
+
+  bool SamePoint(const PointKey& other) const
+  {
+    return this->X[0] == other.X[0] && this->X[1] == other.X[1] &&
+      this->X[2] == other.X[2];
+  }
+};
+
+// Key of a float point when there are fewer than 2^32 points. The
+// coordinates and the id are packed in two words (the id in the low bits
+// of ZId), which halves the size of the key.
+struct PackedFloatPointKey
+{
+  vtkTypeUInt64 XY;
+  vtkTypeUInt64 ZId;
+
+  static int GetNumberOfDigits()
+  {
+    return (96 + VTK_MERGER_RADIX_BITS - 1) / VTK_MERGER_RADIX_BITS;
+  }
+
+  void Set(const float *x, vtkIdType id)
+  {
+    this->XY = (static_cast<vtkTypeUInt64>(
+                  CoordinateBits<vtkTypeUInt32>(x[0])) << 32) |
+      CoordinateBits<vtkTypeUInt32>(x[1]);
+    this->ZId = (static_cast<vtkTypeUInt64>(
+                   CoordinateBits<vtkTypeUInt32>(x[2])) << 32) |
+      static_cast<vtkTypeUInt32>(id);
+  }
+
+  vtkIdType GetId() const
+  {
+    return static_cast<vtkIdType>(this->ZId & 0xffffffffu);
+  }
+
+  unsigned int GetDigit(int digit) const
+  {
+    int bit = 32 + digit * VTK_MERGER_RADIX_BITS;
+    vtkTypeUInt64 value;
+    if (bit < 64)
+      {
+      value = this->ZId >> bit;
+      if (bit + VTK_MERGER_RADIX_BITS > 64)
+        {
+        value |= this->XY << (64 - bit);
+        }
+      }
+    else
+      {
+      value = this->XY >> (bit - 64);
+      }
+    return static_cast<unsigned int>(value) & (VTK_MERGER_RADIX_SIZE - 1);
+  }
+
+  bool SamePoint(const PackedFloatPointKey& other) const
+  {
+    return this->XY == other.XY && (this->ZId >> 32) == (other.ZId >> 32);
+  }
+};
+
+template <class TKey, class TValue>
+struct BuildKeysFunctor
+{
+  const TValue *Points;
+  TKey *Keys;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Keys[i].Set(this->Points + 3 * i, i);
+      }
+  }
+};
+
+// Counts the digits of each block of keys for one radix sort pass.
+template <class TKey>
+struct CountDigitsFunctor
+{
+  const TKey *Keys;
+  vtkIdType NumberOfKeys;
+  int Digit;
+  vtkIdType *Counts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      vtkIdType *counts = this->Counts + block * VTK_MERGER_RADIX_SIZE;
+      std::fill(counts, counts + VTK_MERGER_RADIX_SIZE, 0);
+      vtkIdType first = block * VTK_MERGER_BLOCK_SIZE;
+      vtkIdType last = std::min(first + VTK_MERGER_BLOCK_SIZE,
+                                this->NumberOfKeys);
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        ++counts[this->Keys[i].GetDigit(this->Digit)];
+        }
+      }
+  }
+};
+
+// Moves each block of keys to the positions computed from the counts.
+template <class TKey>
+struct ScatterKeysFunctor
+{
+  const TKey *Source;
+  TKey *Target;
+  vtkIdType NumberOfKeys;
+  int Digit;
+  vtkIdType *Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      vtkIdType *offsets = this->Offsets + block * VTK_MERGER_RADIX_SIZE;
+      vtkIdType first = block * VTK_MERGER_BLOCK_SIZE;
+      vtkIdType last = std::min(first + VTK_MERGER_BLOCK_SIZE,
+                                this->NumberOfKeys);
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        this->Target[offsets[this->Source[i].GetDigit(this->Digit)]++] =
+          this->Source[i];
+        }
+      }
+  }
+};
+
+// Sort the keys on their coordinates. Each pass is stable and the keys
+// start in id order, so coincident points end up sorted by id. The sorted
+// keys end up in either keys or buffer, which is returned.
+template <class TKey>
+TKey *RadixSort(TKey *keys, TKey *buffer, vtkIdType n)
+{
+  vtkIdType numBlocks = (n + VTK_MERGER_BLOCK_SIZE - 1) / VTK_MERGER_BLOCK_SIZE;
+  std::vector<vtkIdType> counts(numBlocks * VTK_MERGER_RADIX_SIZE);
+
+  TKey *source = keys;
+  TKey *target = buffer;
+  for (int digit = 0; digit < TKey::GetNumberOfDigits(); ++digit)
+    {
+    CountDigitsFunctor<TKey> counter;
+    counter.Keys = source;
+    counter.NumberOfKeys = n;
+    counter.Digit = digit;
+    counter.Counts = &counts[0];
+    vtkSMPTools::For(0, numBlocks, 1, counter);
+
+    // Turn the counts into the offset at which each block writes each
+    // digit. A pass where all keys share the same digit is skipped.
+    vtkIdType offset = 0;
+    bool sorted = false;
+    for (int d = 0; d < VTK_MERGER_RADIX_SIZE && !sorted; ++d)
+      {
+      vtkIdType digitStart = offset;
+      for (vtkIdType block = 0; block < numBlocks; ++block)
+        {
+        vtkIdType &count = counts[block * VTK_MERGER_RADIX_SIZE + d];
+        vtkIdType blockCount = count;
+        count = offset;
+        offset += blockCount;
+        }
+      sorted = (offset - digitStart == n);
+      }
+    if (sorted)
+      {
+      continue;
+      }
+
+    ScatterKeysFunctor<TKey> scatter;
+    scatter.Source = source;
+    scatter.Target = target;
+    scatter.NumberOfKeys = n;
+    scatter.Digit = digit;
+    scatter.Offsets = &counts[0];
+    vtkSMPTools::For(0, numBlocks, 1, scatter);
+    std::swap(source, target);
+    }
+  return source;
+}
+
+// For each key in sorted order, record the id of the first point of its
+// run in Representative[id], and flag that point in IsRepresentative.
+template <class TKey>
+struct FindRepresentativesFunctor
+{
+  const TKey *Keys;
+  vtkIdType *Representative;
+  unsigned char *IsRepresentative;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType runStart = begin;
+    while (runStart > 0 && this->Keys[runStart - 1].SamePoint(this->Keys[begin]))
+      {
+      --runStart;
+      }
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      if (!this->Keys[i].SamePoint(this->Keys[runStart]))
+        {
+        runStart = i;
+        }
+      vtkIdType rep = this->Keys[runStart].GetId();
+      vtkIdType id = this->Keys[i].GetId();
+      this->Representative[id] = rep;
+      this->IsRepresentative[id] = (i == runStart);
+      }
+  }
+};
+
+struct CountRepresentativesFunctor
+{
+  const unsigned char *IsRepresentative;
+  vtkIdType NumberOfPoints;
+  vtkIdType *Counts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkIdType first = chunk * VTK_MERGER_BLOCK_SIZE;
+      vtkIdType last = std::min(first + VTK_MERGER_BLOCK_SIZE,
+                                this->NumberOfPoints);
+      vtkIdType count = 0;
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        count += this->IsRepresentative[i];
+        }
+      this->Counts[chunk] = count;
+      }
+  }
+};
+
+// Number the representatives in input order and copy them to the output.
+struct NumberRepresentativesFunctor
+{
+  const unsigned char *IsRepresentative;
+  const vtkIdType *Offsets;
+  vtkIdType NumberOfPoints;
+  vtkIdType *NewIds;
+  const unsigned char *Source;
+  unsigned char *Target;
+  size_t PointSize;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkIdType first = chunk * VTK_MERGER_BLOCK_SIZE;
+      vtkIdType last = std::min(first + VTK_MERGER_BLOCK_SIZE,
+                                this->NumberOfPoints);
+      vtkIdType next = this->Offsets[chunk];
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        if (this->IsRepresentative[i])
+          {
+          this->NewIds[i] = next;
+          memcpy(this->Target + next * this->PointSize,
+                 this->Source + i * this->PointSize, this->PointSize);
+          ++next;
+          }
+        }
+      }
+  }
+};
+
+// Replace each representative id in the map by its new id.
+struct RemapFunctor
+{
+  const vtkIdType *NewIds;
+  vtkIdType *Map;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Map[i] = this->NewIds[this->Map[i]];
+      }
+  }
+};
+
+template <class TKey, class TValue>
+vtkIdType SortAndMergePoints(const TValue *coordinates, vtkIdType numPts,
+                           const unsigned char *source, size_t pointSize,
+                           vtkPoints *mergedPoints, vtkIdType *map)
+{
+  // The keys are filled in parallel, so they are left uninitialized here
+  // rather than zeroed by a serial pass.
+  TKey *keys = new TKey[numPts];
+  TKey *buffer = new TKey[numPts];
+  BuildKeysFunctor<TKey, TValue> builder;
+  builder.Points = coordinates;
+  builder.Keys = keys;
+  vtkSMPTools::For(0, numPts, builder);
+
+  const TKey *sorted = RadixSort(keys, buffer, numPts);
+
+  unsigned char *isRepresentative = new unsigned char[numPts];
+  FindRepresentativesFunctor<TKey> finder;
+  finder.Keys = sorted;
+  finder.Representative = map;
+  finder.IsRepresentative = isRepresentative;
+  vtkSMPTools::For(0, numPts, VTK_MERGER_BLOCK_SIZE, finder);
+  delete [] keys;
+  delete [] buffer;
+
+  vtkIdType numChunks = (numPts + VTK_MERGER_BLOCK_SIZE - 1) /
+    VTK_MERGER_BLOCK_SIZE;
+  std::vector<vtkIdType> offsets(numChunks + 1, 0);
+  CountRepresentativesFunctor counter;
+  counter.IsRepresentative = isRepresentative;
+  counter.NumberOfPoints = numPts;
+  counter.Counts = &offsets[1];
+  vtkSMPTools::For(0, numChunks, 1, counter);
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+    offsets[chunk + 1] += offsets[chunk];
+    }
+  vtkIdType numUnique = offsets[numChunks];
+
+  mergedPoints->SetNumberOfPoints(numUnique);
+  // Only the entries of representatives are set and read.
+  vtkIdType *newIds = new vtkIdType[numPts];
+  NumberRepresentativesFunctor numberer;
+  numberer.IsRepresentative = isRepresentative;
+  numberer.Offsets = &offsets[0];
+  numberer.NumberOfPoints = numPts;
+  numberer.NewIds = newIds;
+  numberer.Source = source;
+  numberer.Target =
+    static_cast<unsigned char*>(mergedPoints->GetData()->GetVoidPointer(0));
+  numberer.PointSize = pointSize;
+  vtkSMPTools::For(0, numChunks, 1, numberer);
+  delete [] isRepresentative;
+
+  RemapFunctor remap;
+  remap.NewIds = newIds;
+  remap.Map = map;
+  vtkSMPTools::For(0, numPts, remap);
+  delete [] newIds;
+
+  return numUnique;
+}
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkExactPointMerger::MergePoints(vtkPoints *points,
+                                           vtkPoints *mergedPoints,
+                                           vtkIdTypeArray *pointMap)
+{
+  if (!points || !mergedPoints || !pointMap)
+    {
+    vtkErrorMacro(<< "Points, merged points and point map must be given.");
+    return -1;
+    }
+  if (points == mergedPoints)
+    {
+    vtkErrorMacro(<< "The merged points must differ from the input points.");
+    return -1;
+    }
+
+  vtkIdType numPts = points->GetNumberOfPoints();
+  mergedPoints->Initialize();
+  mergedPoints->SetDataType(points->GetDataType());
+  pointMap->SetNumberOfComponents(1);
+  pointMap->SetNumberOfTuples(numPts);
+  if (numPts == 0)
+    {
+    return 0;
+    }
+
+  vtkDataArray *data = points->GetData();
+  const unsigned char *source =
+    static_cast<const unsigned char*>(data->GetVoidPointer(0));
+  size_t pointSize = 3 * data->GetDataTypeSize();
+  vtkIdType *map = pointMap->GetPointer(0);
+
+  vtkIdType numUnique;
+  switch (data->GetDataType())
+    {
+    case VTK_FLOAT:
+      if (static_cast<vtkTypeUInt64>(numPts) <= VTK_UNSIGNED_INT_MAX)
+        {
+        numUnique = SortAndMergePoints<PackedFloatPointKey>(
+          static_cast<const float*>(data->GetVoidPointer(0)),
+          numPts, source, pointSize, mergedPoints, map);
+        }
+      else
+        {
+        numUnique = SortAndMergePoints<PointKey<vtkTypeUInt32> >(
+          static_cast<const float*>(data->GetVoidPointer(0)),
+          numPts, source, pointSize, mergedPoints, map);
+        }
+      break;
+    case VTK_DOUBLE:
+      numUnique = SortAndMergePoints<PointKey<vtkTypeUInt64> >(
+        static_cast<const double*>(data->GetVoidPointer(0)),
+        numPts, source, pointSize, mergedPoints, map);
+      break;
+    default:
+      {
+      // Other point types are compared through their double values, which
+      // is exact for every type vtkPoints supports apart from 64 bit
+      // integers beyond 2^53.
+      vtkSmartPointer<vtkDoubleArray> copy =
+        vtkSmartPointer<vtkDoubleArray>::New();
+      copy->DeepCopy(data);
+      numUnique = SortAndMergePoints<PointKey<vtkTypeUInt64> >(
+        copy->GetPointer(0), numPts, source, pointSize, mergedPoints, map);
+      }
+      break;
+    }
+
+  vtkDebugMacro(<< "Merged " << numPts << " points to " << numUnique);
+  return numUnique;
+}
+
+//----------------------------------------------------------------------------
+void vtkExactPointMerger::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+}
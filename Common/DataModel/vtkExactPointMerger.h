@@ -0,0 +1,65 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkExactPointMerger.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkExactPointMerger - merge exactly coincident points in bulk
+// .SECTION Description
+// vtkExactPointMerger merges the precisely coincident points of a complete
+// vtkPoints in one operation. Unlike vtkMergePoints, which is an
+// incremental locator that hashes points one at a time as they are
+// inserted, the points are sorted on their exact coordinate values with a
+// parallel radix sort (see vtkSMPTools), so no spatial search structure is
+// built. This makes it well suited to readers that load all of the points
+// of a file before merging them (e.g. vtkSTLReader).
+//
+// The merged points are numbered in order of their first occurrence in the
+// input, which is the numbering vtkMergePoints produces when the points are
+// inserted in order. Coordinates are compared exactly; +0 and -0 are
+// considered equal.
+// .SECTION See Also
+// vtkMergePoints vtkSMPTools
+
+#ifndef __vtkExactPointMerger_h
+#define __vtkExactPointMerger_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkIdTypeArray;
+class vtkPoints;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkExactPointMerger : public vtkObject
+{
+public:
+  static vtkExactPointMerger *New();
+  vtkTypeMacro(vtkExactPointMerger,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Merge the coincident points of points. On return mergedPoints holds
+  // the unique points (with the data type of points) and pointMap holds,
+  // for each input point, the id of the corresponding point in
+  // mergedPoints. Returns the number of unique points, or -1 on error.
+  vtkIdType MergePoints(vtkPoints *points, vtkPoints *mergedPoints,
+                        vtkIdTypeArray *pointMap);
+
+protected:
+  vtkExactPointMerger() {}
+  ~vtkExactPointMerger() {}
+
+private:
+  vtkExactPointMerger(const vtkExactPointMerger&);  // Not implemented.
+  void operator=(const vtkExactPointMerger&);  // Not implemented.
+};
+
+#endif
@@ -14,9 +14,13 @@
 =========================================================================*/
 #include "vtkImplicitBoolean.h"
 
+#include "vtkDoubleArray.h"
 #include "vtkImplicitFunctionCollection.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <math.h>
 
 vtkStandardNewMacro(vtkImplicitBoolean);
@@ -146,6 +150,96 @@ double vtkImplicitBoolean::EvaluateFunction(double x[3])
   return value;
 }
 
+// Evaluate boolean combinations of implicit function for each point in an
+// array.  Each function is evaluated for all of the points at once, and
+// the values are combined in the same way as for a single point.
+void vtkImplicitBoolean::EvaluateFunction(vtkDataArray *input,
+                                          vtkDataArray *output)
+{
+  vtkIdType i, n = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(n);
+
+  // Combine the values into the output if it is a double array
+  vtkSmartPointer<vtkDoubleArray> result = vtkDoubleArray::SafeDownCast(output);
+  if ( !result )
+    {
+    result = vtkSmartPointer<vtkDoubleArray>::New();
+    result->SetNumberOfTuples(n);
+    }
+  double *value = result->GetPointer(0);
+
+  // Without any functions the value is zero, as for a single point
+  double initial = 0.0;
+  if ( this->FunctionList->GetNumberOfItems() > 0 )
+    {
+    if ( this->OperationType == VTK_UNION ||
+         this->OperationType == VTK_UNION_OF_MAGNITUDES )
+      {
+      initial = VTK_DOUBLE_MAX;
+      }
+    else if ( this->OperationType == VTK_INTERSECTION )
+      {
+      initial = -VTK_DOUBLE_MAX;
+      }
+    }
+  std::fill(value, value + n, initial);
+
+  vtkImplicitFunction *f, *firstF = NULL;
+  vtkNew<vtkDoubleArray> values;
+  vtkCollectionSimpleIterator sit;
+  for (this->FunctionList->InitTraversal(sit);
+       (f=this->FunctionList->GetNextImplicitFunction(sit)); )
+    {
+    f->FunctionValue(input, values.GetPointer());
+    const double *v = values->GetPointer(0);
+
+    if ( this->OperationType == VTK_UNION )
+      { //take minimum value
+      for (i = 0; i < n; i++)
+        {
+        value[i] = (v[i] < value[i] ? v[i] : value[i]);
+        }
+      }
+    else if ( this->OperationType == VTK_INTERSECTION )
+      { //take maximum value
+      for (i = 0; i < n; i++)
+        {
+        value[i] = (v[i] > value[i] ? v[i] : value[i]);
+        }
+      }
+    else if ( this->OperationType == VTK_UNION_OF_MAGNITUDES )
+      { //take minimum absolute value
+      for (i = 0; i < n; i++)
+        {
+        double a = fabs(v[i]);
+        value[i] = (a < value[i] ? a : value[i]);
+        }
+      }
+    else if ( firstF == NULL )
+      { //difference, start with the first function
+      firstF = f;
+      std::copy(v, v + n, value);
+      }
+    else if ( f != firstF )
+      { //difference, subtract the other functions
+      for (i = 0; i < n; i++)
+        {
+        double a = (-1.0)*v[i];
+        value[i] = (a > value[i] ? a : value[i]);
+        }
+      }
+    }
+
+  if ( result.GetPointer() != output )
+    {
+    for (i = 0; i < n; i++)
+      {
+      output->SetComponent(i, 0, value[i]);
+      }
+    }
+}
+
 // Evaluate gradient of boolean combination.
 void vtkImplicitBoolean::EvaluateGradient(double x[3], double g[3])
 {
@@ -56,10 +56,12 @@ public:
   static vtkImplicitBoolean *New();
 
   // Description:
-  // Evaluate boolean combinations of implicit function using current operator.
+  // Evaluate boolean combinations of implicit function using current operator,
+  // for point x[3] or for each point in an array.
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output);
 
   // Description:
   // Evaluate gradient of boolean combination.
@@ -16,8 +16,15 @@
 
 #include "vtkMath.h"
 #include "vtkAbstractTransform.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkTransform.h"
 
+#include <algorithm>
+
 vtkCxxSetObjectMacro(vtkImplicitFunction,Transform,vtkAbstractTransform);
 
 vtkImplicitFunction::vtkImplicitFunction()
@@ -72,6 +79,83 @@ double vtkImplicitFunction::FunctionValue(const double x[3])
   */
 }
 
+//----------------------------------------------------------------------------
+// Evaluate function at each of the points in the input array. The points
+// are transformed through transform (if provided).
+void vtkImplicitFunction::FunctionValue(vtkDataArray *input,
+                                        vtkDataArray *output)
+{
+  if ( ! this->Transform )
+    {
+    this->EvaluateFunction(input, output);
+    }
+  else //pass the points through transform
+    {
+    vtkNew<vtkPoints> inPts;
+    inPts->SetData(input);
+    vtkNew<vtkPoints> outPts;
+    outPts->SetDataTypeToDouble();
+    outPts->Allocate(input->GetNumberOfTuples());
+    this->Transform->TransformPoints(inPts.GetPointer(), outPts.GetPointer());
+    this->EvaluateFunction(outPts->GetData(), output);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Evaluate function at each of the points of the input dataset. The points
+// of datasets without a points array are gathered in blocks.
+void vtkImplicitFunction::FunctionValue(vtkDataSet *input,
+                                        vtkDataArray *output)
+{
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if (pointSet && pointSet->GetPoints())
+    {
+    this->FunctionValue(pointSet->GetPoints()->GetData(), output);
+    return;
+    }
+
+  const vtkIdType blockSize = 65536;
+  vtkIdType numPts = input->GetNumberOfPoints();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> points;
+  points->SetNumberOfComponents(3);
+  vtkNew<vtkDoubleArray> values;
+  for (vtkIdType first = 0; first < numPts; first += blockSize)
+    {
+    vtkIdType n = std::min(blockSize, numPts - first);
+    points->SetNumberOfTuples(n);
+    double *x = points->GetPointer(0);
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      input->GetPoint(first + i, &x[3*i]);
+      }
+    this->FunctionValue(points.GetPointer(), values.GetPointer());
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      output->SetComponent(first + i, 0, values->GetValue(i));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Evaluate function at each of the points in the input array, one at
+// a time.
+void vtkImplicitFunction::EvaluateFunction(vtkDataArray *input,
+                                           vtkDataArray *output)
+{
+  vtkIdType n = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(n);
+
+  double x[3];
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    input->GetTuple(i, x);
+    output->SetComponent(i, 0, this->EvaluateFunction(x));
+    }
+}
+
 // Evaluate function gradient at position x-y-z and pass back vector. Point
 // x[3] is transformed through transform (if provided).
 void vtkImplicitFunction::FunctionGradient(const double x[3], double g[3])
@@ -51,6 +51,8 @@
 #include "vtkObject.h"
 
 class vtkAbstractTransform;
+class vtkDataArray;
+class vtkDataSet;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkImplicitFunction : public vtkObject
 {
@@ -70,6 +72,19 @@ public:
   double FunctionValue(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->FunctionValue(xyz); };
 
+  // Description:
+  // Evaluate function at each of the points in the input array, which
+  // must have three components, and store the values in the output array.
+  // The output is resized to have one component and as many tuples as the
+  // input.  The points are transformed through transform (if provided).
+  void FunctionValue(vtkDataArray *input, vtkDataArray *output);
+
+  // Description:
+  // Evaluate function at each of the points of the dataset and store the
+  // values in the output array, as above.  The points of datasets with
+  // implicit points, such as vtkImageData, are evaluated in blocks.
+  void FunctionValue(vtkDataSet *input, vtkDataArray *output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector. Point
   // x[3] is transformed through transform (if provided).
@@ -96,6 +111,15 @@ public:
   double EvaluateFunction(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->EvaluateFunction(xyz); };
 
+  // Description:
+  // Evaluate function at each of the points in the input array and store
+  // the values in the output array.  You should generally not call this
+  // method directly, you should use FunctionValue() instead.  The default
+  // implementation calls EvaluateFunction() for each point in turn, and
+  // derived classes can override it to evaluate all the points in a tight
+  // loop, in parallel if their evaluation is thread safe.
+  virtual void EvaluateFunction(vtkDataArray *input, vtkDataArray *output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector.
   // You should generally not call this method directly, you should use
@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitFunctionInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImplicitFunctionInternals - Batch evaluation of implicit functions
+// .SECTION Description
+// This is a helper for the implicit functions that override the batch
+// EvaluateFunction() method.  The function is given as a small object with
+// an inline operator() that evaluates one point, so that the loop over the
+// points can be inlined and vectorized by the compiler.  The points are
+// done in blocks, and when the input and output are float or double arrays
+// the blocks are done in parallel with vtkSMPTools.  Otherwise the generic
+// vtkDataArray methods are used, serially.
+
+#ifndef __vtkImplicitFunctionInternals_h
+#define __vtkImplicitFunctionInternals_h
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkSMPTools.h"
+
+// The number of points in each block
+#define VTK_IMPLICIT_FUNCTION_BLOCK 1024
+
+namespace {
+
+//----------------------------------------------------------------------------
+// Evaluate the function for n points, storing the results in v.
+template<class F, class T, class U>
+inline void vtkImplicitFunctionEvaluateBlock(
+  const F &f, const T *x, U *v, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    v[i] = static_cast<U>(f(x));
+    x += 3;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Evaluate the function for the points in a range of blocks.
+template<class F, class T, class U>
+class vtkImplicitFunctionEvaluateFunctor
+{
+public:
+  vtkImplicitFunctionEvaluateFunctor(const F &f, const T *x, U *v,
+                                     vtkIdType n)
+    : Function(f), Input(x), Output(v), NumberOfPoints(n) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType block = begin; block < end; block++)
+      {
+      vtkIdType first = block*VTK_IMPLICIT_FUNCTION_BLOCK;
+      vtkIdType n = this->NumberOfPoints - first;
+      n = (n < VTK_IMPLICIT_FUNCTION_BLOCK ? n : VTK_IMPLICIT_FUNCTION_BLOCK);
+      vtkImplicitFunctionEvaluateBlock(
+        this->Function, this->Input + 3*first, this->Output + first, n);
+      }
+  }
+
+private:
+  const F &Function;
+  const T *Input;
+  U *Output;
+  vtkIdType NumberOfPoints;
+};
+
+//----------------------------------------------------------------------------
+template<class F, class T, class U>
+void vtkImplicitFunctionEvaluateParallel(
+  const F &f, const T *x, U *v, vtkIdType n)
+{
+  vtkImplicitFunctionEvaluateFunctor<F, T, U> functor(f, x, v, n);
+  vtkIdType numBlocks =
+    (n + VTK_IMPLICIT_FUNCTION_BLOCK - 1)/VTK_IMPLICIT_FUNCTION_BLOCK;
+  vtkSMPTools::For(0, numBlocks, 1, functor);
+}
+
+//----------------------------------------------------------------------------
+template<class F, class T>
+void vtkImplicitFunctionEvaluateToOutput(
+  const F &f, const T *x, vtkDataArray *output, vtkIdType n)
+{
+  if (vtkDoubleArray *doubleArray = vtkDoubleArray::SafeDownCast(output))
+    {
+    vtkImplicitFunctionEvaluateParallel(f, x, doubleArray->GetPointer(0), n);
+    }
+  else if (vtkFloatArray *floatArray = vtkFloatArray::SafeDownCast(output))
+    {
+    vtkImplicitFunctionEvaluateParallel(f, x, floatArray->GetPointer(0), n);
+    }
+  else
+    {
+    double v[VTK_IMPLICIT_FUNCTION_BLOCK];
+    for (vtkIdType first = 0; first < n; first += VTK_IMPLICIT_FUNCTION_BLOCK)
+      {
+      vtkIdType m = n - first;
+      m = (m < VTK_IMPLICIT_FUNCTION_BLOCK ? m : VTK_IMPLICIT_FUNCTION_BLOCK);
+      vtkImplicitFunctionEvaluateBlock(f, x + 3*first, v, m);
+      for (vtkIdType i = 0; i < m; i++)
+        {
+        output->SetComponent(first + i, 0, v[i]);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Evaluate the function at each point of the input, which must have three
+// components, and store the values in the output.
+template<class F>
+void vtkImplicitFunctionEvaluate(
+  const F &f, vtkDataArray *input, vtkDataArray *output)
+{
+  vtkIdType n = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(n);
+  if (n == 0)
+    {
+    return;
+    }
+
+  if (vtkDoubleArray *doubleArray = vtkDoubleArray::SafeDownCast(input))
+    {
+    vtkImplicitFunctionEvaluateToOutput(
+      f, doubleArray->GetPointer(0), output, n);
+    }
+  else if (vtkFloatArray *floatArray = vtkFloatArray::SafeDownCast(input))
+    {
+    vtkImplicitFunctionEvaluateToOutput(
+      f, floatArray->GetPointer(0), output, n);
+    }
+  else
+    {
+    double x[3*VTK_IMPLICIT_FUNCTION_BLOCK];
+    double v[VTK_IMPLICIT_FUNCTION_BLOCK];
+    for (vtkIdType first = 0; first < n; first += VTK_IMPLICIT_FUNCTION_BLOCK)
+      {
+      vtkIdType m = n - first;
+      m = (m < VTK_IMPLICIT_FUNCTION_BLOCK ? m : VTK_IMPLICIT_FUNCTION_BLOCK);
+      for (vtkIdType i = 0; i < m; i++)
+        {
+        input->GetTuple(first + i, &x[3*i]);
+        }
+      vtkImplicitFunctionEvaluateBlock(f, x, v, m);
+      for (vtkIdType i = 0; i < m; i++)
+        {
+        output->SetComponent(first + i, 0, v[i]);
+        }
+      }
+    }
+}
+
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImplicitFunctionInternals.h
@@ -49,6 +49,10 @@ public:
     {
       return this->vtkImplicitFunction::EvaluateFunction(x, y, z);
     }
+  virtual void EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+    {
+      this->vtkImplicitFunction::EvaluateFunction(input, output);
+    }
 
   // Description
   // Evaluate normal. Not implemented.
@@ -68,6 +68,8 @@ public:
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+    {this->vtkImplicitFunction::EvaluateFunction(input, output); } ;
 
   // Description:
   // Evaluate selection loop returning the gradient.
@@ -13,11 +13,33 @@
 
 =========================================================================*/
 #include "vtkPlane.h"
+
+#include "vtkImplicitFunctionInternals.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 
 vtkStandardNewMacro(vtkPlane);
 
+namespace {
+
+// The plane equation, for batch evaluation
+struct vtkPlaneFunction
+{
+  double Normal[3];
+  double Origin[3];
+
+  template<class T>
+  double operator()(const T *p) const
+  {
+    double x[3] = { p[0], p[1], p[2] };
+    return ( this->Normal[0]*(x[0]-this->Origin[0]) +
+             this->Normal[1]*(x[1]-this->Origin[1]) +
+             this->Normal[2]*(x[2]-this->Origin[2]) );
+  }
+};
+
+}
+
 // Construct plane passing through origin and normal to z-axis.
 vtkPlane::vtkPlane()
 {
@@ -134,6 +156,18 @@ double vtkPlane::EvaluateFunction(double x[3])
            this->Normal[2]*(x[2]-this->Origin[2]) );
 }
 
+// Evaluate plane equation for each point in an array.
+void vtkPlane::EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkPlaneFunction f;
+  for (int i=0; i<3; i++)
+    {
+    f.Normal[i] = this->Normal[i];
+    f.Origin[i] = this->Origin[i];
+    }
+  vtkImplicitFunctionEvaluate(f, input, output);
+}
+
 // Evaluate function gradient at point x[3].
 void vtkPlane::EvaluateGradient(double vtkNotUsed(x)[3], double n[3])
 {
@@ -36,10 +36,11 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description
-  // Evaluate plane equation for point x[3].
+  // Evaluate plane equation for point x[3], or for each point in an array.
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output);
 
   // Description
   // Evaluate function gradient at point x[3].
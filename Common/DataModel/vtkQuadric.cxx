@@ -13,11 +13,33 @@
 
 =========================================================================*/
 #include "vtkQuadric.h"
+
+#include "vtkImplicitFunctionInternals.h"
 #include "vtkObjectFactory.h"
 
 
 vtkStandardNewMacro(vtkQuadric);
 
+namespace {
+
+// The quadric equation, for batch evaluation
+struct vtkQuadricFunction
+{
+  double Coefficients[10];
+
+  template<class T>
+  double operator()(const T *p) const
+  {
+    double x[3] = { p[0], p[1], p[2] };
+    const double *a = this->Coefficients;
+    return ( a[0]*x[0]*x[0] + a[1]*x[1]*x[1] + a[2]*x[2]*x[2] +
+             a[3]*x[0]*x[1] + a[4]*x[1]*x[2] + a[5]*x[0]*x[2] +
+             a[6]*x[0] + a[7]*x[1] + a[8]*x[2] + a[9] );
+  }
+};
+
+}
+
 // Construct quadric with all coefficients = 1.
 vtkQuadric::vtkQuadric()
 {
@@ -70,6 +92,17 @@ double vtkQuadric::EvaluateFunction(double x[3])
            a[6]*x[0] + a[7]*x[1] + a[8]*x[2] + a[9] );
 }
 
+// Evaluate the quadric equation for each point in an array.
+void vtkQuadric::EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkQuadricFunction f;
+  for (int i=0; i<10; i++)
+    {
+    f.Coefficients[i] = this->Coefficients[i];
+    }
+  vtkImplicitFunctionEvaluate(f, input, output);
+}
+
 // Evaluate the gradient to the quadric equation.
 void vtkQuadric::EvaluateGradient(double x[3], double n[3])
 {
@@ -35,10 +35,11 @@ public:
   static vtkQuadric *New();
 
   // Description
-  // Evaluate quadric equation.
+  // Evaluate quadric equation, for point x[3] or for each point in an array.
   double EvaluateFunction(double x[3]);
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output);
 
   // Description
   // Evaluate the gradient to the quadric equation.
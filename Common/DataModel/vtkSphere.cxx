@@ -13,11 +13,34 @@
 
 =========================================================================*/
 #include "vtkSphere.h"
+
+#include "vtkImplicitFunctionInternals.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 
 vtkStandardNewMacro(vtkSphere);
 
+namespace {
+
+// The sphere equation, for batch evaluation
+struct vtkSphereFunction
+{
+  double Center[3];
+  double Radius;
+
+  template<class T>
+  double operator()(const T *p) const
+  {
+    double x[3] = { p[0], p[1], p[2] };
+    return ( ((x[0] - this->Center[0]) * (x[0] - this->Center[0]) +
+              (x[1] - this->Center[1]) * (x[1] - this->Center[1]) +
+              (x[2] - this->Center[2]) * (x[2] - this->Center[2])) -
+             this->Radius*this->Radius );
+  }
+};
+
+}
+
 //----------------------------------------------------------------------------
 // Construct sphere with center at (0,0,0) and radius=0.5.
 vtkSphere::vtkSphere()
@@ -39,6 +62,18 @@ double vtkSphere::EvaluateFunction(double x[3])
            this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+// Evaluate sphere equation for each point in an array.
+void vtkSphere::EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkSphereFunction f;
+  f.Center[0] = this->Center[0];
+  f.Center[1] = this->Center[1];
+  f.Center[2] = this->Center[2];
+  f.Radius = this->Radius;
+  vtkImplicitFunctionEvaluate(f, input, output);
+}
+
 //----------------------------------------------------------------------------
 // Evaluate sphere gradient.
 void vtkSphere::EvaluateGradient(double x[3], double n[3])
@@ -23,14 +23,25 @@
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+// Off by default, since subclasses that keep per-thread state cannot run
+// their pieces on the vtkSMPTools backend.
+bool vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP = false;
 
 //----------------------------------------------------------------------------
 vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 {
   this->Threader = vtkMultiThreader::New();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
+  this->EnableSMP = vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP;
+  this->DesiredBytesPerPiece = 65536;
+  this->MinimumPieceSize[0] = 16;
+  this->MinimumPieceSize[1] = 1;
+  this->MinimumPieceSize[2] = 1;
+  this->SplitMode = SLAB;
 }
 
 //----------------------------------------------------------------------------
@@ -45,6 +56,27 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On" : "Off") << "\n";
+  os << indent << "DesiredBytesPerPiece: " << this->DesiredBytesPerPiece
+     << "\n";
+  os << indent << "MinimumPieceSize: (" << this->MinimumPieceSize[0] << ", "
+     << this->MinimumPieceSize[1] << ", " << this->MinimumPieceSize[2]
+     << ")\n";
+  os << indent << "SplitMode: "
+     << (this->SplitMode == SLAB ? "Slab" :
+         (this->SplitMode == BEAM ? "Beam" : "Block")) << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::SetGlobalDefaultEnableSMP(bool enable)
+{
+  vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP = enable;
+}
+
+//----------------------------------------------------------------------------
+bool vtkThreadedImageAlgorithm::GetGlobalDefaultEnableSMP()
+{
+  return vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP;
 }
 
 struct vtkImageThreadStruct
@@ -79,6 +111,11 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6],
   // start with same extent
   memcpy(splitExt, startExt, 6 * sizeof(int));
 
+  if (this->EnableSMP)
+    {
+    return this->SplitExtentIntoPieces(splitExt, startExt, num, total);
+    }
+
   splitAxis = 2;
   min = startExt[4];
   max = startExt[5];
@@ -121,22 +158,93 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6],
 }
 
 
-// this mess is really a simple function. All it does is call
-// the ThreadedExecute method after setting the correct
-// extent for this thread. Its just a pain to calculate
-// the correct extent.
-static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+//----------------------------------------------------------------------------
+// Splits the extent into a grid of at most "total" pieces of at least
+// MinimumPieceSize along the axes allowed by SplitMode, and returns the
+// actual number of pieces. Pieces are numbered with X varying fastest.
+int vtkThreadedImageAlgorithm::SplitExtentIntoPieces(int splitExt[6],
+                                                     int startExt[6],
+                                                     int num, int total)
 {
-  vtkImageThreadStruct *str;
-  int ext[6], splitExt[6], total;
-  int threadId, threadCount;
+  int size[3];
+  int maxDivisions[3];
+  for (int axis = 0; axis < 3; axis++)
+    {
+    size[axis] = startExt[2*axis+1] - startExt[2*axis] + 1;
+    if (size[axis] <= 0)
+      {
+      // empty extent so cannot split
+      return 1;
+      }
+    int minimumSize = this->MinimumPieceSize[axis];
+    maxDivisions[axis] = size[axis] / (minimumSize > 1 ? minimumSize : 1);
+    if (maxDivisions[axis] < 1)
+      {
+      maxDivisions[axis] = 1;
+      }
+    }
 
-  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
-  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
+  // the axes that may be split, from the one that is split first
+  int axes[3] = { 2, 1, 0 };
+  int numAxes = (this->SplitMode == BLOCK ? 3 :
+                 (this->SplitMode == BEAM ? 2 : 1));
+  if (this->SplitMode == SLAB)
+    {
+    // the first axis that can be split
+    int i = 0;
+    while (i < 2 && maxDivisions[axes[i]] == 1)
+      {
+      i++;
+      }
+    axes[0] = axes[i];
+    }
 
-  str = static_cast<vtkImageThreadStruct *>
-    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  // spread the pieces evenly over the axes, and give the rest to the
+  // next axes when an axis cannot be split any further
+  int divisions[3] = { 1, 1, 1 };
+  double remaining = total;
+  for (int i = 0; i < numAxes; i++)
+    {
+    int axis = axes[i];
+    int d = static_cast<int>(floor(pow(remaining, 1.0/(numAxes - i)) + 1e-6));
+    divisions[axis] = (d < maxDivisions[axis] ? d : maxDivisions[axis]);
+    if (divisions[axis] < 1)
+      {
+      divisions[axis] = 1;
+      }
+    remaining = floor(remaining/divisions[axis]);
+    }
+
+  int pieces = divisions[0]*divisions[1]*divisions[2];
+  if (num >= pieces)
+    {
+    return pieces;
+    }
+
+  int index[3];
+  index[0] = num % divisions[0];
+  index[1] = (num / divisions[0]) % divisions[1];
+  index[2] = num / (divisions[0]*divisions[1]);
+  for (int axis = 0; axis < 3; axis++)
+    {
+    vtkIdType s = size[axis];
+    vtkIdType d = divisions[axis];
+    splitExt[2*axis] = startExt[2*axis] +
+      static_cast<int>(s*index[axis]/d);
+    splitExt[2*axis+1] = startExt[2*axis] +
+      static_cast<int>(s*(index[axis] + 1)/d) - 1;
+    }
+
+  return pieces;
+}
 
+//----------------------------------------------------------------------------
+// Gets the extent that the threads or pieces split: the update extent of
+// the output that the request came from, or of the first input if the
+// filter has no output. Returns false if there is no such extent.
+static bool vtkThreadedImageAlgorithmGetExtent(vtkImageThreadStruct *str,
+                                               int ext[6])
+{
   // if we have an output
   if (str->Filter->GetNumberOfOutputPorts())
     {
@@ -148,7 +256,7 @@ static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *ar
     // update directly, for now an error
     if (outputPort == -1)
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return false;
       }
 
     // get the update extent from the output port
@@ -178,9 +286,32 @@ static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *ar
       }
     if (inPort >= str->Filter->GetNumberOfInputPorts())
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return false;
       }
     }
+  return true;
+}
+
+// this mess is really a simple function. All it does is call
+// the ThreadedExecute method after setting the correct
+// extent for this thread. Its just a pain to calculate
+// the correct extent.
+static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+{
+  vtkImageThreadStruct *str;
+  int ext[6], splitExt[6], total;
+  int threadId, threadCount;
+
+  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
+
+  str = static_cast<vtkImageThreadStruct *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  if (!vtkThreadedImageAlgorithmGetExtent(str, ext))
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
 
   // execute the actual method with appropriate extent
   // first find out how many pieces extent can be split into.
@@ -211,6 +342,63 @@ static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *ar
 }
 
 
+//----------------------------------------------------------------------------
+// Runs ThreadedRequestData for a range of pieces on the vtkSMPTools backend.
+class vtkThreadedImageAlgorithmFunctor
+{
+public:
+  vtkThreadedImageAlgorithmFunctor(vtkImageThreadStruct *str, int extent[6],
+                                   vtkIdType pieces)
+    : Str(str), NumberOfPieces(pieces)
+  {
+    memcpy(this->Extent, extent, sizeof(int)*6);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    this->Str->Filter->SMPRequestData(this->Str->Request,
+                                      this->Str->InputsInfo,
+                                      this->Str->OutputsInfo,
+                                      this->Str->Inputs, this->Str->Outputs,
+                                      begin, end, this->NumberOfPieces,
+                                      this->Extent);
+  }
+
+private:
+  vtkImageThreadStruct *Str;
+  vtkIdType NumberOfPieces;
+  int Extent[6];
+};
+
+//----------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::SMPRequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector,
+  vtkImageData ***inData,
+  vtkImageData **outData,
+  vtkIdType begin, vtkIdType end,
+  vtkIdType pieces, int extent[6])
+{
+  for (vtkIdType piece = begin; piece < end; ++piece)
+    {
+    int splitExt[6];
+    int total = this->SplitExtent(splitExt, extent, static_cast<int>(piece),
+                                  static_cast<int>(pieces));
+
+    // skip pieces that are not used or are empty
+    if (piece < total &&
+        splitExt[0] <= splitExt[1] &&
+        splitExt[2] <= splitExt[3] &&
+        splitExt[4] <= splitExt[5])
+      {
+      this->ThreadedRequestData(request, inputVector, outputVector,
+                                inData, outData, splitExt,
+                                static_cast<int>(piece));
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 // This is the superclasses style of Execute method.  Convert it into
 // an imaging style Execute method.
@@ -283,13 +471,46 @@ int vtkThreadedImageAlgorithm::RequestData(
     this->CopyAttributeData(str.Inputs[0][0],str.Outputs[0],inputVector);
     }
 
-  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
-  this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);
-
   // always shut off debugging to avoid threading problems with GetMacros
   int debug = this->Debug;
   this->Debug = 0;
-  this->Threader->SingleMethodExecute();
+  if (this->EnableSMP)
+    {
+    int ext[6];
+    if (vtkThreadedImageAlgorithmGetExtent(&str, ext))
+      {
+      // make pieces of about DesiredBytesPerPiece bytes of output scalars
+      vtkImageData *data = (str.Outputs && str.Outputs[0] ? str.Outputs[0] :
+        (str.Inputs && str.Inputs[0] ? str.Inputs[0][0] : 0));
+      vtkIdType bytes = 1;
+      if (data && data->GetPointData()->GetScalars())
+        {
+        bytes = data->GetScalarSize()*data->GetNumberOfScalarComponents();
+        }
+      for (i = 0; i < 3; ++i)
+        {
+        bytes *= (ext[2*i+1] >= ext[2*i] ? ext[2*i+1] - ext[2*i] + 1 : 0);
+        }
+      vtkIdType pieces = (bytes + this->DesiredBytesPerPiece - 1)/
+        this->DesiredBytesPerPiece;
+      pieces = (pieces < VTK_INT_MAX ? pieces : VTK_INT_MAX);
+
+      // find out how many pieces the extent can actually be split into
+      int splitExt[6];
+      pieces = this->SplitExtent(splitExt, ext, 0,
+                                 static_cast<int>(pieces > 1 ? pieces : 1));
+
+      vtkThreadedImageAlgorithmFunctor functor(&str, ext, pieces);
+      vtkSMPTools::For(0, pieces, 1, functor);
+      }
+    }
+  else
+    {
+    this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+    this->Threader->SetSingleMethod(
+      vtkThreadedImageAlgorithmThreadedExecute, &str);
+    this->Threader->SingleMethodExecute();
+    }
   this->Debug = debug;
 
   // free up the arrays
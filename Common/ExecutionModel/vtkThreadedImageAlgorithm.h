@@ -19,6 +19,14 @@
 // into smaller extents so that the vtkImageData limits are observed. It
 // also provides support for multithreading. If you don't need any of this
 // functionality, consider using vtkSimpleImageToImageAlgorithm instead.
+//
+// By default the update extent is split into one piece per thread and the
+// pieces are run with vtkMultiThreader. When EnableSMP is on, the extent is
+// instead split into many small pieces of about DesiredBytesPerPiece bytes
+// each, which the vtkSMPTools backend balances over its threads. This helps
+// when some pieces cost much more than others. Subclasses must not keep
+// per-thread state indexed by the thread id to run in this mode, since the
+// id passed to ThreadedRequestData is then the number of the piece.
 // .SECTION See also
 // vtkSimpleImageToImageAlgorithm
 
@@ -59,11 +67,66 @@ public:
   vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
   vtkGetMacro( NumberOfThreads, int );
 
+  // Description:
+  // Use the vtkSMPTools backend instead of vtkMultiThreader to run
+  // ThreadedRequestData over many small pieces of the extent. The default
+  // for new filters is given by GlobalDefaultEnableSMP, which is off.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
+  // Description:
+  // Set the default of EnableSMP for all filters created afterwards.
+  static void SetGlobalDefaultEnableSMP(bool enable);
+  static bool GetGlobalDefaultEnableSMP();
+
+  // Description:
+  // The size that the pieces should aim for when EnableSMP is on, in bytes
+  // of output scalars. Smaller pieces balance the load better but add
+  // overhead. The default is 65536.
+  vtkSetClampMacro(DesiredBytesPerPiece, vtkIdType, 1, VTK_ID_MAX);
+  vtkGetMacro(DesiredBytesPerPiece, vtkIdType);
+
+  // Description:
+  // The smallest size of a piece along each axis when EnableSMP is on.
+  // The default is (16,1,1), so that rows are not split into tiny parts.
+  vtkSetVector3Macro(MinimumPieceSize, int);
+  vtkGetVector3Macro(MinimumPieceSize, int);
+
+  // Description:
+  // How the extent is split into pieces when EnableSMP is on. Slab mode
+  // splits along a single axis, preferring Z, beam mode splits along Z and
+  // Y, and block mode along all three axes. The default is slab mode.
+  vtkSetClampMacro(SplitMode, int, SLAB, BLOCK);
+  void SetSplitModeToSlab() { this->SetSplitMode(SLAB); }
+  void SetSplitModeToBeam() { this->SetSplitMode(BEAM); }
+  void SetSplitModeToBlock() { this->SetSplitMode(BLOCK); }
+  vtkGetMacro(SplitMode, int);
+  enum SplitModeEnum
+  {
+    SLAB = 0,
+    BEAM = 1,
+    BLOCK = 2
+  };
+
   // Description:
   // Putting this here until I merge graphics and imaging streaming.
   virtual int SplitExtent(int splitExt[6], int startExt[6],
                           int num, int total);
 
+  // Description:
+  // Split the extent into the given number of pieces and call
+  // ThreadedRequestData for the pieces from begin up to, but not including,
+  // end. It is called by the vtkSMPTools backend when EnableSMP is on and
+  // is public so that the functor can call it.
+  virtual void SMPRequestData(vtkInformation *request,
+                              vtkInformationVector **inputVector,
+                              vtkInformationVector *outputVector,
+                              vtkImageData ***inData,
+                              vtkImageData **outData,
+                              vtkIdType begin, vtkIdType end,
+                              vtkIdType pieces, int extent[6]);
+
 protected:
   vtkThreadedImageAlgorithm();
   ~vtkThreadedImageAlgorithm();
@@ -71,6 +134,17 @@ protected:
   vtkMultiThreader *Threader;
   int NumberOfThreads;
 
+  bool EnableSMP;
+  static bool GlobalDefaultEnableSMP;
+  vtkIdType DesiredBytesPerPiece;
+  int MinimumPieceSize[3];
+  int SplitMode;
+
+  // Description:
+  // The splitting used by SplitExtent when EnableSMP is on.
+  int SplitExtentIntoPieces(int splitExt[6], int startExt[6],
+                            int num, int total);
+
   // Description:
   // This is called by the superclass.
   // This is the method you should override.
@@ -32,6 +32,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
@@ -151,34 +153,13 @@ void vtkCutter::StructuredPointsCutter(vtkDataSet *dataSetInput,
     contourData->GetPointData()->AddArray(cutScalars);
     }
 
-  int i,j,k;
-  double scalar;
-  double x[3];
-  int *ext = input->GetExtent();
-  double *origin = input->GetOrigin();
-  double *spacing = input->GetSpacing();
-  int count = 0;
-  for (k = ext[4]; k <= ext[5]; ++k)
-    {
-    x[2] = origin[2] + spacing[2]*k;
-    for (j = ext[2]; j <= ext[3]; ++j)
-      {
-      x[1] = origin[1] + spacing[1]*j;
-      for (i = ext[0]; i <= ext[1]; i++)
-        {
-        x[0] = origin[0] + spacing[0]*i;
-        scalar = this->CutFunction->FunctionValue(x);
-        cutScalars->SetComponent(count, 0, scalar);
-        count++;
-        }
-      }
-    }
+  this->CutFunction->FunctionValue(input, cutScalars);
 
   this->SynchronizedTemplates3D->SetInputData(contourData);
   this->SynchronizedTemplates3D->
     SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"cutScalars");
   this->SynchronizedTemplates3D->SetNumberOfContours(numContours);
-  for (i = 0; i < numContours; i++)
+  for (int i = 0; i < numContours; i++)
     {
     this->SynchronizedTemplates3D->SetValue(i, this->GetValue(i));
     }
@@ -226,13 +207,7 @@ void vtkCutter::StructuredGridCutter(vtkDataSet *dataSetInput,
     contourData->GetPointData()->AddArray(cutScalars);
     }
 
-  int i;
-  double scalar;
-  for (i = 0; i < numPts; i++)
-    {
-    scalar = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i, 0, scalar);
-    }
+  this->CutFunction->FunctionValue(input, cutScalars);
   int numContours = this->GetNumberOfContours();
 
   this->GridSynchronizedTemplates->SetDebug(this->GetDebug());
@@ -242,7 +217,7 @@ void vtkCutter::StructuredGridCutter(vtkDataSet *dataSetInput,
   this->GridSynchronizedTemplates->
     SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"cutScalars");
   this->GridSynchronizedTemplates->SetNumberOfContours(numContours);
-  for (i = 0; i < numContours; i++)
+  for (int i = 0; i < numContours; i++)
     {
     this->GridSynchronizedTemplates->SetValue(i, this->GetValue(i));
     }
@@ -288,20 +263,14 @@ void vtkCutter::RectilinearGridCutter(vtkDataSet *dataSetInput,
     contourData->GetPointData()->AddArray(cutScalars);
     }
 
-  int i;
-  double scalar;
-  for (i = 0; i < numPts; i++)
-    {
-    scalar = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i, 0, scalar);
-    }
+  this->CutFunction->FunctionValue(input, cutScalars);
   int numContours = this->GetNumberOfContours();
 
   this->RectilinearSynchronizedTemplates->SetInputData(contourData);
   this->RectilinearSynchronizedTemplates->
     SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"cutScalars");
   this->RectilinearSynchronizedTemplates->SetNumberOfContours(numContours);
-  for (i = 0; i < numContours; i++)
+  for (int i = 0; i < numContours; i++)
     {
     this->RectilinearSynchronizedTemplates->SetValue(i, this->GetValue(i));
     }
@@ -518,11 +487,7 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
 
   // Loop over all points evaluating scalar function at each point
   //
-  for ( i=0; i < numPts; i++ )
-    {
-    s = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i,0,s);
-    }
+  this->CutFunction->FunctionValue(input, cutScalars);
 
   // Compute some information for progress methods
   //
@@ -685,7 +650,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   vtkCellArray *newVerts, *newLines, *newPolys;
   vtkPoints *newPoints;
   vtkDoubleArray *cutScalars;
-  double value, s;
+  double value;
   vtkIdType estimatedSize, numCells=input->GetNumberOfCells();
   vtkIdType numPts=input->GetNumberOfPoints();
   int numCellPts;
@@ -768,11 +733,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 
   // Loop over all points evaluating scalar function at each point
   //
-  for ( i=0; i < numPts; i++ )
-    {
-    s = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i,0,s);
-    }
+  this->CutFunction->FunctionValue(input, cutScalars);
 
   // Compute some information for progress methods
   //
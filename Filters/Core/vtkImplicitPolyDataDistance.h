@@ -57,6 +57,8 @@ public:
   // Description:
   // Evaluate plane equation of nearest triangle to point x[3].
   double EvaluateFunction(double x[3]);
+  void EvaluateFunction(vtkDataArray *input, vtkDataArray *output)
+    {this->vtkImplicitFunction::EvaluateFunction(input, output); } ;
 
   // Description:
   // Evaluate function gradient of nearest triangle to point x[3].
@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterClipImplicitPoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkCutter and vtkClipDataSet on datasets with implicit points
+// .SECTION Description
+// Image data and rectilinear grids have no point array, so the cut and
+// clip functions are evaluated over their points in blocks.  This cuts and
+// clips such datasets with a transformed sphere, and checks that the
+// result matches contouring or clipping the same function values computed
+// one point at a time.
+
+#include "vtkCellArray.h"
+#include "vtkClipDataSet.h"
+#include "vtkContourFilter.h"
+#include "vtkCutter.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkTransform.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace {
+
+const double Tolerance = 1e-5;
+
+// A copy of the input with the function values as its point scalars.
+vtkSmartPointer<vtkDataSet> WithScalars(vtkDataSet *input,
+                                        vtkImplicitFunction *func)
+{
+  vtkSmartPointer<vtkDataSet> copy;
+  copy.TakeReference(input->NewInstance());
+  copy->ShallowCopy(input);
+
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("values");
+  scalars->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    scalars->SetValue(i, func->FunctionValue(input->GetPoint(i)));
+    }
+  copy->GetPointData()->SetScalars(scalars.GetPointer());
+  return copy;
+}
+
+bool SamePoints(vtkDataSet *a, vtkDataSet *b, const char *what)
+{
+  if (a->GetNumberOfPoints() == 0 ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+    cerr << what << ": " << a->GetNumberOfPoints() << " points instead of "
+         << b->GetNumberOfPoints() << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    for (int j = 0; j < 3; ++j)
+      {
+      if (fabs(x[j] - y[j]) > Tolerance)
+        {
+        cerr << what << ": point " << i << " differs" << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b, const char *what)
+{
+  vtkIdTypeArray *aIds = a->GetData();
+  vtkIdTypeArray *bIds = b->GetData();
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      aIds->GetNumberOfTuples() != bIds->GetNumberOfTuples())
+    {
+    cerr << what << ": " << a->GetNumberOfCells() << " cells instead of "
+         << b->GetNumberOfCells() << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < aIds->GetNumberOfTuples(); ++i)
+    {
+    if (aIds->GetValue(i) != bIds->GetValue(i))
+      {
+      cerr << what << ": connectivity differs at " << i << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// More than one contour value, so that vtkCutter computes the function
+// values itself rather than handing the function to a templates filter.
+bool TestCutter(vtkDataSet *input, vtkImplicitFunction *func,
+                const char *what)
+{
+  const double values[3] = { -0.2, 0.0, 0.35 };
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputData(input);
+  cutter->SetCutFunction(func);
+  vtkNew<vtkContourFilter> contour;
+  contour->SetInputData(WithScalars(input, func));
+  contour->ComputeScalarsOff();
+  contour->ComputeNormalsOff();
+  for (int i = 0; i < 3; ++i)
+    {
+    cutter->SetValue(i, values[i]);
+    contour->SetValue(i, values[i]);
+    }
+  cutter->Update();
+  contour->Update();
+
+  vtkPolyData *cut = cutter->GetOutput();
+  vtkPolyData *expected = contour->GetOutput();
+  return (SamePoints(cut, expected, what) &&
+          SameCells(cut->GetPolys(), expected->GetPolys(), what));
+}
+
+bool TestClip(vtkDataSet *input, vtkImplicitFunction *func, int insideOut,
+              const char *what)
+{
+  vtkNew<vtkClipDataSet> clip;
+  clip->SetInputData(input);
+  clip->SetClipFunction(func);
+  clip->SetInsideOut(insideOut);
+  clip->Update();
+
+  vtkNew<vtkClipDataSet> expectedClip;
+  expectedClip->SetInputData(WithScalars(input, func));
+  expectedClip->SetInsideOut(insideOut);
+  expectedClip->Update();
+
+  vtkUnstructuredGrid *clipped = clip->GetOutput();
+  vtkUnstructuredGrid *expected = expectedClip->GetOutput();
+  return (SamePoints(clipped, expected, what) &&
+          SameCells(clipped->GetCells(), expected->GetCells(), what));
+}
+
+vtkSmartPointer<vtkRectilinearGrid> MakeRectilinearGrid()
+{
+  vtkSmartPointer<vtkRectilinearGrid> grid =
+    vtkSmartPointer<vtkRectilinearGrid>::New();
+  grid->SetDimensions(45, 40, 38);
+  vtkNew<vtkDoubleArray> coords[3];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int n = grid->GetDimensions()[axis];
+    for (int i = 0; i < n; ++i)
+      {
+      // Uneven spacing, denser in the middle
+      double t = 2.0 * i / (n - 1) - 1.0;
+      coords[axis]->InsertNextValue(1.3 * t * (0.6 + 0.4 * t * t));
+      }
+    }
+  grid->SetXCoordinates(coords[0].GetPointer());
+  grid->SetYCoordinates(coords[1].GetPointer());
+  grid->SetZCoordinates(coords[2].GetPointer());
+  return grid;
+}
+
+}
+
+int TestCutterClipImplicitPoints(int, char *[])
+{
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.0);
+  transform->RotateX(-20.0);
+  transform->Scale(1.0, 1.6, 0.7);
+  transform->Translate(0.1, -0.2, 0.05);
+  vtkNew<vtkSphere> sphere;
+  sphere->SetRadius(0.8);
+  sphere->SetTransform(transform.GetPointer());
+
+  // More points than are evaluated in one block
+  vtkNew<vtkImageData> volume;
+  volume->SetExtent(0, 49, 0, 44, 0, 39);
+  volume->SetOrigin(-1.2, -1.1, -1.0);
+  volume->SetSpacing(0.05, 0.05, 0.05);
+
+  // vtkClipDataSet hands 3D images to vtkClipVolume, so clip a slice
+  vtkNew<vtkImageData> slice;
+  slice->SetExtent(0, 299, 0, 249, 0, 0);
+  slice->SetOrigin(-1.5, -0.5, 0.1);
+  slice->SetSpacing(0.01, 0.004, 1.0);
+
+  vtkSmartPointer<vtkRectilinearGrid> grid = MakeRectilinearGrid();
+
+  bool success = true;
+  success &= TestCutter(volume.GetPointer(), sphere.GetPointer(),
+                        "Image cut");
+  success &= TestCutter(grid, sphere.GetPointer(), "Rectilinear grid cut");
+  for (int insideOut = 0; insideOut < 2; ++insideOut)
+    {
+    success &= TestClip(slice.GetPointer(), sphere.GetPointer(), insideOut,
+                        "Image clip");
+    success &= TestClip(grid, sphere.GetPointer(), insideOut,
+                        "Rectilinear grid clip");
+    }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkClipVolume.h"
+#include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
@@ -27,6 +28,7 @@
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
@@ -321,11 +323,7 @@ int vtkClipDataSet::RequestData(
       {
       inPD->SetScalars(tmpScalars);
       }
-    for ( i=0; i < numPts; i++ )
-      {
-      s = this->ClipFunction->FunctionValue(input->GetPoint(i));
-      tmpScalars->SetTuple1(i,s);
-      }
+    this->ClipFunction->FunctionValue(input, tmpScalars);
     clipScalars = tmpScalars;
     }
   else //using input scalars
@@ -528,10 +526,11 @@ int vtkClipDataSet::ClipPoints(vtkDataSet* input,
     }
   if (this->ClipFunction)
     {
+    vtkNew<vtkDoubleArray> functionValues;
+    this->ClipFunction->FunctionValue(input, functionValues.GetPointer());
     for(vtkIdType i=0; i<numPts; i++)
       {
-      double* pt = input->GetPoint(i);
-      double fv = this->ClipFunction->FunctionValue(pt);
+      double fv = functionValues->GetValue(i);
       int addPoint = 0;
       if (this->InsideOut)
         {
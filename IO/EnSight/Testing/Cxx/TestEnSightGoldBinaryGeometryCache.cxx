@@ -0,0 +1,415 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestEnSightGoldBinaryGeometryCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkEnSightGoldBinaryReader shares a static geometry between
+// time steps, and reads it again once the geometry file changes, even when
+// its size stays the same.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkEnSightGoldBinaryReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include "vtksys/SystemTools.hxx"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+// The unstructured part is NX x NY x NZ hexahedra, the structured part is
+// a block of BX x BY x BZ points.
+const int NX = 6, NY = 5, NZ = 4;
+const int BX = 4, BY = 3, BZ = 2;
+const int NumberOfNodes = (NX + 1) * (NY + 1) * (NZ + 1);
+const int NumberOfHexes = NX * NY * NZ;
+const int NumberOfBlockPoints = BX * BY * BZ;
+const int NumberOfBlockCells = (BX - 1) * (BY - 1) * (BZ - 1);
+
+void WriteString(FILE* fp, const char* s)
+{
+  char line[80];
+  memset(line, 0, 80);
+  strncpy(line, s, 79);
+  fwrite(line, 1, 80, fp);
+}
+
+void WriteInt(FILE* fp, int i)
+{
+  fwrite(&i, sizeof(int), 1, fp);
+}
+
+void WriteFloats(FILE* fp, const std::vector<float>& v)
+{
+  fwrite(&v[0], sizeof(float), v.size(), fp);
+}
+
+float NodeCoordinate(int node, int axis, float shift)
+{
+  int i = node % (NX + 1);
+  int j = (node / (NX + 1)) % (NY + 1);
+  int k = node / ((NX + 1) * (NY + 1));
+  return (axis == 0 ? 0.5f * i + shift : (axis == 1 ? 0.25f * j : 0.125f * k));
+}
+
+// With nodeIds, the node ids are listed, which changes the file size.
+bool WriteGeometry(const std::string& fileName, float shift, bool nodeIds)
+{
+  FILE* fp = fopen(fileName.c_str(), "wb");
+  if (!fp)
+    {
+    return false;
+    }
+  WriteString(fp, "C Binary");
+  WriteString(fp, "geometry");
+  WriteString(fp, "for the geometry cache test");
+  WriteString(fp, nodeIds ? "node id given" : "node id off");
+  WriteString(fp, "element id off");
+
+  WriteString(fp, "part");
+  WriteInt(fp, 1);
+  WriteString(fp, "hexahedra");
+  WriteString(fp, "coordinates");
+  WriteInt(fp, NumberOfNodes);
+  if (nodeIds)
+    {
+    for (int n = 0; n < NumberOfNodes; ++n)
+      {
+      WriteInt(fp, n + 1);
+      }
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    std::vector<float> x(NumberOfNodes);
+    for (int n = 0; n < NumberOfNodes; ++n)
+      {
+      x[n] = NodeCoordinate(n, axis, shift);
+      }
+    WriteFloats(fp, x);
+    }
+  WriteString(fp, "hexa8");
+  WriteInt(fp, NumberOfHexes);
+  for (int k = 0; k < NZ; ++k)
+    {
+    for (int j = 0; j < NY; ++j)
+      {
+      for (int i = 0; i < NX; ++i)
+        {
+        int p = i + (NX + 1) * (j + (NY + 1) * k);
+        int dy = NX + 1, dz = (NX + 1) * (NY + 1);
+        int hex[8] = { p, p + 1, p + dy + 1, p + dy,
+                       p + dz, p + dz + 1, p + dz + dy + 1, p + dz + dy };
+        for (int c = 0; c < 8; ++c)
+          {
+          WriteInt(fp, hex[c] + 1);
+          }
+        }
+      }
+    }
+
+  WriteString(fp, "part");
+  WriteInt(fp, 2);
+  WriteString(fp, "block");
+  WriteString(fp, "block");
+  WriteInt(fp, BX);
+  WriteInt(fp, BY);
+  WriteInt(fp, BZ);
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    std::vector<float> x(NumberOfBlockPoints);
+    for (int n = 0; n < NumberOfBlockPoints; ++n)
+      {
+      int ijk[3] = { n % BX, (n / BX) % BY, n / (BX * BY) };
+      x[n] = 10.0f + ijk[axis] + (axis == 0 ? shift : 0.0f);
+      }
+    WriteFloats(fp, x);
+    }
+  fclose(fp);
+  return true;
+}
+
+float Value(int step, int part, int i)
+{
+  return 100.0f * step + 10.0f * part + 0.5f * i;
+}
+
+bool WriteVariables(const std::string& prefix, int step)
+{
+  char suffix[16];
+  sprintf(suffix, "%04d", step);
+
+  FILE* fp = fopen((prefix + "pres" + suffix + ".scl").c_str(), "wb");
+  if (!fp)
+    {
+    return false;
+    }
+  WriteString(fp, "pres");
+  WriteString(fp, "part");
+  WriteInt(fp, 1);
+  WriteString(fp, "coordinates");
+  std::vector<float> v(NumberOfNodes);
+  for (int i = 0; i < NumberOfNodes; ++i)
+    {
+    v[i] = Value(step, 1, i);
+    }
+  WriteFloats(fp, v);
+  WriteString(fp, "part");
+  WriteInt(fp, 2);
+  WriteString(fp, "block");
+  v.resize(NumberOfBlockPoints);
+  for (int i = 0; i < NumberOfBlockPoints; ++i)
+    {
+    v[i] = Value(step, 2, i);
+    }
+  WriteFloats(fp, v);
+  fclose(fp);
+
+  fp = fopen((prefix + "temp" + suffix + ".esc").c_str(), "wb");
+  if (!fp)
+    {
+    return false;
+    }
+  WriteString(fp, "temp");
+  WriteString(fp, "part");
+  WriteInt(fp, 1);
+  WriteString(fp, "hexa8");
+  v.resize(NumberOfHexes);
+  for (int i = 0; i < NumberOfHexes; ++i)
+    {
+    v[i] = -Value(step, 1, i);
+    }
+  WriteFloats(fp, v);
+  WriteString(fp, "part");
+  WriteInt(fp, 2);
+  WriteString(fp, "block");
+  v.resize(NumberOfBlockCells);
+  for (int i = 0; i < NumberOfBlockCells; ++i)
+    {
+    v[i] = -Value(step, 2, i);
+    }
+  WriteFloats(fp, v);
+  fclose(fp);
+  return true;
+}
+
+bool WriteCase(const std::string& fileName)
+{
+  FILE* fp = fopen(fileName.c_str(), "w");
+  if (!fp)
+    {
+    return false;
+    }
+  fprintf(fp,
+    "FORMAT\n"
+    "type: ensight gold\n"
+    "GEOMETRY\n"
+    "model: TestEnSightGeometryCache.geo\n"
+    "VARIABLE\n"
+    "scalar per node: 1 pres TestEnSightGeometryCache-pres****.scl\n"
+    "scalar per element: 1 temp TestEnSightGeometryCache-temp****.esc\n"
+    "TIME\n"
+    "time set: 1\n"
+    "number of steps: 2\n"
+    "filename start number: 0\n"
+    "filename increment: 1\n"
+    "time values: 0.0 1.0\n");
+  fclose(fp);
+  return true;
+}
+
+// The parts of the output, and the arrays that hold their geometry. The
+// arrays are referenced so that their addresses are not reused.
+struct Parts
+{
+  vtkUnstructuredGrid* Hexahedra;
+  vtkStructuredGrid* Block;
+  vtkSmartPointer<vtkDataArray> HexahedraPoints;
+  vtkSmartPointer<vtkDataArray> HexahedraCells;
+  vtkSmartPointer<vtkDataArray> BlockPoints;
+};
+
+bool GetParts(vtkEnSightGoldBinaryReader* reader, Parts& parts)
+{
+  vtkMultiBlockDataSet* output = reader->GetOutput();
+  parts.Hexahedra = output->GetNumberOfBlocks() == 2 ?
+    vtkUnstructuredGrid::SafeDownCast(output->GetBlock(0)) : 0;
+  parts.Block = output->GetNumberOfBlocks() == 2 ?
+    vtkStructuredGrid::SafeDownCast(output->GetBlock(1)) : 0;
+  if (!parts.Hexahedra || !parts.Block ||
+      parts.Hexahedra->GetNumberOfPoints() != NumberOfNodes ||
+      parts.Hexahedra->GetNumberOfCells() != NumberOfHexes ||
+      parts.Block->GetNumberOfPoints() != NumberOfBlockPoints)
+    {
+    cerr << "The output does not have the expected parts" << endl;
+    return false;
+    }
+  parts.HexahedraPoints = parts.Hexahedra->GetPoints()->GetData();
+  parts.HexahedraCells = parts.Hexahedra->GetCells()->GetData();
+  parts.BlockPoints = parts.Block->GetPoints()->GetData();
+  return true;
+}
+
+bool CheckValues(vtkDataArray* array, int step, int part, float sign)
+{
+  for (vtkIdType i = 0; array && i < array->GetNumberOfTuples(); ++i)
+    {
+    if (array->GetComponent(i, 0) != sign * Value(step, part, i))
+      {
+      cerr << "Wrong value for " << array->GetName() << " at " << i
+           << " at time step " << step << endl;
+      return false;
+      }
+    }
+  return (array != 0);
+}
+
+bool CheckStep(Parts& parts, int step, float shift)
+{
+  double x[3];
+  parts.Hexahedra->GetPoint(NumberOfNodes - 1, x);
+  if (x[0] != NodeCoordinate(NumberOfNodes - 1, 0, shift))
+    {
+    cerr << "Wrong coordinates at time step " << step << endl;
+    return false;
+    }
+  return
+    CheckValues(parts.Hexahedra->GetPointData()->GetArray("pres"),
+                step, 1, 1.0f) &&
+    CheckValues(parts.Block->GetPointData()->GetArray("pres"),
+                step, 2, 1.0f) &&
+    CheckValues(parts.Hexahedra->GetCellData()->GetArray("temp"),
+                step, 1, -1.0f) &&
+    CheckValues(parts.Block->GetCellData()->GetArray("temp"),
+                step, 2, -1.0f);
+}
+}
+
+int TestEnSightGoldBinaryGeometryCache(int argc, char* argv[])
+{
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string dir = temp_dir;
+  delete [] temp_dir;
+  std::string prefix = dir + "/TestEnSightGeometryCache-";
+
+  if (!WriteGeometry(dir + "/TestEnSightGeometryCache.geo", 0.0f, false) ||
+      !WriteVariables(prefix, 0) || !WriteVariables(prefix, 1) ||
+      !WriteCase(dir + "/TestEnSightGeometryCache.case"))
+    {
+    cerr << "Could not write the case" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkEnSightGoldBinaryReader> reader;
+  reader->SetFilePath(dir.c_str());
+  reader->SetCaseFileName("TestEnSightGeometryCache.case");
+  reader->SetTimeValue(0.0);
+  reader->Update();
+  Parts first;
+  if (!GetParts(reader.GetPointer(), first) ||
+      !CheckStep(first, 0, 0.0f))
+    {
+    cerr << "Error: first time step" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The second time step shares the geometry of the first one
+  reader->SetTimeValue(1.0);
+  reader->Update();
+  Parts second;
+  if (!GetParts(reader.GetPointer(), second) ||
+      !CheckStep(second, 1, 0.0f))
+    {
+    cerr << "Error: second time step" << endl;
+    return EXIT_FAILURE;
+    }
+  if (second.HexahedraPoints != first.HexahedraPoints ||
+      second.HexahedraCells != first.HexahedraCells ||
+      second.BlockPoints != first.BlockPoints)
+    {
+    cerr << "Error: the geometry was not shared between time steps" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Once the geometry file changes, it must be read again
+  if (!WriteGeometry(dir + "/TestEnSightGeometryCache.geo", 2.0f, true))
+    {
+    cerr << "Could not write the geometry" << endl;
+    return EXIT_FAILURE;
+    }
+  reader->SetTimeValue(0.0);
+  reader->Update();
+  Parts third;
+  if (!GetParts(reader.GetPointer(), third) ||
+      !CheckStep(third, 0, 2.0f))
+    {
+    cerr << "Error: changed geometry" << endl;
+    return EXIT_FAILURE;
+    }
+  if (third.HexahedraPoints == first.HexahedraPoints ||
+      third.BlockPoints == first.BlockPoints)
+    {
+    cerr << "Error: the changed geometry was not read again" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A rewrite of the same size is noticed as long as the file system gives
+  // it another modification time, even within the same second.  Write it
+  // next to the geometry file and move it over it, to compare the times.
+  std::string geometryName = dir + "/TestEnSightGeometryCache.geo";
+  std::string rewriteName = dir + "/TestEnSightGeometryCacheRewrite.geo";
+  if (!WriteGeometry(rewriteName, 3.0f, true))
+    {
+    cerr << "Could not write the geometry" << endl;
+    return EXIT_FAILURE;
+    }
+  int result = 0;
+  bool newer =
+    (vtksys::SystemTools::FileTimeCompare(geometryName, rewriteName,
+                                          &result) && result != 0);
+  if (rename(rewriteName.c_str(), geometryName.c_str()) != 0)
+    {
+    cerr << "Could not replace the geometry" << endl;
+    return EXIT_FAILURE;
+    }
+  if (newer)
+    {
+    reader->SetTimeValue(1.0);
+    reader->Update();
+    Parts fourth;
+    if (!GetParts(reader.GetPointer(), fourth) ||
+        !CheckStep(fourth, 1, 3.0f))
+      {
+      cerr << "Error: geometry rewritten with the same size" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
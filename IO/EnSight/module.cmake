@@ -3,6 +3,11 @@ vtk_module(vtkIOEnSight
     StandAlone
   DEPENDS
     vtkCommonExecutionModel
+  PRIVATE_DEPENDS
+    vtksys
+  TEST_DEPENDS
+    vtkTestingCore
+    vtksys
   KIT
     vtkIO
   )
@@ -21,13 +21,19 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkPoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include "vtksys/Configure.hxx"
+
 #include <sys/stat.h>
 #include <ctype.h>
 #include <string>
@@ -49,13 +55,143 @@ class vtkEnSightGoldBinaryReader::FileOffsetMapInternal
 };
 
 
+class vtkEnSightGoldBinaryReader::GeometryCacheInternal
+{
+  public:
+    GeometryCacheInternal() : TimeStep(0), ModificationTime(0),
+      ModificationTimeNanoseconds(0), Size(0), RequestedByteOrder(0),
+      ByteOrder(0), NodeIdsListed(0), ElementIdsListed(0),
+      NumberOfGeometryParts(0), NumberOfNewOutputs(0)
+    {
+    }
+    std::string FileName;
+    int TimeStep;
+    time_t ModificationTime;
+    long ModificationTimeNanoseconds;
+    off_t Size;
+    int RequestedByteOrder;
+    int ByteOrder;
+    int NodeIdsListed;
+    int ElementIdsListed;
+    int NumberOfGeometryParts;
+    int NumberOfNewOutputs;
+    vtkSmartPointer<vtkMultiBlockDataSet> Parts;
+};
+
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+namespace
+{
+// The fraction of a second of the modification time of a file, where the
+// platform records it.
+long GetModificationTimeNanoseconds(const struct stat &fs)
+{
+#if vtksys_STAT_HAS_ST_MTIM
+  return static_cast<long>(fs.st_mtim.tv_nsec);
+#else
+  (void)fs;
+  return 0;
+#endif
+}
+
+// The path InitializeFile() opens fileName with.
+std::string GetFullFileName(const char* filePath, const char* fileName)
+{
+  std::string sfilename;
+  if (filePath)
+    {
+    sfilename = filePath;
+    if (sfilename.at(sfilename.length()-1) != '/')
+      {
+      sfilename += "/";
+      }
+    }
+  sfilename += fileName;
+  return sfilename;
+}
+
+// Swaps the 4-byte words of a range from the byte order of the file,
+// concurrently.
+class SwapWords4Functor
+{
+public:
+  char *Words;
+  bool LittleEndian;
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    if (this->LittleEndian)
+      {
+      vtkByteSwap::Swap4LERange(this->Words + 4 * begin, end - begin);
+      }
+    else
+      {
+      vtkByteSwap::Swap4BERange(this->Words + 4 * begin, end - begin);
+      }
+  }
+};
+
+void SwapWords4(void *words, vtkIdType numWords, bool littleEndian)
+{
+  SwapWords4Functor swapper;
+  swapper.Words = static_cast<char*>(words);
+  swapper.LittleEndian = littleEndian;
+  vtkSMPTools::For(0, numWords, 65536, swapper);
+}
+
+// Stores the i-th values of numComponents arrays as the components
+// firstComponent, firstComponent + 1, ... of tuple ids[i] of an array,
+// or of tuple i when there are no ids, concurrently.
+class ScatterComponentsFunctor
+{
+public:
+  const float * const *Components;
+  int NumberOfComponents;
+  float *Output;
+  int OutputComponents;
+  const vtkIdType *Ids;
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      float *tuple = this->Output +
+        (this->Ids ? this->Ids[i] : i) * this->OutputComponents;
+      for (int j = 0; j < this->NumberOfComponents; j++)
+        {
+        tuple[j] = this->Components[j][i];
+        }
+      }
+  }
+};
+
+void ScatterComponents(vtkFloatArray *output, int firstComponent,
+  const float * const *components, int numComponents, vtkIdType numValues,
+  vtkIdList *ids = NULL)
+{
+  ScatterComponentsFunctor scatter;
+  scatter.Components = components;
+  scatter.NumberOfComponents = numComponents;
+  scatter.Output = output->GetPointer(0) + firstComponent;
+  scatter.OutputComponents = output->GetNumberOfComponents();
+  scatter.Ids = ids ? ids->GetPointer(0) : NULL;
+  vtkSMPTools::For(0, numValues, 16384, scatter);
+}
+
+// The points of coordinates arrays x, y and z.
+void ScatterComponents(vtkPoints *points, const float * const *coords,
+  vtkIdType numPoints)
+{
+  points->SetNumberOfPoints(numPoints);
+  ScatterComponents(vtkFloatArray::SafeDownCast(points->GetData()), 0,
+    coords, 3, numPoints);
+}
+}
+
 //----------------------------------------------------------------------------
 vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
 {
   this->FileOffsets = new vtkEnSightGoldBinaryReader::FileOffsetMapInternal;
+  this->GeometryCache = new vtkEnSightGoldBinaryReader::GeometryCacheInternal;
 
   this->IFile = NULL;
   this->FileSize = 0;
@@ -69,6 +205,7 @@ vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
 vtkEnSightGoldBinaryReader::~vtkEnSightGoldBinaryReader()
 {
   delete this->FileOffsets;
+  delete this->GeometryCache;
 
   if (this->IFile)
     {
@@ -253,6 +390,12 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
   int partId, realId;
   int lineRead, i;
 
+  if (this->ReadCachedGeometry(fileName, timeStep, output))
+    {
+    return 1;
+    }
+  const int byteOrder = this->ByteOrder;
+
   if (!this->InitializeFile(fileName))
     {
     return 0;
@@ -427,9 +570,106 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
     return 0;
     }
 
+  this->CacheGeometry(fileName, timeStep, byteOrder, output);
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkEnSightGoldBinaryReader::ReadCachedGeometry(const char* fileName,
+  int timeStep, vtkMultiBlockDataSet *output)
+{
+  GeometryCacheInternal *cache = this->GeometryCache;
+  struct stat fs;
+  if (!cache->Parts || !fileName ||
+    cache->FileName != GetFullFileName(this->FilePath, fileName) ||
+    (this->UseFileSets && cache->TimeStep != timeStep) ||
+    (cache->RequestedByteOrder != this->ByteOrder &&
+      cache->ByteOrder != this->ByteOrder) ||
+    stat(cache->FileName.c_str(), &fs) != 0 ||
+    cache->ModificationTime != fs.st_mtime ||
+    cache->ModificationTimeNanoseconds != GetModificationTimeNanoseconds(fs) ||
+    cache->Size != fs.st_size)
+    {
+    cache->Parts = NULL;
+    return 0;
+    }
+
+  vtkDebugMacro("using the cached geometry of " << cache->FileName.c_str());
+  // The state the geometry file sets for the variable files.
+  this->ByteOrder = cache->ByteOrder;
+  this->NodeIdsListed = cache->NodeIdsListed;
+  this->ElementIdsListed = cache->ElementIdsListed;
+  this->NumberOfGeometryParts += cache->NumberOfGeometryParts;
+  this->NumberOfNewOutputs += cache->NumberOfNewOutputs;
+
+  // Shallow copies, so that the variables added to the output do not end
+  // up in the cache.
+  unsigned int numBlocks = cache->Parts->GetNumberOfBlocks();
+  output->SetNumberOfBlocks(numBlocks);
+  for (unsigned int i = 0; i < numBlocks; i++)
+    {
+    vtkDataSet *part = this->GetDataSetFromBlock(cache->Parts, i);
+    if (part)
+      {
+      vtkDataSet *copy = part->NewInstance();
+      copy->ShallowCopy(part);
+      this->AddToBlock(output, i, copy);
+      copy->Delete();
+      }
+    if (cache->Parts->HasMetaData(i) &&
+      cache->Parts->GetMetaData(i)->Has(vtkCompositeDataSet::NAME()))
+      {
+      this->SetBlockName(output, i,
+        cache->Parts->GetMetaData(i)->Get(vtkCompositeDataSet::NAME()));
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkEnSightGoldBinaryReader::CacheGeometry(const char* fileName,
+  int timeStep, int byteOrder, vtkMultiBlockDataSet *output)
+{
+  GeometryCacheInternal *cache = this->GeometryCache;
+  cache->FileName = GetFullFileName(this->FilePath, fileName);
+  struct stat fs;
+  if (stat(cache->FileName.c_str(), &fs) != 0)
+    {
+    cache->Parts = NULL;
+    return;
+    }
+  cache->TimeStep = timeStep;
+  cache->ModificationTime = fs.st_mtime;
+  cache->ModificationTimeNanoseconds = GetModificationTimeNanoseconds(fs);
+  cache->Size = fs.st_size;
+  cache->RequestedByteOrder = byteOrder;
+  cache->ByteOrder = this->ByteOrder;
+  cache->NodeIdsListed = this->NodeIdsListed;
+  cache->ElementIdsListed = this->ElementIdsListed;
+  cache->NumberOfGeometryParts = this->NumberOfGeometryParts;
+  cache->NumberOfNewOutputs = this->NumberOfNewOutputs;
+
+  cache->Parts = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  unsigned int numBlocks = output->GetNumberOfBlocks();
+  cache->Parts->SetNumberOfBlocks(numBlocks);
+  for (unsigned int i = 0; i < numBlocks; i++)
+    {
+    vtkDataSet *part = this->GetDataSetFromBlock(output, i);
+    if (part)
+      {
+      vtkDataSet *copy = part->NewInstance();
+      copy->ShallowCopy(part);
+      cache->Parts->SetBlock(i, copy);
+      copy->Delete();
+      }
+    if (output->HasMetaData(i) &&
+      output->GetMetaData(i)->Has(vtkCompositeDataSet::NAME()))
+      {
+      cache->Parts->GetMetaData(i)->Set(vtkCompositeDataSet::NAME(),
+        output->GetMetaData(i)->Get(vtkCompositeDataSet::NAME()));
+      }
+    }
+}
 
 //----------------------------------------------------------------------------
 int vtkEnSightGoldBinaryReader::CountTimeSteps()
@@ -1410,10 +1650,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerNode(
       // For complex scalars, there is a file for the real part and another
       // file for the imaginary part, but we are storing them as a 2-component
       // array.
-      for (i = 0; i < numPts; i++)
-        {
-        scalars->SetComponent(i, component, scalarsRead[i]);
-        }
+      ScatterComponents(scalars, component, &scalarsRead, 1, numPts);
       scalars->SetName(description);
       output->GetPointData()->AddArray(scalars);
       if (!output->GetPointData()->GetScalars())
@@ -1460,10 +1697,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerNode(
       scalarsRead = new float[numPts];
       this->ReadFloatArray(scalarsRead, numPts);
 
-      for (i = 0; i < numPts; i++)
-        {
-        scalars->SetComponent(i, component, scalarsRead[i]);
-        }
+      ScatterComponents(scalars, component, &scalarsRead, 1, numPts);
       if (component == 0)
         {
         scalars->SetName(description);
@@ -1507,7 +1741,6 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerNode(
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *vectors;
-  float tuple[3];
   float *comp1, *comp2, *comp3;
   float *vectorsRead;
   vtkDataSet *output;
@@ -1651,13 +1884,8 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerNode(
       this->ReadFloatArray(comp1, numPts);
       this->ReadFloatArray(comp2, numPts);
       this->ReadFloatArray(comp3, numPts);
-      for (i = 0; i < numPts; i++)
-        {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        vectors->SetTuple(i, tuple);
-        }
+      const float *comps[3] = { comp1, comp2, comp3 };
+      ScatterComponents(vectors, 0, comps, 3, numPts);
       vectors->SetName(description);
       output->GetPointData()->AddArray(vectors);
       if (!output->GetPointData()->GetVectors())
@@ -1698,7 +1926,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerNode(
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *tensors;
   float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
   vtkDataSet *output;
 
   // Initialize
@@ -1800,16 +2027,8 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerNode(
       this->ReadFloatArray(comp4, numPts);
       this->ReadFloatArray(comp5, numPts);
       this->ReadFloatArray(comp6, numPts);
-      for (i = 0; i < numPts; i++)
-        {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        tuple[3] = comp4[i];
-        tuple[4] = comp5[i];
-        tuple[5] = comp6[i];
-        tensors->InsertTuple(i, tuple);
-        }
+      const float *comps[6] = { comp1, comp2, comp3, comp4, comp5, comp6 };
+      ScatterComponents(tensors, 0, comps, 6, numPts);
       tensors->SetName(description);
       output->GetPointData()->AddArray(tensors);
       tensors->Delete();
@@ -1991,10 +2210,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
         {
         scalarsRead = new float[numCells];
         this->ReadFloatArray(scalarsRead, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          scalars->SetComponent(i, component, scalarsRead[i]);
-          }
+        ScatterComponents(scalars, component, &scalarsRead, 1, numCells);
         if (this->IFile->eof())
           {
           lineRead = 0;
@@ -2031,11 +2247,8 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
           scalarsRead = new float[numCellsPerElement];
           this->ReadFloatArray(scalarsRead, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            scalars->SetComponent(this->GetCellIds(idx, elementType)->GetId(i),
-              component, scalarsRead[i]);
-            }
+          ScatterComponents(scalars, component, &scalarsRead, 1,
+            numCellsPerElement, this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2096,7 +2309,6 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
   vtkFloatArray *vectors;
   float *comp1, *comp2, *comp3;
   int lineRead, elementType;
-  float tuple[3];
   vtkDataSet *output;
 
   // Initialize
@@ -2230,13 +2442,8 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
         this->ReadFloatArray(comp1, numCells);
         this->ReadFloatArray(comp2, numCells);
         this->ReadFloatArray(comp3, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          vectors->SetTuple(i, tuple);
-          }
+        const float *comps[3] = { comp1, comp2, comp3 };
+        ScatterComponents(vectors, 0, comps, 3, numCells);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2273,14 +2480,9 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
           this->ReadFloatArray(comp1, numCellsPerElement);
           this->ReadFloatArray(comp2, numCellsPerElement);
           this->ReadFloatArray(comp3, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            vectors->SetTuple(this->GetCellIds(idx, elementType)->GetId(i),
-              tuple);
-            }
+          const float *comps[3] = { comp1, comp2, comp3 };
+          ScatterComponents(vectors, 0, comps, 3, numCellsPerElement,
+            this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2336,7 +2538,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
   vtkFloatArray *tensors;
   int lineRead, elementType;
   float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
   vtkDataSet *output;
 
   // Initialize
@@ -2477,16 +2678,8 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
         this->ReadFloatArray(comp4, numCells);
         this->ReadFloatArray(comp5, numCells);
         this->ReadFloatArray(comp6, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          tuple[3] = comp4[i];
-          tuple[4] = comp5[i];
-          tuple[5] = comp6[i];
-          tensors->InsertTuple(i, tuple);
-          }
+        const float *comps[6] = { comp1, comp2, comp3, comp4, comp5, comp6 };
+        ScatterComponents(tensors, 0, comps, 6, numCells);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2532,17 +2725,9 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
           this->ReadFloatArray(comp4, numCellsPerElement);
           this->ReadFloatArray(comp5, numCellsPerElement);
           this->ReadFloatArray(comp6, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            tuple[3] = comp4[i];
-            tuple[4] = comp5[i];
-            tuple[5] = comp6[i];
-            tensors->InsertTuple(this->GetCellIds(idx, elementType)->GetId(i),
-              tuple);
-            }
+          const float *comps[6] = { comp1, comp2, comp3, comp4, comp5, comp6 };
+          ScatterComponents(tensors, 0, comps, 6, numCellsPerElement,
+            this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2643,8 +2828,6 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       vtkPoints *points = vtkPoints::New();
       vtkDebugMacro("num. points: " << numPts);
 
-      points->Allocate(numPts);
-
       if (this->NodeIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numPts, ios::cur);
@@ -2657,10 +2840,8 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       this->ReadFloatArray(yCoords, numPts);
       this->ReadFloatArray(zCoords, numPts);
 
-      for (i = 0; i < numPts; i++)
-        {
-        points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-        }
+      const float *coords[3] = { xCoords, yCoords, zCoords };
+      ScatterComponents(points, coords, numPts);
 
       output->SetPoints(points);
       points->Delete();
@@ -3751,7 +3932,6 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
     return -1;
     }
   output->SetDimensions(dimensions);
-  points->Allocate(numPts);
 
   xCoords = new float[numPts];
   yCoords = new float[numPts];
@@ -3760,10 +3940,8 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
   this->ReadFloatArray(yCoords, numPts);
   this->ReadFloatArray(zCoords, numPts);
 
-  for (i = 0; i < numPts; i++)
-    {
-    points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-    }
+  const float *coords[3] = { xCoords, yCoords, zCoords };
+  ScatterComponents(points, coords, numPts);
   output->SetPoints(points);
   if (iblanked)
     {
@@ -4129,14 +4307,7 @@ int vtkEnSightGoldBinaryReader::ReadIntArray(int *result,
     return 0;
     }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-    {
-    vtkByteSwap::Swap4LERange(result, numInts);
-    }
-  else
-    {
-    vtkByteSwap::Swap4BERange(result, numInts);
-    }
+  SwapWords4(result, numInts, this->ByteOrder == FILE_LITTLE_ENDIAN);
 
   if (this->Fortran)
     {
@@ -4217,14 +4388,7 @@ int vtkEnSightGoldBinaryReader::ReadFloatArray(float *result,
     return 0;
     }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-    {
-    vtkByteSwap::Swap4LERange(result, numFloats);
-    }
-  else
-    {
-    vtkByteSwap::Swap4BERange(result, numFloats);
-    }
+  SwapWords4(result, numFloats, this->ByteOrder == FILE_LITTLE_ENDIAN);
 
   if (this->Fortran)
     {
@@ -31,6 +31,14 @@
 // what types they will be.
 // This reader can only handle static EnSight datasets (both static geometry
 // and variables).
+//
+// The parts of the geometry read last are kept, so that the time steps of a
+// case with a static geometry file share them (including their cell
+// connectivity) instead of reading the geometry again. The cache is keyed
+// on the geometry file, its size, its modification time and, with file
+// sets, the time step in it. Where the platform or the file system only
+// records the modification time to the second, a geometry file that is
+// rewritten with the same size within the same second is not noticed.
 // .SECTION Thanks
 // Thanks to Yvan Fournier for providing the code to support nfaced elements.
 
@@ -199,6 +207,18 @@ protected:
   // Read the file index, if available, and add it to the time step cache
   void AddFileIndexToCache(const char* fileName);
 
+  // Description:
+  // Fill output with the parts of the geometry cached for fileName and
+  // timeStep, if any. Returns 1 if the cache was used.
+  int ReadCachedGeometry(const char* fileName, int timeStep,
+                         vtkMultiBlockDataSet *output);
+
+  // Description:
+  // Keep the parts of the geometry just read from fileName into output.
+  // byteOrder is the ByteOrder set before the file was read.
+  void CacheGeometry(const char* fileName, int timeStep, int byteOrder,
+                     vtkMultiBlockDataSet *output);
+
   int NodeIdsListed;
   int ElementIdsListed;
   int Fortran;
@@ -210,6 +230,8 @@ protected:
   //BTX
   class FileOffsetMapInternal;
   FileOffsetMapInternal *FileOffsets;
+  class GeometryCacheInternal;
+  GeometryCacheInternal *GeometryCache;
   //ETX
 
 private:
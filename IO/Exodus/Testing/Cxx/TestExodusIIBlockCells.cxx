@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExodusIIBlockCells.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the cells of an element block read by vtkExodusIIReader, with and
+// without SqueezePoints. Squeezed points must be numbered in the order that
+// the cells first use them.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkExodusIIReader.h"
+#include "vtkExodusIIWriter.h"
+#include "vtkIntArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <string>
+
+namespace
+{
+// A block of n x n x n hexahedra.
+void MakeGrid(vtkUnstructuredGrid* grid, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= n; ++k)
+    {
+    for (int j = 0; j <= n; ++j)
+      {
+      for (int i = 0; i <= n; ++i)
+        {
+        points->InsertNextPoint(i, j, 1.5 * k);
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate(n * n * n);
+  vtkIdType d = (n + 1) * (n + 1);
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        vtkIdType p = (k * (n + 1) + j) * (n + 1) + i;
+        vtkIdType hex[8] = { p, p + 1, p + n + 2, p + n + 1,
+                             p + d, p + d + 1, p + d + n + 2, p + d + n + 1 };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        }
+      }
+    }
+  vtkNew<vtkIntArray> blockIds;
+  blockIds->SetName("ObjectId");
+  blockIds->SetNumberOfTuples(grid->GetNumberOfCells());
+  blockIds->FillComponent(0, 1);
+  grid->GetCellData()->AddArray(blockIds.GetPointer());
+}
+
+bool TestRead(const std::string& fileName, vtkUnstructuredGrid* grid,
+              bool squeeze)
+{
+  vtkNew<vtkExodusIIReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  reader->SetAllArrayStatus(vtkExodusIIReader::ELEM_BLOCK, 1);
+  reader->SetSqueezePoints(squeeze);
+  reader->Update();
+
+  vtkMultiBlockDataSet* blocks = vtkMultiBlockDataSet::SafeDownCast(
+    reader->GetOutput()->GetBlock(0));
+  vtkUnstructuredGrid* output = blocks ?
+    vtkUnstructuredGrid::SafeDownCast(blocks->GetBlock(0)) : 0;
+  if (!output || output->GetNumberOfCells() != grid->GetNumberOfCells())
+    {
+    cerr << "Wrong number of cells" << endl;
+    return false;
+    }
+
+  vtkIdType nextId = 0;
+  for (vtkIdType c = 0; c < grid->GetNumberOfCells(); ++c)
+    {
+    vtkIdType n1, *ids1, n2, *ids2;
+    grid->GetCellPoints(c, n1, ids1);
+    output->GetCellPoints(c, n2, ids2);
+    if (output->GetCellType(c) != VTK_HEXAHEDRON || n1 != n2)
+      {
+      cerr << "Wrong type or size for cell " << c << endl;
+      return false;
+      }
+    for (vtkIdType p = 0; p < n1; ++p)
+      {
+      if (squeeze)
+        {
+        if (ids2[p] > nextId)
+          {
+          cerr << "Point " << ids2[p] << " of cell " << c
+               << " is not numbered by first use" << endl;
+          return false;
+          }
+        nextId += (ids2[p] == nextId);
+        }
+      double x1[3], x2[3];
+      grid->GetPoint(ids1[p], x1);
+      output->GetPoint(ids2[p], x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+        {
+        cerr << "Wrong point " << p << " for cell " << c << endl;
+        return false;
+        }
+      }
+    }
+  if (squeeze && output->GetNumberOfPoints() != nextId)
+    {
+    cerr << "Expected " << nextId << " squeezed points, got "
+         << output->GetNumberOfPoints() << endl;
+    return false;
+    }
+
+  return true;
+}
+}
+
+int TestExodusIIBlockCells(int argc, char* argv[])
+{
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string fileName = temp_dir;
+  delete [] temp_dir;
+  fileName += "/TestExodusIIBlockCells.exo";
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 6);
+
+  vtkNew<vtkExodusIIWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(grid.GetPointer());
+  writer->WriteAllTimeStepsOff();
+  writer->Write();
+
+  int result = EXIT_SUCCESS;
+  if (!TestRead(fileName, grid.GetPointer(), true))
+    {
+    cerr << "Error: SqueezePoints on" << endl;
+    result = EXIT_FAILURE;
+    }
+  if (!TestRead(fileName, grid.GetPointer(), false))
+    {
+    cerr << "Error: SqueezePoints off" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -0,0 +1,93 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExodusIICache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkExodusIICache drops time-varying arrays before the
+// time-invariant ones, whatever the order they were used in.
+
+#include "vtkDoubleArray.h"
+#include "vtkExodusIICache.h"
+#include "vtkExodusIIReader.h"
+#include "vtkNew.h"
+
+namespace
+{
+// An array of about 1 MiB.
+void InsertArray(vtkExodusIICache* cache, vtkExodusIICacheKey key)
+{
+  vtkDoubleArray* arr = vtkDoubleArray::New();
+  arr->SetNumberOfTuples(131072);
+  cache->Insert(key, arr);
+  arr->Delete();
+}
+
+bool Has(vtkExodusIICache* cache, const vtkExodusIICacheKey& key)
+{
+  return cache->Find(key) != NULL;
+}
+}
+
+int TestExodusIICache(int, char*[])
+{
+  vtkNew<vtkExodusIICache> cache;
+  cache->SetCacheCapacity(4.5);
+
+  vtkExodusIICacheKey conn(-1, vtkExodusIIReader::ELEM_BLOCK_ELEM_CONN, 0, 0);
+  vtkExodusIICacheKey coords(-1, vtkExodusIIReader::NODAL_COORDS, 0, 0);
+  InsertArray(cache.GetPointer(), conn);
+  InsertArray(cache.GetPointer(), coords);
+
+  // Sweep through time steps: the connectivity and coordinates are used at
+  // every step, but have become the least recently used entries when the
+  // next time step's arrays are inserted.
+  for (int t = 0; t < 10; ++t)
+    {
+    InsertArray(cache.GetPointer(),
+      vtkExodusIICacheKey(t, vtkExodusIIReader::NODAL, 0, 0));
+    InsertArray(cache.GetPointer(),
+      vtkExodusIICacheKey(t, vtkExodusIIReader::ELEM_BLOCK, 0, 0));
+    if (!Has(cache.GetPointer(), conn) || !Has(cache.GetPointer(), coords))
+      {
+      cerr << "Time-invariant arrays dropped at time step " << t << endl;
+      return EXIT_FAILURE;
+      }
+    if (t > 0 &&
+        Has(cache.GetPointer(),
+          vtkExodusIICacheKey(t - 1, vtkExodusIIReader::NODAL, 0, 0)))
+      {
+      cerr << "Time-varying array kept at time step " << t << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Time-invariant arrays still go when nothing else is left to drop.
+  cache->SetCacheCapacity(1.5);
+  if (Has(cache.GetPointer(), conn) && Has(cache.GetPointer(), coords))
+    {
+    cerr << "Cache capacity exceeded" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Invalidating entries must keep both lists consistent.
+  InsertArray(cache.GetPointer(), conn);
+  cache->Invalidate(conn);
+  cache->Invalidate(coords);
+  cache->Clear();
+  if (cache->GetSpaceLeft() != 1.5)
+    {
+    cerr << "Cache not empty after Clear()" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
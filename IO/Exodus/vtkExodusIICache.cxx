@@ -85,6 +85,7 @@ void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
   os << indent << "Size: " << this->Size << " MiB\n";
   os << indent << "Cache: " << &this->Cache << " (" << this->Cache.size() << ")\n";
   os << indent << "LRU: " << &this->LRU << "\n";
+  os << indent << "PinnedLRU: " << &this->PinnedLRU << "\n";
 }
 
 void vtkExodusIICache::Clear()
@@ -109,9 +110,12 @@ void vtkExodusIICache::SetCacheCapacity( double sizeInMiB )
 int vtkExodusIICache::ReduceToSize( double newSize )
 {
   int deletedSomething = 0;
-  while ( this->Size > newSize && ! this->LRU.empty() )
+  while ( this->Size > newSize &&
+    ! ( this->LRU.empty() && this->PinnedLRU.empty() ) )
     {
-    vtkExodusIICacheRef cit( this->LRU.back() );
+    // Time-invariant entries only go once all the others are gone.
+    vtkExodusIICacheLRU& lru = this->LRU.empty() ? this->PinnedLRU : this->LRU;
+    vtkExodusIICacheRef cit( lru.back() );
     vtkDataArray* arr = cit->second->Value;
     if ( arr )
       {
@@ -138,7 +142,7 @@ int vtkExodusIICache::ReduceToSize( double newSize )
 
     delete cit->second;
     this->Cache.erase( cit );
-    this->LRU.pop_back();
+    lru.pop_back();
     }
 
   if ( this->Cache.size() == 0 )
@@ -173,8 +177,9 @@ void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Replacing " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
+    vtkExodusIICacheLRU& lru = this->GetLRU( key );
+    lru.erase( it->second->LRUEntry );
+    it->second->LRUEntry = lru.insert( lru.begin(), it );
     }
   else
     {
@@ -185,7 +190,8 @@ void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Adding " << VTK_EXO_PRT_KEY( key ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    iret.first->second->LRUEntry = this->LRU.insert( this->LRU.begin(), iret.first );
+    vtkExodusIICacheLRU& lru = this->GetLRU( key );
+    iret.first->second->LRUEntry = lru.insert( lru.begin(), iret.first );
     }
   //printCache( this->Cache, this->LRU );
 }
@@ -197,8 +203,9 @@ vtkDataArray*& vtkExodusIICache::Find( vtkExodusIICacheKey key )
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
     {
-    this->LRU.erase( it->second->LRUEntry );
-    it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
+    vtkExodusIICacheLRU& lru = this->GetLRU( key );
+    lru.erase( it->second->LRUEntry );
+    it->second->LRUEntry = lru.insert( lru.begin(), it );
     return it->second->Value;
     }
 
@@ -214,7 +221,7 @@ int vtkExodusIICache::Invalidate( vtkExodusIICacheKey key )
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
+    this->GetLRU( it->first ).erase( it->second->LRUEntry );
     if ( it->second->Value )
       {
       this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
@@ -251,7 +258,7 @@ int vtkExodusIICache::Invalidate( vtkExodusIICacheKey key, vtkExodusIICacheKey p
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
+    this->GetLRU( it->first ).erase( it->second->LRUEntry );
     if ( it->second->Value )
       {
       this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
@@ -22,6 +22,11 @@
 // entries O(1). Each cache entry stores an iterator into
 // the list of references so that it can be located quickly for
 // removal.
+//
+// Entries whose key has a negative timestep do not vary with time
+// (connectivity, coordinates of undeformed meshes, maps, ...). They are
+// kept in a separate LRU list and are only dropped once no time-varying
+// entry is left, so that sweeping through time steps does not evict them.
 
 #include "vtkIOExodusModule.h" // For export macro
 #include "vtkObject.h"
@@ -206,6 +211,13 @@ protected:
 
   /// The actual LRU list (indices into the cache ordered least to most recently used).
   vtkExodusIICacheLRU LRU;
+
+  /// The LRU list of the time-invariant entries, which are dropped after those in LRU.
+  vtkExodusIICacheLRU PinnedLRU;
+
+  /// The LRU list that holds the entry with the given key.
+  vtkExodusIICacheLRU& GetLRU( const vtkExodusIICacheKey& key )
+    { return key.Time < 0 ? this->PinnedLRU : this->LRU; }
   //ETX
 
 private:
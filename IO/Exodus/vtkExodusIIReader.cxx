@@ -37,6 +37,7 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -373,6 +374,134 @@ void vtkExodusIIReaderPrivate::ArrayInfoType::Reset()
   this->ObjectTruth.clear();
 }
 
+// --------------------------------------------------- PARALLEL CONVERSION HELPERS
+// Exodus access goes through netCDF, which is not thread-safe, so arrays are
+// read serially. Converting what was read into VTK arrays is split across
+// threads with vtkSMPTools.
+namespace
+{
+// Interleaves components that were read separately into an array.
+// Components of the array past those read (2-D vectors promoted to 3-D)
+// are set to 0.
+template<typename T>
+class vtkExodusIIInterleaveFunctor
+{
+public:
+  vtkExodusIIInterleaveFunctor(
+    T* data, int numComps, const std::vector<std::vector<double> >& src ):
+    Data( data ), NumComps( numComps ), Src( src )
+    {
+    }
+
+  void operator()( vtkIdType begin, vtkIdType end ) const
+    {
+    int numSrc = static_cast<int>( this->Src.size() );
+    for ( vtkIdType t = begin; t < end; ++t )
+      {
+      T* tuple = this->Data + t * this->NumComps;
+      int c;
+      for ( c = 0; c < numSrc; ++c )
+        {
+        tuple[c] = static_cast<T>( this->Src[c][t] );
+        }
+      for ( ; c < this->NumComps; ++c )
+        {
+        tuple[c] = static_cast<T>( 0 );
+        }
+      }
+    }
+
+protected:
+  T* Data;
+  int NumComps;
+  const std::vector<std::vector<double> >& Src;
+};
+
+template<typename T>
+void vtkExodusIIInterleave(
+  T* data, vtkDataArray* arr, const std::vector<std::vector<double> >& src )
+{
+  vtkExodusIIInterleaveFunctor<T> functor(
+    data, arr->GetNumberOfComponents(), src );
+  vtkSMPTools::For( 0, arr->GetNumberOfTuples(), functor );
+}
+
+// Converts 1-based Exodus ids to 0-based VTK ids in place.
+class vtkExodusIIToZeroBasedFunctor
+{
+public:
+  vtkExodusIIToZeroBasedFunctor( int* ids ): Ids( ids ) { }
+
+  void operator()( vtkIdType begin, vtkIdType end ) const
+    {
+    for ( vtkIdType i = begin; i < end; ++i )
+      {
+      --this->Ids[i];
+      }
+    }
+
+protected:
+  int* Ids;
+};
+
+// Fills the connectivity of a vtkCellArray whose cells all have the same
+// number of points. If a point map is given, the ids are squeezed through
+// it; it must already hold every id, so that it is only read here.
+class vtkExodusIIFillCellsFunctor
+{
+public:
+  vtkExodusIIFillCellsFunctor( const int* src, int numPts, vtkIdType* dest,
+    const std::map<vtkIdType,vtkIdType>* pointMap ):
+    Src( src ), NumPts( numPts ), Dest( dest ), PointMap( pointMap )
+    {
+    }
+
+  void operator()( vtkIdType begin, vtkIdType end ) const
+    {
+    const int* src = this->Src + begin * this->NumPts;
+    vtkIdType* dest = this->Dest + begin * ( this->NumPts + 1 );
+    for ( vtkIdType i = begin; i < end; ++i )
+      {
+      *dest++ = this->NumPts;
+      if ( this->PointMap )
+        {
+        for ( int p = 0; p < this->NumPts; ++p )
+          {
+          // Negative ids were mapped as 0, as in GetSqueezePointId()
+          vtkIdType id = ( *src < 0 ? 0 : *src );
+          *dest++ = this->PointMap->find( id )->second;
+          ++src;
+          }
+        }
+      else
+        {
+        for ( int p = 0; p < this->NumPts; ++p )
+          {
+          *dest++ = *src++;
+          }
+        }
+      }
+    }
+
+protected:
+  const int* Src;
+  int NumPts;
+  vtkIdType* Dest;
+  const std::map<vtkIdType,vtkIdType>* PointMap;
+};
+}
+
+// Interleaves components that were read separately into arr.
+static void vtkExodusIIInterleaveComponents(
+  vtkDataArray* arr, const std::vector<std::vector<double> >& src )
+{
+  switch ( arr->GetDataType() )
+    {
+    vtkTemplateMacro( vtkExodusIIInterleave(
+        static_cast<VTK_TT*>( arr->GetVoidPointer( 0 ) ), arr, src ) );
+    }
+}
+
 // ------------------------------------------------------- PRIVATE CLASS MEMBERS
 vtkStandardNewMacro(vtkExodusIIReaderPrivate);
 
@@ -559,9 +688,8 @@ int vtkExodusIIReaderPrivate::AssembleOutputConnectivity(
   // Might want to experiment with the effectiveness of caching connectivity...
   //   set up the ExodusIICache class with the ability to never cache some
   //   key types.
-  // Might also want to experiment with policies other than LRU, especially
-  //   applied to arrays that are not time-varying. During animations, they
-  //   will most likely get dropped even though that might not be wise.
+  // Arrays that are not time-varying are only dropped from the cache once
+  //   all time-varying arrays are gone, so they survive animations.
 
   if ( CONNTYPE_IS_BLOCK(conntypidx) )
     {
@@ -1276,7 +1404,36 @@ void vtkExodusIIReaderPrivate::InsertBlockCells(
     return;
     }
 
-  if (this->SqueezePoints)
+  if ( ! ent )
+    {
+    // All cells have the same number of points, so the cell array can be
+    // filled concurrently. Squeezed point ids are numbered in the order
+    // that the points are first used, so they are assigned serially first
+    // and only looked up while filling.
+    vtkIdType numCells = binfo->Size;
+    const std::map<vtkIdType,vtkIdType>* pointMap = 0;
+    if ( this->SqueezePoints )
+      {
+      const int* srcIds = arr->GetPointer( 0 );
+      vtkIdType numIds = numCells * binfo->PointsPerCell;
+      for ( vtkIdType i = 0; i < numIds; ++i )
+        {
+        this->GetSqueezePointId( binfo, srcIds[i] );
+        }
+      pointMap = &binfo->PointMap;
+      }
+    vtkIdTypeArray* cellData = vtkIdTypeArray::New();
+    cellData->SetNumberOfValues( numCells * ( binfo->PointsPerCell + 1 ) );
+    vtkExodusIIFillCellsFunctor functor( arr->GetPointer( 0 ),
+      binfo->PointsPerCell, cellData->GetPointer( 0 ), pointMap );
+    vtkSMPTools::For( 0, numCells, functor );
+    vtkCellArray* cells = vtkCellArray::New();
+    cells->SetCells( numCells, cellData );
+    binfo->CachedConnectivity->SetCells( binfo->CellType, cells );
+    cells->Delete();
+    cellData->Delete();
+    }
+  else if (this->SqueezePoints)
     {
     std::vector<vtkIdType> cellIds;
     cellIds.resize( binfo->PointsPerCell );
@@ -1696,18 +1853,8 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
           return 0;
           }
         }
-      int t;
-      std::vector<double> tmpTuple;
-      tmpTuple.resize( ncomps );
-      tmpTuple[ncomps - 1] = 0.; // In case we're embedding a 2-D vector in 3-D
-      for ( t = 0; t < arr->GetNumberOfTuples(); ++t )
-        {
-        for ( c = 0; c < ainfop->Components; ++c )
-          {
-          tmpTuple[c] = tmpVal[c][t];
-          }
-        arr->SetTuple( t, &tmpTuple[0] );
-        }
+      // Zeroes the third component if we're embedding a 2-D vector in 3-D
+      vtkExodusIIInterleaveComponents( arr, tmpVal );
       }
     }
   else if ( key.ObjectType == vtkExodusIIReader::GLOBAL_TEMPORAL )
@@ -1741,17 +1888,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
           return 0;
           }
         }
-      int t;
-      std::vector<double> tmpTuple;
-      tmpTuple.resize( ainfop->Components );
-      for ( t = 0; t < arr->GetNumberOfTuples(); ++t )
-        {
-        for ( c = 0; c < ainfop->Components; ++c )
-          {
-          tmpTuple[c] = tmpVal[c][t];
-          }
-        arr->SetTuple( t, &tmpTuple[0] );
-        }
+      vtkExodusIIInterleaveComponents( arr, tmpVal );
       }
     else if ( ex_get_var_time( exoid, EX_GLOBAL,
         ainfop->OriginalIndices[0], key.ObjectId,
@@ -1804,17 +1941,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
           return 0;
           }
         }
-      int t;
-      std::vector<double> tmpTuple;
-      tmpTuple.resize( ainfop->Components );
-      for ( t = 0; t < arr->GetNumberOfTuples(); ++t )
-        {
-        for ( c = 0; c < ainfop->Components; ++c )
-          {
-          tmpTuple[c] = tmpVal[c][t];
-          }
-        arr->SetTuple( t, &tmpTuple[0] );
-        }
+      vtkExodusIIInterleaveComponents( arr, tmpVal );
       }
     }
   else if ( key.ObjectType == vtkExodusIIReader::ELEM_BLOCK_TEMPORAL )
@@ -1857,17 +1984,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
           return 0;
           }
         }
-      int t;
-      std::vector<double> tmpTuple;
-      tmpTuple.resize( ainfop->Components );
-      for ( t = 0; t < arr->GetNumberOfTuples(); ++t )
-        {
-        for ( c = 0; c < ainfop->Components; ++c )
-          {
-          tmpTuple[c] = tmpVal[c][t];
-          }
-        arr->SetTuple( t, &tmpTuple[0] );
-        }
+      vtkExodusIIInterleaveComponents( arr, tmpVal );
       }
     }
   else if (
@@ -1930,19 +2047,10 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
           arr = 0;
           }
         }
-      // Carefully use arr->GetNumberOfComponents() when sizing
-      // output as we may have promoted 2-D arrays to 3-D.
-      int t = arr->GetNumberOfComponents();
-      std::vector<double> tmpTuple;
-      tmpTuple.resize( t );
-      tmpTuple[t - 1] = 0.;
-      for ( t = 0; t < arr->GetNumberOfTuples(); ++t )
+      // This zeroes the last component when 2-D arrays were promoted to 3-D.
+      if ( arr )
         {
-        for ( c = 0; c < ainfop->Components; ++c )
-          {
-          tmpTuple[c] = tmpVal[c][t];
-          }
-        arr->SetTuple( t, &tmpTuple[0] );
+        vtkExodusIIInterleaveComponents( arr, tmpVal );
         }
       }
     }
@@ -2406,10 +2514,8 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
       }
     else
       {
-      for ( c = 0; c <= iarr->GetMaxId(); ++c, ++ptr )
-        {
-        *ptr = *ptr - 1;
-        }
+      vtkExodusIIToZeroBasedFunctor functor( ptr );
+      vtkSMPTools::For( 0, iarr->GetMaxId() + 1, functor );
       }
 
     arr = iarr;
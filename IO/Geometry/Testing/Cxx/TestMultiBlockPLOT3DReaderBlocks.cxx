@@ -0,0 +1,261 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMultiBlockPLOT3DReaderBlocks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkMultiBlockPLOT3DReader with many blocks
+// .SECTION Description
+// Writes a multi-block geometry file with iblanking and a solution file
+// in the Fortran big endian layout, reads them back and checks the
+// points, the cell visibility and functions computed from the solution.
+
+#include "vtkMultiBlockPLOT3DReader.h"
+
+#include "vtkByteSwap.h"
+#include "vtkDataArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int NumberOfBlocks = 40;
+
+void BlockDimensions(int block, int dims[3])
+{
+  dims[0] = 2 + block % 5;
+  dims[1] = 3 + block % 3;
+  dims[2] = 2 + block % 4;
+}
+
+void WriteRecord(FILE *file, std::vector<float> &floats,
+                 std::vector<int> &ints)
+{
+  int size = static_cast<int>(4 * (floats.size() + ints.size()));
+  vtkByteSwap::Swap4BE(&size);
+  fwrite(&size, 4, 1, file);
+  if (!floats.empty())
+    {
+    vtkByteSwap::Swap4BERange(&floats[0], floats.size());
+    fwrite(&floats[0], 4, floats.size(), file);
+    }
+  if (!ints.empty())
+    {
+    vtkByteSwap::Swap4BERange(&ints[0], ints.size());
+    fwrite(&ints[0], 4, ints.size(), file);
+    }
+  fwrite(&size, 4, 1, file);
+  floats.clear();
+  ints.clear();
+}
+
+// The header of both files: the number of blocks and their dimensions.
+void WriteHeader(FILE *file)
+{
+  std::vector<float> floats;
+  std::vector<int> ints(1, NumberOfBlocks);
+  WriteRecord(file, floats, ints);
+  for (int b = 0; b < NumberOfBlocks; ++b)
+    {
+    int dims[3];
+    BlockDimensions(b, dims);
+    ints.insert(ints.end(), dims, dims + 3);
+    }
+  WriteRecord(file, floats, ints);
+}
+
+void Coordinates(int block, int i, int j, int k, double x[3])
+{
+  x[0] = i + 10.0 * block;
+  x[1] = 0.5 * j;
+  x[2] = 2.0 * k;
+}
+
+// The momentum is (y + z, 0, 0) and the density 2, so the vorticity is
+// (0, 0.5, -0.5) everywhere.
+bool WriteFiles(const std::string &xyzName, const std::string &qName)
+{
+  FILE *xyz = fopen(xyzName.c_str(), "wb");
+  FILE *q = fopen(qName.c_str(), "wb");
+  if (!xyz || !q)
+    {
+    return false;
+    }
+  WriteHeader(xyz);
+  WriteHeader(q);
+  std::vector<float> floats;
+  std::vector<int> ints;
+  for (int b = 0; b < NumberOfBlocks; ++b)
+    {
+    int dims[3];
+    BlockDimensions(b, dims);
+    int n = dims[0] * dims[1] * dims[2];
+    std::vector<float> coords[3], momentum;
+    for (int k = 0; k < dims[2]; ++k)
+      {
+      for (int j = 0; j < dims[1]; ++j)
+        {
+        for (int i = 0; i < dims[0]; ++i)
+          {
+          double x[3];
+          Coordinates(b, i, j, k, x);
+          for (int c = 0; c < 3; ++c)
+            {
+            coords[c].push_back(static_cast<float>(x[c]));
+            }
+          momentum.push_back(static_cast<float>(x[1] + x[2]));
+          // the first point of each block is blanked
+          ints.push_back(i + j + k == 0 ? 0 : 1);
+          }
+        }
+      }
+    for (int c = 0; c < 3; ++c)
+      {
+      floats.insert(floats.end(), coords[c].begin(), coords[c].end());
+      }
+    WriteRecord(xyz, floats, ints);
+
+    // fsmach, alpha, re, time
+    floats.resize(4, 1.0f);
+    WriteRecord(q, floats, ints);
+    floats.resize(n, 2.0f);
+    floats.insert(floats.end(), momentum.begin(), momentum.end());
+    floats.resize(n * 4, 0.0f);
+    floats.resize(n * 5, 10.0f);
+    WriteRecord(q, floats, ints);
+    }
+  fclose(xyz);
+  fclose(q);
+  return true;
+}
+
+bool Check(bool condition, const char *what, int block)
+{
+  if (!condition)
+    {
+    cerr << "Wrong " << what << " in block " << block << endl;
+    }
+  return condition;
+}
+
+}
+
+int TestMultiBlockPLOT3DReaderBlocks(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string xyzName = tempDir;
+  xyzName += "/TestMultiBlockPLOT3DReaderBlocks.xyz";
+  std::string qName = tempDir;
+  qName += "/TestMultiBlockPLOT3DReaderBlocks.q";
+  delete [] tempDir;
+
+  if (!WriteFiles(xyzName, qName))
+    {
+    cerr << "Could not write the test files" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMultiBlockPLOT3DReader> reader;
+  reader->SetXYZFileName(xyzName.c_str());
+  reader->SetQFileName(qName.c_str());
+  reader->AutoDetectFormatOn();
+  reader->AddFunction(110);
+  reader->AddFunction(201);
+  reader->Update();
+  vtkMultiBlockDataSet *output = reader->GetOutput();
+  if (static_cast<int>(output->GetNumberOfBlocks()) != NumberOfBlocks)
+    {
+    cerr << "Wrong number of blocks: " << output->GetNumberOfBlocks() << endl;
+    return EXIT_FAILURE;
+    }
+
+  for (int b = 0; b < NumberOfBlocks; ++b)
+    {
+    vtkStructuredGrid *grid =
+      vtkStructuredGrid::SafeDownCast(output->GetBlock(b));
+    int dims[3], gridDims[3];
+    BlockDimensions(b, dims);
+    if (!Check(grid != NULL, "output", b))
+      {
+      return EXIT_FAILURE;
+      }
+    grid->GetDimensions(gridDims);
+    if (!Check(gridDims[0] == dims[0] && gridDims[1] == dims[1] &&
+               gridDims[2] == dims[2], "dimensions", b))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkDataArray *pressure = grid->GetPointData()->GetArray("Pressure");
+    vtkDataArray *vorticity = grid->GetPointData()->GetArray("Vorticity");
+    if (!Check(pressure && vorticity, "functions", b))
+      {
+      return EXIT_FAILURE;
+      }
+    vtkIdType id = 0;
+    for (int k = 0; k < dims[2]; ++k)
+      {
+      for (int j = 0; j < dims[1]; ++j)
+        {
+        for (int i = 0; i < dims[0]; ++i, ++id)
+          {
+          double x[3], p[3], w[3];
+          Coordinates(b, i, j, k, x);
+          grid->GetPoint(id, p);
+          if (!Check(p[0] == x[0] && p[1] == x[1] && p[2] == x[2],
+                     "points", b))
+            {
+            return EXIT_FAILURE;
+            }
+          double u = (x[1] + x[2]) / 2.0;
+          double expected = 0.4 * (10.0 - u * u);
+          if (!Check(fabs(pressure->GetComponent(id, 0) - expected) < 1e-4,
+                     "pressure", b))
+            {
+            return EXIT_FAILURE;
+            }
+          vorticity->GetTuple(id, w);
+          if (!Check(fabs(w[0]) < 1e-5 && fabs(w[1] - 0.5) < 1e-5 &&
+                     fabs(w[2] + 0.5) < 1e-5, "vorticity", b))
+            {
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+
+    // Only the cell using the blanked first point is hidden.
+    for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+      {
+      if (!Check((grid->IsCellVisible(cellId) != 0) == (cellId != 0),
+                 "visibility", b))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBJReaderSeams.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkOBJReader with per-face texture coordinates
+// .SECTION Description
+// Checks that vertices are only duplicated where the faces sharing them
+// refer to different texture coordinates, and that points and lines are
+// kept when that happens.
+
+#include "vtkOBJReader.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdio>
+#include <string>
+
+int TestOBJReaderSeams(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string fileName = tempDir;
+  fileName += "/TestOBJReaderSeams.obj";
+  delete [] tempDir;
+
+  // Two quads sharing the edge 2-5. The second quad maps the shared edge to
+  // other texture coordinates, so vertices 2 and 5 need a copy each; the
+  // third face reuses the copy of vertex 2 and its last vertex uses a
+  // relative index split over a continuation line.
+  FILE *file = fopen(fileName.c_str(), "w");
+  if (!file)
+    {
+    cerr << "Could not write " << fileName << endl;
+    return EXIT_FAILURE;
+    }
+  fprintf(file,
+          "# seams\n"
+          "v 0 0 0\nv 1 0 0\nv 2 0 0\nv 0 1 0\nv 1 1 0\nv 2 1 0\nv 3 0 0\n"
+          "vt 0 0\nvt 0.5 0\nvt 1 0\nvt 0 1\nvt 0.5 1\nvt 1 1\n"
+          "vt 0.25 0\nvt 0.25 1\n"
+          "f 1/1 2/2 5/5 4/4\n"
+          "f 2/7 3/3 6/6 5/8\n"
+          "f 2/7 7/3 \\\n  -2/-3\n"
+          "l 1 4\n"
+          "p 7\n");
+  fclose(file);
+
+  vtkSmartPointer<vtkOBJReader> reader =
+    vtkSmartPointer<vtkOBJReader>::New();
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkPolyData *output = reader->GetOutput();
+
+  if (output->GetNumberOfPoints() != 9 ||
+      output->GetNumberOfPolys() != 3 ||
+      output->GetNumberOfLines() != 1 ||
+      output->GetNumberOfVerts() != 1)
+    {
+    cerr << "Unexpected number of points or cells: "
+         << output->GetNumberOfPoints() << " points, "
+         << output->GetNumberOfPolys() << " polys, "
+         << output->GetNumberOfLines() << " lines, "
+         << output->GetNumberOfVerts() << " verts" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkDataArray *tcoords = output->GetPointData()->GetTCoords();
+  if (!tcoords || tcoords->GetNumberOfTuples() != 9)
+    {
+    cerr << "Missing texture coordinates" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // position and texture coordinates expected at each face vertex
+  const double expected[][5] = {
+    { 0, 0, 0, 0, 0 }, { 1, 0, 0, 0.5, 0 }, { 1, 1, 0, 0.5, 1 },
+    { 0, 1, 0, 0, 1 },
+    { 1, 0, 0, 0.25, 0 }, { 2, 0, 0, 1, 0 }, { 2, 1, 0, 1, 1 },
+    { 1, 1, 0, 0.25, 1 },
+    { 1, 0, 0, 0.25, 0 }, { 3, 0, 0, 1, 0 }, { 2, 1, 0, 1, 1 }
+  };
+  vtkCellArray *polys = output->GetPolys();
+  vtkIdType npts, *pts;
+  int corner = 0;
+  polys->InitTraversal();
+  while (polys->GetNextCell(npts, pts))
+    {
+    for (vtkIdType i = 0; i < npts; ++i, ++corner)
+      {
+      double x[3], tc[2];
+      output->GetPoint(pts[i], x);
+      tcoords->GetTuple(pts[i], tc);
+      const double *e = expected[corner];
+      if (x[0] != e[0] || x[1] != e[1] || x[2] != e[2] ||
+          tc[0] != e[3] || tc[1] != e[4])
+        {
+        cerr << "Wrong point or texture coordinates at face vertex "
+             << corner << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  if (corner != 11)
+    {
+    cerr << "Wrong number of face vertices" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // the lines and points still refer to the vertices of the file
+  vtkCellArray *lines = output->GetLines();
+  lines->InitTraversal();
+  if (!lines->GetNextCell(npts, pts) || npts != 2 ||
+      pts[0] != 0 || pts[1] != 3)
+    {
+    cerr << "Wrong line" << endl;
+    return EXIT_FAILURE;
+    }
+  vtkCellArray *verts = output->GetVerts();
+  verts->InitTraversal();
+  if (!verts->GetNextCell(npts, pts) || npts != 1 || pts[0] != 6)
+    {
+    cerr << "Wrong vertex cell" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
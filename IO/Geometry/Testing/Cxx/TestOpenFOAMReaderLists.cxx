@@ -0,0 +1,499 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOpenFOAMReaderLists.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkOpenFOAMReader reads large lists the same way whichever
+// parser they go through. The same case is written three times:
+//  - ASCII lists with a size prefix and with comments, which are parsed
+//    concurrently,
+//  - ASCII lists without a size prefix and binary faces, which are parsed
+//    one value at a time,
+//  - binary lists, whose doubles are read in bulk.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDirectory.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkOpenFOAMReader.h"
+#include "vtkPoints.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+enum CaseType
+{
+  PARALLEL_ASCII,
+  SERIAL_ASCII,
+  BINARY
+};
+
+// A block of hexahedra, as an OpenFOAM polyMesh, and the values of a
+// scalar field and a vector field on its cells.
+struct FoamCase
+{
+  std::vector<double> Points;
+  std::vector<std::vector<int> > Faces;
+  std::vector<int> Owner;
+  std::vector<int> Neighbour;
+  std::vector<double> P;
+  std::vector<double> U;
+  int NumberOfInternalFaces;
+};
+
+void MakeCase(FoamCase& c, int nx, int ny, int nz)
+{
+  for (int k = 0; k <= nz; ++k)
+    {
+    for (int j = 0; j <= ny; ++j)
+      {
+      for (int i = 0; i <= nx; ++i)
+        {
+        c.Points.push_back(0.1 * i + 1e-4 * ((i * j + k) % 7));
+        c.Points.push_back(0.13 * j);
+        c.Points.push_back(1.7e-2 * k);
+        }
+      }
+    }
+
+  std::vector<std::vector<int> > boundary;
+  std::vector<int> boundaryOwner;
+#define POINT(i, j, k) ((i) + (nx + 1) * ((j) + (ny + 1) * (k)))
+  for (int k = 0; k < nz; ++k)
+    {
+    for (int j = 0; j < ny; ++j)
+      {
+      for (int i = 0; i < nx; ++i)
+        {
+        int cell = i + nx * (j + ny * k);
+        int f[6][4] = {
+          { POINT(i+1,j,k), POINT(i+1,j+1,k), POINT(i+1,j+1,k+1),
+            POINT(i+1,j,k+1) },
+          { POINT(i,j+1,k), POINT(i,j+1,k+1), POINT(i+1,j+1,k+1),
+            POINT(i+1,j+1,k) },
+          { POINT(i,j,k+1), POINT(i+1,j,k+1), POINT(i+1,j+1,k+1),
+            POINT(i,j+1,k+1) },
+          { POINT(i,j,k), POINT(i,j,k+1), POINT(i,j+1,k+1),
+            POINT(i,j+1,k) },
+          { POINT(i,j,k), POINT(i+1,j,k), POINT(i+1,j,k+1),
+            POINT(i,j,k+1) },
+          { POINT(i,j,k), POINT(i,j+1,k), POINT(i+1,j+1,k),
+            POINT(i+1,j,k) } };
+        bool inside[3] = { i + 1 < nx, j + 1 < ny, k + 1 < nz };
+        int neighbours[3] = { cell + 1, cell + nx, cell + nx * ny };
+        bool first[3] = { i == 0, j == 0, k == 0 };
+        for (int d = 0; d < 3; ++d)
+          {
+          if (inside[d])
+            {
+            c.Faces.push_back(std::vector<int>(f[d], f[d] + 4));
+            c.Owner.push_back(cell);
+            c.Neighbour.push_back(neighbours[d]);
+            }
+          else
+            {
+            boundary.push_back(std::vector<int>(f[d], f[d] + 4));
+            boundaryOwner.push_back(cell);
+            }
+          if (first[d])
+            {
+            boundary.push_back(std::vector<int>(f[d + 3], f[d + 3] + 4));
+            boundaryOwner.push_back(cell);
+            }
+          }
+        }
+      }
+    }
+#undef POINT
+  c.NumberOfInternalFaces = static_cast<int>(c.Faces.size());
+  c.Faces.insert(c.Faces.end(), boundary.begin(), boundary.end());
+  c.Owner.insert(c.Owner.end(), boundaryOwner.begin(), boundaryOwner.end());
+
+  int numCells = nx * ny * nz;
+  for (int i = 0; i < numCells; ++i)
+    {
+    // Unprefixed scalar lists are converted with strtod(), so p only has
+    // exact values, while U checks the other parsers more closely
+    c.P.push_back(0.0625 * (i % 1000) - 30.0);
+    c.U.push_back(0.37 * (i % 97) - 12.5);
+    c.U.push_back(1.0e-7 * i);
+    c.U.push_back(1.5e3 * i);
+    }
+}
+
+// Comments that are put between the values of ASCII lists
+const char* Comment(size_t i)
+{
+  return (i % 997 == 5 ? " // c\n" : (i % 1499 == 3 ? " /* x\n y */ " : ""));
+}
+
+void WriteHeader(FILE* fp, const char* format, const char* cls,
+                 const char* object)
+{
+  fprintf(fp, "FoamFile\n{\n    version 2.0;\n    format %s;\n"
+          "    class %s;\n    object %s;\n}\n", format, cls, object);
+}
+
+void WriteScalars(FILE* fp, const std::vector<double>& values, CaseType type)
+{
+  if (type == BINARY)
+    {
+    fprintf(fp, "%d\n(", static_cast<int>(values.size()));
+    fwrite(&values[0], sizeof(double), values.size(), fp);
+    fprintf(fp, ")\n");
+    return;
+    }
+  if (type == PARALLEL_ASCII)
+    {
+    fprintf(fp, "%d\n", static_cast<int>(values.size()));
+    }
+  fprintf(fp, "(\n");
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    fprintf(fp, (i % 3 ? "%.4f\n" : "%.6e\n"), values[i]);
+    if (type == PARALLEL_ASCII)
+      {
+      fputs(Comment(i), fp);
+      }
+    }
+  fprintf(fp, ")\n");
+}
+
+void WriteVectors(FILE* fp, const std::vector<double>& values, CaseType type)
+{
+  size_t n = values.size() / 3;
+  if (type == BINARY)
+    {
+    fprintf(fp, "%d\n(", static_cast<int>(n));
+    fwrite(&values[0], sizeof(double), values.size(), fp);
+    fprintf(fp, ")\n");
+    return;
+    }
+  if (type == PARALLEL_ASCII)
+    {
+    fprintf(fp, "%d\n", static_cast<int>(n));
+    }
+  fprintf(fp, "(\n");
+  for (size_t i = 0; i < n; ++i)
+    {
+    const double* v = &values[3 * i];
+    if (type == PARALLEL_ASCII && i % 1013 == 7)
+      {
+      fprintf(fp, "(%.9g /* in */ %.9g %.9g)\n", v[0], v[1], v[2]);
+      }
+    else
+      {
+      fprintf(fp, "(%.9g %.9g %.9g)\n", v[0], v[1], v[2]);
+      }
+    if (type == PARALLEL_ASCII)
+      {
+      fputs(Comment(i), fp);
+      }
+    }
+  fprintf(fp, ")\n");
+}
+
+void WriteLabels(FILE* fp, const std::vector<int>& values, CaseType type)
+{
+  if (type == BINARY)
+    {
+    fprintf(fp, "%d\n(", static_cast<int>(values.size()));
+    fwrite(&values[0], sizeof(int), values.size(), fp);
+    fprintf(fp, ")\n");
+    return;
+    }
+  if (type == PARALLEL_ASCII)
+    {
+    fprintf(fp, "%d\n", static_cast<int>(values.size()));
+    }
+  fprintf(fp, "(\n");
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    fprintf(fp, "%d\n", values[i]);
+    if (type == PARALLEL_ASCII)
+      {
+      fputs(Comment(i), fp);
+      }
+    }
+  fprintf(fp, ")\n");
+}
+
+// A labelListList always has a size prefix, so the serial parser is used
+// through the binary format.
+void WriteFaces(FILE* fp, const std::vector<std::vector<int> >& faces,
+                CaseType type)
+{
+  fprintf(fp, "%d\n(\n", static_cast<int>(faces.size()));
+  for (size_t i = 0; i < faces.size(); ++i)
+    {
+    const std::vector<int>& f = faces[i];
+    if (type != PARALLEL_ASCII)
+      {
+      fprintf(fp, "%d(", static_cast<int>(f.size()));
+      fwrite(&f[0], sizeof(int), f.size(), fp);
+      fprintf(fp, ")\n");
+      continue;
+      }
+    // some faces without a size prefix
+    if (i % 5 == 1)
+      {
+      fprintf(fp, "(%d %d %d %d)\n", f[0], f[1], f[2], f[3]);
+      }
+    else
+      {
+      fprintf(fp, "4(%d %d %d %d)\n", f[0], f[1], f[2], f[3]);
+      }
+    fputs(Comment(i), fp);
+    }
+  fprintf(fp, ")\n");
+}
+
+bool WriteCase(const FoamCase& c, const std::string& root, CaseType type)
+{
+  const char* format = (type == PARALLEL_ASCII ? "ascii" : "binary");
+  const char* listFormat = (type == BINARY ? "binary" : "ascii");
+  std::string polyMesh = root + "/constant/polyMesh";
+  if (!vtkDirectory::MakeDirectory(polyMesh.c_str()) ||
+      !vtkDirectory::MakeDirectory((root + "/system").c_str()) ||
+      !vtkDirectory::MakeDirectory((root + "/0").c_str()))
+    {
+    return false;
+    }
+
+  FILE* fp = fopen((polyMesh + "/points").c_str(), "wb");
+  if (!fp)
+    {
+    return false;
+    }
+  WriteHeader(fp, listFormat, "vectorField", "points");
+  WriteVectors(fp, c.Points, type);
+  fclose(fp);
+
+  fp = fopen((polyMesh + "/faces").c_str(), "wb");
+  WriteHeader(fp, format, "faceList", "faces");
+  WriteFaces(fp, c.Faces, type);
+  fclose(fp);
+
+  fp = fopen((polyMesh + "/owner").c_str(), "wb");
+  WriteHeader(fp, listFormat, "labelList", "owner");
+  WriteLabels(fp, c.Owner, type);
+  fclose(fp);
+
+  fp = fopen((polyMesh + "/neighbour").c_str(), "wb");
+  WriteHeader(fp, listFormat, "labelList", "neighbour");
+  WriteLabels(fp, c.Neighbour, type);
+  fclose(fp);
+
+  fp = fopen((polyMesh + "/boundary").c_str(), "wb");
+  WriteHeader(fp, "ascii", "polyBoundaryMesh", "boundary");
+  fprintf(fp, "1\n(\n    walls\n    {\n        type wall;\n"
+          "        nFaces %d;\n        startFace %d;\n    }\n)\n",
+          static_cast<int>(c.Faces.size()) - c.NumberOfInternalFaces,
+          c.NumberOfInternalFaces);
+  fclose(fp);
+
+  fp = fopen((root + "/system/controlDict").c_str(), "wb");
+  WriteHeader(fp, "ascii", "dictionary", "controlDict");
+  fprintf(fp, "application icoFoam;\nstartTime 0;\nendTime 1;\n"
+          "deltaT 1;\nwriteControl timeStep;\nwriteInterval 1;\n");
+  fclose(fp);
+
+  fp = fopen((root + "/0/p").c_str(), "wb");
+  WriteHeader(fp, listFormat, "volScalarField", "p");
+  fprintf(fp, "dimensions [0 2 -2 0 0 0 0];\n"
+          "internalField nonuniform List<scalar> ");
+  WriteScalars(fp, c.P, type);
+  fprintf(fp, ";\nboundaryField\n{\n    walls\n    {\n"
+          "        type zeroGradient;\n    }\n}\n");
+  fclose(fp);
+
+  fp = fopen((root + "/0/U").c_str(), "wb");
+  WriteHeader(fp, listFormat, "volVectorField", "U");
+  fprintf(fp, "dimensions [0 1 -1 0 0 0 0];\n"
+          "internalField nonuniform List<vector> ");
+  WriteVectors(fp, c.U, type);
+  fprintf(fp, ";\nboundaryField\n{\n    walls\n    {\n"
+          "        type fixedValue;\n        value uniform (0 0 0);\n"
+          "    }\n}\n");
+  fclose(fp);
+
+  fp = fopen((root + "/case.foam").c_str(), "wb");
+  fclose(fp);
+  return true;
+}
+
+vtkUnstructuredGrid* GetInternalMesh(vtkOpenFOAMReader* reader)
+{
+  vtkMultiBlockDataSet* output = reader->GetOutput();
+  if (!output || output->GetNumberOfBlocks() < 1)
+    {
+    return NULL;
+    }
+  return vtkUnstructuredGrid::SafeDownCast(output->GetBlock(0));
+}
+
+bool CompareArrays(vtkDataArray* a, vtkDataArray* b, const char* name)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    cerr << "Array " << name << " is missing or has the wrong size" << endl;
+    return false;
+    }
+  int nc = a->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int j = 0; j < nc; ++j)
+      {
+      if (a->GetComponent(i, j) != b->GetComponent(i, j))
+        {
+        cerr << "Array " << name << " differs at " << i << ": "
+             << a->GetComponent(i, j) << " vs " << b->GetComponent(i, j)
+             << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool CompareToValues(vtkDataArray* a, const std::vector<double>& values,
+                     const char* name)
+{
+  if (!a || a->GetNumberOfTuples() * a->GetNumberOfComponents() !=
+      static_cast<vtkIdType>(values.size()))
+    {
+    cerr << "Array " << name << " is missing or has the wrong size" << endl;
+    return false;
+    }
+  int nc = a->GetNumberOfComponents();
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    float expected = static_cast<float>(values[i]);
+    if (a->GetComponent(i / nc, i % nc) != expected)
+      {
+      cerr << "Array " << name << " differs at value " << i << ": "
+           << a->GetComponent(i / nc, i % nc) << " vs " << expected << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CompareCells(vtkUnstructuredGrid* a, vtkUnstructuredGrid* b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    cerr << "Number of cells differs" << endl;
+    return false;
+    }
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+    {
+    vtkIdType n1, *ids1, n2, *ids2;
+    a->GetCellPoints(c, n1, ids1);
+    b->GetCellPoints(c, n2, ids2);
+    bool same = (a->GetCellType(c) == b->GetCellType(c) && n1 == n2);
+    for (vtkIdType p = 0; same && p < n1; ++p)
+      {
+      same = (ids1[p] == ids2[p]);
+      }
+    if (!same)
+      {
+      cerr << "Cell " << c << " differs" << endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestOpenFOAMReaderLists(int argc, char* argv[])
+{
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string prefix = temp_dir;
+  delete [] temp_dir;
+  prefix += "/TestOpenFOAMReaderLists";
+
+  // The lists are several times larger than the chunks of the tokenizer
+  const int n = 20;
+  FoamCase foamCase;
+  MakeCase(foamCase, n, n, n);
+
+  const char* names[3] = { "parallel", "serial", "binary" };
+  vtkNew<vtkOpenFOAMReader> readers[3];
+  vtkUnstructuredGrid* meshes[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    std::string root = prefix + "-" + names[i];
+    if (!WriteCase(foamCase, root, static_cast<CaseType>(i)))
+      {
+      cerr << "Could not write case " << root << endl;
+      return EXIT_FAILURE;
+      }
+    readers[i]->SetFileName((root + "/case.foam").c_str());
+    readers[i]->Update();
+    meshes[i] = GetInternalMesh(readers[i].GetPointer());
+    if (!meshes[i] || meshes[i]->GetNumberOfCells() != n * n * n)
+      {
+      cerr << "Could not read the internal mesh of " << root << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < 3; i += 2)
+    {
+    if (!CompareCells(meshes[i], meshes[1]))
+      {
+      cerr << "Error: cells of " << names[i] << " case" << endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  // The ASCII cases must give the same floats
+  if (!CompareArrays(meshes[0]->GetPoints()->GetData(),
+                     meshes[1]->GetPoints()->GetData(), "points") ||
+      !CompareArrays(meshes[0]->GetCellData()->GetArray("p"),
+                     meshes[1]->GetCellData()->GetArray("p"), "p") ||
+      !CompareArrays(meshes[0]->GetCellData()->GetArray("U"),
+                     meshes[1]->GetCellData()->GetArray("U"), "U"))
+    {
+    cerr << "Error: values of parallel case" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  // The binary doubles are only rounded to float
+  if (!CompareToValues(meshes[2]->GetPoints()->GetData(),
+                       foamCase.Points, "points") ||
+      !CompareToValues(meshes[2]->GetCellData()->GetArray("p"),
+                       foamCase.P, "p") ||
+      !CompareToValues(meshes[2]->GetCellData()->GetArray("U"),
+                       foamCase.U, "U"))
+    {
+    cerr << "Error: values of binary case" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
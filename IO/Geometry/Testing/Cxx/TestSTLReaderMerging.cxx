@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReaderMerging.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the bulk point merging of vtkSTLReader gives the same output
+// as merging through a vtkMergePoints locator.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkSTLWriter.h"
+#include "vtkTestUtilities.h"
+
+#include <string>
+
+namespace
+{
+// A height field triangulated on an n x n grid, plus one degenerate
+// triangle which merging removes.
+void MakeSurface(vtkPolyData* surface, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j <= n; ++j)
+    {
+    for (int i = 0; i <= n; ++i)
+      {
+      points->InsertNextPoint(i, j, 0.125 * ((i * j) % 7));
+      }
+    }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+    {
+    for (int i = 0; i < n; ++i)
+      {
+      vtkIdType p = j * (n + 1) + i;
+      vtkIdType t1[3] = { p, p + 1, p + n + 2 };
+      vtkIdType t2[3] = { p, p + n + 2, p + n + 1 };
+      polys->InsertNextCell(3, t1);
+      polys->InsertNextCell(3, t2);
+      }
+    }
+  vtkIdType degenerate[3] = { 0, 1, 1 };
+  polys->InsertNextCell(3, degenerate);
+  surface->SetPoints(points.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+}
+
+int Compare(vtkPolyData* expected, vtkPolyData* actual)
+{
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+      expected->GetNumberOfPolys() != actual->GetNumberOfPolys())
+    {
+    cerr << "Expected " << expected->GetNumberOfPoints() << " points and "
+         << expected->GetNumberOfPolys() << " triangles, got "
+         << actual->GetNumberOfPoints() << " points and "
+         << actual->GetNumberOfPolys() << " triangles" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    expected->GetPoint(i, x);
+    actual->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      cerr << "Wrong point " << i << endl;
+      return 0;
+      }
+    }
+  vtkIdTypeArray* e = expected->GetPolys()->GetData();
+  vtkIdTypeArray* a = actual->GetPolys()->GetData();
+  if (e->GetNumberOfTuples() != a->GetNumberOfTuples())
+    {
+    cerr << "Wrong connectivity size" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < e->GetNumberOfTuples(); ++i)
+    {
+    if (e->GetValue(i) != a->GetValue(i))
+      {
+      cerr << "Wrong connectivity at " << i << endl;
+      return 0;
+      }
+    }
+  vtkDataArray* es = expected->GetCellData()->GetScalars();
+  vtkDataArray* as = actual->GetCellData()->GetScalars();
+  if ((es == NULL) != (as == NULL) ||
+      (es && es->GetNumberOfTuples() != as->GetNumberOfTuples()))
+    {
+    cerr << "Wrong solid labels" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestFile(const std::string& fileName, int scalarTags, vtkIdType numPoints)
+{
+  vtkNew<vtkMergePoints> locator;
+  vtkNew<vtkSTLReader> expected;
+  expected->SetFileName(fileName.c_str());
+  expected->SetScalarTags(scalarTags);
+  expected->SetLocator(locator.GetPointer());
+  expected->Update();
+
+  vtkNew<vtkSTLReader> actual;
+  actual->SetFileName(fileName.c_str());
+  actual->SetScalarTags(scalarTags);
+  actual->Update();
+
+  if (actual->GetOutput()->GetNumberOfPoints() != numPoints)
+    {
+    cerr << "Expected " << numPoints << " merged points, got "
+         << actual->GetOutput()->GetNumberOfPoints() << endl;
+    return 0;
+    }
+  return Compare(expected->GetOutput(), actual->GetOutput());
+}
+}
+
+int TestSTLReaderMerging(int argc, char* argv[])
+{
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string prefix = temp_dir;
+  delete [] temp_dir;
+  prefix += "/TestSTLReaderMerging";
+
+  const int n = 200;
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), n);
+  const vtkIdType numPoints = (n + 1) * (n + 1);
+
+  int result = EXIT_SUCCESS;
+  vtkNew<vtkSTLWriter> writer;
+  writer->SetInputData(surface.GetPointer());
+
+  std::string binaryName = prefix + "-binary.stl";
+  writer->SetFileName(binaryName.c_str());
+  writer->SetFileTypeToBinary();
+  writer->Write();
+  if (!TestFile(binaryName, 0, numPoints))
+    {
+    cerr << "Error: binary file" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  std::string asciiName = prefix + "-ascii.stl";
+  writer->SetFileName(asciiName.c_str());
+  writer->SetFileTypeToASCII();
+  writer->Write();
+  if (!TestFile(asciiName, 1, numPoints))
+    {
+    cerr << "Error: ascii file" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Without merging every facet keeps its own points.
+  vtkNew<vtkSTLReader> unmerged;
+  unmerged->SetFileName(binaryName.c_str());
+  unmerged->MergingOff();
+  unmerged->Update();
+  if (unmerged->GetOutput()->GetNumberOfPoints() !=
+      3 * surface->GetNumberOfPolys() ||
+      unmerged->GetOutput()->GetNumberOfPolys() != surface->GetNumberOfPolys())
+    {
+    cerr << "Error: unmerged binary file" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -26,14 +26,17 @@
 #include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnsignedCharArray.h"
-#include "vtkIdList.h"
 #include "vtkCellData.h"
 
 #include "vtkMultiBlockPLOT3DReaderInternals.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkMultiBlockPLOT3DReader);
 
 #define VTK_RHOINF 1.0
@@ -41,6 +44,242 @@ vtkStandardNewMacro(vtkMultiBlockPLOT3DReader);
 #define VTK_PINF ((VTK_RHOINF*VTK_CINF) * (VTK_RHOINF*VTK_CINF) / this->Gamma)
 #define VTK_CV (this->R / (this->Gamma-1.0))
 
+namespace
+{
+// Binary geometry files are read this many bytes at a time. Consecutive
+// blocks smaller than this are read together.
+const long vtkPLOT3DReadSize = 64 << 20;
+
+// Swaps num values of the given size from the byte order of the file to
+// the native one.
+void vtkPLOT3DSwapRange(void* values, size_t num, int size, int byteOrder)
+{
+  if (byteOrder == vtkMultiBlockPLOT3DReader::FILE_LITTLE_ENDIAN)
+    {
+    if (size == 4)
+      {
+      vtkByteSwap::Swap4LERange(values, num);
+      }
+    else
+      {
+      vtkByteSwap::Swap8LERange(values, num);
+      }
+    }
+  else
+    {
+    if (size == 4)
+      {
+      vtkByteSwap::Swap4BERange(values, num);
+      }
+    else
+      {
+      vtkByteSwap::Swap8BERange(values, num);
+      }
+    }
+}
+
+// Swaps the values of an array read from a file, concurrently.
+class vtkPLOT3DSwapFunctor
+{
+public:
+  char* Values;
+  int Size;
+  int ByteOrder;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    vtkPLOT3DSwapRange(this->Values + begin*this->Size, end - begin,
+                       this->Size, this->ByteOrder);
+    }
+};
+
+// Stores the values begin to end of the numDims components of a vector,
+// written one component after the other in the file, as the tuples of a
+// 3-component array. Components that are not in the file are set to 0.
+// The values are swapped in place in the components.
+template <class DataType>
+void vtkPLOT3DInterleave(char* components, vtkIdType n, int numDims,
+                         int byteOrder, vtkIdType begin, vtkIdType end,
+                         DataType* vector)
+{
+  const size_t size = sizeof(DataType);
+  int component;
+  for (component = 0; component < numDims; component++)
+    {
+    char* values = components + (component*n + begin)*size;
+    vtkPLOT3DSwapRange(values, end - begin, static_cast<int>(size),
+                       byteOrder);
+    for (vtkIdType i=begin; i<end; i++, values += size)
+      {
+      memcpy(vector + 3*i + component, values, size);
+      }
+    }
+  for (; component < 3; component++)
+    {
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      vector[3*i+component] = 0;
+      }
+    }
+}
+
+// Interleaves the components of a vector read from a file, concurrently.
+template <class DataType>
+class vtkPLOT3DInterleaveFunctor
+{
+public:
+  char* Components;
+  vtkIdType NumberOfValues;
+  int NumberOfDimensions;
+  int ByteOrder;
+  DataType* Vector;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    vtkPLOT3DInterleave(this->Components, this->NumberOfValues,
+                        this->NumberOfDimensions, this->ByteOrder,
+                        begin, end, this->Vector);
+    }
+};
+
+// Arrays of a block of the geometry file and where its record was read.
+struct vtkPLOT3DGeometryBlock
+{
+  char* Data;
+  int Dimensions[3];
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  void* Points;
+  int* IBlank;
+  unsigned char* Visibility;
+};
+
+// Runs Worker over the points or cells of consecutive blocks as if they
+// were one range, so that small blocks are processed together and large
+// ones are split between threads. Starts holds the index of the first item
+// of each block in that range, followed by the total number of items.
+template <class Worker>
+class vtkPLOT3DBlocksFunctor
+{
+public:
+  vtkPLOT3DBlocksFunctor(const Worker& worker,
+                         const std::vector<vtkIdType>& starts) :
+    Work(worker), Starts(starts)
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    size_t block = std::upper_bound(this->Starts.begin(), this->Starts.end(),
+                                    begin) - this->Starts.begin() - 1;
+    for (; begin < end; block++)
+      {
+      vtkIdType last = std::min(end, this->Starts[block+1]);
+      this->Work(block, begin - this->Starts[block],
+                 last - this->Starts[block]);
+      begin = last;
+      }
+    }
+
+private:
+  const Worker& Work;
+  const std::vector<vtkIdType>& Starts;
+};
+
+template <class Worker>
+void vtkPLOT3DForBlocks(const Worker& worker,
+                        const std::vector<vtkIdType>& starts)
+{
+  vtkPLOT3DBlocksFunctor<Worker> functor(worker, starts);
+  vtkSMPTools::For(0, starts.back(), functor);
+}
+
+// Converts the coordinates and iblanking of geometry blocks from the
+// records read from the file.
+template <class DataType>
+class vtkPLOT3DGeometryConverter
+{
+public:
+  const vtkPLOT3DGeometryBlock* Blocks;
+  int NumberOfDimensions;
+  int ByteOrder;
+
+  void operator()(size_t b, vtkIdType begin, vtkIdType end) const
+    {
+    const vtkPLOT3DGeometryBlock& block = this->Blocks[b];
+    vtkPLOT3DInterleave(block.Data, block.NumberOfPoints,
+                        this->NumberOfDimensions, this->ByteOrder,
+                        begin, end, static_cast<DataType*>(block.Points));
+    if (block.IBlank)
+      {
+      // the iblanking follows the coordinates as 4 byte ints
+      char* ib = block.Data +
+        this->NumberOfDimensions*block.NumberOfPoints*sizeof(DataType) +
+        begin*sizeof(int);
+      vtkPLOT3DSwapRange(ib, end - begin, 4, this->ByteOrder);
+      memcpy(block.IBlank + begin, ib, (end - begin)*sizeof(int));
+      }
+    }
+};
+
+// A cell of a block is visible if none of its points is blanked.
+class vtkPLOT3DVisibilityWorker
+{
+public:
+  const vtkPLOT3DGeometryBlock* Blocks;
+
+  void operator()(size_t b, vtkIdType begin, vtkIdType end) const
+    {
+    const vtkPLOT3DGeometryBlock& block = this->Blocks[b];
+    const int* dims = block.Dimensions;
+    vtkIdType cellDims[3], steps[3];
+    for (int i=0; i<3; i++)
+      {
+      cellDims[i] = dims[i] > 1 ? dims[i] - 1 : 1;
+      steps[i] = dims[i] > 1 ? 1 : 0;
+      }
+    vtkIdType d01 = static_cast<vtkIdType>(dims[0])*dims[1];
+    for (vtkIdType cellId=begin; cellId<end; cellId++)
+      {
+      vtkIdType i = cellId % cellDims[0];
+      vtkIdType j = (cellId / cellDims[0]) % cellDims[1];
+      vtkIdType k = cellId / (cellDims[0]*cellDims[1]);
+      const int* ib = block.IBlank + i + j*dims[0] + k*d01;
+      unsigned char visible = 1;
+      for (vtkIdType kk=0; kk<=steps[2] && visible; kk++)
+        {
+        for (vtkIdType jj=0; jj<=steps[1] && visible; jj++)
+          {
+          for (vtkIdType ii=0; ii<=steps[0]; ii++)
+            {
+            if (ib[ii + jj*dims[0] + kk*d01] == 0)
+              {
+              visible = 0;
+              break;
+              }
+            }
+          }
+        }
+      block.Visibility[cellId] = visible;
+      }
+    }
+};
+
+// Computes the visibility of the cells of blocks from their iblanking.
+void vtkPLOT3DComputeVisibility(const vtkPLOT3DGeometryBlock* blocks,
+                                int numBlocks)
+{
+  std::vector<vtkIdType> starts(1, 0);
+  for (int i=0; i<numBlocks; i++)
+    {
+    starts.push_back(starts.back() + blocks[i].NumberOfCells);
+    }
+  vtkPLOT3DVisibilityWorker worker;
+  worker.Blocks = blocks;
+  vtkPLOT3DForBlocks(worker, starts);
+}
+}
+
 template <class DataType>
 class vtkPLOT3DArrayReader
 {
@@ -53,50 +292,31 @@ public:
   int ReadScalar(FILE* fp, int n, DataType* scalar)
     {
       int retVal = static_cast<int>(fread(scalar, sizeof(DataType), n, fp));
-      if (this->ByteOrder == vtkMultiBlockPLOT3DReader::FILE_LITTLE_ENDIAN)
-        {
-        if (sizeof(DataType) == 4)
-          {
-          vtkByteSwap::Swap4LERange(scalar, n);
-          }
-        else
-          {
-          vtkByteSwap::Swap8LERange(scalar, n);
-          }
-        }
-      else
-        {
-        if (sizeof(DataType) == 4)
-          {
-          vtkByteSwap::Swap4BERange(scalar, n);
-          }
-        else
-          {
-          vtkByteSwap::Swap8BERange(scalar, n);
-          }
-        }
+      vtkPLOT3DSwapFunctor swapper;
+      swapper.Values = reinterpret_cast<char*>(scalar);
+      swapper.Size = static_cast<int>(sizeof(DataType));
+      swapper.ByteOrder = this->ByteOrder;
+      vtkSMPTools::For(0, n, 65536, swapper);
       return retVal;
     }
 
   int ReadVector(FILE* fp, int n, int numDims, DataType* vector)
     {
-      // Setting to 0 in case numDims == 0. We still need to
-      // populate an array with 3 components but the code below
-      // does not read the 3rd component (it doesn't exist
-      // in the file)
-      memset(vector, 0, n*3*sizeof(DataType));
-
-      int retVal = 0;
-      DataType* buffer = new DataType[n];
-      for (int component = 0; component < numDims; component++)
-        {
-        retVal += this->ReadScalar(fp, n, buffer);
-        for (int i=0; i<n; i++)
-          {
-          vector[3*i+component] = buffer[i];
-          }
-        }
-      delete[] buffer;
+      // All components are read at once, then swapped and interleaved
+      // concurrently. The components that are not in the file (the 3rd
+      // one of 2D files) are set to 0.
+      std::vector<char> buffer(
+        static_cast<size_t>(n)*numDims*sizeof(DataType) + 1);
+      int retVal = static_cast<int>(
+        fread(&buffer[0], sizeof(DataType), static_cast<size_t>(n)*numDims,
+              fp));
+      vtkPLOT3DInterleaveFunctor<DataType> interleave;
+      interleave.Components = &buffer[0];
+      interleave.NumberOfValues = n;
+      interleave.NumberOfDimensions = numDims;
+      interleave.ByteOrder = this->ByteOrder;
+      interleave.Vector = vector;
+      vtkSMPTools::For(0, n, 16384, interleave);
 
       return retVal;
     }
@@ -897,6 +1117,126 @@ int vtkMultiBlockPLOT3DReader::RequestInformation(
   return 1;
 }
 
+// Read the coordinates and iblanking of all blocks of a binary geometry
+// file. The record of each block starts at an offset given by the
+// dimensions of the blocks before it, so consecutive blocks are read
+// together and converted concurrently.
+int vtkMultiBlockPLOT3DReader::ReadBinaryGeometry(FILE* xyzFp)
+{
+  vtkMultiBlockPLOT3DReaderInternals* internal = this->Internal;
+  int numBlocks = static_cast<int>(internal->Blocks.size());
+  int byteCount = internal->HasByteCount ? 4 : 0;
+
+  std::vector<long> offsets(numBlocks + 1);
+  offsets[0] = ftell(xyzFp);
+  std::vector<vtkPLOT3DGeometryBlock> blocks(numBlocks);
+  int i;
+  for (i=0; i<numBlocks; i++)
+    {
+    vtkStructuredGrid* nthOutput = internal->Blocks[i];
+    vtkPLOT3DGeometryBlock& block = blocks[i];
+    memset(&block, 0, sizeof(block));
+    nthOutput->GetDimensions(block.Dimensions);
+    offsets[i+1] = offsets[i] + internal->CalculateFileSizeForBlock(
+      internal->Precision, internal->IBlanking,
+      internal->NumberOfDimensions, internal->HasByteCount,
+      block.Dimensions);
+
+    block.NumberOfPoints = static_cast<vtkIdType>(block.Dimensions[0])*
+      block.Dimensions[1]*block.Dimensions[2];
+    vtkDataArray* pointArray = this->NewFloatArray();
+    pointArray->SetNumberOfComponents(3);
+    pointArray->SetNumberOfTuples(block.NumberOfPoints);
+    block.Points = pointArray->GetVoidPointer(0);
+
+    vtkPoints* points = vtkPoints::New();
+    points->SetData(pointArray);
+    pointArray->Delete();
+    nthOutput->SetPoints(points);
+    points->Delete();
+
+    if (internal->IBlanking)
+      {
+      vtkIntArray* iblank = vtkIntArray::New();
+      iblank->SetName("IBlank");
+      iblank->SetNumberOfTuples(block.NumberOfPoints);
+      block.IBlank = iblank->GetPointer(0);
+      nthOutput->GetPointData()->AddArray(iblank);
+      iblank->Delete();
+
+      block.NumberOfCells = nthOutput->GetNumberOfCells();
+      vtkUnsignedCharArray* visibility = vtkUnsignedCharArray::New();
+      visibility->SetNumberOfComponents(1);
+      visibility->SetNumberOfTuples(block.NumberOfCells);
+      visibility->SetName("Visibility");
+      block.Visibility = visibility->GetPointer(0);
+      nthOutput->SetCellVisibilityArray(visibility);
+      nthOutput->GetCellData()->AddArray(visibility);
+      visibility->Delete();
+      }
+    }
+
+  std::vector<char> buffer;
+  for (int first=0; first<numBlocks; )
+    {
+    int last = first + 1;
+    while (last < numBlocks &&
+           offsets[last+1] - offsets[first] <= vtkPLOT3DReadSize)
+      {
+      last++;
+      }
+    size_t size = static_cast<size_t>(offsets[last] - offsets[first]);
+    buffer.resize(size + 1);
+    fseek(xyzFp, offsets[first], SEEK_SET);
+    size_t numRead = fread(&buffer[0], 1, size, xyzFp);
+    // What is missing from a truncated file reads as 0, but a block of
+    // which no coordinates or no iblanking could be read is an error.
+    memset(&buffer[0] + numRead, 0, size - numRead);
+    std::vector<vtkIdType> starts(1, 0);
+    for (i=first; i<last; i++)
+      {
+      size_t start = static_cast<size_t>(offsets[i] - offsets[first])
+        + byteCount;
+      size_t ibStart = start + static_cast<size_t>(blocks[i].NumberOfPoints)*
+        internal->NumberOfDimensions*internal->Precision;
+      if (blocks[i].NumberOfPoints > 0 &&
+          (numRead <= start || (internal->IBlanking && numRead <= ibStart)))
+        {
+        vtkErrorMacro("Encountered premature end-of-file while reading "
+                      "the geometry file (or the file is corrupt).");
+        this->SetErrorCode(vtkErrorCode::PrematureEndOfFileError);
+        return 0;
+        }
+      blocks[i].Data = &buffer[0] + start;
+      starts.push_back(starts.back() + blocks[i].NumberOfPoints);
+      }
+
+    if (internal->Precision == 4)
+      {
+      vtkPLOT3DGeometryConverter<float> converter;
+      converter.Blocks = &blocks[first];
+      converter.NumberOfDimensions = internal->NumberOfDimensions;
+      converter.ByteOrder = internal->ByteOrder;
+      vtkPLOT3DForBlocks(converter, starts);
+      }
+    else
+      {
+      vtkPLOT3DGeometryConverter<double> converter;
+      converter.Blocks = &blocks[first];
+      converter.NumberOfDimensions = internal->NumberOfDimensions;
+      converter.ByteOrder = internal->ByteOrder;
+      vtkPLOT3DForBlocks(converter, starts);
+      }
+    if (internal->IBlanking)
+      {
+      vtkPLOT3DComputeVisibility(&blocks[first], last - first);
+      }
+    first = last;
+    }
+
+  return 1;
+}
+
 int vtkMultiBlockPLOT3DReader::RequestData(
   vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
 {
@@ -938,82 +1278,82 @@ int vtkMultiBlockPLOT3DReader::RequestData(
     // Update from the value in the file.
     numBlocks = static_cast<int>(this->Internal->Blocks.size());
 
-    for(i=0; i<numBlocks; i++)
+    if (this->Internal->BinaryFile)
       {
-
-      // Read the geometry of this grid.
-      this->SkipByteCount(xyzFp);
-
-      vtkStructuredGrid* nthOutput = this->Internal->Blocks[i];
-      int dims[3];
-      nthOutput->GetDimensions(dims);
-      vtkDataArray* pointArray = this->NewFloatArray();
-      pointArray->SetNumberOfComponents(3);
-      pointArray->SetNumberOfTuples( dims[0]*dims[1]*dims[2] );
-
-      vtkPoints* points = vtkPoints::New();
-      points->SetData(pointArray);
-      pointArray->Delete();
-      nthOutput->SetPoints(points);
-      points->Delete();
-      if ( this->ReadVector(xyzFp,
-                            dims[0]*dims[1]*dims[2],
-                            this->Internal->NumberOfDimensions,
-                            pointArray) == 0)
+      if ( !this->ReadBinaryGeometry(xyzFp) )
         {
-        vtkErrorMacro("Encountered premature end-of-file while reading "
-                      "the geometry file (or the file is corrupt).");
-        this->SetErrorCode(vtkErrorCode::PrematureEndOfFileError);
         fclose(xyzFp);
         return 0;
         }
-
-      if (this->Internal->IBlanking)
+      }
+    else
+      {
+      for(i=0; i<numBlocks; i++)
         {
-        int* ib = (int*)malloc(dims[0]*dims[1]*dims[2]*sizeof(int));
-        if ( this->ReadIntBlock(xyzFp, dims[0]*dims[1]*dims[2], ib) == 0)
+
+        // Read the geometry of this grid.
+        this->SkipByteCount(xyzFp);
+
+        vtkStructuredGrid* nthOutput = this->Internal->Blocks[i];
+        int dims[3];
+        nthOutput->GetDimensions(dims);
+        vtkDataArray* pointArray = this->NewFloatArray();
+        pointArray->SetNumberOfComponents(3);
+        pointArray->SetNumberOfTuples( dims[0]*dims[1]*dims[2] );
+
+        vtkPoints* points = vtkPoints::New();
+        points->SetData(pointArray);
+        pointArray->Delete();
+        nthOutput->SetPoints(points);
+        points->Delete();
+        if ( this->ReadVector(xyzFp,
+                              dims[0]*dims[1]*dims[2],
+                              this->Internal->NumberOfDimensions,
+                              pointArray) == 0)
           {
           vtkErrorMacro("Encountered premature end-of-file while reading "
-                        "the q file (or the file is corrupt).");
+                        "the geometry file (or the file is corrupt).");
           this->SetErrorCode(vtkErrorCode::PrematureEndOfFileError);
-          free(ib);
           fclose(xyzFp);
           return 0;
           }
 
-        vtkIntArray* iblank = vtkIntArray::New();
-        iblank->SetName("IBlank");
-        iblank->SetVoidArray(ib, dims[0]*dims[1]*dims[2], 0);
-        nthOutput->GetPointData()->AddArray(iblank);
-        iblank->Delete();
-
-        vtkUnsignedCharArray* visibility = vtkUnsignedCharArray::New();
-        visibility->SetNumberOfComponents(1);
-        visibility->SetNumberOfTuples( nthOutput->GetNumberOfCells() );
-        visibility->SetName("Visibility");
-        nthOutput->SetCellVisibilityArray(visibility);
-        nthOutput->GetCellData()->AddArray(visibility);
-        vtkIdList* ids = vtkIdList::New();
-        ids->SetNumberOfIds(8);
-        vtkIdType numCells = nthOutput->GetNumberOfCells();
-        for (vtkIdType cellId=0; cellId<numCells; cellId++)
+        if (this->Internal->IBlanking)
           {
-          nthOutput->GetCellPoints(cellId, ids);
-          vtkIdType numIds = ids->GetNumberOfIds();
-          char visible = 1;
-          for (vtkIdType ptIdx=0; ptIdx<numIds; ptIdx++)
+          int* ib = (int*)malloc(dims[0]*dims[1]*dims[2]*sizeof(int));
+          if ( this->ReadIntBlock(xyzFp, dims[0]*dims[1]*dims[2], ib) == 0)
             {
-            if (ib[ids->GetId(ptIdx)] == 0)
-              {
-              visible = 0;
-              break;
-              }
+            vtkErrorMacro("Encountered premature end-of-file while reading "
+                          "the q file (or the file is corrupt).");
+            this->SetErrorCode(vtkErrorCode::PrematureEndOfFileError);
+            free(ib);
+            fclose(xyzFp);
+            return 0;
             }
-          visibility->SetValue(cellId, visible);
+
+          vtkIntArray* iblank = vtkIntArray::New();
+          iblank->SetName("IBlank");
+          iblank->SetVoidArray(ib, dims[0]*dims[1]*dims[2], 0);
+          nthOutput->GetPointData()->AddArray(iblank);
+          iblank->Delete();
+
+          vtkUnsignedCharArray* visibility = vtkUnsignedCharArray::New();
+          visibility->SetNumberOfComponents(1);
+          visibility->SetNumberOfTuples( nthOutput->GetNumberOfCells() );
+          visibility->SetName("Visibility");
+          nthOutput->SetCellVisibilityArray(visibility);
+          nthOutput->GetCellData()->AddArray(visibility);
+          vtkPLOT3DGeometryBlock block;
+          memset(&block, 0, sizeof(block));
+          nthOutput->GetDimensions(block.Dimensions);
+          block.NumberOfCells = nthOutput->GetNumberOfCells();
+          block.IBlank = ib;
+          block.Visibility = visibility->GetPointer(0);
+          vtkPLOT3DComputeVisibility(&block, 1);
+          visibility->Delete();
           }
-        ids->Delete();
+        this->SkipByteCount(xyzFp);
         }
-      this->SkipByteCount(xyzFp);
       }
 
     fclose(xyzFp);
@@ -1492,107 +1832,534 @@ void vtkMultiBlockPLOT3DReader::AssignAttribute(int fNumber, vtkStructuredGrid*
     }
 }
 
-void vtkMultiBlockPLOT3DReader::ComputeTemperature(vtkStructuredGrid* output)
+namespace
 {
-  double *m, e, rr, u, v, w, v2, p, d, rrgas;
-  vtkIdType i;
-  vtkDataArray *temperature;
-
-  //  Check that the required data is available
-  //
-  vtkPointData* outputPD = output->GetPointData();
-  vtkDataArray* density = outputPD->GetArray("Density");
-  vtkDataArray* momentum = outputPD->GetArray("Momentum");
-  vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
+// The solution at a point. Quantities that a function does not need are
+// left at 0, the density at 1.
+struct vtkPLOT3DSolution
+{
+  double Density;
+  double Momentum[3];
+  double Energy;
+  double Gamma;
+  double Vector[3];
 
-  if ( density == NULL || momentum == NULL ||
-       energy == NULL )
+  double VelocitySquared() const
     {
-    vtkErrorMacro(<<"Cannot compute temperature");
-    return;
+    double rr = 1.0 / this->Density;
+    double u = this->Momentum[0] * rr;
+    double v = this->Momentum[1] * rr;
+    double w = this->Momentum[2] * rr;
+    return u*u + v*v + w*w;
     }
+};
 
-  vtkIdType numPts = density->GetNumberOfTuples();
-  temperature = this->NewFloatArray();
-  temperature->SetNumberOfTuples(numPts);
-
-  //  Compute the temperature
-  //
-  rrgas = 1.0 / this->R;
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    p = (this->Gamma-1.) * (e - 0.5 * d * v2);
-    temperature->SetTuple1(i, p*rr*rrgas);
-  }
-
-  temperature->SetName("Temperature");
-  outputPD->AddArray(temperature);
+// Evaluates a function of the solution at every point of a block,
+// concurrently. Function maps the solution at a point to the values of
+// the tuple of the output there.
+template <class DataType, class Function>
+class vtkPLOT3DPointFunctor
+{
+public:
+  vtkDataArray* Density;
+  vtkDataArray* Momentum;
+  vtkDataArray* Energy;
+  vtkDataArray* Gamma;
+  vtkDataArray* Vector;
+  DataType* Output;
+  int NumberOfComponents;
+  Function Evaluate;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    vtkPLOT3DSolution s;
+    memset(&s, 0, sizeof(s));
+    s.Density = 1.0;
+    double value[3];
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      if (this->Density)
+        {
+        s.Density = this->Density->GetComponent(i,0);
+        s.Density = (s.Density != 0.0 ? s.Density : 1.0);
+        }
+      if (this->Momentum)
+        {
+        this->Momentum->GetTuple(i, s.Momentum);
+        }
+      if (this->Energy)
+        {
+        s.Energy = this->Energy->GetComponent(i,0);
+        }
+      if (this->Gamma)
+        {
+        s.Gamma = this->Gamma->GetComponent(i,0);
+        }
+      if (this->Vector)
+        {
+        this->Vector->GetTuple(i, s.Vector);
+        }
+      this->Evaluate(s, value);
+      DataType* tuple = this->Output + i*this->NumberOfComponents;
+      for (int j=0; j<this->NumberOfComponents; j++)
+        {
+        tuple[j] = static_cast<DataType>(value[j]);
+        }
+      }
+    }
+};
 
-  temperature->Delete();
-  vtkDebugMacro(<<"Created temperature scalar");
+template <class DataType, class Function>
+void vtkPLOT3DComputePoints(DataType* output, vtkDataArray* outputArray,
+                            const Function& function, vtkDataArray* density,
+                            vtkDataArray* momentum, vtkDataArray* energy,
+                            vtkDataArray* gamma, vtkDataArray* vector)
+{
+  vtkPLOT3DPointFunctor<DataType, Function> functor;
+  functor.Density = density;
+  functor.Momentum = momentum;
+  functor.Energy = energy;
+  functor.Gamma = gamma;
+  functor.Vector = vector;
+  functor.Output = output;
+  functor.NumberOfComponents = outputArray->GetNumberOfComponents();
+  functor.Evaluate = function;
+  vtkSMPTools::For(0, outputArray->GetNumberOfTuples(), functor);
 }
 
-void vtkMultiBlockPLOT3DReader::ComputePressure(vtkStructuredGrid* output)
+// Fills output, a float or double array with as many tuples as the
+// inputs, with a function of the solution.
+template <class Function>
+void vtkPLOT3DComputePoints(vtkDataArray* output, const Function& function,
+                            vtkDataArray* density, vtkDataArray* momentum,
+                            vtkDataArray* energy = NULL,
+                            vtkDataArray* gamma = NULL,
+                            vtkDataArray* vector = NULL)
 {
-  double *m, e, u, v, w, v2, p, d, rr;
-  vtkIdType i;
-  vtkDataArray *pressure;
-
-  //  Check that the required data is available
-  //
-  vtkPointData* outputPD = output->GetPointData();
-  vtkDataArray* density = outputPD->GetArray("Density");
-  vtkDataArray* momentum = outputPD->GetArray("Momentum");
-  vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
-  if ( density == NULL || momentum == NULL ||
-       energy == NULL )
+  if (output->GetDataType() == VTK_FLOAT)
     {
-    vtkErrorMacro(<<"Cannot compute pressure");
-    return;
+    vtkPLOT3DComputePoints(static_cast<float*>(output->GetVoidPointer(0)),
+                           output, function, density, momentum, energy,
+                           gamma, vector);
+    }
+  else
+    {
+    vtkPLOT3DComputePoints(static_cast<double*>(output->GetVoidPointer(0)),
+                           output, function, density, momentum, energy,
+                           gamma, vector);
     }
-
-  vtkIdType numPts = density->GetNumberOfTuples();
-  pressure = this->NewFloatArray();
-  pressure->SetNumberOfTuples(numPts);
-
-  //  Compute the pressure
-  //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    p = (this->Gamma-1.) * (e - 0.5 * d * v2);
-    pressure->SetTuple1(i, p);
-  }
-
-  pressure->SetName("Pressure");
-  outputPD->AddArray(pressure);
-  pressure->Delete();
-  vtkDebugMacro(<<"Created pressure scalar");
 }
 
-void vtkMultiBlockPLOT3DReader::ComputeEnthalpy(vtkStructuredGrid* output)
+struct vtkPLOT3DTemperature
 {
-  double *m, e, u, v, w, v2, d, rr;
-  vtkIdType i;
-  vtkDataArray *enthalpy;
+  double Gamma;
+  double RRGas;
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double rr = 1.0 / s.Density;
+    double p = (this->Gamma-1.) *
+      (s.Energy - 0.5 * s.Density * s.VelocitySquared());
+    value[0] = p*rr*this->RRGas;
+    }
+};
 
+struct vtkPLOT3DPressure
+{
+  double Gamma;
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    value[0] = (this->Gamma-1.) *
+      (s.Energy - 0.5 * s.Density * s.VelocitySquared());
+    }
+};
+
+struct vtkPLOT3DEnthalpy
+{
+  double Gamma;
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double rr = 1.0 / s.Density;
+    value[0] = this->Gamma*(s.Energy*rr - 0.5*s.VelocitySquared());
+    }
+};
+
+struct vtkPLOT3DKineticEnergy
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    value[0] = 0.5*s.VelocitySquared();
+    }
+};
+
+struct vtkPLOT3DVelocityMagnitude
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    value[0] = sqrt(s.VelocitySquared());
+    }
+};
+
+// Gamma and R are named so that VTK_PINF and VTK_CV can be used.
+struct vtkPLOT3DEntropy
+{
+  double Gamma;
+  double R;
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double d = s.Density;
+    double p = (this->Gamma-1.)*(s.Energy - 0.5*d*s.VelocitySquared());
+    value[0] = VTK_CV *
+      log((p/VTK_PINF)/pow(d/VTK_RHOINF,(double)this->Gamma));
+    }
+};
+
+// The vector of the solution is the vorticity.
+struct vtkPLOT3DSwirl
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double v2 = s.VelocitySquared();
+    const double* m = s.Momentum;
+    const double* vort = s.Vector;
+    if ( v2 != 0.0 )
+      {
+      value[0] = (vort[0]*m[0] + vort[1]*m[1] + vort[2]*m[2]) / v2;
+      }
+    else
+      {
+      value[0] = 0.0;
+      }
+    }
+};
+
+struct vtkPLOT3DVelocity
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double rr = 1.0 / s.Density;
+    value[0] = s.Momentum[0] * rr;
+    value[1] = s.Momentum[1] * rr;
+    value[2] = s.Momentum[2] * rr;
+    }
+};
+
+struct vtkPLOT3DPressureCoefficient
+{
+  double FreeStreamPressure;
+  double Denominator;
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double g = s.Gamma;
+    double p = (g-1.) * (s.Energy - 0.5 * s.Density * s.VelocitySquared());
+    value[0] = (p - this->FreeStreamPressure)/this->Denominator;
+    }
+};
+
+struct vtkPLOT3DMachNumber
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double g = s.Gamma;
+    double rr = 1.0 / s.Density;
+    double v2 = s.VelocitySquared();
+    double a2 = g * (g-1.) * (s.Energy * rr - .5*v2);
+    value[0] = sqrt(v2/a2);
+    }
+};
+
+struct vtkPLOT3DSoundSpeed
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    double g = s.Gamma;
+    double rr = 1.0 / s.Density;
+    double p = (g-1.) * (s.Energy - 0.5 * s.Density * s.VelocitySquared());
+    value[0] = sqrt(g*p*rr);
+    }
+};
+
+// The vector of the solution is the vorticity.
+struct vtkPLOT3DVorticityMagnitude
+{
+  void operator()(const vtkPLOT3DSolution& s, double* value) const
+    {
+    const double* vort = s.Vector;
+    value[0] = sqrt(vort[0]*vort[0]+
+                    vort[1]*vort[1]+vort[2]*vort[2]);
+    }
+};
+
+// Evaluates a function of the derivatives of a point field at every point
+// of the curvilinear grid of a block, concurrently over the grid lines
+// along i. Function gets the metrics of the grid, metrics[d] being the
+// gradient of computational coordinate d (xi, eta, zeta), and the
+// derivatives of the field along the computational directions.
+template <class DataType, class Function>
+class vtkPLOT3DGradientFunctor
+{
+public:
+  vtkPoints* Points;
+  vtkDataArray* Field;
+  int Dimensions[3];
+  DataType* Output;
+  int NumberOfComponents;
+  Function Evaluate;
+
+  // Differences of the coordinates and the field along direction dir at
+  // point ijk: central inside the grid, one-sided on its boundary.
+  void Difference(const int ijk[3], int dir, double dx[3],
+                  double df[3]) const
+    {
+    const int* dims = this->Dimensions;
+    double xp[3], xm[3], vp[3] = {0.0, 0.0, 0.0}, vm[3] = {0.0, 0.0, 0.0};
+    double factor;
+    int ii;
+    if ( dims[dir] == 1 ) // 2D in this direction
+      {
+      factor = 1.0;
+      for (ii=0; ii<3; ii++)
+        {
+        xp[ii] = xm[ii] = 0.0;
+        }
+      xp[dir] = 1.0;
+      }
+    else
+      {
+      vtkIdType d01 = static_cast<vtkIdType>(dims[0])*dims[1];
+      vtkIdType stride = dir == 0 ? 1 : (dir == 1 ? dims[0] : d01);
+      vtkIdType idx = ijk[0] + ijk[1]*dims[0] + ijk[2]*d01;
+      vtkIdType idx2 = idx;
+      if ( ijk[dir] == 0 )
+        {
+        factor = 1.0;
+        idx += stride;
+        }
+      else if ( ijk[dir] == (dims[dir]-1) )
+        {
+        factor = 1.0;
+        idx2 -= stride;
+        }
+      else
+        {
+        factor = 0.5;
+        idx += stride;
+        idx2 -= stride;
+        }
+      this->Points->GetPoint(idx,xp);
+      this->Points->GetPoint(idx2,xm);
+      this->Field->GetTuple(idx,vp);
+      this->Field->GetTuple(idx2,vm);
+      }
+    for (ii=0; ii<3; ii++)
+      {
+      dx[ii] = factor * (xp[ii] - xm[ii]);
+      df[ii] = factor * (vp[ii] - vm[ii]);
+      }
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    const int* dims = this->Dimensions;
+    double dx[3][3], df[3][3], metrics[3][3], value[3];
+    int ijk[3];
+    for (vtkIdType line=begin; line<end; line++)
+      {
+      ijk[1] = static_cast<int>(line % dims[1]);
+      ijk[2] = static_cast<int>(line / dims[1]);
+      for (ijk[0]=0; ijk[0]<dims[0]; ijk[0]++)
+        {
+        for (int dir=0; dir<3; dir++)
+          {
+          this->Difference(ijk, dir, dx[dir], df[dir]);
+          }
+        double xxi = dx[0][0], yxi = dx[0][1], zxi = dx[0][2];
+        double xeta = dx[1][0], yeta = dx[1][1], zeta = dx[1][2];
+        double xzeta = dx[2][0], yzeta = dx[2][1], zzeta = dx[2][2];
+
+        // Now calculate the Jacobian.  Grids occasionally have
+        // singularities, or points where the Jacobian is infinite (the
+        // inverse is zero).  For these cases, we'll set the Jacobian to
+        // zero, which will result in a zero vorticity.
+        //
+        double aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
+          -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
+        if (aj != 0.0)
+          {
+          aj = 1. / aj;
+          }
+
+        //  Xi metrics.
+        metrics[0][0] =  aj*(yeta*zzeta-zeta*yzeta);
+        metrics[0][1] = -aj*(xeta*zzeta-zeta*xzeta);
+        metrics[0][2] =  aj*(xeta*yzeta-yeta*xzeta);
+
+        //  Eta metrics.
+        metrics[1][0] = -aj*(yxi*zzeta-zxi*yzeta);
+        metrics[1][1] =  aj*(xxi*zzeta-zxi*xzeta);
+        metrics[1][2] = -aj*(xxi*yzeta-yxi*xzeta);
+
+        //  Zeta metrics.
+        metrics[2][0] =  aj*(yxi*zeta-zxi*yeta);
+        metrics[2][1] = -aj*(xxi*zeta-zxi*xeta);
+        metrics[2][2] =  aj*(xxi*yeta-yxi*xeta);
+
+        this->Evaluate(metrics, df, value);
+        DataType* tuple = this->Output + (ijk[0] + line*dims[0])*
+          this->NumberOfComponents;
+        for (int j=0; j<this->NumberOfComponents; j++)
+          {
+          tuple[j] = static_cast<DataType>(value[j]);
+          }
+        }
+      }
+    }
+};
+
+template <class DataType, class Function>
+void vtkPLOT3DComputeGradient(DataType* output, vtkDataArray* outputArray,
+                              vtkStructuredGrid* grid, vtkDataArray* field,
+                              const Function& function)
+{
+  vtkPLOT3DGradientFunctor<DataType, Function> functor;
+  functor.Points = grid->GetPoints();
+  functor.Field = field;
+  grid->GetDimensions(functor.Dimensions);
+  functor.Output = output;
+  functor.NumberOfComponents = outputArray->GetNumberOfComponents();
+  functor.Evaluate = function;
+  vtkSMPTools::For(
+    0, static_cast<vtkIdType>(functor.Dimensions[1])*functor.Dimensions[2],
+    functor);
+}
+
+// Fills output, a float or double array with a tuple for each point of
+// grid, with a function of the derivatives of field.
+template <class Function>
+void vtkPLOT3DComputeGradient(vtkDataArray* output, vtkStructuredGrid* grid,
+                              vtkDataArray* field, const Function& function)
+{
+  if (output->GetDataType() == VTK_FLOAT)
+    {
+    vtkPLOT3DComputeGradient(static_cast<float*>(output->GetVoidPointer(0)),
+                             output, grid, field, function);
+    }
+  else
+    {
+    vtkPLOT3DComputeGradient(static_cast<double*>(output->GetVoidPointer(0)),
+                             output, grid, field, function);
+    }
+}
+
+// The field is the velocity.
+struct vtkPLOT3DVorticity
+{
+  void operator()(const double m[3][3], const double df[3][3],
+                  double* value) const
+    {
+    for (int c=0; c<3; c++)
+      {
+      int a = (c+1)%3;
+      int b = (c+2)%3;
+      value[c] = m[0][a]*df[0][b]+m[1][a]*df[1][b]+m[2][a]*df[2][b]
+        - m[0][b]*df[0][a]-m[1][b]*df[1][a]-m[2][b]*df[2][a];
+      }
+    }
+};
+
+// The field is the pressure.
+struct vtkPLOT3DGradient
+{
+  void operator()(const double m[3][3], const double df[3][3],
+                  double* value) const
+    {
+    for (int c=0; c<3; c++)
+      {
+      value[c] = m[0][c]*df[0][0]+m[1][c]*df[1][0]+m[2][c]*df[2][0];
+      }
+    }
+};
+
+// The field is the velocity.
+struct vtkPLOT3DStrainRate
+{
+  void operator()(const double m[3][3], const double df[3][3],
+                  double* value) const
+    {
+    for (int c=0; c<3; c++)
+      {
+      value[c] = m[0][c]*df[0][c]+m[1][c]*df[1][c]+m[2][c]*df[2][c];
+      }
+    }
+};
+}
+
+void vtkMultiBlockPLOT3DReader::ComputeTemperature(vtkStructuredGrid* output)
+{
+  //  Check that the required data is available
+  //
+  vtkPointData* outputPD = output->GetPointData();
+  vtkDataArray* density = outputPD->GetArray("Density");
+  vtkDataArray* momentum = outputPD->GetArray("Momentum");
+  vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
+
+  if ( density == NULL || momentum == NULL ||
+       energy == NULL )
+    {
+    vtkErrorMacro(<<"Cannot compute temperature");
+    return;
+    }
+
+  vtkIdType numPts = density->GetNumberOfTuples();
+  vtkDataArray* temperature = this->NewFloatArray();
+  temperature->SetNumberOfTuples(numPts);
+
+  //  Compute the temperature
+  //
+  vtkPLOT3DTemperature function;
+  function.Gamma = this->Gamma;
+  function.RRGas = 1.0 / this->R;
+  vtkPLOT3DComputePoints(temperature, function, density, momentum, energy);
+
+  temperature->SetName("Temperature");
+  outputPD->AddArray(temperature);
+
+  temperature->Delete();
+  vtkDebugMacro(<<"Created temperature scalar");
+}
+
+void vtkMultiBlockPLOT3DReader::ComputePressure(vtkStructuredGrid* output)
+{
+  //  Check that the required data is available
+  //
+  vtkPointData* outputPD = output->GetPointData();
+  vtkDataArray* density = outputPD->GetArray("Density");
+  vtkDataArray* momentum = outputPD->GetArray("Momentum");
+  vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
+  if ( density == NULL || momentum == NULL ||
+       energy == NULL )
+    {
+    vtkErrorMacro(<<"Cannot compute pressure");
+    return;
+    }
+
+  vtkIdType numPts = density->GetNumberOfTuples();
+  vtkDataArray* pressure = this->NewFloatArray();
+  pressure->SetNumberOfTuples(numPts);
+
+  //  Compute the pressure
+  //
+  vtkPLOT3DPressure function;
+  function.Gamma = this->Gamma;
+  vtkPLOT3DComputePoints(pressure, function, density, momentum, energy);
+
+  pressure->SetName("Pressure");
+  outputPD->AddArray(pressure);
+  pressure->Delete();
+  vtkDebugMacro(<<"Created pressure scalar");
+}
+
+void vtkMultiBlockPLOT3DReader::ComputeEnthalpy(vtkStructuredGrid* output)
+{
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1607,24 +2374,15 @@ void vtkMultiBlockPLOT3DReader::ComputeEnthalpy(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  enthalpy = this->NewFloatArray();
+  vtkDataArray* enthalpy = this->NewFloatArray();
   enthalpy->SetNumberOfTuples(numPts);
 
   //  Compute the enthalpy
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    enthalpy->SetTuple1(i, this->Gamma*(e*rr - 0.5*v2));
-  }
+  vtkPLOT3DEnthalpy function;
+  function.Gamma = this->Gamma;
+  vtkPLOT3DComputePoints(enthalpy, function, density, momentum, energy);
+
   enthalpy->SetName("Enthalpy");
   outputPD->AddArray(enthalpy);
   enthalpy->Delete();
@@ -1633,10 +2391,6 @@ void vtkMultiBlockPLOT3DReader::ComputeEnthalpy(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputeKineticEnergy(vtkStructuredGrid* output)
 {
-  double *m, u, v, w, v2, d, rr;
-  vtkIdType i;
-  vtkDataArray *kineticEnergy;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1649,23 +2403,14 @@ void vtkMultiBlockPLOT3DReader::ComputeKineticEnergy(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  kineticEnergy = this->NewFloatArray();
+  vtkDataArray* kineticEnergy = this->NewFloatArray();
   kineticEnergy->SetNumberOfTuples(numPts);
 
   //  Compute the kinetic energy
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    kineticEnergy->SetTuple1(i, 0.5*v2);
-  }
+  vtkPLOT3DComputePoints(kineticEnergy, vtkPLOT3DKineticEnergy(),
+                         density, momentum);
+
   kineticEnergy->SetName("KineticEnergy");
   outputPD->AddArray(kineticEnergy);
   kineticEnergy->Delete();
@@ -1674,10 +2419,6 @@ void vtkMultiBlockPLOT3DReader::ComputeKineticEnergy(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputeVelocityMagnitude(vtkStructuredGrid* output)
 {
-  double *m, u, v, w, v2, d, rr;
-  vtkIdType i;
-  vtkDataArray *velocityMag;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1692,23 +2433,14 @@ void vtkMultiBlockPLOT3DReader::ComputeVelocityMagnitude(vtkStructuredGrid* outp
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  velocityMag = this->NewFloatArray();
+  vtkDataArray* velocityMag = this->NewFloatArray();
   velocityMag->SetNumberOfTuples(numPts);
 
   //  Compute the velocity magnitude
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    velocityMag->SetTuple1(i, sqrt((double)v2));
-    }
+  vtkPLOT3DComputePoints(velocityMag, vtkPLOT3DVelocityMagnitude(),
+                         density, momentum);
+
   velocityMag->SetName("VelocityMagnitude");
   outputPD->AddArray(velocityMag);
   velocityMag->Delete();
@@ -1717,10 +2449,6 @@ void vtkMultiBlockPLOT3DReader::ComputeVelocityMagnitude(vtkStructuredGrid* outp
 
 void vtkMultiBlockPLOT3DReader::ComputeEntropy(vtkStructuredGrid* output)
 {
-  double *m, u, v, w, v2, d, rr, s, p, e;
-  vtkIdType i;
-  vtkDataArray *entropy;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1735,26 +2463,16 @@ void vtkMultiBlockPLOT3DReader::ComputeEntropy(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  entropy = this->NewFloatArray();
+  vtkDataArray* entropy = this->NewFloatArray();
   entropy->SetNumberOfTuples(numPts);
 
   //  Compute the entropy
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    p = (this->Gamma-1.)*(e - 0.5*d*v2);
-    s = VTK_CV * log((p/VTK_PINF)/pow((double)d/VTK_RHOINF,(double)this->Gamma));
-    entropy->SetTuple1(i,s);
-  }
+  vtkPLOT3DEntropy function;
+  function.Gamma = this->Gamma;
+  function.R = this->R;
+  vtkPLOT3DComputePoints(entropy, function, density, momentum, energy);
+
   entropy->SetName("Entropy");
   outputPD->AddArray(entropy);
   entropy->Delete();
@@ -1763,11 +2481,6 @@ void vtkMultiBlockPLOT3DReader::ComputeEntropy(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputeSwirl(vtkStructuredGrid* output)
 {
-  vtkDataArray *vorticity;
-  double d, rr, *m, u, v, w, v2, *vort, s;
-  vtkIdType i;
-  vtkDataArray *swirl;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1782,36 +2495,17 @@ void vtkMultiBlockPLOT3DReader::ComputeSwirl(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  swirl = this->NewFloatArray();
+  vtkDataArray* swirl = this->NewFloatArray();
   swirl->SetNumberOfTuples(numPts);
 
   this->ComputeVorticity(output);
-  vorticity = outputPD->GetArray("Vorticity");
+  vtkDataArray* vorticity = outputPD->GetArray("Vorticity");
 //
 //  Compute the swirl
 //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    vort = vorticity->GetTuple(i);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    if ( v2 != 0.0 )
-      {
-      s = (vort[0]*m[0] + vort[1]*m[1] + vort[2]*m[2]) / v2;
-      }
-    else
-      {
-      s = 0.0;
-      }
+  vtkPLOT3DComputePoints(swirl, vtkPLOT3DSwirl(), density, momentum,
+                         NULL, NULL, vorticity);
 
-    swirl->SetTuple1(i,s);
-  }
   swirl->SetName("Swirl");
   outputPD->AddArray(swirl);
   swirl->Delete();
@@ -1822,10 +2516,6 @@ void vtkMultiBlockPLOT3DReader::ComputeSwirl(vtkStructuredGrid* output)
 // Vector functions
 void vtkMultiBlockPLOT3DReader::ComputeVelocity(vtkStructuredGrid* output)
 {
-  double *m, v[3], d, rr;
-  vtkIdType i;
-  vtkDataArray *velocity;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -1840,23 +2530,14 @@ void vtkMultiBlockPLOT3DReader::ComputeVelocity(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  velocity = this->NewFloatArray();
+  vtkDataArray* velocity = this->NewFloatArray();
   velocity->SetNumberOfComponents(3);
   velocity->SetNumberOfTuples(numPts);
 
   //  Compute the velocity
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    rr = 1.0 / d;
-    v[0] = m[0] * rr;
-    v[1] = m[1] * rr;
-    v[2] = m[2] * rr;
-    velocity->SetTuple(i, v);
-  }
+  vtkPLOT3DComputePoints(velocity, vtkPLOT3DVelocity(), density, momentum);
+
   velocity->SetName("Velocity");
   outputPD->AddArray(velocity);
   velocity->Delete();
@@ -1865,24 +2546,13 @@ void vtkMultiBlockPLOT3DReader::ComputeVelocity(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputeVorticity(vtkStructuredGrid* output)
 {
-  vtkDataArray *velocity;
-  vtkDataArray *vorticity;
-  int dims[3], ijsize;
-  vtkPoints *points;
-  int i, j, k, idx, idx2, ii;
-  double vort[3], xp[3], xm[3], vp[3], vm[3], factor;
-  double xxi, yxi, zxi, uxi, vxi, wxi;
-  double xeta, yeta, zeta, ueta, veta, weta;
-  double xzeta, yzeta, zzeta, uzeta, vzeta, wzeta;
-  double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
   vtkDataArray* density = outputPD->GetArray("Density");
   vtkDataArray* momentum = outputPD->GetArray("Momentum");
   vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
-  if ( (points=output->GetPoints()) == NULL ||
+  if ( output->GetPoints() == NULL ||
        density == NULL || momentum == NULL ||
        energy == NULL )
     {
@@ -1891,204 +2561,16 @@ void vtkMultiBlockPLOT3DReader::ComputeVorticity(vtkStructuredGrid* output)
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  vorticity = this->NewFloatArray();
+  vtkDataArray* vorticity = this->NewFloatArray();
   vorticity->SetNumberOfComponents(3);
   vorticity->SetNumberOfTuples(numPts);
 
   this->ComputeVelocity(output);
-  velocity = outputPD->GetArray("Velocity");
-
-  output->GetDimensions(dims);
-  ijsize = dims[0]*dims[1];
-
-  for (k=0; k<dims[2]; k++)
-    {
-    for (j=0; j<dims[1]; j++)
-      {
-      for (i=0; i<dims[0]; i++)
-        {
-        //  Xi derivatives.
-        if ( dims[0] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[0] = 1.0;
-          }
-        else if ( i == 0 )
-          {
-          factor = 1.0;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( i == (dims[0]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i-1 + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = (i-1) + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
-        xxi = factor * (xp[0] - xm[0]);
-        yxi = factor * (xp[1] - xm[1]);
-        zxi = factor * (xp[2] - xm[2]);
-        uxi = factor * (vp[0] - vm[0]);
-        vxi = factor * (vp[1] - vm[1]);
-        wxi = factor * (vp[2] - vm[2]);
-
-        //  Eta derivatives.
-        if ( dims[1] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[1] = 1.0;
-          }
-        else if ( j == 0 )
-          {
-          factor = 1.0;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( j == (dims[1]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
+  vtkDataArray* velocity = outputPD->GetArray("Velocity");
 
-        xeta = factor * (xp[0] - xm[0]);
-        yeta = factor * (xp[1] - xm[1]);
-        zeta = factor * (xp[2] - xm[2]);
-        ueta = factor * (vp[0] - vm[0]);
-        veta = factor * (vp[1] - vm[1]);
-        weta = factor * (vp[2] - vm[2]);
+  vtkPLOT3DComputeGradient(vorticity, output, velocity,
+                           vtkPLOT3DVorticity());
 
-        //  Zeta derivatives.
-        if ( dims[2] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[2] = 1.0;
-          }
-        else if ( k == 0 )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( k == (dims[2]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
-        xzeta = factor * (xp[0] - xm[0]);
-        yzeta = factor * (xp[1] - xm[1]);
-        zzeta = factor * (xp[2] - xm[2]);
-        uzeta = factor * (vp[0] - vm[0]);
-        vzeta = factor * (vp[1] - vm[1]);
-        wzeta = factor * (vp[2] - vm[2]);
-
-        // Now calculate the Jacobian.  Grids occasionally have
-        // singularities, or points where the Jacobian is infinite (the
-        // inverse is zero).  For these cases, we'll set the Jacobian to
-        // zero, which will result in a zero vorticity.
-        //
-        aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
-              -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
-        if (aj != 0.0)
-          {
-          aj = 1. / aj;
-          }
-
-        //  Xi metrics.
-        xix  =  aj*(yeta*zzeta-zeta*yzeta);
-        xiy  = -aj*(xeta*zzeta-zeta*xzeta);
-        xiz  =  aj*(xeta*yzeta-yeta*xzeta);
-
-        //  Eta metrics.
-        etax = -aj*(yxi*zzeta-zxi*yzeta);
-        etay =  aj*(xxi*zzeta-zxi*xzeta);
-        etaz = -aj*(xxi*yzeta-yxi*xzeta);
-
-        //  Zeta metrics.
-        zetax=  aj*(yxi*zeta-zxi*yeta);
-        zetay= -aj*(xxi*zeta-zxi*xeta);
-        zetaz=  aj*(xxi*yeta-yxi*xeta);
-
-        //  Finally, the vorticity components.
-        //
-        vort[0]= xiy*wxi+etay*weta+zetay*wzeta - xiz*vxi-etaz*veta-zetaz*vzeta;
-        vort[1]= xiz*uxi+etaz*ueta+zetaz*uzeta - xix*wxi-etax*weta-zetax*wzeta;
-        vort[2]= xix*vxi+etax*veta+zetax*vzeta - xiy*uxi-etay*ueta-zetay*uzeta;
-        idx = i + j*dims[0] + k*ijsize;
-        vorticity->SetTuple(idx,vort);
-        }
-      }
-    }
   vorticity->SetName("Vorticity");
   outputPD->AddArray(vorticity);
   vorticity->Delete();
@@ -2097,24 +2579,13 @@ void vtkMultiBlockPLOT3DReader::ComputeVorticity(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputePressureGradient(vtkStructuredGrid* output)
 {
-  vtkDataArray *pressure;
-  vtkDataArray *gradient;
-  int dims[3], ijsize;
-  vtkPoints *points;
-  int i, j, k, idx, idx2, ii;
-  double g[3], xp[3], xm[3], pp, pm, factor;
-  double xxi, yxi, zxi, pxi;
-  double xeta, yeta, zeta, peta;
-  double xzeta, yzeta, zzeta, pzeta;
-  double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
   vtkDataArray* density = outputPD->GetArray("Density");
   vtkDataArray* momentum = outputPD->GetArray("Momentum");
   vtkDataArray* energy = outputPD->GetArray("StagnationEnergy");
-  if ( (points=output->GetPoints()) == NULL ||
+  if ( output->GetPoints() == NULL ||
        density == NULL || momentum == NULL ||
        energy == NULL )
     {
@@ -2123,197 +2594,15 @@ void vtkMultiBlockPLOT3DReader::ComputePressureGradient(vtkStructuredGrid* outpu
     }
 
   vtkIdType numPts = density->GetNumberOfTuples();
-  gradient = this->NewFloatArray();
+  vtkDataArray* gradient = this->NewFloatArray();
   gradient->SetNumberOfComponents(3);
   gradient->SetNumberOfTuples(numPts);
 
   this->ComputePressure(output);
-  pressure = outputPD->GetArray("Pressure");
+  vtkDataArray* pressure = outputPD->GetArray("Pressure");
 
-  output->GetDimensions(dims);
-  ijsize = dims[0]*dims[1];
+  vtkPLOT3DComputeGradient(gradient, output, pressure, vtkPLOT3DGradient());
 
-  for (k=0; k<dims[2]; k++)
-    {
-    for (j=0; j<dims[1]; j++)
-      {
-      for (i=0; i<dims[0]; i++)
-        {
-        //  Xi derivatives.
-        if ( dims[0] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            xp[ii] = xm[ii] = 0.0;
-            }
-          xp[0] = 1.0; pp = pm = 0.0;
-          }
-        else if ( i == 0 )
-          {
-          factor = 1.0;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else if ( i == (dims[0]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i-1 + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = (i-1) + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-
-        xxi = factor * (xp[0] - xm[0]);
-        yxi = factor * (xp[1] - xm[1]);
-        zxi = factor * (xp[2] - xm[2]);
-        pxi = factor * (pp - pm);
-
-        //  Eta derivatives.
-        if ( dims[1] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            xp[ii] = xm[ii] = 0.0;
-            }
-          xp[1] = 1.0; pp = pm = 0.0;
-          }
-        else if ( j == 0 )
-          {
-          factor = 1.0;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else if ( j == (dims[1]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-
-        xeta = factor * (xp[0] - xm[0]);
-        yeta = factor * (xp[1] - xm[1]);
-        zeta = factor * (xp[2] - xm[2]);
-        peta = factor * (pp - pm);
-
-        //  Zeta derivatives.
-        if ( dims[2] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            xp[ii] = xm[ii] = 0.0;
-            }
-          xp[2] = 1.0; pp = pm = 0.0;
-          }
-        else if ( k == 0 )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else if ( k == (dims[2]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          points->GetPoint(idx,xp);
-          points->GetPoint(idx2,xm);
-          pp = pressure->GetComponent(idx,0);
-          pm = pressure->GetComponent(idx2,0);
-          }
-
-        xzeta = factor * (xp[0] - xm[0]);
-        yzeta = factor * (xp[1] - xm[1]);
-        zzeta = factor * (xp[2] - xm[2]);
-        pzeta = factor * (pp - pm);
-
-        //  Now calculate the Jacobian.  Grids occasionally have
-        //  singularities, or points where the Jacobian is infinite (the
-        //  inverse is zero).  For these cases, we'll set the Jacobian to
-        //  zero, which will result in a zero vorticity.
-        //
-        aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
-              -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
-        if (aj != 0.0)
-          {
-          aj = 1. / aj;
-          }
-
-        //  Xi metrics.
-        xix  =  aj*(yeta*zzeta-zeta*yzeta);
-        xiy  = -aj*(xeta*zzeta-zeta*xzeta);
-        xiz  =  aj*(xeta*yzeta-yeta*xzeta);
-
-        //  Eta metrics.
-        etax = -aj*(yxi*zzeta-zxi*yzeta);
-        etay =  aj*(xxi*zzeta-zxi*xzeta);
-        etaz = -aj*(xxi*yzeta-yxi*xzeta);
-
-        //  Zeta metrics.
-        zetax=  aj*(yxi*zeta-zxi*yeta);
-        zetay= -aj*(xxi*zeta-zxi*xeta);
-        zetaz=  aj*(xxi*yeta-yxi*xeta);
-
-        //  Finally, the vorticity components.
-        g[0]= xix*pxi+etax*peta+zetax*pzeta;
-        g[1]= xiy*pxi+etay*peta+zetay*pzeta;
-        g[2]= xiz*pxi+etaz*peta+zetaz*pzeta;
-
-        idx = i + j*dims[0] + k*ijsize;
-        gradient->SetTuple(idx,g);
-        }
-      }
-    }
   gradient->SetName("PressureGradient");
   outputPD->AddArray(gradient);
   gradient->Delete();
@@ -2322,9 +2611,6 @@ void vtkMultiBlockPLOT3DReader::ComputePressureGradient(vtkStructuredGrid* outpu
 
 void vtkMultiBlockPLOT3DReader::ComputePressureCoefficient(vtkStructuredGrid* output)
 {
-  double *m, e, u, v, w, v2, p, d, g, rr, pc, gi, pi, fsm, den;
-  vtkIdType i;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -2351,26 +2637,13 @@ void vtkMultiBlockPLOT3DReader::ComputePressureCoefficient(vtkStructuredGrid* ou
   pressure_coeff->SetNumberOfTuples(numPts);
   //  Compute the pressure coefficient
   //
-  gi = props->GetComponent(0,4);
-  fsm = props->GetComponent(0,0);
-  den = .5*fsm*fsm;
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    g = gamma->GetComponent(i,0);
-    pi = 1.0 / gi;
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    p = (g-1.) * (e - 0.5 * d * v2);
-    pc = (p - pi)/den;
-    pressure_coeff->SetTuple1(i, pc);
-    }
+  double gi = props->GetComponent(0,4);
+  double fsm = props->GetComponent(0,0);
+  vtkPLOT3DPressureCoefficient function;
+  function.FreeStreamPressure = 1.0 / gi;
+  function.Denominator = .5*fsm*fsm;
+  vtkPLOT3DComputePoints(pressure_coeff, function, density, momentum, energy,
+                         gamma);
 
   pressure_coeff->SetName("PressureCoefficient");
   outputPD->AddArray(pressure_coeff);
@@ -2380,9 +2653,6 @@ void vtkMultiBlockPLOT3DReader::ComputePressureCoefficient(vtkStructuredGrid* ou
 
 void vtkMultiBlockPLOT3DReader::ComputeMachNumber(vtkStructuredGrid* output)
 {
-  double *m, e, u, v, w, v2, a2, d, g, rr;
-  vtkIdType i;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -2408,21 +2678,8 @@ void vtkMultiBlockPLOT3DReader::ComputeMachNumber(vtkStructuredGrid* output)
 
   //  Compute the mach number
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    g = gamma->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    a2 = g * (g-1.) * (e * rr - .5*v2);
-    machnumber->SetTuple1(i, sqrt(v2/a2));
-  }
+  vtkPLOT3DComputePoints(machnumber, vtkPLOT3DMachNumber(), density,
+                         momentum, energy, gamma);
 
   machnumber->SetName("MachNumber");
   outputPD->AddArray(machnumber);
@@ -2432,9 +2689,6 @@ void vtkMultiBlockPLOT3DReader::ComputeMachNumber(vtkStructuredGrid* output)
 
 void vtkMultiBlockPLOT3DReader::ComputeSoundSpeed(vtkStructuredGrid* output)
 {
-  double *m, e, u, v, w, v2, p, d, g, rr;
-  vtkIdType i;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -2460,21 +2714,8 @@ void vtkMultiBlockPLOT3DReader::ComputeSoundSpeed(vtkStructuredGrid* output)
 
   //  Compute sound speed
   //
-  for (i=0; i < numPts; i++)
-    {
-    d = density->GetComponent(i,0);
-    d = (d != 0.0 ? d : 1.0);
-    m = momentum->GetTuple(i);
-    e = energy->GetComponent(i,0);
-    g = gamma->GetComponent(i,0);
-    rr = 1.0 / d;
-    u = m[0] * rr;
-    v = m[1] * rr;
-    w = m[2] * rr;
-    v2 = u*u + v*v + w*w;
-    p = (g-1.) * (e - 0.5 * d * v2);
-    soundspeed->SetTuple1(i, sqrt(g*p*rr));
-  }
+  vtkPLOT3DComputePoints(soundspeed, vtkPLOT3DSoundSpeed(), density,
+                         momentum, energy, gamma);
 
   soundspeed->SetName("SoundSpeed");
   outputPD->AddArray(soundspeed);
@@ -2495,13 +2736,8 @@ void vtkMultiBlockPLOT3DReader::ComputeVorticityMagnitude(vtkStructuredGrid* out
   vtkDataArray* vm = this->NewFloatArray();
   vtkIdType numPts = vorticity->GetNumberOfTuples();
   vm->SetNumberOfTuples(numPts);
-  for (vtkIdType idx=0; idx<numPts; idx++)
-    {
-    double* vort = vorticity->GetTuple(idx);
-    double magnitude = sqrt(vort[0]*vort[0]+
-                            vort[1]*vort[1]+vort[2]*vort[2]);
-    vm->SetTuple1(idx, magnitude);
-    }
+  vtkPLOT3DComputePoints(vm, vtkPLOT3DVorticityMagnitude(), NULL, NULL,
+                         NULL, NULL, vorticity);
   vm->SetName("VorticityMagnitude");
   outputPD->AddArray(vm);
   vm->Delete();
@@ -2509,15 +2745,6 @@ void vtkMultiBlockPLOT3DReader::ComputeVorticityMagnitude(vtkStructuredGrid* out
 
 void vtkMultiBlockPLOT3DReader::ComputeStrainRate(vtkStructuredGrid* output)
 {
-  vtkDataArray *velocity;
-  int dims[3], ijsize;
-  int i, j, k, idx, idx2, ii;
-  double stRate[3], xp[3], xm[3], vp[3], vm[3], factor;
-  double xxi, yxi, zxi, uxi, vxi, wxi;
-  double xeta, yeta, zeta, ueta, veta, weta;
-  double xzeta, yzeta, zzeta, uzeta, vzeta, wzeta;
-  double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-
   //  Check that the required data is available
   //
   vtkPointData* outputPD = output->GetPointData();
@@ -2540,204 +2767,17 @@ void vtkMultiBlockPLOT3DReader::ComputeStrainRate(vtkStructuredGrid* output)
   strainRate->SetName("StrainRate");
 
   this->ComputeVelocity(output);
-  velocity = outputPD->GetArray("Velocity");
+  vtkDataArray* velocity = outputPD->GetArray("Velocity");
   if(!velocity)
     {
     vtkErrorMacro("Could not compute strain rate.");
+    strainRate->Delete();
     return;
     }
 
-  output->GetDimensions(dims);
-  ijsize = dims[0]*dims[1];
-
-  for (k=0; k<dims[2]; k++)
-    {
-    for (j=0; j<dims[1]; j++)
-      {
-      for (i=0; i<dims[0]; i++)
-        {
-        //  Xi derivatives.
-        if ( dims[0] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[0] = 1.0;
-          }
-        else if ( i == 0 )
-          {
-          factor = 1.0;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( i == (dims[0]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i-1 + j*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = (i+1) + j*dims[0] + k*ijsize;
-          idx2 = (i-1) + j*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
-        xxi = factor * (xp[0] - xm[0]);
-        yxi = factor * (xp[1] - xm[1]);
-        zxi = factor * (xp[2] - xm[2]);
-        uxi = factor * (vp[0] - vm[0]);
-        vxi = factor * (vp[1] - vm[1]);
-        wxi = factor * (vp[2] - vm[2]);
-
-        //  Eta derivatives.
-        if ( dims[1] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[1] = 1.0;
-          }
-        else if ( j == 0 )
-          {
-          factor = 1.0;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( j == (dims[1]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + (j+1)*dims[0] + k*ijsize;
-          idx2 = i + (j-1)*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
+  vtkPLOT3DComputeGradient(strainRate, output, velocity,
+                           vtkPLOT3DStrainRate());
 
-        xeta = factor * (xp[0] - xm[0]);
-        yeta = factor * (xp[1] - xm[1]);
-        zeta = factor * (xp[2] - xm[2]);
-        ueta = factor * (vp[0] - vm[0]);
-        veta = factor * (vp[1] - vm[1]);
-        weta = factor * (vp[2] - vm[2]);
-
-        //  Zeta derivatives.
-        if ( dims[2] == 1 ) // 2D in this direction
-          {
-          factor = 1.0;
-          for (ii=0; ii<3; ii++)
-            {
-            vp[ii] = vm[ii] = xp[ii] = xm[ii] = 0.0;
-            }
-          xp[2] = 1.0;
-          }
-        else if ( k == 0 )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + k*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else if ( k == (dims[2]-1) )
-          {
-          factor = 1.0;
-          idx = i + j*dims[0] + k*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-        else
-          {
-          factor = 0.5;
-          idx = i + j*dims[0] + (k+1)*ijsize;
-          idx2 = i + j*dims[0] + (k-1)*ijsize;
-          output->GetPoint(idx,xp);
-          output->GetPoint(idx2,xm);
-          velocity->GetTuple(idx,vp);
-          velocity->GetTuple(idx2,vm);
-          }
-
-        xzeta = factor * (xp[0] - xm[0]);
-        yzeta = factor * (xp[1] - xm[1]);
-        zzeta = factor * (xp[2] - xm[2]);
-        uzeta = factor * (vp[0] - vm[0]);
-        vzeta = factor * (vp[1] - vm[1]);
-        wzeta = factor * (vp[2] - vm[2]);
-
-        // Now calculate the Jacobian.  Grids occasionally have
-        // singularities, or points where the Jacobian is infinite (the
-        // inverse is zero).  For these cases, we'll set the Jacobian to
-        // zero, which will result in a zero vorticity.
-        //
-        aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
-              -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
-        if (aj != 0.0)
-          {
-          aj = 1. / aj;
-          }
-
-        //  Xi metrics.
-        xix  =  aj*(yeta*zzeta-zeta*yzeta);
-        xiy  = -aj*(xeta*zzeta-zeta*xzeta);
-        xiz  =  aj*(xeta*yzeta-yeta*xzeta);
-
-        //  Eta metrics.
-        etax = -aj*(yxi*zzeta-zxi*yzeta);
-        etay =  aj*(xxi*zzeta-zxi*xzeta);
-        etaz = -aj*(xxi*yzeta-yxi*xzeta);
-
-        //  Zeta metrics.
-        zetax=  aj*(yxi*zeta-zxi*yeta);
-        zetay= -aj*(xxi*zeta-zxi*xeta);
-        zetaz=  aj*(xxi*yeta-yxi*xeta);
-
-        //  Finally, the strain rate components.
-        //
-        stRate[0] = xix*uxi+etax*ueta+zetax*uzeta;
-        stRate[1] = xiy*vxi+etay*veta+zetay*vzeta;
-        stRate[2] = xiz*wxi+etaz*weta+zetaz*wzeta;
-        idx = i + j*dims[0] + k*ijsize;
-        strainRate->SetTuple(idx,stRate);
-        }
-      }
-    }
   outputPD->AddArray(strainRate);
   strainRate->Delete();
 }
@@ -261,6 +261,7 @@ protected:
 
   int ReadScalar(FILE* fp, int n, vtkDataArray* scalar);
   int ReadVector(FILE* fp, int n, int numDims, vtkDataArray* vector);
+  int ReadBinaryGeometry(FILE* xyzFp);
 
   int GetNumberOfBlocksInternal(FILE* xyzFp, int allocate);
 
@@ -16,12 +16,19 @@
 
 #include "vtkCellArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkOBJReader);
 
@@ -83,7 +90,8 @@ f <v_a>//<n_a> <v_b>//<n_b> ...
     polygonal face as above but without texture coordinates.
 
     Per-face tcoords and normals are supported by duplicating
-    the vertices on each face as necessary.
+    the vertices that faces refer to with different tcoords or
+    normals.
 
 l <v_a> <v_b> ...
 
@@ -98,557 +106,906 @@ p <v_a> <v_b> ...
 \*---------------------------------------------------------------------------*/
 
 
-int vtkOBJReader::RequestData(
-  vtkInformation *vtkNotUsed(request),
-  vtkInformationVector **vtkNotUsed(inputVector),
-  vtkInformationVector *outputVector)
+namespace {
+
+// The file is read in blocks of at least vtkOBJReaderBlockSize bytes, and
+// the records of a block are parsed concurrently in chunks of about
+// vtkOBJReaderChunkSize bytes.
+const size_t vtkOBJReaderBlockSize = 64 << 20;
+const size_t vtkOBJReaderChunkSize = 1 << 20;
+
+// Number of lines and records of each kind in (a part of) the file, and of
+// the indices held by the p, l and f records.
+struct vtkOBJReaderCounts
 {
-  // get the info object
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkIdType TextLines;
+  vtkIdType Points;
+  vtkIdType TCoords;
+  vtkIdType Normals;
+  vtkIdType Verts;
+  vtkIdType VertIds;
+  vtkIdType Lines;
+  vtkIdType LineIds;
+  vtkIdType Polys;
+  vtkIdType PolyIds;
+};
+
+void vtkOBJReaderAddCounts(vtkOBJReaderCounts &sum,
+                           const vtkOBJReaderCounts &counts)
+{
+  sum.TextLines += counts.TextLines;
+  sum.Points += counts.Points;
+  sum.TCoords += counts.TCoords;
+  sum.Normals += counts.Normals;
+  sum.Verts += counts.Verts;
+  sum.VertIds += counts.VertIds;
+  sum.Lines += counts.Lines;
+  sum.LineIds += counts.LineIds;
+  sum.Polys += counts.Polys;
+  sum.PolyIds += counts.PolyIds;
+}
 
-  // get the ouptut
-  vtkPolyData *output = vtkPolyData::SafeDownCast(
-    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+enum
+{
+  OBJ_NO_ERROR,
+  OBJ_BAD_RECORD,
+  OBJ_BAD_CONTINUATION,
+  OBJ_BAD_ELEMENT
+};
+
+// A run of whole records of the file, with what the counting pass found in
+// it and where the filling pass stores it.
+struct vtkOBJReaderChunk
+{
+  char *Begin;
+  char *End;
+  vtkOBJReaderCounts Count;
+  vtkOBJReaderCounts Start;
+  bool HasFaceTCoords;
+  bool HasFaceNormals;
+  bool TCoordsSameAsVerts;
+  bool NormalsSameAsVerts;
+  int Error;
+  const char *ErrorCommand;
+  vtkIdType ErrorLine; // counted from the start of the chunk
+};
+
+// Where the filling pass stores the records. Cells are stored as a count
+// followed by the point ids, and the texture coordinate and normal ids of
+// the face vertices (-1 if there are none) in the same order as the point
+// ids of the faces.
+struct vtkOBJReaderOutput
+{
+  float *Points;
+  float *TCoords;
+  float *Normals;
+  vtkIdType *Verts;
+  vtkIdType *Lines;
+  vtkIdType *Polys;
+  vtkIdType *PolyTCoordIds;
+  vtkIdType *PolyNormalIds;
+};
+
+inline bool vtkOBJReaderIsSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' ||
+    c == '\v' || c == '\f';
+}
 
-  if (!this->FileName)
+// Returns true if the newline at p ends a record, that is if the line is
+// not continued with a backslash. first is the start of a line.
+bool vtkOBJReaderEndsRecord(const char *first, const char *p)
+{
+  while (p > first && (p[-1] == ' ' || p[-1] == '\t' || p[-1] == '\r'))
     {
-    vtkErrorMacro(<< "A FileName must be specified.");
-    return 0;
+    --p;
     }
+  return p == first || p[-1] != '\\';
+}
 
-  FILE *in = fopen(this->FileName,"r");
-
-  if (in == NULL)
+// Returns the end of the first record ending at or after p, or stop.
+char *vtkOBJReaderFindRecordEnd(char *first, char *p, char *stop)
+{
+  while (p < stop &&
+         (p = static_cast<char *>(memchr(p, '\n', stop - p))) != NULL)
     {
-    vtkErrorMacro(<< "File " << this->FileName << " not found");
-    return 0;
+    if (vtkOBJReaderEndsRecord(first, p))
+      {
+      return p + 1;
+      }
+    ++p;
     }
+  return stop;
+}
 
-  vtkDebugMacro(<<"Reading file");
-
-  // intialise some structures to store the file contents in
-  vtkPoints *points = vtkPoints::New();
-  vtkFloatArray *tcoords = vtkFloatArray::New();
-  tcoords->SetNumberOfComponents(2);
-  vtkFloatArray *normals = vtkFloatArray::New();
-  normals->SetNumberOfComponents(3);
-  vtkCellArray *polys = vtkCellArray::New();
-  vtkCellArray *tcoord_polys = vtkCellArray::New();
-
-  vtkCellArray *pointElems = vtkCellArray::New();
-  vtkCellArray *lineElems = vtkCellArray::New();
-  vtkCellArray *normal_polys = vtkCellArray::New();
+// Returns the length of the whole records at the start of buffer.
+size_t vtkOBJReaderWholeRecordsLength(const char *buffer, size_t length)
+{
+  for (size_t i = length; i > 0; --i)
+    {
+    if (buffer[i - 1] == '\n' &&
+        vtkOBJReaderEndsRecord(buffer, buffer + i - 1))
+      {
+      return i;
+      }
+    }
+  return 0;
+}
 
-  bool hasTCoords = false;
-  bool hasNormals = false;
-  bool tcoords_same_as_verts = true;
-  bool normals_same_as_verts = true;
-  bool everything_ok = true; // (use of this flag avoids early return and associated memory leak)
+inline bool vtkOBJReaderParseInt(const char *&p, vtkIdType &value)
+{
+  const char *q = p;
+  bool negative = (*q == '-');
+  if (*q == '-' || *q == '+')
+    {
+    ++q;
+    }
+  if (*q < '0' || *q > '9')
+    {
+    return false;
+    }
+  vtkIdType v = 0;
+  do
+    {
+    v = 10 * v + (*q++ - '0');
+    }
+  while (*q >= '0' && *q <= '9');
+  value = negative ? -v : v;
+  p = q;
+  return true;
+}
 
-  // -- work through the file line by line, assigning into the above 7 structures as appropriate --
+// Parses a "v", "v/t", "v//n" or "v/t/n" index token. Missing indices are
+// set to 0, which no valid index takes.
+inline bool vtkOBJReaderParseIndices(const char *p, vtkIdType indices[3])
+{
+  indices[0] = indices[1] = indices[2] = 0;
+  if (!vtkOBJReaderParseInt(p, indices[0]))
+    {
+    return false;
+    }
+  if (*p == '/')
+    {
+    ++p;
+    vtkOBJReaderParseInt(p, indices[1]);
+    if (*p == '/')
+      {
+      ++p;
+      vtkOBJReaderParseInt(p, indices[2]);
+      }
+    }
+  return true;
+}
 
-  { // (make a local scope section to emphasise that the variables below are only used here)
+// Parses count numbers the way sscanf's %f would.
+inline bool vtkOBJReaderParseFloats(const char *p, float *values, int count)
+{
+  for (int i = 0; i < count; ++i)
+    {
+    char *end;
+    double value = strtod(p, &end);
+    if (end == p)
+      {
+      return false;
+      }
+    values[i] = static_cast<float>(value);
+    p = end;
+    }
+  return true;
+}
 
-  const int MAX_LINE = 1024;
-  char rawLine[MAX_LINE];
-  float xyz[3];
+void vtkOBJReaderSetError(vtkOBJReaderChunk &chunk, int error,
+                          const char *command, vtkIdType line)
+{
+  chunk.Error = error;
+  chunk.ErrorCommand = command;
+  chunk.ErrorLine = line;
+}
 
-  int lineNr = 0;
-  int numPoints = 0;
-  while (everything_ok && fgets(rawLine, MAX_LINE, in) != NULL)
+// Counts the records of a chunk when output is NULL, and parses them into
+// output otherwise. The counting pass also replaces the newlines with null
+// characters so that both passes can handle the lines as C strings.
+void vtkOBJReaderParseChunk(vtkOBJReaderChunk &chunk,
+                            const vtkOBJReaderOutput *output)
+{
+  const bool fill = (output != NULL);
+  if (!fill)
     {
-    lineNr++;
-    char *pLine = rawLine;
-    char *pEnd = rawLine + strlen(rawLine);
+    for (char *c = chunk.Begin; c < chunk.End &&
+         (c = static_cast<char *>(memchr(c, '\n', chunk.End - c))) != NULL;)
+      {
+      *c++ = '\0';
+      }
+    }
 
-    // find the first non-whitespace character
-    while (isspace(*pLine) && pLine < pEnd) { pLine++; }
+  vtkOBJReaderCounts n;
+  memset(&n, 0, sizeof(n));
+  const vtkOBJReaderCounts &start = chunk.Start;
+  char *next = chunk.Begin;
+  while (next < chunk.End && chunk.Error == OBJ_NO_ERROR)
+    {
+    char *pLine = next;
+    next += strlen(next) + 1;
+    n.TextLines++;
 
-    // this first non-whitespace is the command
+    // the first word of the line is the command
+    while (vtkOBJReaderIsSpace(*pLine)) { pLine++; }
     const char *cmd = pLine;
+    while (*pLine && !vtkOBJReaderIsSpace(*pLine)) { pLine++; }
+    const size_t cmdLength = pLine - cmd;
 
-    // skip over non-whitespace
-    while (!isspace(*pLine) && pLine < pEnd) { pLine++; }
-
-    // terminate command
-    if (pLine < pEnd)
-      {
-      *pLine = '\0';
-      pLine++;
-      }
-
-    // in the OBJ format the first characters determine how to interpret the line:
-    if (strcmp(cmd, "v") == 0)
+    if (cmdLength == 1 && cmd[0] == 'v')
       {
-      // this is a vertex definition, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
+      if (fill && !vtkOBJReaderParseFloats(
+            pLine, output->Points + 3 * (start.Points + n.Points), 3))
         {
-        points->InsertNextPoint(xyz);
-        numPoints++;
-        }
-      else
-        {
-        vtkErrorMacro(<<"Error reading 'v' at line " << lineNr);
-        everything_ok = false;
+        vtkOBJReaderSetError(chunk, OBJ_BAD_RECORD, "v", n.TextLines);
         }
+      n.Points++;
       }
-    else if (strcmp(cmd, "vt") == 0)
+    else if (cmdLength == 2 && cmd[0] == 'v' && cmd[1] == 't')
       {
-      // this is a tcoord, expect two floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f", xyz, xyz+1) == 2)
+      if (fill && !vtkOBJReaderParseFloats(
+            pLine, output->TCoords + 2 * (start.TCoords + n.TCoords), 2))
         {
-        tcoords->InsertNextTuple(xyz);
-        }
-      else
-        {
-        vtkErrorMacro(<<"Error reading 'vt' at line " << lineNr);
-        everything_ok = false;
+        vtkOBJReaderSetError(chunk, OBJ_BAD_RECORD, "vt", n.TextLines);
         }
+      n.TCoords++;
       }
-    else if (strcmp(cmd, "vn") == 0)
+    else if (cmdLength == 2 && cmd[0] == 'v' && cmd[1] == 'n')
       {
-      // this is a normal, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
+      if (fill && !vtkOBJReaderParseFloats(
+            pLine, output->Normals + 3 * (start.Normals + n.Normals), 3))
         {
-        normals->InsertNextTuple(xyz);
-        hasNormals = true;
-        }
-      else
-        {
-        vtkErrorMacro(<<"Error reading 'vn' at line " << lineNr);
-        everything_ok = false;
+        vtkOBJReaderSetError(chunk, OBJ_BAD_RECORD, "vn", n.TextLines);
         }
+      n.Normals++;
       }
-    else if (strcmp(cmd, "p") == 0)
+    else if (cmdLength == 1 &&
+             (cmd[0] == 'p' || cmd[0] == 'l' || cmd[0] == 'f'))
       {
-      // this is a point definition, consisting of 1-based indices separated by whitespace and /
-      pointElems->InsertNextCell(0); // we don't yet know how many points are to come
-
-      int nVerts=0; // keep a count of how many there are
-
-      while (everything_ok && pLine < pEnd)
+      // a point, line or face definition, consisting of 1-based or
+      // negative (relative) indices separated by whitespace and /
+      const char type = cmd[0];
+      const char *command = (type == 'p' ? "p" : (type == 'l' ? "l" : "f"));
+      vtkIdType *cell = NULL;
+      vtkIdType *tcoordIds = NULL;
+      vtkIdType *normalIds = NULL;
+      if (fill)
         {
-        // find next non-whitespace character
-        while (isspace(*pLine) && pLine < pEnd) { pLine++; }
-
-        if (pLine < pEnd)         // there is still data left on this line
+        if (type == 'p')
           {
-          int iVert;
-          if (sscanf(pLine, "%d", &iVert) == 1)
-            {
-            if (iVert < 0)
-              {
-              pointElems->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              pointElems->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            }
-          else if (strcmp(pLine, "\\\n") == 0)
+          cell = output->Verts +
+            start.Verts + n.Verts + start.VertIds + n.VertIds;
+          }
+        else if (type == 'l')
+          {
+          cell = output->Lines +
+            start.Lines + n.Lines + start.LineIds + n.LineIds;
+          }
+        else
+          {
+          cell = output->Polys +
+            start.Polys + n.Polys + start.PolyIds + n.PolyIds;
+          if (output->PolyTCoordIds)
             {
-            // handle backslash-newline continuation
-            if (fgets(rawLine, MAX_LINE, in) != NULL)
-              {
-              lineNr++;
-              pLine = rawLine;
-              pEnd = rawLine + strlen(rawLine);
-              continue;
-              }
-            else
-              {
-              vtkErrorMacro(<<"Error reading continuation line at line " << lineNr);
-              everything_ok = false;
-              }
+            tcoordIds = output->PolyTCoordIds + start.PolyIds + n.PolyIds;
             }
-          else
+          if (output->PolyNormalIds)
             {
-            vtkErrorMacro(<<"Error reading 'p' at line " << lineNr);
-            everything_ok = false;
+            normalIds = output->PolyNormalIds + start.PolyIds + n.PolyIds;
             }
-          // skip over what we just sscanf'd
-          // (find the first whitespace character)
-          while (!isspace(*pLine) && pLine < pEnd) { pLine++; }
           }
         }
 
-      if (nVerts < 1)
+      vtkIdType nVerts = 0, nTCoords = 0, nNormals = 0;
+      bool ok = true;
+      while (ok)
         {
-        vtkErrorMacro
-        (
-            <<"Error reading file near line " << lineNr
-            << " while processing the 'p' command"
-        );
-        everything_ok = false;
-        }
-
-      // now we know how many points there were in this cell
-      pointElems->UpdateCellCount(nVerts);
-      }
-    else if (strcmp(cmd, "l") == 0)
-      {
-      // this is a line definition, consisting of 1-based indices separated by whitespace and /
-      lineElems->InsertNextCell(0); // we don't yet know how many points are to come
-
-      int nVerts=0; // keep a count of how many there are
-
-      while (everything_ok && pLine < pEnd)
-        {
-        // find next non-whitespace character
-        while (isspace(*pLine) && pLine < pEnd) { pLine++; }
+        while (vtkOBJReaderIsSpace(*pLine)) { pLine++; }
+        if (!*pLine)
+          {
+          break;
+          }
+        const char *token = pLine;
+        while (*pLine && !vtkOBJReaderIsSpace(*pLine)) { pLine++; }
 
-        if (pLine < pEnd)         // there is still data left on this line
+        if (pLine - token == 1 && *token == '\\')
           {
-          int iVert, dummyInt;
-          if (sscanf(pLine, "%d/%d", &iVert, &dummyInt) == 2)
-            {
-            // we simply ignore texture information
-            if (iVert < 0)
-              {
-              lineElems->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              lineElems->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            }
-          else if (sscanf(pLine, "%d", &iVert) == 1)
-            {
-            if (iVert < 0)
-              {
-              lineElems->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              lineElems->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            }
-          else if (strcmp(pLine, "\\\n") == 0)
+          const char *rest = pLine;
+          while (vtkOBJReaderIsSpace(*rest)) { rest++; }
+          if (!*rest)
             {
             // handle backslash-newline continuation
-            if (fgets(rawLine, MAX_LINE, in) != NULL)
-              {
-              lineNr++;
-              pLine = rawLine;
-              pEnd = rawLine + strlen(rawLine);
-              continue;
-              }
-            else
+            if (next >= chunk.End)
               {
-              vtkErrorMacro(<<"Error reading continuation line at line " << lineNr);
-              everything_ok = false;
+              if (fill)
+                {
+                vtkOBJReaderSetError(chunk, OBJ_BAD_CONTINUATION, command,
+                                     n.TextLines);
+                }
+              ok = false;
+              break;
               }
+            pLine = next;
+            next += strlen(next) + 1;
+            n.TextLines++;
+            continue;
             }
-          else
+          }
+
+        vtkIdType indices[3];
+        if (!vtkOBJReaderParseIndices(token, indices))
+          {
+          if (fill)
             {
-            vtkErrorMacro(<<"Error reading 'l' at line " << lineNr);
-            everything_ok = false;
+            vtkOBJReaderSetError(chunk, OBJ_BAD_RECORD, command, n.TextLines);
             }
-          // skip over what we just sscanf'd
-          // (find the first whitespace character)
-          while (!isspace(*pLine) && pLine < pEnd) { pLine++; }
+          ok = false;
+          break;
           }
-        }
-
-      if (nVerts < 2)
-        {
-        vtkErrorMacro
-        (
-            <<"Error reading file near line " << lineNr
-            << " while processing the 'l' command"
-        );
-        everything_ok = false;
-        }
-
-      // now we know how many points there were in this cell
-      lineElems->UpdateCellCount(nVerts);
-      }
-    else if (strcmp(cmd, "f") == 0)
-      {
-      // this is a face definition, consisting of 1-based indices separated by whitespace and /
-
-      polys->InsertNextCell(0); // we don't yet know how many points are to come
-      tcoord_polys->InsertNextCell(0);
-      normal_polys->InsertNextCell(0);
-
-      int nVerts=0, nTCoords=0, nNormals=0; // keep a count of how many of each there are
 
-      while (everything_ok && pLine < pEnd)
-        {
-        // find the first non-whitespace character
-        while (isspace(*pLine) && pLine < pEnd) { pLine++; }
-
-        if (pLine < pEnd)         // there is still data left on this line
+        // texture coordinates and normals are ignored except for faces
+        if (type == 'f')
           {
-          int iVert,iTCoord,iNormal;
-          if (sscanf(pLine, "%d/%d/%d", &iVert, &iTCoord, &iNormal) == 3)
+          if (indices[1] != 0)
             {
-            if (iVert < 0)
-              {
-              polys->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              polys->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            tcoord_polys->InsertCellPoint(iTCoord-1);
             nTCoords++;
-            normal_polys->InsertCellPoint(iNormal-1);
-            nNormals++;
-            if (iTCoord != iVert)
-              tcoords_same_as_verts = false;
-            if (iNormal != iVert)
-              normals_same_as_verts = false;
+            chunk.HasFaceTCoords = true;
             }
-          else if (sscanf(pLine, "%d//%d", &iVert, &iNormal) == 2)
+          if (indices[2] != 0)
             {
-            if (iVert < 0)
-              {
-              polys->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              polys->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            normal_polys->InsertCellPoint(iNormal-1);
             nNormals++;
-            if (iNormal != iVert)
-              normals_same_as_verts = false;
+            chunk.HasFaceNormals = true;
             }
-          else if (sscanf(pLine, "%d/%d", &iVert, &iTCoord) == 2)
-            {
-            if (iVert < 0)
-              {
-              polys->InsertCellPoint(numPoints+iVert);
-              }
-            else
-              {
-              polys->InsertCellPoint(iVert-1);
-              }
-            nVerts++;
-            tcoord_polys->InsertCellPoint(iTCoord-1);
-            nTCoords++;
-            if (iTCoord != iVert)
-              tcoords_same_as_verts = false;
-            }
-          else if (sscanf(pLine, "%d", &iVert) == 1)
+          }
+        if (fill)
+          {
+          const vtkIdType iVert = indices[0] < 0 ?
+            start.Points + n.Points + indices[0] : indices[0] - 1;
+          cell[1 + nVerts] = iVert;
+          if (type == 'f')
             {
-            if (iVert < 0)
+            vtkIdType iTCoord = -1, iNormal = -1;
+            if (indices[1] != 0)
               {
-              polys->InsertCellPoint(numPoints+iVert);
+              iTCoord = indices[1] < 0 ?
+                start.TCoords + n.TCoords + indices[1] : indices[1] - 1;
+              if (iTCoord != iVert)
+                {
+                chunk.TCoordsSameAsVerts = false;
+                }
               }
-            else
+            if (indices[2] != 0)
               {
-              polys->InsertCellPoint(iVert-1);
+              iNormal = indices[2] < 0 ?
+                start.Normals + n.Normals + indices[2] : indices[2] - 1;
+              if (iNormal != iVert)
+                {
+                chunk.NormalsSameAsVerts = false;
+                }
               }
-            nVerts++;
-            }
-          else if (strcmp(pLine, "\\\n") == 0)
-            {
-            // handle backslash-newline continuation
-            if (fgets(rawLine, MAX_LINE, in) != NULL)
+            if (tcoordIds)
               {
-              lineNr++;
-              pLine = rawLine;
-              pEnd = rawLine + strlen(rawLine);
-              continue;
+              tcoordIds[nVerts] = iTCoord;
               }
-            else
+            if (normalIds)
               {
-              vtkErrorMacro(<<"Error reading continuation line at line " << lineNr);
-              everything_ok = false;
+              normalIds[nVerts] = iNormal;
               }
             }
-          else
-            {
-            vtkErrorMacro(<<"Error reading 'f' at line " << lineNr);
-            everything_ok = false;
-            }
-          // skip over what we just read
-          // (find the first whitespace character)
-          while (!isspace(*pLine) && pLine < pEnd) { pLine++; }
           }
+        nVerts++;
         }
 
-      // count of tcoords and normals must be equal to number of vertices or zero
-      if ( nVerts < 3 ||
+      // count of tcoords and normals must be equal to number of vertices
+      // or zero. A record with an error still keeps the place of what was
+      // read of it, so that both passes agree.
+      const vtkIdType minVerts = (type == 'p' ? 1 : (type == 'l' ? 2 : 3));
+      if (fill && ok &&
+          (nVerts < minVerts ||
            (nTCoords > 0 && nTCoords != nVerts) ||
-           (nNormals > 0 && nNormals != nVerts)
-         )
+           (nNormals > 0 && nNormals != nVerts)))
         {
-        vtkErrorMacro
-        (
-            <<"Error reading file near line " << lineNr
-            << " while processing the 'f' command"
-        );
-        everything_ok = false;
+        vtkOBJReaderSetError(chunk, OBJ_BAD_ELEMENT, command, n.TextLines);
         }
+      if (fill)
+        {
+        cell[0] = nVerts;
+        }
+      if (type == 'p')
+        {
+        n.Verts++;
+        n.VertIds += nVerts;
+        }
+      else if (type == 'l')
+        {
+        n.Lines++;
+        n.LineIds += nVerts;
+        }
+      else
+        {
+        n.Polys++;
+        n.PolyIds += nVerts;
+        }
+      }
+    }
 
-      // now we know how many points there were in this cell
-      polys->UpdateCellCount(nVerts);
-      tcoord_polys->UpdateCellCount(nTCoords);
-      normal_polys->UpdateCellCount(nNormals);
+  if (!fill)
+    {
+    chunk.Count = n;
+    }
+}
 
-      // also make a note of whether any cells have tcoords, and whether any have normals
-      if (nTCoords > 0) { hasTCoords = true; }
-      if (nNormals > 0) { hasNormals = true; }
+class vtkOBJReaderParseChunks
+{
+public:
+  vtkOBJReaderParseChunks(vtkOBJReaderChunk *chunks,
+                          const vtkOBJReaderOutput *output)
+    : Chunks(chunks), Output(output)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkOBJReaderParseChunk(this->Chunks[i], this->Output);
       }
-    else
+  }
+
+private:
+  vtkOBJReaderChunk *Chunks;
+  const vtkOBJReaderOutput *Output;
+};
+
+// Gathers a tuple of an attribute for each output point. The points read
+// from the file take the tuple given by pointIds (zeros where that is -1),
+// or their own when pointIds is NULL; the copies of points made for faces
+// that disagree about the attributes take the tuple given by copyIds.
+class vtkOBJReaderGatherTuples
+{
+public:
+  vtkOBJReaderGatherTuples(const float *source, int numberOfComponents,
+                           vtkIdType numberOfPoints, const vtkIdType *pointIds,
+                           const vtkIdType *copyIds, float *output)
+    : Source(source), NumberOfComponents(numberOfComponents),
+      NumberOfPoints(numberOfPoints), PointIds(pointIds), CopyIds(copyIds),
+      Output(output)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int nc = this->NumberOfComponents;
+    for (vtkIdType i = begin; i < end; ++i)
       {
-      //vtkDebugMacro(<<"Ignoring line: "<<rawLine);
+      vtkIdType id;
+      if (i < this->NumberOfPoints)
+        {
+        id = this->PointIds ? this->PointIds[i] : i;
+        }
+      else
+        {
+        id = this->CopyIds[i - this->NumberOfPoints];
+        }
+      float *tuple = this->Output + i * nc;
+      for (int c = 0; c < nc; ++c)
+        {
+        tuple[c] = (id < 0 ? 0.0f : this->Source[id * nc + c]);
+        }
       }
+  }
+
+private:
+  const float *Source;
+  int NumberOfComponents;
+  vtkIdType NumberOfPoints;
+  const vtkIdType *PointIds;
+  const vtkIdType *CopyIds;
+  float *Output;
+};
+
+template <class T>
+T *vtkOBJReaderData(std::vector<T> &v)
+{
+  return v.empty() ? NULL : &v[0];
+}
 
-    } // (end of while loop)
+}
 
-  } // (end of local scope section)
+int vtkOBJReader::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **vtkNotUsed(inputVector),
+  vtkInformationVector *outputVector)
+{
+  // get the info object
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
 
-  // we have finished with the file
-  fclose(in);
+  // get the ouptut
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  if (!this->FileName)
+    {
+    vtkErrorMacro(<< "A FileName must be specified.");
+    return 0;
+    }
 
+  FILE *in = fopen(this->FileName,"rb");
 
-  if (everything_ok)   // (otherwise just release allocated memory and return)
+  if (in == NULL)
     {
-    // -- now turn this lot into a useable vtkPolyData --
+    vtkErrorMacro(<< "File " << this->FileName << " not found");
+    return 0;
+    }
 
-    // if there are no tcoords or normals or they match exactly
-    // then we can just copy the data into the output (easy!)
-    if (
-        (!hasTCoords || tcoords_same_as_verts) &&
-        (!hasNormals || normals_same_as_verts)
-       )
+  vtkDebugMacro(<<"Reading file");
+
+  // intialise some structures to store the file contents in
+  vtkSmartPointer<vtkFloatArray> points =
+    vtkSmartPointer<vtkFloatArray>::New();
+  points->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkFloatArray> tcoords =
+    vtkSmartPointer<vtkFloatArray>::New();
+  tcoords->SetNumberOfComponents(2);
+  vtkSmartPointer<vtkFloatArray> normals =
+    vtkSmartPointer<vtkFloatArray>::New();
+  normals->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkIdTypeArray> pointElems =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> lineElems =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> polys =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  std::vector<vtkIdType> tcoord_polys;
+  std::vector<vtkIdType> normal_polys;
+
+  vtkOBJReaderCounts total;
+  memset(&total, 0, sizeof(total));
+  bool hasTCoords = false;
+  bool hasNormals = false;
+  bool tcoords_same_as_verts = true;
+  bool normals_same_as_verts = true;
+  bool everything_ok = true;
+
+  // -- work through the file a block at a time: count the records of each
+  // chunk of the block concurrently, place them with a prefix sum over the
+  // chunks, then parse the chunks concurrently straight into the arrays --
+
+  std::vector<char> buffer(vtkOBJReaderBlockSize + 1);
+  size_t filled = 0;
+  bool atEnd = false;
+  while (everything_ok && (!atEnd || filled > 0))
+    {
+    if (!atEnd)
       {
-      vtkDebugMacro(<<"Copying file data into the output directly");
+      const size_t capacity = buffer.size() - 1;
+      filled += fread(&buffer[filled], 1, capacity - filled, in);
+      atEnd = (filled < capacity);
+      }
 
-      output->SetPoints(points);
-      if (pointElems->GetNumberOfCells())
-        {
-        output->SetVerts(pointElems);
-        }
-      if (lineElems->GetNumberOfCells())
+    // only whole records are parsed, the rest waits for the next block
+    size_t length = filled;
+    if (atEnd)
+      {
+      buffer[length] = '\0';
+      }
+    else
+      {
+      length = vtkOBJReaderWholeRecordsLength(&buffer[0], filled);
+      if (length == 0)
         {
-        output->SetLines(lineElems);
+        // a record that does not fit in the buffer
+        buffer.resize(2 * buffer.size() - 1);
+        continue;
         }
-      if (polys->GetNumberOfCells())
+      }
+
+    std::vector<vtkOBJReaderChunk> chunks;
+    char *first = &buffer[0];
+    char *stop = first + length;
+    for (char *begin = first; begin < stop;)
+      {
+      vtkOBJReaderChunk chunk;
+      memset(&chunk, 0, sizeof(chunk));
+      chunk.TCoordsSameAsVerts = true;
+      chunk.NormalsSameAsVerts = true;
+      chunk.Error = OBJ_NO_ERROR;
+      chunk.Begin = begin;
+      chunk.End = stop;
+      if (static_cast<size_t>(stop - begin) > 2 * vtkOBJReaderChunkSize)
         {
-        output->SetPolys(polys);
+        chunk.End = vtkOBJReaderFindRecordEnd(
+          first, begin + vtkOBJReaderChunkSize, stop);
         }
+      chunks.push_back(chunk);
+      begin = chunk.End;
+      }
+    const vtkIdType numChunks = static_cast<vtkIdType>(chunks.size());
+
+    vtkSMPTools::For(0, numChunks, 1,
+      vtkOBJReaderParseChunks(&chunks[0], NULL));
+
+    const vtkOBJReaderCounts blockStart = total;
+    bool blockHasTCoords = false;
+    bool blockHasNormals = false;
+    for (vtkIdType i = 0; i < numChunks; ++i)
+      {
+      chunks[i].Start = total;
+      vtkOBJReaderAddCounts(total, chunks[i].Count);
+      blockHasTCoords |= chunks[i].HasFaceTCoords;
+      blockHasNormals |= chunks[i].HasFaceNormals;
+      }
 
-      // if there is an exact correspondence between tcoords and vertices then can simply
-      // assign the tcoords points as point data
-      if (hasTCoords && tcoords_same_as_verts)
-        output->GetPointData()->SetTCoords(tcoords);
+    points->WritePointer(3 * blockStart.Points,
+                         3 * (total.Points - blockStart.Points));
+    tcoords->WritePointer(2 * blockStart.TCoords,
+                          2 * (total.TCoords - blockStart.TCoords));
+    normals->WritePointer(3 * blockStart.Normals,
+                          3 * (total.Normals - blockStart.Normals));
+    pointElems->WritePointer(blockStart.Verts + blockStart.VertIds,
+                             total.Verts + total.VertIds -
+                             blockStart.Verts - blockStart.VertIds);
+    lineElems->WritePointer(blockStart.Lines + blockStart.LineIds,
+                            total.Lines + total.LineIds -
+                            blockStart.Lines - blockStart.LineIds);
+    polys->WritePointer(blockStart.Polys + blockStart.PolyIds,
+                        total.Polys + total.PolyIds -
+                        blockStart.Polys - blockStart.PolyIds);
+    // the ids of the face vertices of earlier blocks, which had none,
+    // become -1
+    if (blockHasTCoords || !tcoord_polys.empty())
+      {
+      tcoord_polys.resize(total.PolyIds, -1);
+      }
+    if (blockHasNormals || !normal_polys.empty())
+      {
+      normal_polys.resize(total.PolyIds, -1);
+      }
 
-      // if there is an exact correspondence between normals and vertices then can simply
-      // assign the normals as point data
-      if (hasNormals && normals_same_as_verts)
+    vtkOBJReaderOutput arrays;
+    arrays.Points = points->GetPointer(0);
+    arrays.TCoords = tcoords->GetPointer(0);
+    arrays.Normals = normals->GetPointer(0);
+    arrays.Verts = pointElems->GetPointer(0);
+    arrays.Lines = lineElems->GetPointer(0);
+    arrays.Polys = polys->GetPointer(0);
+    arrays.PolyTCoordIds = vtkOBJReaderData(tcoord_polys);
+    arrays.PolyNormalIds = vtkOBJReaderData(normal_polys);
+    vtkSMPTools::For(0, numChunks, 1,
+      vtkOBJReaderParseChunks(&chunks[0], &arrays));
+
+    // report the first error in the file
+    for (vtkIdType i = 0; i < numChunks && everything_ok; ++i)
+      {
+      const vtkOBJReaderChunk &chunk = chunks[i];
+      const vtkIdType lineNr = chunk.Start.TextLines + chunk.ErrorLine;
+      if (chunk.Error == OBJ_BAD_RECORD)
+        {
+        vtkErrorMacro(<<"Error reading '" << chunk.ErrorCommand
+                      << "' at line " << lineNr);
+        everything_ok = false;
+        }
+      else if (chunk.Error == OBJ_BAD_CONTINUATION)
         {
-        output->GetPointData()->SetNormals(normals);
+        vtkErrorMacro(<<"Error reading continuation line at line "
+                      << lineNr);
+        everything_ok = false;
         }
-      output->Squeeze();
+      else if (chunk.Error == OBJ_BAD_ELEMENT)
+        {
+        vtkErrorMacro
+        (
+            <<"Error reading file near line " << lineNr
+            << " while processing the '" << chunk.ErrorCommand
+            << "' command"
+        );
+        everything_ok = false;
+        }
+      hasTCoords |= chunk.HasFaceTCoords;
+      hasNormals |= chunk.HasFaceNormals;
+      tcoords_same_as_verts &= chunk.TCoordsSameAsVerts;
+      normals_same_as_verts &= chunk.NormalsSameAsVerts;
       }
-    // otherwise we can duplicate the vertices as necessary (a bit slower)
-    else
+
+    memmove(&buffer[0], &buffer[length], filled - length);
+    filled -= length;
+    }
+  std::vector<char>().swap(buffer);
+
+  // we have finished with the file
+  fclose(in);
+
+  vtkIdType numPolys = total.Polys;
+  if (everything_ok &&
+      (!hasTCoords || tcoords_same_as_verts) &&
+      (!hasNormals || normals_same_as_verts))
+    {
+    // if there are no tcoords or normals or they match exactly
+    // then we can just copy the data into the output (easy!)
+    vtkDebugMacro(<<"Copying file data into the output directly");
+
+    // if there is an exact correspondence between tcoords and vertices then can simply
+    // assign the tcoords points as point data
+    if (hasTCoords)
+      {
+      output->GetPointData()->SetTCoords(tcoords);
+      }
+
+    // if there is an exact correspondence between normals and vertices then can simply
+    // assign the normals as point data
+    if (hasNormals || total.Normals > 0)
       {
-      vtkDebugMacro(<<"Duplicating vertices so that tcoords and normals are correct");
-
-      vtkPoints *new_points = vtkPoints::New();
-      vtkFloatArray *new_tcoords = vtkFloatArray::New();
-      new_tcoords->SetNumberOfComponents(2);
-      vtkFloatArray *new_normals = vtkFloatArray::New();
-      new_normals->SetNumberOfComponents(3);
-      vtkCellArray *new_polys = vtkCellArray::New();
-
-      // for each poly, copy its vertices into new_points (and point at them)
-      // also copy its tcoords into new_tcoords
-      // also copy its normals into new_normals
-      polys->InitTraversal();
-      tcoord_polys->InitTraversal();
-      normal_polys->InitTraversal();
-
-      vtkIdType dummy_warning_prevention_mechanism[1];
-      vtkIdType n_pts=-1,*pts=dummy_warning_prevention_mechanism;
-      vtkIdType n_tcoord_pts=-1,*tcoord_pts=dummy_warning_prevention_mechanism;
-      vtkIdType n_normal_pts=-1,*normal_pts=dummy_warning_prevention_mechanism;
-      for (int i=0; i<polys->GetNumberOfCells(); ++i)
+      output->GetPointData()->SetNormals(normals);
+      }
+    }
+  // otherwise we can duplicate the vertices as necessary (a bit slower)
+  else if (everything_ok)
+    {
+    vtkDebugMacro(<<"Duplicating vertices so that tcoords and normals are correct");
+
+    // Each vertex takes the tcoord and normal of the first face vertex that
+    // refers to it. A face vertex that refers to it with another tcoord or
+    // normal is given a copy of the vertex, made once for each combination,
+    // so vertices are only duplicated along the seams of the attributes.
+    const vtkIdType numPoints = total.Points;
+    std::vector<vtkIdType> pointTCoords(hasTCoords ? numPoints : 0, -1);
+    std::vector<vtkIdType> pointNormals(hasNormals ? numPoints : 0, -1);
+    std::vector<vtkIdType> firstCopy(numPoints, -1);
+    std::vector<vtkIdType> copyPoints, copyTCoords, copyNormals, nextCopy;
+
+    vtkIdType *cells = polys->GetPointer(0);
+    vtkIdType readLoc = 0, writeLoc = 0, faceVert = 0;
+    numPolys = 0;
+    for (vtkIdType i = 0; i < total.Polys && everything_ok; ++i)
+      {
+      const vtkIdType n_pts = cells[readLoc];
+
+      // If some faces have tcoords and not others (likewise normals)
+      // then we must do something else VTK will complain. (crash on render attempt)
+      // Easiest solution is to delete polys that don't have complete tcoords (if there
+      // are any tcoords in the dataset) or normals (if there are any normals in the dataset).
+      if ((hasTCoords && tcoord_polys[faceVert] < 0) ||
+          (hasNormals && normal_polys[faceVert] < 0))
         {
-        polys->GetNextCell(n_pts,pts);
-        tcoord_polys->GetNextCell(n_tcoord_pts,tcoord_pts);
-        normal_polys->GetNextCell(n_normal_pts,normal_pts);
-
-        // If some vertices have tcoords and not others (likewise normals)
-        // then we must do something else VTK will complain. (crash on render attempt)
-        // Easiest solution is to delete polys that don't have complete tcoords (if there
-        // are any tcoords in the dataset) or normals (if there are any normals in the dataset).
-
-        if (
-            (n_pts != n_tcoord_pts && hasTCoords) ||
-            (n_pts != n_normal_pts && hasNormals)
-           )
-          {
-          // skip this poly
-          vtkDebugMacro(<<"Skipping poly "<<i+1<<" (1-based index)");
-          }
-        else
+        // skip this poly
+        vtkDebugMacro(<<"Skipping poly "<<i+1<<" (1-based index)");
+        }
+      else
+        {
+        // the polys are compacted in place, writeLoc never passes readLoc
+        cells[writeLoc] = n_pts;
+        for (vtkIdType j = 0; j < n_pts; ++j)
           {
-          // copy the corresponding points, tcoords and normals across
-          for (int j=0; j<n_pts; ++j)
+          vtkIdType pt = cells[readLoc + 1 + j];
+          const vtkIdType tc = hasTCoords ? tcoord_polys[faceVert + j] : 0;
+          const vtkIdType nm = hasNormals ? normal_polys[faceVert + j] : 0;
+          if (pt < 0 || pt >= numPoints ||
+              (hasTCoords && (tc < 0 || tc >= total.TCoords)) ||
+              (hasNormals && (nm < 0 || nm >= total.Normals)))
+            {
+            vtkErrorMacro(<<"Face " << i + 1 << " refers to a vertex, "
+                          "tcoord or normal that is not defined");
+            everything_ok = false;
+            break;
+            }
+
+          if (hasTCoords ? pointTCoords[pt] < 0 : pointNormals[pt] < 0)
+            {
+            if (hasTCoords)
+              {
+              pointTCoords[pt] = tc;
+              }
+            if (hasNormals)
+              {
+              pointNormals[pt] = nm;
+              }
+            }
+          else if ((hasTCoords && pointTCoords[pt] != tc) ||
+                   (hasNormals && pointNormals[pt] != nm))
             {
-            // copy the tcoord for this point across (if there is one)
-            if (n_tcoord_pts>0)
+            vtkIdType copy = firstCopy[pt];
+            while (copy >= 0 &&
+                   ((hasTCoords && copyTCoords[copy] != tc) ||
+                    (hasNormals && copyNormals[copy] != nm)))
               {
-              new_tcoords->InsertNextTuple(tcoords->GetTuple(tcoord_pts[j]));
+              copy = nextCopy[copy];
               }
-            // copy the normal for this point across (if there is one)
-            if (n_normal_pts>0)
+            if (copy < 0)
               {
-              new_normals->InsertNextTuple(normals->GetTuple(normal_pts[j]));
+              copy = static_cast<vtkIdType>(copyPoints.size());
+              copyPoints.push_back(pt);
+              copyTCoords.push_back(tc);
+              copyNormals.push_back(nm);
+              nextCopy.push_back(firstCopy[pt]);
+              firstCopy[pt] = copy;
               }
-            // copy the vertex into the new structure and update
-            // the vertex index in the polys structure (pts is a pointer into it)
-            pts[j] = new_points->InsertNextPoint(points->GetPoint(pts[j]));
+            pt = numPoints + copy;
             }
-          // copy this poly (pointing at the new points) into the new polys list
-          new_polys->InsertNextCell(n_pts,pts);
+          cells[writeLoc + 1 + j] = pt;
           }
+        writeLoc += n_pts + 1;
+        numPolys++;
         }
+      readLoc += n_pts + 1;
+      faceVert += n_pts;
+      }
+
+    if (everything_ok)
+      {
+      polys->Resize(writeLoc);
+      std::vector<vtkIdType>().swap(tcoord_polys);
+      std::vector<vtkIdType>().swap(normal_polys);
+      std::vector<vtkIdType>().swap(firstCopy);
+      std::vector<vtkIdType>().swap(nextCopy);
+
+      // append the copies of the vertices
+      const vtkIdType numCopies = static_cast<vtkIdType>(copyPoints.size());
+      points->WritePointer(3 * numPoints, 3 * numCopies);
+      vtkSMPTools::For(numPoints, numPoints + numCopies,
+        vtkOBJReaderGatherTuples(points->GetPointer(0), 3, numPoints, NULL,
+                                 vtkOBJReaderData(copyPoints),
+                                 points->GetPointer(0)));
 
-      // use the new structures for the output
-      output->SetPoints(new_points);
-      output->SetPolys(new_polys);
       if (hasTCoords)
         {
+        vtkSmartPointer<vtkFloatArray> new_tcoords =
+          vtkSmartPointer<vtkFloatArray>::New();
+        new_tcoords->SetNumberOfComponents(2);
+        new_tcoords->SetNumberOfTuples(numPoints + numCopies);
+        vtkSMPTools::For(0, numPoints + numCopies,
+          vtkOBJReaderGatherTuples(tcoords->GetPointer(0), 2, numPoints,
+                                   vtkOBJReaderData(pointTCoords),
+                                   vtkOBJReaderData(copyTCoords),
+                                   new_tcoords->GetPointer(0)));
         output->GetPointData()->SetTCoords(new_tcoords);
         }
       if (hasNormals)
         {
+        vtkSmartPointer<vtkFloatArray> new_normals =
+          vtkSmartPointer<vtkFloatArray>::New();
+        new_normals->SetNumberOfComponents(3);
+        new_normals->SetNumberOfTuples(numPoints + numCopies);
+        vtkSMPTools::For(0, numPoints + numCopies,
+          vtkOBJReaderGatherTuples(normals->GetPointer(0), 3, numPoints,
+                                   vtkOBJReaderData(pointNormals),
+                                   vtkOBJReaderData(copyNormals),
+                                   new_normals->GetPointer(0)));
         output->GetPointData()->SetNormals(new_normals);
         }
-
-      // TODO: fixup for pointElems and lineElems too
-
-      output->Squeeze();
-
-      new_points->Delete();
-      new_polys->Delete();
-      new_tcoords->Delete();
-      new_normals->Delete();
       }
     }
 
-  points->Delete();
-  tcoords->Delete();
-  normals->Delete();
-  polys->Delete();
-  tcoord_polys->Delete();
-  normal_polys->Delete();
-
-  lineElems->Delete();
-  pointElems->Delete();
+  if (everything_ok)   // (otherwise just release allocated memory and return)
+    {
+    // -- now turn this lot into a useable vtkPolyData --
+    vtkSmartPointer<vtkPoints> outPoints = vtkSmartPointer<vtkPoints>::New();
+    outPoints->SetData(points);
+    output->SetPoints(outPoints);
+    if (total.Verts > 0)
+      {
+      vtkSmartPointer<vtkCellArray> cells =
+        vtkSmartPointer<vtkCellArray>::New();
+      cells->SetCells(total.Verts, pointElems);
+      output->SetVerts(cells);
+      }
+    if (total.Lines > 0)
+      {
+      vtkSmartPointer<vtkCellArray> cells =
+        vtkSmartPointer<vtkCellArray>::New();
+      cells->SetCells(total.Lines, lineElems);
+      output->SetLines(cells);
+      }
+    if (numPolys > 0)
+      {
+      vtkSmartPointer<vtkCellArray> cells =
+        vtkSmartPointer<vtkCellArray>::New();
+      cells->SetCells(numPolys, polys);
+      output->SetPolys(cells);
+      }
+    output->Squeeze();
+    }
 
   return 1;
 }
@@ -40,6 +40,8 @@
 #define VTK_FOAMFILE_INBUFSIZE (16384)
 #define VTK_FOAMFILE_OUTBUFSIZE (131072)
 #define VTK_FOAMFILE_INCLUDE_STACK_SIZE (10)
+// ASCII lists of at least this many elements are parsed concurrently
+#define VTK_FOAMFILE_PARALLEL_LIST_SIZE (4096)
 
 #if defined(_MSC_VER) && (_MSC_VER >= 1400)
 #define _CRT_SECURE_NO_WARNINGS 1
@@ -54,6 +56,7 @@
 
 #include "vtkOpenFOAMReader.h"
 
+#include <algorithm>
 #include <vector>
 #include "vtksys/SystemTools.hxx"
 #include <vtksys/ios/sstream>
@@ -80,6 +83,7 @@
 #include "vtkPolygon.h"
 #include "vtkPyramid.h"
 #include "vtkQuad.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -1533,6 +1537,7 @@ public:
 
   int ReadIntValue();
   float ReadFloatValue();
+  void ReadListBody(std::vector<char>& body);
 };
 
 int vtkFoamFile::ReadNext()
@@ -1735,6 +1740,77 @@ float vtkFoamFile::ReadFloatValue()
   return static_cast<float>(nonNegative ? num : -num);
 }
 
+// copies the body of a list up to the closing parenthesis at the
+// current nesting level, which is consumed, into body. comments are
+// replaced by a space so that the body only holds values and
+// parentheses. the characters are copied from the buffer in bulk rather
+// than through Getc().
+void vtkFoamFile::ReadListBody(std::vector<char>& body)
+{
+  body.clear();
+  int depth = 0;
+  for (;;)
+    {
+    unsigned char *ptr = this->Superclass::BufPtr;
+    unsigned char * const endPtr = this->Superclass::BufEndPtr;
+    bool closed = false;
+    for (; ptr != endPtr; ++ptr)
+      {
+      const unsigned char c = *ptr;
+      if (c == '\n')
+        {
+        ++this->Superclass::LineNumber;
+        }
+      else if (c == '(')
+        {
+        ++depth;
+        }
+      else if (c == ')')
+        {
+        if (depth == 0)
+          {
+          closed = true;
+          break;
+          }
+        --depth;
+        }
+      else if (c == 47) // '/' == 47
+        {
+        break;
+        }
+      }
+    body.insert(body.end(), this->Superclass::BufPtr, ptr);
+    this->Superclass::BufPtr = ptr;
+
+    if (closed)
+      {
+      ++this->Superclass::BufPtr;
+      return;
+      }
+    int c;
+    if (ptr != endPtr)
+      {
+      // a comment, which NextTokenHead() skips along with the whitespaces
+      // that follow it
+      c = this->NextTokenHead();
+      if (c == '/')
+        {
+        this->ThrowUnexpectedNondigitCharExecption(c);
+        }
+      body.push_back(' ');
+      }
+    else
+      {
+      c = this->ReadNext();
+      }
+    if (c == EOF)
+      {
+      this->ThrowUnexpectedEOFException();
+      }
+    this->PutBack(c);
+    }
+}
+
 // hacks to keep exception throwing code out-of-line to make
 // putBack() and readExpecting() inline expandable
 void vtkFoamFile::ThrowUnexpectedEOFException()
@@ -2006,6 +2082,351 @@ VTK_TEMPLATE_SPECIALIZE inline float vtkFoamReadValue<float>::ReadValue(vtkFoamI
   return io.ReadFloatValue();
 }
 
+//-----------------------------------------------------------------------------
+// converters of a number token of a list body. the arithmetic is that of
+// vtkFoamFile::ReadIntValue() and vtkFoamFile::ReadFloatValue() so that
+// both give the same values. ptr is advanced past the converted chars.
+template <typename T> struct vtkFoamParseValue
+{
+public:
+  static bool Parse(const char *&ptr, const char *endPtr, T& value);
+};
+
+VTK_TEMPLATE_SPECIALIZE inline bool vtkFoamParseValue<int>::Parse(
+    const char *&ptr, const char *endPtr, int& value)
+{
+  const char *p = ptr;
+  bool nonNegative = true;
+  if (p != endPtr && (*p == '-' || *p == '+'))
+    {
+    nonNegative = (*p++ == '+');
+    }
+  if (p == endPtr || !isdigit(*p))
+    {
+    return false;
+    }
+  int num = 0;
+  for (; p != endPtr && isdigit(*p); ++p)
+    {
+    num = 10 * num + *p - 48; // '0' == 48
+    }
+  value = nonNegative ? num : -num;
+  ptr = p;
+  return true;
+}
+
+VTK_TEMPLATE_SPECIALIZE inline bool vtkFoamParseValue<float>::Parse(
+    const char *&ptr, const char *endPtr, float& value)
+{
+  const char *p = ptr;
+  bool nonNegative = true;
+  if (p != endPtr && (*p == '-' || *p == '+'))
+    {
+    nonNegative = (*p++ == '+');
+    }
+  if (p == endPtr || (!isdigit(*p) && *p != '.'))
+    {
+    return false;
+    }
+
+  // read integer part
+  double num = 0.0;
+  for (; p != endPtr && isdigit(*p); ++p)
+    {
+    num = num * 10.0 + (*p - 48); // '0' == 48
+    }
+
+  // read decimal part
+  if (p != endPtr && *p == '.')
+    {
+    double divisor = 1.0;
+    for (++p; p != endPtr && isdigit(*p); ++p)
+      {
+      num = num * 10.0 + (*p - 48);
+      divisor *= 10.0;
+      }
+    num /= divisor;
+    }
+
+  // read exponent part
+  if (p != endPtr && (*p == 'E' || *p == 'e'))
+    {
+    int esign = 1;
+    int eval = 0;
+    double scale = 1.0;
+
+    if (++p != endPtr && (*p == '-' || *p == '+'))
+      {
+      esign = (*p++ == '-' ? -1 : 1);
+      }
+    for (; p != endPtr && isdigit(*p); ++p)
+      {
+      eval = eval * 10 + (*p - 48);
+      }
+
+    while (eval >= 64)
+      {
+      scale *= 1.0e+64;
+      eval -= 64;
+      }
+    while (eval >= 16)
+      {
+      scale *= 1.0e+16;
+      eval -= 16;
+      }
+    while (eval >= 4)
+      {
+      scale *= 1.0e+4;
+      eval -= 4;
+      }
+    while (eval >= 1)
+      {
+      scale *= 1.0e+1;
+      eval -= 1;
+      }
+
+    if (esign < 0)
+      {
+      num /= scale;
+      }
+    else
+      {
+      num *= scale;
+      }
+    }
+
+  value = static_cast<float>(nonNegative ? num : -num);
+  ptr = p;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// class vtkFoamListTokenizer
+// splits the body of an ASCII list (cf. vtkFoamFile::ReadListBody()) into
+// numbers and parentheses concurrently. the body is cut into chunks at
+// token boundaries, the tokens of each chunk are counted, and each chunk
+// then converts its own range of the tokens.
+template <typename T> class vtkFoamListTokenizer
+{
+  const char *Body;
+  std::vector<vtkIdType> ChunkStarts;
+  std::vector<vtkIdType> FirstTokens;
+  std::vector<vtkIdType> Parentheses;
+  std::vector<vtkIdType> Errors;
+  vtkIdType NumberOfParentheses;
+
+  static bool IsSpace(const char c)
+  {
+    return isspace(static_cast<unsigned char>(c)) != 0;
+  }
+
+  struct CountFunctor
+  {
+    vtkFoamListTokenizer *Self;
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      for (vtkIdType chunkI = begin; chunkI < end; chunkI++)
+        {
+        vtkIdType nTokens = 0, nParentheses = 0;
+        bool inNumber = false;
+        const char *endPtr = this->Self->Body
+          + this->Self->ChunkStarts[chunkI + 1];
+        for (const char *ptr = this->Self->Body
+          + this->Self->ChunkStarts[chunkI]; ptr != endPtr; ++ptr)
+          {
+          if (*ptr == '(' || *ptr == ')')
+            {
+            nTokens++;
+            nParentheses++;
+            inNumber = false;
+            }
+          else if (IsSpace(*ptr))
+            {
+            inNumber = false;
+            }
+          else if (!inNumber)
+            {
+            nTokens++;
+            inNumber = true;
+            }
+          }
+        this->Self->FirstTokens[chunkI + 1] = nTokens;
+        this->Self->Parentheses[chunkI] = nParentheses;
+        }
+    }
+  };
+
+  struct FillFunctor
+  {
+    vtkFoamListTokenizer *Self;
+    char *Kinds;
+    T *Values;
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      for (vtkIdType chunkI = begin; chunkI < end; chunkI++)
+        {
+        vtkIdType tokenI = this->Self->FirstTokens[chunkI];
+        const char *endPtr = this->Self->Body
+          + this->Self->ChunkStarts[chunkI + 1];
+        const char *ptr = this->Self->Body + this->Self->ChunkStarts[chunkI];
+        while (ptr != endPtr)
+          {
+          if (*ptr == '(' || *ptr == ')')
+            {
+            if (this->Kinds)
+              {
+              this->Kinds[tokenI] = *ptr;
+              }
+            tokenI++;
+            ++ptr;
+            }
+          else if (IsSpace(*ptr))
+            {
+            ++ptr;
+            }
+          else
+            {
+            const char *tokenEndPtr = ptr;
+            while (tokenEndPtr != endPtr && *tokenEndPtr != '('
+              && *tokenEndPtr != ')' && !IsSpace(*tokenEndPtr))
+              {
+              ++tokenEndPtr;
+              }
+            const char *parsedPtr = ptr;
+            if ((!vtkFoamParseValue<T>::Parse(parsedPtr, tokenEndPtr,
+              this->Values[tokenI]) || parsedPtr != tokenEndPtr)
+              && this->Self->Errors[chunkI] < 0)
+              {
+              this->Self->Errors[chunkI] = ptr - this->Self->Body;
+              }
+            if (this->Kinds)
+              {
+              this->Kinds[tokenI] = 0;
+              }
+            tokenI++;
+            ptr = tokenEndPtr;
+            }
+          }
+        }
+    }
+  };
+  friend struct CountFunctor;
+  friend struct FillFunctor;
+
+public:
+  vtkFoamListTokenizer() : Body(NULL), NumberOfParentheses(0)
+  {
+  }
+
+  // counts the tokens of body and returns their number. body must be
+  // kept until Fill() is called.
+  vtkIdType Count(const std::vector<char>& body)
+  {
+    this->Body = body.empty() ? NULL : &body[0];
+    const vtkIdType nChars = static_cast<vtkIdType>(body.size());
+    const vtkIdType nChunks = nChars / 65536 + 1;
+    this->ChunkStarts.resize(nChunks + 1);
+    this->ChunkStarts[0] = 0;
+    for (vtkIdType chunkI = 1; chunkI < nChunks; chunkI++)
+      {
+      // move the boundary onto a delimiter so that no token is split
+      vtkIdType charI = std::max(chunkI * nChars / nChunks,
+        this->ChunkStarts[chunkI - 1]);
+      while (charI < nChars && body[charI] != '(' && body[charI] != ')'
+        && !IsSpace(body[charI]))
+        {
+        charI++;
+        }
+      this->ChunkStarts[chunkI] = charI;
+      }
+    this->ChunkStarts[nChunks] = nChars;
+    this->FirstTokens.assign(nChunks + 1, 0);
+    this->Parentheses.assign(nChunks, 0);
+    this->Errors.assign(nChunks, -1);
+
+    CountFunctor counter;
+    counter.Self = this;
+    vtkSMPTools::For(0, nChunks, 1, counter);
+
+    this->NumberOfParentheses = 0;
+    for (vtkIdType chunkI = 0; chunkI < nChunks; chunkI++)
+      {
+      this->FirstTokens[chunkI + 1] += this->FirstTokens[chunkI];
+      this->NumberOfParentheses += this->Parentheses[chunkI];
+      }
+    return this->FirstTokens[nChunks];
+  }
+
+  vtkIdType GetNumberOfParentheses() const
+  {
+    return this->NumberOfParentheses;
+  }
+
+  // converts the tokens counted by Count(). kinds, if not NULL, receives
+  // '(' or ')' for a parenthesis and 0 for a number, values receives the
+  // numbers; the values of the parentheses are left untouched.
+  void Fill(char *kinds, T *values)
+  {
+    FillFunctor filler;
+    filler.Self = this;
+    filler.Kinds = kinds;
+    filler.Values = values;
+    const vtkIdType nChunks
+      = static_cast<vtkIdType>(this->ChunkStarts.size()) - 1;
+    vtkSMPTools::For(0, nChunks, 1, filler);
+
+    for (vtkIdType chunkI = 0; chunkI < nChunks; chunkI++)
+      {
+      if (this->Errors[chunkI] >= 0)
+        {
+        const char *ptr = this->Body + this->Errors[chunkI];
+        vtkStdString token;
+        for (; token.length() < 64 && *ptr != '(' && *ptr != ')'
+          && !IsSpace(*ptr) && ptr != this->Body + this->ChunkStarts[nChunks];
+          ++ptr)
+          {
+          token += *ptr;
+          }
+        throw vtkFoamError() << "Expected a number, found " << token;
+        }
+      }
+  }
+};
+
+// converts double precision values to the single precision ones of a
+// binary list concurrently
+struct vtkFoamDoubleToFloatFunctor
+{
+  const double *Input;
+  float *Output;
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      this->Output[i] = static_cast<float>(this->Input[i]);
+      }
+  }
+};
+
+// reads nValues double precision values of a binary list into output
+// with a single read per block
+static void vtkFoamReadBinaryDoubles(vtkFoamIOobject& io, float *output,
+  const vtkIdType nValues)
+{
+  const vtkIdType blockSize = 1048576;
+  std::vector<double> buffer(std::min(nValues, blockSize));
+  vtkFoamDoubleToFloatFunctor converter;
+  converter.Input = buffer.empty() ? NULL : &buffer[0];
+  for (vtkIdType valueI = 0; valueI < nValues; valueI += blockSize)
+    {
+    const vtkIdType n = std::min(nValues - valueI, blockSize);
+    io.Read(reinterpret_cast<unsigned char *>(&buffer[0]),
+      static_cast<int>(n * sizeof(double)));
+    converter.Output = output + valueI;
+    vtkSMPTools::For(0, n, 65536, converter);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // class vtkFoamEntryValue
 // a class that represents a value of a dictionary entry that corresponds to
@@ -2057,6 +2478,21 @@ public:
         this->Ptr->SetValue(i, vtkFoamReadValue<primitiveT>::ReadValue(io));
         }
     }
+    // parses the list body concurrently, including the closing ')'
+    void ReadAsciiListInParallel(vtkFoamIOobject& io, const int size)
+    {
+      std::vector<char> body;
+      io.ReadListBody(body);
+      vtkFoamListTokenizer<primitiveT> tokenizer;
+      const vtkIdType nTokens = tokenizer.Count(body);
+      if (tokenizer.GetNumberOfParentheses() != 0 || nTokens != size)
+        {
+        throw vtkFoamError() << "Expected " << size << " values, found "
+        << nTokens - tokenizer.GetNumberOfParentheses() << " values and "
+        << tokenizer.GetNumberOfParentheses() << " parentheses";
+        }
+      tokenizer.Fill(NULL, this->Ptr->GetPointer(0));
+    }
     void ReadBinaryList(vtkFoamIOobject& io, const int size)
     {
       io.Read(reinterpret_cast<unsigned char *>(this->Ptr->GetPointer(0)), size
@@ -2082,6 +2518,43 @@ public:
   {
     listT *Ptr;
 
+    // checks the tokens of each element of a tokenized ASCII list and
+    // stores its components, block by block
+    struct ScatterFunctor
+    {
+      enum { BlockSize = 4096 };
+      const char *Kinds;
+      const primitiveT *Values;
+      primitiveT *Output;
+      vtkIdType Size;
+      char *Malformed;
+      void operator()(vtkIdType begin, vtkIdType end) const
+      {
+        const int nElementTokens = nComponents + (isPositions ? 3 : 2);
+        for (vtkIdType blockI = begin; blockI < end; blockI++)
+          {
+          const vtkIdType endI = std::min(this->Size,
+            (blockI + 1) * BlockSize);
+          for (vtkIdType i = blockI * BlockSize; i < endI; i++)
+            {
+            const char *kinds = this->Kinds + i * nElementTokens;
+            const primitiveT *values = this->Values + i * nElementTokens;
+            bool valid = kinds[0] == '(' && kinds[nComponents + 1] == ')'
+              && (!isPositions || kinds[nComponents + 2] == 0);
+            for (int j = 0; j < nComponents; j++)
+              {
+              valid = valid && kinds[j + 1] == 0;
+              this->Output[i * nComponents + j] = values[j + 1];
+              }
+            if (!valid)
+              {
+              this->Malformed[blockI] = 1;
+              }
+            }
+          }
+      }
+    };
+
 public:
     vectorListTraits() :
       Ptr(listT::New())
@@ -2129,6 +2602,41 @@ public:
           }
         }
     }
+    // parses the list body concurrently, including the closing ')'
+    void ReadAsciiListInParallel(vtkFoamIOobject& io, const int size)
+    {
+      std::vector<char> body;
+      io.ReadListBody(body);
+      vtkFoamListTokenizer<primitiveT> tokenizer;
+      const vtkIdType nTokens = tokenizer.Count(body);
+      // each element is "(x y z)", followed by label celli for positions
+      const int nElementTokens = nComponents + (isPositions ? 3 : 2);
+      if (nTokens != static_cast<vtkIdType>(size) * nElementTokens
+        || tokenizer.GetNumberOfParentheses() != 2 * static_cast<vtkIdType>(size))
+        {
+        throw vtkFoamError() << "Expected " << size << " elements of "
+        << nComponents << " components";
+        }
+      std::vector<char> kinds(nTokens);
+      std::vector<primitiveT> values(nTokens);
+      tokenizer.Fill(&kinds[0], &values[0]);
+
+      ScatterFunctor scatter;
+      scatter.Kinds = &kinds[0];
+      scatter.Values = &values[0];
+      scatter.Output = this->Ptr->GetPointer(0);
+      scatter.Size = size;
+      const vtkIdType nBlocks = (size + ScatterFunctor::BlockSize - 1)
+        / ScatterFunctor::BlockSize;
+      std::vector<char> malformed(nBlocks, 0);
+      scatter.Malformed = &malformed[0];
+      vtkSMPTools::For(0, nBlocks, 1, scatter);
+      if (std::find(malformed.begin(), malformed.end(), 1) != malformed.end())
+        {
+        throw vtkFoamError() << "Malformed list of " << nComponents
+        << "-component elements";
+        }
+    }
     void ReadBinaryList(vtkFoamIOobject& io, const int size)
     {
       if (isPositions) // lagrangian/positions (class Cloud)
@@ -2153,13 +2661,8 @@ public:
         }
       else
         {
-        for (int i = 0; i < size; i++)
-          {
-          double buffer[nComponents];
-          io.Read(reinterpret_cast<unsigned char *>(buffer), sizeof(double)
-              * nComponents);
-          this->Ptr->SetTuple(i, buffer);
-          }
+        vtkFoamReadBinaryDoubles(io, this->Ptr->GetPointer(0),
+          static_cast<vtkIdType>(size) * nComponents);
         }
     }
     void ReadValue(vtkFoamIOobject& io, vtkFoamToken& currToken)
@@ -2302,6 +2805,86 @@ public:
   template <vtkFoamToken::tokenType listType, typename traitsT> void ReadNonuniformList(
       vtkFoamIOobject& io);
 
+  // reads the body of an ASCII list of sizeI labelLists, which are
+  // tokenized concurrently, and returns the total number of labels
+  int ReadAsciiLabelListListInParallel(vtkFoamIOobject& io, const int sizeI)
+  {
+    std::vector<char> body;
+    io.ReadListBody(body);
+    vtkFoamListTokenizer<int> tokenizer;
+    const vtkIdType nTokens = tokenizer.Count(body);
+    std::vector<char> kinds(nTokens + 1, ')');
+    std::vector<int> values(nTokens + 1);
+    if (nTokens > 0)
+      {
+      tokenizer.Fill(&kinds[0], &values[0]);
+      }
+
+    // kinds[nTokens] is a sentinel so that a truncated sublist is detected
+    // without checking the bounds
+    vtkIdType tokenI = 0;
+    int bodyI = 0;
+    for (int i = 0; i < sizeI; i++)
+      {
+      if (tokenI == nTokens)
+        {
+        throw vtkFoamError() << "Expected " << sizeI << " lists, found " << i;
+        }
+      if (kinds[tokenI] == 0)
+        {
+        const int sizeJ = values[tokenI++];
+        if (sizeJ < 0)
+          {
+          throw vtkFoamError() << "List size must not be negative: size = "
+          << sizeJ;
+          }
+        if (kinds[tokenI++] != '(')
+          {
+          throw vtkFoamError() << "Expected '(' after list size " << sizeJ;
+          }
+        int *listI = this->Superclass::LabelListListPtr->WritePointer(i,
+            bodyI, sizeJ);
+        for (int j = 0; j < sizeJ; j++, tokenI++)
+          {
+          if (kinds[tokenI] != 0)
+            {
+            throw vtkFoamError() << "Expected " << sizeJ
+            << " integers in list " << i;
+            }
+          listI[j] = values[tokenI];
+          }
+        if (kinds[tokenI++] != ')' || tokenI > nTokens)
+          {
+          throw vtkFoamError() << "Expected ')' after " << sizeJ
+          << " integers in list " << i;
+          }
+        bodyI += sizeJ;
+        }
+      else if (kinds[tokenI] == '(')
+        {
+        this->Superclass::LabelListListPtr->SetIndex(i, bodyI);
+        for (tokenI++; kinds[tokenI] == 0; tokenI++)
+          {
+          this->Superclass::LabelListListPtr
+          ->InsertValue(bodyI++, values[tokenI]);
+          }
+        if (tokenI == nTokens || kinds[tokenI++] != ')')
+          {
+          throw vtkFoamError() << "Expected integers and ')' in list " << i;
+          }
+        }
+      else
+        {
+        throw vtkFoamError() << "Expected integer or '(', found ')'";
+        }
+      }
+    if (tokenI != nTokens)
+      {
+      throw vtkFoamError() << "Expected ')' after " << sizeI << " lists";
+      }
+    return bodyI;
+  }
+
   // reads a list of labelLists. requires size prefix of the listList
   // to be present. size of each sublist must also be present in the
   // stream if the format is binary.
@@ -2325,70 +2908,79 @@ public:
       this->Superclass::Type = LABELLISTLIST;
       io.ReadExpecting('(');
       int bodyI = 0;
-      for (int i = 0; i < sizeI; i++)
+      if (io.GetFormat() == vtkFoamIOobject::ASCII
+        && sizeI >= VTK_FOAMFILE_PARALLEL_LIST_SIZE)
         {
-        if (!io.Read(currToken))
-          {
-          throw vtkFoamError() << "Unexpected EOF";
-          }
-        if (currToken.GetType() == vtkFoamToken::LABEL)
+        // parses the list body concurrently, including the closing ')'
+        bodyI = this->ReadAsciiLabelListListInParallel(io, sizeI);
+        }
+      else
+        {
+        for (int i = 0; i < sizeI; i++)
           {
-          const int sizeJ = currToken.To<int>();
-          if (sizeJ < 0)
+          if (!io.Read(currToken))
             {
-            throw vtkFoamError() << "List size must not be negative: size = "
-            << sizeJ;
+            throw vtkFoamError() << "Unexpected EOF";
             }
-          int *listI = this->Superclass::LabelListListPtr->WritePointer(i,
-              bodyI, sizeJ);
-
-          if (io.GetFormat() == vtkFoamIOobject::ASCII)
+          if (currToken.GetType() == vtkFoamToken::LABEL)
             {
-            io.ReadExpecting('(');
-            for (int j = 0; j < sizeJ; j++)
+            const int sizeJ = currToken.To<int>();
+            if (sizeJ < 0)
               {
-              listI[j] = vtkFoamReadValue<int>::ReadValue(io);
+              throw vtkFoamError() << "List size must not be negative: size = "
+              << sizeJ;
               }
-            io.ReadExpecting(')');
-            }
-          else
-            {
-            if (sizeJ > 0) // avoid invalid reference to labelListI.at(0)
+            int *listI = this->Superclass::LabelListListPtr->WritePointer(i,
+                bodyI, sizeJ);
+
+            if (io.GetFormat() == vtkFoamIOobject::ASCII)
               {
               io.ReadExpecting('(');
-              io.Read(reinterpret_cast<unsigned char*>(listI), sizeJ
-                  * sizeof(int));
+              for (int j = 0; j < sizeJ; j++)
+                {
+                listI[j] = vtkFoamReadValue<int>::ReadValue(io);
+                }
               io.ReadExpecting(')');
               }
+            else
+              {
+              if (sizeJ > 0) // avoid invalid reference to labelListI.at(0)
+                {
+                io.ReadExpecting('(');
+                io.Read(reinterpret_cast<unsigned char*>(listI), sizeJ
+                    * sizeof(int));
+                io.ReadExpecting(')');
+                }
+              }
+            bodyI += sizeJ;
             }
-          bodyI += sizeJ;
-          }
-        else if (currToken == '(')
-          {
-          this->Superclass::LabelListListPtr->SetIndex(i, bodyI);
-          while (io.Read(currToken) && currToken != ')')
+          else if (currToken == '(')
             {
-            if (currToken.GetType() != vtkFoamToken::LABEL)
+            this->Superclass::LabelListListPtr->SetIndex(i, bodyI);
+            while (io.Read(currToken) && currToken != ')')
               {
-              throw vtkFoamError() << "Expected an integer, found "
-              << currToken;
+              if (currToken.GetType() != vtkFoamToken::LABEL)
+                {
+                throw vtkFoamError() << "Expected an integer, found "
+                << currToken;
+                }
+              this->Superclass::LabelListListPtr
+              ->InsertValue(bodyI++, currToken.To<int>());
               }
-            this->Superclass::LabelListListPtr
-            ->InsertValue(bodyI++, currToken.To<int>());
+            }
+          else
+            {
+            throw vtkFoamError() << "Expected integer or '(', found "
+            << currToken;
             }
           }
-        else
-          {
-          throw vtkFoamError() << "Expected integer or '(', found "
-          << currToken;
-          }
+        io.ReadExpecting(')');
         }
       // set the next index of the last element to calculate the last
       // subarray size
       this->Superclass::LabelListListPtr->SetIndex(sizeI, bodyI);
       // shrink to the actually used size
       this->Superclass::LabelListListPtr->ResizeBody(bodyI);
-      io.ReadExpecting(')');
       }
     else
       {
@@ -2500,12 +3092,7 @@ VTK_TEMPLATE_SPECIALIZE
 void vtkFoamEntryValue::listTraits<vtkFloatArray, float>::ReadBinaryList(
     vtkFoamIOobject& io, const int size)
 {
-  for (int i = 0; i < size; i++)
-    {
-    double buffer;
-    io.Read(reinterpret_cast<unsigned char *>(&buffer), sizeof(double));
-    this->Ptr->SetValue(i, static_cast<float>(buffer));
-    }
+  vtkFoamReadBinaryDoubles(io, this->Ptr->GetPointer(0), size);
 }
 
 // generic reader for nonuniform lists. requires size prefix of the
@@ -2547,8 +3134,15 @@ void vtkFoamEntryValue::ReadNonuniformList(vtkFoamIOobject& io)
         {
         throw vtkFoamError() << "Expected '(', found " << currToken;
         }
-      list.ReadAsciiList(io, size);
-      io.ReadExpecting(')');
+      if (size >= VTK_FOAMFILE_PARALLEL_LIST_SIZE)
+        {
+        list.ReadAsciiListInParallel(io, size);
+        }
+      else
+        {
+        list.ReadAsciiList(io, size);
+        io.ReadExpecting(')');
+        }
       }
     else
       {
@@ -18,17 +18,22 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkErrorCode.h"
+#include "vtkExactPointMerger.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
-#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <ctype.h>
+#include <string.h>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkSTLReader);
@@ -36,6 +41,52 @@ vtkStandardNewMacro(vtkSTLReader);
 #define VTK_ASCII 0
 #define VTK_BINARY 1
 
+namespace
+{
+// A binary facet is a normal and three vertices (twelve 32-bit floats)
+// followed by a 2 byte attribute byte count.
+const size_t VTK_STL_FACET_SIZE = 50;
+
+// Number of facets read from the file at once.
+const vtkIdType VTK_STL_BLOCK_SIZE = 65536;
+
+// Copies the little endian vertices of a block of facets into the points.
+struct STLFacetDecoder
+{
+  const char *Facets;
+  float *Points;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      float *x = this->Points + 9 * i;
+      // skip the normal
+      memcpy(x, this->Facets + VTK_STL_FACET_SIZE * i + 12, 9 * sizeof(float));
+      vtkByteSwap::Swap4LERange(x, 9);
+      }
+  }
+};
+
+// Fills the connectivity of unmerged triangles, 3 consecutive points each.
+struct STLConnectivityBuilder
+{
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType *cell = this->Connectivity + 4 * i;
+      cell[0] = 3;
+      cell[1] = 3 * i;
+      cell[2] = 3 * i + 1;
+      cell[3] = 3 * i + 2;
+      }
+  }
+};
+}
+
 vtkCxxSetObjectMacro(vtkSTLReader,Locator,vtkIncrementalPointLocator);
 
 // Construct object with merging set to true.
@@ -167,41 +218,82 @@ int vtkSTLReader::RequestData(
     int nextCell=0;
 
     mergedPts = vtkPoints::New();
-    mergedPts->Allocate(newPts->GetNumberOfPoints()/2);
     mergedPolys = vtkCellArray::New();
-    mergedPolys->Allocate(newPolys->GetSize());
     if (newScalars)
       {
       mergedScalars = vtkFloatArray::New();
-      mergedScalars->Allocate(newPolys->GetSize());
+      mergedScalars->Allocate(newPolys->GetNumberOfCells());
       }
 
-    vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
     if (this->Locator == NULL)
       {
-      locator.TakeReference(this->NewDefaultLocator());
-      }
-    locator->InitPointInsertion (mergedPts, newPts->GetBounds());
-
-    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
-      {
-      for (i=0; i < 3; i++)
+      // All of the points are known, so merge them in bulk rather than
+      // inserting them one at a time in a locator.
+      vtkIdTypeArray *pointMap = vtkIdTypeArray::New();
+      vtkExactPointMerger *merger = vtkExactPointMerger::New();
+      merger->MergePoints(newPts, mergedPts, pointMap);
+      merger->Delete();
+      const vtkIdType *map = pointMap->GetPointer(0);
+
+      vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+      vtkIdType *cells = connectivity->WritePointer(
+        0, 4 * newPolys->GetNumberOfCells());
+      vtkIdType numCells = 0;
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
         {
-        newPts->GetPoint(pts[i],x);
-        locator->InsertUniquePoint(x, nodes[i]);
+        for (i=0; i < 3; i++)
+          {
+          nodes[i] = map[pts[i]];
+          }
+
+        if ( nodes[0] != nodes[1] &&
+             nodes[0] != nodes[2] &&
+             nodes[1] != nodes[2] )
+          {
+          cells[0] = 3;
+          cells[1] = nodes[0];
+          cells[2] = nodes[1];
+          cells[3] = nodes[2];
+          cells += 4;
+          numCells++;
+          if (newScalars)
+            {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+            }
+          }
+        nextCell++;
         }
+      connectivity->SetNumberOfTuples(4 * numCells);
+      mergedPolys->SetCells(numCells, connectivity);
+      connectivity->Delete();
+      pointMap->Delete();
+      }
+    else
+      {
+      mergedPts->Allocate(newPts->GetNumberOfPoints()/2);
+      mergedPolys->Allocate(newPolys->GetSize());
+      this->Locator->InitPointInsertion (mergedPts, newPts->GetBounds());
 
-      if ( nodes[0] != nodes[1] &&
-           nodes[0] != nodes[2] &&
-           nodes[1] != nodes[2] )
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
         {
-        mergedPolys->InsertNextCell(3,nodes);
-        if (newScalars)
+        for (i=0; i < 3; i++)
           {
-          mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          newPts->GetPoint(pts[i],x);
+          this->Locator->InsertUniquePoint(x, nodes[i]);
           }
+
+        if ( nodes[0] != nodes[1] &&
+             nodes[0] != nodes[2] &&
+             nodes[1] != nodes[2] )
+          {
+          mergedPolys->InsertNextCell(3,nodes);
+          if (newScalars)
+            {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+            }
+          }
+        nextCell++;
         }
-      nextCell++;
       }
 
     newPts->Delete();
@@ -250,13 +342,9 @@ int vtkSTLReader::RequestData(
 bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
                                  vtkCellArray *newPolys)
 {
-  int i, numTris;
-  vtkIdType pts[3];
+  int numTris;
   unsigned long   ulint;
-  unsigned short  ibuff2;
   char    header[81];
-  typedef struct  {float  n[3], v1[3], v2[3], v3[3];} facet_t;
-  facet_t facet;
 
   vtkDebugMacro(<< " Reading BINARY STL file");
 
@@ -290,50 +378,66 @@ bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
   ulFileLength -= (80 + 4); // 80 byte - header, 4 byte - tringle count
   ulFileLength /= 50;       // 50 byte - twelve 32-bit-floating point numbers + 2 byte for attribute byte count
 
-  if (numTris < static_cast<int>(ulFileLength))
+  // The file cannot hold more facets than its length allows, so a larger
+  // count in the header is not trusted either.
+  if (numTris != static_cast<int>(ulFileLength))
+    {
+    vtkDebugMacro(<< "Binary count " << numTris
+                  << " does not match the file length, using " << ulFileLength);
     numTris = static_cast<int>(ulFileLength);
+    }
 
   // now we can allocate the memory we need for this STL file
-  newPts->Allocate(numTris*3,10000);
-  newPolys->Allocate(numTris,20000);
-
-  for ( i=0; fread(&facet,48,1,fp) > 0; i++ )
+  vtkFloatArray *coordinates = vtkFloatArray::New();
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetNumberOfTuples(static_cast<vtkIdType>(numTris) * 3);
+  float *points = coordinates->GetPointer(0);
+
+  // Facets are read in blocks and decoded in parallel.
+  std::vector<char> buffer(VTK_STL_FACET_SIZE * VTK_STL_BLOCK_SIZE);
+  STLFacetDecoder decoder;
+  decoder.Facets = &buffer[0];
+  vtkIdType i = 0;
+  while (i < numTris)
     {
-    if (fread(&ibuff2,2,1,fp) != 1) //read extra junk
+    vtkIdType numToRead = std::min(static_cast<vtkIdType>(VTK_STL_BLOCK_SIZE),
+                                   static_cast<vtkIdType>(numTris) - i);
+    size_t numBytes =
+      fread(&buffer[0], 1, VTK_STL_FACET_SIZE * numToRead, fp);
+    vtkIdType numRead = static_cast<vtkIdType>(numBytes / VTK_STL_FACET_SIZE);
+    decoder.Points = points + 9 * i;
+    vtkSMPTools::For(0, numRead, decoder);
+    i += numRead;
+
+    if (numBytes % VTK_STL_FACET_SIZE >= 48) //read extra junk
       {
+      coordinates->Delete();
       vtkErrorMacro ("STLReader error reading file: " << this->FileName
                      << " Premature EOF while reading extra junk.");
       return false;
       }
-
-    vtkByteSwap::Swap4LE (facet.n);
-    vtkByteSwap::Swap4LE (facet.n+1);
-    vtkByteSwap::Swap4LE (facet.n+2);
-
-    vtkByteSwap::Swap4LE (facet.v1);
-    vtkByteSwap::Swap4LE (facet.v1+1);
-    vtkByteSwap::Swap4LE (facet.v1+2);
-    pts[0] = newPts->InsertNextPoint(facet.v1);
-
-    vtkByteSwap::Swap4LE (facet.v2);
-    vtkByteSwap::Swap4LE (facet.v2+1);
-    vtkByteSwap::Swap4LE (facet.v2+2);
-    pts[1] = newPts->InsertNextPoint(facet.v2);
-
-    vtkByteSwap::Swap4LE (facet.v3);
-    vtkByteSwap::Swap4LE (facet.v3+1);
-    vtkByteSwap::Swap4LE (facet.v3+2);
-    pts[2] = newPts->InsertNextPoint(facet.v3);
-
-    newPolys->InsertNextCell(3,pts);
-
-    if ( (i % 5000) == 0 && i != 0 )
+    if (numRead < numToRead)
       {
-      vtkDebugMacro(<< "triangle# " << i);
-      this->UpdateProgress(static_cast<double>(i)/numTris);
+      break;
       }
+
+    vtkDebugMacro(<< "triangle# " << i);
+    this->UpdateProgress(static_cast<double>(i)/numTris);
     }
 
+  coordinates->SetNumberOfTuples(3 * i);
+  newPts->SetData(coordinates);
+  coordinates->Delete();
+
+  // Every facet refers to its own three points.
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfTuples(4 * i);
+  STLConnectivityBuilder builder;
+  builder.Connectivity = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, i, builder);
+  newPolys->SetCells(i, connectivity);
+  connectivity->Delete();
+
   return true;
 }
 
@@ -495,8 +599,8 @@ int vtkSTLReader::GetSTLFileType(const char *filename)
   return type;
 }
 
-// Specify a spatial locator for merging points. By
-// default an instance of vtkMergePoints is used.
+// Create a vtkMergePoints, which merges the same points as the built-in
+// merging.
 vtkIncrementalPointLocator* vtkSTLReader::NewDefaultLocator()
 {
   return vtkMergePoints::New();
@@ -22,8 +22,9 @@
 // .stl files are quite inefficient since they duplicate vertex
 // definitions. By setting the Merging boolean you can control whether the
 // point data is merged after reading. Merging is performed by default,
-// however, merging requires a large amount of temporary storage since a
-// 3D hash table must be constructed.
+// however, merging requires a large amount of temporary storage since the
+// points must be sorted (see vtkExactPointMerger), or a 3D hash table must
+// be constructed when a locator is specified.
 
 // .SECTION Caveats
 // Binary files written on one system may not be readable on other systems.
@@ -73,8 +74,9 @@ public:
   vtkBooleanMacro(ScalarTags,int);
 
   // Description:
-  // Specify a spatial locator for merging points. By
-  // default an instance of vtkMergePoints is used.
+  // Specify a spatial locator for merging points. By default no locator
+  // is used and exactly coincident points are merged in bulk with
+  // vtkExactPointMerger, which gives the same result as vtkMergePoints.
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
 
@@ -83,7 +85,9 @@ protected:
   ~vtkSTLReader();
 
   // Description:
-  // Create default locator. Used to create one when none is specified.
+  // Create default locator, a vtkMergePoints. The reader does not use it,
+  // points are merged with vtkExactPointMerger when no locator is
+  // specified, but subclasses may.
   vtkIncrementalPointLocator* NewDefaultLocator();
 
   char *FileName;
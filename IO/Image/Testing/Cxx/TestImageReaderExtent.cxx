@@ -0,0 +1,323 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageReaderExtent.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of update extent requests on image readers
+// .SECTION Description
+// Writes multi-strip TIFF files, and a volume as a series of PNG, JPEG
+// and TIFF files, and checks that reading a sub-extent yields the same
+// values as the matching part of the whole image.
+
+#include "vtkImageData.h"
+#include "vtkImageWriter.h"
+#include "vtkJPEGReader.h"
+#include "vtkJPEGWriter.h"
+#include "vtkNew.h"
+#include "vtkPNGReader.h"
+#include "vtkPNGWriter.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTestUtilities.h"
+#include "vtkTIFFReader.h"
+#include "vtkTIFFWriter.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const int Slices = 12;
+
+// vtkTIFFWriter stores the top row of the image first, so read the files
+// back as ORIENTATION_BOTLEFT.
+const unsigned int BottomLeft = 4;
+
+// The files to read, either a single file or a series given by prefix
+// and pattern or by a list of file names.
+struct ReaderSource
+{
+  std::string Type;
+  std::string FileName;
+  std::string Prefix;
+  bool UseFileNames;
+};
+
+vtkImageReader2 *NewReader(const ReaderSource &source)
+{
+  vtkImageReader2 *reader;
+  if (source.Type == "png")
+    {
+    reader = vtkPNGReader::New();
+    }
+  else if (source.Type == "jpg")
+    {
+    reader = vtkJPEGReader::New();
+    }
+  else
+    {
+    vtkTIFFReader *tiffReader = vtkTIFFReader::New();
+    tiffReader->SetOrientationType(BottomLeft);
+    reader = tiffReader;
+    }
+
+  if (!source.FileName.empty())
+    {
+    reader->SetFileName(source.FileName.c_str());
+    return reader;
+    }
+
+  std::string pattern = "%s_%03d." + source.Type;
+  if (source.UseFileNames)
+    {
+    vtkNew<vtkStringArray> fileNames;
+    for (int z = 0; z < Slices; ++z)
+      {
+      char fileName[1024];
+      sprintf(fileName, pattern.c_str(), source.Prefix.c_str(), z);
+      fileNames->InsertNextValue(fileName);
+      }
+    reader->SetFileNames(fileNames.GetPointer());
+    }
+  else
+    {
+    reader->SetFilePrefix(source.Prefix.c_str());
+    reader->SetFilePattern(pattern.c_str());
+    reader->SetDataExtent(0, 0, 0, 0, 0, Slices - 1);
+    }
+  return reader;
+}
+
+// Read each of the extents and compare it to reading the whole image,
+// and to the input when the format is lossless.
+bool TestExtents(const ReaderSource &source, vtkImageData *input,
+                 bool lossless, int extents[][6], size_t numberOfExtents)
+{
+  const std::string &what =
+    (source.FileName.empty() ? source.Prefix : source.FileName);
+
+  vtkSmartPointer<vtkImageReader2> wholeReader;
+  wholeReader.TakeReference(NewReader(source));
+  wholeReader->Update();
+  vtkImageData *whole = wholeReader->GetOutput();
+
+  int wholeExtent[6];
+  whole->GetExtent(wholeExtent);
+  int inputExtent[6];
+  input->GetExtent(inputExtent);
+  int numberOfComponents = input->GetNumberOfScalarComponents();
+  for (int i = 0; i < 6; ++i)
+    {
+    if (wholeExtent[i] != inputExtent[i])
+      {
+      cerr << "Unexpected extent read from " << what << endl;
+      return false;
+      }
+    }
+  if (whole->GetNumberOfScalarComponents() != numberOfComponents)
+    {
+    cerr << "Unexpected number of components read from " << what << endl;
+    return false;
+    }
+
+  for (size_t e = 0; e < numberOfExtents; ++e)
+    {
+    vtkSmartPointer<vtkImageReader2> reader;
+    reader.TakeReference(NewReader(source));
+    reader->UpdateInformation();
+    reader->SetUpdateExtent(0, extents[e]);
+    reader->Update();
+    vtkImageData *output = reader->GetOutput();
+
+    int *ext = extents[e];
+    int outExt[6];
+    output->GetExtent(outExt);
+    for (int i = 0; i < 6; ++i)
+      {
+      if (outExt[i] != ext[i])
+        {
+        cerr << "Reader did not produce the requested extent for "
+             << what << endl;
+        return false;
+        }
+      }
+
+    for (int z = ext[4]; z <= ext[5]; ++z)
+      {
+      for (int y = ext[2]; y <= ext[3]; ++y)
+        {
+        for (int x = ext[0]; x <= ext[1]; ++x)
+          {
+          for (int c = 0; c < numberOfComponents; ++c)
+            {
+            // JPEG is lossy, so only the whole image can be compared to
+            double expected = whole->GetScalarComponentAsDouble(x, y, z, c);
+            if (output->GetScalarComponentAsDouble(x, y, z, c) != expected ||
+                (lossless &&
+                 input->GetScalarComponentAsDouble(x, y, z, c) != expected))
+              {
+              cerr << "Value mismatch at " << x << ", " << y << ", " << z
+                   << " in " << what << endl;
+              return false;
+              }
+            }
+          }
+        }
+      }
+    }
+  return true;
+}
+
+bool TestTIFFFile(const std::string &tempDir, int scalarType,
+                  int numberOfComponents, int compression)
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 156, 0, 92, 0, 0);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  for (int y = 0; y <= 92; ++y)
+    {
+    for (int x = 0; x <= 156; ++x)
+      {
+      for (int c = 0; c < numberOfComponents; ++c)
+        {
+        image->SetScalarComponentFromDouble(x, y, 0, c,
+          (x * 7 + y * 13 + c * 57 + (x * y) % 11) % 256);
+        }
+      }
+    }
+
+  ReaderSource source;
+  source.Type = "tif";
+  source.FileName = tempDir + "/TestImageReaderExtent.tif";
+  source.UseFileNames = false;
+
+  vtkNew<vtkTIFFWriter> writer;
+  writer->SetInputData(image.GetPointer());
+  writer->SetFileName(source.FileName.c_str());
+  writer->SetCompression(compression);
+  writer->Write();
+
+  int extents[][6] = {
+    { 0, 156, 0, 92, 0, 0 },
+    { 0, 156, 40, 41, 0, 0 },
+    { 17, 101, 3, 88, 0, 0 },
+    { 156, 156, 92, 92, 0, 0 },
+    { 60, 60, 0, 92, 0, 0 }
+  };
+  return TestExtents(source, image.GetPointer(), true, extents,
+                     sizeof(extents) / sizeof(extents[0]));
+}
+
+void MakeVolume(vtkImageData *image, int numberOfComponents)
+{
+  image->SetExtent(0, 70, 0, 45, 0, Slices - 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, numberOfComponents);
+  for (int z = 0; z < Slices; ++z)
+    {
+    for (int y = 0; y <= 45; ++y)
+      {
+      for (int x = 0; x <= 70; ++x)
+        {
+        for (int c = 0; c < numberOfComponents; ++c)
+          {
+          // Runs of equal values, so that PackBits has something to pack
+          image->SetScalarComponentFromDouble(x, y, z, c,
+            ((x / 4) * 9 + y * 5 + z * 11 + c * 40) % 256);
+          }
+        }
+      }
+    }
+}
+
+bool TestSeries(vtkImageWriter *writer, vtkImageData *input,
+                const std::string &prefix, const std::string &type,
+                bool lossless)
+{
+  std::string pattern = "%s_%03d." + type;
+  writer->SetInputData(input);
+  writer->SetFilePrefix(prefix.c_str());
+  writer->SetFilePattern(pattern.c_str());
+  writer->SetFileDimensionality(2);
+  writer->Write();
+
+  int extents[][6] = {
+    { 0, 70, 0, 45, 0, Slices - 1 },
+    { 0, 70, 0, 45, 4, 4 },
+    { 9, 52, 3, 40, 2, 9 },
+    { 70, 70, 45, 45, Slices - 1, Slices - 1 },
+    { 33, 33, 0, 45, 0, Slices - 1 }
+  };
+  ReaderSource source;
+  source.Type = type;
+  source.Prefix = prefix;
+  bool success = true;
+  for (int useFileNames = 0; useFileNames < 2; ++useFileNames)
+    {
+    source.UseFileNames = (useFileNames != 0);
+    success &= TestExtents(source, input, lossless, extents,
+                           sizeof(extents) / sizeof(extents[0]));
+    }
+  return success;
+}
+
+}
+
+int TestImageReaderExtent(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string tempPath = tempDir;
+  delete [] tempDir;
+
+  bool success = true;
+  success &= TestTIFFFile(tempPath, VTK_UNSIGNED_CHAR, 1,
+                          vtkTIFFWriter::PackBits);
+  success &= TestTIFFFile(tempPath, VTK_UNSIGNED_SHORT, 1,
+                          vtkTIFFWriter::NoCompression);
+  success &= TestTIFFFile(tempPath, VTK_UNSIGNED_CHAR, 3,
+                          vtkTIFFWriter::PackBits);
+  success &= TestTIFFFile(tempPath, VTK_FLOAT, 1,
+                          vtkTIFFWriter::NoCompression);
+
+  std::string prefix = tempPath + "/TestImageReaderExtent";
+  for (int numberOfComponents = 1; numberOfComponents <= 3;
+       numberOfComponents += 2)
+    {
+    vtkNew<vtkImageData> image;
+    MakeVolume(image.GetPointer(), numberOfComponents);
+
+    vtkNew<vtkPNGWriter> pngWriter;
+    success &= TestSeries(pngWriter.GetPointer(), image.GetPointer(),
+                          prefix + "PNG", "png", true);
+
+    vtkNew<vtkJPEGWriter> jpegWriter;
+    success &= TestSeries(jpegWriter.GetPointer(), image.GetPointer(),
+                          prefix + "JPEG", "jpg", false);
+
+    vtkNew<vtkTIFFWriter> tiffWriter;
+    tiffWriter->SetCompressionToNoCompression();
+    success &= TestSeries(tiffWriter.GetPointer(), image.GetPointer(),
+                          prefix + "TIFF", "tif", true);
+
+    vtkNew<vtkTIFFWriter> packBitsWriter;
+    packBitsWriter->SetCompressionToPackBits();
+    success &= TestSeries(packBitsWriter.GetPointer(), image.GetPointer(),
+                          prefix + "PackBits", "tif", true);
+    }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
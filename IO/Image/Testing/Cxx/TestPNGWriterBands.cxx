@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPNGWriterBands.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkPNGWriter on images large enough to be compressed in bands
+// .SECTION Description
+// vtkPNGWriter deflates the rows of large images in bands of 256K. This
+// writes 8 and 16 bit images with 1 to 4 components that span several
+// bands, as well as a small one that does not, and checks that
+// vtkPNGReader reads back exactly the same values.
+
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPNGReader.h"
+#include "vtkPNGWriter.h"
+#include "vtkTestUtilities.h"
+
+#include <string>
+
+namespace {
+
+bool TestRoundTrip(const std::string &fileName, int scalarType,
+                   int numberOfComponents, int width, int height)
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, width - 1, 0, height - 1, 0, 0);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  double range = (scalarType == VTK_UNSIGNED_CHAR ? 256.0 : 65536.0);
+
+  // Smooth areas and noisy areas, so that the rows end up with different
+  // filter types.
+  unsigned int seed = 12345;
+  for (int y = 0; y < height; ++y)
+    {
+    for (int x = 0; x < width; ++x)
+      {
+      for (int c = 0; c < numberOfComponents; ++c)
+        {
+        seed = seed * 1103515245u + 12345u;
+        double value = ((y / 64) % 2 == 0 ?
+                        (x * 37 + y * 11 + c * 1000) % 5000 :
+                        (seed >> 8) % 65536);
+        image->SetScalarComponentFromDouble(x, y, 0, c,
+          static_cast<int>(value) % static_cast<int>(range));
+        }
+      }
+    }
+
+  vtkNew<vtkPNGWriter> writer;
+  writer->SetInputData(image.GetPointer());
+  writer->SetFileName(fileName.c_str());
+  writer->Write();
+  if (writer->GetErrorCode())
+    {
+    cerr << "Could not write " << fileName << endl;
+    return false;
+    }
+
+  vtkNew<vtkPNGReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkImageData *output = reader->GetOutput();
+
+  int extent[6];
+  output->GetExtent(extent);
+  if (extent[1] != width - 1 || extent[3] != height - 1 ||
+      output->GetScalarType() != scalarType ||
+      output->GetNumberOfScalarComponents() != numberOfComponents)
+    {
+    cerr << "Wrong image read back for " << width << "x" << height
+         << " " << image->GetScalarTypeAsString() << " with "
+         << numberOfComponents << " components" << endl;
+    return false;
+    }
+
+  for (int y = 0; y < height; ++y)
+    {
+    for (int x = 0; x < width; ++x)
+      {
+      for (int c = 0; c < numberOfComponents; ++c)
+        {
+        if (output->GetScalarComponentAsDouble(x, y, 0, c) !=
+            image->GetScalarComponentAsDouble(x, y, 0, c))
+          {
+          cerr << "Value mismatch at " << x << ", " << y << " for "
+               << width << "x" << height << " "
+               << image->GetScalarTypeAsString() << " with "
+               << numberOfComponents << " components" << endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+int TestPNGWriterBands(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string fileName = tempDir;
+  delete [] tempDir;
+  fileName += "/TestPNGWriterBands.png";
+
+  bool success = true;
+  for (int numberOfComponents = 1; numberOfComponents <= 4;
+       ++numberOfComponents)
+    {
+    // At 1 byte per pixel, a band holds 870 rows of 300 pixels, so every
+    // one of these images spans at least two bands, with a partial last one.
+    success &= TestRoundTrip(fileName, VTK_UNSIGNED_CHAR,
+                             numberOfComponents, 300, 1000);
+    success &= TestRoundTrip(fileName, VTK_UNSIGNED_SHORT,
+                             numberOfComponents, 300, 1000);
+    }
+
+  // Too small to be split into bands
+  success &= TestRoundTrip(fileName, VTK_UNSIGNED_CHAR, 3, 40, 30);
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -248,116 +248,86 @@ void vtkDICOMImageReader::ExecuteDataWithInformation(vtkDataObject *output,
 
   this->ComputeDataIncrements();
 
-  if (this->FileName)
+  vtkDebugMacro( << "Reading " << (this->FileName ? 1 :
+                 static_cast<int>(this->DICOMFileNames->size())) << " file(s)");
+
+  // Decode the files of the slices concurrently
+  if (this->ReadSlices(data) == 0)
     {
-    vtkDebugMacro( << "Single file : " << this->FileName);
+    // Leave the header of the last file read in the helper, for the
+    // accessors describing the last image processed.
+    this->ComputeInternalFileName(data->GetExtent()[5]);
     this->Parser->ClearAllDICOMTagCallbacks();
-    this->Parser->OpenFile(this->FileName);
     this->AppHelper->Clear();
     this->AppHelper->RegisterCallbacks(this->Parser);
-    this->AppHelper->RegisterPixelDataCallback(this->Parser);
-
+    this->Parser->OpenFile(this->InternalFileName);
     this->Parser->ReadHeader();
+    }
+}
 
-    void* imgData = NULL;
-    DICOMParser::VRTypes dataType;
-    unsigned long imageDataLength;
-
-    this->AppHelper->GetImageData(imgData, dataType, imageDataLength);
-    if( !imageDataLength )
-      {
-      vtkErrorMacro( << "There was a problem retrieving data from: " << this->FileName );
-      this->SetErrorCode( vtkErrorCode::FileFormatError );
-      return;
-      }
-
-    void* buffer = data->GetScalarPointer();
-    if (buffer == NULL)
-      {
-      vtkErrorMacro(<< "No memory allocated for image data!");
-      return;
-      }
-    // DICOM stores the upper left pixel as the first pixel in an
-    // image. VTK stores the lower left pixel as the first pixel in
-    // an image.  Need to flip the data.
-    vtkIdType rowLength;
-    rowLength = this->DataIncrements[1];
-    unsigned char *b = (unsigned char *)buffer;
-    unsigned char *iData = (unsigned char *)imgData;
-    iData += (imageDataLength - rowLength); // beginning of last row
-    for (int i=0; i < this->AppHelper->GetHeight(); ++i)
-      {
-      memcpy(b, iData, rowLength);
-      b += rowLength;
-      iData -= rowLength;
-      }
+//----------------------------------------------------------------------------
+int vtkDICOMImageReader::ReadSlice(const char *fileName, int,
+                                   vtkImageData *data, void *outPtr)
+{
+  // The parser and the helper hold the state of the file being parsed, so
+  // every slice needs its own.
+  DICOMParser parser;
+  DICOMAppHelper appHelper;
+  appHelper.RegisterCallbacks(&parser);
+  appHelper.RegisterPixelDataCallback(&parser);
+  if (!parser.OpenFile(fileName))
+    {
+    return 0;
     }
-  else if (this->DICOMFileNames->size() > 0)
+  parser.ReadHeader();
+
+  void* imgData = NULL;
+  DICOMParser::VRTypes dataType;
+  unsigned long imageDataLengthInBytes;
+  appHelper.GetImageData(imgData, dataType, imageDataLengthInBytes);
+
+  int extent[6];
+  data->GetExtent(extent);
+  vtkIdType increments[3];
+  data->GetIncrements(increments);
+  vtkIdType rowLength = this->DataIncrements[1];
+  vtkIdType pixelLength = this->DataIncrements[0];
+  if (!imageDataLengthInBytes ||
+      static_cast<vtkIdType>(imageDataLengthInBytes) <
+        (extent[3] + 1) * rowLength)
     {
-    vtkDebugMacro( << "Multiple files (" << static_cast<int>(this->DICOMFileNames->size()) << ")");
-    this->Parser->ClearAllDICOMTagCallbacks();
-    this->AppHelper->Clear();
-    this->AppHelper->RegisterCallbacks(this->Parser);
-    this->AppHelper->RegisterPixelDataCallback(this->Parser);
-
-    void* buffer = data->GetScalarPointer();
-    if (buffer == NULL)
-      {
-      vtkErrorMacro(<< "No memory allocated for image data!");
-      return;
-      }
-
-    std::vector<std::string>::iterator fiter;
-
-    int count = 0;
-    int numFiles = static_cast<int>(this->DICOMFileNames->size());
-
-    for (fiter = this->DICOMFileNames->begin();
-         fiter != this->DICOMFileNames->end();
-         fiter++)
-      {
-      count++;
-      const char *file = fiter->c_str();
-      vtkDebugMacro( << "File : " << file );
-      this->Parser->OpenFile( file );
-      this->Parser->ReadHeader();
-
-      void* imgData = NULL;
-      DICOMParser::VRTypes dataType;
-      unsigned long imageDataLengthInBytes;
+    return 0;
+    }
 
-      this->AppHelper->GetImageData(imgData, dataType, imageDataLengthInBytes);
-      if( !imageDataLengthInBytes )
-        {
-        vtkErrorMacro( << "There was a problem retrieving data from: " << file );
-        this->SetErrorCode( vtkErrorCode::FileFormatError );
-        return;
-        }
+  // DICOM stores the upper left pixel as the first pixel in an
+  // image. VTK stores the lower left pixel as the first pixel in
+  // an image.  Need to flip the data.
+  unsigned char *b = static_cast<unsigned char *>(outPtr);
+  unsigned char *iData = static_cast<unsigned char *>(imgData) +
+    imageDataLengthInBytes + extent[0] * pixelLength;
+  vtkIdType length = (extent[1] - extent[0] + 1) * pixelLength;
+  for (int y = extent[2]; y <= extent[3]; ++y)
+    {
+    memcpy(b, iData - (y + 1) * rowLength, length);
+    b += increments[1] * data->GetScalarSize();
+    }
+  return 1;
+}
 
-      // DICOM stores the upper left pixel as the first pixel in an
-      // image. VTK stores the lower left pixel as the first pixel in
-      // an image.  Need to flip the data.
-      vtkIdType rowLength;
-      rowLength = this->DataIncrements[1];
-      unsigned char *b = (unsigned char *)buffer;
-      unsigned char *iData = (unsigned char *)imgData;
-      iData += (imageDataLengthInBytes - rowLength); // beginning of last row
-      for (int i=0; i < this->AppHelper->GetHeight(); ++i)
-        {
-        memcpy(b, iData, rowLength);
-        b += rowLength;
-        iData -= rowLength;
-        }
-      buffer = ((char*) buffer) + imageDataLengthInBytes;
-
-      this->UpdateProgress(float(count)/float(numFiles));
-      int len = static_cast<int> (strlen((const char*) (*fiter).c_str()));
-      char* filename = new char[len+1];
-      strcpy(filename, (const char*) (*fiter).c_str());
-      this->SetProgressText(filename);
-      delete[] filename;
-      }
+//----------------------------------------------------------------------------
+void vtkDICOMImageReader::ComputeInternalFileName(int slice)
+{
+  if (this->FileName || slice < 0 ||
+      slice >= static_cast<int>(this->DICOMFileNames->size()))
+    {
+    this->Superclass::ComputeInternalFileName(slice);
+    return;
     }
+
+  const std::string &fileName = (*this->DICOMFileNames)[slice];
+  delete [] this->InternalFileName;
+  this->InternalFileName = new char[fileName.size() + 1];
+  strcpy(this->InternalFileName, fileName.c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -156,6 +156,11 @@ class VTKIOIMAGE_EXPORT vtkDICOMImageReader : public vtkImageReader2
   //
   virtual int CanReadFile(const char* fname);
 
+  // Description:
+  // When reading a directory, the internal file name of a slice is that
+  // of its file in the series, sorted by image position.
+  virtual void ComputeInternalFileName(int slice);
+
   //
   // What file extensions are supported?
   //
@@ -179,6 +184,8 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSlice(const char *fileName, int slice, vtkImageData *data,
+                        void *outPtr);
 
   //
   // Constructor
@@ -22,10 +22,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageReader2);
 
@@ -809,6 +813,104 @@ void vtkImageReader2::ExecuteDataWithInformation(vtkDataObject *output,
     }
 }
 
+//----------------------------------------------------------------------------
+// Reads a range of the slices of a file series into the output.
+class vtkImageReader2SliceReader
+{
+public:
+  vtkImageReader2 *Reader;
+  vtkImageData *Data;
+  const std::vector<std::string> *FileNames;
+  int FirstSlice;
+  char *Output;
+  vtkIdType SliceSize; // in bytes
+  char *Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Failed[i] = !this->Reader->ReadSlice(
+        (*this->FileNames)[i].c_str(), this->FirstSlice + static_cast<int>(i),
+        this->Data, this->Output + i * this->SliceSize);
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+int vtkImageReader2::ReadSlices(vtkImageData *data)
+{
+  int extent[6];
+  data->GetExtent(extent);
+  int numberOfSlices = extent[5] - extent[4] + 1;
+  if (numberOfSlices <= 0)
+    {
+    return 0;
+    }
+
+  // Work out every file name up front, ComputeInternalFileName is not
+  // thread safe.
+  std::vector<std::string> fileNames(numberOfSlices);
+  for (int i = 0; i < numberOfSlices; ++i)
+    {
+    this->ComputeInternalFileName(extent[4] + i);
+    if (!this->InternalFileName)
+      {
+      return numberOfSlices;
+      }
+    fileNames[i] = this->InternalFileName;
+    }
+
+  vtkIdType increments[3];
+  data->GetIncrements(increments);
+
+  std::vector<char> failed(numberOfSlices, 0);
+  vtkImageReader2SliceReader reader;
+  reader.Reader = this;
+  reader.Data = data;
+  reader.FileNames = &fileNames;
+  reader.FirstSlice = extent[4];
+  reader.Output = static_cast<char*>(data->GetScalarPointer());
+  reader.SliceSize = increments[2] * data->GetScalarSize();
+  reader.Failed = &failed[0];
+
+  // Progress can only be reported from this thread, so hand the slices
+  // out in a few batches, naming the last file of each batch.
+  int batchSize = std::max(32, (numberOfSlices + 9) / 10);
+  for (int first = 0; first < numberOfSlices; first += batchSize)
+    {
+    int last = std::min(first + batchSize, numberOfSlices);
+    vtkSMPTools::For(first, last, 1, reader);
+    this->SetProgressText(fileNames[last - 1].c_str());
+    this->UpdateProgress(static_cast<double>(last) / numberOfSlices);
+    }
+
+  int numberOfFailures = 0;
+  for (int i = 0; i < numberOfSlices; ++i)
+    {
+    if (failed[i])
+      {
+      vtkErrorMacro(<< "Could not read slice " << extent[4] + i
+                    << " from file: " << fileNames[i]);
+      ++numberOfFailures;
+      }
+    }
+  if (numberOfFailures)
+    {
+    this->SetErrorCode(vtkErrorCode::FileFormatError);
+    }
+  return numberOfFailures;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageReader2::ReadSlice(const char *vtkNotUsed(fileName),
+                               int vtkNotUsed(slice),
+                               vtkImageData *vtkNotUsed(data),
+                               void *vtkNotUsed(outPtr))
+{
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkImageReader2::SetMemoryBuffer(void *membuf)
 {
@@ -41,6 +41,7 @@
 #include "vtkIOImageModule.h" // For export macro
 #include "vtkImageAlgorithm.h"
 
+class vtkImageData;
 class vtkStringArray;
 
 #define VTK_FILE_BYTE_ORDER_BIG_ENDIAN 0
@@ -277,9 +278,29 @@ protected:
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *data, vtkInformation *outInfo);
   virtual void ComputeDataIncrements();
+
+  // Description:
+  // Read the slices in the extent of data, each of which is stored in a
+  // file of its own, by calling ReadSlice for them concurrently with
+  // vtkSMPTools. Readers of file series opt into this by overriding
+  // ReadSlice and calling ReadSlices from ExecuteDataWithInformation.
+  // The progress text is set to the name of the last file read.
+  // Returns the number of slices that could not be read.
+  int ReadSlices(vtkImageData *data);
+
+  // Description:
+  // Decode the file of the given slice straight into the output, outPtr
+  // being the first scalar of that slice in data. This is called from
+  // several threads at once, so it may only read the state of the reader
+  // (not InternalFileName, for instance). Return 0 on failure.
+  virtual int ReadSlice(const char *fileName, int slice, vtkImageData *data,
+                        void *outPtr);
+
 private:
   vtkImageReader2(const vtkImageReader2&);  // Not implemented.
   void operator=(const vtkImageReader2&);  // Not implemented.
+
+  friend class vtkImageReader2SliceReader;
 };
 
 #endif
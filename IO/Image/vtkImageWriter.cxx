@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkImageWriter.h"
 
+#include "vtkAlgorithmOutput.h"
 #include "vtkCommand.h"
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
@@ -21,11 +22,20 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkImageData.h"
 
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if _MSC_VER
+#define snprintf _snprintf
+#endif
+
 vtkStandardNewMacro(vtkImageWriter);
 
 //----------------------------------------------------------------------------
@@ -493,6 +503,169 @@ void vtkImageWriter::WriteFile(ofstream *file, vtkImageData *data,
     }
 }
 
+//----------------------------------------------------------------------------
+// Writes a range of the slices of a batch to their files.
+class vtkImageWriterSliceWriter
+{
+public:
+  vtkImageWriter *Writer;
+  vtkImageData *Data;
+  const std::vector<std::string> *FileNames;
+  int *WholeExtent;
+  int *ErrorCodes;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      int uExtent[6];
+      std::copy(this->WholeExtent, this->WholeExtent + 4, uExtent);
+      uExtent[4] = uExtent[5] = this->WholeExtent[4] + static_cast<int>(i);
+      this->ErrorCodes[i] = this->Writer->WriteSlice(
+        (*this->FileNames)[i].c_str(), this->Data, uExtent);
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+void vtkImageWriter::WriteSlices()
+{
+  this->GetInputExecutive(0, 0)->UpdateInformation();
+  vtkInformation *inInfo = this->GetInputInformation(0, 0);
+  int wExtent[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wExtent);
+  int numberOfSlices = wExtent[5] - wExtent[4] + 1;
+  this->FileNumber = wExtent[4];
+  this->MinimumFileNumber = this->MaximumFileNumber = this->FileNumber;
+  this->FilesDeleted = 0;
+  if (numberOfSlices <= 0)
+    {
+    return;
+    }
+
+  // Work out every file name up front.
+  size_t nameSize = (this->FileName ? strlen(this->FileName) : 1) +
+    (this->FilePrefix ? strlen(this->FilePrefix) : 1) +
+    (this->FilePattern ? strlen(this->FilePattern) : 1) + 256;
+  std::vector<char> name(nameSize);
+  std::vector<std::string> fileNames(numberOfSlices);
+  for (int i = 0; i < numberOfSlices; ++i)
+    {
+    int bytesPrinted;
+    if (this->FileName)
+      {
+      bytesPrinted = snprintf(&name[0], nameSize, "%s", this->FileName);
+      }
+    else if (this->FilePrefix)
+      {
+      bytesPrinted = snprintf(&name[0], nameSize, this->FilePattern,
+                              this->FilePrefix, wExtent[4] + i);
+      }
+    else
+      {
+      bytesPrinted = snprintf(&name[0], nameSize, this->FilePattern,
+                              wExtent[4] + i);
+      }
+    if (bytesPrinted < 0 || static_cast<size_t>(bytesPrinted) >= nameSize)
+      {
+      // add null terminating character just to be safe.
+      name[nameSize - 1] = 0;
+      vtkWarningMacro("Filename has been truncated.");
+      }
+    fileNames[i] = &name[0];
+    }
+
+  // Only a batch of slices is requested from the input at a time, both to
+  // bound memory like the one slice per update this replaces and so that
+  // progress can be reported from this thread in between.
+  vtkIdType sliceSize = static_cast<vtkIdType>(wExtent[1] - wExtent[0] + 1) *
+    (wExtent[3] - wExtent[2] + 1);
+  vtkIdType maxBatchSize = std::max<vtkIdType>(1, (1 << 24) / sliceSize);
+  int batchSize = static_cast<int>(std::min<vtkIdType>(
+    std::max(32, (numberOfSlices + 9) / 10), maxBatchSize));
+
+  std::vector<int> errorCodes(numberOfSlices, vtkErrorCode::NoError);
+  vtkImageWriterSliceWriter writer;
+  writer.Writer = this;
+  writer.FileNames = &fileNames;
+  writer.WholeExtent = wExtent;
+  writer.ErrorCodes = &errorCodes[0];
+
+  this->UpdateProgress(0.0);
+  for (int first = 0; first < numberOfSlices; first += batchSize)
+    {
+    int last = std::min(first + batchSize, numberOfSlices);
+    int uExtent[6];
+    std::copy(wExtent, wExtent + 4, uExtent);
+    uExtent[4] = wExtent[4] + first;
+    uExtent[5] = wExtent[4] + last - 1;
+    vtkStreamingDemandDrivenPipeline::SetUpdateExtent(inInfo, uExtent);
+    this->GetInputExecutive(0, 0)->Update(
+      this->GetInputConnection(0, 0)->GetIndex());
+    vtkImageData *data = this->GetInput();
+    if (first == 0 && !this->CanWriteSlice(data))
+      {
+      return;
+      }
+
+    writer.Data = data;
+    this->MaximumFileNumber = uExtent[5];
+    if (this->FileName)
+      {
+      // Every slice goes to the same file, the last one wins.
+      writer(first, last);
+      }
+    else
+      {
+      vtkSMPTools::For(first, last, 1, writer);
+      }
+    this->FileNumber = uExtent[5] + 1;
+
+    for (int i = first; i < last; ++i)
+      {
+      switch (errorCodes[i])
+        {
+        case vtkErrorCode::NoError:
+        case vtkErrorCode::OutOfDiskSpaceError:
+          break;
+        case vtkErrorCode::CannotOpenFileError:
+          vtkErrorMacro("Unable to open file " << fileNames[i]);
+          this->SetErrorCode(errorCodes[i]);
+          break;
+        default:
+          vtkErrorMacro("Could not write slice " << wExtent[4] + i
+                        << " to file " << fileNames[i]);
+          this->SetErrorCode(errorCodes[i]);
+          break;
+        }
+      }
+    if (std::find(errorCodes.begin() + first, errorCodes.begin() + last,
+                  static_cast<int>(vtkErrorCode::OutOfDiskSpaceError)) !=
+        errorCodes.begin() + last)
+      {
+      this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+      this->DeleteFiles();
+      return;
+      }
+    this->UpdateProgress(static_cast<double>(last) / numberOfSlices);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageWriter::CanWriteSlice(vtkImageData *vtkNotUsed(data))
+{
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageWriter::WriteSlice(const char *vtkNotUsed(fileName),
+                               vtkImageData *vtkNotUsed(data),
+                               int vtkNotUsed(uExtent)[6])
+{
+  return vtkErrorCode::FileFormatError;
+}
+
+//----------------------------------------------------------------------------
 void vtkImageWriter::DeleteFiles()
 {
   if (this->FilesDeleted)
@@ -97,6 +97,27 @@ protected:
   virtual void WriteFileHeader(ofstream *, vtkImageData *, int [6]) {}
   virtual void WriteFileTrailer(ofstream *, vtkImageData *) {}
 
+  // Description:
+  // Write each slice of the input to a file of its own by calling
+  // WriteSlice for the slices concurrently with vtkSMPTools. The input is
+  // updated a batch of slices at a time, so only that batch has to be
+  // held in memory. Writers of 2D formats opt into this by overriding
+  // WriteSlice and calling WriteSlices from Write.
+  void WriteSlices();
+
+  // Description:
+  // Check that WriteSlice can handle the scalars of data, reporting why
+  // not. WriteSlices calls this once, before any file is written.
+  virtual int CanWriteSlice(vtkImageData *data);
+
+  // Description:
+  // Write the slice uExtent of data to the named file. This is called
+  // from several threads at once, so it may only read the state of the
+  // writer and must not report errors itself. Returns a vtkErrorCode,
+  // NoError on success.
+  virtual int WriteSlice(const char *fileName, vtkImageData *data,
+                         int uExtent[6]);
+
   // This is called by the superclass.
   // This is the method you should override.
   virtual int RequestData(vtkInformation *request,
@@ -110,6 +131,8 @@ protected:
 private:
   vtkImageWriter(const vtkImageWriter&);  // Not implemented.
   void operator=(const vtkImageWriter&);  // Not implemented.
+
+  friend class vtkImageWriterSliceWriter;
 };
 
 #endif
@@ -225,8 +225,8 @@ void vtkJPEGReader::ExecuteInformation()
 }
 
 template <class OT>
-int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
-                          int *outExt, vtkIdType *outInc, long)
+int vtkJPEGReaderUpdate2(vtkJPEGReader *self, const char *fileName,
+                         OT *outPtr, int *outExt, vtkIdType *outInc, long)
 {
   // certain variables must be stored here for longjmp
   struct vtk_jpeg_error_mgr jerr;
@@ -235,7 +235,7 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
 
   if (!self->GetMemoryBuffer())
     {
-    jerr.fp = fopen(self->GetInternalFileName(), "rb");
+    jerr.fp = fopen(fileName, "rb");
     if (!jerr.fp)
       {
       return 1;
@@ -331,36 +331,24 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkJPEGReaderUpdate(vtkJPEGReader *self, vtkImageData *data, OT *outPtr)
+int vtkJPEGReader::ReadSlice(const char *fileName, int, vtkImageData *data,
+                             void *outPtr)
 {
   vtkIdType outIncr[3];
   int outExtent[6];
-  OT *outPtr2;
-
   data->GetExtent(outExtent);
   data->GetIncrements(outIncr);
 
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);
+  long pixSize = data->GetNumberOfScalarComponents()*data->GetScalarSize();
 
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+  switch (data->GetScalarType())
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a JPEG file
-    if ( vtkJPEGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize) == 2 )
-      {
-      const char* fn = self->GetInternalFileName();
-      vtkErrorWithObjectMacro(self, "libjpeg could not read file: " << fn);
-      }
-
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    vtkTemplateMacro(return vtkJPEGReaderUpdate2(this, fileName,
+                                                 (VTK_TT *)(outPtr),
+                                                 outExtent, outIncr,
+                                                 pixSize) == 0);
     }
+  return 0;
 }
 
 
@@ -382,17 +370,8 @@ void vtkJPEGReader::ExecuteDataWithInformation(vtkDataObject *output,
 
   data->GetPointData()->GetScalars()->SetName("JPEGImage");
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
-  switch (data->GetScalarType())
-    {
-    vtkTemplateMacro(vtkJPEGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
-    default:
-      vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }
+  // Decode the files of the slices concurrently
+  this->ReadSlices(data);
 }
 
 
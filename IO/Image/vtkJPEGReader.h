@@ -60,6 +60,8 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSlice(const char *fileName, int slice, vtkImageData *data,
+                        void *outPtr);
 private:
   vtkJPEGReader(const vtkJPEGReader&);  // Not implemented.
   void operator=(const vtkJPEGReader&);  // Not implemented.
@@ -22,6 +22,8 @@
 #include "vtkToolkits.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <vector>
+
 extern "C" {
 #include "vtk_jpeg.h"
 #if defined(__sgi) && !defined(__GNUC__)
@@ -32,10 +34,6 @@ extern "C" {
 #include <setjmp.h>
 }
 
-#if _MSC_VER
-#define snprintf _snprintf
-#endif
-
 vtkStandardNewMacro(vtkJPEGWriter);
 
 vtkCxxSetObjectMacro(vtkJPEGWriter,Result,vtkUnsignedCharArray);
@@ -80,26 +78,23 @@ void vtkJPEGWriter::Write()
     return;
     }
 
-  // Make sure the file name is allocated
-  size_t InternalFileNameSize = (this->FileName ? strlen(this->FileName) : 1) +
-    (this->FilePrefix ? strlen(this->FilePrefix) : 1) +
-    (this->FilePattern ? strlen(this->FilePattern) : 1) + 10;
-  this->InternalFileName = new char[InternalFileNameSize];
+  if (!this->WriteToMemory)
+    {
+    this->WriteSlices();
+    return;
+    }
 
-  // Fill in image information.
+  // Every slice goes to Result, so they are written one after another
+  // and the last one wins.
   vtkDemandDrivenPipeline::SafeDownCast(this->GetInputExecutive(0, 0))->UpdateInformation();
   int *wExtent;
   wExtent = this->GetInputInformation(0, 0)->Get(
     vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
-  this->FileNumber = wExtent[4];
-  this->MinimumFileNumber = this->MaximumFileNumber = this->FileNumber;
-  this->FilesDeleted = 0;
   this->UpdateProgress(0.0);
   // loop over the z axis and write the slices
   for (this->FileNumber = wExtent[4]; this->FileNumber <= wExtent[5];
        ++this->FileNumber)
     {
-    this->MaximumFileNumber = this->FileNumber;
     int uExtent[6];
     memcpy(uExtent, wExtent, 4*sizeof(int));
     uExtent[4] = this->FileNumber;
@@ -107,37 +102,21 @@ void vtkJPEGWriter::Write()
     vtkStreamingDemandDrivenPipeline::SetUpdateExtent(
       this->GetInputInformation(0, 0),
       uExtent);
-    // determine the name
-    if (this->FileName)
-      {
-      sprintf(this->InternalFileName,"%s",this->FileName);
-      }
-    else
+    this->GetInputExecutive(0, 0)->Update();
+    if (!this->CanWriteSlice(this->GetInput()))
       {
-      if (this->FilePrefix)
-        {
-        sprintf(this->InternalFileName, this->FilePattern,
-                this->FilePrefix, this->FileNumber);
-        }
-      else
-        {
-        snprintf(this->InternalFileName, InternalFileNameSize,
-          this->FilePattern, this->FileNumber);
-        }
+      return;
       }
-    this->GetInputExecutive(0, 0)->Update();
-    this->WriteSlice(this->GetInput(), uExtent);
-    if (this->ErrorCode == vtkErrorCode::OutOfDiskSpaceError)
+    int errorCode = this->WriteSlice(NULL, this->GetInput(), uExtent);
+    if (errorCode != vtkErrorCode::NoError)
       {
-      vtkErrorMacro("Ran out of disk space; deleting file(s) already written");
-      this->DeleteFiles();
+      vtkErrorMacro("Unable to write JPEG image");
+      this->SetErrorCode(errorCode);
       return;
       }
     this->UpdateProgress((this->FileNumber - wExtent[4])/
                          (wExtent[5] - wExtent[4] + 1.0));
     }
-  delete [] this->InternalFileName;
-  this->InternalFileName = NULL;
 }
 
 // these three routines are for writing into memory
@@ -230,28 +209,53 @@ extern "C"
 }
 
 
+//----------------------------------------------------------------------------
+int vtkJPEGWriter::CanWriteSlice(vtkImageData *data)
+{
+  if (data->GetScalarType() != VTK_UNSIGNED_CHAR)
+    {
+    vtkWarningMacro("JPEGWriter only supports unsigned char input");
+    return 0;
+    }
+
+  if (data->GetNumberOfScalarComponents() > MAX_COMPONENTS)
+    {
+    vtkErrorMacro("Exceed JPEG limits for number of components (" << data->GetNumberOfScalarComponents() << " > " << MAX_COMPONENTS << ")" );
+    return 0;
+    }
+  return 1;
+}
+
 // we disable this warning because even though this is a C++ file, between
 // the setjmp and resulting longjmp there should not be any C++ constructors
 // or destructors.
 #if defined(_MSC_VER) && !defined(VTK_DISPLAY_WIN32_WARNINGS)
 #pragma warning ( disable : 4611 )
 #endif
-void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
+int vtkJPEGWriter::WriteSlice(const char *fileName, vtkImageData *data,
+                              int uExtent[6])
 {
-  // Call the correct templated function for the output
-  unsigned int ui;
-
-  // Call the correct templated function for the input
-  if (data->GetScalarType() != VTK_UNSIGNED_CHAR)
+  if (data->GetScalarType() != VTK_UNSIGNED_CHAR ||
+      data->GetNumberOfScalarComponents() > MAX_COMPONENTS)
     {
-    vtkWarningMacro("JPEGWriter only supports unsigned char input");
-    return;
+    return vtkErrorCode::FileFormatError;
     }
 
-  if (data->GetNumberOfScalarComponents() > MAX_COMPONENTS)
+  // set the information about image
+  unsigned int width, height;
+  width = uExtent[1] - uExtent[0] + 1;
+  height = uExtent[3] - uExtent[2] + 1;
+
+  // in jpeg, the first row is the top row of the image
+  void *outPtr;
+  outPtr = data->GetScalarPointer(uExtent[0], uExtent[2], uExtent[4]);
+  std::vector<JSAMPROW> row_pointers(height);
+  vtkIdType *outInc = data->GetIncrements();
+  vtkIdType rowInc = outInc[1];
+  for (unsigned int ui = 0; ui < height; ui++)
     {
-    vtkErrorMacro("Exceed JPEG limits for number of components (" << data->GetNumberOfScalarComponents() << " > " << MAX_COMPONENTS << ")" );
-    return;
+    row_pointers[height - ui - 1] = (JSAMPROW) outPtr;
+    outPtr = (unsigned char *)outPtr + rowInc;
     }
 
   // overriding jpeg_error_mgr so we don't exit when an error happens
@@ -259,15 +263,13 @@ void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
   // Create the jpeg compression object and error handler
   struct jpeg_compress_struct cinfo;
   struct VTK_JPEG_ERROR_MANAGER jerr;
-  this->TempFP = 0;
-  if (!this->WriteToMemory)
+  FILE *fp = 0;
+  if (fileName)
     {
-    this->TempFP = fopen(this->InternalFileName, "wb");
-    if (!this->TempFP)
+    fp = fopen(fileName, "wb");
+    if (!fp)
       {
-      vtkErrorMacro("Unable to open file " << this->InternalFileName);
-      this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
-      return;
+      return vtkErrorCode::CannotOpenFileError;
       }
     }
 
@@ -276,19 +278,18 @@ void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
   if (setjmp(jerr.setjmp_buffer))
     {
     jpeg_destroy_compress(&cinfo);
-    if (!this->WriteToMemory)
+    if (fp)
       {
-      fclose(this->TempFP);
+      fclose(fp);
       }
-    this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
-    return;
+    return vtkErrorCode::OutOfDiskSpaceError;
     }
 
   jpeg_create_compress(&cinfo);
 
   // set the destination file
   struct jpeg_destination_mgr compressionDestination;
-  if (this->WriteToMemory)
+  if (!fp)
     {
     // setup the compress structure to write to memory
     compressionDestination.init_destination = vtkJPEGWriteToMemoryInit;
@@ -299,14 +300,9 @@ void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
     }
   else
     {
-    jpeg_stdio_dest(&cinfo, this->TempFP);
+    jpeg_stdio_dest(&cinfo, fp);
     }
 
-  // set the information about image
-  unsigned int width, height;
-  width = uExtent[1] - uExtent[0] + 1;
-  height = uExtent[3] - uExtent[2] + 1;
-
   cinfo.image_width = width;    /* image width and height, in pixels */
   cinfo.image_height = height;
 
@@ -332,26 +328,16 @@ void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
   // start compression
   jpeg_start_compress(&cinfo, TRUE);
 
-  // write the data. in jpeg, the first row is the top row of the image
-  void *outPtr;
-  outPtr = data->GetScalarPointer(uExtent[0], uExtent[2], uExtent[4]);
-  JSAMPROW *row_pointers = new JSAMPROW [height];
-  vtkIdType *outInc = data->GetIncrements();
-  vtkIdType rowInc = outInc[1];
-  for (ui = 0; ui < height; ui++)
-    {
-    row_pointers[height - ui - 1] = (JSAMPROW) outPtr;
-    outPtr = (unsigned char *)outPtr + rowInc;
-    }
-  jpeg_write_scanlines(&cinfo, row_pointers, height);
+  // write the data
+  jpeg_write_scanlines(&cinfo, &row_pointers[0], height);
 
-  if (!this->WriteToMemory)
+  if (fp)
     {
-    if (fflush(this->TempFP) == EOF)
+    if (fflush(fp) == EOF)
       {
-      this->ErrorCode = vtkErrorCode::OutOfDiskSpaceError;
-      fclose(this->TempFP);
-      return;
+      jpeg_destroy_compress(&cinfo);
+      fclose(fp);
+      return vtkErrorCode::OutOfDiskSpaceError;
       }
     }
 
@@ -359,15 +345,37 @@ void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
   jpeg_finish_compress(&cinfo);
 
   // clean up and close the file
-  delete [] row_pointers;
   jpeg_destroy_compress(&cinfo);
 
-  if (!this->WriteToMemory)
+  if (fp)
+    {
+    fclose(fp);
+    }
+  return vtkErrorCode::NoError;
+}
+
+//----------------------------------------------------------------------------
+void vtkJPEGWriter::WriteSlice(vtkImageData *data, int* uExtent)
+{
+  if (!this->WriteToMemory && !this->InternalFileName)
+    {
+    this->SetErrorCode(vtkErrorCode::NoFileNameError);
+    return;
+    }
+  if (!this->CanWriteSlice(data))
     {
-    fclose(this->TempFP);
+    return;
+    }
+  int errorCode = this->WriteSlice(
+    this->WriteToMemory ? NULL : this->InternalFileName, data, uExtent);
+  if (errorCode != vtkErrorCode::NoError)
+    {
+    vtkErrorMacro("Unable to write JPEG image");
+    this->SetErrorCode(errorCode);
     }
 }
 
+//----------------------------------------------------------------------------
 void vtkJPEGWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
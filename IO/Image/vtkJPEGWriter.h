@@ -68,6 +68,15 @@ protected:
   vtkJPEGWriter();
   ~vtkJPEGWriter();
 
+  // Description:
+  // Compress one slice, to Result if fileName is NULL.
+  virtual int CanWriteSlice(vtkImageData *data);
+  virtual int WriteSlice(const char *fileName, vtkImageData *data,
+                         int uExtent[6]);
+
+  // Description:
+  // Write one slice to InternalFileName, or to Result when writing to
+  // memory, and report any error.
   void WriteSlice(vtkImageData *data, int* uExtent);
 
 private:
@@ -75,6 +84,8 @@ private:
   unsigned int Progressive;
   unsigned int WriteToMemory;
   vtkUnsignedCharArray *Result;
+  // Slices are written concurrently, each to a FILE of its own, so this
+  // is no longer used and stays NULL.
   FILE *TempFP;
 
 private:
@@ -163,29 +163,29 @@ void vtkPNGReader::ExecuteInformation()
 
 //----------------------------------------------------------------------------
 template <class OT>
-void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
-                         int *outExt, vtkIdType *outInc, long pixSize)
+int vtkPNGReaderUpdate2(const char *fileName, OT *outPtr,
+                        int *outExt, vtkIdType *outInc, long pixSize)
 {
   unsigned int ui;
   int i;
-  FILE *fp = fopen(self->GetInternalFileName(), "rb");
+  FILE *fp = fopen(fileName, "rb");
   if (!fp)
     {
-    return;
+    return 0;
     }
   unsigned char header[8];
   if (fread(header, 1, 8, fp) != 8)
     {
-    vtkGenericWarningMacro ("PNGReader error reading file: " << self->GetInternalFileName()
+    vtkGenericWarningMacro ("PNGReader error reading file: " << fileName
                    << " Premature EOF while reading header.");
     fclose (fp);
-    return;
+    return 0;
     }
   int is_png = !png_sig_cmp(header, 0, 8);
   if (!is_png)
     {
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_structp png_ptr = png_create_read_struct
@@ -193,7 +193,7 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
   if (!png_ptr)
     {
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_infop info_ptr = png_create_info_struct(png_ptr);
@@ -202,7 +202,7 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
     png_destroy_read_struct(&png_ptr,
                             (png_infopp)NULL, (png_infopp)NULL);
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_infop end_info = png_create_info_struct(png_ptr);
@@ -211,7 +211,7 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
     png_destroy_read_struct(&png_ptr, &info_ptr,
                             (png_infopp)NULL);
     fclose(fp);
-    return;
+    return 0;
     }
 
   // Set error handling
@@ -219,7 +219,7 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
   {
     png_destroy_read_struct (&png_ptr, &info_ptr, (png_infopp)NULL);
     fclose(fp);
-    return;
+    return 0;
   }
 
   png_init_io(png_ptr, fp);
@@ -295,34 +295,26 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
   png_read_end(png_ptr, NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
   fclose(fp);
+  return 1;
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkPNGReaderUpdate(vtkPNGReader *self, vtkImageData *data, OT *outPtr)
+int vtkPNGReader::ReadSlice(const char *fileName, int, vtkImageData *data,
+                            void *outPtr)
 {
   vtkIdType outIncr[3];
   int outExtent[6];
-  OT *outPtr2;
-
   data->GetExtent(outExtent);
   data->GetIncrements(outIncr);
 
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);
+  long pixSize = data->GetNumberOfScalarComponents()*data->GetScalarSize();
 
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+  switch (data->GetScalarType())
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a PNG file
-    vtkPNGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize);
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    vtkTemplateMacro(return vtkPNGReaderUpdate2(fileName, (VTK_TT *)(outPtr),
+                                                outExtent, outIncr, pixSize));
     }
+  return 0;
 }
 
 
@@ -344,17 +336,8 @@ void vtkPNGReader::ExecuteDataWithInformation(vtkDataObject *output,
 
   this->ComputeDataIncrements();
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
-  switch (data->GetScalarType())
-    {
-    vtkTemplateMacro(vtkPNGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
-    default:
-      vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }
+  // Decode the files of the slices concurrently
+  this->ReadSlices(data);
 }
 
 
@@ -59,6 +59,8 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSlice(const char *fileName, int slice, vtkImageData *data,
+                        void *outPtr);
 private:
   vtkPNGReader(const vtkPNGReader&);  // Not implemented.
   void operator=(const vtkPNGReader&);  // Not implemented.
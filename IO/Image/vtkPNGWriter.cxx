@@ -18,13 +18,14 @@
 #include "vtkErrorCode.h"
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtk_png.h"
+#include "vtk_zlib.h"
 
-#if _MSC_VER
-#define snprintf _snprintf
-#endif
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkPNGWriter);
 
@@ -68,75 +69,45 @@ void vtkPNGWriter::Write()
     return;
     }
 
-  // Make sure the file name is allocated
-  size_t internalFileNameSize = (this->FileName ? strlen(this->FileName) : 1) +
-            (this->FilePrefix ? strlen(this->FilePrefix) : 1) +
-            (this->FilePattern ? strlen(this->FilePattern) : 1) + 256;
-  this->InternalFileName = new char[internalFileNameSize];
-  this->InternalFileName[0] = 0;
+  if (!this->WriteToMemory)
+    {
+    this->WriteSlices();
+    return;
+    }
 
-  // Fill in image information.
+  // Every slice goes to Result, so they are written one after another
+  // and the last one wins.
   this->GetInputExecutive(0, 0)->UpdateInformation();
   int *wExtent;
   wExtent = vtkStreamingDemandDrivenPipeline::GetWholeExtent(
     this->GetInputInformation(0, 0));
-  this->FileNumber = wExtent[4];
-  this->MinimumFileNumber = this->MaximumFileNumber = this->FileNumber;
-  this->FilesDeleted = 0;
   this->UpdateProgress(0.0);
   // loop over the z axis and write the slices
   for (this->FileNumber = wExtent[4]; this->FileNumber <= wExtent[5];
        ++this->FileNumber)
     {
-    this->MaximumFileNumber = this->FileNumber;
     int uExt[6];
     memcpy(uExt, wExtent, 4*sizeof(int));
     uExt[4] = uExt[5] = this->FileNumber;
     vtkStreamingDemandDrivenPipeline::SetUpdateExtent(
       this->GetInputInformation(0, 0), uExt);
-    if (!this->WriteToMemory)
-      {
-      int bytes_printed = 0;
-      // determine the name
-      if (this->FileName)
-        {
-        bytes_printed = snprintf(this->InternalFileName, internalFileNameSize,
-          "%s",this->FileName);
-        }
-      else
-        {
-        if (this->FilePrefix)
-          {
-          bytes_printed = snprintf(this->InternalFileName, internalFileNameSize,
-            this->FilePattern, this->FilePrefix, this->FileNumber);
-          }
-        else
-          {
-          bytes_printed = snprintf(this->InternalFileName, internalFileNameSize,
-            this->FilePattern,this->FileNumber);
-          }
-        }
-      if (static_cast<size_t>(bytes_printed) >= internalFileNameSize)
-        {
-        // add null terminating character just to be safe.
-        this->InternalFileName[internalFileNameSize-1] = 0;
-        vtkWarningMacro("Filename has been truncated.");
-        }
-      }
     vtkDemandDrivenPipeline::SafeDownCast(
       this->GetInputExecutive(0, 0))->UpdateData(
         this->GetInputConnection(0, 0)->GetIndex());
-    this->WriteSlice(this->GetInput(), uExt);
-    if (this->ErrorCode == vtkErrorCode::OutOfDiskSpaceError)
+    if (!this->CanWriteSlice(this->GetInput()))
       {
-      this->DeleteFiles();
-      break;
+      return;
+      }
+    int errorCode = this->WriteSlice(NULL, this->GetInput(), uExt);
+    if (errorCode != vtkErrorCode::NoError)
+      {
+      vtkErrorMacro(<<"Unable to write PNG file!");
+      this->SetErrorCode(errorCode);
+      return;
       }
     this->UpdateProgress((this->FileNumber - wExtent[4])/
                          (wExtent[5] - wExtent[4] + 1.0));
     }
-  delete [] this->InternalFileName;
-  this->InternalFileName = NULL;
 }
 
 extern "C"
@@ -197,31 +168,323 @@ extern "C"
   }
 }
 
+//----------------------------------------------------------------------------
+// Filters and deflates the rows of a large image in bands concurrently.
+// The bands are joined into a single zlib stream the way pigz does it:
+// each band is a raw deflate stream primed with the last 32K of the one
+// before, all but the last end on a sync flush, and the adler32 checksums
+// of the bands are combined for the trailer.
+class vtkPNGWriterBandCompressor
+{
+public:
+  // Description:
+  // Rows, top row first, of RowBytes bytes each with BytesPerPixel bytes
+  // per pixel. Swap is set to store 16 bit samples in network order.
+  unsigned char **Rows;
+  size_t RowBytes;
+  size_t BytesPerPixel;
+  bool Swap;
+  int Level;
+  vtkIdType RowsPerBand;
+
+  std::vector<unsigned char> Filtered;
+  std::vector<std::vector<unsigned char> > Bands;
+  std::vector<uLong> Checksums;
+  std::vector<char> Failed;
+
+  // Description:
+  // Run the two passes, returns false if zlib failed.
+  bool Compress(vtkIdType height)
+  {
+    vtkIdType numberOfBands = (height + this->RowsPerBand - 1) /
+      this->RowsPerBand;
+    this->Filtered.resize(height * (this->RowBytes + 1));
+    this->Bands.resize(numberOfBands);
+    this->Checksums.resize(numberOfBands);
+    this->Failed.assign(numberOfBands, 0);
+
+    RowFilter filter = { this };
+    vtkSMPTools::For(0, height, filter);
+    BandDeflater deflater = { this, height };
+    vtkSMPTools::For(0, numberOfBands, 1, deflater);
+    return std::find(this->Failed.begin(), this->Failed.end(), 1) ==
+      this->Failed.end();
+  }
+
+  // Description:
+  // The two byte zlib header and the four byte adler32 trailer of the
+  // joined stream.
+  void GetHeader(png_byte header[2]) const
+  {
+    // FLEVEL as zlib's deflate writes it for the Z_FILTERED strategy.
+    int levelFlags = this->Level < 2 ? 0 :
+      (this->Level < 6 ? 1 : (this->Level == 6 ? 2 : 3));
+    unsigned int cmf = (0x78 << 8) | (levelFlags << 6);
+    cmf += 31 - cmf % 31;
+    header[0] = static_cast<png_byte>(cmf >> 8);
+    header[1] = static_cast<png_byte>(cmf & 0xff);
+  }
+  void GetTrailer(png_byte trailer[4]) const
+  {
+    uLong checksum = this->Checksums[0];
+    vtkIdType rowsPerBand = this->RowsPerBand;
+    vtkIdType height =
+      static_cast<vtkIdType>(this->Filtered.size() / (this->RowBytes + 1));
+    for (size_t b = 1; b < this->Checksums.size(); ++b)
+      {
+      vtkIdType rows = std::min(rowsPerBand,
+        height - static_cast<vtkIdType>(b) * rowsPerBand);
+      checksum = adler32_combine(checksum, this->Checksums[b],
+        static_cast<z_off_t>(rows * (this->RowBytes + 1)));
+      }
+    for (int i = 0; i < 4; ++i)
+      {
+      trailer[i] = static_cast<png_byte>((checksum >> (24 - 8 * i)) & 0xff);
+      }
+  }
+
+  // Copies row r into buffer, swapping 16 bit samples if asked to.
+  const unsigned char *GetRow(vtkIdType r, unsigned char *buffer) const
+  {
+    const unsigned char *row = this->Rows[r];
+    if (!this->Swap)
+      {
+      return row;
+      }
+    for (size_t i = 0; i + 1 < this->RowBytes; i += 2)
+      {
+      buffer[i] = row[i + 1];
+      buffer[i + 1] = row[i];
+      }
+    return buffer;
+  }
+
+  // Picks the filter of each row with the smallest sum of absolute
+  // differences, which is what libpng does by default.
+  struct RowFilter
+  {
+    vtkPNGWriterBandCompressor *Self;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      size_t n = this->Self->RowBytes;
+      size_t bpp = this->Self->BytesPerPixel;
+      std::vector<unsigned char> buffers(3 * n);
+      std::vector<unsigned char> zeros(n, 0);
+      std::vector<unsigned char> candidates(5 * n);
+      for (vtkIdType r = begin; r < end; ++r)
+        {
+        const unsigned char *row = this->Self->GetRow(r, &buffers[0]);
+        const unsigned char *prior = r == 0 ? &zeros[0] :
+          this->Self->GetRow(r - 1, &buffers[n]);
+        unsigned char *none = &candidates[0];
+        unsigned char *sub = none + n;
+        unsigned char *up = sub + n;
+        unsigned char *avg = up + n;
+        unsigned char *paeth = avg + n;
+        for (size_t i = 0; i < n; ++i)
+          {
+          int a = i >= bpp ? row[i - bpp] : 0;
+          int b = prior[i];
+          int c = i >= bpp ? prior[i - bpp] : 0;
+          int p = b - c;
+          int pc = a - c;
+          int pa = p < 0 ? -p : p;
+          int pb = pc < 0 ? -pc : pc;
+          pc = (p + pc) < 0 ? -(p + pc) : p + pc;
+          int predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+          none[i] = row[i];
+          sub[i] = static_cast<unsigned char>(row[i] - a);
+          up[i] = static_cast<unsigned char>(row[i] - b);
+          avg[i] = static_cast<unsigned char>(row[i] - ((a + b) >> 1));
+          paeth[i] = static_cast<unsigned char>(row[i] - predictor);
+          }
+        int best = 0;
+        unsigned long minimum = 0;
+        for (int f = 0; f < 5; ++f)
+          {
+          const unsigned char *candidate = &candidates[f * n];
+          unsigned long sum = 0;
+          for (size_t i = 0; i < n; ++i)
+            {
+            sum += candidate[i] < 128 ? candidate[i] : 256 - candidate[i];
+            }
+          if (f == 0 || sum < minimum)
+            {
+            best = f;
+            minimum = sum;
+            }
+          }
+        unsigned char *out = &this->Self->Filtered[r * (n + 1)];
+        out[0] = static_cast<unsigned char>(best);
+        memcpy(out + 1, &candidates[best * n], n);
+        }
+    }
+  };
+
+  struct BandDeflater
+  {
+    vtkPNGWriterBandCompressor *Self;
+    vtkIdType Height;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      size_t rowSize = this->Self->RowBytes + 1;
+      vtkIdType numberOfBands =
+        static_cast<vtkIdType>(this->Self->Bands.size());
+      for (vtkIdType b = begin; b < end; ++b)
+        {
+        vtkIdType first = b * this->Self->RowsPerBand;
+        vtkIdType last = std::min(first + this->Self->RowsPerBand,
+                                  this->Height);
+        unsigned char *in = &this->Self->Filtered[first * rowSize];
+        size_t length = (last - first) * rowSize;
+        this->Self->Checksums[b] = adler32(adler32(0L, Z_NULL, 0), in,
+                                           static_cast<uInt>(length));
+        this->Self->Failed[b] = !this->Deflate(
+          in, length, first * rowSize, b == numberOfBands - 1,
+          this->Self->Bands[b]);
+        }
+    }
+
+    bool Deflate(unsigned char *in, size_t length, size_t offset, bool last,
+                 std::vector<unsigned char> &out) const
+    {
+      z_stream stream;
+      stream.zalloc = Z_NULL;
+      stream.zfree = Z_NULL;
+      stream.opaque = Z_NULL;
+      if (deflateInit2(&stream, this->Self->Level, Z_DEFLATED, -15, 8,
+                       Z_FILTERED) != Z_OK)
+        {
+        return false;
+        }
+      size_t dictionary = std::min<size_t>(offset, 32768);
+      if (dictionary > 0)
+        {
+        deflateSetDictionary(&stream, in - dictionary,
+                             static_cast<uInt>(dictionary));
+        }
+      stream.next_in = in;
+      stream.avail_in = static_cast<uInt>(length);
+      int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+      size_t chunk = length / 2 + 1024;
+      out.clear();
+      for (;;)
+        {
+        size_t used = out.size();
+        out.resize(used + chunk);
+        stream.next_out = &out[used];
+        stream.avail_out = static_cast<uInt>(chunk);
+        int status = deflate(&stream, flush);
+        out.resize(used + chunk - stream.avail_out);
+        if (status == Z_STREAM_ERROR)
+          {
+          deflateEnd(&stream);
+          return false;
+          }
+        if (last ? status == Z_STREAM_END : stream.avail_out != 0)
+          {
+          break;
+          }
+        }
+      deflateEnd(&stream);
+      return true;
+    }
+  };
+};
+
+//----------------------------------------------------------------------------
+int vtkPNGWriter::CanWriteSlice(vtkImageData *data)
+{
+  if (data->GetScalarType() != VTK_UNSIGNED_SHORT &&
+      data->GetScalarType() != VTK_UNSIGNED_CHAR)
+    {
+    vtkWarningMacro("PNGWriter only supports unsigned char and unsigned short inputs");
+    return 0;
+    }
+  return 1;
+}
+
 // we disable this warning because even though this is a C++ file, between
 // the setjmp and resulting longjmp there should not be any C++ constructors
 // or destructors.
 #if defined(_MSC_VER) && !defined(VTK_DISPLAY_WIN32_WARNINGS)
 #pragma warning ( disable : 4611 )
 #endif
-void vtkPNGWriter::WriteSlice(vtkImageData *data, int* uExtent)
+int vtkPNGWriter::WriteSlice(const char *fileName, vtkImageData *data,
+                             int uExtent[6])
 {
-  // Call the correct templated function for the output
-  unsigned int ui;
-
-  // Call the correct templated function for the input
   if (data->GetScalarType() != VTK_UNSIGNED_SHORT &&
       data->GetScalarType() != VTK_UNSIGNED_CHAR)
     {
-    vtkWarningMacro("PNGWriter only supports unsigned char and unsigned short inputs");
-    return;
+    return vtkErrorCode::FileFormatError;
+    }
+
+  void *outPtr;
+  outPtr = data->GetScalarPointer(uExtent[0], uExtent[2], uExtent[4]);
+  png_uint_32 width, height;
+  width = uExtent[1] - uExtent[0] + 1;
+  height = uExtent[3] - uExtent[2] + 1;
+  int bit_depth = 8;
+  if (data->GetScalarType() == VTK_UNSIGNED_SHORT)
+    {
+    bit_depth = 16;
+    }
+  int color_type;
+  switch (data->GetNumberOfScalarComponents())
+    {
+    case 1: color_type = PNG_COLOR_TYPE_GRAY;
+      break;
+    case 2: color_type = PNG_COLOR_TYPE_GRAY_ALPHA;
+      break;
+    case 3: color_type = PNG_COLOR_TYPE_RGB;
+      break;
+    default: color_type = PNG_COLOR_TYPE_RGB_ALPHA;
+      break;
+    }
+
+  std::vector<png_byte *> row_pointers(height);
+  vtkIdType *outInc = data->GetIncrements();
+  vtkIdType rowInc = outInc[1]*bit_depth/8;
+  for (png_uint_32 ui = 0; ui < height; ui++)
+    {
+    // computing the offset explicitly in a temporary variable as there seems to
+    // be some bug in intel compilers on longhorn (thanks to Greg Abram) when
+    // the offset is computed directly in the []'s.
+    unsigned int offset = height - ui - 1;
+    row_pointers[offset] = (png_byte *)outPtr;
+    outPtr = (unsigned char *)outPtr + rowInc;
+    }
+
+  // Large images are compressed in bands of rows concurrently, small ones
+  // are left to libpng.
+  vtkPNGWriterBandCompressor bands;
+  bands.BytesPerPixel = data->GetNumberOfScalarComponents()*bit_depth/8;
+  bands.RowBytes = width*bands.BytesPerPixel;
+  bands.RowsPerBand = std::max<vtkIdType>(
+    1, 256*1024/static_cast<vtkIdType>(bands.RowBytes + 1));
+  bool banded = static_cast<vtkIdType>(height) > bands.RowsPerBand;
+  if (banded)
+    {
+    bands.Rows = &row_pointers[0];
+#ifndef VTK_WORDS_BIGENDIAN
+    bands.Swap = bit_depth > 8;
+#else
+    bands.Swap = false;
+#endif
+    bands.Level = this->CompressionLevel;
+    if (!bands.Compress(height))
+      {
+      return vtkErrorCode::UnknownError;
+      }
     }
 
   png_structp png_ptr = png_create_write_struct
     (PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL);
   if (!png_ptr)
     {
-    vtkErrorMacro(<<"Unable to write PNG file!");
-    return;
+    return vtkErrorCode::UnknownError;
     }
 
   png_set_compression_level(png_ptr, this->CompressionLevel);
@@ -231,14 +494,11 @@ void vtkPNGWriter::WriteSlice(vtkImageData *data, int* uExtent)
     {
     png_destroy_write_struct(&png_ptr,
                              (png_infopp)NULL);
-    vtkErrorMacro(<<"Unable to write PNG file!");
-    return;
+    return vtkErrorCode::UnknownError;
     }
 
-
-  this->TempFP = 0;
-  png_byte **row_pointers = 0;
-  if (this->WriteToMemory)
+  FILE *fp = 0;
+  if (!fileName)
     {
     vtkUnsignedCharArray *uc = this->GetResult();
     if (!uc || uc->GetReferenceCount() > 1)
@@ -254,48 +514,24 @@ void vtkPNGWriter::WriteSlice(vtkImageData *data, int* uExtent)
     }
   else
     {
-      this->TempFP = fopen(this->InternalFileName, "wb");
-      if (!this->TempFP)
-        {
-        vtkErrorMacro("Unable to open file " << this->InternalFileName);
-        this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
-        return;
-        }
-      png_init_io(png_ptr, this->TempFP);
-      png_set_error_fn(png_ptr, png_ptr,
-                       vtkPNGWriteErrorFunction, vtkPNGWriteWarningFunction);
-      if (setjmp(png_jmpbuf((png_ptr))))
-        {
-        fclose(this->TempFP);
-        delete [] row_pointers;
-        png_destroy_write_struct(&png_ptr, &info_ptr);
-        this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
-        return;
-        }
-    }
-
-
-  void *outPtr;
-  outPtr = data->GetScalarPointer(uExtent[0], uExtent[2], uExtent[4]);
-  png_uint_32 width, height;
-  width = uExtent[1] - uExtent[0] + 1;
-  height = uExtent[3] - uExtent[2] + 1;
-  int bit_depth = 8;
-  if (data->GetScalarType() == VTK_UNSIGNED_SHORT)
-    {
-    bit_depth = 16;
+    fp = fopen(fileName, "wb");
+    if (!fp)
+      {
+      png_destroy_write_struct(&png_ptr, &info_ptr);
+      return vtkErrorCode::CannotOpenFileError;
+      }
+    png_init_io(png_ptr, fp);
     }
-  int color_type;
-  switch (data->GetNumberOfScalarComponents())
+  png_set_error_fn(png_ptr, png_ptr,
+                   vtkPNGWriteErrorFunction, vtkPNGWriteWarningFunction);
+  if (setjmp(png_jmpbuf((png_ptr))))
     {
-    case 1: color_type = PNG_COLOR_TYPE_GRAY;
-      break;
-    case 2: color_type = PNG_COLOR_TYPE_GRAY_ALPHA;
-      break;
-    case 3: color_type = PNG_COLOR_TYPE_RGB;
-      break;
-    default: color_type = PNG_COLOR_TYPE_RGB_ALPHA;
-      break;
+    if (fp)
+      {
+      fclose(fp);
+      }
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    return vtkErrorCode::OutOfDiskSpaceError;
     }
 
   png_set_IHDR(png_ptr, info_ptr, width, height,
@@ -306,46 +542,89 @@ void vtkPNGWriter::WriteSlice(vtkImageData *data, int* uExtent)
   //                 PNG_INTERLACE_ADAM7
 
   png_write_info(png_ptr, info_ptr);
-  // default is big endian
-  if (bit_depth > 8)
+  if (banded)
     {
-#ifndef VTK_WORDS_BIGENDIAN
-    png_set_swap(png_ptr);
-#endif
+    // One IDAT chunk per band, then the IEND libpng would have written.
+    static png_byte idat[5] = { 73,  68,  65,  84, '\0' };
+    static png_byte iend[5] = { 73,  69,  78,  68, '\0' };
+    png_byte header[2];
+    png_byte trailer[4];
+    bands.GetHeader(header);
+    bands.GetTrailer(trailer);
+    size_t numberOfBands = bands.Bands.size();
+    for (size_t b = 0; b < numberOfBands; ++b)
+      {
+      std::vector<unsigned char> &band = bands.Bands[b];
+      bool first = b == 0;
+      bool last = b == numberOfBands - 1;
+      png_write_chunk_start(png_ptr, idat, static_cast<png_uint_32>(
+        band.size() + (first ? 2 : 0) + (last ? 4 : 0)));
+      if (first)
+        {
+        png_write_chunk_data(png_ptr, header, 2);
+        }
+      if (!band.empty())
+        {
+        png_write_chunk_data(png_ptr, &band[0], band.size());
+        }
+      if (last)
+        {
+        png_write_chunk_data(png_ptr, trailer, 4);
+        }
+      png_write_chunk_end(png_ptr);
+      }
+    png_write_chunk(png_ptr, iend, NULL, 0);
     }
-  row_pointers = new png_byte *[height];
-  vtkIdType *outInc = data->GetIncrements();
-  vtkIdType rowInc = outInc[1]*bit_depth/8;
-  for (ui = 0; ui < height; ui++)
+  else
     {
-    // computing the offset explicitly in a temporary variable as there seems to
-    // be some bug in intel compilers on longhorn (thanks to Greg Abram) when
-    // the offset is computed directly in the []'s.
-    unsigned int offset = height - ui - 1;
-    row_pointers[offset] = (png_byte *)outPtr;
-    outPtr = (unsigned char *)outPtr + rowInc;
+    // default is big endian
+    if (bit_depth > 8)
+      {
+#ifndef VTK_WORDS_BIGENDIAN
+      png_set_swap(png_ptr);
+#endif
+      }
+    png_write_image(png_ptr, &row_pointers[0]);
+    png_write_end(png_ptr, info_ptr);
     }
-  png_write_image(png_ptr, row_pointers);
-  png_write_end(png_ptr, info_ptr);
 
-  delete [] row_pointers;
   png_destroy_write_struct(&png_ptr, &info_ptr);
 
-  if (this->TempFP)
+  int errorCode = vtkErrorCode::NoError;
+  if (fp)
     {
-    fflush(this->TempFP);
-    if (ferror(this->TempFP))
+    fflush(fp);
+    if (ferror(fp))
       {
-      this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+      errorCode = vtkErrorCode::OutOfDiskSpaceError;
       }
+    fclose(fp);
     }
+  return errorCode;
+}
 
-  if (this->TempFP)
+//----------------------------------------------------------------------------
+void vtkPNGWriter::WriteSlice(vtkImageData *data, int* uExtent)
+{
+  if (!this->WriteToMemory && !this->InternalFileName)
+    {
+    this->SetErrorCode(vtkErrorCode::NoFileNameError);
+    return;
+    }
+  if (!this->CanWriteSlice(data))
+    {
+    return;
+    }
+  int errorCode = this->WriteSlice(
+    this->WriteToMemory ? NULL : this->InternalFileName, data, uExtent);
+  if (errorCode != vtkErrorCode::NoError)
     {
-    fclose(this->TempFP);
+    vtkErrorMacro(<<"Unable to write PNG file!");
+    this->SetErrorCode(errorCode);
     }
 }
 
+//----------------------------------------------------------------------------
 void vtkPNGWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -65,10 +65,24 @@ protected:
   vtkPNGWriter();
   ~vtkPNGWriter();
 
+  // Description:
+  // Compress one slice, to Result if fileName is NULL. Images of more
+  // than a few hundred kilobytes are filtered and deflated in bands of
+  // rows concurrently.
+  virtual int CanWriteSlice(vtkImageData *data);
+  virtual int WriteSlice(const char *fileName, vtkImageData *data,
+                         int uExtent[6]);
+
+  // Description:
+  // Write one slice to InternalFileName, or to Result when writing to
+  // memory, and report any error.
   void WriteSlice(vtkImageData *data, int* uExtent);
+
   int CompressionLevel;
   unsigned int WriteToMemory;
   vtkUnsignedCharArray *Result;
+  // Slices are written concurrently, each to a FILE of its own, so this
+  // is no longer used and stays NULL.
   FILE *TempFP;
 
 private:
@@ -19,70 +19,17 @@
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 extern "C" {
 #include "vtk_tiff.h"
 }
 
-namespace {
-struct FlipTrue {};
-struct FlipFalse {};
-
-int GetFileRow(int row, int height, FlipTrue)
-{
-  return height - row - 1;
-}
-
-int GetFileRow(int row, int, FlipFalse)
-{
-  return row;
-}
-
-// Simple scan line copy of a slice in a volume with tightly packed memory.
-template<typename T, typename Flip>
-bool ReadTemplatedImage(T* out, Flip flip,
-                        int startCol, int endCol,
-                        int startRow, int endRow,
-                        int yIncrements,
-                        unsigned int height, TIFF *image)
-{
-  unsigned int isize = TIFFScanlineSize(image);
-  size_t scanLineSize = endCol - startCol + 1;
-  if (scanLineSize * sizeof(T) == isize)
-    {
-    // We can copy straight into the image data output.
-    for (int i = startRow; i <= endRow; ++i)
-      {
-      T* tmp = out + (i - startRow) * yIncrements;
-      if (TIFFReadScanline(image, tmp, GetFileRow(i, height, flip), 0) <= 0)
-        {
-        return false;
-        }
-      }
-    }
-  else
-    {
-    // Copy into a buffer of the appropriate size, then subset into the output.
-    tdata_t buf = _TIFFmalloc(isize);
-    for (int i = startRow; i <= endRow; ++i)
-      {
-      T* tmp = out + (i - startRow) * yIncrements;
-      if (TIFFReadScanline(image, buf, GetFileRow(i, height, flip), 0) <= 0)
-        {
-        _TIFFfree(buf);
-        return false;
-        }
-      memcpy(tmp, static_cast<T*>(buf) + startCol, sizeof(T) * scanLineSize);
-      }
-    _TIFFfree(buf);
-    }
-  return true;
-}
-}
-
 //-------------------------------------------------------------------------
 vtkStandardNewMacro(vtkTIFFReader)
 
@@ -345,6 +292,259 @@ bool vtkTIFFReader::vtkTIFFReaderInternal::CanRead()
              this->BitsPerSample == 32) );
 }
 
+//-------------------------------------------------------------------------
+// The strips or tiles of one or more TIFF directories that intersect the
+// output extent, and where each of them lands in the output.
+class vtkTIFFReader::BlockList
+{
+public:
+  // A directory decoded into one slice of the output.
+  struct Slice
+  {
+    tdir_t Directory;
+    bool Tiled;
+    uint32 BlockWidth; // pixels per row of a decoded strip or tile
+    tsize_t BlockSize;
+    vtkIdType Offset;  // of the slice in the output, in scalars
+  };
+
+  // A strip or tile. Decoded row i lands on output row Y - i when the
+  // list is flipped and Y + i otherwise, starting at output column X.
+  struct Block
+  {
+    size_t Slice;
+    uint32 Index;
+    int X;
+    int Y;
+    int Columns;
+    int Rows;
+  };
+
+  BlockList(bool flip) : Flip(flip), MaxBlockSize(0) {}
+
+  // Description:
+  // Adds the blocks of the current directory of image that intersect the
+  // x/y range of extent. Returns false if the directory does not have the
+  // expected dimensions or its layout cannot be read.
+  bool AddDirectory(TIFF *image, uint32 width, uint32 height,
+                    const int extent[6], vtkIdType offset)
+  {
+    uint32 w = 0;
+    uint32 h = 0;
+    if (!TIFFGetField(image, TIFFTAG_IMAGEWIDTH, &w) ||
+        !TIFFGetField(image, TIFFTAG_IMAGELENGTH, &h) ||
+        w != width || h != height)
+      {
+      return false;
+      }
+
+    Slice slice;
+    slice.Directory = TIFFCurrentDirectory(image);
+    slice.Tiled = TIFFIsTiled(image) != 0;
+    slice.Offset = offset;
+    uint32 blockHeight = 0;
+    if (slice.Tiled)
+      {
+      if (!TIFFGetField(image, TIFFTAG_TILEWIDTH, &slice.BlockWidth) ||
+          !TIFFGetField(image, TIFFTAG_TILELENGTH, &blockHeight))
+        {
+        return false;
+        }
+      slice.BlockSize = TIFFTileSize(image);
+      }
+    else
+      {
+      slice.BlockWidth = width;
+      TIFFGetFieldDefaulted(image, TIFFTAG_ROWSPERSTRIP, &blockHeight);
+      blockHeight = std::min(blockHeight, height);
+      slice.BlockSize = TIFFStripSize(image);
+      }
+    if (slice.BlockWidth == 0 || blockHeight == 0 || slice.BlockSize <= 0)
+      {
+      return false;
+      }
+
+    // The file rows and columns covered by the extent.
+    uint32 firstRow = this->Flip ? height - 1 - extent[3] : extent[2];
+    uint32 lastRow = this->Flip ? height - 1 - extent[2] : extent[3];
+    uint32 firstColumn = slice.Tiled ? extent[0] : 0;
+    uint32 lastColumn = slice.Tiled ? extent[1] : 0;
+    uint32 blocksAcross = (width + slice.BlockWidth - 1) / slice.BlockWidth;
+
+    for (uint32 by = firstRow / blockHeight; by <= lastRow / blockHeight; ++by)
+      {
+      for (uint32 bx = firstColumn / slice.BlockWidth;
+           bx <= lastColumn / slice.BlockWidth; ++bx)
+        {
+        uint32 fileRow = by * blockHeight;
+        Block block;
+        block.Slice = this->Slices.size();
+        block.Index = by * blocksAcross + bx;
+        block.X = bx * slice.BlockWidth;
+        block.Y = this->Flip ? height - 1 - fileRow : fileRow;
+        block.Columns = std::min(slice.BlockWidth, width - block.X);
+        block.Rows = std::min(blockHeight, height - fileRow);
+        this->Blocks.push_back(block);
+        }
+      }
+    this->Slices.push_back(slice);
+    this->MaxBlockSize = std::max(this->MaxBlockSize, slice.BlockSize);
+    return true;
+  }
+
+  // Description:
+  // Adds the tiles of the current directory of image that fall in the
+  // z range of extent, each tile being a slice of its own. Tiles are
+  // numbered column by column, as ExecuteInformation exposes them.
+  bool AddTilesAsSlices(TIFF *image, uint32 width, uint32 height,
+                        uint32 tileWidth, uint32 tileHeight,
+                        const int extent[6], vtkIdType sliceIncrement)
+  {
+    if (tileWidth == 0 || tileHeight == 0)
+      {
+      return false;
+      }
+    uint32 tilesAcross = (width + tileWidth - 1) / tileWidth;
+    uint32 tilesDown = (height + tileHeight - 1) / tileHeight;
+
+    Slice slice;
+    slice.Directory = TIFFCurrentDirectory(image);
+    slice.Tiled = true;
+    slice.BlockWidth = tileWidth;
+    slice.BlockSize = TIFFTileSize(image);
+    for (int k = extent[4]; k <= extent[5]; ++k)
+      {
+      slice.Offset = (k - extent[4]) * sliceIncrement;
+      Block block;
+      block.Slice = this->Slices.size();
+      block.Index = (k % tilesDown) * tilesAcross + k / tilesDown;
+      block.X = 0;
+      block.Y = 0;
+      block.Columns = tileWidth;
+      block.Rows = tileHeight;
+      this->Blocks.push_back(block);
+      this->Slices.push_back(slice);
+      }
+    this->MaxBlockSize = std::max(this->MaxBlockSize, slice.BlockSize);
+    return true;
+  }
+
+  std::vector<Slice> Slices;
+  std::vector<Block> Blocks;
+  bool Flip;
+  tsize_t MaxBlockSize;
+};
+
+//-------------------------------------------------------------------------
+// Decodes a range of the blocks of a BlockList into the output. libtiff
+// handles cannot be shared between threads, so a range that is not the
+// whole list is decoded through a handle of its own.
+template<typename T>
+class vtkTIFFReader::BlockDecoder
+{
+public:
+  vtkTIFFReader *Reader;
+  const BlockList *List;
+  const char *FileName;
+  TIFF *Image;
+  T *Output;
+  bool Copy;
+  char *Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const BlockList &list = *this->List;
+    vtkIdType numberOfBlocks = static_cast<vtkIdType>(list.Blocks.size());
+    TIFF *image = this->Image;
+    if (begin != 0 || end != numberOfBlocks)
+      {
+      image = TIFFOpen(this->FileName, "r");
+      }
+    if (!image)
+      {
+      std::fill(this->Failed + begin, this->Failed + end, 1);
+      return;
+      }
+
+    const int *extent = this->Reader->OutputExtent;
+    const vtkIdType *increments = this->Reader->OutputIncrements;
+    int samples = this->Reader->InternalImage->SamplesPerPixel;
+    int copySamples = std::min(samples, static_cast<int>(increments[0]));
+    tdata_t buffer = _TIFFmalloc(list.MaxBlockSize);
+    tdir_t current = TIFFCurrentDirectory(image);
+
+    for (vtkIdType b = begin; b < end; ++b)
+      {
+      const typename BlockList::Block &block = list.Blocks[b];
+      const typename BlockList::Slice &slice = list.Slices[block.Slice];
+      if (slice.Directory != current)
+        {
+        int status = slice.Directory == current + 1 ?
+          TIFFReadDirectory(image) : TIFFSetDirectory(image, slice.Directory);
+        current = status ? slice.Directory : static_cast<tdir_t>(-1);
+        if (!status)
+          {
+          this->Failed[b] = 1;
+          continue;
+          }
+        }
+
+      tsize_t size = slice.Tiled ?
+        TIFFReadEncodedTile(image, block.Index, buffer, slice.BlockSize) :
+        TIFFReadEncodedStrip(image, block.Index, buffer, slice.BlockSize);
+      if (size < static_cast<tsize_t>(block.Rows * slice.BlockWidth *
+                                      samples * sizeof(T)))
+        {
+        this->Failed[b] = 1;
+        continue;
+        }
+
+      int x0 = std::max(block.X, extent[0]);
+      int x1 = std::min(block.X + block.Columns - 1, extent[1]);
+      for (int i = 0; i < block.Rows && x0 <= x1; ++i)
+        {
+        int y = list.Flip ? block.Y - i : block.Y + i;
+        if (y < extent[2] || y > extent[3])
+          {
+          continue;
+          }
+        T *in = static_cast<T*>(buffer) +
+          (static_cast<vtkIdType>(i) * slice.BlockWidth + x0 - block.X) * samples;
+        T *out = this->Output + slice.Offset +
+          (y - extent[2]) * increments[1] + (x0 - extent[0]) * increments[0];
+        if (this->Copy && increments[0] == samples)
+          {
+          memcpy(out, in, sizeof(T) * samples * (x1 - x0 + 1));
+          }
+        else if (this->Copy)
+          {
+          for (int x = x0; x <= x1; ++x)
+            {
+            std::copy(in, in + copySamples, out);
+            in += samples;
+            out += increments[0];
+            }
+          }
+        else
+          {
+          for (int x = x0; x <= x1; ++x)
+            {
+            this->Reader->EvaluateImageAt(out, in);
+            in += samples;
+            out += increments[0];
+            }
+          }
+        }
+      }
+
+    _TIFFfree(buffer);
+    if (image != this->Image)
+      {
+      TIFFClose(image);
+      }
+  }
+};
+
 //-------------------------------------------------------------------------
 vtkTIFFReader::vtkTIFFReader()
 {
@@ -581,33 +781,11 @@ void vtkTIFFReader::SetOrientationType( unsigned int orientationType )
   this->OrientationTypeSpecifiedFlag = true;
 }
 
-//-------------------------------------------------------------------------
-template <class OT>
-void vtkTIFFReader::Process2(OT *outPtr, int *)
-{
-  if (!this->InternalImage->Open(this->GetInternalFileName()))
-    {
-    return;
-    }
-  // if orientation information is provided, overwrite the value
-  // read from the tiff image
-  if (this->GetOrientationTypeSpecifiedFlag())
-    {
-    this->InternalImage->Orientation = this->GetOrientationType();
-    }
-
-  this->Initialize();
-  this->ReadImageInternal(outPtr);
-
-  // Close the file
-  this->InternalImage->Clean();
-}
-
 //----------------------------------------------------------------------------
 // This function reads in one data of data.
 // templated to handle different data types.
 template <class OT>
-void vtkTIFFReader::Process(OT *outPtr, int outExtent[6], vtkIdType outIncr[3])
+void vtkTIFFReader::Process(OT *outPtr)
 {
   // multiple number of pages
   if (this->InternalImage->NumberOfPages > 1)
@@ -622,22 +800,42 @@ void vtkTIFFReader::Process(OT *outPtr, int outExtent[6], vtkIdType outIncr[3])
     this->ReadTiles(outPtr);
     return;
     }
+}
 
-  // The input tiff dataset is neither multiple pages and nor
-  // tiled. Hence close the image and start reading each TIFF
-  // file
-  this->InternalImage->Clean();
-
-  OT *outPtr2 = outPtr;
-  for (int idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+//----------------------------------------------------------------------------
+int vtkTIFFReader::ReadSlice(const char *fileName, int, vtkImageData *data,
+                             void *outPtr)
+{
+  // The libtiff handle and the colormap are state of the file being read,
+  // so every slice is decoded by a reader of its own.
+  vtkTIFFReader *reader = vtkTIFFReader::New();
+  reader->SetFileName(fileName);
+  reader->ComputeInternalFileName(0);
+  reader->DataScalarType = this->DataScalarType;
+  memcpy(reader->OutputExtent, this->OutputExtent, sizeof(this->OutputExtent));
+  memcpy(reader->OutputIncrements, this->OutputIncrements,
+         sizeof(this->OutputIncrements));
+
+  int status = 0;
+  if (reader->InternalImage->Open(fileName))
     {
-    this->ComputeInternalFileName(idx2);
-    // read in a TIFF file
-    this->Process2(outPtr2, outExtent);
-    this->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    // if orientation information is provided, overwrite the value
+    // read from the tiff image
+    if (this->GetOrientationTypeSpecifiedFlag())
+      {
+      reader->InternalImage->Orientation = this->GetOrientationType();
+      }
+
+    reader->Initialize();
+    switch (data->GetScalarType())
+      {
+      vtkTemplateMacro(reader->ReadImageInternal(static_cast<VTK_TT*>(outPtr)));
+      }
+    reader->InternalImage->Clean();
+    status = 1;
     }
+  reader->Delete();
+  return status;
 }
 
 
@@ -660,15 +858,26 @@ void vtkTIFFReader::ExecuteDataWithInformation(vtkDataObject *output,
   data->GetExtent(this->OutputExtent);
   data->GetIncrements(this->OutputIncrements);
 
-  // Call the correct templated function for the input
-  void *outPtr = data->GetScalarPointer();
+  if (this->InternalImage->NumberOfPages > 1 ||
+      this->InternalImage->NumberOfTiles > 0)
+    {
+    // Call the correct templated function for the input
+    void *outPtr = data->GetScalarPointer();
 
-  switch (data->GetScalarType())
+    switch (data->GetScalarType())
+      {
+      vtkTemplateMacro(this->Process((VTK_TT *)(outPtr)));
+      default:
+        vtkErrorMacro("UpdateFromFile: Unknown data type");
+      }
+    }
+  else
     {
-    vtkTemplateMacro(this->Process((VTK_TT *)(outPtr),
-                                  this->OutputExtent, this->OutputIncrements));
-    default:
-      vtkErrorMacro("UpdateFromFile: Unknown data type");
+    // The input tiff dataset is neither multiple pages and nor
+    // tiled. Hence close the image and decode each TIFF file,
+    // concurrently.
+    this->InternalImage->Clean();
+    this->ReadSlices(data);
     }
   data->GetPointData()->GetScalars()->SetName("Tiff Scalars");
 }
@@ -799,56 +1008,76 @@ void vtkTIFFReader::ReadVolume(T* buffer)
 {
   int width  = this->InternalImage->Width;
   int height = this->InternalImage->Height;
-  unsigned int npages = this->InternalImage->NumberOfPages;
-  if (this->InternalImage->SubFiles > 0)
+  TIFF *image = this->InternalImage->Image;
+
+  // Look up the colormap before leaving the first directory.
+  unsigned int format = this->GetFormat();
+
+  // Find the directories of the requested slices. When the file contains
+  // subfiles, only the full resolution images are slices (see
+  // ExecuteInformation).
+  std::vector<tdir_t> directories;
+  if (!TIFFSetDirectory(image, 0))
     {
-    // See ExecuteInformation
-    npages = this->InternalImage->SubFiles;
+    vtkErrorMacro(<< "Cannot read the first directory of the TIFF file.");
+    return;
     }
-
-  for (unsigned int page = 0; page < npages; ++page)
+  int slice = 0;
+  tdir_t directory = 0;
+  do
     {
-    this->UpdateProgress(static_cast<double>(page + 1) / npages);
-    if (this->InternalImage->SubFiles > 0)
+    uint32 subfiletype = 0;
+    if (this->InternalImage->SubFiles == 0 ||
+        !TIFFGetField(image, TIFFTAG_SUBFILETYPE, &subfiletype) ||
+        subfiletype == 0)
       {
-      long subfiletype = 6;
-      if (TIFFGetField(this->InternalImage->Image, TIFFTAG_SUBFILETYPE,
-                       &subfiletype))
+      if (slice >= this->OutputExtent[4])
         {
-        if (subfiletype != 0)
-          {
-          TIFFReadDirectory(this->InternalImage->Image);
-          continue;
-          }
+        directories.push_back(directory);
         }
+      ++slice;
       }
+    ++directory;
+    }
+  while (slice <= this->OutputExtent[5] && TIFFReadDirectory(image));
 
-    // if we have a Zeiss image meaning that the SamplesPerPixel is 2
-    if (this->InternalImage->SamplesPerPixel == 2)
-      {
-      T* volume = buffer;
-      volume += width * height * this->InternalImage->SamplesPerPixel * page;
-      this->ReadTwoSamplesPerPixelImage(volume, width, height);
-      break;
-      }
-    else if (!this->InternalImage->CanRead())
+  if (static_cast<int>(directories.size()) !=
+      this->OutputExtent[5] - this->OutputExtent[4] + 1)
+    {
+    vtkErrorMacro(<< "Cannot find slice "
+                  << this->OutputExtent[4] + directories.size()
+                  << " in TIFF file.");
+    return;
+    }
+
+  // if we have a Zeiss image meaning that the SamplesPerPixel is 2
+  if (this->InternalImage->SamplesPerPixel == 2)
+    {
+    TIFFSetDirectory(image, directories[0]);
+    this->ReadTwoSamplesPerPixelImage(buffer, width, height);
+    return;
+    }
+
+  if (!this->InternalImage->CanRead())
+    {
+    uint32 *tempImage = new uint32[width * height];
+    for (size_t i = 0; i < directories.size(); ++i)
       {
-      uint32 *tempImage = new uint32[width * height];
-      if (!TIFFReadRGBAImage(this->InternalImage->Image,
-                             width, height,
-                             tempImage, 1))
+      this->UpdateProgress(static_cast<double>(i + 1) / directories.size());
+      if (!TIFFSetDirectory(image, directories[i]) ||
+          !TIFFReadRGBAImage(image, width, height, tempImage, 1))
         {
         vtkErrorMacro( << "Cannot read TIFF image or as a TIFF RGBA image" );
-        delete [] tempImage;
-        return;
+        break;
         }
 
-      T* fimage = buffer;
-      fimage += width * height * 4 * page;
-      for (int yy = 0; yy < height; ++yy)
+      for (int yy = this->OutputExtent[2]; yy <= this->OutputExtent[3]; ++yy)
         {
-        uint32* ssimage = tempImage + (height - yy - 1) * width;
-        for (int xx = 0; xx < width; ++xx)
+        T* fimage = buffer + i * this->OutputIncrements[2] +
+          (yy - this->OutputExtent[2]) * this->OutputIncrements[1];
+        uint32* ssimage = tempImage + (height - yy - 1) * width +
+          this->OutputExtent[0];
+        for (int xx = this->OutputExtent[0]; xx <= this->OutputExtent[1]; ++xx)
           {
           *(fimage    ) = static_cast<T>(TIFFGetR(*ssimage)); // Red
           *(fimage + 1) = static_cast<T>(TIFFGetG(*ssimage)); // Green
@@ -858,69 +1087,107 @@ void vtkTIFFReader::ReadVolume(T* buffer)
           ++ssimage;
           }
         }
-      delete [] tempImage;
-      tempImage = 0;
       }
-    else
+    delete [] tempImage;
+    return;
+    }
+
+  switch (format)
+    {
+    case vtkTIFFReader::GRAYSCALE:
+    case vtkTIFFReader::RGB:
+    case vtkTIFFReader::PALETTE_RGB:
+    case vtkTIFFReader::PALETTE_GRAYSCALE:
+      break;
+    default:
+      return;
+    }
+
+  // Gather the strips or tiles of all the slices so that they are decoded
+  // together rather than one page at a time.
+  BlockList blocks(this->InternalImage->Orientation != ORIENTATION_TOPLEFT);
+  for (size_t i = 0; i < directories.size(); ++i)
+    {
+    if (!TIFFSetDirectory(image, directories[i]) ||
+        !blocks.AddDirectory(image, width, height, this->OutputExtent,
+                             i * this->OutputIncrements[2]))
       {
-      unsigned int format = this->GetFormat();
-      switch (format)
-        {
-        case vtkTIFFReader::GRAYSCALE:
-        case vtkTIFFReader::RGB:
-        case vtkTIFFReader::PALETTE_RGB:
-        case vtkTIFFReader::PALETTE_GRAYSCALE:
-          {
-          T* volume = buffer;
-          volume += width * height * this->InternalImage->SamplesPerPixel * page;
-          this->ReadGenericImage(volume, width, height);
-          break;
-          }
-        default:
-          return;
-        }
+      vtkErrorMacro(<< "Problem reading slice " << this->OutputExtent[4] + i
+                    << " of volume in TIFF file.");
+      return;
       }
-    TIFFReadDirectory(this->InternalImage->Image);
     }
+  this->ReadBlocks(buffer, blocks, this->IsVerbatim(format));
 }
 
 /** Read a tiled tiff */
-void vtkTIFFReader::ReadTiles(void* buffer)
+template<typename T>
+void vtkTIFFReader::ReadTiles(T* buffer)
 {
-  unsigned char* volume = reinterpret_cast<unsigned char*>(buffer);
+  BlockList blocks(false);
+  if (!blocks.AddTilesAsSlices(this->InternalImage->Image,
+                               this->InternalImage->Width,
+                               this->InternalImage->Height,
+                               this->InternalImage->TileWidth,
+                               this->InternalImage->TileHeight,
+                               this->OutputExtent, this->OutputIncrements[2]))
+    {
+    vtkErrorMacro(<< "Cannot read tile width and tile length from file");
+    return;
+    }
+  this->ReadBlocks(buffer, blocks, true);
+}
 
-  for (unsigned int col = 0; col < this->InternalImage->Width;
-       col += this->InternalImage->TileWidth)
+//-------------------------------------------------------------------------
+template<typename T>
+bool vtkTIFFReader::ReadBlocks(T* out, const BlockList& blocks, bool copy)
+{
+  vtkIdType numberOfBlocks = static_cast<vtkIdType>(blocks.Blocks.size());
+  if (numberOfBlocks == 0)
     {
-    for (unsigned int row = 0; row < this->InternalImage->Height;
-         row += this->InternalImage->TileHeight)
-      {
-      unsigned char *tempImage
-              = new unsigned char[this->InternalImage->TileWidth *
-                                  this->InternalImage->TileHeight *
-                                  this->InternalImage->SamplesPerPixel];
+    return true;
+    }
 
-      if (TIFFReadTile(this->InternalImage->Image, tempImage, col, row, 0, 0) < 0)
-        {
-        vtkErrorMacro(<< "Cannot read tile : "<< row << "," << col << " from file");
-        delete [] tempImage;
-        return;
-        }
+  std::vector<char> failed(numberOfBlocks, 0);
+  BlockDecoder<T> decoder;
+  decoder.Reader = this;
+  decoder.List = &blocks;
+  decoder.FileName = this->GetInternalFileName();
+  decoder.Image = this->InternalImage->Image;
+  decoder.Output = out;
+  decoder.Copy = copy;
+  decoder.Failed = &failed[0];
+
+  // EvaluateImageAt looks the colormap up lazily, and reports errors when
+  // it is missing; keep that on this thread.
+  unsigned int format = this->GetFormat();
+  if (!copy && !this->ColorRed &&
+      (format == vtkTIFFReader::PALETTE_RGB ||
+       format == vtkTIFFReader::PALETTE_GRAYSCALE))
+    {
+    decoder(0, numberOfBlocks);
+    }
+  else
+    {
+    // Hand out about a megabyte of decoded data at a time, each chunk
+    // paying for opening the file once.
+    vtkIdType grain = std::max<vtkIdType>(1, (1 << 20) / blocks.MaxBlockSize);
+    vtkSMPTools::For(0, numberOfBlocks, grain, decoder);
+    }
 
-      for (unsigned int yy = 0; yy < this->InternalImage->TileHeight; ++yy)
-        {
-        for (unsigned int xx = 0; xx <  this->InternalImage->TileWidth; ++xx)
-          {
-          for (unsigned int i = 0; i < this->InternalImage->SamplesPerPixel; ++i)
-            {
-            *volume = *(tempImage++);
-            ++volume;
-            }
-          }
-        }
-      delete [] tempImage;
+  for (vtkIdType b = 0; b < numberOfBlocks; ++b)
+    {
+    if (failed[b])
+      {
+      const typename BlockList::Block &block = blocks.Blocks[b];
+      const typename BlockList::Slice &slice = blocks.Slices[block.Slice];
+      vtkErrorMacro(<< "Cannot read " << (slice.Tiled ? "tile " : "strip ")
+                    << block.Index << " of directory " << slice.Directory
+                    << " from file");
+      return false;
       }
     }
+  return true;
 }
 
 /** To Support Zeiss images that contains only 2 samples per pixel but are actually
@@ -1079,121 +1346,35 @@ void vtkTIFFReader::ReadTwoSamplesPerPixelImage(void *out,
 }
 
 template<typename T>
-void vtkTIFFReader::ReadGenericImage(T* out, unsigned int, unsigned int height)
+void vtkTIFFReader::ReadGenericImage(T* out, unsigned int width,
+                                     unsigned int height)
 {
-  // Fast path for simple images
-  unsigned int format = this->GetFormat();
-  if (this->InternalImage->PlanarConfig == PLANARCONFIG_CONTIG &&
-      this->OutputIncrements[0] == 1 &&
-      (format == vtkTIFFReader::GRAYSCALE &&
-       this->InternalImage->Photometrics == PHOTOMETRIC_MINISBLACK &&
-       this->InternalImage->SamplesPerPixel ==  1))
-    {
-    if (this->InternalImage->Orientation == ORIENTATION_TOPLEFT)
-      {
-      FlipFalse flip;
-      if (!ReadTemplatedImage(out, flip,
-                              this->OutputExtent[0], this->OutputExtent[1],
-                              this->OutputExtent[2], this->OutputExtent[3],
-                              this->OutputIncrements[1],
-                              height, this->InternalImage->Image))
-        {
-        vtkErrorMacro(<< "Problem reading slice of volume in TIFF file.");
-        }
-      }
-    else
-      {
-      FlipTrue flip;
-      if (!ReadTemplatedImage(out, flip,
-                              this->OutputExtent[0], this->OutputExtent[1],
-                              this->OutputExtent[2], this->OutputExtent[3],
-                              this->OutputIncrements[1],
-                              height, this->InternalImage->Image))
-        {
-        vtkErrorMacro(<< "Problem reading slice of volume in TIFF file.");
-        }
-      }
-    return;
-    }
-
-  unsigned int isize = TIFFScanlineSize(this->InternalImage->Image);
-  tdata_t buf = _TIFFmalloc(isize);
-
   if (this->InternalImage->PlanarConfig != PLANARCONFIG_CONTIG)
     {
     vtkErrorMacro(<< "This reader can only do PLANARCONFIG_CONTIG");
     return;
     }
 
-  T* image;
-  if (this->InternalImage->PlanarConfig == PLANARCONFIG_CONTIG)
+  BlockList blocks(this->InternalImage->Orientation != ORIENTATION_TOPLEFT);
+  if (!blocks.AddDirectory(this->InternalImage->Image, width, height,
+                           this->OutputExtent, 0))
     {
-    int fileRow = 0;
-    for (int row = this->OutputExtent[2]; row <= this->OutputExtent[3]; ++row)
-      {
-      // Flip from lower left origin to upper left if necessary.
-      if (this->InternalImage->Orientation == ORIENTATION_TOPLEFT)
-        {
-        fileRow = row;
-        }
-      else
-        {
-        fileRow = height - row - 1;
-        }
-      if (TIFFReadScanline(this->InternalImage->Image, buf, fileRow, 0) <= 0)
-        {
-        vtkErrorMacro(<< "Problem reading the row: " << fileRow);
-        break;
-        }
-      image = out + (row - this->OutputExtent[2]) * this->OutputIncrements[1];
-
-      // Copy the pixels into the output buffer
-      unsigned int cc = this->OutputExtent[0] * this->InternalImage->SamplesPerPixel;
-      for (int ix = this->OutputExtent[0]; ix <= this->OutputExtent[1]; ++ix)
-        {
-        this->EvaluateImageAt(image, static_cast<T*>(buf) + cc);
-        image += this->OutputIncrements[0];
-        cc += this->InternalImage->SamplesPerPixel;
-        }
-      }
-    }
-  else if(this->InternalImage->PlanarConfig == PLANARCONFIG_SEPARATE)
-    {
-    int fileRow = 0;
-    unsigned long nsamples;
-    TIFFGetField(this->InternalImage->Image, TIFFTAG_SAMPLESPERPIXEL, &nsamples);
-    for (unsigned long s = 0; s < nsamples; ++s)
-      {
-      for (int row = this->OutputExtent[2]; row <= this->OutputExtent[3]; ++row)
-        {
-        if (this->InternalImage->Orientation == ORIENTATION_TOPLEFT)
-          {
-          fileRow = row;
-          }
-        else
-          {
-          fileRow = height - row - 1;
-          }
-        if (TIFFReadScanline(this->InternalImage->Image, buf, fileRow, s) <= 0)
-          {
-          vtkErrorMacro( << "Problem reading the row: " << fileRow );
-          break;
-          }
-
-        image = out + (row-this->OutputExtent[2])*this->OutputIncrements[1];
-        unsigned int  cc = this->OutputExtent[0] * this->InternalImage->SamplesPerPixel;
-        for (int ix = this->OutputExtent[0]; ix <= this->OutputExtent[1]; ++ix)
-          {
-          this->EvaluateImageAt(image, static_cast<T*>(buf) + cc);
-          image += this->OutputIncrements[0];
-          cc += this->InternalImage->SamplesPerPixel;
-          }
-        }
-      }
+    vtkErrorMacro(<< "Problem reading slice of volume in TIFF file.");
+    return;
     }
-  _TIFFfree(buf);
+  this->ReadBlocks(out, blocks, this->IsVerbatim(this->GetFormat()));
 }
 
+//-------------------------------------------------------------------------
+bool vtkTIFFReader::IsVerbatim(unsigned int format)
+{
+  // Samples that EvaluateImageAt would copy unchanged.
+  return this->InternalImage->PlanarConfig == PLANARCONFIG_CONTIG &&
+    this->OutputIncrements[0] == 1 &&
+    format == vtkTIFFReader::GRAYSCALE &&
+    this->InternalImage->Photometrics == PHOTOMETRIC_MINISBLACK &&
+    this->InternalImage->SamplesPerPixel == 1;
+}
 
 //-------------------------------------------------------------------------
 template<typename T>
@@ -17,6 +17,10 @@
 // vtkTIFFReader is a source object that reads TIFF files.
 // It should be able to read almost any TIFF file
 //
+// Strips and tiles are decoded concurrently with vtkSMPTools, and only the
+// strips, tiles and pages that intersect the requested update extent are
+// read, so large images and stacks can be streamed.
+//
 // .SECTION See Also
 // vtkTIFFWriter
 
@@ -91,6 +95,8 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSlice(const char *fileName, int slice, vtkImageData *data,
+                        void *outPtr);
 
 private:
   vtkTIFFReader(const vtkTIFFReader&);  // Not implemented.
@@ -129,7 +135,8 @@ private:
 
   // Description:
   // Reads 3D data from tiled tiff
-  void ReadTiles(void* buffer);
+  template<typename T>
+  void ReadTiles(T* buffer);
 
   // Description:
   // Reads a generic image.
@@ -137,14 +144,23 @@ private:
   void ReadGenericImage(T* out, unsigned int width, unsigned int height);
 
   // Description:
-  // Dispatch template to determine pixel type and decide on reader actions.
-  template <typename T>
-  void Process(T *outPtr, int outExtent[6], vtkIdType outIncr[3]);
+  // Decodes the strips or tiles gathered in a block list into the output,
+  // concurrently. When copy is true the samples are copied verbatim,
+  // otherwise each pixel goes through EvaluateImageAt.
+  class BlockList;
+  template<typename T> class BlockDecoder;
+  template<typename T>
+  bool ReadBlocks(T* out, const BlockList& blocks, bool copy);
+
+  // Description:
+  // Whether the samples of an image of the given format can be copied
+  // into the output as they are decoded.
+  bool IsVerbatim(unsigned int format);
 
   // Description:
-  // Second layer of dispatch necessary for some TIFF types.
+  // Dispatch template to determine pixel type and decide on reader actions.
   template <typename T>
-  void Process2(T *outPtr, int *outExt);
+  void Process(T *outPtr);
 
   class vtkTIFFReaderInternal;
 
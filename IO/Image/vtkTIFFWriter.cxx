@@ -18,7 +18,11 @@
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtk_tiff.h"
+#include "vtk_zlib.h"
+
+#include <vector>
 
 vtkStandardNewMacro(vtkTIFFWriter);
 
@@ -211,6 +215,126 @@ void vtkTIFFWriter::WriteFileHeader(ofstream *file, vtkImageData *data, int wExt
     }
 }
 
+//----------------------------------------------------------------------------
+// Compresses strips of rows, top row first, the way libtiff's none,
+// PackBits and deflate codecs would. None of them carries state from one
+// strip to the next, so the strips can be compressed concurrently and
+// written with TIFFWriteRawStrip.
+class vtkTIFFWriterStripEncoder
+{
+public:
+  vtkImageData *Data;
+  int *Extent;
+  int Compression;
+  int BytesPerSample;
+  int SamplesPerPixel;
+  vtkIdType RowsPerStrip;
+  vtkIdType NumberOfRows;
+  std::vector<std::vector<unsigned char> > *Strips;
+  char *Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    int height = this->Extent[3] - this->Extent[2] + 1;
+    size_t rowSize = static_cast<size_t>(this->Extent[1] - this->Extent[0] + 1) *
+      this->SamplesPerPixel * this->BytesPerSample;
+    std::vector<unsigned char> rows;
+    for (vtkIdType s = begin; s < end; ++s)
+      {
+      vtkIdType first = s * this->RowsPerStrip;
+      vtkIdType last = first + this->RowsPerStrip;
+      if (last > this->NumberOfRows)
+        {
+        last = this->NumberOfRows;
+        }
+      std::vector<unsigned char> &strip = (*this->Strips)[s];
+      strip.clear();
+      rows.resize((last - first) * rowSize);
+      for (vtkIdType r = first; r < last; ++r)
+        {
+        const unsigned char *row = static_cast<unsigned char *>(
+          this->Data->GetScalarPointer(this->Extent[0],
+            this->Extent[3] - static_cast<int>(r % height),
+            this->Extent[4] + static_cast<int>(r / height)));
+        unsigned char *out = &rows[(r - first) * rowSize];
+        memcpy(out, row, rowSize);
+        if (this->Compression == vtkTIFFWriter::PackBits)
+          {
+          vtkTIFFWriterStripEncoder::PackBits(out, rowSize, strip);
+          }
+        else if (this->Compression == vtkTIFFWriter::Deflate)
+          {
+          this->Difference(out, rowSize);
+          }
+        }
+      if (this->Compression == vtkTIFFWriter::NoCompression)
+        {
+        strip.swap(rows);
+        }
+      else if (this->Compression == vtkTIFFWriter::Deflate)
+        {
+        uLongf size = compressBound(static_cast<uLong>(rows.size()));
+        strip.resize(size);
+        this->Failed[s] = compress2(&strip[0], &size, &rows[0],
+          static_cast<uLong>(rows.size()), Z_DEFAULT_COMPRESSION) != Z_OK;
+        strip.resize(size);
+        }
+      }
+  }
+
+  // The horizontal differencing of TIFFTAG_PREDICTOR 2.
+  void Difference(unsigned char *row, size_t rowSize) const
+  {
+    size_t stride = this->SamplesPerPixel;
+    if (this->BytesPerSample == 2)
+      {
+      uint16 *samples = reinterpret_cast<uint16 *>(row);
+      for (size_t i = rowSize / 2 - 1; i >= stride; --i)
+        {
+        samples[i] = static_cast<uint16>(samples[i] - samples[i - stride]);
+        }
+      }
+    else
+      {
+      for (size_t i = rowSize - 1; i >= stride; --i)
+        {
+        row[i] = static_cast<unsigned char>(row[i] - row[i - stride]);
+        }
+      }
+  }
+
+  // Appends one PackBits encoded row, runs of two or more bytes become a
+  // repeat and literals stop at a run of three.
+  static void PackBits(const unsigned char *row, size_t n,
+                       std::vector<unsigned char> &out)
+  {
+    size_t i = 0;
+    while (i < n)
+      {
+      size_t run = 1;
+      while (i + run < n && run < 128 && row[i + run] == row[i])
+        {
+        ++run;
+        }
+      if (run >= 2)
+        {
+        out.push_back(static_cast<unsigned char>(257 - run));
+        out.push_back(row[i]);
+        i += run;
+        continue;
+        }
+      size_t start = i;
+      while (i < n && i - start < 128 &&
+             !(i + 2 < n && row[i] == row[i + 1] && row[i] == row[i + 2]))
+        {
+        ++i;
+        }
+      out.push_back(static_cast<unsigned char>(i - start - 1));
+      out.insert(out.end(), row + start, row + i);
+      }
+  }
+};
+
 //----------------------------------------------------------------------------
 void vtkTIFFWriter::WriteFile(ofstream *, vtkImageData *data,
                               int extent[6], int*)
@@ -244,6 +368,17 @@ void vtkTIFFWriter::WriteFile(ofstream *, vtkImageData *data,
     return;
     }
 
+  // Deflate cannot be used with floats as libtiff's predictor does not
+  // handle 32 bit samples, leave that error to libtiff.
+  if (this->Compression == vtkTIFFWriter::NoCompression ||
+      this->Compression == vtkTIFFWriter::PackBits ||
+      (this->Compression == vtkTIFFWriter::Deflate &&
+       data->GetScalarType() != VTK_FLOAT))
+    {
+    this->WriteStrips(tif, data, extent);
+    return;
+    }
+
   int row = 0;
   for (idx2 = extent[4]; idx2 <= extent[5]; ++idx2)
     {
@@ -260,6 +395,63 @@ void vtkTIFFWriter::WriteFile(ofstream *, vtkImageData *data,
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkTIFFWriter::WriteStrips(void *tiffPtr, vtkImageData *data,
+                                int extent[6])
+{
+  TIFF* tif = reinterpret_cast<TIFF*>(tiffPtr);
+  vtkIdType numberOfRows =
+    static_cast<vtkIdType>(extent[3] - extent[2] + 1) *
+    (extent[5] - extent[4] + 1);
+  uint32 imageLength = 0;
+  TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &imageLength);
+  if (numberOfRows > static_cast<vtkIdType>(imageLength))
+    {
+    // The slices of a volume are stacked into one tall image, just as
+    // TIFFWriteScanline would grow it.
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH,
+                 static_cast<uint32>(numberOfRows));
+    }
+  uint32 rowsPerStrip = 0;
+  TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+  if (rowsPerStrip == 0 || static_cast<vtkIdType>(rowsPerStrip) > numberOfRows)
+    {
+    rowsPerStrip = static_cast<uint32>(numberOfRows);
+    }
+  vtkIdType numberOfStrips = (numberOfRows + rowsPerStrip - 1) / rowsPerStrip;
+
+  std::vector<std::vector<unsigned char> > strips(numberOfStrips);
+  std::vector<char> failed(numberOfStrips, 0);
+  vtkTIFFWriterStripEncoder encoder;
+  encoder.Data = data;
+  encoder.Extent = extent;
+  encoder.Compression = this->Compression;
+  encoder.BytesPerSample = data->GetScalarSize();
+  encoder.SamplesPerPixel = data->GetNumberOfScalarComponents();
+  encoder.RowsPerStrip = rowsPerStrip;
+  encoder.NumberOfRows = numberOfRows;
+  encoder.Strips = &strips;
+  encoder.Failed = &failed[0];
+  vtkSMPTools::For(0, numberOfStrips, encoder);
+
+  for (vtkIdType s = 0; s < numberOfStrips; ++s)
+    {
+    if (failed[s])
+      {
+      vtkErrorMacro("Could not compress strip " << s);
+      this->SetErrorCode(vtkErrorCode::FileFormatError);
+      return;
+      }
+    if (TIFFWriteRawStrip(tif, static_cast<tstrip_t>(s),
+          strips[s].empty() ? NULL : &strips[s][0],
+          static_cast<tsize_t>(strips[s].size())) < 0)
+      {
+      this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+      return;
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkTIFFWriter::WriteFileTrailer(ofstream *, vtkImageData *)
 {
@@ -63,6 +63,12 @@ protected:
   virtual void WriteFileHeader(ofstream *, vtkImageData *, int wExt[6]);
   virtual void WriteFileTrailer(ofstream *, vtkImageData *);
 
+  // Description:
+  // Compress the strips of the image concurrently and write them raw.
+  // Used for all compressions but JPEG and LZW, whose libtiff codecs are
+  // left to compress scanline by scanline.
+  void WriteStrips(void *tif, vtkImageData *data, int ext[6]);
+
   void* TIFFPtr;
   int Compression;
 
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelimitedTextReaderParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include <vtkAbstractArray.h>
+#include <vtkDelimitedTextReader.h>
+#include <vtkNew.h>
+#include <vtkTable.h>
+#include <vtkTestUtilities.h>
+#include <vtkVariant.h>
+
+#include <vtksys/ios/sstream>
+#include <fstream>
+#include <string>
+
+// Compares the output of the parallel parser against the default parser.
+
+namespace
+{
+struct ReaderSettings
+{
+  bool HaveHeaders;
+  bool DetectNumericColumns;
+  bool ForceDouble;
+  bool MergeConsecutiveDelimiters;
+  bool TrimWhitespace;
+  vtkIdType MaxRecords;
+  const char* FieldDelimiters;
+};
+
+void Configure(vtkDelimitedTextReader* reader, const ReaderSettings& settings)
+{
+  reader->SetHaveHeaders(settings.HaveHeaders);
+  reader->SetDetectNumericColumns(settings.DetectNumericColumns);
+  reader->SetForceDouble(settings.ForceDouble);
+  reader->SetMergeConsecutiveDelimiters(settings.MergeConsecutiveDelimiters);
+  reader->SetTrimWhitespacePriorToNumericConversion(settings.TrimWhitespace);
+  reader->SetMaxRecords(settings.MaxRecords);
+  reader->SetFieldDelimiterCharacters(settings.FieldDelimiters);
+  reader->SetDefaultIntegerValue(-7);
+  reader->SetDefaultDoubleValue(-0.5);
+}
+
+bool CompareTables(vtkTable* expected, vtkTable* actual)
+{
+  if (expected->GetNumberOfColumns() != actual->GetNumberOfColumns() ||
+      expected->GetNumberOfRows() != actual->GetNumberOfRows())
+    {
+    cerr << "Expected " << expected->GetNumberOfColumns() << " columns and "
+         << expected->GetNumberOfRows() << " rows, got "
+         << actual->GetNumberOfColumns() << " columns and "
+         << actual->GetNumberOfRows() << " rows" << endl;
+    return false;
+    }
+  for (vtkIdType c = 0; c < expected->GetNumberOfColumns(); ++c)
+    {
+    vtkAbstractArray* e = expected->GetColumn(c);
+    vtkAbstractArray* a = actual->GetColumn(c);
+    if (strcmp(e->GetClassName(), a->GetClassName()) != 0 ||
+        std::string(e->GetName()) != std::string(a->GetName()))
+      {
+      cerr << "Column " << c << ": expected " << e->GetClassName() << " '"
+           << e->GetName() << "', got " << a->GetClassName() << " '"
+           << a->GetName() << "'" << endl;
+      return false;
+      }
+    for (vtkIdType r = 0; r < expected->GetNumberOfRows(); ++r)
+      {
+      if (e->GetVariantValue(r).ToString() != a->GetVariantValue(r).ToString())
+        {
+        cerr << "Value (" << r << ", " << c << "): expected '"
+             << e->GetVariantValue(r).ToString() << "', got '"
+             << a->GetVariantValue(r).ToString() << "'" << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool TestString(const std::string& input, const ReaderSettings& settings)
+{
+  vtkNew<vtkDelimitedTextReader> serial;
+  Configure(serial.GetPointer(), settings);
+  serial->SetReadFromInputString(1);
+  serial->SetInputString(input);
+  serial->Update();
+
+  vtkNew<vtkDelimitedTextReader> parallel;
+  Configure(parallel.GetPointer(), settings);
+  parallel->SetReadFromInputString(1);
+  parallel->SetInputString(input);
+  parallel->UseParallelParsingOn();
+  parallel->Update();
+
+  return CompareTables(serial->GetOutput(), parallel->GetOutput());
+}
+
+bool TestFile(const std::string& fileName, const ReaderSettings& settings)
+{
+  vtkNew<vtkDelimitedTextReader> serial;
+  Configure(serial.GetPointer(), settings);
+  serial->SetFileName(fileName.c_str());
+  serial->Update();
+
+  vtkNew<vtkDelimitedTextReader> parallel;
+  Configure(parallel.GetPointer(), settings);
+  parallel->SetFileName(fileName.c_str());
+  parallel->UseParallelParsingOn();
+  parallel->Update();
+
+  return CompareTables(serial->GetOutput(), parallel->GetOutput());
+}
+}
+
+int TestDelimitedTextReaderParallel(int argc, char* argv[])
+{
+  const ReaderSettings plain = { false, false, false, false, false, 0, "," };
+  const ReaderSettings headers = { true, true, false, false, false, 0, "," };
+
+  const char* inputs[] = {
+    "a,b,c\n1,2,3\n4,5,6\n",
+    "a,b,c\r\n\r\n  1,\"2,5\",x\"y\"z\r\n4,,\r\n7\r\n8,9,10,11\r\n",
+    "name,value\nx\\ty,1\n\"quoted \\\"\",2.5\nlast,3",
+    "name,value\nlast,3 \n",
+    "i,d,s,e\n1,1.5,abc,\n-2,1e3,12,\n+3, .5 ,1.2.3,\n",
+    "i,d\n 1 , inf\n2,nan\n3,-Infinity\n2147483648,0x10\n",
+    "onlyheader,x\n",
+    "\n\n   \n",
+    "no-delimiter-at-end"
+    };
+
+  int result = EXIT_SUCCESS;
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i)
+    {
+    ReaderSettings settings[] = { plain, headers, headers, headers, headers };
+    settings[2].ForceDouble = true;
+    settings[3].MergeConsecutiveDelimiters = true;
+    settings[3].TrimWhitespace = true;
+    settings[4].MaxRecords = 2;
+    for (size_t j = 0; j < sizeof(settings) / sizeof(settings[0]); ++j)
+      {
+      if (!TestString(inputs[i], settings[j]))
+        {
+        cerr << "Error: input " << i << ", settings " << j << endl;
+        result = EXIT_FAILURE;
+        }
+      }
+    }
+
+  ReaderSettings spaces = headers;
+  spaces.FieldDelimiters = " \t";
+  spaces.MergeConsecutiveDelimiters = true;
+  if (!TestString("a  b\tc\n1   2\t\t3\n", spaces))
+    {
+    cerr << "Error: whitespace delimiters" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  // A file large enough to be split into several chunks, with columns that
+  // only turn out not to be integers past the records used to guess the
+  // column types.
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string fileName = temp_dir;
+  delete [] temp_dir;
+  fileName += "/TestDelimitedTextReaderParallel.csv";
+  {
+  std::ofstream file(fileName.c_str(), ios::binary);
+  file << "id,value,label,late double,late string\r\n";
+  for (int i = 0; i < 100000; ++i)
+    {
+    file << i << "," << (i * 0.25) << ",\"label " << (i % 17) << "\","
+         << (i == 90000 ? "1.5" : "7") << ","
+         << (i == 99999 ? "oops" : "8") << "\r\n";
+    }
+  }
+  if (!TestFile(fileName, headers))
+    {
+    cerr << "Error: large file" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  vtkNew<vtkDelimitedTextReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetHaveHeaders(true);
+  reader->SetDetectNumericColumns(true);
+  reader->UseParallelParsingOn();
+  reader->Update();
+  vtkTable* table = reader->GetOutput();
+  if (table->GetNumberOfRows() != 100000 ||
+      strcmp(table->GetColumn(0)->GetClassName(), "vtkIntArray") != 0 ||
+      strcmp(table->GetColumn(1)->GetClassName(), "vtkDoubleArray") != 0 ||
+      strcmp(table->GetColumn(2)->GetClassName(), "vtkStringArray") != 0 ||
+      strcmp(table->GetColumn(3)->GetClassName(), "vtkDoubleArray") != 0 ||
+      strcmp(table->GetColumn(4)->GetClassName(), "vtkStringArray") != 0)
+    {
+    cerr << "Error: wrong column types for the large file" << endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -21,16 +21,20 @@
 #include "vtkDelimitedTextReader.h"
 #include "vtkCommand.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkDoubleArray.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
 #include "vtkUnicodeStringArray.h"
 #include "vtkStringArray.h"
 #include "vtkStringToNumeric.h"
+#include "vtkVariant.h"
 
 #include "vtkTextCodec.h"
 #include "vtkTextCodecFactory.h"
@@ -44,6 +48,9 @@
 #include <vector>
 
 #include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 
 // #include <utf8.h>
 
@@ -368,6 +375,630 @@ private:
 
 } // End anonymous namespace
 
+////////////////////////////////////////////////////////////////////////////////
+// Parallel parser
+
+/// Chunked parser used when UseParallelParsing is on.  The whole input is
+/// held in one buffer, split into chunks at record delimiters and each
+/// chunk is tokenized independently.  The tokenizer follows the exact
+/// rules of DelimitedTextIterator, but works on bytes, which is valid as
+/// long as every delimiter is an ASCII character and the input is ASCII or
+/// UTF-8 (multibyte sequences never contain ASCII bytes).
+
+namespace {
+
+enum
+{
+  RecordDelimiterClass = 1,
+  FieldDelimiterClass = 2,
+  StringDelimiterClass = 4,
+  WhitespaceClass = 8
+};
+
+struct DelimitedTextSyntax
+{
+  unsigned char Class[256];
+  bool MergeConsecutiveDelimiters;
+  bool UseStringDelimiter;
+
+  bool Is(char c, unsigned char cls) const
+  {
+    return (this->Class[static_cast<unsigned char>(c)] & cls) != 0;
+  }
+};
+
+// Adds the ASCII characters of 'delimiters' to the given class.  Returns
+// false if one of them is not an ASCII character.
+bool AddSyntaxClass(DelimitedTextSyntax& syntax,
+                    const vtkUnicodeString& delimiters, unsigned char cls)
+{
+  for(vtkUnicodeString::const_iterator i = delimiters.begin();
+      i != delimiters.end(); ++i)
+    {
+    if(*i >= 0x80)
+      {
+      return false;
+      }
+    syntax.Class[*i] |= cls;
+    }
+  return true;
+}
+
+// Tokenizes the records in [begin, end) and reports them to the visitor,
+// which provides:
+//
+//   void Field(vtkIdType fieldIndex, const std::string& value);
+//   bool EndRecord(); // return false to stop tokenizing
+//
+// When atEndOfInput is true, a trailing record without record delimiter is
+// handled the way DelimitedTextIterator::ReachedEndOfInput() does.
+template <typename Visitor>
+void TokenizeRecords(const char* begin, const char* end, bool atEndOfInput,
+                     const DelimitedTextSyntax& syntax, Visitor& visitor)
+{
+  std::string field;
+  vtkIdType fieldIndex = 0;
+  vtkIdType fieldsInRecord = 0;
+  bool recordAdjacent = true;
+  bool processEscapeSequence = false;
+  char withinString = 0;
+
+  for(const char* c = begin; c != end; ++c)
+    {
+    const char value = *c;
+
+    // Strip adjacent record delimiters and whitespace...
+    if(recordAdjacent)
+      {
+      if(syntax.Is(value, RecordDelimiterClass | WhitespaceClass))
+        {
+        continue;
+        }
+      recordAdjacent = false;
+      }
+
+    // Look for record delimiters ...
+    if(syntax.Is(value, RecordDelimiterClass))
+      {
+      visitor.Field(fieldIndex, field);
+      field.clear();
+      fieldIndex = 0;
+      fieldsInRecord = 0;
+      recordAdjacent = true;
+      withinString = 0;
+      processEscapeSequence = false;
+      if(!visitor.EndRecord())
+        {
+        return;
+        }
+      continue;
+      }
+
+    // Look for field delimiters unless we're in a string ...
+    if(!withinString && syntax.Is(value, FieldDelimiterClass))
+      {
+      if(!(field.empty() && syntax.MergeConsecutiveDelimiters))
+        {
+        visitor.Field(fieldIndex++, field);
+        fieldsInRecord = fieldIndex;
+        field.clear();
+        }
+      continue;
+      }
+
+    // Check for start of escape sequence ...
+    if(!processEscapeSequence && value == '\\')
+      {
+      processEscapeSequence = true;
+      continue;
+      }
+
+    // Process escape sequence ...
+    if(processEscapeSequence)
+      {
+      switch(value)
+        {
+        case '0': break;
+        case 'a': field += '\a'; break;
+        case 'b': field += '\b'; break;
+        case 't': field += '\t'; break;
+        case 'n': field += '\n'; break;
+        case 'v': field += '\v'; break;
+        case 'f': field += '\f'; break;
+        case 'r': field += '\r'; break;
+        default: field += value; break;
+        }
+      processEscapeSequence = false;
+      continue;
+      }
+
+    if(syntax.UseStringDelimiter)
+      {
+      // Start a string ...
+      if(!withinString && syntax.Is(value, StringDelimiterClass))
+        {
+        withinString = value;
+        field.clear();
+        continue;
+        }
+
+      // End a string ...
+      if(withinString && withinString == value)
+        {
+        withinString = 0;
+        continue;
+        }
+      }
+
+    // Keep growing the current field ...
+    field += value;
+    }
+
+  if(atEndOfInput && !recordAdjacent)
+    {
+    // Handle files that do not end with a record delimiter ...
+    if(!field.empty() && !syntax.Is(field[field.size() - 1],
+                                    RecordDelimiterClass | WhitespaceClass))
+      {
+      visitor.Field(fieldIndex, field);
+      fieldsInRecord = fieldIndex + 1;
+      }
+    if(fieldsInRecord)
+      {
+      visitor.EndRecord();
+      }
+    }
+}
+
+// Collects the fields of the first records of the input.
+class RecordCollector
+{
+public:
+  RecordCollector(vtkIdType maxRecords) : MaxRecords(maxRecords)
+  {
+    this->Records.push_back(std::vector<std::string>());
+  }
+
+  void Field(vtkIdType fieldIndex, const std::string& value)
+  {
+    std::vector<std::string>& record = this->Records.back();
+    if(static_cast<vtkIdType>(record.size()) <= fieldIndex)
+      {
+      record.resize(fieldIndex + 1);
+      }
+    record[fieldIndex] = value;
+  }
+
+  bool EndRecord()
+  {
+    if(static_cast<vtkIdType>(this->Records.size()) == this->MaxRecords)
+      {
+      return false;
+      }
+    this->Records.push_back(std::vector<std::string>());
+    return true;
+  }
+
+  // Records that have been ended; the last entry is always in progress.
+  vtkIdType GetNumberOfRecords() const
+  {
+    return static_cast<vtkIdType>(this->Records.size()) -
+      (this->Records.back().empty() ? 1 : 0);
+  }
+
+  vtkIdType MaxRecords;
+  std::vector<std::vector<std::string> > Records;
+};
+
+// Counts the records of a chunk.
+class RecordCounter
+{
+public:
+  RecordCounter() : NumberOfRecords(0) {}
+  void Field(vtkIdType, const std::string&) {}
+  bool EndRecord() { ++this->NumberOfRecords; return true; }
+  vtkIdType NumberOfRecords;
+};
+
+// Counts the records in [begin, end) without tokenizing the fields; a
+// record starts at the first character that is neither a record delimiter
+// nor whitespace and ends at the next record delimiter.  Returns the start
+// of a trailing record that is not terminated, or 'end'.
+const char* CountCompleteRecords(const char* begin, const char* end,
+                                 const DelimitedTextSyntax& syntax,
+                                 vtkIdType& numberOfRecords)
+{
+  const char* recordStart = end;
+  numberOfRecords = 0;
+  for(const char* c = begin; c != end; ++c)
+    {
+    if(recordStart == end)
+      {
+      if(!syntax.Is(*c, RecordDelimiterClass | WhitespaceClass))
+        {
+        recordStart = c;
+        }
+      }
+    else if(syntax.Is(*c, RecordDelimiterClass))
+      {
+      ++numberOfRecords;
+      recordStart = end;
+      }
+    }
+  return recordStart;
+}
+
+// Returns true if [begin, end) holds valid UTF-8.
+bool IsValidUTF8(const char* begin, const char* end)
+{
+  const unsigned char* c = reinterpret_cast<const unsigned char*>(begin);
+  const unsigned char* e = reinterpret_cast<const unsigned char*>(end);
+  while(c != e)
+    {
+    if(*c < 0x80)
+      {
+      ++c;
+      continue;
+      }
+    int trailing;
+    unsigned int codePoint;
+    if(*c >= 0xC2 && *c <= 0xDF)
+      {
+      trailing = 1;
+      codePoint = *c & 0x1F;
+      }
+    else if(*c >= 0xE0 && *c <= 0xEF)
+      {
+      trailing = 2;
+      codePoint = *c & 0x0F;
+      }
+    else if(*c >= 0xF0 && *c <= 0xF4)
+      {
+      trailing = 3;
+      codePoint = *c & 0x07;
+      }
+    else
+      {
+      return false;
+      }
+    if(e - c <= trailing)
+      {
+      return false;
+      }
+    for(int i = 1; i <= trailing; ++i)
+      {
+      if((c[i] & 0xC0) != 0x80)
+        {
+        return false;
+        }
+      codePoint = (codePoint << 6) | (c[i] & 0x3F);
+      }
+    if((trailing == 2 && (codePoint < 0x800 ||
+                          (codePoint >= 0xD800 && codePoint <= 0xDFFF))) ||
+       (trailing == 3 && (codePoint < 0x10000 || codePoint > 0x10FFFF)))
+      {
+      return false;
+      }
+    c += trailing + 1;
+    }
+  return true;
+}
+
+// Numeric conversions with the semantics of vtkVariant::ToInt() and
+// vtkVariant::ToDouble().  Plain decimal numbers are converted with
+// strtol/strtod, anything else goes through vtkVariant.
+inline bool IsSpace(char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+bool ConvertToInt(const std::string& str, int& value)
+{
+  const char* c = str.c_str();
+  const char* e = c + str.size();
+  while(c != e && IsSpace(*c)) ++c;
+  const char* numberBegin = c;
+  if(c != e && (*c == '+' || *c == '-')) ++c;
+  const char* digits = c;
+  while(c != e && IsDigit(*c)) ++c;
+  bool simple = c != digits;
+  while(c != e && IsSpace(*c)) ++c;
+  if(simple && c == e)
+    {
+    errno = 0;
+    long result = strtol(numberBegin, NULL, 10);
+    if(errno == 0 && result >= VTK_INT_MIN && result <= VTK_INT_MAX)
+      {
+      value = static_cast<int>(result);
+      return true;
+      }
+    return false;
+    }
+  bool ok = false;
+  value = vtkVariant(str).ToInt(&ok);
+  return ok;
+}
+
+bool ConvertToDouble(const std::string& str, double& value)
+{
+  const char* c = str.c_str();
+  const char* e = c + str.size();
+  while(c != e && IsSpace(*c)) ++c;
+  const char* numberBegin = c;
+  if(c != e && (*c == '+' || *c == '-')) ++c;
+  const char* mantissa = c;
+  while(c != e && IsDigit(*c)) ++c;
+  bool simple = c != mantissa;
+  if(c != e && *c == '.')
+    {
+    const char* fraction = ++c;
+    while(c != e && IsDigit(*c)) ++c;
+    simple = simple || c != fraction;
+    }
+  if(simple && c != e && (*c == 'e' || *c == 'E'))
+    {
+    ++c;
+    if(c != e && (*c == '+' || *c == '-')) ++c;
+    const char* exponent = c;
+    while(c != e && IsDigit(*c)) ++c;
+    simple = c != exponent;
+    }
+  while(c != e && IsSpace(*c)) ++c;
+  if(simple && c == e)
+    {
+    errno = 0;
+    value = strtod(numberBegin, NULL);
+    if(errno == 0)
+      {
+      return true;
+      }
+    }
+  bool ok = false;
+  value = vtkVariant(str).ToDouble(&ok);
+  return ok;
+}
+
+enum ColumnType
+{
+  StringColumn,
+  IntColumn,
+  DoubleColumn
+};
+
+struct ColumnConversion
+{
+  bool TrimWhitespace;
+  int DefaultIntegerValue;
+  double DefaultDoubleValue;
+
+  // Stores 'str' at the given row of the column, returns false if it
+  // cannot be converted to the column type.
+  bool Convert(ColumnType type, void* values, vtkIdType row,
+               const std::string& str) const
+  {
+    if(type == StringColumn)
+      {
+      static_cast<vtkStdString*>(values)[row] = str;
+      return true;
+      }
+
+    const std::string* text = &str;
+    std::string trimmed;
+    if(this->TrimWhitespace)
+      {
+      size_t startPos = str.find_first_not_of(" \n\t\r");
+      if(startPos != std::string::npos)
+        {
+        size_t endPos = str.find_last_not_of(" \n\t\r");
+        trimmed = str.substr(startPos, endPos - startPos + 1);
+        }
+      text = &trimmed;
+      }
+
+    if(type == IntColumn)
+      {
+      int& value = static_cast<int*>(values)[row];
+      if(text->empty())
+        {
+        value = this->DefaultIntegerValue;
+        return true;
+        }
+      return ConvertToInt(*text, value);
+      }
+
+    double& value = static_cast<double*>(values)[row];
+    if(text->empty())
+      {
+      value = this->DefaultDoubleValue;
+      return true;
+      }
+    return ConvertToDouble(*text, value);
+  }
+};
+
+struct ParallelChunk
+{
+  const char* Begin;
+  const char* End;
+  vtkIdType FirstRecord;
+  vtkIdType NumberOfRecords;
+  std::vector<unsigned char> Failed;
+};
+
+// Writes the fields of one chunk into the output columns.
+class ColumnFiller
+{
+public:
+  ColumnFiller(vtkIdType firstRow, vtkIdType numberOfRows,
+               const std::vector<ColumnType>& types,
+               const std::vector<void*>& values,
+               const std::vector<unsigned char>& active,
+               const ColumnConversion& conversion,
+               std::vector<unsigned char>& failed) :
+    Row(firstRow), NumberOfRows(numberOfRows), Types(types), Values(values),
+    Active(active), Conversion(conversion), Failed(failed),
+    FieldsInRecord(0), Empty()
+  {
+  }
+
+  void Field(vtkIdType fieldIndex, const std::string& value)
+  {
+    if(this->Row >= 0 &&
+       fieldIndex < static_cast<vtkIdType>(this->Types.size()) &&
+       this->Active[fieldIndex] && !this->Failed[fieldIndex])
+      {
+      if(!this->Conversion.Convert(this->Types[fieldIndex],
+                                   this->Values[fieldIndex], this->Row, value))
+        {
+        this->Failed[fieldIndex] = 1;
+        }
+      }
+    this->FieldsInRecord = fieldIndex + 1;
+  }
+
+  bool EndRecord()
+  {
+    // Missing fields are read as empty strings.
+    if(this->Row >= 0)
+      {
+      for(size_t i = this->FieldsInRecord; i < this->Types.size(); ++i)
+        {
+        if(this->Active[i] && this->Types[i] != StringColumn)
+          {
+          this->Conversion.Convert(this->Types[i], this->Values[i], this->Row,
+                                   this->Empty);
+          }
+        }
+      }
+    this->FieldsInRecord = 0;
+    return ++this->Row < this->NumberOfRows;
+  }
+
+private:
+  vtkIdType Row;
+  vtkIdType NumberOfRows;
+  const std::vector<ColumnType>& Types;
+  const std::vector<void*>& Values;
+  const std::vector<unsigned char>& Active;
+  const ColumnConversion& Conversion;
+  std::vector<unsigned char>& Failed;
+  size_t FieldsInRecord;
+  const std::string Empty;
+};
+
+class ValidateChunksFunctor
+{
+public:
+  ValidateChunksFunctor(std::vector<ParallelChunk>& chunks,
+                        std::vector<unsigned char>& valid) :
+    Chunks(chunks), Valid(valid)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for(vtkIdType i = begin; i != end; ++i)
+      {
+      this->Valid[i] = IsValidUTF8(this->Chunks[i].Begin, this->Chunks[i].End);
+      }
+  }
+
+private:
+  std::vector<ParallelChunk>& Chunks;
+  std::vector<unsigned char>& Valid;
+};
+
+class CountRecordsFunctor
+{
+public:
+  CountRecordsFunctor(std::vector<ParallelChunk>& chunks, const char* inputEnd,
+                      const DelimitedTextSyntax& syntax) :
+    Chunks(chunks), InputEnd(inputEnd), Syntax(syntax)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for(vtkIdType i = begin; i != end; ++i)
+      {
+      ParallelChunk& chunk = this->Chunks[i];
+      const char* tail = CountCompleteRecords(chunk.Begin, chunk.End,
+                                              this->Syntax,
+                                              chunk.NumberOfRecords);
+      if(tail != chunk.End && chunk.End == this->InputEnd)
+        {
+        RecordCounter counter;
+        TokenizeRecords(tail, chunk.End, true, this->Syntax, counter);
+        chunk.NumberOfRecords += counter.NumberOfRecords;
+        }
+      }
+  }
+
+private:
+  std::vector<ParallelChunk>& Chunks;
+  const char* InputEnd;
+  const DelimitedTextSyntax& Syntax;
+};
+
+class FillColumnsFunctor
+{
+public:
+  FillColumnsFunctor(std::vector<ParallelChunk>& chunks, const char* inputEnd,
+                     const DelimitedTextSyntax& syntax, vtkIdType firstRow,
+                     vtkIdType numberOfRows,
+                     const std::vector<ColumnType>& types,
+                     const std::vector<void*>& values,
+                     const std::vector<unsigned char>& active,
+                     const ColumnConversion& conversion) :
+    Chunks(chunks), InputEnd(inputEnd), Syntax(syntax), FirstRow(firstRow),
+    NumberOfRows(numberOfRows), Types(types), Values(values), Active(active),
+    Conversion(conversion)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for(vtkIdType i = begin; i != end; ++i)
+      {
+      ParallelChunk& chunk = this->Chunks[i];
+      chunk.Failed.assign(this->Types.size(), 0);
+      vtkIdType row = chunk.FirstRecord + this->FirstRow;
+      if(row >= this->NumberOfRows)
+        {
+        continue;
+        }
+      ColumnFiller filler(row, this->NumberOfRows, this->Types, this->Values,
+                          this->Active, this->Conversion, chunk.Failed);
+      TokenizeRecords(chunk.Begin, chunk.End, chunk.End == this->InputEnd,
+                      this->Syntax, filler);
+      }
+  }
+
+private:
+  std::vector<ParallelChunk>& Chunks;
+  const char* InputEnd;
+  const DelimitedTextSyntax& Syntax;
+  vtkIdType FirstRow;
+  vtkIdType NumberOfRows;
+  const std::vector<ColumnType>& Types;
+  const std::vector<void*>& Values;
+  const std::vector<unsigned char>& Active;
+  const ColumnConversion& Conversion;
+};
+
+// Number of records used to guess the type of each column.
+const vtkIdType TypeInferenceSampleSize = 1000;
+
+// Target size of the chunks handed to each task.
+const vtkIdType ParallelChunkSize = 1 << 20;
+
+} // End anonymous namespace
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // vtkDelimitedTextReader
 
@@ -406,6 +1037,7 @@ vtkDelimitedTextReader::vtkDelimitedTextReader() :
   this->DefaultIntegerValue = 0;
   this->DefaultDoubleValue = 0.0;
   this->TrimWhitespacePriorToNumericConversion = false;
+  this->UseParallelParsing = false;
 }
 
 vtkDelimitedTextReader::~vtkDelimitedTextReader()
@@ -469,6 +1101,8 @@ void vtkDelimitedTextReader::PrintSelf(ostream& os, vtkIndent indent)
     << this->PedigreeIdArrayName << endl;
   os << indent << "OutputPedigreeIds: "
     << (this->OutputPedigreeIds? "true" : "false") << endl;
+  os << indent << "UseParallelParsing: "
+    << (this->UseParallelParsing ? "true" : "false") << endl;
 }
 
 void vtkDelimitedTextReader::SetInputString(const char *in)
@@ -581,6 +1215,202 @@ vtkStdString vtkDelimitedTextReader::GetLastError()
   return this->LastError;
 }
 
+bool vtkDelimitedTextReader::ParallelParse(const char* begin, const char* end,
+                                           vtkTable* output_table)
+{
+  DelimitedTextSyntax syntax;
+  memset(syntax.Class, 0, sizeof(syntax.Class));
+  syntax.MergeConsecutiveDelimiters = this->MergeConsecutiveDelimiters;
+  syntax.UseStringDelimiter = this->UseStringDelimiter;
+  if(!AddSyntaxClass(syntax, this->UnicodeRecordDelimiters,
+                     RecordDelimiterClass) ||
+     !AddSyntaxClass(syntax, this->UnicodeFieldDelimiters,
+                     FieldDelimiterClass) ||
+     !AddSyntaxClass(syntax, this->UnicodeStringDelimiters,
+                     StringDelimiterClass) ||
+     !AddSyntaxClass(syntax, this->UnicodeWhitespace, WhitespaceClass) ||
+     this->UnicodeEscapeCharacter != vtkUnicodeString::from_utf8("\\"))
+    {
+    return false;
+    }
+
+  // Split the input into chunks that end with a record delimiter.
+  std::vector<ParallelChunk> chunks;
+  for(const char* chunkBegin = begin; chunkBegin != end;)
+    {
+    const char* chunkEnd = end;
+    if(end - chunkBegin > ParallelChunkSize)
+      {
+      chunkEnd = chunkBegin + ParallelChunkSize;
+      while(chunkEnd != end && !syntax.Is(*chunkEnd, RecordDelimiterClass))
+        {
+        ++chunkEnd;
+        }
+      if(chunkEnd != end)
+        {
+        ++chunkEnd;
+        }
+      }
+    ParallelChunk chunk;
+    chunk.Begin = chunkBegin;
+    chunk.End = chunkEnd;
+    chunk.FirstRecord = 0;
+    chunk.NumberOfRecords = 0;
+    chunks.push_back(chunk);
+    chunkBegin = chunkEnd;
+    }
+  const vtkIdType numberOfChunks = static_cast<vtkIdType>(chunks.size());
+
+  // Anything that is not ASCII or UTF-8 is left to the text codecs.
+  std::vector<unsigned char> valid(numberOfChunks, 0);
+  ValidateChunksFunctor validate(chunks, valid);
+  vtkSMPTools::For(0, numberOfChunks, 1, validate);
+  if(std::find(valid.begin(), valid.end(), 0) != valid.end())
+    {
+    return false;
+    }
+
+  const vtkIdType firstRow = this->HaveHeaders ? -1 : 0;
+
+  // The first records give the columns and the sample used to guess the
+  // column types.
+  RecordCollector sample(TypeInferenceSampleSize - firstRow);
+  TokenizeRecords(begin, end, true, syntax, sample);
+  if(sample.GetNumberOfRecords() == 0)
+    {
+    return true;
+    }
+  const std::vector<std::string>& firstRecord = sample.Records[0];
+  const size_t numberOfColumns = firstRecord.size();
+
+  CountRecordsFunctor count(chunks, end, syntax);
+  vtkSMPTools::For(0, numberOfChunks, 1, count);
+  vtkIdType numberOfRecords = 0;
+  for(vtkIdType i = 0; i != numberOfChunks; ++i)
+    {
+    chunks[i].FirstRecord = numberOfRecords;
+    numberOfRecords += chunks[i].NumberOfRecords;
+    }
+  vtkIdType numberOfRows = numberOfRecords + firstRow;
+  if(this->MaxRecords && numberOfRows > this->MaxRecords)
+    {
+    numberOfRows = this->MaxRecords;
+    }
+
+  ColumnConversion conversion;
+  conversion.TrimWhitespace = this->TrimWhitespacePriorToNumericConversion;
+  conversion.DefaultIntegerValue = this->DefaultIntegerValue;
+  conversion.DefaultDoubleValue = this->DefaultDoubleValue;
+
+  // Guess the column types from the sample, the same way
+  // vtkStringToNumeric decides them for the whole column.
+  std::vector<ColumnType> types(numberOfColumns, StringColumn);
+  if(this->DetectNumericColumns)
+    {
+    const vtkIdType sampleEnd = std::min(sample.GetNumberOfRecords(),
+                                         numberOfRows - firstRow);
+    const std::string empty;
+    for(size_t i = 0; i < numberOfColumns; ++i)
+      {
+      bool allInteger = !this->ForceDouble && numberOfRows > 0;
+      bool allNumeric = true;
+      for(vtkIdType r = -firstRow; r < sampleEnd && allNumeric; ++r)
+        {
+        const std::vector<std::string>& record = sample.Records[r];
+        const std::string& value = i < record.size() ? record[i] : empty;
+        int intValue;
+        double doubleValue;
+        if(allInteger &&
+           !conversion.Convert(IntColumn, &intValue, 0, value))
+          {
+          allInteger = false;
+          }
+        if(!allInteger &&
+           !conversion.Convert(DoubleColumn, &doubleValue, 0, value))
+          {
+          allNumeric = false;
+          }
+        }
+      types[i] = allInteger ? IntColumn :
+        (allNumeric ? DoubleColumn : StringColumn);
+      }
+    }
+
+  // Parse the chunks into the columns.  A column whose type turns out to
+  // be wrong is promoted (int to double to string) and parsed again.
+  std::vector<vtkSmartPointer<vtkAbstractArray> > columns(numberOfColumns);
+  std::vector<void*> values(numberOfColumns);
+  std::vector<unsigned char> active(numberOfColumns, 1);
+  for(bool parse = true; parse;)
+    {
+    for(size_t i = 0; i < numberOfColumns; ++i)
+      {
+      if(!active[i])
+        {
+        continue;
+        }
+      if(types[i] == IntColumn)
+        {
+        vtkIntArray* array = vtkIntArray::New();
+        array->SetNumberOfTuples(numberOfRows);
+        values[i] = array->GetPointer(0);
+        columns[i].TakeReference(array);
+        }
+      else if(types[i] == DoubleColumn)
+        {
+        vtkDoubleArray* array = vtkDoubleArray::New();
+        array->SetNumberOfTuples(numberOfRows);
+        values[i] = array->GetPointer(0);
+        columns[i].TakeReference(array);
+        }
+      else
+        {
+        vtkStringArray* array = vtkStringArray::New();
+        array->SetNumberOfValues(numberOfRows);
+        values[i] = array->GetPointer(0);
+        columns[i].TakeReference(array);
+        }
+      }
+
+    FillColumnsFunctor fill(chunks, end, syntax, firstRow, numberOfRows,
+                            types, values, active, conversion);
+    vtkSMPTools::For(0, numberOfChunks, 1, fill);
+
+    parse = false;
+    for(size_t i = 0; i < numberOfColumns; ++i)
+      {
+      bool failed = false;
+      for(vtkIdType c = 0; c != numberOfChunks && !failed; ++c)
+        {
+        failed = active[i] && chunks[c].Failed[i];
+        }
+      active[i] = failed;
+      if(failed)
+        {
+        types[i] = types[i] == IntColumn ? DoubleColumn : StringColumn;
+        parse = true;
+        }
+      }
+    }
+
+  for(size_t i = 0; i < numberOfColumns; ++i)
+    {
+    if(this->HaveHeaders)
+      {
+      columns[i]->SetName(firstRecord[i].c_str());
+      }
+    else
+      {
+      std::stringstream buffer;
+      buffer << "Field " << i;
+      columns[i]->SetName(buffer.str().c_str());
+      }
+    output_table->AddColumn(columns[i]);
+    }
+
+  return true;
+}
+
 int vtkDelimitedTextReader::RequestData(
   vtkInformation*,
   vtkInformationVector**,
@@ -606,6 +1436,7 @@ int vtkDelimitedTextReader::RequestData(
     istream* input_stream_pt = NULL;
     ifstream file_stream;
     std::istringstream string_stream;
+    vtkIdType total_bytes = 0;
 
     if(!this->ReadFromInputString)
       {
@@ -623,7 +1454,7 @@ int vtkDelimitedTextReader::RequestData(
         }
 
       file_stream.seekg(0, ios::end);
-      //const vtkIdType total_bytes = file_stream.tellg();
+      total_bytes = file_stream.tellg();
       file_stream.seekg(0, ios::beg);
 
       input_stream_pt = dynamic_cast<istream*>(&file_stream);
@@ -636,6 +1467,7 @@ int vtkDelimitedTextReader::RequestData(
 
     vtkStdString character_set;
     vtkTextCodec* transCodec = NULL;
+    bool parsed = false;
 
     if(this->UnicodeCharacterSet)
       {
@@ -655,33 +1487,66 @@ int vtkDelimitedTextReader::RequestData(
       this->UnicodeStringDelimiters =
         vtkUnicodeString::from_utf8(tstring);
       this->UnicodeOutputArrays = false;
-      transCodec = vtkTextCodecFactory::CodecToHandle(*input_stream_pt);
+
+      if(this->UseParallelParsing)
+        {
+        std::vector<char> file_buffer;
+        const char* input_begin = this->InputString;
+        const char* input_end = this->InputString ?
+          this->InputString + strlen(this->InputString) : 0;
+        if(!this->ReadFromInputString)
+          {
+          file_buffer.resize(total_bytes);
+          if(total_bytes > 0 &&
+             !file_stream.read(&file_buffer[0], total_bytes))
+            {
+            throw std::runtime_error(
+              "Unable to read input file " + std::string(this->FileName));
+            }
+          input_begin = total_bytes > 0 ? &file_buffer[0] : 0;
+          input_end = input_begin + total_bytes;
+          }
+        parsed = this->ParallelParse(input_begin, input_end, output_table);
+        if(!parsed)
+          {
+          input_stream_pt->clear();
+          input_stream_pt->seekg(0, ios::beg);
+          }
+        }
+
+      if(!parsed)
+        {
+        transCodec = vtkTextCodecFactory::CodecToHandle(*input_stream_pt);
+        }
       }
 
-    if (NULL == transCodec)
+    if (!parsed && NULL == transCodec)
       {
       // should this use the locale instead??
       return 1;
       }
 
-    DelimitedTextIterator iterator(
-      this->MaxRecords,
-      this->UnicodeRecordDelimiters,
-      this->UnicodeFieldDelimiters,
-      this->UnicodeStringDelimiters,
-      this->UnicodeWhitespace,
-      this->UnicodeEscapeCharacter,
-      this->HaveHeaders,
-      this->UnicodeOutputArrays,
-      this->MergeConsecutiveDelimiters,
-      this->UseStringDelimiter,
-      output_table);
-
-    vtkTextCodec::OutputIterator& outIter = iterator;
-
-    transCodec->ToUnicode(*input_stream_pt, outIter);
-    iterator.ReachedEndOfInput();
-    transCodec->Delete();
+    if (!parsed)
+      {
+      DelimitedTextIterator iterator(
+        this->MaxRecords,
+        this->UnicodeRecordDelimiters,
+        this->UnicodeFieldDelimiters,
+        this->UnicodeStringDelimiters,
+        this->UnicodeWhitespace,
+        this->UnicodeEscapeCharacter,
+        this->HaveHeaders,
+        this->UnicodeOutputArrays,
+        this->MergeConsecutiveDelimiters,
+        this->UseStringDelimiter,
+        output_table);
+
+      vtkTextCodec::OutputIterator& outIter = iterator;
+
+      transCodec->ToUnicode(*input_stream_pt, outIter);
+      iterator.ReachedEndOfInput();
+      transCodec->Delete();
+      }
 
     if(this->OutputPedigreeIds)
       {
@@ -715,7 +1580,7 @@ int vtkDelimitedTextReader::RequestData(
       }
     }
 
-    if (this->DetectNumericColumns && !this->UnicodeOutputArrays)
+    if (!parsed && this->DetectNumericColumns && !this->UnicodeOutputArrays)
       {
       vtkStringToNumeric* converter = vtkStringToNumeric::New();
       converter->SetForceDouble(this->ForceDouble);
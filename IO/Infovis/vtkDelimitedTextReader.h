@@ -254,6 +254,20 @@ public:
   vtkSetMacro(ReplacementCharacter, vtkTypeUInt32);
   vtkGetMacro(ReplacementCharacter, vtkTypeUInt32);
 
+  // Description:
+  // When on, ASCII and UTF-8 input read without SetUnicodeCharacterSet() is
+  // loaded in one piece, split into chunks at record delimiters and parsed
+  // concurrently with vtkSMPTools.  When DetectNumericColumns is also on,
+  // the column types are guessed from the first records and numeric
+  // columns are parsed directly into vtkIntArray / vtkDoubleArray, a
+  // column being promoted if a later value does not fit, instead of
+  // storing every field as a string first.  Input that cannot be handled
+  // this way (other encodings, non-ASCII delimiters) is read with the
+  // default parser.  Default is off.
+  vtkSetMacro(UseParallelParsing, bool);
+  vtkGetMacro(UseParallelParsing, bool);
+  vtkBooleanMacro(UseParallelParsing, bool);
+
 //BTX
 protected:
   vtkDelimitedTextReader();
@@ -264,6 +278,12 @@ protected:
     vtkInformationVector**,
     vtkInformationVector*);
 
+  // Description:
+  // Parse [begin, end) into the output table with the parallel parser.
+  // Returns false, leaving the table untouched, if the input must be
+  // handled by the default parser instead.
+  bool ParallelParse(const char* begin, const char* end, vtkTable* output);
+
   char* FileName;
   int ReadFromInputString;
   char *InputString;
@@ -291,6 +311,7 @@ protected:
   bool OutputPedigreeIds;
   vtkStdString LastError;
   vtkTypeUInt32 ReplacementCharacter;
+  bool UseParallelParsing;
 
 private:
   vtkDelimitedTextReader(const vtkDelimitedTextReader&); // Not implemented
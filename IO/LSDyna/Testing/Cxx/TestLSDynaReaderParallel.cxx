@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLSDynaReaderParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkLSDynaReader::UseParallelDecoding
+// .SECTION Description
+// Checks that decoding the state concurrently gives the same output as the
+// serial decoding, over several time steps.
+
+#include "vtkLSDynaReader.h"
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+bool CompareArrays(vtkDataArray* expected, vtkDataArray* actual)
+{
+  if (!expected || !actual ||
+      expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+    {
+    return false;
+    }
+  vtkIdType size =
+    expected->GetNumberOfTuples() * expected->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < size; ++i)
+    {
+    if (expected->GetComponent(i / expected->GetNumberOfComponents(),
+                               i % expected->GetNumberOfComponents()) !=
+        actual->GetComponent(i / actual->GetNumberOfComponents(),
+                             i % actual->GetNumberOfComponents()))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CompareGrids(vtkUnstructuredGrid* expected, vtkUnstructuredGrid* actual)
+{
+  if (!expected || !actual)
+    {
+    return expected == actual;
+    }
+  if (expected->GetNumberOfCells() != actual->GetNumberOfCells() ||
+      expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+      expected->GetPointData()->GetNumberOfArrays() !=
+      actual->GetPointData()->GetNumberOfArrays() ||
+      expected->GetCellData()->GetNumberOfArrays() !=
+      actual->GetCellData()->GetNumberOfArrays())
+    {
+    return false;
+    }
+  if (expected->GetPoints() &&
+      !CompareArrays(expected->GetPoints()->GetData(),
+                     actual->GetPoints()->GetData()))
+    {
+    return false;
+    }
+  for (int i = 0; i < expected->GetPointData()->GetNumberOfArrays(); ++i)
+    {
+    if (!CompareArrays(expected->GetPointData()->GetArray(i),
+                       actual->GetPointData()->GetArray(i)))
+      {
+      cerr << "Point array " << expected->GetPointData()->GetArrayName(i)
+           << " differs" << endl;
+      return false;
+      }
+    }
+  for (int i = 0; i < expected->GetCellData()->GetNumberOfArrays(); ++i)
+    {
+    if (!CompareArrays(expected->GetCellData()->GetArray(i),
+                       actual->GetCellData()->GetArray(i)))
+      {
+      cerr << "Cell array " << expected->GetCellData()->GetArrayName(i)
+           << " differs" << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int TestFile(int argc, char* argv[], const char* name)
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(argc, argv, name);
+
+  vtkNew<vtkLSDynaReader> serial;
+  serial->SetFileName(fname);
+  serial->UpdateInformation();
+
+  vtkNew<vtkLSDynaReader> parallel;
+  parallel->SetFileName(fname);
+  parallel->UseParallelDecodingOn();
+  parallel->UpdateInformation();
+  delete [] fname;
+
+  // Load every array, so that all of the state words get decoded.
+  vtkLSDynaReader* readers[2] = { serial.GetPointer(), parallel.GetPointer() };
+  for (int r = 0; r < 2; ++r)
+    {
+    vtkLSDynaReader* reader = readers[r];
+    for (int i = 0; i < reader->GetNumberOfSolidArrays(); ++i)
+      {
+      reader->SetSolidArrayStatus(i, 1);
+      }
+    for (int i = 0; i < reader->GetNumberOfThickShellArrays(); ++i)
+      {
+      reader->SetThickShellArrayStatus(i, 1);
+      }
+    for (int i = 0; i < reader->GetNumberOfShellArrays(); ++i)
+      {
+      reader->SetShellArrayStatus(i, 1);
+      }
+    for (int i = 0; i < reader->GetNumberOfBeamArrays(); ++i)
+      {
+      reader->SetBeamArrayStatus(i, 1);
+      }
+    for (int i = 0; i < reader->GetNumberOfParticleArrays(); ++i)
+      {
+      reader->SetParticleArrayStatus(i, 1);
+      }
+    }
+
+  vtkIdType numSteps = serial->GetNumberOfTimeSteps();
+  vtkIdType steps[3] = { 0, numSteps - 1, numSteps / 2 };
+  for (int s = 0; s < 3; ++s)
+    {
+    serial->SetTimeStep(steps[s]);
+    serial->Update();
+    parallel->SetTimeStep(steps[s]);
+    parallel->Update();
+
+    vtkMultiBlockDataSet* expected = serial->GetOutput();
+    vtkMultiBlockDataSet* actual = parallel->GetOutput();
+    if (expected->GetNumberOfBlocks() != actual->GetNumberOfBlocks())
+      {
+      cerr << name << ": wrong number of parts" << endl;
+      return 0;
+      }
+    for (unsigned int b = 0; b < expected->GetNumberOfBlocks(); ++b)
+      {
+      if (!CompareGrids(
+            vtkUnstructuredGrid::SafeDownCast(expected->GetBlock(b)),
+            vtkUnstructuredGrid::SafeDownCast(actual->GetBlock(b))))
+        {
+        cerr << name << ": part " << b << " differs at time step "
+             << steps[s] << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+}
+
+int TestLSDynaReaderParallel(int argc, char* argv[])
+{
+  int success = 1;
+  success &= TestFile(argc, argv, "Data/LSDyna/hemi.draw/hemi_draw.d3plot");
+  success &= TestFile(argc, argv, "Data/LSDyna/foam/foam.d3plot");
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
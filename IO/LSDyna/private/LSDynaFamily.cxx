@@ -18,6 +18,8 @@
 ----------------------------------------------------------------------------*/
 
 #include "LSDynaFamily.h"
+
+#include "vtkSMPTools.h"
 //#include "vtksys/SystemTools.hxx"
 
 #include <errno.h>
@@ -169,6 +171,7 @@ LSDynaFamily::LSDynaFamily()
     this->ChunkAlloc = 0;
 
     this->FileHandlesClosed = false;
+    this->ParallelDecoding = false;
 
     this->BufferInfo = new LSDynaFamily::BufferingInfo();
     }
@@ -404,6 +407,65 @@ int LSDynaFamily::SkipWords( vtkIdType numWords )
   return 0;
   }
 
+//-----------------------------------------------------------------------------
+namespace
+{
+  // Reverses the bytes of a range of words of a chunk
+  class SwapWordsFunctor
+  {
+  public:
+    SwapWordsFunctor(unsigned char* chunk, int wordSize):
+      Chunk(chunk), WordSize(wordSize)
+      {
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+      {
+      unsigned char tmp[4];
+      unsigned char* cur = this->Chunk + begin*this->WordSize;
+      vtkIdType i;
+      switch (this->WordSize)
+        {
+      case 4:
+        for (i=begin; i<end; ++i)
+          {
+          tmp[0] = cur[0];
+          tmp[1] = cur[1];
+          cur[0] = cur[3];
+          cur[1] = cur[2];
+          cur[2] = tmp[1];
+          cur[3] = tmp[0];
+          cur += this->WordSize;
+          }
+        break;
+      case 8:
+      default:
+        for (i=begin; i<end; ++i)
+          {
+          tmp[0] = cur[0];
+          tmp[1] = cur[1];
+          tmp[2] = cur[2];
+          tmp[3] = cur[3];
+          cur[0] = cur[7];
+          cur[1] = cur[6];
+          cur[2] = cur[5];
+          cur[3] = cur[4];
+          cur[4] = tmp[3];
+          cur[5] = tmp[2];
+          cur[6] = tmp[1];
+          cur[7] = tmp[0];
+          cur += this->WordSize;
+          }
+        break;
+        }
+      }
+
+  protected:
+    unsigned char* Chunk;
+    int WordSize;
+  };
+}
+
 //-----------------------------------------------------------------------------
 int LSDynaFamily::BufferChunk( WordType wType, vtkIdType chunkSizeInWords )
   {
@@ -459,45 +521,16 @@ int LSDynaFamily::BufferChunk( WordType wType, vtkIdType chunkSizeInWords )
 
   if ( this->SwapEndian && wType != LSDynaFamily::Char )
     {
-    unsigned char tmp[4];
-    vtkIdType i;
-    unsigned char* cur = this->Chunk;
-
     // Currently, wType is unused, but if I ever have to support cray
     // floating point types, this will need to be different
-    switch (this->WordSize)
+    SwapWordsFunctor swapper(this->Chunk,this->WordSize);
+    if ( this->ParallelDecoding )
       {
-    case 4:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        cur[0] = cur[3];
-        cur[1] = cur[2];
-        cur[2] = tmp[1];
-        cur[3] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
-    case 8:
-    default:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        tmp[2] = cur[2];
-        tmp[3] = cur[3];
-        cur[0] = cur[7];
-        cur[1] = cur[6];
-        cur[2] = cur[5];
-        cur[3] = cur[4];
-        cur[4] = tmp[3];
-        cur[5] = tmp[2];
-        cur[6] = tmp[1];
-        cur[7] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
+      vtkSMPTools::For(0,chunkSizeInWords,65536,swapper);
+      }
+    else
+      {
+      swapper(0,chunkSizeInWords);
       }
     }
 
@@ -188,6 +188,13 @@ public:
   vtkIdType GetCurrentFWord() const { return this->FWord; }
 
   int GetWordSize() const;
+
+  //Description:
+  //When set, large chunks are byte swapped and decoded into the part
+  //arrays concurrently (see vtkSMPTools).
+  void SetParallelDecoding( bool parallel ) { this->ParallelDecoding = parallel; }
+  bool GetParallelDecoding() const { return this->ParallelDecoding; }
+
   // Reset erases all information about the current database.
   // It does not free memory allocated for the current chunk.
   void Reset();
@@ -257,6 +264,8 @@ protected:
   vtkIdType ChunkAlloc;
 
   bool FileHandlesClosed;
+  /// Whether chunks are decoded concurrently
+  bool ParallelDecoding;
   struct BufferingInfo;
   BufferingInfo* BufferInfo;
 };
@@ -70,6 +70,16 @@ class CellProperty
       memcpy(loc,values+startPos,len);
       loc = ((T*)loc) + numComps;
       }
+    template<typename T>
+    void setTuple(const vtkIdType& index, T* values)
+      {
+      memcpy(((T*)loc) + index*numComps,values+startPos,len);
+      }
+    template<typename T>
+    void skipTuples(const vtkIdType& numTuples)
+      {
+      loc = ((T*)loc) + numTuples*numComps;
+      }
     void resetForNextTimeStep()
       {
       loc = Data;
@@ -130,6 +140,26 @@ public:
       }
   }
 
+  template<typename T>
+  void SetCellInfo(const vtkIdType& index, T* cellproperty)
+  {
+    std::vector<CellProperty*>::iterator it;
+    for(it=Properties.begin();it!=Properties.end();++it)
+      {
+      (*it)->setTuple(index,cellproperty);
+      }
+  }
+
+  template<typename T>
+  void SkipCellInfo(const vtkIdType& numCells)
+  {
+    std::vector<CellProperty*>::iterator it;
+    for(it=Properties.begin();it!=Properties.end();++it)
+      {
+      (*it)->skipTuples<T>(numCells);
+      }
+  }
+
   void SetDeadCells(unsigned char* dead, const vtkIdType& size)
   {
     memcpy(this->DeadCells+this->DeadIndex,dead,sizeof(unsigned char)*size);
@@ -877,6 +907,47 @@ void vtkLSDynaPart::ReadCellProperties(double *cellProperties,
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkLSDynaPart::ReadCellProperties(float *cellProperties,
+                                       const vtkIdType& numCells,
+                                       const vtkIdType& numPropertiesInCell,
+                                       const vtkIdType& firstCell)
+{
+  float *cell = cellProperties;
+  for(vtkIdType i=0;i<numCells;++i)
+    {
+    this->CellProperties->SetCellInfo(firstCell+i,cell);
+    cell += numPropertiesInCell;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkLSDynaPart::ReadCellProperties(double *cellProperties,
+                                       const vtkIdType& numCells,
+                                       const vtkIdType& numPropertiesInCell,
+                                       const vtkIdType& firstCell)
+{
+  double *cell = cellProperties;
+  for(vtkIdType i=0;i<numCells;++i)
+    {
+    this->CellProperties->SetCellInfo(firstCell+i,cell);
+    cell += numPropertiesInCell;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkLSDynaPart::SkipCellProperties(const vtkIdType& numCells)
+{
+  if(this->DoubleBased)
+    {
+    this->CellProperties->SkipCellInfo<double>(numCells);
+    }
+  else
+    {
+    this->CellProperties->SkipCellInfo<float>(numCells);
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkIdType vtkLSDynaPart::GetMinGlobalPointId() const
 {
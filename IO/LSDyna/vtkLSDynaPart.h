@@ -125,6 +125,19 @@ public:
   void ReadCellProperties(double *cellsProperties, const vtkIdType& numCells,
                           const vtkIdType &numPropertiesInCell);
 
+  //Description:
+  //Same as above, but the cells are stored starting firstCell cells past
+  //the current read position, which is not advanced. Disjoint ranges of
+  //cells can be read concurrently this way; SkipCellProperties must then
+  //be called once with the total number of cells read.
+  void ReadCellProperties(float *cellProperties, const vtkIdType& numCells,
+                          const vtkIdType &numPropertiesInCell,
+                          const vtkIdType& firstCell);
+  void ReadCellProperties(double *cellsProperties, const vtkIdType& numCells,
+                          const vtkIdType &numPropertiesInCell,
+                          const vtkIdType& firstCell);
+  void SkipCellProperties(const vtkIdType& numCells);
+
   //Description:
   //Get the id of the lowest global point this part needs
   //Note: Presumes topology has been built already
@@ -26,6 +26,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -33,6 +34,7 @@
 #include <algorithm>
 #include <vector>
 #include <list>
+#include <map>
 
 //-----------------------------------------------------------------------------
 namespace
@@ -648,12 +650,59 @@ void vtkLSDynaPartCollection::FillCellProperties(double *buffer,
   this->FillCellArray(buffer,type,startId,numCells,numPropertiesInCell);
 }
 
+namespace
+{
+  //a range of cells of the state buffer that belong to a single part
+  template<typename T>
+  struct CellPropertyBlock
+    {
+    vtkLSDynaPart *part;
+    T *data;
+    vtkIdType numCells;
+    vtkIdType firstCell; //relative to the current read position of the part
+    };
+
+  //copies blocks of cell properties to their parts, the blocks of
+  //a given part never overlap so they can be copied concurrently
+  template<typename T>
+  class ReadCellPropertiesFunctor
+    {
+  public:
+    ReadCellPropertiesFunctor(const std::vector<CellPropertyBlock<T> > &blocks,
+                              const vtkIdType &numPropertiesInCell):
+      Blocks(blocks),NumPropertiesInCell(numPropertiesInCell)
+      {
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+      {
+      for(vtkIdType i=begin; i<end; ++i)
+        {
+        const CellPropertyBlock<T> &block = this->Blocks[i];
+        block.part->ReadCellProperties(block.data,block.numCells,
+          this->NumPropertiesInCell,block.firstCell);
+        }
+      }
+
+  protected:
+    const std::vector<CellPropertyBlock<T> > &Blocks;
+    vtkIdType NumPropertiesInCell;
+    };
+}
+
 //-----------------------------------------------------------------------------
 template<typename T>
 void vtkLSDynaPartCollection::FillCellArray(T *buffer,
   const LSDynaMetaData::LSDYNA_TYPES& type, const vtkIdType& startId,
   vtkIdType numCells, const int& numPropertiesInCell)
 {
+  if(this->MetaData->Fam.GetParallelDecoding())
+    {
+    this->FillCellArrayInParallel(buffer,type,startId,numCells,
+                                  numPropertiesInCell);
+    return;
+    }
+
   //we only need to iterate the array for the subsection we need
   T* loc = buffer;
   vtkIdType size, globalStartId;
@@ -676,6 +725,60 @@ void vtkLSDynaPartCollection::FillCellArray(T *buffer,
     }
 }
 
+//-----------------------------------------------------------------------------
+template<typename T>
+void vtkLSDynaPartCollection::FillCellArrayInParallel(T *buffer,
+  const LSDynaMetaData::LSDYNA_TYPES& type, const vtkIdType& startId,
+  vtkIdType numCells, const int& numPropertiesInCell)
+{
+  //split the subsection into blocks of at most blockSize cells of a
+  //single part, numbering the cells of each part from its current
+  //read position
+  const vtkIdType blockSize(4096);
+  std::vector<CellPropertyBlock<T> > blocks;
+  std::map<vtkLSDynaPart*,vtkIdType> numCellsRead;
+
+  T* loc = buffer;
+  vtkIdType size, globalStartId;
+  vtkLSDynaPart *part;
+  this->Storage->InitCellIteration(type,startId);
+  while(this->Storage->GetNextCellPart(globalStartId,size,part))
+    {
+    vtkIdType start = std::max(globalStartId,startId);
+    vtkIdType end = std::min(globalStartId+size,startId+numCells);
+    if(end<start)
+      {
+      break;
+      }
+    vtkIdType is = end - start;
+    if(part)
+      {
+      vtkIdType &firstCell = numCellsRead[part];
+      for(vtkIdType i=0; i<is; i+=blockSize)
+        {
+        CellPropertyBlock<T> block;
+        block.part = part;
+        block.data = loc + i * numPropertiesInCell;
+        block.numCells = std::min(blockSize,is-i);
+        block.firstCell = firstCell + i;
+        blocks.push_back(block);
+        }
+      firstCell += is;
+      }
+    loc += is * numPropertiesInCell;
+    }
+
+  ReadCellPropertiesFunctor<T> functor(blocks,numPropertiesInCell);
+  vtkSMPTools::For(0,static_cast<vtkIdType>(blocks.size()),1,functor);
+
+  //move the read position of each part past the cells we just stored
+  std::map<vtkLSDynaPart*,vtkIdType>::const_iterator it;
+  for(it = numCellsRead.begin(); it != numCellsRead.end(); ++it)
+    {
+    it->first->SkipCellProperties(it->second);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkLSDynaPartCollection::ReadCellUserIds(
     const LSDynaMetaData::LSDYNA_TYPES& type, const int& status)
@@ -914,6 +1017,37 @@ namespace
       }
       return false;
     }
+
+  //copies a chunk of a point property to each of the parts
+  template<typename T>
+  class ReadPointPropertyFunctor
+    {
+  public:
+    ReadPointPropertyFunctor(const std::vector<vtkLSDynaPart*> &parts,
+                             T *buffer, const vtkIdType &numTuples,
+                             const vtkIdType &numComps,
+                             const vtkIdType &offset):
+      Parts(parts),Buffer(buffer),NumTuples(numTuples),NumComps(numComps),
+      Offset(offset)
+      {
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+      {
+      for(vtkIdType i=begin; i<end; ++i)
+        {
+        this->Parts[i]->ReadPointBasedProperty(this->Buffer,this->NumTuples,
+                                               this->NumComps,this->Offset);
+        }
+      }
+
+  protected:
+    const std::vector<vtkLSDynaPart*> &Parts;
+    T *Buffer;
+    vtkIdType NumTuples;
+    vtkIdType NumComps;
+    vtkIdType Offset;
+    };
 }
 
 //-----------------------------------------------------------------------------
@@ -968,21 +1102,43 @@ void vtkLSDynaPartCollection::FillPointProperty(const vtkIdType& numTuples,
       partIt = sortedParts.begin();
       }
 
-    while(partIt!=sortedParts.end())
+    if(p->Fam.GetParallelDecoding())
+      {
+      //each part only writes to its own arrays
+      std::vector<vtkLSDynaPart*> chunkParts(partIt,sortedParts.end());
+      ReadPointPropertyFunctor<T> functor(chunkParts,buf,numPointsToRead,
+                                          numComps,offset);
+      vtkSMPTools::For(0,static_cast<vtkIdType>(chunkParts.size()),1,functor);
+      }
+    else
       {
-      //only read the points which have a point that lies within this section
-      //so we stop once the min is larger than our max id
-      (*partIt)->ReadPointBasedProperty(buf,numPointsToRead,numComps,offset);
-      ++partIt;
+      while(partIt!=sortedParts.end())
+        {
+        //only read the points which have a point that lies within this section
+        //so we stop once the min is larger than our max id
+        (*partIt)->ReadPointBasedProperty(buf,numPointsToRead,numComps,offset);
+        ++partIt;
+        }
       }
     }
   if(leftOver>0 && sortedParts.size() > 0)
     {
     p->Fam.BufferChunk(LSDynaFamily::Float, leftOver*numComps);
     buf = p->Fam.GetBufferAs<T>();
-    for (partIt = sortedParts.begin(); partIt!=sortedParts.end();++partIt)
+    if(p->Fam.GetParallelDecoding())
       {
-      (*partIt)->ReadPointBasedProperty(buf,leftOver,numComps,offset);
+      std::vector<vtkLSDynaPart*> chunkParts(sortedParts.begin(),
+                                             sortedParts.end());
+      ReadPointPropertyFunctor<T> functor(chunkParts,buf,leftOver,
+                                          numComps,offset);
+      vtkSMPTools::For(0,static_cast<vtkIdType>(chunkParts.size()),1,functor);
+      }
+    else
+      {
+      for (partIt = sortedParts.begin(); partIt!=sortedParts.end();++partIt)
+        {
+        (*partIt)->ReadPointBasedProperty(buf,leftOver,numComps,offset);
+        }
       }
     }
   p->Fam.SkipWords(numPointsToSkipEnd * numComps);
@@ -145,6 +145,14 @@ protected:
   void FillCellArray(T *buffer,const LSDynaMetaData::LSDYNA_TYPES& type,
      const vtkIdType& startId, vtkIdType numCells, const int& numTuples);
 
+  //Description:
+  //Same as FillCellArray, but the cells are copied to the parts
+  //concurrently.
+  template<typename T>
+  void FillCellArrayInParallel(T *buffer,
+     const LSDynaMetaData::LSDYNA_TYPES& type, const vtkIdType& startId,
+     vtkIdType numCells, const int& numTuples);
+
   template<typename T>
   void FillCellUserIdArray(T *buffer,const LSDynaMetaData::LSDYNA_TYPES& type,
      const vtkIdType& startId, vtkIdType numCells);
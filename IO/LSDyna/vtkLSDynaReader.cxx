@@ -526,6 +526,7 @@ vtkLSDynaReader::vtkLSDynaReader()
   this->DeformedMesh = 1;
   this->RemoveDeletedCells = 1;
   this->DeletedCellsAsGhostArray = 0;
+  this->UseParallelDecoding = 0;
   this->InputDeck = 0;
   this->Parts = NULL;
 }
@@ -558,6 +559,8 @@ void vtkLSDynaReader::PrintSelf( ostream &os, vtkIndent indent )
     }
   os << indent << "Show Deleted Cells as Ghost Cells: "<<
         (this->DeletedCellsAsGhostArray ? "On" : "Off") << endl;
+  os << indent << "UseParallelDecoding: "
+     << (this->UseParallelDecoding ? "On" : "Off") << endl;
 
   os << indent << "Dimensionality: " << this->GetDimensionality() << endl;
   os << indent << "Nodes: " << this->GetNumberOfNodes() << endl;
@@ -3414,6 +3417,7 @@ int vtkLSDynaReader::RequestData(
     }
   p->Fam.ClearBuffer();
   p->Fam.OpenFileHandles();
+  p->Fam.SetParallelDecoding(this->UseParallelDecoding != 0);
 
   vtkMultiBlockDataSet* mbds = 0;
   vtkInformation* oi = oinfo->GetInformationObject(0);
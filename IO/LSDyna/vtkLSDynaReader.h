@@ -426,6 +426,16 @@ public:
   vtkGetMacro(DeletedCellsAsGhostArray,int);
   vtkBooleanMacro(DeletedCellsAsGhostArray,int);
 
+  // Description:
+  // Should the state words of a time step be decoded into the per-part
+  // arrays concurrently (see vtkSMPTools)? The part topology is cached
+  // across time steps either way, so a change of time step only rereads
+  // the state variables. This only changes how the state is decoded, not
+  // the output. By default, this is false.
+  vtkSetMacro(UseParallelDecoding,int);
+  vtkGetMacro(UseParallelDecoding,int);
+  vtkBooleanMacro(UseParallelDecoding,int);
+
   // Description:
   // The name of the input deck corresponding to the current database.
   // This is used to determine the part names associated with each material ID.
@@ -470,6 +480,10 @@ protected:
   int RemoveDeletedCells;
   int DeletedCellsAsGhostArray;
 
+  // Description:
+  // Should state words be decoded concurrently? By default, this is false.
+  int UseParallelDecoding;
+
   // Description:
   // The range of time steps available within a database.
   // Only valid after UpdateInformation() is called on the reader.
@@ -0,0 +1,330 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMPASReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the grid cache of vtkMPASReader
+// .SECTION Description
+// Writes a small MPAS file and steps through its time steps.  The grid
+// must be reused between time steps while the variables change, and be
+// rebuilt when a setting that shapes the grid changes.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkInformation.h"
+#include "vtkMath.h"
+#include "vtkMPASReader.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include "vtk_netcdf.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int NumberOfLatitudes = 5;
+const int NumberOfLongitudes = 8;
+const int NumberOfLevels = 3;
+const int NumberOfTimeSteps = 3;
+
+#define CHECK_NC(call) \
+  if ((call) != NC_NOERR) \
+    { \
+    cerr << "NetCDF error in " #call << endl; \
+    return false; \
+    }
+
+// The sea surface height of MPAS cell c (point c + 1 of the output).
+double SeaSurfaceHeight(int t, int c)
+{
+  return 100.0 * t + 0.5 * c;
+}
+
+// A band of the sphere, split into triangles whose corners are cells.
+bool WriteFile(const std::string &fileName)
+{
+  int numberOfCells = NumberOfLatitudes * NumberOfLongitudes;
+  int numberOfVertices = 2 * (NumberOfLatitudes - 1) * NumberOfLongitudes;
+
+  int ncid;
+  CHECK_NC(nc_create(fileName.c_str(), NC_CLOBBER, &ncid));
+  int cellDim, vertexDim, degreeDim, timeDim, levelDim;
+  CHECK_NC(nc_def_dim(ncid, "nCells", numberOfCells, &cellDim));
+  CHECK_NC(nc_def_dim(ncid, "nVertices", numberOfVertices, &vertexDim));
+  CHECK_NC(nc_def_dim(ncid, "vertexDegree", 3, &degreeDim));
+  CHECK_NC(nc_def_dim(ncid, "Time", NC_UNLIMITED, &timeDim));
+  CHECK_NC(nc_def_dim(ncid, "nVertLevels", NumberOfLevels, &levelDim));
+
+  const char *coordinateNames[5] =
+    { "xCell", "yCell", "zCell", "lonCell", "latCell" };
+  int coordinateVars[5];
+  for (int i = 0; i < 5; ++i)
+    {
+    CHECK_NC(nc_def_var(ncid, coordinateNames[i], NC_DOUBLE, 1, &cellDim,
+                        &coordinateVars[i]));
+    }
+  int dims[3] = { vertexDim, degreeDim, 0 };
+  int connectivityVar;
+  CHECK_NC(nc_def_var(ncid, "cellsOnVertex", NC_INT, 2, dims,
+                      &connectivityVar));
+  dims[0] = timeDim;
+  dims[1] = cellDim;
+  int sshVar;
+  CHECK_NC(nc_def_var(ncid, "ssh", NC_DOUBLE, 2, dims, &sshVar));
+  dims[2] = levelDim;
+  int temperatureVar;
+  CHECK_NC(nc_def_var(ncid, "temperature", NC_DOUBLE, 3, dims,
+                      &temperatureVar));
+  CHECK_NC(nc_enddef(ncid));
+
+  const double radius = 6371000.0;
+  std::vector<double> coordinates[5];
+  for (int i = 0; i < 5; ++i)
+    {
+    coordinates[i].resize(numberOfCells);
+    }
+  for (int i = 0; i < NumberOfLatitudes; ++i)
+    {
+    for (int j = 0; j < NumberOfLongitudes; ++j)
+      {
+      int c = i * NumberOfLongitudes + j;
+      double lat = -1.2 + 2.4 * i / (NumberOfLatitudes - 1);
+      double lon = 2.0 * vtkMath::Pi() * j / NumberOfLongitudes - 3.0;
+      coordinates[0][c] = radius * cos(lat) * cos(lon);
+      coordinates[1][c] = radius * cos(lat) * sin(lon);
+      coordinates[2][c] = radius * sin(lat);
+      coordinates[3][c] = lon;
+      coordinates[4][c] = lat;
+      }
+    }
+  for (int i = 0; i < 5; ++i)
+    {
+    CHECK_NC(nc_put_var_double(ncid, coordinateVars[i], &coordinates[i][0]));
+    }
+
+  // Cell ids in cellsOnVertex start at 1.
+  std::vector<int> connectivity;
+  for (int i = 0; i < NumberOfLatitudes - 1; ++i)
+    {
+    for (int j = 0; j < NumberOfLongitudes; ++j)
+      {
+      int c00 = i * NumberOfLongitudes + j + 1;
+      int c01 = i * NumberOfLongitudes + (j + 1) % NumberOfLongitudes + 1;
+      int c10 = c00 + NumberOfLongitudes;
+      int c11 = c01 + NumberOfLongitudes;
+      int triangles[6] = { c00, c01, c11, c00, c11, c10 };
+      connectivity.insert(connectivity.end(), triangles, triangles + 6);
+      }
+    }
+  CHECK_NC(nc_put_var_int(ncid, connectivityVar, &connectivity[0]));
+
+  for (int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+    std::vector<double> ssh(numberOfCells);
+    std::vector<double> temperature(numberOfCells * NumberOfLevels);
+    for (int c = 0; c < numberOfCells; ++c)
+      {
+      ssh[c] = SeaSurfaceHeight(t, c);
+      for (int l = 0; l < NumberOfLevels; ++l)
+        {
+        temperature[c * NumberOfLevels + l] = 1000.0 * t + c + 0.01 * l;
+        }
+      }
+    size_t start[3] = { static_cast<size_t>(t), 0, 0 };
+    size_t count[3] = { 1, static_cast<size_t>(numberOfCells),
+                        static_cast<size_t>(NumberOfLevels) };
+    CHECK_NC(nc_put_vara_double(ncid, sshVar, start, count, &ssh[0]));
+    CHECK_NC(nc_put_vara_double(ncid, temperatureVar, start, count,
+                                &temperature[0]));
+    }
+
+  CHECK_NC(nc_close(ncid));
+  return true;
+}
+
+// The parts of an output that are compared between updates.  The arrays
+// are held so that their addresses cannot be reused by new ones.
+struct Grid
+{
+  vtkSmartPointer<vtkDataArray> Points;
+  vtkSmartPointer<vtkCellArray> Cells;
+  vtkSmartPointer<vtkDataArray> SSH;
+};
+
+Grid Update(vtkMPASReader *reader, int timeStep)
+{
+  reader->UpdateInformation();
+  reader->GetOutputInformation(0)->Set(
+    vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), timeStep);
+  reader->Update();
+
+  vtkUnstructuredGrid *output = reader->GetOutput();
+  Grid grid;
+  grid.Points = output->GetPoints() ? output->GetPoints()->GetData() : NULL;
+  grid.Cells = output->GetCells();
+  grid.SSH = output->GetPointData()->GetArray("ssh");
+  return grid;
+}
+
+bool CheckTimeStep(const Grid &grid, int timeStep)
+{
+  if (!grid.Points || !grid.Cells || !grid.SSH)
+    {
+    cerr << "Incomplete output at time step " << timeStep << endl;
+    return false;
+    }
+  // Point 0 is a dummy point.
+  for (int c = 0; c < NumberOfLatitudes * NumberOfLongitudes; c += 7)
+    {
+    if (grid.SSH->GetComponent(c + 1, 0) != SeaSurfaceHeight(timeStep, c))
+      {
+      cerr << "Wrong ssh for cell " << c << " at time step " << timeStep
+           << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool Reused(const Grid &previous, const Grid &current, const char *what)
+{
+  if (current.Points != previous.Points || current.Cells != previous.Cells)
+    {
+    cerr << "The grid was rebuilt " << what << endl;
+    return false;
+    }
+  return true;
+}
+
+bool Rebuilt(const Grid &previous, const Grid &current, const char *what)
+{
+  if (current.Points == previous.Points || current.Cells == previous.Cells)
+    {
+    cerr << "The grid was not rebuilt " << what << endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+int TestMPASReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string fileName = tempDir;
+  delete [] tempDir;
+  fileName += "/TestMPASReaderCache.nc";
+
+  if (!WriteFile(fileName))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMPASReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  reader->EnableAllPointArrays();
+
+  // The grid is shared by all time steps.
+  Grid step0 = Update(reader.GetPointer(), 0);
+  Grid step1 = Update(reader.GetPointer(), 1);
+  Grid step2 = Update(reader.GetPointer(), 2);
+  if (!CheckTimeStep(step0, 0) || !CheckTimeStep(step1, 1) ||
+      !CheckTimeStep(step2, 2) ||
+      !Reused(step0, step1, "for time step 1") ||
+      !Reused(step0, step2, "for time step 2"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Projecting to lat/lon shapes the grid, so it is rebuilt, and then
+  // shared again.
+  reader->SetProjectLatLon(true);
+  Grid projected1 = Update(reader.GetPointer(), 1);
+  Grid projected0 = Update(reader.GetPointer(), 0);
+  if (!CheckTimeStep(projected1, 1) || !CheckTimeStep(projected0, 0) ||
+      !Rebuilt(step1, projected1, "when projecting to lat/lon") ||
+      !Reused(projected1, projected0, "for a projected time step"))
+    {
+    return EXIT_FAILURE;
+    }
+  double bounds[6];
+  reader->GetOutput()->GetBounds(bounds);
+  if (bounds[4] != 0.0 || bounds[5] != 0.0)
+    {
+    cerr << "The projected grid is not flat" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The multilayer view has a layer of points per level.
+  reader->SetProjectLatLon(false);
+  reader->SetShowMultilayerView(true);
+  Grid layers2 = Update(reader.GetPointer(), 2);
+  if (!Rebuilt(step2, layers2, "for the multilayer view") ||
+      layers2.Points->GetNumberOfTuples() <= step2.Points->GetNumberOfTuples())
+    {
+    cerr << "Wrong multilayer grid" << endl;
+    return EXIT_FAILURE;
+    }
+  Grid layers1 = Update(reader.GetPointer(), 1);
+  if (!Reused(layers2, layers1, "for a multilayer time step"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Back to the original settings, which must rebuild the original grid.
+  reader->SetShowMultilayerView(false);
+  Grid again0 = Update(reader.GetPointer(), 0);
+  if (!CheckTimeStep(again0, 0) ||
+      !Rebuilt(layers1, again0, "for the single layer view") ||
+      again0.Points->GetNumberOfTuples() != step0.Points->GetNumberOfTuples())
+    {
+    return EXIT_FAILURE;
+    }
+  for (vtkIdType i = 0; i < again0.Points->GetNumberOfTuples(); ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      if (again0.Points->GetComponent(i, j) != step0.Points->GetComponent(i, j))
+        {
+        cerr << "The rebuilt grid differs from the first one" << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Without a cache, every time step builds its own grid.
+  reader->SetGeometryCacheSize(0);
+  Grid uncached1 = Update(reader.GetPointer(), 1);
+  Grid uncached2 = Update(reader.GetPointer(), 2);
+  if (!CheckTimeStep(uncached1, 1) || !CheckTimeStep(uncached2, 2) ||
+      !Rebuilt(uncached1, uncached2, "with the cache disabled"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestNetCDFCFReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the geometry cache of vtkNetCDFCFReader
+// .SECTION Description
+// Writes a small curvilinear CF file and steps through its time steps.
+// The points must be reused between time steps while the variables
+// change, and be rebuilt when a setting that shapes the grid changes.
+
+#include "vtkDataArray.h"
+#include "vtkInformation.h"
+#include "vtkNetCDFCFReader.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+
+#include "vtk_netcdf.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int NumberOfLevels = 3;
+const int NumberOfRows = 6;
+const int NumberOfColumns = 9;
+const int NumberOfTimeSteps = 3;
+
+#define CHECK_NC(call) \
+  if ((call) != NC_NOERR) \
+    { \
+    cerr << "NetCDF error in " #call << endl; \
+    return false; \
+    }
+
+// The value of variable w at time step t and point i.
+double W(int t, int i)
+{
+  return 0.5 * i - 10.0 * t;
+}
+
+bool PutText(int ncid, int var, const char *name, const char *text)
+{
+  CHECK_NC(nc_put_att_text(ncid, var, name, strlen(text), text));
+  return true;
+}
+
+// A curvilinear lon/lat grid with a vertical coordinate.
+bool WriteFile(const std::string &fileName)
+{
+  int ncid;
+  CHECK_NC(nc_create(fileName.c_str(), NC_CLOBBER, &ncid));
+  int timeDim, levelDim, rowDim, columnDim;
+  CHECK_NC(nc_def_dim(ncid, "time", NC_UNLIMITED, &timeDim));
+  CHECK_NC(nc_def_dim(ncid, "lev", NumberOfLevels, &levelDim));
+  CHECK_NC(nc_def_dim(ncid, "y", NumberOfRows, &rowDim));
+  CHECK_NC(nc_def_dim(ncid, "x", NumberOfColumns, &columnDim));
+
+  int timeVar, levelVar, latVar, lonVar, wVar;
+  CHECK_NC(nc_def_var(ncid, "time", NC_DOUBLE, 1, &timeDim, &timeVar));
+  CHECK_NC(nc_def_var(ncid, "lev", NC_DOUBLE, 1, &levelDim, &levelVar));
+  int dims[4] = { rowDim, columnDim, 0, 0 };
+  CHECK_NC(nc_def_var(ncid, "lat", NC_DOUBLE, 2, dims, &latVar));
+  CHECK_NC(nc_def_var(ncid, "lon", NC_DOUBLE, 2, dims, &lonVar));
+  dims[0] = timeDim;
+  dims[1] = levelDim;
+  dims[2] = rowDim;
+  dims[3] = columnDim;
+  CHECK_NC(nc_def_var(ncid, "w", NC_DOUBLE, 4, dims, &wVar));
+  if (!PutText(ncid, timeVar, "units", "days since 2000-01-01") ||
+      !PutText(ncid, levelVar, "units", "m") ||
+      !PutText(ncid, levelVar, "axis", "Z") ||
+      !PutText(ncid, latVar, "units", "degrees_north") ||
+      !PutText(ncid, lonVar, "units", "degrees_east") ||
+      !PutText(ncid, wVar, "coordinates", "lon lat"))
+    {
+    return false;
+    }
+  CHECK_NC(nc_enddef(ncid));
+
+  std::vector<double> levels(NumberOfLevels);
+  for (int i = 0; i < NumberOfLevels; ++i)
+    {
+    levels[i] = 1000.0 + 50.0 * i;
+    }
+  CHECK_NC(nc_put_var_double(ncid, levelVar, &levels[0]));
+
+  std::vector<double> lat(NumberOfRows * NumberOfColumns);
+  std::vector<double> lon(NumberOfRows * NumberOfColumns);
+  for (int j = 0; j < NumberOfRows; ++j)
+    {
+    for (int i = 0; i < NumberOfColumns; ++i)
+      {
+      lat[j * NumberOfColumns + i] = -60.0 + 20.0 * j + 3.0 * sin(0.3 * i);
+      lon[j * NumberOfColumns + i] = 10.0 + 25.0 * i + 2.0 * cos(0.4 * j);
+      }
+    }
+  CHECK_NC(nc_put_var_double(ncid, latVar, &lat[0]));
+  CHECK_NC(nc_put_var_double(ncid, lonVar, &lon[0]));
+
+  std::vector<double> w(NumberOfLevels * NumberOfRows * NumberOfColumns);
+  for (int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+    size_t index = static_cast<size_t>(t);
+    double time = 1.5 * t;
+    CHECK_NC(nc_put_var1_double(ncid, timeVar, &index, &time));
+    for (size_t i = 0; i < w.size(); ++i)
+      {
+      w[i] = W(t, static_cast<int>(i));
+      }
+    size_t start[4] = { index, 0, 0, 0 };
+    size_t count[4] = { 1, NumberOfLevels, NumberOfRows, NumberOfColumns };
+    CHECK_NC(nc_put_vara_double(ncid, wVar, start, count, &w[0]));
+    }
+
+  CHECK_NC(nc_close(ncid));
+  return true;
+}
+
+// The parts of an output that are compared between updates.  The arrays
+// are held so that their addresses cannot be reused by new ones.
+struct Grid
+{
+  vtkSmartPointer<vtkDataArray> Points;
+  vtkSmartPointer<vtkDataArray> W;
+};
+
+Grid Update(vtkNetCDFCFReader *reader, int timeStep)
+{
+  reader->UpdateInformation();
+  reader->GetOutputInformation(0)->Set(
+    vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), 1.5 * timeStep);
+  reader->Update();
+
+  Grid grid;
+  vtkStructuredGrid *output =
+    vtkStructuredGrid::SafeDownCast(reader->GetOutput());
+  if (output)
+    {
+    grid.Points = output->GetPoints() ? output->GetPoints()->GetData() : NULL;
+    grid.W = output->GetPointData()->GetArray("w");
+    }
+  return grid;
+}
+
+bool CheckTimeStep(const Grid &grid, int timeStep)
+{
+  vtkIdType numberOfPoints = NumberOfLevels * NumberOfRows * NumberOfColumns;
+  if (!grid.Points || !grid.W ||
+      grid.Points->GetNumberOfTuples() != numberOfPoints ||
+      grid.W->GetNumberOfTuples() != numberOfPoints)
+    {
+    cerr << "Incomplete output at time step " << timeStep << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    if (grid.W->GetComponent(i, 0) != W(timeStep, i))
+      {
+      cerr << "Wrong w for point " << i << " at time step " << timeStep
+           << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool Reused(const Grid &previous, const Grid &current, const char *what)
+{
+  if (current.Points != previous.Points)
+    {
+    cerr << "The points were rebuilt " << what << endl;
+    return false;
+    }
+  return true;
+}
+
+bool Rebuilt(const Grid &previous, const Grid &current, const char *what)
+{
+  if (current.Points == previous.Points)
+    {
+    cerr << "The points were not rebuilt " << what << endl;
+    return false;
+    }
+  return true;
+}
+
+bool SamePoints(const Grid &a, const Grid &b)
+{
+  if (a.Points->GetNumberOfTuples() != b.Points->GetNumberOfTuples())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a.Points->GetNumberOfTuples(); ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      if (a.Points->GetComponent(i, j) != b.Points->GetComponent(i, j))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+int TestNetCDFCFReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string fileName = tempDir;
+  delete [] tempDir;
+  fileName += "/TestNetCDFCFReaderCache.nc";
+
+  if (!WriteFile(fileName))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkNetCDFCFReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  reader->SetVariableArrayStatus("w", 1);
+
+  // The points are shared by all time steps.
+  Grid step0 = Update(reader.GetPointer(), 0);
+  Grid step1 = Update(reader.GetPointer(), 1);
+  Grid step2 = Update(reader.GetPointer(), 2);
+  if (!CheckTimeStep(step0, 0) || !CheckTimeStep(step1, 1) ||
+      !CheckTimeStep(step2, 2) ||
+      !Reused(step0, step1, "for time step 1") ||
+      !Reused(step0, step2, "for time step 2"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Cartesian coordinates shape the grid, so the points are rebuilt, and
+  // then shared again.
+  reader->SphericalCoordinatesOff();
+  Grid cartesian1 = Update(reader.GetPointer(), 1);
+  Grid cartesian0 = Update(reader.GetPointer(), 0);
+  if (!CheckTimeStep(cartesian1, 1) || !CheckTimeStep(cartesian0, 0) ||
+      !Rebuilt(step1, cartesian1, "for Cartesian coordinates") ||
+      !Reused(cartesian1, cartesian0, "for a Cartesian time step"))
+    {
+    return EXIT_FAILURE;
+    }
+  if (SamePoints(step0, cartesian0))
+    {
+    cerr << "Cartesian points are the same as spherical ones" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // So does the vertical scale.
+  reader->SphericalCoordinatesOn();
+  reader->SetVerticalScale(2.0);
+  Grid scaled2 = Update(reader.GetPointer(), 2);
+  if (!CheckTimeStep(scaled2, 2) ||
+      !Rebuilt(cartesian0, scaled2, "for a new vertical scale") ||
+      SamePoints(step2, scaled2))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Back to the original settings, which must rebuild the original points.
+  reader->SetVerticalScale(1.0);
+  Grid again1 = Update(reader.GetPointer(), 1);
+  if (!CheckTimeStep(again1, 1) ||
+      !Rebuilt(scaled2, again1, "for the original vertical scale"))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!SamePoints(step1, again1))
+    {
+    cerr << "The rebuilt points differ from the first ones" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without a cache, every time step builds its own points.
+  reader->SetGeometryCacheSize(0);
+  Grid uncached0 = Update(reader.GetPointer(), 0);
+  Grid uncached2 = Update(reader.GetPointer(), 2);
+  if (!CheckTimeStep(uncached0, 0) || !CheckTimeStep(uncached2, 2) ||
+      !Rebuilt(again1, uncached0, "with the cache disabled") ||
+      !Rebuilt(uncached0, uncached2, "with the cache disabled"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
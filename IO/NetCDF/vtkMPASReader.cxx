@@ -71,6 +71,8 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkDataArraySelection.h"
 #include "vtkDataObject.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationDoubleVectorKey.h"
 #include "vtkInformationVector.h"
@@ -78,10 +80,12 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkToolkits.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include "vtk_netcdfcpp.h"
@@ -107,7 +111,9 @@ using namespace std;
 class vtkMPASReader::Internal {
   public:
   Internal() :
-    ncFile(NULL)
+    ncFile(NULL),
+    GeometryCached(false),
+    GeometrySize(0.0)
   {
     for (int i = 0; i < MAX_VARS; i++)
       {
@@ -123,9 +129,42 @@ class vtkMPASReader::Internal {
       }
   };
 
+  // Record the settings that shape the grid.
+  void GetGeometrySettings(vtkMPASReader *reader, int settings[7])
+  {
+    settings[0] = reader->ProjectLatLon;
+    settings[1] = reader->ShowMultilayerView;
+    settings[2] = reader->IsAtmosphere;
+    settings[3] = reader->IsZeroCentered;
+    settings[4] = reader->LayerThickness;
+    settings[5] = reader->CenterLon;
+    settings[6] = reader->VerticalLevelSelected;
+  };
+
+  void ReleaseGeometry()
+  {
+    this->GeometryCached = false;
+    this->Points = NULL;
+    this->Cells = NULL;
+    this->CellTypes = NULL;
+    this->CellLocations = NULL;
+    this->CellMask = NULL;
+  };
+
   NcFile* ncFile;
   NcVar* cellVars[MAX_VARS];
   NcVar* pointVars[MAX_VARS];
+
+  // Grid built by the last call to ReadAndOutputGrid, kept while the
+  // settings it was built with stay the same.
+  bool GeometryCached;
+  int GeometrySettings[7];
+  double GeometrySize;
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Cells;
+  vtkSmartPointer<vtkUnsignedCharArray> CellTypes;
+  vtkSmartPointer<vtkIdTypeArray> CellLocations;
+  vtkSmartPointer<vtkDataArray> CellMask;
 };
 
 
@@ -258,6 +297,250 @@ static int SphericalToCartesian(double rho, double phi, double theta, double* x,
 }
 
 
+//----------------------------------------------------------------------------
+//  Functor computing the output points of a range of grid points, one
+//  point or one column of points per grid point.
+//----------------------------------------------------------------------------
+
+class vtkMPASReaderPointBuilder
+{
+public:
+  const double *PointX;
+  const double *PointY;
+  const double *PointZ;
+  bool ProjectLatLon;
+  bool ShowMultilayerView;
+  int MaximumNVertLevels;
+  float AdjustedLayerThickness;
+  float *Output;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkIdType pointsPerColumn =
+      this->ShowMultilayerView ? this->MaximumNVertLevels + 1 : 1;
+    for (vtkIdType j = begin; j < end; j++)
+      {
+      float *out = this->Output + 3 * j * pointsPerColumn;
+      double x, y, z;
+
+      if (this->ProjectLatLon)
+        {
+        x = this->PointX[j] * 180.0 / vtkMath::Pi();
+        y = this->PointY[j] * 180.0 / vtkMath::Pi();
+        z = 0.0;
+        }
+      else
+        {
+        x = this->PointX[j];
+        y = this->PointY[j];
+        z = this->PointZ[j];
+        }
+
+      if (!this->ShowMultilayerView)
+        {
+        out[0] = static_cast<float>(x);
+        out[1] = static_cast<float>(y);
+        out[2] = static_cast<float>(z);
+        continue;
+        }
+
+      double rho=0.0, rholevel=0.0, theta=0.0, phi=0.0;
+      int retval = -1;
+
+      if (!this->ProjectLatLon)
+        {
+        if ((x != 0.0) || (y != 0.0) || (z != 0.0))
+          {
+          retval = CartesianToSpherical(x, y, z, &rho, &phi, &theta);
+          }
+        }
+
+      for (int levelNum = 0; levelNum < this->MaximumNVertLevels+1; levelNum++)
+        {
+        if (this->ProjectLatLon)
+          {
+          z = -(double)((levelNum)*this->AdjustedLayerThickness);
+          }
+        else
+          {
+          if (!retval && ((x != 0.0) || (y != 0.0) || (z != 0.0)))
+            {
+            rholevel = rho - (this->AdjustedLayerThickness * levelNum);
+            retval = SphericalToCartesian(rholevel, phi, theta, &x, &y, &z);
+            }
+          }
+        *out++ = static_cast<float>(x);
+        *out++ = static_cast<float>(y);
+        *out++ = static_cast<float>(z);
+        }
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+//  Functor writing the connectivity of a range of grid cells, one cell or
+//  one column of cells per grid cell.  Cells below the bottom topography
+//  get all their points set to zero.
+//----------------------------------------------------------------------------
+
+class vtkMPASReaderCellBuilder
+{
+public:
+  const int *Connections;
+  const int *OrigConnections;
+  const int *CellMap;
+  const int *MaximumLevelPoint;
+  bool IncludeTopography;
+  bool ShowMultilayerView;
+  int NumberOfCells;
+  int CellOffset;
+  int PointsPerCell;
+  int MaximumNVertLevels;
+  int VerticalLevelSelected;
+  vtkIdType *Output;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    int pointsPerPolygon = this->PointsPerCell;
+    vtkIdType cellsPerColumn = 1;
+    if (this->ShowMultilayerView)
+      {
+      pointsPerPolygon = 2 * this->PointsPerCell;
+      cellsPerColumn = this->MaximumNVertLevels;
+      }
+    vtkIdType *out = this->Output + begin * cellsPerColumn * (pointsPerPolygon + 1);
+
+    for (vtkIdType j = begin; j < end; j++)
+      {
+      const int *conns = this->Connections + (j * this->PointsPerCell);
+
+      int minLevel = 0;
+      if (this->IncludeTopography)
+        {
+        //check if it is a mirror cell, if so, get original
+        const int* connections;
+        if (j >= this->NumberOfCells + this->CellOffset)
+          {
+          int origCellNum =
+            this->CellMap[j - this->NumberOfCells - this->CellOffset];
+          connections = this->OrigConnections + (origCellNum*this->PointsPerCell);
+          }
+        else
+          {
+          connections = this->OrigConnections + (j * this->PointsPerCell);
+          }
+
+        // Take the min of the MaximumLevelPoint of each point
+        minLevel = this->MaximumLevelPoint[connections[0]];
+        for (int k = 1; k < this->PointsPerCell; k++)
+          {
+          minLevel = min(minLevel, this->MaximumLevelPoint[connections[k]]);
+          }
+        }
+
+      if (!this->ShowMultilayerView)
+        {
+        // If that min is greater than or equal to this output level,
+        // include the cell, otherwise set all points to zero.
+        bool hidden = this->IncludeTopography &&
+          ((minLevel-1) < this->VerticalLevelSelected);
+        *out++ = pointsPerPolygon;
+        for (int k = 0; k < this->PointsPerCell; k++)
+          {
+          *out++ = hidden ? 0 : conns[k];
+          }
+        continue;
+        }
+
+      // multilayer: for each level, write the cell
+      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
+        {
+        *out++ = pointsPerPolygon;
+        if (this->IncludeTopography && ((minLevel-1) < levelNum))
+          {
+          for (int k = 0; k < pointsPerPolygon; k++)
+            {
+            *out++ = 0;
+            }
+          continue;
+          }
+        for (int k = 0; k < this->PointsPerCell; k++)
+          {
+          *out++ = (conns[k]*(this->MaximumNVertLevels+1)) + levelNum;
+          }
+        for (int k = 0; k < this->PointsPerCell; k++)
+          {
+          *out++ = (conns[k]*(this->MaximumNVertLevels+1)) + levelNum + 1;
+          }
+        }
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+//  Functor putting out the data of a range of output points.  In multilayer
+//  view, Input holds the values read for the grid points, either one per
+//  point or one per point and level, and every column of output points gets
+//  the values of its grid point with the last level repeated on top.  Point 0
+//  is a dummy copy of point 1 and extra points use the data of the point
+//  they mirror.
+//----------------------------------------------------------------------------
+
+class vtkMPASReaderPointDataScatter
+{
+public:
+  const int *PointMap;
+  int NumberOfPoints;
+  int PointOffset;
+  bool ShowMultilayerView;
+  int MaximumNVertLevels;
+  bool Layered;
+  const double *Input;
+  double *Output;
+
+  int SourcePoint(vtkIdType j) const
+  {
+    if (j < this->PointOffset)
+      {
+      return this->PointOffset;
+      }
+    if (j < this->PointOffset + this->NumberOfPoints)
+      {
+      return static_cast<int>(j);
+      }
+    return this->PointMap[j - this->NumberOfPoints - this->PointOffset];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    if (!this->ShowMultilayerView)
+      {
+      for (vtkIdType j = begin; j < end; j++)
+        {
+        this->Output[j] = this->Output[this->SourcePoint(j)];
+        }
+      return;
+      }
+
+    int levels = this->MaximumNVertLevels;
+    for (vtkIdType j = begin; j < end; j++)
+      {
+      vtkIdType source = this->SourcePoint(j) - this->PointOffset;
+      double *out = this->Output + j * (levels + 1);
+      if (this->Layered)
+        {
+        const double *in = this->Input + source * levels;
+        std::copy(in, in + levels, out);
+        out[levels] = in[levels - 1];
+        }
+      else
+        {
+        std::fill(out, out + levels + 1, this->Input[source]);
+        }
+      }
+  }
+};
+
 vtkStandardNewMacro(vtkMPASReader);
 
 //----------------------------------------------------------------------------
@@ -307,7 +590,32 @@ void vtkMPASReader::DestroyData()
 {
   vtkDebugMacro(<< "DestroyData..." << endl);
   // vars are okay, just delete var data storage
+  this->DestroyVariableData(false);
+
+  // delete old geometry and create new
+  this->Internals->ReleaseGeometry();
+
+  delete []this->PointVarData;
+  this->PointVarData = NULL;
+
+  free(this->CellMap);
+  this->CellMap = NULL;
+
+  free(this->PointMap);
+  this->PointMap = NULL;
 
+  free(this->MaximumLevelPoint);
+  this->MaximumLevelPoint = NULL;
+}
+
+//----------------------------------------------------------------------------
+//  Destroys the data arrays of the variables.  Arrays of variables without
+//  a Time dimension are kept if keepTimeInvariant is set, since they are
+//  the same for every time step.
+//----------------------------------------------------------------------------
+
+void vtkMPASReader::DestroyVariableData(bool keepTimeInvariant)
+{
   vtkDebugMacro(<< "Destructing cell var data..." << endl);
   if (this->CellVarDataArray)
     {
@@ -326,27 +634,15 @@ void vtkMPASReader::DestroyData()
     {
     for (int i = 0; i < this->NumberOfPointVars; i++)
       {
-      if (this->PointVarDataArray[i] != NULL)
+      if (this->PointVarDataArray[i] != NULL &&
+          !(keepTimeInvariant &&
+            this->Internals->pointVars[i]->num_dims() == 1))
         {
         this->PointVarDataArray[i]->Delete();
         this->PointVarDataArray[i] = NULL;
         }
       }
     }
-
-  // delete old geometry and create new
-
-  delete []this->PointVarData;
-  this->PointVarData = NULL;
-
-  free(this->CellMap);
-  this->CellMap = NULL;
-
-  free(this->PointMap);
-  this->PointMap = NULL;
-
-  free(this->MaximumLevelPoint);
-  this->MaximumLevelPoint = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -519,15 +815,24 @@ int vtkMPASReader::RequestData(vtkInformation *vtkNotUsed(reqInfo),
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
       outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  // Output the unstructured grid from the netCDF file
-  if (this->DataRequested)
+  // Reuse the grid of the previous request if the settings that shape it
+  // are unchanged, otherwise output the unstructured grid from the netCDF
+  // file.
+  if (this->RestoreCachedGeometry(output))
     {
-    this->DestroyData();
+    this->DestroyVariableData(true);
     }
-
-  if (!this->ReadAndOutputGrid(true))
+  else
     {
-    return 0;
+    if (this->DataRequested)
+      {
+      this->DestroyData();
+      }
+
+    if (!this->ReadAndOutputGrid(true))
+      {
+      return 0;
+      }
     }
 
   // Collect the time step requested
@@ -567,10 +872,14 @@ int vtkMPASReader::RequestData(vtkInformation *vtkNotUsed(reqInfo),
     // Is this variable requested
     if (this->PointDataArraySelection->GetArraySetting(var))
       {
-      vtkDebugMacro( << "Loading Point Variable: " << var << endl);
-      if (!this->LoadPointVarData(var, this->DTime))
+      // Arrays kept from the previous request are time-invariant.
+      if (this->PointVarDataArray[var] == NULL)
         {
-        return 0;
+        vtkDebugMacro( << "Loading Point Variable: " << var << endl);
+        if (!this->LoadPointVarData(var, this->DTime))
+          {
+          return 0;
+          }
         }
       output->GetPointData()->AddArray(this->PointVarDataArray[var]);
 
@@ -625,6 +934,8 @@ void vtkMPASReader::SetDefaults() {
   this->DoBugFix = false;
   this->CenterRad = CenterLon * vtkMath::Pi() / 180.0;
 
+  this->GeometryCacheSize = 1024.0;
+
   this->PointX = NULL;
   this->PointY = NULL;
   this->PointZ = NULL;
@@ -918,12 +1229,90 @@ int vtkMPASReader::ReadAndOutputGrid(bool init)
   delete []this->PointVarData;
   this->PointVarData = new double[this->MaximumPoints];
 
+  this->CacheGeometry();
+
   vtkDebugMacro(<< "Leaving vtkMPASReader::ReadAndOutputGrid" << endl);
 
   return(1);
 }
 
 
+//----------------------------------------------------------------------------
+//  Keep the grid just output, unless it is larger than GeometryCacheSize.
+//  The maps and buffers used to load variables on it are kept alive until
+//  the next call to DestroyData.
+//----------------------------------------------------------------------------
+
+void vtkMPASReader::CacheGeometry()
+{
+  Internal *cache = this->Internals;
+  cache->ReleaseGeometry();
+
+  vtkUnstructuredGrid *output = this->GetOutput();
+  if (!output->GetPoints() || !output->GetCells())
+    {
+    return;
+    }
+
+  // GetActualMemorySize() is in KiB.
+  double size = output->GetPoints()->GetData()->GetActualMemorySize() +
+    output->GetCells()->GetActualMemorySize() +
+    output->GetCellTypesArray()->GetActualMemorySize() +
+    output->GetCellLocationsArray()->GetActualMemorySize();
+  if (size > 1024.0 * this->GeometryCacheSize)
+    {
+    vtkDebugMacro(<< "Grid of " << size << " KiB is not cached" << endl);
+    return;
+    }
+
+  cache->Points = output->GetPoints();
+  cache->Cells = output->GetCells();
+  cache->CellTypes = output->GetCellTypesArray();
+  cache->CellLocations = output->GetCellLocationsArray();
+  cache->CellMask = output->GetCellData()->GetArray("Mask");
+  cache->GetGeometrySettings(this, cache->GeometrySettings);
+  cache->GeometrySize = size;
+  cache->GeometryCached = true;
+}
+
+
+//----------------------------------------------------------------------------
+//  Pass the cached grid to output if it was built with the current settings.
+//----------------------------------------------------------------------------
+
+bool vtkMPASReader::RestoreCachedGeometry(vtkUnstructuredGrid *output)
+{
+  Internal *cache = this->Internals;
+  if (!cache->GeometryCached)
+    {
+    return false;
+    }
+
+  // The cache may have been disabled or shrunk since the grid was kept.
+  if (cache->GeometrySize > 1024.0 * this->GeometryCacheSize)
+    {
+    cache->ReleaseGeometry();
+    return false;
+    }
+
+  int settings[7];
+  cache->GetGeometrySettings(this, settings);
+  if (!std::equal(settings, settings + 7, cache->GeometrySettings))
+    {
+    return false;
+    }
+
+  vtkDebugMacro(<< "Reusing cached grid" << endl);
+  output->SetPoints(cache->Points);
+  output->SetCells(cache->CellTypes, cache->CellLocations, cache->Cells);
+  if (cache->CellMask)
+    {
+    output->GetCellData()->AddArray(cache->CellMask);
+    }
+  return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Allocate into sphere view of dual geometry
 //----------------------------------------------------------------------------
@@ -977,6 +1366,8 @@ int vtkMPASReader::AllocSphereGeometry()
     NcVar *maxLevelPointVar = ncFile->get_var("maxLevelCell");
     maxLevelPointVar->get(this->MaximumLevelPoint + this->PointOffset,
                           this->NumberOfPoints);
+    // point 0 has no levels
+    this->MaximumLevelPoint[0] = 0;
     }
 
   this->CurrentExtraPoint = this->NumberOfPoints + this->PointOffset;
@@ -1079,6 +1470,8 @@ int vtkMPASReader::AllocLatLonGeometry()
     NcVar *maxLevelPointVar = ncFile->get_var("maxLevelCell");
     maxLevelPointVar->get(this->MaximumLevelPoint + this->PointOffset,
                           this->NumberOfPoints);
+    // point 0 has no levels
+    this->MaximumLevelPoint[0] = 0;
     }
 
   this->CurrentExtraPoint = this->NumberOfPoints + this->PointOffset;
@@ -1411,83 +1804,32 @@ void vtkMPASReader::OutputPoints(bool init)
      <<"ProjectLatLon: " << ProjectLatLon << " ShowMultilayerView: "
      << ShowMultilayerView << endl);
 
+  vtkIdType pointsPerColumn =
+    this->ShowMultilayerView ? this->MaximumNVertLevels + 1 : 1;
   if (init)
     {
     points = vtkSmartPointer<vtkPoints>::New();
-    points->Allocate(this->MaximumPoints, this->MaximumPoints);
     output->SetPoints(points);
     }
   else
     {
     points = output->GetPoints();
     points->Initialize();
-    points->Allocate(this->MaximumPoints, this->MaximumPoints);
-    }
-
-  for (int j = 0; j < this->CurrentExtraPoint; j++ )
-    {
-
-    double x, y, z;
-
-    if (ProjectLatLon)
-      {
-      x = this->PointX[j] * 180.0 / vtkMath::Pi();
-      y = this->PointY[j] * 180.0 / vtkMath::Pi();
-      z = 0.0;
-      }
-    else
-      {
-      x = this->PointX[j];
-      y = this->PointY[j];
-      z = this->PointZ[j];
-      }
-
-    if (!ShowMultilayerView)
-      {
-      points->InsertNextPoint(x, y, z);
-      //    points->SetPoint(j, x, y, z);
-      }
-    else
-      {
-      double rho=0.0, rholevel=0.0, theta=0.0, phi=0.0;
-      int retval = -1;
-
-      if (!ProjectLatLon)
-        {
-        if ((x != 0.0) || (y != 0.0) || (z != 0.0))
-          {
-          retval = CartesianToSpherical(x, y, z, &rho, &phi, &theta);
-          if (retval)
-            {
-            vtkDebugMacro("Can't create point for layered view." << endl);
-            }
-          }
-        }
-
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels+1; levelNum++)
-        {
-
-        if (ProjectLatLon)
-          {
-          z = -(double)((levelNum)*adjustedLayerThickness);
-          }
-        else
-          {
-          if (!retval && ((x != 0.0) || (y != 0.0) || (z != 0.0)))
-            {
-            rholevel = rho - (adjustedLayerThickness * levelNum);
-            retval = SphericalToCartesian(rholevel, phi, theta, &x, &y, &z);
-            if (retval)
-              {
-              vtkDebugMacro("Can't create point for layered view." << endl);
-              }
-            }
-          }
-        //   points->SetPoint(j*(this->MaximumNVertLevels+1) + levelNum, x, y, z);
-        points->InsertNextPoint(x, y, z);
-        }
-      }
     }
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(this->CurrentExtraPoint * pointsPerColumn);
+
+  vtkMPASReaderPointBuilder builder;
+  builder.PointX = this->PointX;
+  builder.PointY = this->PointY;
+  builder.PointZ = this->PointZ;
+  builder.ProjectLatLon = this->ProjectLatLon;
+  builder.ShowMultilayerView = this->ShowMultilayerView;
+  builder.MaximumNVertLevels = this->MaximumNVertLevels;
+  builder.AdjustedLayerThickness = adjustedLayerThickness;
+  builder.Output =
+    static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0);
+  vtkSMPTools::For(0, this->CurrentExtraPoint, builder);
 
   if (this->PointX)
     {
@@ -1554,19 +1896,7 @@ void vtkMPASReader::OutputCells(bool init)
   vtkDebugMacro(<< "In OutputCells..." << endl);
   vtkUnstructuredGrid* output = GetOutput();
 
-  if (init)
-    {
-    output->Allocate(this->MaximumCells, this->MaximumCells);
-    }
-  else
-    {
-    vtkCellArray* cells = output->GetCells();
-    cells->Initialize();
-    output->Allocate(this->MaximumCells, this->MaximumCells);
-    }
-
   int cellType = GetCellType();
-  int val;
 
   int pointsPerPolygon;
   if (this->ShowMultilayerView)
@@ -1584,110 +1914,34 @@ void vtkMPASReader::OutputCells(bool init)
      << " LayerThickness: " << LayerThickness << " ProjectLatLon: "
      << ProjectLatLon << " ShowMultilayerView: " << ShowMultilayerView);
 
-  std::vector<vtkIdType> polygon(pointsPerPolygon);
-
-  for (int j = 0; j < this->CurrentExtraCell ; j++)
-    {
-
-    int* conns;
-    if (this->ProjectLatLon)
-      {
-      conns = this->ModConnections + (j * this->PointsPerCell);
-      }
-    else
-      {
-      conns = this->OrigConnections + (j * this->PointsPerCell);
-      }
-
-    int minLevel= 0;
-
-    if (this->IncludeTopography)
-      {
-      int* connections;
-
-      //check if it is a mirror cell, if so, get original
-      if (j >= this->NumberOfCells + this->CellOffset)
-        {
-        //cout << "setting origCell" << endl;
-        int origCellNum = *(this->CellMap + (j - this->NumberOfCells - this->CellOffset));
-        //cout << "mirror cell: " <<j<< " origCell: "<< origCell << endl;
-        connections = this->OrigConnections + (origCellNum*this->PointsPerCell);
-        }
-      else
-        {
-        connections = this->OrigConnections + (j * this->PointsPerCell);
-        }
-
-      //cout << "calc minLevel" << endl;
-      minLevel = this->MaximumLevelPoint[connections[0]];
-      //cout << "initial minLevel:" << minLevel << endl;
-      // Take the min of the this->MaximumLevelPoint of each point
-      for (int k = 1; k < this->PointsPerCell; k++)
-        {
-        minLevel = min(minLevel, this->MaximumLevelPoint[connections[k]]);
-        }
-      //cout << endl;
-      }
-
-    // singlelayer
-    if (!this->ShowMultilayerView)
-      {
-      // If that min is greater than or equal to this output level,
-      // include the cell, otherwise set all points to zero.
-
-      if (this->IncludeTopography && ((minLevel-1) < this->VerticalLevelSelected))
-        {
-        //cerr << "Setting all points to zero" << endl;
-        val = 0;
-        for (int k = 0; k < this->PointsPerCell; k++)
-          {
-          polygon[k] = val;
-          }
-        }
-      else
-        {
-        for (int k = 0; k < this->PointsPerCell; k++)
-          {
-          polygon[k] = conns[k];
-          }
-        }
-      output->InsertNextCell(cellType, pointsPerPolygon, &polygon[0]);
-
-    }
-    else
-      { // multilayer
-      // for each level, write the cell
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-        if (this->IncludeTopography && ((minLevel-1) < levelNum))
-          {
-          // setting all points to zero
-          val = 0;
-          for (int k = 0; k < pointsPerPolygon; k++)
-            {
-            polygon[k] = val;
-            }
-          }
-        else
-          {
-          for (int k = 0; k < this->PointsPerCell; k++)
-            {
-            val = (conns[k]*(this->MaximumNVertLevels+1)) + levelNum;
-            polygon[k] = val;
-            }
-
-          for (int k = 0; k < this->PointsPerCell; k++)
-            {
-            val = (conns[k]*(this->MaximumNVertLevels+1)) + levelNum + 1;
-            polygon[k+this->PointsPerCell] = val;
-            }
-          }
-        //vtkDebugMacro
-        //("InsertingCell j: " << j << " level: " << levelNum << endl);
-        output->InsertNextCell(cellType, pointsPerPolygon, &polygon[0]);
-        }
-      }
-    }
+  // Every cell has the same size, so each grid cell knows where its cells
+  // go in the connectivity array.
+  vtkIdType cellsPerColumn =
+    this->ShowMultilayerView ? this->MaximumNVertLevels : 1;
+  vtkIdType numberOfCells = this->CurrentExtraCell * cellsPerColumn;
+  vtkSmartPointer<vtkIdTypeArray> connectivity =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  connectivity->SetNumberOfTuples(numberOfCells * (pointsPerPolygon + 1));
+
+  vtkMPASReaderCellBuilder builder;
+  builder.Connections =
+    this->ProjectLatLon ? this->ModConnections : this->OrigConnections;
+  builder.OrigConnections = this->OrigConnections;
+  builder.CellMap = this->CellMap;
+  builder.MaximumLevelPoint = this->MaximumLevelPoint;
+  builder.IncludeTopography = this->IncludeTopography;
+  builder.ShowMultilayerView = this->ShowMultilayerView;
+  builder.NumberOfCells = this->NumberOfCells;
+  builder.CellOffset = this->CellOffset;
+  builder.PointsPerCell = this->PointsPerCell;
+  builder.MaximumNVertLevels = this->MaximumNVertLevels;
+  builder.VerticalLevelSelected = this->VerticalLevelSelected;
+  builder.Output = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, this->CurrentExtraCell, builder);
+
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetCells(numberOfCells, connectivity);
+  output->SetCells(cellType, cells);
 
   if (this->CellMask)
     {
@@ -1698,6 +1952,7 @@ void vtkMPASReader::OutputCells(bool init)
                        vtkIntArray::VTK_DATA_ARRAY_FREE);
     cellMask->SetName("Mask");
     output->GetCellData()->AddArray(cellMask);
+    cellMask->Delete();
     this->CellMask = NULL;
     }
 
@@ -1771,9 +2026,6 @@ int vtkMPASReader::LoadPointVarData(int variableIndex, double dTimeStep)
       ncVar->set_cur(timestep, 0, this->VerticalLevelSelected);
       ncVar->get(dataBlock+this->PointOffset, 1, this->NumberOfPoints, 1);
       }
-
-    dataBlock[0] = dataBlock[1];
-    // data is all in place, don't need to do next step
     }
   else
     { // multilayer
@@ -1794,98 +2046,36 @@ int vtkMPASReader::LoadPointVarData(int variableIndex, double dTimeStep)
       ncVar->set_cur(timestep, 0, 0);
       ncVar->get(dataPtr, 1, this->NumberOfPoints, this->MaximumNVertLevels);
       }
-    if (numDims == 1 || numDims == 2)
-      {
-      // need to replicate data over all vertical layers
-      // layout in memory needs to be:
-      // pt1, pt1, ..., (VertLevels times), pt2, pt2, ..., (VertLevels times),
-      // need to go backwards through the points in order to not overwrite
-      // anything.
-      for(int i=this->NumberOfPoints; i>0; i--)
-        {
-        // point to copy
-        double pt = *(dataPtr + i - 1);
-
-        // where to start copying
-        double* copyPtr = dataPtr + (i-1)*this->MaximumNVertLevels;
-
-        for(int j=0; j<this->MaximumNVertLevels; j++)
-          {
-          *copyPtr = pt;
-          copyPtr++;
-          }
-        }
-      }
     }
 
   vtkDebugMacro
     (<< "got point data in vtkMPASReader::LoadPointVarData" << endl);
 
-  int i=0, k=0;
-
-  if (ShowMultilayerView)
-    {
-
-    // put in dummy points
-    for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-      {
-      dataBlock[levelNum] = this->PointVarData[this->MaximumNVertLevels + levelNum];
-      }
-    // write highest level dummy point (duplicate of last level)
-    dataBlock[this->MaximumNVertLevels] = this->PointVarData[this->MaximumNVertLevels+this->MaximumNVertLevels-1];
-
-    vtkDebugMacro (<< "Wrote dummy vtkMPASReader::LoadPointVarData" << endl);
-
-    // put in other points
-    for (int j = this->PointOffset; j < this->NumberOfPoints + this->PointOffset; j++)
-      {
-
-      i = j*(this->MaximumNVertLevels+1);
-      k = j*(this->MaximumNVertLevels);
-
-      // write data for one point -- lowest level to highest
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-        dataBlock[i++] = this->PointVarData[k++];
-        }
-
-      // for last layer of points, repeat last level's values
-      // Need Mark's input on this one
-      dataBlock[i++] = this->PointVarData[--k];
-      //vtkDebugMacro (<< "Wrote j:" << j << endl);
-      }
-
-    }
-
-  vtkDebugMacro (<< "Wrote next pts vtkMPASReader::LoadPointVarData" << endl);
-
   vtkDebugMacro
     (<< "this->NumberOfPoints: " << this->NumberOfPoints << " this->CurrentExtraPoint: "
      << this->CurrentExtraPoint << endl);
 
-  // put out data for extra points
-  for (int j = this->PointOffset + this->NumberOfPoints; j < this->CurrentExtraPoint; j++)
+  // Put in the dummy point, replicate the data over the vertical layers if
+  // needed and put out data for extra points.
+  vtkMPASReaderPointDataScatter scatter;
+  scatter.PointMap = this->PointMap;
+  scatter.NumberOfPoints = this->NumberOfPoints;
+  scatter.PointOffset = this->PointOffset;
+  scatter.ShowMultilayerView = this->ShowMultilayerView;
+  scatter.MaximumNVertLevels = this->MaximumNVertLevels;
+  scatter.Layered = (numDims == 3);
+  scatter.Input = this->PointVarData +
+                  (this->MaximumNVertLevels * this->PointOffset);
+  scatter.Output = dataBlock;
+  if (this->ShowMultilayerView)
     {
-    // use map to find out what point data we are using
-
-    if (!ShowMultilayerView)
-      {
-      k = this->PointMap[j - this->NumberOfPoints - this->PointOffset];
-      dataBlock[j] = dataBlock[k];
-      }
-    else
-      {
-      k = this->PointMap[j - this->NumberOfPoints - this->PointOffset]*this->MaximumNVertLevels;
-      // write data for one point -- lowest level to highest
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-        dataBlock[i++] = this->PointVarData[k++];
-        }
-
-      // for last layer of points, repeat last level's values
-      // Need Mark's input on this one
-      dataBlock[i++] = this->PointVarData[--k];
-      }
+    vtkSMPTools::For(0, this->CurrentExtraPoint, scatter);
+    }
+  else
+    {
+    dataBlock[0] = dataBlock[1];
+    vtkSMPTools::For(this->PointOffset + this->NumberOfPoints,
+                     this->CurrentExtraPoint, scatter);
     }
 
   vtkDebugMacro
@@ -1937,14 +2127,15 @@ int vtkMPASReader::LoadCellVarData(int variableIndex, double dTimeStep)
                      (int)(this->NumberOfTimeSteps-1));
   vtkDebugMacro( << "Time: " << timestep << endl);
 
-  ncVar->set_cur(timestep, 0, this->VerticalLevelSelected);
-
+  // Read only the selected level, or all levels in multilayer view.
   if (!ShowMultilayerView)
     {
+    ncVar->set_cur(timestep, 0, this->VerticalLevelSelected);
     ncVar->get(dataBlock, 1, this->NumberOfCells, 1);
     }
   else
     {
+    ncVar->set_cur(timestep, 0, 0);
     ncVar->get(dataBlock, 1, this->NumberOfCells, this->MaximumNVertLevels);
     }
 
@@ -2462,4 +2653,5 @@ void vtkMPASReader::PrintSelf(ostream& os, vtkIndent indent)
      << (this->IsZeroCentered?"ON":"OFF") << endl;
   os << indent << "LayerThicknessRange: "
      << this->LayerThicknessRange[0] << "," << this->LayerThicknessRange[1] << endl;
+  os << indent << "GeometryCacheSize: " << this->GeometryCacheSize << endl;
 }
@@ -156,6 +156,14 @@ class VTKIONETCDF_EXPORT vtkMPASReader : public vtkUnstructuredGridAlgorithm
   void SetShowMultilayerView(bool val);
   vtkGetMacro(ShowMultilayerView, bool);
 
+  // Description:
+  // Set/Get the size in MiB above which the grid built from the
+  // time-invariant variables is not kept between updates. While the grid is
+  // kept, requests for other time steps or arrays reuse it instead of
+  // reading and rebuilding it. Set to 0 to disable. The default is 1024.
+  vtkSetClampMacro(GeometryCacheSize, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(GeometryCacheSize, double);
+
   // Description:
   // Returns true if the given file can be read.
   static int CanReadFile(const char *filename);
@@ -224,6 +232,8 @@ class VTKIONETCDF_EXPORT vtkMPASReader : public vtkUnstructuredGridAlgorithm
   bool DoBugFix;
   double CenterRad;
 
+  double GeometryCacheSize;
+
 
   // geometry
   int MaximumNVertLevels;
@@ -255,6 +265,9 @@ class VTKIONETCDF_EXPORT vtkMPASReader : public vtkUnstructuredGridAlgorithm
   double* PointVarData;
 
   void SetDefaults();
+  void DestroyVariableData(bool keepTimeInvariant);
+  void CacheGeometry();
+  bool RestoreCachedGeometry(vtkUnstructuredGrid *output);
   int GetNcDims();
   int CheckParams();
   int GetNcVars(const char* cellDimName, const char* pointDimName);
@@ -26,6 +26,7 @@
 #include "vtkDataArraySelection.h"
 #include "vtkDoubleArray.h"
 #include "vtkExtentTranslator.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -36,10 +37,12 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStringArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include "vtkSmartPointer.h"
@@ -47,6 +50,7 @@
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <set>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 #include <vtksys/SystemTools.hxx>
 
@@ -729,6 +733,294 @@ public:
   std::vector<vtkNetCDFCFReader::vtkDependentDimensionInfo> v;
 };
 
+//=============================================================================
+class vtkNetCDFCFReader::vtkGeometryCache
+{
+public:
+  vtkGeometryCache() : Size(0.0) {}
+
+  // Everything the geometry of an output depends on.  The time step and the
+  // selected variables are deliberately not part of it.
+  void MakeKey(vtkNetCDFCFReader *self, vtkDataSet *output,
+               const int extent[6], std::vector<double> &key)
+  {
+    key.clear();
+    key.push_back(output->GetDataObjectType());
+    key.insert(key.end(), extent, extent+6);
+    for (vtkIdType i = 0; i < self->LoadingDimensions->GetNumberOfTuples(); i++)
+      {
+      key.push_back(self->LoadingDimensions->GetValue(i));
+      }
+    key.push_back(self->CoordinateType(self->LoadingDimensions));
+    key.push_back(self->SphericalCoordinates);
+    key.push_back(self->VerticalScale);
+    key.push_back(self->VerticalBias);
+    key.push_back(self->MetaDataMTime.GetMTime());
+  }
+
+  void Release()
+  {
+    this->Key.clear();
+    this->Points = NULL;
+    this->Cells = NULL;
+    this->CellTypes = NULL;
+    this->CellLocations = NULL;
+  }
+
+  std::vector<double> Key;
+  double Size;
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Cells;
+  vtkSmartPointer<vtkUnsignedCharArray> CellTypes;
+  vtkSmartPointer<vtkIdTypeArray> CellLocations;
+};
+
+//=============================================================================
+// The following functors fill the points of a structured extent one row of
+// points (constant j and k) at a time.  They produce exactly the values of
+// the serial loops they replace, in the same order.
+class vtkNetCDFCFReaderRowIterator
+{
+public:
+  vtkNetCDFCFReaderRowIterator(const int extent[6], double *points)
+    : Points(points)
+  {
+    std::copy(extent, extent+6, this->Extent);
+    this->RowLength = extent[1] - extent[0] + 1;
+    this->RowsPerSlab = extent[3] - extent[2] + 1;
+  }
+
+  vtkIdType GetNumberOfRows() const
+  {
+    return this->RowsPerSlab*(this->Extent[5] - this->Extent[4] + 1);
+  }
+
+protected:
+  // Returns the first point of the given row and its j and k indices.
+  double *StartRow(vtkIdType row, int &j, int &k) const
+  {
+    j = this->Extent[2] + static_cast<int>(row%this->RowsPerSlab);
+    k = this->Extent[4] + static_cast<int>(row/this->RowsPerSlab);
+    return this->Points + 3*row*this->RowLength;
+  }
+
+  int Extent[6];
+  vtkIdType RowLength;
+  vtkIdType RowsPerSlab;
+  double *Points;
+};
+
+class vtkNetCDFCFReader1DRectilinearPoints : public vtkNetCDFCFReaderRowIterator
+{
+public:
+  // Coordinates[c] is NULL for components that are always 0.
+  vtkNetCDFCFReader1DRectilinearPoints(const int extent[6], double *points,
+                                       const double *coordinates[3])
+    : vtkNetCDFCFReaderRowIterator(extent, points)
+  {
+    std::copy(coordinates, coordinates+3, this->Coordinates);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType row = begin; row < end; row++)
+      {
+      int ijk[3];
+      double *point = this->StartRow(row, ijk[1], ijk[2]);
+      for (ijk[0] = this->Extent[0]; ijk[0] <= this->Extent[1]; ijk[0]++)
+        {
+        for (int c = 0; c < 3; c++)
+          {
+          *point++ = this->Coordinates[c]
+            ? this->Coordinates[c][ijk[c]] : 0.0;
+          }
+        }
+      }
+  }
+
+private:
+  const double *Coordinates[3];
+};
+
+class vtkNetCDFCFReader1DSphericalPoints : public vtkNetCDFCFReaderRowIterator
+{
+public:
+  // Index[c] selects which of k, j, i indexes coordinate array c.
+  // Coordinates[2] is NULL when there is no vertical dimension.
+  vtkNetCDFCFReader1DSphericalPoints(const int extent[6], double *points,
+                                     const double *coordinates[3],
+                                     const int index[3],
+                                     double vertScale, double vertBias)
+    : vtkNetCDFCFReaderRowIterator(extent, points),
+      VertScale(vertScale), VertBias(vertBias)
+  {
+    std::copy(coordinates, coordinates+3, this->Coordinates);
+    std::copy(index, index+3, this->Index);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType row = begin; row < end; row++)
+      {
+      int ijk[3];
+      double *point = this->StartRow(row, ijk[1], ijk[0]);
+      for (ijk[2] = this->Extent[0]; ijk[2] <= this->Extent[1]; ijk[2]++)
+        {
+        double lon = this->Coordinates[0][ijk[this->Index[0]]];
+        double lat = this->Coordinates[1][ijk[this->Index[1]]];
+        double h = this->Coordinates[2]
+          ? this->Coordinates[2][ijk[this->Index[2]]] : 1.0;
+        lon = vtkMath::RadiansFromDegrees(lon);
+        lat = vtkMath::RadiansFromDegrees(lat);
+        h = h*this->VertScale + this->VertBias;
+
+        *point++ = h*cos(lon)*cos(lat);
+        *point++ = h*sin(lon)*cos(lat);
+        *point++ = h*sin(lat);
+        }
+      }
+  }
+
+private:
+  const double *Coordinates[3];
+  int Index[3];
+  double VertScale;
+  double VertBias;
+};
+
+class vtkNetCDFCFReader2DPoints : public vtkNetCDFCFReaderRowIterator
+{
+public:
+  // The longitude and latitude arrays hold one tuple per j index with one
+  // component per i index.  Heights holds the final vertical coordinate of
+  // each k index.
+  vtkNetCDFCFReader2DPoints(const int extent[6], double *points,
+                            vtkDoubleArray *longitude, vtkDoubleArray *latitude,
+                            const double *heights, bool spherical)
+    : vtkNetCDFCFReaderRowIterator(extent, points),
+      Longitude(longitude->GetPointer(0)),
+      Latitude(latitude->GetPointer(0)),
+      NumberOfComponents(longitude->GetNumberOfComponents()),
+      Heights(heights), Spherical(spherical) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType row = begin; row < end; row++)
+      {
+      int j, k;
+      double *point = this->StartRow(row, j, k);
+      double h = this->Heights[k - this->Extent[4]];
+      const double *lonRow = this->Longitude + j*this->NumberOfComponents;
+      const double *latRow = this->Latitude + j*this->NumberOfComponents;
+      for (int i = this->Extent[0]; i <= this->Extent[1]; i++)
+        {
+        double lon = lonRow[i];
+        double lat = latRow[i];
+        if (this->Spherical)
+          {
+          lon = vtkMath::RadiansFromDegrees(lon);
+          lat = vtkMath::RadiansFromDegrees(lat);
+          *point++ = h*cos(lon)*cos(lat);
+          *point++ = h*sin(lon)*cos(lat);
+          *point++ = h*sin(lat);
+          }
+        else
+          {
+          *point++ = lon;
+          *point++ = lat;
+          *point++ = h;
+          }
+        }
+      }
+  }
+
+private:
+  const double *Longitude;
+  const double *Latitude;
+  vtkIdType NumberOfComponents;
+  const double *Heights;
+  bool Spherical;
+};
+
+// Fills the connectivity of the quads (or hexahedra) of a structured extent.
+class vtkNetCDFCFReaderStructuredCells
+{
+public:
+  vtkNetCDFCFReaderStructuredCells(const vtkIdType numCells[3],
+                                   vtkIdType nextPointRow,
+                                   vtkIdType nextPointSlab,
+                                   bool extentIs2D, vtkIdType *connectivity)
+    : NextPointRow(nextPointRow), NextPointSlab(nextPointSlab),
+      ExtentIs2D(extentIs2D), Connectivity(connectivity)
+  {
+    this->NumCells[0] = numCells[0];
+    this->NumCells[1] = numCells[1];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkIdType cellSize = this->ExtentIs2D ? 5 : 9;
+    vtkIdType *ids = this->Connectivity + begin*cellSize;
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      vtkIdType i = cellId%this->NumCells[0];
+      vtkIdType j = (cellId/this->NumCells[0])%this->NumCells[1];
+      vtkIdType k = cellId/(this->NumCells[0]*this->NumCells[1]);
+      vtkIdType lowCellPoint
+        = k*this->NextPointSlab + j*this->NextPointRow + i;
+
+      *ids++ = cellSize - 1;
+      *ids++ = lowCellPoint;
+      *ids++ = lowCellPoint + 1;
+      *ids++ = lowCellPoint + this->NextPointRow + 1;
+      *ids++ = lowCellPoint + this->NextPointRow;
+      if (!this->ExtentIs2D)
+        {
+        // This code is assuming that all axis are scaling up.  If that is
+        // not the case, this will probably make inverted hexahedra.
+        lowCellPoint += this->NextPointSlab;
+        *ids++ = lowCellPoint;
+        *ids++ = lowCellPoint + 1;
+        *ids++ = lowCellPoint + this->NextPointRow + 1;
+        *ids++ = lowCellPoint + this->NextPointRow;
+        }
+      }
+  }
+
+private:
+  vtkIdType NumCells[2];
+  vtkIdType NextPointRow;
+  vtkIdType NextPointSlab;
+  bool ExtentIs2D;
+  vtkIdType *Connectivity;
+};
+
+// Converts longitude/latitude points to points on a sphere.
+class vtkNetCDFCFReaderLonLatToSphere
+{
+public:
+  vtkNetCDFCFReaderLonLatToSphere(double *points, double height)
+    : Points(points), Height(height) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType pointId = begin; pointId < end; pointId++)
+      {
+      double *point = this->Points + 3*pointId;
+      double lon = vtkMath::RadiansFromDegrees(point[0]);
+      double lat = vtkMath::RadiansFromDegrees(point[1]);
+
+      point[0] = this->Height*cos(lon)*cos(lat);
+      point[1] = this->Height*sin(lon)*cos(lat);
+      point[2] = this->Height*sin(lat);
+      }
+  }
+
+private:
+  double *Points;
+  double Height;
+};
+
 //=============================================================================
 vtkStandardNewMacro(vtkNetCDFCFReader);
 
@@ -739,15 +1031,18 @@ vtkNetCDFCFReader::vtkNetCDFCFReader()
   this->VerticalScale = 1.0;
   this->VerticalBias = 0.0;
   this->OutputType = -1;
+  this->GeometryCacheSize = 1024.0;
 
   this->DimensionInfo = new vtkDimensionInfoVector;
   this->DependentDimensionInfo = new vtkDependentDimensionInfoVector;
+  this->GeometryCache = new vtkGeometryCache;
 }
 
 vtkNetCDFCFReader::~vtkNetCDFCFReader()
 {
   delete this->DimensionInfo;
   delete this->DependentDimensionInfo;
+  delete this->GeometryCache;
 }
 
 void vtkNetCDFCFReader::PrintSelf(ostream &os, vtkIndent indent)
@@ -758,6 +1053,7 @@ void vtkNetCDFCFReader::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "VerticalScale: " << this->VerticalScale <<endl;
   os << indent << "VerticalBias: " << this->VerticalBias <<endl;
   os << indent << "OutputType: " << this->OutputType <<endl;
+  os << indent << "GeometryCacheSize: " << this->GeometryCacheSize <<endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -1093,6 +1389,13 @@ int vtkNetCDFCFReader::RequestData(vtkInformation *request,
     = vtkStructuredGrid::GetData(outputVector);
   if (structuredOutput)
     {
+    int extent[6];
+    structuredOutput->GetExtent(extent);
+    if (this->RestoreCachedGeometry(structuredOutput, extent))
+      {
+      return 1;
+      }
+
     switch (this->CoordinateType(this->LoadingDimensions))
       {
       case COORDS_UNIFORM_RECTILINEAR:
@@ -1120,6 +1423,8 @@ int vtkNetCDFCFReader::RequestData(vtkInformation *request,
         vtkErrorMacro("Internal error: unknown coordinate type.");
         return 0;
       }
+
+    this->CacheGeometry(structuredOutput, extent);
     }
 
   vtkUnstructuredGrid *unstructuredOutput
@@ -1128,6 +1433,10 @@ int vtkNetCDFCFReader::RequestData(vtkInformation *request,
     {
     int extent[6];
     this->GetUpdateExtentForOutput(unstructuredOutput, extent);
+    if (this->RestoreCachedGeometry(unstructuredOutput, extent))
+      {
+      return 1;
+      }
 
     switch (this->CoordinateType(this->LoadingDimensions))
       {
@@ -1156,11 +1465,97 @@ int vtkNetCDFCFReader::RequestData(vtkInformation *request,
         vtkErrorMacro("Internal error: unknown coordinate type.");
         return 0;
       }
+
+    this->CacheGeometry(unstructuredOutput, extent);
     }
 
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkNetCDFCFReader::RestoreCachedGeometry(vtkDataSet *output,
+                                              const int extent[6])
+{
+  if (!this->GeometryCache->Points)
+    {
+    return false;
+    }
+
+  // The cache may have been disabled or shrunk since the geometry was kept.
+  if (this->GeometryCache->Size > 1024.0*this->GeometryCacheSize)
+    {
+    this->GeometryCache->Release();
+    return false;
+    }
+
+  std::vector<double> key;
+  this->GeometryCache->MakeKey(this, output, extent, key);
+  if (key != this->GeometryCache->Key)
+    {
+    return false;
+    }
+
+  vtkDebugMacro("Reusing cached geometry.");
+  vtkStructuredGrid *structuredOutput = vtkStructuredGrid::SafeDownCast(output);
+  if (structuredOutput)
+    {
+    structuredOutput->SetPoints(this->GeometryCache->Points);
+    }
+  vtkUnstructuredGrid *unstructuredOutput
+    = vtkUnstructuredGrid::SafeDownCast(output);
+  if (unstructuredOutput)
+    {
+    unstructuredOutput->SetPoints(this->GeometryCache->Points);
+    unstructuredOutput->SetCells(this->GeometryCache->CellTypes,
+                                 this->GeometryCache->CellLocations,
+                                 this->GeometryCache->Cells);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkNetCDFCFReader::CacheGeometry(vtkDataSet *output, const int extent[6])
+{
+  this->GeometryCache->Release();
+
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(output);
+  if (!pointSet || !pointSet->GetPoints())
+    {
+    return;
+    }
+  unsigned long size = pointSet->GetPoints()->GetData()->GetActualMemorySize();
+
+  vtkUnstructuredGrid *unstructuredOutput
+    = vtkUnstructuredGrid::SafeDownCast(output);
+  if (unstructuredOutput)
+    {
+    if (!unstructuredOutput->GetCells())
+      {
+      return;
+      }
+    size += unstructuredOutput->GetCells()->GetActualMemorySize();
+    size += unstructuredOutput->GetCellTypesArray()->GetActualMemorySize();
+    size += unstructuredOutput->GetCellLocationsArray()->GetActualMemorySize();
+    }
+
+  // Sizes are in KiB.
+  if (size > 1024.0*this->GeometryCacheSize)
+    {
+    return;
+    }
+
+  this->GeometryCache->MakeKey(this, output, extent, this->GeometryCache->Key);
+  this->GeometryCache->Size = size;
+  this->GeometryCache->Points = pointSet->GetPoints();
+  if (unstructuredOutput)
+    {
+    this->GeometryCache->Cells = unstructuredOutput->GetCells();
+    this->GeometryCache->CellTypes = unstructuredOutput->GetCellTypesArray();
+    this->GeometryCache->CellLocations
+      = unstructuredOutput->GetCellLocationsArray();
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkNetCDFCFReader::ExtentForDimensionsAndPiece(int pieceNumber,
                                                     int numberOfPieces,
@@ -1298,50 +1693,22 @@ void vtkNetCDFCFReader::Add1DRectilinearCoordinates(vtkPoints *points,
   points->SetNumberOfPoints(  (extent[1]-extent[0]+1)
                             * (extent[3]-extent[2]+1)
                             * (extent[5]-extent[4]+1) );
-  vtkDataArray *pointData = points->GetData();
 
+  const double *coordinates[3] = { NULL, NULL, NULL };
   int numDimNetCDF = this->LoadingDimensions->GetNumberOfTuples();
-  for (int dimVTK = 0; dimVTK < 3; dimVTK++)
+  for (int dimVTK = 0; dimVTK < std::min(numDimNetCDF, 3); dimVTK++)
     {
-    vtkSmartPointer<vtkDoubleArray> coords;
-    if (dimVTK < numDimNetCDF)
-      {
-      // Remember that netCDF dimension ordering is backward from VTK.
-      int dimNetCDF = this->LoadingDimensions->GetValue(numDimNetCDF-dimVTK-1);
-      coords = this->GetDimensionInfo(dimNetCDF)->GetCoordinates();
-
-      int ijk[3];
-      vtkIdType pointIdx = 0;
-      for (ijk[2] = extent[2*2]; ijk[2] <= extent[2*2+1]; ijk[2]++)
-        {
-        for (ijk[1] = extent[1*2]; ijk[1] <= extent[1*2+1]; ijk[1]++)
-          {
-          for (ijk[0] = extent[0*2]; ijk[0] <= extent[0*2+1]; ijk[0]++)
-            {
-            pointData->SetComponent(pointIdx, dimVTK,
-                                    coords->GetValue(ijk[dimVTK]));
-            pointIdx++;
-            }
-          }
-        }
-      }
-    else
-      {
-      int ijk[3];
-      vtkIdType pointIdx = 0;
-      for (ijk[2] = extent[2*2]; ijk[2] <= extent[2*2+1]; ijk[2]++)
-        {
-        for (ijk[1] = extent[1*2]; ijk[1] <= extent[1*2+1]; ijk[1]++)
-          {
-          for (ijk[0] = extent[0*2]; ijk[0] <= extent[0*2+1]; ijk[0]++)
-            {
-            pointData->SetComponent(pointIdx, dimVTK, 0.0);
-            pointIdx++;
-            }
-          }
-        }
-      }
+    // Remember that netCDF dimension ordering is backward from VTK.
+    int dimNetCDF = this->LoadingDimensions->GetValue(numDimNetCDF-dimVTK-1);
+    coordinates[dimVTK]
+      = this->GetDimensionInfo(dimNetCDF)->GetCoordinates()->GetPointer(0);
     }
+
+  vtkNetCDFCFReader1DRectilinearPoints functor(
+    extent,
+    static_cast<double*>(points->GetData()->GetVoidPointer(0)),
+    coordinates);
+  vtkSMPTools::For(0, functor.GetNumberOfRows(), functor);
 }
 
 //-----------------------------------------------------------------------------
@@ -1349,9 +1716,9 @@ void vtkNetCDFCFReader::Add2DRectilinearCoordinates(vtkPoints *points,
                                                     const int extent[6])
 {
   points->SetDataTypeToDouble();
-  points->Allocate(  (extent[1]-extent[0]+1)
-                   * (extent[3]-extent[2]+1)
-                   * (extent[5]-extent[4]+1) );
+  points->SetNumberOfPoints(  (extent[1]-extent[0]+1)
+                            * (extent[3]-extent[2]+1)
+                            * (extent[5]-extent[4]+1) );
 
   vtkDependentDimensionInfo *info
     = this->FindDependentDimensionInfo(this->LoadingDimensions);
@@ -1373,27 +1740,24 @@ void vtkNetCDFCFReader::Add2DRectilinearCoordinates(vtkPoints *points,
       }
     }
 
+  std::vector<double> heights;
   for (int k = extent[4]; k <= extent[5]; k++)
     {
-    double h;
     if (verticalCoordinates)
       {
-      h = verticalCoordinates->GetValue(k);
+      heights.push_back(verticalCoordinates->GetValue(k));
       }
     else
       {
-      h = 0.0;
-      }
-    for (int j = extent[2]; j <= extent[3]; j++)
-      {
-      for (int i = extent[0]; i <= extent[1]; i++)
-        {
-        double lon = longitudeCoordinates->GetComponent(j, i);
-        double lat = latitudeCoordinates->GetComponent(j, i);
-        points->InsertNextPoint(lon, lat, h);
-        }
+      heights.push_back(0.0);
       }
     }
+
+  vtkNetCDFCFReader2DPoints functor(
+    extent,
+    static_cast<double*>(points->GetData()->GetVoidPointer(0)),
+    longitudeCoordinates, latitudeCoordinates, &heights[0], false);
+  vtkSMPTools::For(0, functor.GetNumberOfRows(), functor);
 }
 
 //-----------------------------------------------------------------------------
@@ -1476,9 +1840,9 @@ void vtkNetCDFCFReader::Add1DSphericalCoordinates(vtkPoints *points,
                                                   const int extent[6])
 {
   points->SetDataTypeToDouble();
-  points->Allocate(  (extent[1]-extent[0]+1)
-                   * (extent[3]-extent[2]+1)
-                   * (extent[5]-extent[4]+1) );
+  points->SetNumberOfPoints(  (extent[1]-extent[0]+1)
+                            * (extent[3]-extent[2]+1)
+                            * (extent[5]-extent[4]+1) );
 
   vtkDoubleArray *coordArrays[3];
   for (vtkIdType i = 0; i < this->LoadingDimensions->GetNumberOfTuples(); i++)
@@ -1519,38 +1883,32 @@ void vtkNetCDFCFReader::Add1DSphericalCoordinates(vtkPoints *points,
       }
     }
 
-  int ijk[3];
-  for (ijk[0] = extent[4]; ijk[0] <= extent[5]; ijk[0]++)
+  // The loops run over k, j, i, which index the netCDF dimensions in order.
+  // Without a vertical dimension the first one is unused.
+  const double *coordinates[3];
+  int index[3];
+  coordinates[0] = coordArrays[longitudeDim]->GetPointer(0);
+  coordinates[1] = coordArrays[latitudeDim]->GetPointer(0);
+  if (verticalDim >= 0)
     {
-    for (ijk[1] = extent[2]; ijk[1] <= extent[3]; ijk[1]++)
-      {
-      for (ijk[2] = extent[0]; ijk[2] <= extent[1]; ijk[2]++)
-        {
-        double lon, lat, h;
-        if (verticalDim >= 0)
-          {
-          lon = coordArrays[longitudeDim]->GetValue(ijk[longitudeDim]);
-          lat = coordArrays[latitudeDim]->GetValue(ijk[latitudeDim]);
-          h = coordArrays[verticalDim]->GetValue(ijk[verticalDim]);
-          }
-        else
-          {
-          lon = coordArrays[longitudeDim]->GetValue(ijk[longitudeDim+1]);
-          lat = coordArrays[latitudeDim]->GetValue(ijk[latitudeDim+1]);
-          h = 1.0;
-          }
-        lon = vtkMath::RadiansFromDegrees(lon);
-        lat = vtkMath::RadiansFromDegrees(lat);
-        h = h*vertScale + vertBias;
-
-        double cartesianCoord[3];
-        cartesianCoord[0] = h*cos(lon)*cos(lat);
-        cartesianCoord[1] = h*sin(lon)*cos(lat);
-        cartesianCoord[2] = h*sin(lat);
-        points->InsertNextPoint(cartesianCoord);
-        }
-      }
+    coordinates[2] = coordArrays[verticalDim]->GetPointer(0);
+    index[0] = longitudeDim;
+    index[1] = latitudeDim;
+    index[2] = verticalDim;
     }
+  else
+    {
+    coordinates[2] = NULL;
+    index[0] = longitudeDim+1;
+    index[1] = latitudeDim+1;
+    index[2] = 0;
+    }
+
+  vtkNetCDFCFReader1DSphericalPoints functor(
+    extent,
+    static_cast<double*>(points->GetData()->GetVoidPointer(0)),
+    coordinates, index, vertScale, vertBias);
+  vtkSMPTools::For(0, functor.GetNumberOfRows(), functor);
 }
 
 //-----------------------------------------------------------------------------
@@ -1558,9 +1916,9 @@ void vtkNetCDFCFReader::Add2DSphericalCoordinates(vtkPoints *points,
                                                   const int extent[6])
 {
   points->SetDataTypeToDouble();
-  points->Allocate(  (extent[1]-extent[0]+1)
-                   * (extent[3]-extent[2]+1)
-                   * (extent[5]-extent[4]+1) );
+  points->SetNumberOfPoints(  (extent[1]-extent[0]+1)
+                            * (extent[3]-extent[2]+1)
+                            * (extent[5]-extent[4]+1) );
 
   vtkDependentDimensionInfo *info
     = this->FindDependentDimensionInfo(this->LoadingDimensions);
@@ -1603,34 +1961,24 @@ void vtkNetCDFCFReader::Add2DSphericalCoordinates(vtkPoints *points,
       }
     }
 
+  std::vector<double> heights;
   for (int k = extent[4]; k <= extent[5]; k++)
     {
-    double h;
     if (verticalCoordinates)
       {
-      h = verticalCoordinates->GetValue(k)*vertScale + vertBias;
+      heights.push_back(verticalCoordinates->GetValue(k)*vertScale + vertBias);
       }
     else
       {
-      h = vertScale + vertBias;
-      }
-    for (int j = extent[2]; j <= extent[3]; j++)
-      {
-      for (int i = extent[0]; i <= extent[1]; i++)
-        {
-        double lon = longitudeCoordinates->GetComponent(j, i);
-        double lat = latitudeCoordinates->GetComponent(j, i);
-        lon = vtkMath::RadiansFromDegrees(lon);
-        lat = vtkMath::RadiansFromDegrees(lat);
-
-        double cartesianCoord[3];
-        cartesianCoord[0] = h*cos(lon)*cos(lat);
-        cartesianCoord[1] = h*sin(lon)*cos(lat);
-        cartesianCoord[2] = h*sin(lat);
-        points->InsertNextPoint(cartesianCoord);
-        }
+      heights.push_back(vertScale + vertBias);
       }
     }
+
+  vtkNetCDFCFReader2DPoints functor(
+    extent,
+    static_cast<double*>(points->GetData()->GetVoidPointer(0)),
+    longitudeCoordinates, latitudeCoordinates, &heights[0], true);
+  vtkSMPTools::For(0, functor.GetNumberOfRows(), functor);
 }
 
 //-----------------------------------------------------------------------------
@@ -1701,64 +2049,26 @@ void vtkNetCDFCFReader::AddStructuredCells(
 
   bool extentIs2D = (numCells[2] < 1);
 
-  if (extentIs2D)
+  vtkIdType totalNumCells = std::max(numCells[0], vtkIdType(0))
+                          * std::max(numCells[1], vtkIdType(0));
+  if (!extentIs2D)
     {
-    vtkIdType totalNumCells = numCells[0]*numCells[1];
-    unstructuredOutput->Allocate(totalNumCells);
-    vtkCellArray *cells = unstructuredOutput->GetCells();
-    cells->Allocate(cells->EstimateSize(totalNumCells, 4));
-
-    for (int j = 0; j < numCells[1]; j++)
-      {
-      vtkIdType rowStart = j*nextPointRow;
-      for (int i = 0; i < numCells[0]; i++)
-        {
-        vtkIdType lowCellPoint = rowStart + i;
-
-        vtkIdType pointIds[4];
-        pointIds[0] = lowCellPoint;
-        pointIds[1] = lowCellPoint + 1;
-        pointIds[2] = lowCellPoint + nextPointRow + 1;
-        pointIds[3] = lowCellPoint + nextPointRow;
-
-        unstructuredOutput->InsertNextCell(VTK_QUAD, 4, pointIds);
-        }
-      }
+    totalNumCells *= numCells[2];
     }
-  else // !extentIs2D
-    {
-    vtkIdType totalNumCells = numCells[0]*numCells[1]*numCells[2];
-    unstructuredOutput->Allocate(totalNumCells);
-    vtkCellArray *cells = unstructuredOutput->GetCells();
-    cells->Allocate(cells->EstimateSize(totalNumCells, 8));
+  vtkIdType cellSize = extentIs2D ? 4 : 8;
 
-    for (int k = 0; k < numCells[2]; k++)
-      {
-      vtkIdType slabStart = k*nextPointSlab;
-      for (int j = 0; j < numCells[1]; j++)
-        {
-        vtkIdType rowStart = slabStart + j*nextPointRow;
-        for (int i = 0; i < numCells[0]; i++)
-          {
-          vtkIdType lowCellPoint = rowStart + i;
-
-          // This code is assuming that all axis are scaling up.  If that is
-          // not the case, this will probably make inverted hexahedra.
-          vtkIdType pointIds[8];
-          pointIds[0] = lowCellPoint;
-          pointIds[1] = lowCellPoint + 1;
-          pointIds[2] = lowCellPoint + nextPointRow + 1;
-          pointIds[3] = lowCellPoint + nextPointRow;
-          pointIds[4] = lowCellPoint + nextPointSlab;
-          pointIds[5] = lowCellPoint + nextPointSlab + 1;
-          pointIds[6] = lowCellPoint + nextPointSlab + nextPointRow + 1;
-          pointIds[7] = lowCellPoint + nextPointSlab + nextPointRow;
-
-          unstructuredOutput->InsertNextCell(VTK_HEXAHEDRON, 8, pointIds);
-          }
-        }
-      }
-    }
+  VTK_CREATE(vtkIdTypeArray, connectivity);
+  connectivity->SetNumberOfValues(totalNumCells*(cellSize+1));
+  vtkNetCDFCFReaderStructuredCells functor(numCells,
+                                           nextPointRow,
+                                           nextPointSlab,
+                                           extentIs2D,
+                                           connectivity->GetPointer(0));
+  vtkSMPTools::For(0, totalNumCells, functor);
+
+  VTK_CREATE(vtkCellArray, cells);
+  cells->SetCells(totalNumCells, connectivity);
+  unstructuredOutput->SetCells(extentIs2D ? VTK_QUAD : VTK_HEXAHEDRON, cells);
 }
 
 //-----------------------------------------------------------------------------
@@ -1835,20 +2145,10 @@ void vtkNetCDFCFReader::AddUnstructuredSphericalCoordinates(
     }
 
   vtkPoints *points = unstructuredOutput->GetPoints();
-  vtkIdType numPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointId = 0; pointId < numPoints; pointId++)
-    {
-    double lonLat[3];
-    points->GetPoint(pointId, lonLat);
-    double lon = vtkMath::RadiansFromDegrees(lonLat[0]);
-    double lat = vtkMath::RadiansFromDegrees(lonLat[1]);
-
-    double cartesianCoord[3];
-    cartesianCoord[0] = height*cos(lon)*cos(lat);
-    cartesianCoord[1] = height*sin(lon)*cos(lat);
-    cartesianCoord[2] = height*sin(lat);
-    points->SetPoint(pointId, cartesianCoord);
-    }
+  vtkNetCDFCFReaderLonLatToSphere functor(
+    static_cast<double*>(points->GetData()->GetVoidPointer(0)), height);
+  vtkSMPTools::For(0, points->GetNumberOfPoints(), functor);
+  points->Modified();
 }
 
 //-----------------------------------------------------------------------------
@@ -88,6 +88,15 @@ public:
     this->SetOutputType(VTK_UNSTRUCTURED_GRID);
   }
 
+  // Description:
+  // Set/Get the size in MiB above which the points and cells built for a
+  // structured or unstructured output are not kept between updates.  While
+  // they are kept, requests for other time steps or variables over the same
+  // extent reuse them instead of rebuilding them.  Set to 0 to disable.  The
+  // default is 1024.
+  vtkSetClampMacro(GeometryCacheSize, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(GeometryCacheSize, double);
+
   // Description:
   // Returns true if the given file can be read.
   static int CanReadFile(const char *filename);
@@ -103,6 +112,8 @@ protected:
 
   int OutputType;
 
+  double GeometryCacheSize;
+
   virtual int RequestDataObject(vtkInformation *request,
                                 vtkInformationVector **inputVector,
                                 vtkInformationVector *outputVector);
@@ -288,6 +299,20 @@ protected:
                                         vtkUnstructuredGrid *unstructuredOutput,
                                         const int extent[6]);
 
+//BTX
+  // Description:
+  // Keeps the points (and cells) last built for a structured or unstructured
+  // output so that they can be shared by later requests.
+  class vtkGeometryCache;
+  friend class vtkGeometryCache;
+  vtkGeometryCache *GeometryCache;
+//ETX
+
+  // Description:
+  // Internal methods for sharing geometry between requests.  Restore returns
+  // false if the cached geometry does not match the output and extent.
+  bool RestoreCachedGeometry(vtkDataSet *output, const int extent[6]);
+  void CacheGeometry(vtkDataSet *output, const int extent[6]);
 
 private:
   vtkNetCDFCFReader(const vtkNetCDFCFReader &); // Not implemented
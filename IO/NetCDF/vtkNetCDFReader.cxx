@@ -34,6 +34,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkStructuredGrid.h"
@@ -95,6 +96,43 @@ static int NetCDFTypeToVTKType(nc_type type)
     }
 }
 
+//=============================================================================
+// Applies the scale_factor and add_offset attributes of a variable.  Packed
+// variables are usually the large ones, so the values are converted in
+// parallel.
+template<class T>
+class vtkNetCDFReaderUnpackValues
+{
+public:
+  vtkNetCDFReaderUnpackValues(const T *input, double *output,
+                              double scale, double offset)
+    : Input(input), Output(output), Scale(scale), Offset(offset) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      this->Output[i] = static_cast<double>(this->Input[i])*this->Scale
+                        + this->Offset;
+      }
+  }
+
+private:
+  const T *Input;
+  double *Output;
+  double Scale;
+  double Offset;
+};
+
+template<class T>
+static void vtkNetCDFReaderUnpack(const T *input, double *output,
+                                  vtkIdType numValues,
+                                  double scale, double offset)
+{
+  vtkNetCDFReaderUnpackValues<T> functor(input, output, scale, offset);
+  vtkSMPTools::For(0, numValues, functor);
+}
+
 //=============================================================================
 vtkStandardNewMacro(vtkNetCDFReader);
 
@@ -874,9 +912,12 @@ int vtkNetCDFReader::LoadVariable(int ncFD, const char *varName, double time,
     VTK_CREATE(vtkDoubleArray, adjustedArray);
     adjustedArray->SetNumberOfComponents(1);
     adjustedArray->SetNumberOfTuples(arraySize);
-    for (vtkIdType i = 0; i < arraySize; i++)
+    switch (dataArray->GetDataType())
       {
-      adjustedArray->SetValue(i, dataArray->GetTuple1(i)*scale + offset);
+      vtkTemplateMacro(vtkNetCDFReaderUnpack(
+                         static_cast<VTK_TT*>(dataArray->GetVoidPointer(0)),
+                         adjustedArray->GetPointer(0),
+                         arraySize, scale, offset));
       }
     dataArray = adjustedArray;
     }
@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPLYReadWriteBlocks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Round trip test of vtkPLYWriter and vtkPLYReader
+// .SECTION Description
+// Writes a mesh with point and cell colors and more elements than the
+// reader and writer handle at once, reads it back and compares the result
+// to the input for each file type and byte order.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkNew.h"
+#include "vtkPLYReader.h"
+#include "vtkPLYWriter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <string>
+
+namespace {
+
+bool CompareColors(vtkUnsignedCharArray *expected, vtkDataArray *actual,
+                   const char *what)
+{
+  if (!actual || actual->GetNumberOfTuples() != expected->GetNumberOfTuples()
+      || actual->GetNumberOfComponents() != 3)
+    {
+    cerr << "Missing or mis-sized " << what << " colors" << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      if (expected->GetComponent(i, c) != actual->GetComponent(i, c))
+        {
+        cerr << "Mismatch in " << what << " color " << i << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool RoundTrip(vtkPolyData *input, const char *fileName, bool binary,
+               int byteOrder)
+{
+  vtkNew<vtkPLYWriter> writer;
+  writer->SetInputData(input);
+  writer->SetFileName(fileName);
+  writer->SetArrayName("RGB");
+  if (binary)
+    {
+    writer->SetFileTypeToBinary();
+    writer->SetDataByteOrder(byteOrder);
+    }
+  else
+    {
+    writer->SetFileTypeToASCII();
+    }
+  writer->Write();
+
+  vtkNew<vtkPLYReader> reader;
+  reader->SetFileName(fileName);
+  reader->Update();
+  vtkPolyData *output = reader->GetOutput();
+
+  if (output->GetNumberOfPoints() != input->GetNumberOfPoints() ||
+      output->GetNumberOfPolys() != input->GetNumberOfPolys())
+    {
+    cerr << "Wrong number of points or polygons read from " << fileName
+         << endl;
+    return false;
+    }
+
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    double p[3], q[3];
+    input->GetPoint(i, p);
+    output->GetPoint(i, q);
+    // ASCII files store fewer significant digits than a float has.
+    double tol = binary ? 0.0 : 1e-3;
+    for (int c = 0; c < 3; ++c)
+      {
+      if (q[c] - p[c] > tol || p[c] - q[c] > tol)
+        {
+        cerr << "Mismatch in point " << i << " read from " << fileName
+             << endl;
+        return false;
+        }
+      }
+    }
+
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkCellArray *outPolys = output->GetPolys();
+  vtkIdType inNpts, *inPts, outNpts, *outPts;
+  inPolys->InitTraversal();
+  outPolys->InitTraversal();
+  vtkIdType cellId = 0;
+  while (inPolys->GetNextCell(inNpts, inPts))
+    {
+    if (!outPolys->GetNextCell(outNpts, outPts) || outNpts != inNpts)
+      {
+      cerr << "Mismatch in polygon " << cellId << " read from " << fileName
+           << endl;
+      return false;
+      }
+    for (vtkIdType j = 0; j < inNpts; ++j)
+      {
+      if (inPts[j] != outPts[j])
+        {
+        cerr << "Mismatch in polygon " << cellId << " read from "
+             << fileName << endl;
+        return false;
+        }
+      }
+    ++cellId;
+    }
+
+  return
+    CompareColors(vtkUnsignedCharArray::SafeDownCast(
+                    input->GetPointData()->GetArray("RGB")),
+                  output->GetPointData()->GetArray("RGB"), "point") &&
+    CompareColors(vtkUnsignedCharArray::SafeDownCast(
+                    input->GetCellData()->GetArray("RGB")),
+                  output->GetCellData()->GetArray("RGB"), "cell");
+}
+
+}
+
+int TestPLYReadWriteBlocks(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string fileName = tempDir;
+  fileName += "/TestPLYReadWriteBlocks.ply";
+  delete [] tempDir;
+
+  // Enough points and polygons to span several blocks, with polygons of
+  // varying size so that the face elements do not all have the same length.
+  const vtkIdType numPoints = 600000;
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numPoints);
+  vtkNew<vtkUnsignedCharArray> pointColors;
+  pointColors->SetName("RGB");
+  pointColors->SetNumberOfComponents(3);
+  pointColors->SetNumberOfTuples(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    points->SetPoint(i, 0.25 * (i % 1000), 0.5 * (i / 1000), 0.125 * (i % 7));
+    pointColors->SetTuple3(i, i % 256, (i * 7) % 256, (i * 13) % 256);
+    }
+
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkUnsignedCharArray> cellColors;
+  cellColors->SetName("RGB");
+  cellColors->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i + 6 < numPoints; i += 2)
+    {
+    vtkIdType ids[6];
+    vtkIdType npts = 3 + (i / 2) % 4;
+    for (vtkIdType j = 0; j < npts; ++j)
+      {
+      ids[j] = (i + j * j) % numPoints;
+      }
+    polys->InsertNextCell(npts, ids);
+    cellColors->InsertNextTuple3(i % 256, 255 - i % 256, 3);
+    }
+
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points.GetPointer());
+  input->SetPolys(polys.GetPointer());
+  input->GetPointData()->AddArray(pointColors.GetPointer());
+  input->GetCellData()->AddArray(cellColors.GetPointer());
+
+  if (!RoundTrip(input.GetPointer(), fileName.c_str(), true,
+                 VTK_LITTLE_ENDIAN) ||
+      !RoundTrip(input.GetPointer(), fileName.c_str(), true,
+                 VTK_BIG_ENDIAN) ||
+      !RoundTrip(input.GetPointer(), fileName.c_str(), false,
+                 VTK_LITTLE_ENDIAN))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
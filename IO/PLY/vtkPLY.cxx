@@ -49,10 +49,13 @@ WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
 #include "vtkPLY.h"
 #include "vtkHeap.h"
 #include "vtkByteSwap.h"
+#include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <string.h>
 #include <cassert>
+#include <vector>
 
 /* memory allocation */
 #define myalloc(mem_size) vtkPLY::my_alloc((mem_size), __LINE__, __FILE__)
@@ -99,6 +102,364 @@ static const int ply_type_size[] = {
 #define OTHER_PROP       0
 #define NAMED_PROP       1
 
+/* elements are read and written through memory in blocks of at most this
+   many bytes beyond what is strictly needed */
+#define BLOCK_READ_AHEAD  (1 << 26)
+
+
+/******************************************************************************
+Byte-swapped access to the items of a binary PLY file held in memory.  These
+convert values exactly like get_binary_item() and write_binary_item().
+******************************************************************************/
+
+template <class T>
+static T get_buffered_value(const char *ptr, int file_type)
+{
+  T value;
+  memcpy(&value, ptr, sizeof(value));
+  file_type == PLY_BINARY_BE ?
+    vtkByteSwap::SwapBE(&value) :
+    vtkByteSwap::SwapLE(&value);
+  return value;
+}
+
+template <class T>
+static void put_buffered_value(char *ptr, int file_type, T value)
+{
+  file_type == PLY_BINARY_BE ?
+    vtkByteSwap::SwapBE(&value) :
+    vtkByteSwap::SwapLE(&value);
+  memcpy(ptr, &value, sizeof(value));
+}
+
+static void get_buffered_item(
+  const char *ptr,
+  int file_type,
+  int type,
+  int *int_val,
+  unsigned int *uint_val,
+  double *double_val
+)
+{
+  switch (type) {
+    case PLY_CHAR:
+      {
+      vtkTypeInt8 value = get_buffered_value<vtkTypeInt8>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_UCHAR:
+    case PLY_UINT8:
+      {
+      vtkTypeUInt8 value = get_buffered_value<vtkTypeUInt8>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_SHORT:
+      {
+      vtkTypeInt16 value = get_buffered_value<vtkTypeInt16>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_USHORT:
+      {
+      vtkTypeUInt16 value = get_buffered_value<vtkTypeUInt16>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_INT:
+    case PLY_INT32:
+      {
+      vtkTypeInt32 value = get_buffered_value<vtkTypeInt32>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_UINT:
+      {
+      vtkTypeUInt32 value = get_buffered_value<vtkTypeUInt32>(ptr, file_type);
+      *int_val = value;
+      *uint_val = value;
+      *double_val = value;
+      }
+      break;
+    case PLY_FLOAT:
+    case PLY_FLOAT32:
+      {
+      vtkTypeFloat32 value = get_buffered_value<vtkTypeFloat32>(ptr, file_type);
+      *int_val = static_cast<int>(value);
+      *uint_val = static_cast<unsigned int>(value);
+      *double_val = value;
+      }
+      break;
+    case PLY_DOUBLE:
+      {
+      vtkTypeFloat64 value = get_buffered_value<vtkTypeFloat64>(ptr, file_type);
+      *int_val = static_cast<int>(value);
+      *uint_val = static_cast<unsigned int>(value);
+      *double_val = value;
+      }
+      break;
+    default:
+      *int_val = 0;
+      *uint_val = 0;
+      *double_val = 0.0;
+  }
+}
+
+static void put_buffered_item(
+  char *ptr,
+  int file_type,
+  int int_val,
+  unsigned int uint_val,
+  double double_val,
+  int type
+)
+{
+  switch (type) {
+    case PLY_CHAR:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeInt8>(int_val));
+      break;
+    case PLY_SHORT:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeInt16>(int_val));
+      break;
+    case PLY_INT:
+    case PLY_INT32:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeInt32>(int_val));
+      break;
+    case PLY_UCHAR:
+    case PLY_UINT8:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeUInt8>(uint_val));
+      break;
+    case PLY_USHORT:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeUInt16>(uint_val));
+      break;
+    case PLY_UINT:
+      put_buffered_value(ptr, file_type, static_cast<vtkTypeUInt32>(uint_val));
+      break;
+    case PLY_FLOAT:
+    case PLY_FLOAT32:
+      put_buffered_value(ptr, file_type,
+                         static_cast<vtkTypeFloat32>(double_val));
+      break;
+    case PLY_DOUBLE:
+      put_buffered_value(ptr, file_type,
+                         static_cast<vtkTypeFloat64>(double_val));
+      break;
+  }
+}
+
+/******************************************************************************
+Make sure that at least "needed" bytes of the file have been read into the
+buffer.  Unless "exact" is set, more is read ahead to limit the number of
+reads.  Returns false at the end of the file.
+******************************************************************************/
+
+static bool fill_buffer(FILE *fp, std::vector<char> &buffer, size_t needed,
+                        bool exact)
+{
+  if (buffer.size() >= needed)
+    return true;
+
+  size_t request = needed - buffer.size();
+  if (!exact) {
+    request = std::max(request,
+      std::min(std::max(buffer.size(), static_cast<size_t>(1 << 20)),
+               static_cast<size_t>(BLOCK_READ_AHEAD)));
+  }
+  size_t filled = buffer.size();
+  buffer.resize(filled + request);
+  filled += fread (&buffer[filled], 1, request, fp);
+  buffer.resize(filled);
+  return filled >= needed;
+}
+
+/******************************************************************************
+Converts binary elements held in memory into the user's structures.  This
+does for each element what binary_get_element() does.
+******************************************************************************/
+
+class vtkPLYBlockDecoder
+{
+public:
+  vtkPLYBlockDecoder(PlyFile *plyfile, const char *buffer,
+                     const size_t *starts, char *elems, int elem_size)
+    : FileType(plyfile->file_type), Elem(plyfile->which_elem),
+      Buffer(buffer), Starts(starts), Elems(elems), ElemSize(elem_size) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    PlyElement *elem = this->Elem;
+    int int_val;
+    unsigned int uint_val;
+    double double_val;
+
+    for (vtkIdType i = begin; i < end; i++) {
+      const char *data = this->Buffer + this->Starts[i];
+      char *elem_ptr = this->Elems + i * this->ElemSize;
+      char *other_data = 0;
+      int other_flag = 0;
+      if (elem->other_offset != NO_OTHER_PROPS) {
+        other_data = *(char **) (elem_ptr + elem->other_offset);
+        other_flag = 1;
+      }
+
+      for (int j = 0; j < elem->nprops; j++) {
+        PlyProperty *prop = elem->props[j];
+        int store_it = (elem->store_prop[j] | other_flag);
+        char *elem_data = elem->store_prop[j] ? elem_ptr : other_data;
+
+        if (prop->is_list) {
+          get_buffered_item (data, this->FileType, prop->count_external,
+                             &int_val, &uint_val, &double_val);
+          data += ply_type_size[prop->count_external];
+          if (store_it)
+            vtkPLY::store_item (elem_data + prop->count_offset,
+                                prop->count_internal,
+                                int_val, uint_val, double_val);
+
+          int list_count = int_val;
+          char **store_array = (char **) (elem_data + prop->offset);
+          if (list_count <= 0) {
+            if (store_it)
+              *store_array = NULL;
+            continue;
+          }
+
+          int external_size = ply_type_size[prop->external_type];
+          if (!store_it) {
+            data += list_count * external_size;
+            continue;
+          }
+          int item_size = ply_type_size[prop->internal_type];
+          char *item = (char *) myalloc (item_size * list_count);
+          *store_array = item;
+          for (int k = 0; k < list_count; k++) {
+            get_buffered_item (data, this->FileType, prop->external_type,
+                               &int_val, &uint_val, &double_val);
+            data += external_size;
+            vtkPLY::store_item (item, prop->internal_type,
+                                int_val, uint_val, double_val);
+            item += item_size;
+          }
+        }
+        else {
+          get_buffered_item (data, this->FileType, prop->external_type,
+                             &int_val, &uint_val, &double_val);
+          data += ply_type_size[prop->external_type];
+          if (store_it)
+            vtkPLY::store_item (elem_data + prop->offset, prop->internal_type,
+                                int_val, uint_val, double_val);
+        }
+      }
+    }
+  }
+
+private:
+  int FileType;
+  PlyElement *Elem;
+  const char *Buffer;
+  const size_t *Starts;
+  char *Elems;
+  int ElemSize;
+};
+
+/******************************************************************************
+Converts the user's structures into binary elements held in memory.  This
+does for each element what ply_put_element() does.  With a NULL buffer only
+the size in bytes of each element is computed and stored in sizes.
+******************************************************************************/
+
+class vtkPLYBlockEncoder
+{
+public:
+  vtkPLYBlockEncoder(PlyFile *plyfile, char *elems, int elem_size,
+                     size_t *starts, char *buffer)
+    : FileType(plyfile->file_type), Elem(plyfile->which_elem),
+      Elems(elems), ElemSize(elem_size), Starts(starts), Buffer(buffer) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    PlyElement *elem = this->Elem;
+    int int_val;
+    unsigned int uint_val;
+    double double_val;
+
+    for (vtkIdType i = begin; i < end; i++) {
+      char *elem_ptr = this->Elems + i * this->ElemSize;
+      char **other_ptr = (char **) (elem_ptr + elem->other_offset);
+      char *data = this->Buffer ? this->Buffer + this->Starts[i] : NULL;
+      size_t size = 0;
+
+      for (int j = 0; j < elem->nprops; j++) {
+        PlyProperty *prop = elem->props[j];
+        char *elem_data;
+        if (elem->store_prop[j] == OTHER_PROP)
+          elem_data = *other_ptr;
+        else
+          elem_data = elem_ptr;
+
+        if (prop->is_list) {
+          vtkPLY::get_stored_item (elem_data + prop->count_offset,
+                                   prop->count_internal,
+                                   &int_val, &uint_val, &double_val);
+          unsigned int list_count = uint_val;
+          int external_size = ply_type_size[prop->external_type];
+          if (!data) {
+            size += ply_type_size[prop->count_external] +
+                    list_count * external_size;
+            continue;
+          }
+          put_buffered_item (data, this->FileType, int_val, uint_val,
+                             double_val, prop->count_external);
+          data += ply_type_size[prop->count_external];
+          const char *item = *(char **) (elem_data + prop->offset);
+          int item_size = ply_type_size[prop->internal_type];
+          for (unsigned int k = 0; k < list_count; k++) {
+            vtkPLY::get_stored_item (item, prop->internal_type,
+                                     &int_val, &uint_val, &double_val);
+            put_buffered_item (data, this->FileType, int_val, uint_val,
+                               double_val, prop->external_type);
+            data += external_size;
+            item += item_size;
+          }
+        }
+        else if (!data) {
+          size += ply_type_size[prop->external_type];
+        }
+        else {
+          vtkPLY::get_stored_item (elem_data + prop->offset,
+                                   prop->internal_type,
+                                   &int_val, &uint_val, &double_val);
+          put_buffered_item (data, this->FileType, int_val, uint_val,
+                             double_val, prop->external_type);
+          data += ply_type_size[prop->external_type];
+        }
+      }
+
+      if (!data)
+        this->Starts[i + 1] = size;
+    }
+  }
+
+private:
+  int FileType;
+  PlyElement *Elem;
+  char *Elems;
+  int ElemSize;
+  size_t *Starts;
+  char *Buffer;
+};
+
 
 /*************/
 /*  Writing  */
@@ -607,6 +968,53 @@ void vtkPLY::ply_put_element(PlyFile *plyfile, void *elem_ptr)
 }
 
 
+/******************************************************************************
+Write a block of elements to the file.  This is equivalent to calling
+ply_put_element() for each of them, but binary elements are converted in
+parallel and written all at once.
+
+Entry:
+  plyfile   - file identifier
+  elem_ptr  - pointer to an array of elements
+  elem_size - size in bytes of one element of the array
+  num       - number of elements to write
+******************************************************************************/
+
+void vtkPLY::ply_put_element_block(
+  PlyFile *plyfile,
+  void *elem_ptr,
+  int elem_size,
+  int num
+)
+{
+  char *elems = (char *) elem_ptr;
+
+  if (plyfile->file_type == PLY_ASCII) {
+    for (int i = 0; i < num; i++)
+      ply_put_element (plyfile, elems + (size_t) i * elem_size);
+    return;
+  }
+  if (num <= 0)
+    return;
+
+  /* find where each element goes, then convert them all */
+  std::vector<size_t> starts(num + 1, 0);
+  vtkPLYBlockEncoder sizer(plyfile, elems, elem_size, &starts[0], NULL);
+  vtkSMPTools::For(0, num, sizer);
+  for (int i = 0; i < num; i++)
+    starts[i + 1] += starts[i];
+
+  std::vector<char> buffer(starts[num]);
+  if (buffer.empty())
+    return;
+  vtkPLYBlockEncoder encoder(plyfile, elems, elem_size, &starts[0],
+                             &buffer[0]);
+  vtkSMPTools::For(0, num, encoder);
+
+  fwrite (&buffer[0], 1, buffer.size(), plyfile->fp);
+}
+
+
 /******************************************************************************
 Specify a comment that will be written in the header.
 
@@ -986,6 +1394,131 @@ void vtkPLY::ply_get_element(PlyFile *plyfile, void *elem_ptr)
 }
 
 
+/******************************************************************************
+Read a block of elements from the file.  This is equivalent to calling
+ply_get_element() for each of them, but binary elements are read all at once
+and converted in parallel.
+
+Entry:
+  plyfile   - file identifier
+  elem_ptr  - pointer to an array of elements
+  elem_size - size in bytes of one element of the array
+  num       - number of elements to read
+
+Exit:
+  returns PLY_OKAY, or PLY_ERROR if the file ended early, in which case the
+  elements that could not be read are zeroed
+******************************************************************************/
+
+int vtkPLY::ply_get_element_block(
+  PlyFile *plyfile,
+  void *elem_ptr,
+  int elem_size,
+  int num
+)
+{
+  char *elems = (char *) elem_ptr;
+  PlyElement *elem = plyfile->which_elem;
+
+  if (plyfile->file_type == PLY_ASCII) {
+    for (int i = 0; i < num; i++)
+      ascii_get_element (plyfile, elems + (size_t) i * elem_size);
+    return PLY_OKAY;
+  }
+  if (num <= 0)
+    return PLY_OKAY;
+
+  /* elements without lists all have the same size in the file */
+  bool fixed_size = true;
+  size_t size = 0;
+  for (int j = 0; j < elem->nprops; j++) {
+    if (elem->props[j]->is_list)
+      fixed_size = false;
+    else
+      size += ply_type_size[elem->props[j]->external_type];
+  }
+
+  /* read the elements, finding where each one starts */
+  std::vector<char> buffer;
+  std::vector<size_t> starts(num + 1);
+  int num_read = num;
+  if (fixed_size) {
+    size_t available = fill_buffer (plyfile->fp, buffer, num * size, true) ?
+      num * size : buffer.size();
+    num_read = size ? static_cast<int>(available / size) : num;
+    for (int i = 0; i <= num_read; i++)
+      starts[i] = i * size;
+  }
+  else {
+    int int_val;
+    unsigned int uint_val;
+    double double_val;
+    size_t pos = 0;
+    int scanned = 0;
+    bool eof = false;
+    for (; scanned < num && !eof; scanned++) {
+      starts[scanned] = pos;
+      for (int j = 0; j < elem->nprops && !eof; j++) {
+        PlyProperty *prop = elem->props[j];
+        if (!prop->is_list) {
+          pos += ply_type_size[prop->external_type];
+          continue;
+        }
+        eof = !fill_buffer (plyfile->fp, buffer,
+                            pos + ply_type_size[prop->count_external], false);
+        if (eof)
+          break;
+        get_buffered_item (&buffer[pos], plyfile->file_type,
+                           prop->count_external,
+                           &int_val, &uint_val, &double_val);
+        pos += ply_type_size[prop->count_external];
+        if (int_val > 0)
+          pos += (size_t) int_val * ply_type_size[prop->external_type];
+      }
+    }
+    if (eof) {
+      scanned--;
+    }
+    else {
+      starts[num] = pos;
+      eof = !fill_buffer (plyfile->fp, buffer, pos, false);
+    }
+    /* the elements that end within what could be read are complete */
+    num_read = static_cast<int>(
+      std::upper_bound(starts.begin() + 1, starts.begin() + scanned + 1,
+                       buffer.size()) - (starts.begin() + 1));
+    if (!eof && buffer.size() > pos) {
+      /* give back what was read ahead */
+      fseek (plyfile->fp, -static_cast<long>(buffer.size() - pos), SEEK_CUR);
+    }
+  }
+
+  if (num_read < num) {
+    vtkGenericWarningMacro ("PLY error reading file."
+                            << " Premature EOF while reading elements.");
+    memset (elems + (size_t) num_read * elem_size, 0,
+            (size_t) (num - num_read) * elem_size);
+  }
+
+  /* make room for other_props */
+  if (elem->other_offset != NO_OTHER_PROPS) {
+    for (int i = 0; i < num_read; i++) {
+      char **ptr = (char **) (elems + (size_t) i * elem_size +
+                              elem->other_offset);
+      *ptr = (char *) plyAllocateMemory(elem->other_size);
+    }
+  }
+
+  if (num_read > 0) {
+    vtkPLYBlockDecoder decoder(plyfile, &buffer[0], &starts[0], elems,
+                               elem_size);
+    vtkSMPTools::For(0, num_read, decoder);
+  }
+
+  return num_read == num ? PLY_OKAY : PLY_ERROR;
+}
+
+
 /******************************************************************************
 Extract the comments from the header information of a PLY file.
 
@@ -2602,6 +3135,7 @@ void vtkPLY::add_property (PlyFile *plyfile, char **words, int )
   if (equal_strings (words[1], "list")) {       /* is a list */
     prop->count_external = get_prop_type (words[2]);
     prop->external_type = get_prop_type (words[3]);
+    prop->count_internal = prop->count_external;
     prop->name = strdup (words[4]);
     prop->is_list = 1;
   }
@@ -2611,6 +3145,10 @@ void vtkPLY::add_property (PlyFile *plyfile, char **words, int )
     prop->is_list = 0;
   }
 
+  /* properties that are never requested are read but not stored; give */
+  /* them valid internal types so that they can still be sized */
+  prop->internal_type = prop->external_type;
+
   /* add this property to the list of properties of the current element */
 
   elem = plyfile->elems[plyfile->nelems - 1];
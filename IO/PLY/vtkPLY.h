@@ -165,6 +165,7 @@ public:
   static void ply_header_complete(PlyFile *);
   static void ply_put_element_setup(PlyFile *, const char *);
   static void ply_put_element(PlyFile *, void *);
+  static void ply_put_element_block(PlyFile *, void *, int, int);
   static void ply_put_comment(PlyFile *, const char *);
   static void ply_put_obj_info(PlyFile *, const char *);
   static PlyFile *ply_read(FILE *, int *, char ***);
@@ -174,6 +175,7 @@ public:
   static void ply_get_property(PlyFile *, const char *, PlyProperty *);
   static PlyOtherProp *ply_get_other_properties(PlyFile *, const char *, int);
   static void ply_get_element(PlyFile *, void *);
+  static int ply_get_element_block(PlyFile *, void *, int, int);
   static char **ply_get_comments(PlyFile *, int *);
   static char **ply_get_obj_info(PlyFile *, int *);
   static void ply_close(PlyFile *);
@@ -18,15 +18,19 @@
 #include "vtkCellData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPLY.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <ctype.h>
 #include <cstddef>
+#include <vector>
 
 vtkStandardNewMacro(vtkPLYReader);
 
@@ -44,6 +48,12 @@ vtkPLYReader::~vtkPLYReader()
   delete [] this->FileName;
 }
 
+
+// Elements are read this many at a time.
+static const int vtkPLYReaderBlockSize = 1 << 18;
+
+namespace {
+
 typedef struct _plyVertex {
   float x[3];             // the usual 3-space position of a vertex
   float tex[2];
@@ -62,6 +72,91 @@ typedef struct _plyFace {
   int *verts;             // vertex index list
 } plyFace;
 
+// Copies a block of vertices into the output arrays.  Arrays that are not
+// read are NULL.
+class vtkPLYReaderCopyVertices
+{
+public:
+  vtkPLYReaderCopyVertices(const plyVertex *vertices, float *points,
+                           float *tcoords, float *normals, unsigned char *rgb)
+    : Vertices(vertices), Points(points), TCoords(tcoords), Normals(normals),
+      RGB(rgb) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType j = begin; j < end; j++)
+      {
+      const plyVertex &vertex = this->Vertices[j];
+      std::copy(vertex.x, vertex.x + 3, this->Points + 3*j);
+      if ( this->TCoords )
+        {
+        std::copy(vertex.tex, vertex.tex + 2, this->TCoords + 2*j);
+        }
+      if ( this->Normals )
+        {
+        std::copy(vertex.normal, vertex.normal + 3, this->Normals + 3*j);
+        }
+      if ( this->RGB )
+        {
+        this->RGB[3*j] = vertex.red;
+        this->RGB[3*j+1] = vertex.green;
+        this->RGB[3*j+2] = vertex.blue;
+        }
+      }
+  }
+
+private:
+  const plyVertex *Vertices;
+  float *Points;
+  float *TCoords;
+  float *Normals;
+  unsigned char *RGB;
+};
+
+// Copies a block of faces into the connectivity and cell arrays and frees
+// their vertex lists.  Offsets gives where each face goes in the
+// connectivity.  Arrays that are not read are NULL.
+class vtkPLYReaderCopyFaces
+{
+public:
+  vtkPLYReaderCopyFaces(plyFace *faces, const vtkIdType *offsets,
+                        vtkIdType *connectivity, unsigned char *intensity,
+                        unsigned char *rgb)
+    : Faces(faces), Offsets(offsets), Connectivity(connectivity),
+      Intensity(intensity), RGB(rgb) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType j = begin; j < end; j++)
+      {
+      plyFace &face = this->Faces[j];
+      vtkIdType *ids = this->Connectivity + this->Offsets[j];
+      *ids++ = face.nverts;
+      std::copy(face.verts, face.verts + face.nverts, ids);
+      free(face.verts); // allocated in vtkPLY::ply_get_element_block
+      if ( this->Intensity )
+        {
+        this->Intensity[j] = face.intensity;
+        }
+      if ( this->RGB )
+        {
+        this->RGB[3*j] = face.red;
+        this->RGB[3*j+1] = face.green;
+        this->RGB[3*j+2] = face.blue;
+        }
+      }
+  }
+
+private:
+  plyFace *Faces;
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  unsigned char *Intensity;
+  unsigned char *RGB;
+};
+
+}
+
 int vtkPLYReader::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **vtkNotUsed(inputVector),
@@ -176,7 +271,7 @@ int vtkPLYReader::RequestData(
        vtkPLY::find_property (elem, "green", &index) != NULL &&
        vtkPLY::find_property (elem, "blue", &index) != NULL )
     {
-    RGBPoints = vtkUnsignedCharArray::New();
+    RGBPoints = vtkSmartPointer<vtkUnsignedCharArray>::New();
     RGBPointsAvailable = true;
     RGBPoints->SetName("RGB");
     RGBPoints->SetNumberOfComponents(3);
@@ -255,23 +350,23 @@ int vtkPLYReader::RequestData(
         RGBPoints->SetNumberOfTuples(numPts);
         }
 
-      plyVertex vertex;
-      for (int j=0; j < numPts; j++)
+      // Read the vertices a block at a time.
+      std::vector<plyVertex> vertices(std::min(numPts, vtkPLYReaderBlockSize));
+      for (int j=0; j < numPts; j += vtkPLYReaderBlockSize)
         {
-        vtkPLY::ply_get_element (ply, (void *) &vertex);
-        pts->SetPoint (j, vertex.x);
-        if ( TexCoordsPointsAvailable )
-          {
-          TexCoordsPoints->SetTuple2(j, vertex.tex[0], vertex.tex[1]);
-          }
-        if ( NormalPointsAvailable )
-          {
-          Normals->SetTuple3(j, vertex.normal[0], vertex.normal[1], vertex.normal[2]);
-          }
-        if ( RGBPointsAvailable )
+        int numBlock = std::min(numPts - j, vtkPLYReaderBlockSize);
+        if ( vtkPLY::ply_get_element_block(ply, &vertices[0],
+               static_cast<int>(sizeof(plyVertex)), numBlock) != PLY_OKAY )
           {
-          RGBPoints->SetTuple3(j, vertex.red, vertex.green, vertex.blue);
+          vtkWarningMacro(<<"Could not read all the vertices");
           }
+        vtkPLYReaderCopyVertices copier(
+          &vertices[0],
+          static_cast<float*>(pts->GetVoidPointer(3*j)),
+          TexCoordsPointsAvailable ? TexCoordsPoints->GetPointer(2*j) : NULL,
+          NormalPointsAvailable ? Normals->GetPointer(3*j) : NULL,
+          RGBPointsAvailable ? RGBPoints->GetPointer(3*j) : NULL);
+        vtkSMPTools::For(0, numBlock, copier);
         }
       output->SetPoints(pts);
       pts->Delete();
@@ -282,17 +377,17 @@ int vtkPLYReader::RequestData(
       // Create a polygonal array
       numPolys = numElems;
       vtkCellArray *polys = vtkCellArray::New();
-      polys->Allocate(polys->EstimateSize(numPolys,3),numPolys/2);
-      plyFace face;
-      vtkIdType vtkVerts[256];
+      vtkSmartPointer<vtkIdTypeArray> connectivity =
+        vtkSmartPointer<vtkIdTypeArray>::New();
+      connectivity->Allocate(polys->EstimateSize(numPolys,3));
 
       // Get the face properties
       vtkPLY::ply_get_property (ply, elemName, &faceProps[0]);
       if ( intensityAvailable )
         {
         vtkPLY::ply_get_property (ply, elemName, &faceProps[1]);
-        RGBCells->SetNumberOfComponents(1);
-        RGBCells->SetNumberOfTuples(numPolys);
+        intensity->SetNumberOfComponents(1);
+        intensity->SetNumberOfTuples(numPolys);
         }
       if ( RGBCellsAvailable )
         {
@@ -303,29 +398,32 @@ int vtkPLYReader::RequestData(
         RGBCells->SetNumberOfTuples(numPolys);
         }
 
-      // grab all the face elements
-      for (int j=0; j < numPolys; j++)
+      // Read the faces a block at a time.
+      std::vector<plyFace> faces(std::min(numPolys, vtkPLYReaderBlockSize));
+      std::vector<vtkIdType> offsets(faces.size() + 1);
+      for (int j=0; j < numPolys; j += vtkPLYReaderBlockSize)
         {
-        //grab and element from the file
-        vtkPLY::ply_get_element (ply, (void *) &face);
-        for (int k=0; k < face.nverts; k++)
+        int numBlock = std::min(numPolys - j, vtkPLYReaderBlockSize);
+        if ( vtkPLY::ply_get_element_block(ply, &faces[0],
+               static_cast<int>(sizeof(plyFace)), numBlock) != PLY_OKAY )
           {
-          vtkVerts[k] = face.verts[k];
+          vtkWarningMacro(<<"Could not read all the faces");
           }
-        free(face.verts); // allocated in vtkPLY::ascii/binary_get_element
 
-        polys->InsertNextCell(face.nverts,vtkVerts);
-        if ( intensityAvailable )
+        offsets[0] = connectivity->GetNumberOfTuples();
+        for (int k=0; k < numBlock; k++)
           {
-          intensity->SetValue(j,face.intensity);
-          }
-        if ( RGBCellsAvailable )
-          {
-          RGBCells->SetValue(3*j,face.red);
-          RGBCells->SetValue(3*j+1,face.green);
-          RGBCells->SetValue(3*j+2,face.blue);
+          offsets[k+1] = offsets[k] + faces[k].nverts + 1;
           }
+        connectivity->WritePointer(offsets[0], offsets[numBlock] - offsets[0]);
+
+        vtkPLYReaderCopyFaces copier(
+          &faces[0], &offsets[0], connectivity->GetPointer(0),
+          intensityAvailable ? intensity->GetPointer(j) : NULL,
+          RGBCellsAvailable ? RGBCells->GetPointer(3*j) : NULL);
+        vtkSMPTools::For(0, numBlock, copier);
         }
+      polys->SetCells(numPolys, connectivity);
       output->SetPolys(polys);
       polys->Delete();
       }//if face
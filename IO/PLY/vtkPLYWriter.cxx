@@ -22,8 +22,11 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkScalarsToColors.h"
+#include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <vector>
 
 vtkStandardNewMacro(vtkPLYWriter);
 
@@ -54,6 +57,12 @@ vtkPLYWriter::~vtkPLYWriter()
   delete[] this->FileName;
 }
 
+
+// Elements are written this many at a time.
+static const vtkIdType vtkPLYWriterBlockSize = 1 << 18;
+
+namespace {
+
 typedef struct _plyVertex {
   float x[3];             // the usual 3-space position of a vertex
   unsigned char red;
@@ -69,6 +78,43 @@ typedef struct _plyFace {
   unsigned char blue;
 } plyFace;
 
+// Fills a block of vertices from the points and point colors.
+class vtkPLYWriterCopyVertices
+{
+public:
+  vtkPLYWriterCopyVertices(vtkPoints *points, vtkIdType first,
+                           const unsigned char *colors, plyVertex *vertices)
+    : Points(points), First(first), Colors(colors), Vertices(vertices) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    double dpoint[3];
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      plyVertex &vert = this->Vertices[i];
+      this->Points->GetPoint(this->First + i, dpoint);
+      vert.x[0] = static_cast<float>(dpoint[0]);
+      vert.x[1] = static_cast<float>(dpoint[1]);
+      vert.x[2] = static_cast<float>(dpoint[2]);
+      if ( this->Colors )
+        {
+        const unsigned char *color = this->Colors + 3*(this->First + i);
+        vert.red = color[0];
+        vert.green = color[1];
+        vert.blue = color[2];
+        }
+      }
+  }
+
+private:
+  vtkPoints *Points;
+  vtkIdType First;
+  const unsigned char *Colors;
+  plyVertex *Vertices;
+};
+
+}
+
 void vtkPLYWriter::WriteData()
 {
   vtkIdType i, j, idx;
@@ -181,31 +227,24 @@ void vtkPLYWriter::WriteData()
   // complete the header
   vtkPLY::ply_header_complete (ply);
 
-  // set up and write the vertex elements
-  plyVertex vert;
+  // set up and write the vertex elements, a block at a time
   vtkPLY::ply_put_element_setup (ply, "vertex");
-  double dpoint[3];
-  for (i = 0; i < numPts; i++)
+  std::vector<plyVertex> verts(std::min(numPts, vtkPLYWriterBlockSize));
+  for (i = 0; i < numPts; i += vtkPLYWriterBlockSize)
     {
-    inPts->GetPoint(i,dpoint);
-    vert.x[0] = static_cast<float>(dpoint[0]);
-    vert.x[1] = static_cast<float>(dpoint[1]);
-    vert.x[2] = static_cast<float>(dpoint[2]);
-    if ( pointColors )
-      {
-      idx = 3*i;
-      vert.red = *(pointColors + idx);
-      vert.green = *(pointColors + idx + 1);
-      vert.blue = *(pointColors + idx + 2);
-      }
-    vtkPLY::ply_put_element (ply, (void *) &vert);
+    vtkIdType numBlock = std::min(numPts - i, vtkPLYWriterBlockSize);
+    vtkPLYWriterCopyVertices copier(inPts, i, pointColors, &verts[0]);
+    vtkSMPTools::For(0, numBlock, copier);
+    vtkPLY::ply_put_element_block (ply, &verts[0],
+                                   static_cast<int>(sizeof(plyVertex)),
+                                   static_cast<int>(numBlock));
     }
 
-  // set up and write the face elements
-  plyFace face;
-  int verts[256];
-  face.verts = verts;
+  // set up and write the face elements, a block at a time
   vtkPLY::ply_put_element_setup (ply, "face");
+  std::vector<plyFace> faces;
+  std::vector<int> faceVerts;
+  std::vector<vtkIdType> faceOffsets;
   vtkIdType npts = 0;
   vtkIdType *pts = 0;
   for (polys->InitTraversal(), i = 0; i < numPolys; i++)
@@ -217,11 +256,9 @@ void vtkPLYWriter::WriteData()
       }
     else
       {
-      for (j=0; j<npts; j++)
-        {
-        face.nverts = npts;
-        verts[j] = (int)pts[j];
-        }
+      plyFace face;
+      face.nverts = static_cast<unsigned char>(npts);
+      face.verts = NULL;
       if ( cellColors )
         {
         idx = 3*i;
@@ -229,7 +266,30 @@ void vtkPLYWriter::WriteData()
         face.green = *(cellColors + idx + 1);
         face.blue = *(cellColors + idx + 2);
         }
-      vtkPLY::ply_put_element (ply, (void *) &face);
+      faces.push_back(face);
+      faceOffsets.push_back(static_cast<vtkIdType>(faceVerts.size()));
+      for (j=0; j<npts; j++)
+        {
+        faceVerts.push_back(static_cast<int>(pts[j]));
+        }
+      }
+
+    if ( static_cast<vtkIdType>(faces.size()) == vtkPLYWriterBlockSize ||
+         (i == numPolys - 1 && !faces.empty()) )
+      {
+      for (size_t k = 0; k < faces.size(); k++)
+        {
+        if ( faces[k].nverts )
+          {
+          faces[k].verts = &faceVerts[faceOffsets[k]];
+          }
+        }
+      vtkPLY::ply_put_element_block (ply, &faces[0],
+                                     static_cast<int>(sizeof(plyFace)),
+                                     static_cast<int>(faces.size()));
+      faces.clear();
+      faceVerts.clear();
+      faceOffsets.clear();
       }
     }//for all polygons
 
@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLUnstructuredGridPieceStreaming.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Pushes the pieces of an unstructured grid one at a time through
+// vtkXMLUnstructuredGridWriter::WriteNextPiece() and reads the file back.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <string>
+
+namespace
+{
+// Build a strip of 'numCells' hexahedra starting at x = 'offset'.
+vtkSmartPointer<vtkUnstructuredGrid> MakePiece(int offset, int numCells)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> pointValues;
+  pointValues->SetName("PointValues");
+  for (int i = 0; i <= numCells; ++i)
+    {
+    for (int k = 0; k < 2; ++k)
+      {
+      for (int j = 0; j < 2; ++j)
+        {
+        points->InsertNextPoint(offset + i, j, k);
+        pointValues->InsertNextValue(offset + i + 10 * j + 100 * k);
+        }
+      }
+    }
+
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate(numCells);
+  for (int i = 0; i < numCells; ++i)
+    {
+    vtkIdType b = 4 * i;
+    vtkIdType hex[8] = { b, b + 4, b + 5, b + 1, b + 2, b + 6, b + 7, b + 3 };
+    grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+    cellIds->InsertNextValue(offset + i);
+    }
+  grid->GetPointData()->AddArray(pointValues.GetPointer());
+  grid->GetCellData()->AddArray(cellIds.GetPointer());
+  return grid;
+}
+
+int TestMode(const std::string& fileName, int dataMode)
+{
+  const int numPieces = 3;
+  const int cellsPerPiece[numPieces] = { 4, 1, 7 };
+
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataMode(dataMode);
+  writer->SetNumberOfPieces(numPieces);
+  // The input only needs to exist for Start(); every piece replaces it.
+  writer->SetInputData(MakePiece(0, 1));
+  writer->Start();
+  int offset = 0;
+  for (int piece = 0; piece < numPieces; ++piece)
+    {
+    writer->SetInputData(MakePiece(offset, cellsPerPiece[piece]));
+    writer->WriteNextPiece();
+    offset += cellsPerPiece[piece];
+    }
+  writer->Stop();
+
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+
+  vtkUnstructuredGrid* output = reader->GetOutput();
+  vtkIdType expectedPoints = 0;
+  for (int piece = 0; piece < numPieces; ++piece)
+    {
+    expectedPoints += 4 * (cellsPerPiece[piece] + 1);
+    }
+  if (output->GetNumberOfCells() != offset ||
+      output->GetNumberOfPoints() != expectedPoints)
+    {
+    cerr << "Wrong output size: " << output->GetNumberOfCells() << " cells, "
+         << output->GetNumberOfPoints() << " points" << endl;
+    return 0;
+    }
+
+  vtkIntArray* cellIds = vtkIntArray::SafeDownCast(
+    output->GetCellData()->GetArray("CellIds"));
+  if (!cellIds || !output->GetPointData()->GetArray("PointValues"))
+    {
+    cerr << "Missing attribute arrays" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+    {
+    if (cellIds->GetValue(i) != i ||
+        output->GetCellType(i) != VTK_HEXAHEDRON)
+      {
+      cerr << "Wrong cell " << i << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+}
+
+int TestXMLUnstructuredGridPieceStreaming(int argc, char* argv[])
+{
+  char* temp_dir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!temp_dir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string prefix = temp_dir;
+  delete [] temp_dir;
+  prefix += "/TestXMLUnstructuredGridPieceStreaming";
+
+  int result = EXIT_SUCCESS;
+  if (!TestMode(prefix + "-appended.vtu", vtkXMLWriter::Appended))
+    {
+    cerr << "Error: appended mode" << endl;
+    result = EXIT_FAILURE;
+    }
+  if (!TestMode(prefix + "-binary.vtu", vtkXMLWriter::Binary))
+    {
+    cerr << "Error: binary mode" << endl;
+    result = EXIT_FAILURE;
+    }
+  if (!TestMode(prefix + "-ascii.vtu", vtkXMLWriter::Ascii))
+    {
+    cerr << "Error: ascii mode" << endl;
+    result = EXIT_FAILURE;
+    }
+  return result;
+}
@@ -49,6 +49,7 @@ vtkXMLUnstructuredDataWriter::vtkXMLUnstructuredDataWriter()
   this->CellOffsets->SetName("offsets");
 
   this->CurrentPiece = 0;
+  this->UserPieceStreaming = 0;
   this->FieldDataOM->Allocate(0);
   this->PointsOM    = new OffsetsManagerGroup;
   this->PointDataOM = new OffsetsManagerArray;
@@ -96,7 +97,12 @@ int vtkXMLUnstructuredDataWriter::ProcessRequest(vtkInformation* request,
 
   if(request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
     {
-    if((this->WritePiece < 0) || (this->WritePiece >= this->NumberOfPieces))
+    if(this->UserPieceStreaming)
+      {
+      // The caller provides each piece as the complete input.
+      this->SetInputUpdateExtent(0, 1, 0);
+      }
+    else if((this->WritePiece < 0) || (this->WritePiece >= this->NumberOfPieces))
       {
       this->SetInputUpdateExtent(
         this->CurrentPiece, this->NumberOfPieces, this->GhostLevel);
@@ -185,8 +191,9 @@ int vtkXMLUnstructuredDataWriter::ProcessRequest(vtkInformation* request,
 
     if((this->WritePiece < 0) || (this->WritePiece >= this->NumberOfPieces))
       {
-      // Tell the pipeline to start looping.
-      if (this->CurrentPiece == 0)
+      // Tell the pipeline to start looping, unless the pieces are pushed
+      // one at a time through WriteNextPiece().
+      if (this->CurrentPiece == 0 && !this->UserPieceStreaming)
         {
         request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
         }
@@ -227,6 +234,55 @@ int vtkXMLUnstructuredDataWriter::ProcessRequest(vtkInformation* request,
   return this->Superclass::ProcessRequest(request, inputVector, outputVector);
 }
 
+//----------------------------------------------------------------------------
+void vtkXMLUnstructuredDataWriter::WriteNextPiece()
+{
+  if (this->UserContinueExecuting != 1)
+    {
+    vtkErrorMacro("Start() must be called before WriteNextPiece().");
+    return;
+    }
+  if (this->WritePiece >= 0 && this->WritePiece < this->NumberOfPieces)
+    {
+    vtkErrorMacro("WriteNextPiece() cannot be used to write a single piece. "
+                  "Set WritePiece to -1.");
+    return;
+    }
+
+  this->UserPieceStreaming = 1;
+  this->Modified();
+  this->Update();
+  this->UserPieceStreaming = 0;
+
+  // Push the piece to disk so that nothing of it has to be kept around.
+  if (this->Stream)
+    {
+    this->Stream->flush();
+    if (this->Stream->fail())
+      {
+      this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLUnstructuredDataWriter::WriteNextPiece(double time)
+{
+  this->WriteNextPiece();
+
+  // Record the time value once the last piece of the time step is written.
+  if (this->UserContinueExecuting == 1 && this->CurrentPiece == 0 &&
+      this->CurrentTimeIndex > 0 && this->NumberOfTimeValues && this->Stream)
+    {
+    ostream& os = *(this->Stream);
+    std::streampos returnPos = os.tellp();
+    vtkTypeInt64 t = this->NumberOfTimeValues[this->CurrentTimeIndex-1];
+    os.seekp(std::streampos(t));
+    os << time;
+    os.seekp(returnPos);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLUnstructuredDataWriter::AllocatePositionArrays()
 {
@@ -882,6 +938,11 @@ void vtkXMLUnstructuredDataWriter::ConvertCells(vtkCellArray* cells)
     inCell += numberOfPoints;
     *outCellOffset++ = outCellPoints - outCellPointsBase;
     }
+
+  // The arrays are reused for every piece; make sure their cached ranges
+  // are recomputed.
+  this->CellPoints->Modified();
+  this->CellOffsets->Modified();
 }
 
 //----------------------------------------------------------------------------
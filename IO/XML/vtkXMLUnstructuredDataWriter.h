@@ -53,6 +53,20 @@ public:
   vtkSetMacro(GhostLevel, int);
   vtkGetMacro(GhostLevel, int);
 
+  // Description:
+  // API to stream pieces into the file from outside the VTK pipeline.
+  // Set NumberOfPieces and call Start().  Then, for each piece, set the
+  // piece as the writer's input and call WriteNextPiece().  The piece is
+  // written and flushed immediately so that the caller can release it
+  // before producing the next one; the piece sizes and appended data
+  // offsets are patched into the header as the pieces arrive.  The first
+  // piece defines the set of arrays written for all pieces.  After
+  // NumberOfPieces pieces the writer moves on to the next time step
+  // (see SetNumberOfTimeSteps()), optionally recording the given time
+  // value.  Call Stop() to close the file.
+  void WriteNextPiece();
+  void WriteNextPiece(double time);
+
   // See the vtkAlgorithm for a desciption of what these do
   int ProcessRequest(vtkInformation*,
                      vtkInformationVector**,
@@ -157,6 +171,9 @@ protected:
 
   int CurrentPiece;
 
+  // Set while a piece provided through WriteNextPiece() is being written.
+  int UserPieceStreaming;
+
   // Hold the face arrays for polyhedron cells.
   vtkIdTypeArray* Faces;
   vtkIdTypeArray* FaceOffsets;
@@ -0,0 +1,305 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXdmf3ReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the heavy data cache of vtkXdmf3Reader
+// .SECTION Description
+// Writes an unstructured grid with its arrays in HDF5, makes a temporal
+// collection whose two steps refer to the same heavy data, and checks that
+// the steps share the arrays read for the first one, that the arrays are
+// read again when the cache is off, when the heavy data file is rewritten
+// and when the file name is set again, and that disabled arrays are not
+// read.
+
+#include "vtkXdmf3Reader.h"
+#include "vtkXdmf3Writer.h"
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include "vtksys/SystemTools.hxx"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+vtkUnstructuredGrid *MakeGrid()
+{
+  const int n = 20;
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> a;
+  a->SetName("A");
+  vtkNew<vtkDoubleArray> b;
+  b->SetName("B");
+  b->SetNumberOfComponents(3);
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        points->InsertNextPoint(i, 2.0 * j, 3.0 * k);
+        a->InsertNextValue(i + j * k);
+        b->InsertNextTuple3(i, j, k);
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+  grid->GetPointData()->AddArray(a.GetPointer());
+  grid->GetPointData()->AddArray(b.GetPointer());
+  grid->Allocate((n - 1) * (n - 1) * (n - 1));
+  for (int k = 0; k + 1 < n; ++k)
+    {
+    for (int j = 0; j + 1 < n; ++j)
+      {
+      for (int i = 0; i + 1 < n; ++i)
+        {
+        vtkIdType p = i + n * (j + n * k);
+        vtkIdType ids[8] = { p, p + 1, p + n + 1, p + n,
+                             p + n * n, p + n * n + 1, p + n * n + n + 1,
+                             p + n * n + n };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+        }
+      }
+    }
+  return grid;
+}
+
+// Repeats the grid of a file written by vtkXdmf3Writer as the steps of a
+// temporal collection. Both steps refer to the same heavy data.
+bool MakeTemporalFile(const std::string &in, const std::string &out)
+{
+  std::ifstream input(in.c_str());
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  std::string xml = buffer.str();
+  size_t start = xml.find("<Grid");
+  size_t end = xml.rfind("</Grid>");
+  if (start == std::string::npos || end == std::string::npos)
+    {
+    return false;
+    }
+  std::string grid = xml.substr(start, end + 7 - start);
+  size_t body = grid.find('>') + 1;
+
+  std::ofstream output(out.c_str());
+  output << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"2.0\">\n<Domain>\n"
+         << "<Grid Name=\"Steps\" GridType=\"Collection\""
+         << " CollectionType=\"Temporal\">\n";
+  for (int step = 0; step < 2; ++step)
+    {
+    output << grid.substr(0, body) << "\n<Time Value=\"" << step << "\"/>"
+           << grid.substr(body) << "\n";
+    }
+  output << "</Grid>\n</Domain>\n</Xdmf>\n";
+  return true;
+}
+
+struct Step
+{
+  vtkDataArray *Points;
+  vtkDataArray *Connectivity;
+  vtkDataArray *A;
+  vtkDataArray *B;
+};
+
+bool Read(vtkXdmf3Reader *reader, double time, vtkUnstructuredGrid *input,
+          Step &step)
+{
+  reader->UpdateInformation();
+  reader->GetOutputInformation(0)->Set(
+    vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), time);
+  reader->Update();
+  vtkUnstructuredGrid *output =
+    vtkUnstructuredGrid::SafeDownCast(reader->GetOutputDataObject(0));
+  if (!output ||
+      output->GetNumberOfPoints() != input->GetNumberOfPoints() ||
+      output->GetNumberOfCells() != input->GetNumberOfCells())
+    {
+    cerr << "Wrong output at time " << time << endl;
+    return false;
+    }
+  step.Points = output->GetPoints()->GetData();
+  step.Connectivity = output->GetCells()->GetData();
+  step.A = output->GetPointData()->GetArray("A");
+  step.B = output->GetPointData()->GetArray("B");
+
+  vtkDataArray *a = input->GetPointData()->GetArray("A");
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    double p[3], q[3];
+    input->GetPoint(i, p);
+    output->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2] ||
+        (step.A && step.A->GetComponent(i, 0) != a->GetComponent(i, 0)))
+      {
+      cerr << "Wrong point or array value " << i << " at time " << time
+           << endl;
+      return false;
+      }
+    }
+  vtkIdType inNpts, *inPts, outNpts, *outPts;
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+    {
+    input->GetCellPoints(i, inNpts, inPts);
+    output->GetCellPoints(i, outNpts, outPts);
+    if (outNpts != inNpts || output->GetCellType(i) != VTK_HEXAHEDRON)
+      {
+      cerr << "Wrong cell " << i << " at time " << time << endl;
+      return false;
+      }
+    for (vtkIdType j = 0; j < inNpts; ++j)
+      {
+      if (inPts[j] != outPts[j])
+        {
+        cerr << "Wrong cell " << i << " at time " << time << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+int TestXdmf3ReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string gridName = tempDir;
+  gridName += "/TestXdmf3ReaderCache.xmf";
+  std::string heavyName = tempDir;
+  heavyName += "/TestXdmf3ReaderCache.h5";
+  std::string stepsName = tempDir;
+  stepsName += "/TestXdmf3ReaderCacheSteps.xmf";
+  delete [] tempDir;
+
+  // The writer appends to an existing heavy data file, so remove the one
+  // left by an earlier run.
+  vtksys::SystemTools::RemoveFile(heavyName.c_str());
+  vtkUnstructuredGrid *input = MakeGrid();
+  vtkNew<vtkXdmf3Writer> writer;
+  writer->SetLightDataLimit(10);
+  writer->SetFileName(gridName.c_str());
+  writer->SetInputData(input);
+  writer->Write();
+  if (!MakeTemporalFile(gridName, stepsName))
+    {
+    cerr << "Could not make the temporal collection" << endl;
+    input->Delete();
+    return EXIT_FAILURE;
+    }
+
+  // With the cache, the second step shares what was read for the first.
+  vtkNew<vtkXdmf3Reader> reader;
+  reader->SetFileName(stepsName.c_str());
+  reader->SetHeavyDataCacheSize(64 * 1024);
+  reader->UpdateInformation();
+  reader->SetPointArrayStatus("B", 0);
+  Step first, second;
+  bool ok = Read(reader.GetPointer(), 0.0, input, first);
+  if (ok && (!first.A || first.B))
+    {
+    cerr << "The array selection was not honored" << endl;
+    ok = false;
+    }
+  if (ok)
+    {
+    first.Points->Register(NULL);
+    first.Connectivity->Register(NULL);
+    first.A->Register(NULL);
+    ok = Read(reader.GetPointer(), 1.0, input, second);
+    if (ok && (first.Points != second.Points ||
+               first.Connectivity != second.Connectivity ||
+               first.A != second.A || second.B))
+      {
+      cerr << "The steps do not share their arrays" << endl;
+      ok = false;
+      }
+    first.Points->UnRegister(NULL);
+    first.Connectivity->UnRegister(NULL);
+    first.A->UnRegister(NULL);
+    }
+
+  // New values in a rewritten heavy data file are read, not the cached ones.
+  // The new array makes the file longer, and leaves the slabs of the others
+  // where they were.
+  vtkDataArray *a = input->GetPointData()->GetArray("A");
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    a->SetComponent(i, 0, a->GetComponent(i, 0) + 1000.0);
+    }
+  vtkNew<vtkDoubleArray> c;
+  c->SetName("C");
+  c->DeepCopy(a);
+  input->GetPointData()->AddArray(c.GetPointer());
+  vtksys::SystemTools::RemoveFile(heavyName.c_str());
+  vtkNew<vtkXdmf3Writer> rewriter;
+  rewriter->SetLightDataLimit(10);
+  rewriter->SetFileName(gridName.c_str());
+  rewriter->SetInputData(input);
+  rewriter->Write();
+  reader->Modified();
+  ok = ok && Read(reader.GetPointer(), 0.0, input, first);
+
+  // Setting the file name drops the cached arrays.
+  if (ok)
+    {
+    first.A->Register(NULL);
+    reader->SetFileName(stepsName.c_str());
+    reader->Modified();
+    ok = Read(reader.GetPointer(), 1.0, input, second);
+    if (ok && first.A == second.A)
+      {
+      cerr << "Cached arrays were kept when setting the file name" << endl;
+      ok = false;
+      }
+    first.A->UnRegister(NULL);
+    }
+
+  // Without it, each step reads its own.
+  vtkNew<vtkXdmf3Reader> uncached;
+  uncached->SetFileName(stepsName.c_str());
+  uncached->SetHeavyDataCacheSize(0);
+  ok = ok && Read(uncached.GetPointer(), 0.0, input, first);
+  if (ok)
+    {
+    first.Connectivity->Register(NULL);
+    ok = Read(uncached.GetPointer(), 1.0, input, second);
+    if (ok && (!second.B || first.Connectivity == second.Connectivity))
+      {
+      cerr << "Arrays were shared with the cache off" << endl;
+      ok = false;
+      }
+    first.Connectivity->UnRegister(NULL);
+    }
+
+  input->Delete();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,12 +18,16 @@
 
 #include "vtkXdmf3ArrayKeeper.h"
 
+#include "vtkDataArray.h"
+
 #include "XdmfArray.hpp"
 
 //------------------------------------------------------------------------------
 vtkXdmf3ArrayKeeper::vtkXdmf3ArrayKeeper()
 {
   generation = 0;
+  this->CacheSize = 0;
+  this->CacheUsed = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -63,4 +67,66 @@ void vtkXdmf3ArrayKeeper::Release(bool force)
       }
     }
   //cerr << "released " << cnt << "/" << total << " arrays" << endl;
+  if (force)
+    {
+    this->Trim(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkDataArray *vtkXdmf3ArrayKeeper::GetArray(const std::string &key)
+{
+  std::map<std::string, CachedArray>::iterator it = this->Cache.find(key);
+  if (it == this->Cache.end())
+    {
+    return NULL;
+    }
+  this->CacheUse.splice(this->CacheUse.begin(), this->CacheUse, it->second.Use);
+  return it->second.Array;
+}
+
+//------------------------------------------------------------------------------
+void vtkXdmf3ArrayKeeper::CacheArray(const std::string &key,
+                                     vtkDataArray *array)
+{
+  unsigned long size = array->GetActualMemorySize();
+  if (size > this->CacheSize || this->Cache.find(key) != this->Cache.end())
+    {
+    return;
+    }
+  this->Trim(this->CacheSize - size);
+
+  CachedArray &cached = this->Cache[key];
+  cached.Array = array;
+  cached.Size = size;
+  cached.Use = this->CacheUse.insert(this->CacheUse.begin(), key);
+  array->Register(NULL);
+  this->CacheUsed += size;
+}
+
+//------------------------------------------------------------------------------
+void vtkXdmf3ArrayKeeper::ClearCache()
+{
+  this->Trim(0);
+}
+
+//------------------------------------------------------------------------------
+void vtkXdmf3ArrayKeeper::SetCacheSize(unsigned long size)
+{
+  this->CacheSize = size;
+  this->Trim(size);
+}
+
+//------------------------------------------------------------------------------
+void vtkXdmf3ArrayKeeper::Trim(unsigned long size)
+{
+  while (!this->CacheUse.empty() && (size == 0 || this->CacheUsed > size))
+    {
+    std::map<std::string, CachedArray>::iterator it =
+      this->Cache.find(this->CacheUse.back());
+    this->CacheUsed -= it->second.Size;
+    it->second.Array->UnRegister(NULL);
+    this->Cache.erase(it);
+    this->CacheUse.pop_back();
+    }
 }
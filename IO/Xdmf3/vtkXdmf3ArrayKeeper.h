@@ -22,6 +22,12 @@
 // current timestep. A release method frees arrays that have not been recently
 // used.
 //
+// Arrays read from heavy data can also be cached by a key that describes the
+// file, dataset and slab they come from, so that other grids and later
+// timesteps that refer to the same slab share the VTK array instead of
+// reading it again. The cache is bounded, drops the least recently used
+// arrays first and is off by default.
+//
 // This file is a helper for the vtkXdmf3Reader and not intended to be
 // part of VTK public API
 // VTK-HeaderTest-Exclude: vtkXdmf3ArrayKeeper.h
@@ -30,9 +36,12 @@
 #define __vtkXdmf3ArrayKeeper_h
 
 #include "vtkIOXdmf3Module.h" // For export macro
+#include <list>
 #include <map>
+#include <string>
 
 class XdmfArray;
+class vtkDataArray;
 
 class VTKIOXDMF3_EXPORT vtkXdmf3ArrayKeeper
   : public std::map<XdmfArray *, unsigned int>
@@ -59,8 +68,43 @@ public:
   //Force argument frees all arrays.
   void Release(bool force);
 
+  //Description:
+  //Returns the array cached for the heavy data slab described by key,
+  //or NULL if there is none. The caller does not own the array.
+  vtkDataArray *GetArray(const std::string &key);
+
+  //Description:
+  //Caches an array read from the heavy data slab described by key.
+  //Arrays that do not fit in the cache are not kept.
+  void CacheArray(const std::string &key, vtkDataArray *array);
+
+  //Description:
+  //Drops all cached arrays, for when the files they were read from change.
+  void ClearCache();
+
+  //Description:
+  //Set the most memory in kibibytes (1024 bytes) that cached arrays may
+  //use. 0, the default, disables the cache.
+  void SetCacheSize(unsigned long size);
+  unsigned long GetCacheSize() { return this->CacheSize; }
+
 private:
+  //Drops the least recently used arrays until the cache fits in size.
+  //A size of 0 empties the cache.
+  void Trim(unsigned long size);
+
+  struct CachedArray
+  {
+    vtkDataArray *Array;
+    unsigned long Size;
+    std::list<std::string>::iterator Use;
+  };
+
   unsigned int generation;
+  std::map<std::string, CachedArray> Cache;
+  std::list<std::string> CacheUse; //most recently used first
+  unsigned long CacheSize;
+  unsigned long CacheUsed;
 };
 
 #endif //__vtkXdmf3ArrayKeeper_h
@@ -27,6 +27,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkImageData.h"
 #include "vtkExtractSelection.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMergePoints.h"
 #include "vtkMutableDirectedGraph.h"
 #include "vtkOutEdgeIterator.h"
@@ -38,6 +39,7 @@
 #include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
 #include "vtkType.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkVertexListIterator.h"
@@ -51,6 +53,8 @@
 #include "XdmfGeometry.hpp"
 #include "XdmfGeometryType.hpp"
 #include "XdmfGraph.hpp"
+#include "XdmfHDF5Controller.hpp"
+#include "XdmfHeavyDataController.hpp"
 #include "XdmfRectilinearGrid.hpp"
 #include "XdmfRegularGrid.hpp"
 #include "XdmfSet.hpp"
@@ -60,6 +64,10 @@
 #include "XdmfTopology.hpp"
 #include "XdmfTopologyType.hpp"
 
+#include "vtksys/SystemTools.hxx"
+
+#include <sstream>
+
 //==============================================================================
 bool vtkXdmf3DataSet_ReadIfNeeded(XdmfArray *array, bool dbg=false)
 {
@@ -88,6 +96,53 @@ void vtkXdmf3DataSet_ReleaseIfNeeded(XdmfArray *array, bool MyInit,
     }
 }
 
+void vtkXdmf3DataSet_AppendDimensions(std::ostringstream &key,
+                                      const std::vector<unsigned int> &dims)
+{
+  key << "(";
+  for (unsigned int i = 0; i < dims.size(); i++)
+    {
+    key << dims[i] << " ";
+    }
+  key << ")";
+}
+
+//Describes the file, dataset and slab that the heavy data of an array comes
+//from, so that arrays referring to the same slab can share what was read.
+//The modification time and length of the file are part of it, so that
+//nothing read before the file was rewritten is reused.
+//Returns an empty string for arrays that do not come from heavy data.
+std::string vtkXdmf3DataSet_SlabKey(XdmfArray *array)
+{
+  unsigned int nControllers = array->getNumberHeavyDataControllers();
+  if (array->isInitialized() || array->getReference() || nControllers == 0)
+    {
+    return std::string();
+    }
+  std::ostringstream key;
+  for (unsigned int i = 0; i < nControllers; i++)
+    {
+    shared_ptr<XdmfHeavyDataController> controller =
+      array->getHeavyDataController(i);
+    std::string filePath = controller->getFilePath();
+    key << controller->getName() << ":" << filePath << "@"
+        << vtksys::SystemTools::ModifiedTime(filePath) << ","
+        << vtksys::SystemTools::FileLength(filePath.c_str())
+        << controller->getDescriptor();
+    vtkXdmf3DataSet_AppendDimensions(key, controller->getDimensions());
+    shared_ptr<XdmfHDF5Controller> hdf5 =
+      shared_dynamic_cast<XdmfHDF5Controller>(controller);
+    if (hdf5)
+      {
+      vtkXdmf3DataSet_AppendDimensions(key, hdf5->getStart());
+      vtkXdmf3DataSet_AppendDimensions(key, hdf5->getStride());
+      vtkXdmf3DataSet_AppendDimensions(key, hdf5->getDataspaceDimensions());
+      }
+    key << ";";
+    }
+  return key.str();
+}
+
 //==============================================================================
 vtkDataArray *vtkXdmf3DataSet::XdmfToVTKArray(
   XdmfArray* xArray,
@@ -170,12 +225,33 @@ vtkDataArray *vtkXdmf3DataSet::XdmfToVTKArray(
       }
     unsigned int ntuples = xArray->getSize() / ncomp;
 
+    //arrays read from heavy data are shared with every grid and timestep
+    //that refers to the same slab for as long as the keeper caches them
+    std::string key;
+    if (keeper && keeper->GetCacheSize() > 0)
+      {
+      key = vtkXdmf3DataSet_SlabKey(xArray);
+      }
+    if (!key.empty())
+      {
+      std::ostringstream fullKey;
+      fullKey << key << vtk_type << "," << ncomp << "," << attrName;
+      key = fullKey.str();
+      vtkDataArray *cached = keeper->GetArray(key);
+      if (cached)
+        {
+        vArray->Delete();
+        cached->Register(NULL);
+        return cached;
+        }
+      }
+
     vArray->SetNumberOfComponents(static_cast<int>(ncomp));
-    vArray->SetNumberOfTuples(ntuples);
     bool freeMe = vtkXdmf3DataSet_ReadIfNeeded(xArray);
 #define DO_DEEPREAD 0
 #if DO_DEEPREAD
     //deepcopy
+    vArray->SetNumberOfTuples(ntuples);
     switch(vArray->GetDataType())
       {
       vtkTemplateMacro(
@@ -187,6 +263,22 @@ vtkDataArray *vtkXdmf3DataSet::XdmfToVTKArray(
         cerr << "UNKNOWN" << endl;
       }
 #else
+    if (!key.empty())
+      {
+      //the cache may outlive the xdmf array, so the vtk array gets its own
+      //copy and the xdmf array is released right away
+      vArray->SetNumberOfTuples(ntuples);
+      memcpy(vArray->GetVoidPointer(0), xArray->getValuesInternal(),
+             static_cast<size_t>(ntuples) * ncomp *
+             vArray->GetDataTypeSize());
+      if (freeMe)
+        {
+        xArray->release();
+        }
+      keeper->CacheArray(key, vArray);
+      return vArray;
+      }
+
     //shallowcopy
     vArray->SetVoidArray(xArray->getValuesInternal(), ntuples*ncomp, 1);
     if (keeper && freeMe)
@@ -1137,31 +1229,11 @@ void vtkXdmf3DataSet::CopyShape(
     }
 
   int whole_extent[6];
-  whole_extent[0] = 0;
-  whole_extent[1] = -1;
-  whole_extent[2] = 0;
-  whole_extent[3] = -1;
-  whole_extent[4] = 0;
-  whole_extent[5] = -1;
+  vtkXdmf3DataSet::GetWholeExtent(grid, whole_extent);
+  dataSet->SetExtent(whole_extent);
 
   shared_ptr<XdmfArray> xdims;
   xdims = grid->getDimensions();
-  //Note: XDMF standard for RECTMESH is inconsistent with SMESH and CORECTMESH
-  //it is ijk in VTK terms and they are kji.
-  if (xdims)
-    {
-    bool freeMe = vtkXdmf3DataSet_ReadIfNeeded(xdims.get());
-    for (unsigned int i = 0; (i < 3 && i < xdims->getSize()); i++)
-      {
-      whole_extent[i*2+1] = xdims->getValue<int>(i)-1;
-      }
-  if (xdims->getSize() == 2)
-    {
-    whole_extent[5] = whole_extent[4];
-    }
-    vtkXdmf3DataSet_ReleaseIfNeeded(xdims.get(), freeMe);
-    }
-  dataSet->SetExtent(whole_extent);
 
   vtkDataArray *vCoords = NULL;
   shared_ptr<XdmfArray> xCoords;
@@ -1197,6 +1269,37 @@ void vtkXdmf3DataSet::CopyShape(
     }
 }
 
+//--------------------------------------------------------------------------
+void vtkXdmf3DataSet::GetWholeExtent(
+  XdmfRectilinearGrid *grid,
+  int whole_extent[6])
+{
+  whole_extent[0] = 0;
+  whole_extent[1] = -1;
+  whole_extent[2] = 0;
+  whole_extent[3] = -1;
+  whole_extent[4] = 0;
+  whole_extent[5] = -1;
+
+  shared_ptr<XdmfArray> xdims;
+  xdims = grid->getDimensions();
+  //Note: XDMF standard for RECTMESH is inconsistent with SMESH and CORECTMESH
+  //it is ijk in VTK terms and they are kji.
+  if (xdims)
+    {
+    bool freeMe = vtkXdmf3DataSet_ReadIfNeeded(xdims.get());
+    for (unsigned int i = 0; (i < 3 && i < xdims->getSize()); i++)
+      {
+      whole_extent[i*2+1] = xdims->getValue<int>(i)-1;
+      }
+  if (xdims->getSize() == 2)
+    {
+    whole_extent[5] = whole_extent[4];
+    }
+    vtkXdmf3DataSet_ReleaseIfNeeded(xdims.get(), freeMe);
+    }
+}
+
 //--------------------------------------------------------------------------
 void vtkXdmf3DataSet::VTKToXdmf(
   vtkRectilinearGrid *dataSet,
@@ -1263,25 +1366,7 @@ void vtkXdmf3DataSet::CopyShape(
     }
 
   int whole_extent[6];
-  whole_extent[0] = 0;
-  whole_extent[1] = -1;
-  whole_extent[2] = 0;
-  whole_extent[3] = -1;
-  whole_extent[4] = 0;
-  whole_extent[5] = -1;
-  shared_ptr<XdmfArray> xdims;
-  xdims = grid->getDimensions();
-  if (xdims)
-    {
-    for (unsigned int i = 0; (i < 3 && i < xdims->getSize()); i++)
-      {
-      whole_extent[(2-i)*2+1] = xdims->getValue<int>(i)-1;
-      }
-    }
-  if (xdims->getSize() == 2)
-    {
-    whole_extent[1] = whole_extent[0];
-    }
+  vtkXdmf3DataSet::GetWholeExtent(grid, whole_extent);
   dataSet->SetExtent(whole_extent);
 
   vtkDataArray *vPoints = NULL;
@@ -1318,6 +1403,32 @@ void vtkXdmf3DataSet::CopyShape(
     }
 }
 
+//--------------------------------------------------------------------------
+void vtkXdmf3DataSet::GetWholeExtent(
+  XdmfCurvilinearGrid *grid,
+  int whole_extent[6])
+{
+  whole_extent[0] = 0;
+  whole_extent[1] = -1;
+  whole_extent[2] = 0;
+  whole_extent[3] = -1;
+  whole_extent[4] = 0;
+  whole_extent[5] = -1;
+  shared_ptr<XdmfArray> xdims;
+  xdims = grid->getDimensions();
+  if (xdims)
+    {
+    for (unsigned int i = 0; (i < 3 && i < xdims->getSize()); i++)
+      {
+      whole_extent[(2-i)*2+1] = xdims->getValue<int>(i)-1;
+      }
+    }
+  if (xdims->getSize() == 2)
+    {
+    whole_extent[1] = whole_extent[0];
+    }
+}
+
 //--------------------------------------------------------------------------
 void vtkXdmf3DataSet::VTKToXdmf(
   vtkStructuredGrid *dataSet,
@@ -1395,9 +1506,37 @@ void vtkXdmf3DataSet::CopyShape(
     return;
     }
 
-  bool freeMe = vtkXdmf3DataSet_ReadIfNeeded(xTopology.get());
+  //grids that share a topology, like the steps of a temporal collection,
+  //share the cells converted from it
+  std::string key;
+  if (keeper && keeper->GetCacheSize() > 0)
+    {
+    key = vtkXdmf3DataSet_SlabKey(xTopology.get());
+    }
+  bool cachedCells = false;
+  if (!key.empty())
+    {
+    key += xCellType->getName();
+    vtkIdTypeArray *connectivity = vtkIdTypeArray::SafeDownCast(
+      keeper->GetArray(key + "cells"));
+    vtkUnsignedCharArray *types = vtkUnsignedCharArray::SafeDownCast(
+      keeper->GetArray(key + "types"));
+    vtkIdTypeArray *locations = vtkIdTypeArray::SafeDownCast(
+      keeper->GetArray(key + "locations"));
+    if (connectivity && types && locations)
+      {
+      vtkCellArray* vCells = vtkCellArray::New();
+      vCells->SetCells(types->GetNumberOfTuples(), connectivity);
+      dataSet->SetCells(types, locations, vCells, NULL, NULL);
+      vCells->Delete();
+      cachedCells = true;
+      }
+    }
+
+  bool freeMe =
+    !cachedCells && vtkXdmf3DataSet_ReadIfNeeded(xTopology.get());
 
-  if (xCellType != XdmfTopologyType::Mixed())
+  if (!cachedCells && xCellType != XdmfTopologyType::Mixed())
     {
     // all cells are of the same type.
     unsigned int numPointsPerCell= xCellType->getNodesPerElement();
@@ -1429,7 +1568,7 @@ void vtkXdmf3DataSet::CopyShape(
     vtkXdmf3DataSet_ReleaseIfNeeded(xTopology.get(), freeMe);
     delete [] cell_types;
     }
-  else
+  else if (!cachedCells)
     {
     // mixed cell types
     unsigned int conn_length = xTopology->getSize();
@@ -1490,6 +1629,18 @@ void vtkXdmf3DataSet::CopyShape(
     vtkXdmf3DataSet_ReleaseIfNeeded(xTopology.get(), freeMe);
     }
 
+  if (freeMe)
+    {
+    //the cells are a converted copy, so the topology is not needed any more
+    xTopology->release();
+    }
+  if (!key.empty() && !cachedCells && !dataSet->GetFaces())
+    {
+    keeper->CacheArray(key + "cells", dataSet->GetCells()->GetData());
+    keeper->CacheArray(key + "types", dataSet->GetCellTypesArray());
+    keeper->CacheArray(key + "locations", dataSet->GetCellLocationsArray());
+    }
+
   //copy geometry
   vtkDataArray *vPoints = NULL;
   shared_ptr<XdmfGeometry> geom = grid->getGeometry();
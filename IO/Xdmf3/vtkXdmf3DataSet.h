@@ -146,6 +146,10 @@ public:
     vtkRectilinearGrid *dataSet,
     vtkXdmf3ArrayKeeper *keeper=NULL);
 
+  // Description:
+  // Helper that finds the extent of the grid without reading its heavy data
+  static void GetWholeExtent(XdmfRectilinearGrid *grid, int whole_extent[6]);
+
   // Description:
   // Populates the Xdmf Grid with the contents of the VTK data set
   static void VTKToXdmf(
@@ -171,6 +175,10 @@ public:
     vtkStructuredGrid *dataSet,
     vtkXdmf3ArrayKeeper *keeper=NULL);
 
+  // Description:
+  // Helper that finds the extent of the grid without reading its heavy data
+  static void GetWholeExtent(XdmfCurvilinearGrid *grid, int whole_extent[6]);
+
   // Description:
   // Populates the Xdmf Grid with the contents of the VTK data set
   static void VTKToXdmf(
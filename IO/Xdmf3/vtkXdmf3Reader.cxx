@@ -29,9 +29,7 @@
 #include "vtkMultiProcessController.h"
 #include "vtkMutableDirectedGraph.h"
 #include "vtkObjectFactory.h"
-#include "vtkRectilinearGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkStructuredGrid.h"
 #include "vtkTimerLog.h"
 #include "vtkXdmf3ArrayKeeper.h"
 #include "vtkXdmf3ArraySelection.h"
@@ -418,6 +416,7 @@ vtkXdmf3Reader::vtkXdmf3Reader()
 
   this->Internal = new vtkXdmf3Reader::Internals();
   this->FileSeriesAsTime = true;
+  this->HeavyDataCacheSize = 0;
 
   this->FieldArraysCache = this->Internal->FieldArrays;
   this->CellArraysCache = this->Internal->CellArrays;
@@ -443,11 +442,13 @@ void vtkXdmf3Reader::PrintSelf(ostream& os, vtkIndent indent)
     (this->FileName ? this->FileName : "(none)") << endl;
   os << indent << "FileSeriesAsTime: " <<
     (this->FileSeriesAsTime ? "True" : "False") << endl;
+  os << indent << "HeavyDataCacheSize: " << this->HeavyDataCacheSize << endl;
 }
 
 //----------------------------------------------------------------------------
 void vtkXdmf3Reader::AddFileName(const char* filename)
 {
+  this->Internal->Keeper->ClearCache();
   this->Internal->FileNames.push_back(filename);
   if (this->Internal->FileNames.size()==1)
     {
@@ -469,6 +470,7 @@ void vtkXdmf3Reader::SetFileName(const char* filename)
 //----------------------------------------------------------------------------
 void vtkXdmf3Reader::RemoveAllFileNames()
 {
+  this->Internal->Keeper->ClearCache();
   this->Internal->FileNames.clear();
 }
 
@@ -622,19 +624,13 @@ int vtkXdmf3Reader::RequestInformation(vtkInformation *,
       shared_dynamic_cast<XdmfRectilinearGrid>(this->Internal->TopGrid);
     if (recGrid)
       {
-      vtkRectilinearGrid *dataSet = vtkRectilinearGrid::New();
-      vtkXdmf3DataSet::CopyShape(recGrid.get(), dataSet, this->Internal->Keeper);
-      dataSet->GetExtent(whole_extent);
-      dataSet->Delete();
+      vtkXdmf3DataSet::GetWholeExtent(recGrid.get(), whole_extent);
       }
     shared_ptr<XdmfCurvilinearGrid> crvGrid =
       shared_dynamic_cast<XdmfCurvilinearGrid>(this->Internal->TopGrid);
     if (crvGrid)
       {
-      vtkStructuredGrid *dataSet = vtkStructuredGrid::New();
-      vtkXdmf3DataSet::CopyShape(crvGrid.get(), dataSet, this->Internal->Keeper);
-      dataSet->GetExtent(whole_extent);
-      dataSet->Delete();
+      vtkXdmf3DataSet::GetWholeExtent(crvGrid.get(), whole_extent);
       }
 
     outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
@@ -662,6 +658,7 @@ int vtkXdmf3Reader::RequestData(vtkInformation *,
     }
 
   vtkTimerLog::MarkStartEvent("X3R::Release");
+  this->Internal->Keeper->SetCacheSize(this->HeavyDataCacheSize);
   this->Internal->ReleaseArrays();
   this->Internal->BumpKeeper();
   vtkTimerLog::MarkEndEvent("X3R::Release");
@@ -59,6 +59,21 @@ public:
   vtkSetMacro(FileSeriesAsTime, bool);
   vtkGetMacro(FileSeriesAsTime, bool);
 
+  // Description:
+  // The most memory, in kibibytes (1024 bytes), used to keep arrays read
+  // from heavy data between updates. Grids and timesteps that refer to the
+  // same slab of a heavy data file, such as a topology shared by all steps
+  // of a temporal collection, share the cached arrays instead of reading
+  // them again. The least recently used arrays are dropped first.
+  // Uncached arrays point straight at the memory XDMF read them into, while
+  // cached ones are copies that stay alive after XDMF releases its own, so
+  // the cache trades up to this much memory for not reading shared slabs
+  // again. Cached arrays are dropped when the file names change and are not
+  // reused once the heavy data file is rewritten. 0, the default, turns the
+  // cache off.
+  vtkSetMacro(HeavyDataCacheSize, unsigned long);
+  vtkGetMacro(HeavyDataCacheSize, unsigned long);
+
   // Description:
   // Determine if the file can be read with this reader.
   virtual int CanReadFile(const char* filename);
@@ -173,6 +188,7 @@ private:
   void operator=(const vtkXdmf3Reader&); // Not implemented
 
   bool FileSeriesAsTime;
+  unsigned long HeavyDataCacheSize;
 
   class Internals;
   Internals *Internal;
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageEuclideanDistance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the algorithms in vtkImageEuclideanDistance
+// .SECTION Description
+// Compares the squared distances computed by each algorithm with those
+// computed by brute force, for anisotropic spacing, for a maximum distance,
+// and for 2D distances within a volume.
+
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+void BruteForce(vtkImageData *image, int dim, double maxDist,
+                std::vector<double> &result)
+{
+  int ext[6];
+  image->GetExtent(ext);
+  double spacing[3];
+  image->GetSpacing(spacing);
+  int nx = ext[1] - ext[0] + 1;
+  int ny = ext[3] - ext[2] + 1;
+  int nz = ext[5] - ext[4] + 1;
+  unsigned char *ptr = static_cast<unsigned char *>(image->GetScalarPointer());
+
+  result.assign(nx*ny*nz, maxDist);
+  for (int z = 0; z < nz; z++)
+    {
+    for (int y = 0; y < ny; y++)
+      {
+      for (int x = 0; x < nx; x++)
+        {
+        double &d = result[x + nx*(y + ny*z)];
+        for (int k = 0; k < nz; k++)
+          {
+          if (dim < 3 && k != z)
+            {
+            continue;
+            }
+          for (int j = 0; j < ny; j++)
+            {
+            for (int i = 0; i < nx; i++)
+              {
+              if (ptr[i + nx*(j + ny*k)] == 0)
+                {
+                double dx = (i - x)*spacing[0];
+                double dy = (j - y)*spacing[1];
+                double dz = (k - z)*spacing[2];
+                double r = dx*dx + dy*dy + dz*dz;
+                d = (r < d ? r : d);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+}
+
+bool Compare(vtkImageData *image, int algorithm, int dim, double maxDist,
+             const std::vector<double> &expected)
+{
+  vtkNew<vtkImageEuclideanDistance> dist;
+  dist->SetInputData(image);
+  dist->SetAlgorithm(algorithm);
+  dist->SetDimensionality(dim);
+  dist->SetMaximumDistance(maxDist);
+  dist->Update();
+
+  double *ptr = static_cast<double *>(
+    dist->GetOutput()->GetScalarPointer());
+  for (size_t i = 0; i < expected.size(); i++)
+    {
+    if (fabs(ptr[i] - expected[i]) > 1e-9*(1.0 + expected[i]))
+      {
+      cerr << "Algorithm " << algorithm << " in " << dim << "D gave "
+           << ptr[i] << " instead of " << expected[i] << " at " << i
+           << " with maximum distance " << maxDist << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+int TestImageEuclideanDistance(int, char *[])
+{
+  vtkMath::RandomSeed(5678);
+
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 22, 0, 16, 0, 11);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char *ptr = static_cast<unsigned char *>(image->GetScalarPointer());
+  vtkIdType n = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    ptr[i] = (vtkMath::Random() < 0.01 ? 0 : 1);
+    }
+  // make sure that some slices have no features
+  for (vtkIdType i = 0; i < 23*17*3; i++)
+    {
+    ptr[i] = 1;
+    }
+
+  static const int algorithms[3] = {
+    VTK_EDT_SAITO, VTK_EDT_SAITO_CACHED, VTK_EDT_FELZENSZWALB };
+  static const double maxDists[2] = { VTK_INT_MAX, 20.0 };
+
+  std::vector<double> expected;
+  for (int anisotropic = 0; anisotropic < 2; anisotropic++)
+    {
+    if (anisotropic)
+      {
+      image->SetSpacing(0.7, 1.0, 1.9);
+      }
+    for (int dim = 2; dim <= 3; dim++)
+      {
+      for (int m = 0; m < 2; m++)
+        {
+        BruteForce(image.GetPointer(), dim, maxDists[m], expected);
+        for (int a = 0; a < 3; a++)
+          {
+          // the Saito algorithms are only exact for isotropic spacing
+          // and they do not fully clamp to the maximum distance
+          if ((anisotropic || maxDists[m] != VTK_INT_MAX) &&
+              algorithms[a] != VTK_EDT_FELZENSZWALB)
+            {
+            continue;
+            }
+          if (!Compare(image.GetPointer(), algorithms[a], dim, maxDists[m],
+                       expected))
+            {
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkImageFFT and vtkImageRFFT
+// .SECTION Description
+// Compares the FFT with a direct computation of the DFT for sizes that use
+// each kind of butterfly and for prime sizes that use Bluestein's
+// algorithm, for complex input and for real input, and checks that
+// the RFFT gives back the input.
+
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Compute the DFT of each row of the image directly.
+void DirectDFT(vtkImageData *image, std::vector<double> &result)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  int n = dims[0];
+  int nc = image->GetNumberOfScalarComponents();
+  double *ptr = static_cast<double *>(image->GetScalarPointer());
+
+  result.assign(2*n*dims[1], 0.0);
+  for (int row = 0; row < dims[1]; row++)
+    {
+    const double *x = ptr + row*n*nc;
+    double *X = &result[2*row*n];
+    for (int k = 0; k < n; k++)
+      {
+      long double re = 0.0;
+      long double im = 0.0;
+      for (int j = 0; j < n; j++)
+        {
+        long double phase = -2.0L*vtkMath::Pi()*((static_cast<long>(j)*k) % n)/n;
+        long double c = cosl(phase);
+        long double s = sinl(phase);
+        long double a = x[j*nc];
+        long double b = (nc > 1 ? x[j*nc + 1] : 0.0);
+        re += a*c - b*s;
+        im += a*s + b*c;
+        }
+      X[2*k] = static_cast<double>(re);
+      X[2*k + 1] = static_cast<double>(im);
+      }
+    }
+}
+
+bool Compare(const double *a, const double *b, vtkIdType n, double scale,
+             const char *what, int size)
+{
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    if (fabs(a[i] - b[i]) > 1e-9*scale)
+      {
+      cerr << what << " of size " << size << " gave " << a[i]
+           << " instead of " << b[i] << " at " << i << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool TestSize(int n, int rows, int nc)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(n, rows, 1);
+  image->AllocateScalars(VTK_DOUBLE, nc);
+  double *ptr = static_cast<double *>(image->GetScalarPointer());
+  for (int i = 0; i < n*rows*nc; i++)
+    {
+    ptr[i] = vtkMath::Random(-1.0, 1.0);
+    }
+
+  std::vector<double> expected;
+  DirectDFT(image.GetPointer(), expected);
+
+  vtkNew<vtkImageFFT> fft;
+  fft->SetDimensionality(1);
+  fft->SetInputData(image.GetPointer());
+  fft->Update();
+  double *output = static_cast<double *>(
+    fft->GetOutput()->GetScalarPointer());
+  if (!Compare(output, &expected[0], 2*n*rows, n,
+               (nc == 1 ? "FFT of real data" : "FFT"), n))
+    {
+    return false;
+    }
+
+  vtkNew<vtkImageRFFT> rfft;
+  rfft->SetDimensionality(1);
+  rfft->SetInputConnection(fft->GetOutputPort());
+  rfft->Update();
+  double *inverse = static_cast<double *>(
+    rfft->GetOutput()->GetScalarPointer());
+  for (int i = 0; i < n*rows; i++)
+    {
+    double imag = (nc > 1 ? ptr[i*nc + 1] : 0.0);
+    if (fabs(inverse[2*i] - ptr[i*nc]) > 1e-9 ||
+        fabs(inverse[2*i + 1] - imag) > 1e-9)
+      {
+      cerr << "RFFT of size " << n << " gave (" << inverse[2*i] << ","
+           << inverse[2*i + 1] << ") instead of (" << ptr[i*nc] << ","
+           << imag << ") at " << i << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+}
+
+int TestImageFFT(int, char *[])
+{
+  vtkMath::RandomSeed(4321);
+
+  // all sizes up to 40 cover every butterfly and the smaller primes
+  for (int n = 1; n <= 40; n++)
+    {
+    if (!TestSize(n, 1, 2))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // larger sizes, including primes and products of large primes
+  static const int sizes[7] = { 64, 97, 210, 289, 1000, 1021, 1024 };
+  for (int i = 0; i < 7; i++)
+    {
+    if (!TestSize(sizes[i], 2, 2))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // real input, where rows are transformed in pairs, with an odd number
+  // of rows so that one row is left over
+  static const int realSizes[4] = { 1, 8, 37, 120 };
+  for (int i = 0; i < 4; i++)
+    {
+    if (!TestSize(realSizes[i], 5, 1))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
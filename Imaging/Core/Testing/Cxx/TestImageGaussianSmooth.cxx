@@ -0,0 +1,250 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageGaussianSmooth.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkImageGaussianSmooth
+// .SECTION Description
+// Compares the explicit kernel with a direct convolution, including the
+// normalization at the edges of the image, and checks that the recursive
+// filter is close to the true gaussian and to the explicit kernel.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+
+#include <math.h>
+#include <vector>
+
+namespace {
+
+// The kernel weight for offset i from a sample at index x, where the
+// kernel is clipped at [lo, hi] and normalized
+double KernelWeight(int x, int i, int radius, int lo, int hi, double std)
+{
+  if (i < -radius || i > radius || x + i < lo || x + i > hi)
+    {
+    return 0.0;
+    }
+  if (std == 0.0)
+    {
+    return 1.0;
+    }
+  double sum = 0.0;
+  for (int j = -radius; j <= radius; j++)
+    {
+    if (x + j >= lo && x + j <= hi)
+      {
+      sum += exp(-(j*j)/(2.0*std*std));
+      }
+    }
+  return exp(-(i*i)/(2.0*std*std))/sum;
+}
+
+bool CheckExplicit()
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-2, 40, 1, 22, 0, 9);
+  image->AllocateScalars(VTK_DOUBLE, 3);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < 3; c++)
+      {
+      scalars->SetComponent(i, c, vtkMath::Random(-100.0, 100.0));
+      }
+    }
+
+  double stds[3] = { 2.0, 1.3, 0.9 };
+  double factors[3] = { 2.0, 3.0, 1.5 };
+  vtkNew<vtkImageGaussianSmooth> smooth;
+  smooth->SetInputData(image.GetPointer());
+  smooth->SetStandardDeviations(stds);
+  smooth->SetRadiusFactors(factors);
+  smooth->Update();
+  vtkDataArray *result = smooth->GetOutput()->GetPointData()->GetScalars();
+
+  int ext[6], dims[3], radius[3];
+  image->GetExtent(ext);
+  image->GetDimensions(dims);
+  for (int j = 0; j < 3; j++)
+    {
+    radius[j] = static_cast<int>(stds[j]*factors[j]);
+    }
+
+  vtkIdType v = 0;
+  for (int z = ext[4]; z <= ext[5]; z++)
+    {
+    for (int y = ext[2]; y <= ext[3]; y++)
+      {
+      for (int x = ext[0]; x <= ext[1]; x++)
+        {
+        for (int c = 0; c < 3; c++)
+          {
+          double sum = 0.0;
+          for (int k = -radius[2]; k <= radius[2]; k++)
+            {
+            double wz = KernelWeight(z, k, radius[2], ext[4], ext[5], stds[2]);
+            for (int j = -radius[1]; j <= radius[1]; j++)
+              {
+              double wy = KernelWeight(y, j, radius[1], ext[2], ext[3],
+                                       stds[1]);
+              for (int i = -radius[0]; i <= radius[0]; i++)
+                {
+                double w = wz*wy*KernelWeight(x, i, radius[0], ext[0], ext[1],
+                                              stds[0]);
+                if (w != 0.0)
+                  {
+                  vtkIdType u = v + i + dims[0]*(j + dims[1]*k);
+                  sum += w*scalars->GetComponent(u, c);
+                  }
+                }
+              }
+            }
+          if (fabs(sum - result->GetComponent(v, c)) > 1e-10)
+            {
+            cerr << "Explicit kernel gave " << result->GetComponent(v, c)
+                 << " instead of " << sum << " at (" << x << "," << y << ","
+                 << z << ")" << endl;
+            return false;
+            }
+          }
+        v++;
+        }
+      }
+    }
+
+  return true;
+}
+
+bool CheckRecursive()
+{
+  // the impulse response should be close to the gaussian
+  static const double stds[3] = { 1.0, 3.0, 12.0 };
+  for (int s = 0; s < 3; s++)
+    {
+    vtkNew<vtkImageData> image;
+    image->SetExtent(-200, 200, 0, 0, 0, 0);
+    image->AllocateScalars(VTK_DOUBLE, 1);
+    double *ptr = static_cast<double *>(image->GetScalarPointer());
+    for (int i = 0; i < 401; i++)
+      {
+      ptr[i] = (i == 200 ? 1.0 : 0.0);
+      }
+
+    vtkNew<vtkImageGaussianSmooth> smooth;
+    smooth->SetInputData(image.GetPointer());
+    smooth->SetDimensionality(1);
+    smooth->SetStandardDeviation(stds[s]);
+    smooth->RecursiveOn();
+    smooth->Update();
+    double *result =
+      static_cast<double *>(smooth->GetOutput()->GetScalarPointer());
+
+    double peak = 1.0/(sqrt(2.0*vtkMath::Pi())*stds[s]);
+    for (int i = -200; i <= 200; i++)
+      {
+      double expected = peak*exp(-(i*i)/(2.0*stds[s]*stds[s]));
+      if (fabs(result[i + 200] - expected) > 0.04*peak)
+        {
+        cerr << "Recursive impulse response with std " << stds[s]
+             << " gave " << result[i + 200] << " instead of " << expected
+             << " at " << i << endl;
+        return false;
+        }
+      }
+    }
+
+  // a 3D image, compared with an explicit kernel with a large radius
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 47, -5, 30, 3, 33);
+  image->AllocateScalars(VTK_FLOAT, 2);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < 2; c++)
+      {
+      scalars->SetComponent(i, c, vtkMath::Random(0.0, 100.0));
+      }
+    }
+
+  vtkNew<vtkImageGaussianSmooth> explicitSmooth;
+  explicitSmooth->SetInputData(image.GetPointer());
+  explicitSmooth->SetStandardDeviations(4.0, 2.5, 6.0);
+  explicitSmooth->SetRadiusFactor(5.0);
+  explicitSmooth->Update();
+  vtkDataArray *expected =
+    explicitSmooth->GetOutput()->GetPointData()->GetScalars();
+
+  vtkNew<vtkImageGaussianSmooth> recursiveSmooth;
+  recursiveSmooth->SetInputData(image.GetPointer());
+  recursiveSmooth->SetStandardDeviations(4.0, 2.5, 6.0);
+  recursiveSmooth->SetRadiusFactor(5.0);
+  recursiveSmooth->RecursiveOn();
+  recursiveSmooth->Update();
+  vtkDataArray *result =
+    recursiveSmooth->GetOutput()->GetPointData()->GetScalars();
+
+  for (vtkIdType i = 0; i < result->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < 2; c++)
+      {
+      double a = result->GetComponent(i, c);
+      double b = expected->GetComponent(i, c);
+      if (fabs(a - b) > 0.5)
+        {
+        cerr << "Recursive filter gave " << a << " instead of " << b
+             << " at point " << i << endl;
+        return false;
+        }
+      }
+    }
+
+  // a constant image should stay constant, even at the edges
+  image->AllocateScalars(VTK_FLOAT, 1);
+  float *ptr = static_cast<float *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    ptr[i] = 10.0f;
+    }
+  recursiveSmooth->Modified();
+  recursiveSmooth->Update();
+  ptr = static_cast<float *>(recursiveSmooth->GetOutput()->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    if (fabs(ptr[i] - 10.0f) > 1e-4)
+      {
+      cerr << "Recursive filter gave " << ptr[i] << " for a constant image"
+           << " at point " << i << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+}
+
+int TestImageGaussianSmooth(int, char *[])
+{
+  vtkMath::RandomSeed(8642);
+
+  if (!CheckExplicit() || !CheckRecursive())
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
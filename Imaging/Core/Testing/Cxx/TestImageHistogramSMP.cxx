@@ -0,0 +1,332 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageHistogramSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the parallel histogram filters
+// .SECTION Description
+// Compares the histograms from vtkImageHistogram and vtkImageAccumulate,
+// with and without a stencil, and with vtkMultiThreader and vtkSMPTools,
+// with histograms that are counted directly.  Also checks the percentiles
+// from vtkImageHistogramStatistics against the sorted values.
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageAccumulate.h"
+#include "vtkImageData.h"
+#include "vtkImageHistogram.h"
+#include "vtkImageHistogramStatistics.h"
+#include "vtkImageStencilData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// A stencil that is a ball in the middle of the extent
+void MakeStencil(vtkImageStencilData *stencil, const int extent[6])
+{
+  stencil->SetExtent(const_cast<int *>(extent));
+  stencil->AllocateExtents();
+  double center[3], radius[3];
+  for (int i = 0; i < 3; i++)
+    {
+    center[i] = 0.5*(extent[2*i] + extent[2*i+1]);
+    radius[i] = 0.4*(extent[2*i+1] - extent[2*i] + 1);
+    }
+  for (int z = extent[4]; z <= extent[5]; z++)
+    {
+    for (int y = extent[2]; y <= extent[3]; y++)
+      {
+      double dy = (y - center[1])/radius[1];
+      double dz = (z - center[2])/radius[2];
+      double r = 1.0 - dy*dy - dz*dz;
+      if (r > 0)
+        {
+        int dx = static_cast<int>(sqrt(r)*radius[0]);
+        int xc = static_cast<int>(center[0]);
+        stencil->InsertNextExtent(xc - dx, xc + dx, y, z);
+        }
+      }
+    }
+}
+
+bool InStencil(vtkImageStencilData *stencil, int x, int y, int z)
+{
+  if (!stencil)
+    {
+    return true;
+    }
+  int iter = 0;
+  int r1, r2;
+  int ext[6];
+  stencil->GetExtent(ext);
+  while (stencil->GetNextExtent(r1, r2, ext[0], ext[1], y, z, iter))
+    {
+    if (x >= r1 && x <= r2)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+// Visit the values within the stencil, in order
+void GetValues(vtkImageData *image, vtkImageStencilData *stencil,
+               std::vector<std::vector<double> > &values)
+{
+  int ext[6];
+  image->GetExtent(ext);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  int nc = scalars->GetNumberOfComponents();
+  values.clear();
+  vtkIdType v = 0;
+  for (int z = ext[4]; z <= ext[5]; z++)
+    {
+    for (int y = ext[2]; y <= ext[3]; y++)
+      {
+      for (int x = ext[0]; x <= ext[1]; x++)
+        {
+        if (InStencil(stencil, x, y, z))
+          {
+          std::vector<double> tuple(nc);
+          for (int c = 0; c < nc; c++)
+            {
+            tuple[c] = scalars->GetComponent(v, c);
+            }
+          values.push_back(tuple);
+          }
+        v++;
+        }
+      }
+    }
+}
+
+bool CheckHistogram(vtkImageData *image, vtkImageStencilData *stencil,
+                    int component, bool smp)
+{
+  vtkNew<vtkImageHistogram> histogram;
+  histogram->SetInputData(image);
+  if (stencil)
+    {
+    histogram->SetStencilData(stencil);
+    }
+  histogram->SetActiveComponent(component);
+  histogram->AutomaticBinningOn();
+  histogram->SetMaximumNumberOfBins(1000);
+  histogram->GenerateHistogramImageOff();
+  histogram->SetEnableSMP(smp);
+  histogram->SetDesiredBytesPerPiece(1000);
+  histogram->SetNumberOfThreads(4);
+  histogram->Update();
+
+  int n = histogram->GetNumberOfBins();
+  double origin = histogram->GetBinOrigin();
+  double spacing = histogram->GetBinSpacing();
+  std::vector<vtkIdType> expected(n, 0);
+  std::vector<std::vector<double> > values;
+  GetValues(image, stencil, values);
+  for (size_t i = 0; i < values.size(); i++)
+    {
+    for (size_t c = 0; c < values[i].size(); c++)
+      {
+      if (component < 0 || static_cast<int>(c) == component)
+        {
+        double x = (values[i][c] - origin)/spacing;
+        x = (x > 0 ? x : 0);
+        x = (x < n - 1 ? x : n - 1);
+        expected[static_cast<int>(x + 0.5)]++;
+        }
+      }
+    }
+
+  vtkIdTypeArray *result = histogram->GetHistogram();
+  for (int i = 0; i < n; i++)
+    {
+    if (result->GetValue(i) != expected[i])
+      {
+      cerr << "vtkImageHistogram bin " << i << " has "
+           << result->GetValue(i) << " instead of " << expected[i]
+           << " with component " << component << " and EnableSMP "
+           << smp << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+bool CheckAccumulate(vtkImageData *image, vtkImageStencilData *stencil)
+{
+  vtkNew<vtkImageAccumulate> accumulate;
+  accumulate->SetInputData(image);
+  if (stencil)
+    {
+    accumulate->SetStencilData(stencil);
+    }
+  accumulate->SetComponentExtent(0, 15, 0, 7, 0, 0);
+  accumulate->SetComponentOrigin(-100.0, 0.0, 0.0);
+  accumulate->SetComponentSpacing(50.0, 100.0, 1.0);
+  accumulate->Update();
+
+  std::vector<vtkIdType> expected(16*8, 0);
+  double min[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+  double max[2] = { VTK_DOUBLE_MIN, VTK_DOUBLE_MIN };
+  std::vector<std::vector<double> > values;
+  GetValues(image, stencil, values);
+  for (size_t i = 0; i < values.size(); i++)
+    {
+    int x = vtkMath::Floor((values[i][0] + 100.0)/50.0);
+    int y = vtkMath::Floor(values[i][1]/100.0);
+    if (x >= 0 && x < 16 && y >= 0 && y < 8)
+      {
+      expected[x + 16*y]++;
+      }
+    for (int c = 0; c < 2; c++)
+      {
+      min[c] = std::min(min[c], values[i][c]);
+      max[c] = std::max(max[c], values[i][c]);
+      }
+    }
+
+  vtkIdType *result = static_cast<vtkIdType *>(
+    accumulate->GetOutput()->GetScalarPointer());
+  for (int i = 0; i < 16*8; i++)
+    {
+    if (result[i] != expected[i])
+      {
+      cerr << "vtkImageAccumulate bin " << i << " has " << result[i]
+           << " instead of " << expected[i] << endl;
+      return false;
+      }
+    }
+
+  if (accumulate->GetVoxelCount() != static_cast<vtkIdType>(2*values.size()) ||
+      accumulate->GetMin()[0] != min[0] || accumulate->GetMin()[1] != min[1] ||
+      accumulate->GetMax()[0] != max[0] || accumulate->GetMax()[1] != max[1])
+    {
+    cerr << "vtkImageAccumulate statistics are wrong" << endl;
+    return false;
+    }
+
+  return true;
+}
+
+bool CheckPercentiles(vtkImageData *image)
+{
+  vtkNew<vtkImageHistogramStatistics> statistics;
+  statistics->SetInputData(image);
+  statistics->Update();
+
+  std::vector<std::vector<double> > values;
+  GetValues(image, NULL, values);
+  std::vector<double> sorted;
+  for (size_t i = 0; i < values.size(); i++)
+    {
+    sorted.insert(sorted.end(), values[i].begin(), values[i].end());
+    }
+  std::sort(sorted.begin(), sorted.end());
+
+  // like the median, a percentile is the last bin that holds no more than
+  // rank samples together with the bins below it, which is the bin just
+  // below the one holding the sample of that rank
+  double origin = statistics->GetBinOrigin();
+  double spacing = statistics->GetBinSpacing();
+  double lastBin = origin + (statistics->GetNumberOfBins() - 1)*spacing;
+  static const double percentiles[6] = { 0.0, 1.0, 25.0, 50.0, 99.5, 100.0 };
+  for (int i = 0; i < 6; i++)
+    {
+    size_t rank = static_cast<size_t>(sorted.size()*(percentiles[i]*0.01));
+    double expected = lastBin;
+    if (rank < sorted.size())
+      {
+      expected = std::max(sorted[rank] - spacing, origin);
+      }
+    double value = statistics->GetPercentile(percentiles[i]);
+    if (value != expected)
+      {
+      cerr << "Percentile " << percentiles[i] << " is " << value
+           << " instead of " << expected << endl;
+      return false;
+      }
+    }
+
+  if (statistics->GetPercentile(50.0) != statistics->GetMedian())
+    {
+    cerr << "The 50th percentile " << statistics->GetPercentile(50.0)
+         << " is not the median " << statistics->GetMedian() << endl;
+    return false;
+    }
+
+  return true;
+}
+
+}
+
+int TestImageHistogramSMP(int, char *[])
+{
+  vtkMath::RandomSeed(1357);
+
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-5, 40, 0, 31, 2, 25);
+  image->AllocateScalars(VTK_SHORT, 2);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    // the ranges of the slabs differ, to exercise the growth of the bins
+    double z = static_cast<double>(i)/scalars->GetNumberOfTuples();
+    scalars->SetComponent(i, 0, vtkMath::Floor(vtkMath::Random(-50, 300*z)));
+    scalars->SetComponent(i, 1, vtkMath::Floor(vtkMath::Random(0, 700)));
+    }
+
+  vtkNew<vtkImageData> floatImage;
+  floatImage->SetExtent(image->GetExtent());
+  floatImage->AllocateScalars(VTK_FLOAT, 1);
+  scalars = floatImage->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    scalars->SetComponent(i, 0, vtkMath::Random(-2.0, 5.0));
+    }
+
+  vtkNew<vtkImageStencilData> stencil;
+  MakeStencil(stencil.GetPointer(), image->GetExtent());
+
+  for (int smp = 0; smp < 2; smp++)
+    {
+    for (int component = -1; component < 2; component++)
+      {
+      if (!CheckHistogram(image.GetPointer(), NULL, component, smp != 0) ||
+          !CheckHistogram(image.GetPointer(), stencil.GetPointer(),
+                          component, smp != 0))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    if (!CheckHistogram(floatImage.GetPointer(), stencil.GetPointer(),
+                        0, smp != 0))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  if (!CheckAccumulate(image.GetPointer(), NULL) ||
+      !CheckAccumulate(image.GetPointer(), stencil.GetPointer()) ||
+      !CheckPercentiles(image.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageInterpolateLine.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of line interpolation in vtkImageInterpolator
+// .SECTION Description
+// Checks that InterpolateLineIJK gives the same values as InterpolateIJK,
+// that ComputeLineBoundsIJK agrees with CheckBoundsIJK, and that oblique
+// reslicing gives the same result as the general execution path.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageInterpolator.h"
+#include "vtkImageReslice.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+template<class F>
+bool TestLines(vtkImageInterpolator *interp, const char *name)
+{
+  int nc = interp->GetNumberOfComponents();
+  std::vector<F> lineValues(nc*201);
+  std::vector<F> pointValues(nc);
+
+  for (int trial = 0; trial < 50; trial++)
+    {
+    F point[3], step[3];
+    for (int k = 0; k < 3; k++)
+      {
+      point[k] = static_cast<F>(vtkMath::Random(-8.0, 16.0));
+      step[k] = static_cast<F>(vtkMath::Random(-0.3, 0.3));
+      }
+    // lines parallel to the axes are common in practice
+    if (trial % 5 == 0)
+      {
+      step[trial % 3] = 0;
+      step[(trial + 1) % 3] = 0;
+      }
+
+    int imin = -100;
+    int imax = 100;
+    bool inBounds = interp->ComputeLineBoundsIJK(point, step, imin, imax);
+    for (int i = -100; i <= 100; i++)
+      {
+      F p[3];
+      p[0] = point[0] + i*step[0];
+      p[1] = point[1] + i*step[1];
+      p[2] = point[2] + i*step[2];
+      bool check = interp->CheckBoundsIJK(p);
+      if (check != (inBounds && i >= imin && i <= imax))
+        {
+        cerr << name << ": bounds disagree for sample " << i << endl;
+        return false;
+        }
+      }
+    if (!inBounds)
+      {
+      continue;
+      }
+
+    int n = imax - imin + 1;
+    interp->InterpolateLineIJK(point, step, imin, &lineValues[0], n);
+    for (int i = 0; i < n; i++)
+      {
+      F p[3];
+      p[0] = point[0] + (imin + i)*step[0];
+      p[1] = point[1] + (imin + i)*step[1];
+      p[2] = point[2] + (imin + i)*step[2];
+      interp->InterpolateIJK(p, &pointValues[0]);
+      for (int c = 0; c < nc; c++)
+        {
+        double a = lineValues[i*nc + c];
+        double b = pointValues[c];
+        if (fabs(a - b) > 1e-5*(1.0 + fabs(b)))
+          {
+          cerr << name << ": line gave " << a << " instead of " << b
+               << " for sample " << (imin + i) << endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  return true;
+}
+
+bool TestReslice(vtkImageData *image, int mode)
+{
+  vtkNew<vtkTransform> transform;
+  transform->Translate(4.0, 3.0, 2.0);
+  transform->RotateWXYZ(25.0, 1.0, 2.0, 3.0);
+
+  // a homogeneous scale of two makes the reslicing take the general path
+  // without changing the result, because the scale is a power of two
+  vtkNew<vtkMatrix4x4> general;
+  for (int i = 0; i < 4; i++)
+    {
+    for (int j = 0; j < 4; j++)
+      {
+      general->SetElement(
+        i, j, 2.0*transform->GetMatrix()->GetElement(i, j));
+      }
+    }
+
+  vtkNew<vtkImageReslice> reslice[2];
+  for (int i = 0; i < 2; i++)
+    {
+    reslice[i]->SetInputData(image);
+    reslice[i]->SetInterpolationMode(mode);
+    reslice[i]->SetOutputExtent(-5, 30, -5, 30, 0, 12);
+    reslice[i]->SetOutputSpacing(1.0, 1.0, 1.0);
+    reslice[i]->SetOutputOrigin(0.0, 0.0, 0.0);
+    reslice[i]->SetBackgroundLevel(0.0);
+    }
+  reslice[0]->SetResliceAxes(transform->GetMatrix());
+  reslice[1]->SetResliceAxes(general.GetPointer());
+  reslice[0]->Update();
+  reslice[1]->Update();
+
+  vtkDataArray *a = reslice[0]->GetOutput()->GetPointData()->GetScalars();
+  vtkDataArray *b = reslice[1]->GetOutput()->GetPointData()->GetScalars();
+  int nc = a->GetNumberOfComponents();
+  vtkIdType n = a->GetNumberOfTuples()*nc;
+  vtkIdType inside = 0;
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    double u = a->GetComponent(i/nc, i%nc);
+    double v = b->GetComponent(i/nc, i%nc);
+    if (fabs(u - v) > 1e-5*(1.0 + fabs(v)))
+      {
+      cerr << "vtkImageReslice: " << reslice[0]->GetInterpolationModeAsString()
+           << " gave " << u << " instead of " << v << " at " << i << endl;
+      return false;
+      }
+    inside += (v != 0.0);
+    }
+
+  // make sure that the output isn't just background
+  if (inside == 0 || inside == n)
+    {
+    cerr << "vtkImageReslice: " << inside << " of " << n
+         << " output values are inside the input" << endl;
+    return false;
+    }
+
+  return true;
+}
+
+}
+
+int TestImageInterpolateLine(int, char *[])
+{
+  static const int scalarTypes[5] = {
+    VTK_FLOAT, VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_UNSIGNED_CHAR, VTK_DOUBLE };
+  static const int modes[3] = {
+    VTK_NEAREST_INTERPOLATION, VTK_LINEAR_INTERPOLATION,
+    VTK_CUBIC_INTERPOLATION };
+  static const int borders[3] = {
+    VTK_IMAGE_BORDER_CLAMP, VTK_IMAGE_BORDER_REPEAT,
+    VTK_IMAGE_BORDER_MIRROR };
+
+  vtkMath::RandomSeed(1234);
+
+  for (int t = 0; t < 5; t++)
+    {
+    for (int nc = 1; nc <= 3; nc += 2)
+      {
+      vtkNew<vtkImageData> image;
+      image->SetExtent(0, 15, 0, 11, 0, 7);
+      image->AllocateScalars(scalarTypes[t], nc);
+      vtkDataArray *scalars = image->GetPointData()->GetScalars();
+      for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+        {
+        for (int c = 0; c < nc; c++)
+          {
+          scalars->SetComponent(i, c, vtkMath::Random(10.0, 250.0));
+          }
+        }
+
+      for (int m = 0; m < 3; m++)
+        {
+        for (int b = 0; b < 3; b++)
+          {
+          vtkNew<vtkImageInterpolator> interp;
+          interp->SetInterpolationMode(modes[m]);
+          interp->SetBorderMode(borders[b]);
+          interp->Initialize(image.GetPointer());
+          interp->Update();
+
+          std::string name = scalars->GetDataTypeAsString();
+          name += " ";
+          name += interp->GetInterpolationModeAsString();
+          name += " ";
+          name += interp->GetBorderModeAsString();
+          if (!TestLines<double>(interp.GetPointer(), name.c_str()) ||
+              !TestLines<float>(interp.GetPointer(), name.c_str()))
+            {
+            return EXIT_FAILURE;
+            }
+          }
+
+        if (!TestReslice(image.GetPointer(), modes[m]))
+          {
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
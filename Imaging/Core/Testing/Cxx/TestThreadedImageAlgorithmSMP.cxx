@@ -0,0 +1,243 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedImageAlgorithmSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the vtkSMPTools execution of vtkThreadedImageAlgorithm
+// .SECTION Description
+// Checks that the pieces made for each split mode cover the extent exactly
+// once, and that filters give the same output with EnableSMP on and off.
+// vtkImageDifference must ignore EnableSMP, since it sums its error over
+// thread ids.
+
+#include "vtkDataArray.h"
+#include "vtkImageBSplineCoefficients.h"
+#include "vtkImageData.h"
+#include "vtkImageDifference.h"
+#include "vtkImageReslice.h"
+#include "vtkImageShiftScale.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTransform.h"
+
+#include <vector>
+
+namespace {
+
+bool CheckPieces(vtkThreadedImageAlgorithm *filter, int extent[6],
+                 int total)
+{
+  int size[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    size[i] = extent[2*i+1] - extent[2*i] + 1;
+    }
+  std::vector<int> count(size[0]*size[1]*size[2], 0);
+  int splitExt[6];
+  int pieces = filter->SplitExtent(splitExt, extent, 0, total);
+  if (pieces < 1 || pieces > total)
+    {
+    cerr << "Wrong number of pieces: " << pieces << " of " << total << endl;
+    return false;
+    }
+  for (int piece = 0; piece < pieces; ++piece)
+    {
+    filter->SplitExtent(splitExt, extent, piece, total);
+    for (int i = 0; i < 3; ++i)
+      {
+      if (splitExt[2*i] < extent[2*i] || splitExt[2*i+1] > extent[2*i+1])
+        {
+        cerr << "Piece " << piece << " is outside the extent" << endl;
+        return false;
+        }
+      }
+    for (int z = splitExt[4]; z <= splitExt[5]; ++z)
+      {
+      for (int y = splitExt[2]; y <= splitExt[3]; ++y)
+        {
+        for (int x = splitExt[0]; x <= splitExt[1]; ++x)
+          {
+          count[(x - extent[0]) +
+                size[0]*((y - extent[2]) + size[1]*(z - extent[4]))]++;
+          }
+        }
+      }
+    }
+  for (size_t i = 0; i < count.size(); ++i)
+    {
+    if (count[i] != 1)
+      {
+      cerr << "Voxel " << i << " is in " << count[i] << " pieces" << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CompareOutputs(vtkThreadedImageAlgorithm *filter, const char *name)
+{
+  filter->EnableSMPOff();
+  filter->Update();
+  vtkNew<vtkImageData> expected;
+  expected->DeepCopy(filter->GetOutput());
+  vtkDataArray *expectedScalars = expected->GetPointData()->GetScalars();
+
+  for (int mode = vtkThreadedImageAlgorithm::SLAB;
+       mode <= vtkThreadedImageAlgorithm::BLOCK; ++mode)
+    {
+    filter->EnableSMPOn();
+    filter->SetSplitMode(mode);
+    filter->SetDesiredBytesPerPiece(1000);
+    filter->Modified();
+    filter->Update();
+    vtkDataArray *scalars = filter->GetOutput()->GetPointData()->GetScalars();
+    if (!scalars ||
+        scalars->GetNumberOfTuples() != expectedScalars->GetNumberOfTuples())
+      {
+      cerr << name << ": wrong output size in split mode " << mode << endl;
+      return false;
+      }
+    int n = scalars->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+      {
+      for (int c = 0; c < n; ++c)
+        {
+        if (scalars->GetComponent(i, c) != expectedScalars->GetComponent(i, c))
+          {
+          cerr << name << ": wrong value at " << i << " in split mode "
+               << mode << endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+void MakeRGBImage(vtkImageData *image, int seed)
+{
+  image->SetExtent(0, 199, 0, 149, 0, 0);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char *ptr =
+    static_cast<unsigned char *>(image->GetScalarPointer());
+  for (int y = 0; y < 150; ++y)
+    {
+    for (int x = 0; x < 200; ++x)
+      {
+      for (int c = 0; c < 3; ++c)
+        {
+        *ptr++ = static_cast<unsigned char>((x*7 + y*seed + c*50) % 256);
+        }
+      }
+    }
+}
+
+bool CheckDifference()
+{
+  vtkNew<vtkImageData> image1;
+  MakeRGBImage(image1.GetPointer(), 3);
+  vtkNew<vtkImageData> image2;
+  MakeRGBImage(image2.GetPointer(), 5);
+
+  vtkNew<vtkImageDifference> difference;
+  difference->SetInputData(image1.GetPointer());
+  difference->SetImageData(image2.GetPointer());
+  difference->Update();
+  double error = difference->GetError();
+  double thresholdedError = difference->GetThresholdedError();
+
+  // far more pieces than there are thread slots
+  difference->EnableSMPOn();
+  difference->SetDesiredBytesPerPiece(100);
+  difference->Modified();
+  difference->Update();
+  if (error <= 0.0 || difference->GetError() != error ||
+      difference->GetThresholdedError() != thresholdedError)
+    {
+    cerr << "vtkImageDifference: error " << difference->GetError()
+         << " with EnableSMP on, " << error << " with it off" << endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+int TestThreadedImageAlgorithmSMP(int, char *[])
+{
+  // the pieces tile the extent for all split modes
+  vtkNew<vtkImageShiftScale> shiftScale;
+  shiftScale->EnableSMPOn();
+  int extents[3][6] = {
+    { 0, 63, 0, 31, 0, 11 },
+    { -5, 40, 3, 3, 0, 17 },
+    { 0, 200, 0, 150, 0, 0 } };
+  int totals[5] = { 1, 3, 16, 100, 5000 };
+  for (int mode = vtkThreadedImageAlgorithm::SLAB;
+       mode <= vtkThreadedImageAlgorithm::BLOCK; ++mode)
+    {
+    shiftScale->SetSplitMode(mode);
+    for (int e = 0; e < 3; ++e)
+      {
+      for (int t = 0; t < 5; ++t)
+        {
+        if (!CheckPieces(shiftScale.GetPointer(), extents[e], totals[t]))
+          {
+          cerr << "in split mode " << mode << ", extent " << e
+               << ", total " << totals[t] << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  // the filters give the same output with many small pieces
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 47, 0, 39, 0, 23);
+  image->AllocateScalars(VTK_FLOAT, 1);
+  float *ptr = static_cast<float *>(image->GetScalarPointer());
+  for (int z = 0; z < 24; ++z)
+    {
+    for (int y = 0; y < 40; ++y)
+      {
+      for (int x = 0; x < 48; ++x)
+        {
+        *ptr++ = static_cast<float>((x*x + 3*y) % 17 + 0.25*z);
+        }
+      }
+    }
+
+  shiftScale->SetInputData(image.GetPointer());
+  shiftScale->SetShift(1.5);
+  shiftScale->SetScale(3.0);
+
+  vtkNew<vtkTransform> transform;
+  transform->RotateWXYZ(30.0, 1.0, 2.0, 3.0);
+  vtkNew<vtkImageReslice> reslice;
+  reslice->SetInputData(image.GetPointer());
+  reslice->SetResliceAxes(transform->GetMatrix());
+  reslice->SetInterpolationModeToCubic();
+
+  vtkNew<vtkImageBSplineCoefficients> coefficients;
+  coefficients->SetInputData(image.GetPointer());
+
+  if (!CompareOutputs(shiftScale.GetPointer(), "vtkImageShiftScale") ||
+      !CompareOutputs(reslice.GetPointer(), "vtkImageReslice") ||
+      !CompareOutputs(coefficients.GetPointer(),
+                      "vtkImageBSplineCoefficients") ||
+      !CheckDifference())
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -48,6 +48,139 @@ void vtkInterpolateNOP<F>::RowInterpolationFunc(
 {
 }
 
+//----------------------------------------------------------------------------
+// interpolate a line one sample at a time, for interpolators that do not
+// provide a line interpolation function
+template<class F>
+void vtkInterpolateLineBySample(
+  void (*interpolate)(vtkInterpolationInfo *, const F [3], F *),
+  vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+  F *outPtr, int n)
+{
+  int numscalars = info->NumberOfComponents;
+  for (int i = i0; i < i0 + n; i++)
+    {
+    F p[3];
+    p[0] = point[0] + i*step[0];
+    p[1] = point[1] + i*step[1];
+    p[2] = point[2] + i*step[2];
+    interpolate(info, p, outPtr);
+    outPtr += numscalars;
+    }
+}
+
+//----------------------------------------------------------------------------
+// check a sample on a line against the bounds, exactly as CheckBoundsIJK
+template<class F>
+inline bool vtkInterpolateLineCheck(
+  const F bounds[6], const F point[3], const F step[3], int i)
+{
+  F x = point[0] + i*step[0];
+  F y = point[1] + i*step[1];
+  F z = point[2] + i*step[2];
+  return !((x < bounds[0]) | (x > bounds[1]) |
+           (y < bounds[2]) | (y > bounds[3]) |
+           (z < bounds[4]) | (z > bounds[5]));
+}
+
+//----------------------------------------------------------------------------
+// find the contiguous range of samples on a line that are within bounds
+template<class F>
+bool vtkInterpolateLineBounds(
+  const F bounds[6], const F point[3], const F step[3], int &imin, int &imax)
+{
+  if (imin > imax)
+    {
+    return false;
+    }
+
+  // solve for the range analytically
+  double lo = imin;
+  double hi = imax;
+  for (int k = 0; k < 3; k++)
+    {
+    double s = step[k];
+    double a = bounds[2*k] - static_cast<double>(point[k]);
+    double b = bounds[2*k+1] - static_cast<double>(point[k]);
+    if (s == 0)
+      {
+      if (a > 0 || b < 0)
+        {
+        return false;
+        }
+      }
+    else
+      {
+      a /= s;
+      b /= s;
+      if (s < 0)
+        {
+        double tmp = a;
+        a = b;
+        b = tmp;
+        }
+      lo = (a > lo ? ceil(a) : lo);
+      hi = (b < hi ? floor(b) : hi);
+      }
+    }
+
+  // the result can be off by one due to roundoff, so find the exact
+  // ends by checking the samples themselves
+  int i1 = imin;
+  int i2 = imax;
+  if (lo <= hi)
+    {
+    i1 = static_cast<int>(lo);
+    i2 = static_cast<int>(hi);
+    }
+  else if (hi >= imin && lo <= imax)
+    {
+    i1 = static_cast<int>(lo);
+    i2 = i1 - 1;
+    if (i2 >= imin && vtkInterpolateLineCheck(bounds, point, step, i2))
+      {
+      i1 = i2;
+      }
+    else if (vtkInterpolateLineCheck(bounds, point, step, i1))
+      {
+      i2 = i1;
+      }
+    else
+      {
+      return false;
+      }
+    }
+  else
+    {
+    return false;
+    }
+
+  while (i1 <= i2 && !vtkInterpolateLineCheck(bounds, point, step, i1))
+    {
+    i1++;
+    }
+  while (i2 >= i1 && !vtkInterpolateLineCheck(bounds, point, step, i2))
+    {
+    i2--;
+    }
+  if (i1 > i2)
+    {
+    return false;
+    }
+  while (i1 > imin && vtkInterpolateLineCheck(bounds, point, step, i1 - 1))
+    {
+    i1--;
+    }
+  while (i2 < imax && vtkInterpolateLineCheck(bounds, point, step, i2 + 1))
+    {
+    i2++;
+    }
+
+  imin = i1;
+  imax = i2;
+  return true;
+}
+
 } // end anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -89,6 +222,8 @@ vtkAbstractImageInterpolator::vtkAbstractImageInterpolator()
     &(vtkInterpolateNOP<double>::RowInterpolationFunc);
   this->RowInterpolationFuncFloat =
     &(vtkInterpolateNOP<float>::RowInterpolationFunc);
+  this->LineInterpolationFuncDouble = NULL;
+  this->LineInterpolationFuncFloat = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -302,6 +437,8 @@ void vtkAbstractImageInterpolator::Update()
       &(vtkInterpolateNOP<double>::RowInterpolationFunc);
     this->RowInterpolationFuncFloat =
       &(vtkInterpolateNOP<float>::RowInterpolationFunc);
+    this->LineInterpolationFuncDouble = NULL;
+    this->LineInterpolationFuncFloat = NULL;
 
     return;
     }
@@ -379,6 +516,8 @@ void vtkAbstractImageInterpolator::Update()
   this->GetInterpolationFunc(&this->InterpolationFuncFloat);
   this->GetRowInterpolationFunc(&this->RowInterpolationFuncDouble);
   this->GetRowInterpolationFunc(&this->RowInterpolationFuncFloat);
+  this->GetLineInterpolationFunc(&this->LineInterpolationFuncDouble);
+  this->GetLineInterpolationFunc(&this->LineInterpolationFuncFloat);
 }
 
 //----------------------------------------------------------------------------
@@ -463,6 +602,72 @@ void vtkAbstractImageInterpolator::GetRowInterpolationFunc(
 {
 }
 
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::GetLineInterpolationFunc(
+  void (**doublefunc)(
+    vtkInterpolationInfo *, const double [3], const double [3], int,
+    double *, int))
+{
+  *doublefunc = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::GetLineInterpolationFunc(
+  void (**floatfunc)(
+    vtkInterpolationInfo *, const float [3], const float [3], int,
+    float *, int))
+{
+  *floatfunc = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::InterpolateLineIJK(
+  const double point[3], const double step[3], int i0, double *value, int n)
+{
+  if (this->LineInterpolationFuncDouble)
+    {
+    this->LineInterpolationFuncDouble(
+      this->InterpolationInfo, point, step, i0, value, n);
+    }
+  else
+    {
+    vtkInterpolateLineBySample(this->InterpolationFuncDouble,
+      this->InterpolationInfo, point, step, i0, value, n);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::InterpolateLineIJK(
+  const float point[3], const float step[3], int i0, float *value, int n)
+{
+  if (this->LineInterpolationFuncFloat)
+    {
+    this->LineInterpolationFuncFloat(
+      this->InterpolationInfo, point, step, i0, value, n);
+    }
+  else
+    {
+    vtkInterpolateLineBySample(this->InterpolationFuncFloat,
+      this->InterpolationInfo, point, step, i0, value, n);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkAbstractImageInterpolator::ComputeLineBoundsIJK(
+  const double point[3], const double step[3], int &imin, int &imax)
+{
+  return vtkInterpolateLineBounds(
+    this->StructuredBoundsDouble, point, step, imin, imax);
+}
+
+//----------------------------------------------------------------------------
+bool vtkAbstractImageInterpolator::ComputeLineBoundsIJK(
+  const float point[3], const float step[3], int &imin, int &imax)
+{
+  return vtkInterpolateLineBounds(
+    this->StructuredBoundsFloat, point, step, imin, imax);
+}
+
 //----------------------------------------------------------------------------
 void vtkAbstractImageInterpolator::PrecomputeWeightsForExtent(
   const double [16], const int [6], int [6], vtkInterpolationWeights *&)
@@ -198,6 +198,30 @@ public:
     vtkInterpolationWeights *&weights, int xIdx, int yIdx, int zIdx,
     float *value, int n);
 
+  // Description:
+  // Get a row of n samples along a line in structured coords, where the
+  // i-th sample is taken at point + (i0 + i)*step.  This is equivalent to
+  // calling InterpolateIJK() for each sample, and gives the same values
+  // to within floating-point roundoff, but it avoids the per-sample
+  // overhead.  The samples are not checked against the bounds, so use
+  // ComputeLineBoundsIJK() to find the samples that are in bounds.
+  void InterpolateLineIJK(
+    const double point[3], const double step[3], int i0,
+    double *value, int n);
+  void InterpolateLineIJK(
+    const float point[3], const float step[3], int i0,
+    float *value, int n);
+
+  // Description:
+  // Given the range [imin, imax], find the range of i for which the
+  // point + i*step is in bounds according to CheckBoundsIJK().  Since
+  // the bounds are a box, these samples are contiguous.  The range is
+  // narrowed in place, and false is returned if no samples are in bounds.
+  bool ComputeLineBoundsIJK(
+    const double point[3], const double step[3], int &imin, int &imax);
+  bool ComputeLineBoundsIJK(
+    const float point[3], const float step[3], int &imin, int &imax);
+
   // Description:
   // Get the spacing of the data being interpolated.
   vtkGetVector3Macro(Spacing, double);
@@ -245,6 +269,19 @@ protected:
     void (**floatfunc)(
       vtkInterpolationWeights *, int, int, int, float *, int));
 
+  // Description:
+  // Get the line interpolation functions.  These are optional, if they
+  // are not provided then InterpolateLineIJK() will interpolate each
+  // sample with the interpolation functions.
+  virtual void GetLineInterpolationFunc(
+    void (**doublefunc)(
+      vtkInterpolationInfo *, const double [3], const double [3], int,
+      double *, int));
+  virtual void GetLineInterpolationFunc(
+    void (**floatfunc)(
+      vtkInterpolationInfo *, const float [3], const float [3], int,
+      float *, int));
+
   vtkDataArray *Scalars;
   double StructuredBoundsDouble[6];
   float StructuredBoundsFloat[6];
@@ -272,6 +309,12 @@ protected:
   void (*RowInterpolationFuncFloat)(
     vtkInterpolationWeights *weights, int idX, int idY, int idZ,
     float *outPtr, int n);
+  void (*LineInterpolationFuncDouble)(
+    vtkInterpolationInfo *info, const double point[3], const double step[3],
+    int i0, double *outPtr, int n);
+  void (*LineInterpolationFuncFloat)(
+    vtkInterpolationInfo *info, const float point[3], const float step[3],
+    int i0, float *outPtr, int n);
 
 private:
 
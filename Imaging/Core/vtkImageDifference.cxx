@@ -35,6 +35,8 @@ vtkImageDifference::vtkImageDifference()
   this->AllowShift = 1;
   this->Averaging = 1;
   this->SetNumberOfInputPorts(2);
+  // the error is accumulated per thread id, see RequestData
+  this->EnableSMP = false;
 }
 
 
@@ -159,6 +161,21 @@ int vtkImageDifference::RequestUpdateExtent(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The SMP execution passes piece numbers as the thread id, and there can be
+// more pieces than there are slots in ErrorPerThread, so it cannot be used.
+int vtkImageDifference::RequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  bool enableSMP = this->EnableSMP;
+  this->EnableSMP = false;
+  int rval = this->Superclass::RequestData(request, inputVector, outputVector);
+  this->EnableSMP = enableSMP;
+  return rval;
+}
+
 //----------------------------------------------------------------------------
 void vtkImageDifference::ThreadedRequestData(
   vtkInformation * vtkNotUsed( request ),
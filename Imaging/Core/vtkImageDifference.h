@@ -107,6 +107,13 @@ protected:
                                   vtkInformationVector **,
                                   vtkInformationVector *);
 
+  // Description:
+  // The error is accumulated per thread id, so this always executes with
+  // vtkMultiThreader and ignores EnableSMP.
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *);
+
   virtual void ThreadedRequestData(vtkInformation *request,
                                    vtkInformationVector **inputVector,
                                    vtkInformationVector *outputVector,
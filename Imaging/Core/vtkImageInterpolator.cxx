@@ -510,6 +510,374 @@ void vtkImageInterpolatorGetInterpolationFunc(
     }
 }
 
+//----------------------------------------------------------------------------
+// Interpolation along a line, for samples that are known to be in bounds.
+// The indices and fractional offsets for a block of samples are computed
+// in simple loops that the compiler can vectorize, and then the values
+// are gathered from the input.
+
+const int vtkImageLineBlockSize = 64;
+
+template <class F, class T>
+struct vtkImageNLCLineInterpolate
+{
+  static void Nearest(
+    vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+    F *outPtr, int n);
+
+  static void Trilinear(
+    vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+    F *outPtr, int n);
+
+  static void Tricubic(
+    vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+    F *outPtr, int n);
+};
+
+//----------------------------------------------------------------------------
+// compute one coordinate of a block of samples and round it
+template<class F>
+inline void vtkImageLineRound(F p, F s, int i0, int n, int *idx)
+{
+  for (int i = 0; i < n; i++)
+    {
+    idx[i] = vtkInterpolationMath::Round(p + (i0 + i)*s);
+    }
+}
+
+//----------------------------------------------------------------------------
+// compute one coordinate of a block of samples and split it into the
+// integer and fractional parts
+template<class F>
+inline void vtkImageLineFloor(F p, F s, int i0, int n, int *idx, F *frac)
+{
+  for (int i = 0; i < n; i++)
+    {
+    idx[i] = vtkInterpolationMath::Floor(p + (i0 + i)*s, frac[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// apply the border mode to a block of indices (after adding the shift)
+// and convert them into memory offsets
+inline void vtkImageLineOffsets(
+  int border, int minIdx, int maxIdx, vtkIdType inc,
+  const int *idx, int shift, vtkIdType *fact, int n)
+{
+  switch (border)
+    {
+    case VTK_IMAGE_BORDER_REPEAT:
+      for (int i = 0; i < n; i++)
+        {
+        fact[i] = vtkInterpolationMath::Wrap(
+          idx[i] + shift, minIdx, maxIdx)*inc;
+        }
+      break;
+
+    case VTK_IMAGE_BORDER_MIRROR:
+      for (int i = 0; i < n; i++)
+        {
+        fact[i] = vtkInterpolationMath::Mirror(
+          idx[i] + shift, minIdx, maxIdx)*inc;
+        }
+      break;
+
+    default:
+      for (int i = 0; i < n; i++)
+        {
+        fact[i] = vtkInterpolationMath::Clamp(
+          idx[i] + shift, minIdx, maxIdx)*inc;
+        }
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCLineInterpolate<F, T>::Nearest(
+  vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+  F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+  int border = info->BorderMode;
+
+  int idx[vtkImageLineBlockSize];
+  vtkIdType factX[vtkImageLineBlockSize];
+  vtkIdType factY[vtkImageLineBlockSize];
+  vtkIdType factZ[vtkImageLineBlockSize];
+
+  for (int j = 0; j < n; j += vtkImageLineBlockSize)
+    {
+    int m = n - j;
+    m = (m < vtkImageLineBlockSize ? m : vtkImageLineBlockSize);
+
+    vtkImageLineRound(point[0], step[0], i0 + j, m, idx);
+    vtkImageLineOffsets(border, inExt[0], inExt[1], inInc[0], idx, 0,
+                        factX, m);
+    vtkImageLineRound(point[1], step[1], i0 + j, m, idx);
+    vtkImageLineOffsets(border, inExt[2], inExt[3], inInc[1], idx, 0,
+                        factY, m);
+    vtkImageLineRound(point[2], step[2], i0 + j, m, idx);
+    vtkImageLineOffsets(border, inExt[4], inExt[5], inInc[2], idx, 0,
+                        factZ, m);
+
+    for (int i = 0; i < m; i++)
+      {
+      const T *tmpPtr = inPtr + (factX[i] + factY[i] + factZ[i]);
+      int c = numscalars;
+      do
+        {
+        *outPtr++ = *tmpPtr++;
+        }
+      while (--c);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCLineInterpolate<F, T>::Trilinear(
+  vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+  F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+  int border = info->BorderMode;
+
+  int idx[vtkImageLineBlockSize];
+  F fX[vtkImageLineBlockSize];
+  F fY[vtkImageLineBlockSize];
+  F fZ[vtkImageLineBlockSize];
+  vtkIdType factX[2][vtkImageLineBlockSize];
+  vtkIdType factY[2][vtkImageLineBlockSize];
+  vtkIdType factZ[2][vtkImageLineBlockSize];
+
+  for (int j = 0; j < n; j += vtkImageLineBlockSize)
+    {
+    int m = n - j;
+    m = (m < vtkImageLineBlockSize ? m : vtkImageLineBlockSize);
+
+    // the second index is only advanced if the fraction is not zero
+    F *f[3] = { fX, fY, fZ };
+    vtkIdType *fact[3][2] = { { factX[0], factX[1] },
+                              { factY[0], factY[1] },
+                              { factZ[0], factZ[1] } };
+    for (int k = 0; k < 3; k++)
+      {
+      F *fk = f[k];
+      vtkImageLineFloor(point[k], step[k], i0 + j, m, idx, fk);
+      vtkImageLineOffsets(border, inExt[2*k], inExt[2*k+1], inInc[k],
+                          idx, 0, fact[k][0], m);
+      for (int i = 0; i < m; i++)
+        {
+        idx[i] += (fk[i] != 0);
+        }
+      vtkImageLineOffsets(border, inExt[2*k], inExt[2*k+1], inInc[k],
+                          idx, 0, fact[k][1], m);
+      }
+
+    for (int i = 0; i < m; i++)
+      {
+      vtkIdType i00 = factY[0][i] + factZ[0][i];
+      vtkIdType i01 = factY[0][i] + factZ[1][i];
+      vtkIdType i10 = factY[1][i] + factZ[0][i];
+      vtkIdType i11 = factY[1][i] + factZ[1][i];
+
+      F fx = fX[i];
+      F fy = fY[i];
+      F fz = fZ[i];
+
+      F rx = 1 - fx;
+      F ry = 1 - fy;
+      F rz = 1 - fz;
+
+      F ryrz = ry*rz;
+      F fyrz = fy*rz;
+      F ryfz = ry*fz;
+      F fyfz = fy*fz;
+
+      const T *inPtr0 = inPtr + factX[0][i];
+      const T *inPtr1 = inPtr + factX[1][i];
+
+      int c = numscalars;
+      do
+        {
+        *outPtr++ = (rx*(ryrz*inPtr0[i00] + ryfz*inPtr0[i01] +
+                         fyrz*inPtr0[i10] + fyfz*inPtr0[i11]) +
+                     fx*(ryrz*inPtr1[i00] + ryfz*inPtr1[i01] +
+                         fyrz*inPtr1[i10] + fyfz*inPtr1[i11]));
+        inPtr0++;
+        inPtr1++;
+        }
+      while (--c);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCLineInterpolate<F, T>::Tricubic(
+  vtkInterpolationInfo *info, const F point[3], const F step[3], int i0,
+  F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+  int border = info->BorderMode;
+
+  // check if only one slice in a particular direction
+  int multipleY = (inExt[2] != inExt[3]);
+  int multipleZ = (inExt[4] != inExt[5]);
+
+  int idx[vtkImageLineBlockSize];
+  F fX[vtkImageLineBlockSize];
+  F fY[vtkImageLineBlockSize];
+  F fZ[vtkImageLineBlockSize];
+  vtkIdType factX[4][vtkImageLineBlockSize];
+  vtkIdType factY[4][vtkImageLineBlockSize];
+  vtkIdType factZ[4][vtkImageLineBlockSize];
+
+  for (int j = 0; j < n; j += vtkImageLineBlockSize)
+    {
+    int m = n - j;
+    m = (m < vtkImageLineBlockSize ? m : vtkImageLineBlockSize);
+
+    F *f[3] = { fX, fY, fZ };
+    vtkIdType (*fact[3])[vtkImageLineBlockSize] = { factX, factY, factZ };
+    for (int k = 0; k < 3; k++)
+      {
+      vtkImageLineFloor(point[k], step[k], i0 + j, m, idx, f[k]);
+      for (int l = 0; l < 4; l++)
+        {
+        vtkImageLineOffsets(border, inExt[2*k], inExt[2*k+1], inInc[k],
+                            idx, l - 1, fact[k][l], m);
+        }
+      }
+
+    for (int i = 0; i < m; i++)
+      {
+      // get the interpolation coefficients
+      F fx[4], fy[4], fz[4];
+      vtkTricubicInterpWeights(fx, fX[i]);
+      vtkTricubicInterpWeights(fy, fY[i]);
+      vtkTricubicInterpWeights(fz, fZ[i]);
+
+      // or if fractional offset is zero
+      int useY = multipleY & (fY[i] != 0);
+      int useZ = multipleZ & (fZ[i] != 0);
+
+      // the limits to use when doing the interpolation
+      int j1 = 1 - useY;
+      int j2 = 1 + 2*useY;
+
+      int k1 = 1 - useZ;
+      int k2 = 1 + 2*useZ;
+
+      // if only one coefficient will be used
+      if (useY == 0) { fy[1] = 1; }
+      if (useZ == 0) { fz[1] = 1; }
+
+      vtkIdType factX0 = factX[0][i];
+      vtkIdType factX1 = factX[1][i];
+      vtkIdType factX2 = factX[2][i];
+      vtkIdType factX3 = factX[3][i];
+
+      const T *tmpInPtr = inPtr;
+      int c = numscalars;
+      do // loop over components
+        {
+        F val = 0;
+        int k = k1;
+        do // loop over z
+          {
+          F ifz = fz[k];
+          vtkIdType factz = factZ[k][i];
+          int jj = j1;
+          do // loop over y
+            {
+            F ify = fy[jj];
+            F fzy = ifz*ify;
+            vtkIdType factzy = factz + factY[jj][i];
+            const T *tmpPtr = tmpInPtr + factzy;
+            val += fzy*(fx[0]*tmpPtr[factX0] +
+                        fx[1]*tmpPtr[factX1] +
+                        fx[2]*tmpPtr[factX2] +
+                        fx[3]*tmpPtr[factX3]);
+            }
+          while (++jj <= j2);
+          }
+        while (++k <= k2);
+
+        *outPtr++ = val;
+        tmpInPtr++;
+        }
+      while (--c);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template<class F, class T>
+void vtkImageInterpolatorGetLineInterpolationFuncT(
+  void (**interpolate)(
+    vtkInterpolationInfo *, const F [3], const F [3], int, F *, int),
+  int interpolationMode)
+{
+  switch (interpolationMode)
+    {
+    case VTK_NEAREST_INTERPOLATION:
+      *interpolate = &(vtkImageNLCLineInterpolate<F, T>::Nearest);
+      break;
+    case VTK_LINEAR_INTERPOLATION:
+      *interpolate = &(vtkImageNLCLineInterpolate<F, T>::Trilinear);
+      break;
+    case VTK_CUBIC_INTERPOLATION:
+      *interpolate = &(vtkImageNLCLineInterpolate<F, T>::Tricubic);
+      break;
+    default:
+      *interpolate = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Get the line interpolation function for the specified data types.  To
+// limit the code size, these are only provided for the most common types,
+// and other types will be interpolated one sample at a time.
+template<class F>
+void vtkImageInterpolatorGetLineInterpolationFunc(
+  void (**interpolate)(
+    vtkInterpolationInfo *, const F [3], const F [3], int, F *, int),
+  int dataType, int interpolationMode)
+{
+  switch (dataType)
+    {
+    case VTK_FLOAT:
+      vtkImageInterpolatorGetLineInterpolationFuncT<F, float>(
+        interpolate, interpolationMode);
+      break;
+    case VTK_SHORT:
+      vtkImageInterpolatorGetLineInterpolationFuncT<F, short>(
+        interpolate, interpolationMode);
+      break;
+    case VTK_UNSIGNED_SHORT:
+      vtkImageInterpolatorGetLineInterpolationFuncT<F, unsigned short>(
+        interpolate, interpolationMode);
+      break;
+    case VTK_UNSIGNED_CHAR:
+      vtkImageInterpolatorGetLineInterpolationFuncT<F, unsigned char>(
+        interpolate, interpolationMode);
+      break;
+    default:
+      *interpolate = 0;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Interpolation for precomputed weights
 
@@ -1078,6 +1446,24 @@ void vtkImageInterpolator::GetRowInterpolationFunc(
     func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
 }
 
+//----------------------------------------------------------------------------
+void vtkImageInterpolator::GetLineInterpolationFunc(
+  void (**func)(vtkInterpolationInfo *, const double [3], const double [3],
+                int, double *, int))
+{
+  vtkImageInterpolatorGetLineInterpolationFunc(
+    func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageInterpolator::GetLineInterpolationFunc(
+  void (**func)(vtkInterpolationInfo *, const float [3], const float [3],
+                int, float *, int))
+{
+  vtkImageInterpolatorGetLineInterpolationFunc(
+    func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
+}
+
 //----------------------------------------------------------------------------
 void vtkImageInterpolator::PrecomputeWeightsForExtent(
   const double matrix[16], const int extent[6], int newExtent[6],
@@ -2083,6 +2083,11 @@ void vtkImageResliceExecute(vtkImageReslice *self,
     optimizeNearest = 1;
     }
 
+  // for affine transformations the samples on each output row lie on a
+  // line through the input, so the whole row can be interpolated at once
+  bool optimizeLine = (!optimizeNearest && !newtrans && !perspective &&
+                       nsamples <= 1);
+
   // get Increments to march through data
   vtkIdType outIncX, outIncY, outIncZ;
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
@@ -2170,7 +2175,63 @@ void vtkImageResliceExecute(vtkImageReslice *self,
                                      outPtr, background, outComponents,
                                      setpixels, iter))
         {
-        if (!optimizeNearest)
+        if (optimizeLine)
+          {
+          // the samples that are in bounds form one contiguous segment
+          int startIdX = idXmin;
+          int endIdX = idXmax;
+          if (!interpolator->ComputeLineBoundsIJK(
+                inPoint1, xAxis, startIdX, endIdX))
+            {
+            startIdX = idXmax + 1;
+            endIdX = idXmax;
+            }
+
+          if (startIdX > idXmin)
+            {
+            setpixels(outPtr, background, outComponents, startIdX - idXmin);
+            }
+
+          int numpixels = endIdX - startIdX + 1;
+          if (numpixels > 0)
+            {
+            interpolator->InterpolateLineIJK(
+              inPoint1, xAxis, startIdX, floatPtr, numpixels);
+
+            if (outputStencil)
+              {
+              outputStencil->InsertNextExtent(startIdX, endIdX, idY, idZ);
+              }
+
+            if (rescaleScalars)
+              {
+              vtkImageResliceRescaleScalars(floatPtr, inComponents,
+                                            numpixels,
+                                            scalarShift, scalarScale);
+              }
+
+            if (convertScalars)
+              {
+              (self->*convertScalars)(floatPtr, outPtr,
+                                      vtkTypeTraits<F>::VTKTypeID(),
+                                      inComponents, numpixels,
+                                      startIdX, idY, idZ, threadId);
+
+              outPtr = static_cast<void *>(static_cast<char *>(outPtr)
+                         + numpixels*outComponents*scalarSize);
+              }
+            else
+              {
+              convertpixels(outPtr, floatPtr, outComponents, numpixels);
+              }
+            }
+
+          if (endIdX < idXmax)
+            {
+            setpixels(outPtr, background, outComponents, idXmax - endIdX);
+            }
+          }
+        else if (!optimizeNearest)
           {
           bool wasInBounds = 1;
           bool isInBounds = 1;
@@ -127,6 +127,11 @@ void vtkImageFFTExecute(vtkImageFFT *self,
           }
         count++;
         }
+
+      // If the input is real, the FFTs of two rows are done at once by
+      // putting the second row into the imaginary part.
+      int pair = (numberOfComponents == 1 && idx1 < outMax1);
+
       // copy into complex numbers
       inPtr0 = inPtr1;
       pComplex = inComplex;
@@ -138,6 +143,10 @@ void vtkImageFFTExecute(vtkImageFFT *self,
           { // yes we have an imaginary input
           pComplex->Imag = static_cast<double>(inPtr0[1]);;
           }
+        else if (pair)
+          {
+          pComplex->Imag = static_cast<double>(inPtr0[inInc1]);
+          }
         inPtr0 += inInc0;
         ++pComplex;
         }
@@ -145,6 +154,28 @@ void vtkImageFFTExecute(vtkImageFFT *self,
       // Call the method that performs the fft
       self->ExecuteFft(inComplex, outComplex, inSize0);
 
+      if (pair)
+        {
+        // Separate the transforms of the two rows using their symmetry:
+        // X[k] = (Z[k] + conj(Z[-k]))/2, Y[k] = (Z[k] - conj(Z[-k]))/2i
+        outPtr0 = outPtr1;
+        for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+          {
+          int k = idx0 - inMin0;
+          vtkImageComplex z1 = outComplex[k];
+          vtkImageComplex z2 = outComplex[(inSize0 - k) % inSize0];
+          *outPtr0 = 0.5*(z1.Real + z2.Real);
+          outPtr0[1] = 0.5*(z1.Imag - z2.Imag);
+          outPtr0[outInc1] = 0.5*(z1.Imag + z2.Imag);
+          outPtr0[outInc1 + 1] = 0.5*(z2.Real - z1.Real);
+          outPtr0 += outInc0;
+          }
+        ++idx1;
+        inPtr1 += 2*inInc1;
+        outPtr1 += 2*outInc1;
+        continue;
+        }
+
       // copy into output
       outPtr0 = outPtr1;
       pComplex = outComplex + (outMin0 - inMin0);
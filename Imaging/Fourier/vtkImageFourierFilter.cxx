@@ -15,8 +15,383 @@
 #include "vtkImageFourierFilter.h"
 
 #include "vtkMath.h"
+#include "vtkSimpleCriticalSection.h"
+
+#include <map>
+#include <vector>
 #include <math.h>
 
+// Prime factors larger than this are done with Bluestein's algorithm
+#define VTK_FFT_MAX_RADIX 31
+
+//----------------------------------------------------------------------------
+// A plan for the forward FFT of one particular size.  If all the prime
+// factors of the size are small, the FFT is done with a recursive
+// mixed-radix decimation-in-time algorithm, with special butterflies for
+// radix 2, 3, and 4.  Otherwise, Bluestein's algorithm is used, which
+// does the FFT as a convolution with a chirp via FFTs of a power-of-two
+// size.  All of the twiddle factors are computed when the plan is made,
+// and once made, a plan can be used by many threads at once.
+class vtkImageFourierPlan
+{
+public:
+  vtkImageFourierPlan(int n);
+  ~vtkImageFourierPlan();
+
+  // Compute the forward FFT of "in" into "out", the two must not overlap.
+  void Execute(const vtkImageComplex *in, vtkImageComplex *out) const;
+
+private:
+  void Work(vtkImageComplex *out, const vtkImageComplex *in,
+            int fstride, const int *factors) const;
+  void Butterfly2(vtkImageComplex *out, int fstride, int m) const;
+  void Butterfly3(vtkImageComplex *out, int fstride, int m) const;
+  void Butterfly4(vtkImageComplex *out, int fstride, int m) const;
+  void ButterflyN(vtkImageComplex *out, int fstride, int m, int p) const;
+  void ExecuteBluestein(const vtkImageComplex *in,
+                        vtkImageComplex *out) const;
+
+  int N;
+  // pairs of (radix, remaining length) for each stage
+  std::vector<int> Factors;
+  // exp(-2*pi*i*k/N) for k in [0,N)
+  std::vector<vtkImageComplex> Twiddles;
+
+  // for Bluestein's algorithm
+  vtkImageFourierPlan *SubPlan;
+  std::vector<vtkImageComplex> Chirp;
+  std::vector<vtkImageComplex> ChirpFFT;
+
+  vtkImageFourierPlan(const vtkImageFourierPlan&);  // Not implemented.
+  void operator=(const vtkImageFourierPlan&);  // Not implemented.
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierPlan::vtkImageFourierPlan(int n)
+{
+  this->N = n;
+  this->SubPlan = NULL;
+
+  // factor the size, using radix 4 as much as possible
+  bool bluestein = false;
+  int p = 4;
+  do
+    {
+    while (n % p)
+      {
+      switch (p)
+        {
+        case 4: p = 2; break;
+        case 2: p = 3; break;
+        default: p += 2; break;
+        }
+      if (p*p > n)
+        {
+        p = n;
+        }
+      }
+    n /= p;
+    this->Factors.push_back(p);
+    this->Factors.push_back(n);
+    bluestein |= (p > VTK_FFT_MAX_RADIX);
+    }
+  while (n > 1);
+
+  if (!bluestein)
+    {
+    this->Twiddles.resize(this->N);
+    for (int k = 0; k < this->N; ++k)
+      {
+      double phase = -2.0*vtkMath::Pi()*k/this->N;
+      this->Twiddles[k].Real = cos(phase);
+      this->Twiddles[k].Imag = sin(phase);
+      }
+    return;
+    }
+
+  // for Bluestein, X[k] = w[k] * sum(x[j]*w[j] * conj(w[k-j])), where
+  // w[k] = exp(-pi*i*k*k/N), and the sum is a convolution done by FFT
+  n = this->N;
+  int m = 1;
+  while (m < 2*n - 1)
+    {
+    m *= 2;
+    }
+  this->SubPlan = new vtkImageFourierPlan(m);
+  this->Chirp.resize(n);
+  for (int k = 0; k < n; ++k)
+    {
+    // reduce k*k modulo 2*N to keep the phase accurate
+    vtkTypeInt64 kk = static_cast<vtkTypeInt64>(k)*k % (2*n);
+    double phase = -vtkMath::Pi()*kk/n;
+    this->Chirp[k].Real = cos(phase);
+    this->Chirp[k].Imag = sin(phase);
+    }
+  vtkImageComplex zero = { 0.0, 0.0 };
+  std::vector<vtkImageComplex> b(m, zero);
+  vtkImageComplexConjugate(this->Chirp[0], b[0]);
+  for (int k = 1; k < n; ++k)
+    {
+    vtkImageComplexConjugate(this->Chirp[k], b[k]);
+    b[m - k] = b[k];
+    }
+  this->ChirpFFT.resize(m);
+  this->SubPlan->Execute(&b[0], &this->ChirpFFT[0]);
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierPlan::~vtkImageFourierPlan()
+{
+  delete this->SubPlan;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::Execute(
+  const vtkImageComplex *in, vtkImageComplex *out) const
+{
+  if (this->SubPlan)
+    {
+    this->ExecuteBluestein(in, out);
+    }
+  else if (this->N == 1)
+    {
+    out[0] = in[0];
+    }
+  else
+    {
+    this->Work(out, in, 1, &this->Factors[0]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Recursively do the sub-transforms of each stage, and then combine them.
+void vtkImageFourierPlan::Work(
+  vtkImageComplex *out, const vtkImageComplex *in,
+  int fstride, const int *factors) const
+{
+  const int p = factors[0];
+  const int m = factors[1];
+  vtkImageComplex *outEnd = out + p*m;
+
+  if (m == 1)
+    {
+    for (vtkImageComplex *o = out; o != outEnd; ++o)
+      {
+      *o = *in;
+      in += fstride;
+      }
+    }
+  else
+    {
+    for (vtkImageComplex *o = out; o != outEnd; o += m)
+      {
+      this->Work(o, in, fstride*p, factors + 2);
+      in += fstride;
+      }
+    }
+
+  switch (p)
+    {
+    case 2: this->Butterfly2(out, fstride, m); break;
+    case 3: this->Butterfly3(out, fstride, m); break;
+    case 4: this->Butterfly4(out, fstride, m); break;
+    default: this->ButterflyN(out, fstride, m, p); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::Butterfly2(
+  vtkImageComplex *out, int fstride, int m) const
+{
+  const vtkImageComplex *tw = &this->Twiddles[0];
+  vtkImageComplex *out2 = out + m;
+  vtkImageComplex t;
+  for (int k = 0; k < m; ++k)
+    {
+    vtkImageComplexMultiply(out2[k], *tw, t);
+    tw += fstride;
+    vtkImageComplexSubtract(out[k], t, out2[k]);
+    vtkImageComplexAdd(out[k], t, out[k]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::Butterfly3(
+  vtkImageComplex *out, int fstride, int m) const
+{
+  const vtkImageComplex *tw1 = &this->Twiddles[0];
+  const vtkImageComplex *tw2 = tw1;
+  // the imaginary part of exp(-2*pi*i/3)
+  const double s = this->Twiddles[fstride*m].Imag;
+  vtkImageComplex s0, s1, s2, s3;
+  for (int k = 0; k < m; ++k)
+    {
+    vtkImageComplexMultiply(out[m], *tw1, s1);
+    vtkImageComplexMultiply(out[2*m], *tw2, s2);
+    tw1 += fstride;
+    tw2 += 2*fstride;
+    vtkImageComplexAdd(s1, s2, s3);
+    vtkImageComplexSubtract(s1, s2, s0);
+    out[m].Real = out[0].Real - 0.5*s3.Real;
+    out[m].Imag = out[0].Imag - 0.5*s3.Imag;
+    s0.Real *= s;
+    s0.Imag *= s;
+    vtkImageComplexAdd(out[0], s3, out[0]);
+    out[2*m].Real = out[m].Real + s0.Imag;
+    out[2*m].Imag = out[m].Imag - s0.Real;
+    out[m].Real -= s0.Imag;
+    out[m].Imag += s0.Real;
+    ++out;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::Butterfly4(
+  vtkImageComplex *out, int fstride, int m) const
+{
+  const vtkImageComplex *tw1 = &this->Twiddles[0];
+  const vtkImageComplex *tw2 = tw1;
+  const vtkImageComplex *tw3 = tw1;
+  vtkImageComplex s0, s1, s2, s3, s4, s5;
+  for (int k = 0; k < m; ++k)
+    {
+    vtkImageComplexMultiply(out[m], *tw1, s0);
+    vtkImageComplexMultiply(out[2*m], *tw2, s1);
+    vtkImageComplexMultiply(out[3*m], *tw3, s2);
+    tw1 += fstride;
+    tw2 += 2*fstride;
+    tw3 += 3*fstride;
+    vtkImageComplexSubtract(out[0], s1, s5);
+    vtkImageComplexAdd(out[0], s1, out[0]);
+    vtkImageComplexAdd(s0, s2, s3);
+    vtkImageComplexSubtract(s0, s2, s4);
+    vtkImageComplexSubtract(out[0], s3, out[2*m]);
+    vtkImageComplexAdd(out[0], s3, out[0]);
+    out[m].Real = s5.Real + s4.Imag;
+    out[m].Imag = s5.Imag - s4.Real;
+    out[3*m].Real = s5.Real - s4.Imag;
+    out[3*m].Imag = s5.Imag + s4.Real;
+    ++out;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::ButterflyN(
+  vtkImageComplex *out, int fstride, int m, int p) const
+{
+  const vtkImageComplex *tw = &this->Twiddles[0];
+  vtkImageComplex scratch[VTK_FFT_MAX_RADIX];
+  vtkImageComplex t;
+  for (int u = 0; u < m; ++u)
+    {
+    for (int q = 0; q < p; ++q)
+      {
+      scratch[q] = out[u + q*m];
+      }
+    for (int q = 0; q < p; ++q)
+      {
+      int k = u + q*m;
+      int j = 0;
+      out[k] = scratch[0];
+      for (int r = 1; r < p; ++r)
+        {
+        j += fstride*k;
+        if (j >= this->N)
+          {
+          j -= this->N;
+          }
+        vtkImageComplexMultiply(scratch[r], tw[j], t);
+        vtkImageComplexAdd(out[k], t, out[k]);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierPlan::ExecuteBluestein(
+  const vtkImageComplex *in, vtkImageComplex *out) const
+{
+  int n = this->N;
+  int m = static_cast<int>(this->ChirpFFT.size());
+  std::vector<vtkImageComplex> buffer(2*m);
+  vtkImageComplex *a = &buffer[0];
+  vtkImageComplex *c = &buffer[m];
+
+  // multiply by the chirp and pad with zeros
+  for (int k = 0; k < n; ++k)
+    {
+    vtkImageComplexMultiply(in[k], this->Chirp[k], a[k]);
+    }
+  for (int k = n; k < m; ++k)
+    {
+    a[k].Real = 0.0;
+    a[k].Imag = 0.0;
+    }
+
+  // convolve with the conjugate chirp, with the inverse FFT done as the
+  // conjugate of the forward FFT of the conjugate
+  this->SubPlan->Execute(a, c);
+  for (int k = 0; k < m; ++k)
+    {
+    vtkImageComplexMultiply(c[k], this->ChirpFFT[k], c[k]);
+    c[k].Imag = -c[k].Imag;
+    }
+  this->SubPlan->Execute(c, a);
+
+  // multiply by the chirp again
+  double scale = 1.0/m;
+  for (int k = 0; k < n; ++k)
+    {
+    vtkImageComplex t;
+    t.Real = a[k].Real*scale;
+    t.Imag = -a[k].Imag*scale;
+    vtkImageComplexMultiply(t, this->Chirp[k], out[k]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The plans are cached by size.  The lock is needed because the filter
+// executes in several threads at once.
+class vtkImageFourierFilterInternals
+{
+public:
+  ~vtkImageFourierFilterInternals()
+  {
+    std::map<int, vtkImageFourierPlan *>::iterator iter;
+    for (iter = this->Plans.begin(); iter != this->Plans.end(); ++iter)
+      {
+      delete iter->second;
+      }
+  }
+
+  const vtkImageFourierPlan *GetPlan(int n)
+  {
+    this->Lock.Lock();
+    vtkImageFourierPlan *&plan = this->Plans[n];
+    if (plan == NULL)
+      {
+      plan = new vtkImageFourierPlan(n);
+      }
+    this->Lock.Unlock();
+    return plan;
+  }
+
+  std::map<int, vtkImageFourierPlan *> Plans;
+  vtkSimpleCriticalSection Lock;
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::vtkImageFourierFilter()
+{
+  this->Internals = new vtkImageFourierFilterInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::~vtkImageFourierFilter()
+{
+  delete this->Internals;
+}
+
 /*=========================================================================
         Vectors of complex numbers.
 =========================================================================*/
@@ -145,64 +520,32 @@ void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
 //----------------------------------------------------------------------------
 // This function calculates the whole fft (or rfft) of an array.
 // The contents of the input array are changed.
-// It is engineered for no decimation so input and output cannot be equal.
+// The input and output cannot be equal.
 // (fb = 1) => fft, (fb = -1) => rfft;
 void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
                                                       vtkImageComplex *out,
                                                       int N, int fb)
 {
-  vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
+  const vtkImageFourierPlan *plan = this->Internals->GetPlan(N);
   int idx;
 
-  // If this is a reverse transform (scale accordingly).
-  if(fb == -1)
+  if(fb == 1)
     {
-    p1 = in;
-    for(idx = 0; idx < N; ++idx)
-      {
-      p1->Real = p1->Real / N;
-      p1->Imag = p1->Imag / N;
-      ++p1;
-      }
+    plan->Execute(in, out);
+    return;
     }
-  p1 = in;
-  p2 = out;
-  while(block_size < N && n <= N)
+
+  // The reverse transform is the conjugate of the forward transform of the
+  // conjugate, scaled by 1/N.
+  for(idx = 0; idx < N; ++idx)
     {
-    if((rest_size % n) == 0)
-      {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
-        {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
-        }
-      else
-        {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
-        }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
-      }
-    else
-      {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
-      }
+    in[idx].Real = in[idx].Real / N;
+    in[idx].Imag = -in[idx].Imag / N;
     }
-  // If the results ended up in the input, copy to output.
-  if(p1 != out)
+  plan->Execute(in, out);
+  for(idx = 0; idx < N; ++idx)
     {
-    for(n = 0; n < N; ++n)
-      {
-      *out++ = *p1++;
-      }
+    out[idx].Imag = -out[idx].Imag;
     }
 }
 
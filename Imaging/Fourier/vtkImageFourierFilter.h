@@ -18,6 +18,11 @@
 // this superclass is a container for methods that manipulate these structure
 // including fast Fourier transforms.  Complex numbers may become a class.
 // This should really be a helper class.
+//
+// The FFT of each size is planned the first time that size is used, and
+// the plan (including the twiddle factors) is kept by the filter.  Sizes
+// whose prime factors are small use a mixed-radix FFT, and other sizes
+// use Bluestein's algorithm, so all sizes take O(N log N) time.
 #ifndef __vtkImageFourierFilter_h
 #define __vtkImageFourierFilter_h
 
@@ -84,6 +89,8 @@ typedef struct{
 /******************* End of COMPLEX number stuff ********************/
 //ETX
 
+class vtkImageFourierFilterInternals;
+
 class VTKIMAGINGFOURIER_EXPORT vtkImageFourierFilter : public vtkImageDecomposeFilter
 {
 public:
@@ -109,8 +116,8 @@ public:
   //ETX
 
 protected:
-  vtkImageFourierFilter() {}
-  ~vtkImageFourierFilter() {}
+  vtkImageFourierFilter();
+  ~vtkImageFourierFilter();
 
   //BTX
   void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out,
@@ -119,6 +126,8 @@ protected:
                        int N, int bsize, int n, int fb);
   void ExecuteFftForwardBackward(vtkImageComplex *in, vtkImageComplex *out,
                                  int N, int fb);
+
+  vtkImageFourierFilterInternals *Internals;
   //ETX
 private:
   vtkImageFourierFilter(const vtkImageFourierFilter&);  // Not implemented.
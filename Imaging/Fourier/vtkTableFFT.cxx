@@ -44,10 +44,12 @@ vtkStandardNewMacro(vtkTableFFT);
 //-----------------------------------------------------------------------------
 vtkTableFFT::vtkTableFFT()
 {
+  this->FFT = vtkImageFFT::New();
 }
 
 vtkTableFFT::~vtkTableFFT()
 {
+  this->FFT->Delete();
 }
 
 void vtkTableFFT::PrintSelf(ostream &os, vtkIndent indent)
@@ -106,10 +108,15 @@ vtkSmartPointer<vtkDataArray> vtkTableFFT::DoFFT(vtkDataArray *input)
   imgInput->GetPointData()->SetScalars(input);
 
   // Compute the FFT
-  VTK_CREATE(vtkImageFFT, fft);
-  fft->SetInputData(imgInput);
-  fft->Update();
+  this->FFT->SetInputData(imgInput);
+  this->FFT->Update();
+  vtkSmartPointer<vtkDataArray> result =
+    this->FFT->GetOutput()->GetPointData()->GetScalars();
+
+  // Release the output so that the next column gets a new array
+  this->FFT->SetInputData(NULL);
+  this->FFT->GetOutput()->ReleaseData();
 
   // Return the result
-  return vtkSmartPointer<vtkDataArray>(fft->GetOutput()->GetPointData()->GetScalars());
+  return result;
 }
@@ -40,6 +40,8 @@
 #include "vtkImagingFourierModule.h" // For export macro
 #include "vtkSmartPointer.h"    // For internal method.
 
+class vtkImageFFT;
+
 class VTKIMAGINGFOURIER_EXPORT vtkTableFFT : public vtkTableAlgorithm
 {
 public:
@@ -61,6 +63,9 @@ protected:
   virtual vtkSmartPointer<vtkDataArray> DoFFT(vtkDataArray *input);
 //ETX
 
+  // The FFT filter is kept so that its plans can be reused by all columns.
+  vtkImageFFT *FFT;
+
 private:
   vtkTableFFT(const vtkTableFFT &);     // Not implemented
   void operator=(const vtkTableFFT &);  // Not implemented
@@ -18,9 +18,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <math.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageEuclideanDistance);
 
@@ -554,6 +557,140 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
   free(temp);
   free(sq);
 }
+//----------------------------------------------------------------------------
+// Execute Felzenszwalb's algorithm.
+//
+// P. Felzenszwalb and D. Huttenlocher. Distance Transforms of Sampled
+// Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
+//
+// The squared distance along each row is the lower envelope of the
+// parabolas rooted at each voxel, which is found in linear time.  The rows
+// along the axis are processed in parallel, each thread with its own
+// scratch space, and the results are written back in place.
+//
+namespace {
+
+struct vtkImageEuclideanDistanceScratch
+{
+  std::vector<double> F;
+  std::vector<double> Z;
+  std::vector<int> V;
+};
+
+class vtkImageEuclideanDistanceEnvelope
+{
+public:
+  vtkImageEuclideanDistanceEnvelope(double *data, const int size[3],
+                                    const vtkIdType inc[3], int axis,
+                                    double spacing, double maxDist)
+    : Data(data), Spacing2(spacing*spacing), MaxDist(maxDist)
+  {
+    this->Axis1 = (axis == 0 ? 1 : 0);
+    this->Axis2 = (axis == 2 ? 1 : 2);
+    this->Size = size[axis];
+    this->Size1 = size[this->Axis1];
+    this->Inc = inc[axis];
+    this->Inc1 = inc[this->Axis1];
+    this->Inc2 = inc[this->Axis2];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkImageEuclideanDistanceScratch &scratch = this->Scratch.Local();
+    int n = this->Size;
+    if (static_cast<int>(scratch.V.size()) < n)
+      {
+      scratch.F.resize(n);
+      scratch.Z.resize(n + 1);
+      scratch.V.resize(n);
+      }
+    double *f = &scratch.F[0];
+    double *z = &scratch.Z[0];
+    int *v = &scratch.V[0];
+    double w = this->Spacing2;
+    double maxDist = this->MaxDist;
+    vtkIdType inc = this->Inc;
+
+    for (vtkIdType row = begin; row < end; ++row)
+      {
+      double *ptr = this->Data + (row % this->Size1)*this->Inc1 +
+        (row / this->Size1)*this->Inc2;
+
+      // buffer the row, and find the lower envelope of the parabolas
+      // f[q] + w*(p - q)^2, ignoring those at or beyond the maximum
+      int k = -1;
+      double *tmpPtr = ptr;
+      for (int q = 0; q < n; ++q)
+        {
+        double fq = *tmpPtr;
+        tmpPtr += inc;
+        f[q] = fq;
+        if (fq >= maxDist)
+          {
+          continue;
+          }
+        double dq = q;
+        double h = fq + w*dq*dq;
+        double s = -VTK_DOUBLE_MAX;
+        while (k >= 0)
+          {
+          double dr = v[k];
+          s = (h - (f[v[k]] + w*dr*dr))/(2*w*(dq - dr));
+          if (s > z[k])
+            {
+            break;
+            }
+          --k;
+          }
+        ++k;
+        v[k] = q;
+        z[k] = (k == 0 ? -VTK_DOUBLE_MAX : s);
+        z[k+1] = VTK_DOUBLE_MAX;
+        }
+
+      // sample the envelope, distances beyond the maximum are clamped
+      tmpPtr = ptr;
+      if (k < 0)
+        {
+        for (int p = 0; p < n; ++p)
+          {
+          *tmpPtr = maxDist;
+          tmpPtr += inc;
+          }
+        continue;
+        }
+      int j = 0;
+      for (int p = 0; p < n; ++p)
+        {
+        while (z[j+1] < p)
+          {
+          ++j;
+          }
+        int r = v[j];
+        double dp = p - r;
+        double d = f[r] + w*dp*dp;
+        *tmpPtr = (d < maxDist ? d : maxDist);
+        tmpPtr += inc;
+        }
+      }
+  }
+
+protected:
+  double *Data;
+  int Axis1;
+  int Axis2;
+  int Size;
+  int Size1;
+  vtkIdType Inc;
+  vtkIdType Inc1;
+  vtkIdType Inc2;
+  double Spacing2;
+  double MaxDist;
+  vtkSMPThreadLocal<vtkImageEuclideanDistanceScratch> Scratch;
+};
+
+} // end anonymous namespace
+
 //----------------------------------------------------------------------------
 void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData,
                                                       int outExt[6],
@@ -563,6 +700,90 @@ void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData,
   outData->AllocateScalars(outInfo);
 }
 
+//----------------------------------------------------------------------------
+// The Felzenszwalb algorithm initializes the output from the input and
+// then computes the distances along each axis within the output.
+int vtkImageEuclideanDistance::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (this->Algorithm != VTK_EDT_FELZENSZWALB)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkImageData *inData = vtkImageData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *outData = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  int outExt[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), outExt);
+  this->AllocateOutputScalars(outData, outExt, outInfo);
+
+  vtkDebugMacro(<<"Executing image euclidean distance");
+
+  void *inPtr = inData->GetScalarPointerForExtent(
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT()));
+  double *outPtr = static_cast<double *>(outData->GetScalarPointer());
+
+  if (!inPtr)
+    {
+    vtkErrorMacro(<< "Execute: No scalars for update extent.")
+    return 1;
+    }
+
+  if (outData->GetScalarType() != VTK_DOUBLE ||
+      outData->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro(<< "Execute: Output must be be type double with "
+                  "one component.");
+    return 1;
+    }
+
+  // initialize with the permutation for the first axis, i.e. no permutation
+  this->Iteration = 0;
+  switch (inData->GetScalarType())
+    {
+    vtkTemplateMacro(
+      vtkImageEuclideanDistanceInitialize(this,
+                                          inData,
+                                          static_cast<VTK_TT *>(inPtr),
+                                          outData, outExt, outPtr));
+    default:
+      vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      return 1;
+    }
+
+  int size[3];
+  size[0] = outExt[1] - outExt[0] + 1;
+  size[1] = outExt[3] - outExt[2] + 1;
+  size[2] = outExt[5] - outExt[4] + 1;
+  vtkIdType *inc = outData->GetIncrements();
+
+  for (int axis = 0; axis < this->Dimensionality; ++axis)
+    {
+    double spacing = 1.0;
+    if (this->ConsiderAnisotropy && outData->GetSpacing()[axis] != 0)
+      {
+      spacing = outData->GetSpacing()[axis];
+      }
+
+    vtkImageEuclideanDistanceEnvelope envelope(
+      outPtr, size, inc, axis, spacing, this->MaximumDistance);
+    vtkIdType rows = static_cast<vtkIdType>(size[0])*size[1]*size[2];
+    rows /= size[axis];
+    vtkSMPTools::For(0, rows, envelope);
+
+    this->UpdateProgress((axis + 1.0)/this->Dimensionality);
+    }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the
 // EuclideanDistance algorithm to fill the output from the input.
@@ -747,6 +968,10 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "Saito\n";
     }
+  else if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+    {
+    os << "Felzenszwalb\n";
+    }
   else
     {
     os << "Saito Cached\n";
@@ -29,6 +29,11 @@
 // slow it very significantly. In that case, one should use
 // ::SetAlgorithmToSaitoCached() instead for better performance.
 //
+// For large images, ::SetAlgorithmToFelzenszwalb() computes the same
+// distances in linear time.  It processes all of the axes within the
+// output image instead of producing an intermediate image for each axis,
+// and the rows along each axis are processed in parallel with vtkSMPTools.
+//
 // References:
 //
 // T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance
@@ -38,6 +43,9 @@
 // O. Cuisenaire. Distance Transformation: fast algorithms and applications
 // to medical image processing. PhD Thesis, Universite catholique de Louvain,
 // October 1999. http://ltswww.epfl.ch/~cuisenai/papers/oc_thesis.pdf
+//
+// P. Felzenszwalb and D. Huttenlocher. Distance Transforms of Sampled
+// Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
 
 
 #ifndef __vtkImageEuclideanDistance_h
@@ -48,6 +56,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTKIMAGINGGENERAL_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -93,13 +102,15 @@ public:
   // Selects a Euclidean DT algorithm.
   // 1. Saito
   // 2. Saito-cached
-  // More algorithms will be added later on.
+  // 3. Felzenszwalb (linear time, parallel, no intermediate images)
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
   void SetAlgorithmToSaito ()
     { this->SetAlgorithm(VTK_EDT_SAITO); }
   void SetAlgorithmToSaitoCached ()
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }
+  void SetAlgorithmToFelzenszwalb ()
+    { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }
 
   virtual int IterativeRequestData(vtkInformation*,
                                    vtkInformationVector**,
@@ -119,6 +130,13 @@ protected:
                                      int outExt[6],
                                      vtkInformation* outInfo);
 
+  // Description:
+  // The Felzenszwalb algorithm does all of the axes at once, the other
+  // algorithms do one axis per iteration.
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
   virtual int IterativeRequestInformation(vtkInformation* in,
                                           vtkInformation* out);
   virtual int IterativeRequestUpdateExtent(vtkInformation* in,
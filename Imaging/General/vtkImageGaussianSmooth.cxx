@@ -20,6 +20,10 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <complex>
+#include <vector>
+
 #include <math.h>
 
 vtkStandardNewMacro(vtkImageGaussianSmooth);
@@ -34,6 +38,7 @@ vtkImageGaussianSmooth::vtkImageGaussianSmooth()
   this->RadiusFactors[0] = 1.5;
   this->RadiusFactors[1] = 1.5;
   this->RadiusFactors[2] = 1.5;
+  this->Recursive = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +66,8 @@ void vtkImageGaussianSmooth::PrintSelf(ostream& os, vtkIndent indent)
      << this->StandardDeviations[0] << ", "
      << this->StandardDeviations[1] << ", "
      << this->StandardDeviations[2] << " )\n";
+
+  os << indent << "Recursive: " << (this->Recursive ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -142,110 +149,321 @@ void vtkImageGaussianSmooth::InternalRequestUpdateExtent(int *inExt,
 }
 
 //----------------------------------------------------------------------------
-// For a given position along the convolution axis, this method loops over
-// all other axes, and performs the convolution. Boundary conditions handled
-// previously.
-template <class T>
-void
-vtkImageGaussianSmoothExecute(vtkImageGaussianSmooth *self, int axis,
-                              double *kernel, int kernelSize,
-                              vtkImageData *inData, T *inPtrC,
-                              vtkImageData *outData, int outExt[6],
-                              T *outPtrC, int *pcycle, int target,
-                              int *pcount, int total)
+// The number of lines that are filtered together.  The lines are stored
+// interleaved, so that the inner loops run across the lines.
+#define VTK_GAUSSIAN_SMOOTH_LINES 16
+
+namespace {
+
+// The filter for one axis, for all of the lines along that axis.  The
+// explicit filter stores a kernel for every output sample, but the kernels
+// that are not clipped by the whole extent all share the same weights.
+struct vtkImageGaussianSmoothFilter
+{
+  bool Recursive;
+  // explicit kernels
+  std::vector<double> Weights;
+  std::vector<int> Offset;
+  std::vector<int> Start;
+  std::vector<int> Size;
+  // recursive filter
+  double B;
+  double A[3];
+  double M[9];
+  std::vector<double> Norm;
+};
+
+//----------------------------------------------------------------------------
+// Apply the recursive filter to W interleaved lines of length n, in place.
+// The three rows before the data must be zero, and there must be room for
+// three more rows after the data.  The input is taken to be zero outside
+// of the line, i.e. the forward pass starts from a zero state, and the
+// backward pass starts from the state that the zero input beyond the end
+// of the line would have given.
+template<int W>
+void vtkImageGaussianSmoothRecursiveLines(
+  const vtkImageGaussianSmoothFilter &filter, double *data, int n)
 {
-  int maxC, max0 = 0, max1 = 0;
-  int idxC, idx0, idx1, idxK;
-  vtkIdType *inIncs, *outIncs;
-  vtkIdType inInc0 = 0, inInc1 = 0, inIncK, outInc0 = 0, outInc1 = 0;
-  T *outPtr1, *outPtr0;
-  T *inPtr1, *inPtr0, *inPtrK;
-  double *ptrK, sum;
-
-  // I am counting on the fact that tight loops (component on outside)
-  // is more important than cache misses from shuffled access.
-
-  // Do the correct shuffling of the axes (increments, extents)
-  inIncs = inData->GetIncrements();
-  outIncs = outData->GetIncrements();
-  inIncK = inIncs[axis];
-  maxC = outData->GetNumberOfScalarComponents();
-  switch (axis)
+  const double B = filter.B;
+  const double a0 = filter.A[0];
+  const double a1 = filter.A[1];
+  const double a2 = filter.A[2];
+  const double *M = filter.M;
+
+  // the causal pass
+  double *row = data;
+  for (int k = 0; k < n; k++)
     {
-    case 0:
-      inInc0 = inIncs[1];  inInc1 = inIncs[2];
-      outInc0 = outIncs[1];  outInc1 = outIncs[2];
-      max0 = outExt[3] - outExt[2] + 1;   max1 = outExt[5] - outExt[4] + 1;
-      break;
-    case 1:
-      inInc0 = inIncs[0];  inInc1 = inIncs[2];
-      outInc0 = outIncs[0];  outInc1 = outIncs[2];
-      max0 = outExt[1] - outExt[0] + 1;   max1 = outExt[5] - outExt[4] + 1;
-      break;
-    case 2:
-      inInc0 = inIncs[0];  inInc1 = inIncs[1];
-      outInc0 = outIncs[0];  outInc1 = outIncs[1];
-      max0 = outExt[1] - outExt[0] + 1;   max1 = outExt[3] - outExt[2] + 1;
+    for (int j = 0; j < W; j++)
+      {
+      row[j] = B*row[j] + a0*row[j - W] + a1*row[j - 2*W] + a2*row[j - 3*W];
+      }
+    row += W;
+    }
+
+  // the initial state of the anti-causal pass
+  for (int j = 0; j < W; j++)
+    {
+    double w0 = row[j - W];
+    double w1 = row[j - 2*W];
+    double w2 = row[j - 3*W];
+    row[j] = M[0]*w0 + M[1]*w1 + M[2]*w2;
+    row[j + W] = M[3]*w0 + M[4]*w1 + M[5]*w2;
+    row[j + 2*W] = M[6]*w0 + M[7]*w1 + M[8]*w2;
+    }
+
+  // the anti-causal pass
+  for (int k = 0; k < n; k++)
+    {
+    row -= W;
+    for (int j = 0; j < W; j++)
+      {
+      row[j] = B*row[j] + a0*row[j + W] + a1*row[j + 2*W] + a2*row[j + 3*W];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the coefficients of the third-order recursive gaussian of van
+// Vliet, Young, and Verbeek, "Recursive Gaussian derivative filters", ICPR
+// 1998, and the normalization for a line of length n.  The poles for a
+// standard deviation of two are scaled by solving for the exponent that
+// gives the requested variance.
+void vtkImageGaussianSmoothComputeRecursive(
+  vtkImageGaussianSmoothFilter *filter, double sigma, int n)
+{
+  typedef std::complex<double> complexType;
+  static const complexType poles[3] = {
+    complexType(1.41650, 1.00829),
+    complexType(1.41650, -1.00829),
+    complexType(1.86543, 0.0) };
+
+  // Newton's method for the scale q, with the variance of the filter
+  // being the sum of 2 d/(d - 1)^2 for all the poles d = poles^(1/q)
+  double q = 0.5*sigma;
+  for (int iter = 0; iter < 50; iter++)
+    {
+    complexType v = 0.0;
+    complexType dv = 0.0;
+    for (int i = 0; i < 3; i++)
+      {
+      complexType d = pow(poles[i], 1.0/q);
+      complexType dm = d - 1.0;
+      v += 2.0*d/(dm*dm);
+      dv += 2.0*d*(d + 1.0)*log(poles[i])/(q*q*dm*dm*dm);
+      }
+    double dq = (v.real() - sigma*sigma)/dv.real();
+    q -= dq;
+    if (fabs(dq) < 1e-10*q)
+      {
       break;
+      }
+    }
+
+  // The coefficients of the polynomial with roots at 1/d
+  complexType p[3];
+  for (int i = 0; i < 3; i++)
+    {
+    p[i] = 1.0/pow(poles[i], 1.0/q);
+    }
+  filter->A[0] = (p[0] + p[1] + p[2]).real();
+  filter->A[1] = -(p[0]*p[1] + p[0]*p[2] + p[1]*p[2]).real();
+  filter->A[2] = (p[0]*p[1]*p[2]).real();
+  filter->B = 1.0 - filter->A[0] - filter->A[1] - filter->A[2];
+
+  filter->Recursive = true;
+
+  // The matrix that maps the last three states of the causal pass to the
+  // first three states of the anti-causal pass, found by running the
+  // filter over a tail of zeros that is long enough for the response to
+  // decay to the limit of double precision.
+  int tail = 50 + static_cast<int>(60.0*q);
+  std::vector<double> buffer(tail + 6);
+  double *data = &buffer[3];
+  std::fill(filter->M, filter->M + 9, 0.0);
+  for (int i = 0; i < 3; i++)
+    {
+    std::fill(buffer.begin(), buffer.end(), 0.0);
+    data[-1 - i] = 1.0;
+    vtkImageGaussianSmoothRecursiveLines<1>(*filter, data, tail);
+    filter->M[i] = data[0];
+    filter->M[i + 3] = data[1];
+    filter->M[i + 6] = data[2];
+    }
+
+  // The response to a line of ones, for normalization at the ends
+  buffer.assign(n + 6, 0.0);
+  data = &buffer[3];
+  std::fill(data, data + n, 1.0);
+  vtkImageGaussianSmoothRecursiveLines<1>(*filter, data, n);
+  filter->Norm.resize(n);
+  for (int k = 0; k < n; k++)
+    {
+    filter->Norm[k] = 1.0/data[k];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Apply the explicit kernels to W interleaved lines.
+template<int W>
+void vtkImageGaussianSmoothExplicitLines(
+  const vtkImageGaussianSmoothFilter &filter, const double *inData,
+  double *outData, int n)
+{
+  for (int k = 0; k < n; k++)
+    {
+    const double *kernel = &filter.Weights[filter.Offset[k]];
+    const double *row = inData + filter.Start[k]*W;
+    int size = filter.Size[k];
+    double sum[W];
+    for (int j = 0; j < W; j++)
+      {
+      sum[j] = 0.0;
+      }
+    for (int i = 0; i < size; i++)
+      {
+      double weight = kernel[i];
+      for (int j = 0; j < W; j++)
+        {
+        sum[j] += weight*row[j];
+        }
+      row += W;
+      }
+    for (int j = 0; j < W; j++)
+      {
+      outData[j] = sum[j];
+      }
+    outData += W;
+    }
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+// This method filters all of the lines along the given axis, a few lines
+// at a time.  The lines are copied into an interleaved buffer, filtered,
+// and copied to the output.  The input and output pointers are for the
+// first samples of inExt and outExt, which must be the same along the
+// other two axes.
+template <class T>
+void vtkImageGaussianSmoothExecute(vtkImageGaussianSmooth *self, int axis,
+                                   const vtkImageGaussianSmoothFilter &filter,
+                                   vtkImageData *inData, int inExt[6],
+                                   T *inPtr, vtkImageData *outData,
+                                   int outExt[6], T *outPtr, int *pcycle,
+                                   int target, int *pcount, int total)
+{
+  const int W = VTK_GAUSSIAN_SMOOTH_LINES;
+
+  // The other two axes, the first of which is the faster one
+  int axis1 = (axis == 0 ? 1 : 0);
+  int axis2 = (axis == 2 ? 1 : 2);
+
+  vtkIdType *inIncs = inData->GetIncrements();
+  vtkIdType *outIncs = outData->GetIncrements();
+  int numComp = outData->GetNumberOfScalarComponents();
+  int inSize = inExt[2*axis+1] - inExt[2*axis] + 1;
+  int outSize = outExt[2*axis+1] - outExt[2*axis] + 1;
+  int outStart = outExt[2*axis] - inExt[2*axis];
+  int numLines = numComp*(outExt[2*axis1+1] - outExt[2*axis1] + 1);
+  int numRows = outExt[2*axis2+1] - outExt[2*axis2] + 1;
+
+  // The input lines, with space for the recursive filter before and after
+  std::vector<double> inBuffer((inSize + 6)*W, 0.0);
+  double *inLines = &inBuffer[3*W];
+  std::vector<double> outBuffer;
+  const double *outLines = inLines + outStart*W;
+  if (!filter.Recursive)
+    {
+    outBuffer.resize(outSize*W);
+    outLines = &outBuffer[0];
     }
 
-  for (idxC = 0; idxC < maxC; ++idxC)
+  vtkIdType inOffsets[W];
+  vtkIdType outOffsets[W];
+
+  for (int idx2 = 0; !self->AbortExecute && idx2 < numRows; idx2++)
     {
-    inPtr1 = inPtrC;
-    outPtr1 = outPtrC;
-    for (idx1 = 0; !self->AbortExecute && idx1 < max1; ++idx1)
+    T *inRow = inPtr + idx2*inIncs[axis2];
+    T *outRow = outPtr + idx2*outIncs[axis2];
+
+    for (int line = 0; line < numLines; line += W)
       {
-      inPtr0 = inPtr1;
-      outPtr0 = outPtr1;
-      for (idx0 = 0; idx0 < max0; ++idx0)
+      int n = (numLines - line < W ? numLines - line : W);
+      for (int j = 0; j < n; j++)
+        {
+        int c = (line + j) % numComp;
+        int idx1 = (line + j) / numComp;
+        inOffsets[j] = c + idx1*inIncs[axis1];
+        outOffsets[j] = c + idx1*outIncs[axis1];
+        }
+
+      // Copy the lines into the buffer
+      double *bufPtr = inLines;
+      for (int k = 0; k < inSize; k++)
+        {
+        const T *inSample = inRow + k*inIncs[axis];
+        for (int j = 0; j < n; j++)
+          {
+          bufPtr[j] = static_cast<double>(inSample[inOffsets[j]]);
+          }
+        bufPtr += W;
+        }
+
+      // Filter the lines
+      if (filter.Recursive)
+        {
+        vtkImageGaussianSmoothRecursiveLines<W>(filter, inLines, inSize);
+        }
+      else
         {
-        inPtrK = inPtr0;
-        ptrK = kernel;
-        sum = 0.0;
-        // too bad this short loop has to be the inner most loop
-        for (idxK = 0; idxK < kernelSize; ++idxK)
+        vtkImageGaussianSmoothExplicitLines<W>(
+          filter, inLines, &outBuffer[0], outSize);
+        }
+
+      // Copy the results to the output
+      const double *resultPtr = outLines;
+      for (int k = 0; k < outSize; k++)
+        {
+        T *outSample = outRow + k*outIncs[axis];
+        if (filter.Recursive)
+          {
+          double norm = filter.Norm[outStart + k];
+          for (int j = 0; j < n; j++)
+            {
+            outSample[outOffsets[j]] = static_cast<T>(resultPtr[j]*norm);
+            }
+          }
+        else
           {
-          sum += *ptrK * static_cast<double>(*inPtrK);
-          ++ptrK;
-          inPtrK += inIncK;
+          for (int j = 0; j < n; j++)
+            {
+            outSample[outOffsets[j]] = static_cast<T>(resultPtr[j]);
+            }
           }
-        *outPtr0 = static_cast<T>(sum);
-        inPtr0 += inInc0;
-        outPtr0 += outInc0;
+        resultPtr += W;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
-      // we finished a row ... do we update ???
+
+      // we finished some lines ... do we update ???
       if (total)
         { // yes this is the main thread
-        *pcycle += max0;
+        *pcycle += n*outSize;
         if (*pcycle > target)
           { // yes
           *pcycle -= target;
           *pcount += target;
           self->UpdateProgress(static_cast<double>(*pcount) /
                                static_cast<double>(total));
-          //fprintf(stderr, "count: %d, total: %d, progress: %f\n",
-          //*pcount, total, (double)(*pcount) / (double)total);
           }
         }
       }
-
-    ++inPtrC;
-    ++outPtrC;
     }
 }
 
 //----------------------------------------------------------------------------
-template <class T>
-size_t vtkImageGaussianSmoothGetTypeSize(T*)
-{
-  return sizeof(T);
-}
-
-//----------------------------------------------------------------------------
-// This method convolves over one axis. It loops over the convolved axis,
-// and handles boundary conditions.
+// This method convolves over one axis.  It computes the kernels for all of
+// the positions along the convolved axis, which handles the boundary
+// conditions, and then filters the lines.
 void vtkImageGaussianSmooth::ExecuteAxis(int axis,
                                          vtkImageData *inData, int inExt[6],
                                          vtkImageData *outData, int outExt[6],
@@ -253,108 +471,84 @@ void vtkImageGaussianSmooth::ExecuteAxis(int axis,
                                          int *pcount, int total,
                                          vtkInformation *inInfo)
 {
-  int idxA, max;
   int wholeExtent[6], wholeMax, wholeMin;
-  double *kernel;
-  // previousClip and currentClip rembers that the previous was not clipped
-  // keeps from recomputing kernels for center pixels.
-  int kernelSize = 0;
-  int kernelLeftClip, kernelRightClip;
-  int previousClipped, currentClipped;
-  int radius, size;
-  void *inPtr;
-  void *outPtr;
-  int coords[3];
-  vtkIdType *outIncs, outIncA;
-
-  // Get the correct starting pointer of the output
-  outPtr = outData->GetScalarPointerForExtent(outExt);
-  outIncs = outData->GetIncrements();
-  outIncA = outIncs[axis];
-
-  // trick to account for the scalar type of the output(used to be only float)
-  switch (outData->GetScalarType())
-    {
-    vtkTemplateMacro(
-      outIncA *= vtkImageGaussianSmoothGetTypeSize(static_cast<VTK_TT*>(0))
-      );
-    default:
-      vtkErrorMacro("Unknown scalar type");
-      return;
-    }
-
-  // Determine default starting position of input
-  coords[0] = inExt[0];
-  coords[1] = inExt[2];
-  coords[2] = inExt[4];
+  vtkImageGaussianSmoothFilter filter;
+  double std = this->StandardDeviations[axis];
 
   // get whole extent for boundary checking ...
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
   wholeMin = wholeExtent[axis*2];
   wholeMax = wholeExtent[axis*2+1];
 
-  // allocate memory for the kernel
-  radius = static_cast<int>(this->StandardDeviations[axis]
-                            * this->RadiusFactors[axis]);
-  size = 2*radius + 1;
-  kernel = new double[size];
-
-  // loop over the convolution axis
-  previousClipped = currentClipped = 1;
-  max = outExt[axis*2+1];
-  for (idxA = outExt[axis*2]; idxA <= max; ++idxA)
+  if (this->Recursive && std >= 1.0)
     {
-    // left boundary condition
-    coords[axis] = idxA - radius;
-    kernelLeftClip = wholeMin - coords[axis];
-    if (kernelLeftClip > 0)
-      { // front of kernel is cut off ("kernelStart" samples)
-      coords[axis] += kernelLeftClip;
-      }
-    else
-      {
-      kernelLeftClip = 0;
-      }
-    // Right boundary condition
-    kernelRightClip = (idxA + radius) - wholeMax;
-    if (kernelRightClip < 0)
+    vtkImageGaussianSmoothComputeRecursive(
+      &filter, std, inExt[axis*2+1] - inExt[axis*2] + 1);
+    }
+  else
+    {
+    // previousClipped remembers that the previous kernel was not clipped,
+    // so that the kernel for the center pixels is only computed once.
+    int radius = static_cast<int>(std * this->RadiusFactors[axis]);
+    int size = 2*radius + 1;
+    int outSize = outExt[axis*2+1] - outExt[axis*2] + 1;
+    int previousClipped = 1;
+    int offset = 0;
+    filter.Recursive = false;
+    filter.Offset.resize(outSize);
+    filter.Start.resize(outSize);
+    filter.Size.resize(outSize);
+    for (int k = 0; k < outSize; k++)
       {
-      kernelRightClip = 0;
-      }
+      int idxA = outExt[axis*2] + k;
+      // left boundary condition
+      int kernelLeftClip = wholeMin - (idxA - radius);
+      if (kernelLeftClip < 0)
+        {
+        kernelLeftClip = 0;
+        }
+      // Right boundary condition
+      int kernelRightClip = (idxA + radius) - wholeMax;
+      if (kernelRightClip < 0)
+        {
+        kernelRightClip = 0;
+        }
 
-    // We can only use previous kernel if it is not clipped and new
-    // kernel is also not clipped.
-    currentClipped = kernelLeftClip + kernelRightClip;
-    if (currentClipped || previousClipped)
-      {
-      this->ComputeKernel(kernel, -radius+kernelLeftClip,
-                          radius-kernelRightClip,
-                          static_cast<double>(this->StandardDeviations[axis]));
-      kernelSize = size - kernelLeftClip - kernelRightClip;
-      }
-    previousClipped = currentClipped;
+      // We can only use previous kernel if it is not clipped and new
+      // kernel is also not clipped.
+      int currentClipped = kernelLeftClip + kernelRightClip;
+      if (currentClipped || previousClipped)
+        {
+        offset = static_cast<int>(filter.Weights.size());
+        filter.Weights.resize(offset + size);
+        this->ComputeKernel(&filter.Weights[offset], -radius+kernelLeftClip,
+                            radius-kernelRightClip, std);
+        }
+      previousClipped = currentClipped;
 
-    /* now do the convolution on the rest of the axes */
-    inPtr = inData->GetScalarPointer(coords);
-    switch (inData->GetScalarType())
-      {
-      vtkTemplateMacro(
-        vtkImageGaussianSmoothExecute(this, axis, kernel, kernelSize,
-                                      inData, static_cast<VTK_TT*>(inPtr),
-                                      outData, outExt,
-                                      static_cast<VTK_TT*>(outPtr),
-                                      pcycle, target, pcount, total)
-        );
-      default:
-        vtkErrorMacro("Unknown scalar type");
-        return;
+      filter.Offset[k] = offset;
+      filter.Start[k] = idxA - radius + kernelLeftClip - inExt[axis*2];
+      filter.Size[k] = size - kernelLeftClip - kernelRightClip;
       }
-    outPtr = static_cast<void *>(
-      static_cast<unsigned char *>(outPtr) + outIncA);
     }
 
-  // get rid of temporary kernel
-  delete [] kernel;
+  void *inPtr = inData->GetScalarPointerForExtent(inExt);
+  void *outPtr = outData->GetScalarPointerForExtent(outExt);
+
+  switch (inData->GetScalarType())
+    {
+    vtkTemplateMacro(
+      vtkImageGaussianSmoothExecute(this, axis, filter,
+                                    inData, inExt,
+                                    static_cast<VTK_TT*>(inPtr),
+                                    outData, outExt,
+                                    static_cast<VTK_TT*>(outPtr),
+                                    pcycle, target, pcount, total)
+      );
+    default:
+      vtkErrorMacro("Unknown scalar type");
+      return;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -16,6 +16,10 @@
 // .SECTION Description
 // vtkImageGaussianSmooth implements a convolution of the input image
 // with a gaussian. Supports from one to three dimensional convolutions.
+// Several lines are filtered at once, so that the inner loops run across
+// the lines and can be vectorized by the compiler.  For large standard
+// deviations, the Recursive option gives a filter whose cost does not
+// depend on the size of the gaussian.
 
 #ifndef __vtkImageGaussianSmooth_h
 #define __vtkImageGaussianSmooth_h
@@ -70,6 +74,19 @@ public:
   vtkSetMacro(Dimensionality, int);
   vtkGetMacro(Dimensionality, int);
 
+  // Description:
+  // Use a recursive filter (van Vliet, Young, and Verbeek) instead of
+  // convolving with an explicit kernel.  The recursive filter takes the
+  // same time for any standard deviation, but it is only an approximation
+  // of the gaussian (within a few percent of its peak), and it is not
+  // used along axes where the standard deviation is less than 1.0.  The
+  // RadiusFactors still set how far beyond the output extent the input is
+  // read, and the filter is normalized at the edges of the input just like
+  // the explicit kernel is.  Default: Off.
+  vtkSetMacro(Recursive, int);
+  vtkBooleanMacro(Recursive, int);
+  vtkGetMacro(Recursive, int);
+
 protected:
   vtkImageGaussianSmooth();
   ~vtkImageGaussianSmooth();
@@ -77,6 +94,7 @@ protected:
   int Dimensionality;
   double StandardDeviations[3];
   double RadiusFactors[3];
+  int Recursive;
 
   void ComputeKernel(double *kernel, int min, int max, double std);
   virtual int RequestUpdateExtent (vtkInformation *, vtkInformationVector **, vtkInformationVector *);
@@ -22,6 +22,10 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTypeTraits.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageMedian3D);
 
@@ -369,6 +373,155 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
   delete [] Sort;
 }
 
+//-----------------------------------------------------------------------------
+// Add (delta = 1) or remove (delta = -1) the samples in one YZ slice of
+// the neighborhood to or from the histogram.
+template <class T>
+void vtkImageMedian3DHistogramSlice(const T *inPtr, const vtkIdType inInc[3],
+                                    int ny, int nz, int delta, int minValue,
+                                    int shift, int *fine, int *coarse)
+{
+  for (int idx2 = 0; idx2 < nz; ++idx2)
+    {
+    const T *tmpPtr = inPtr;
+    for (int idx1 = 0; idx1 < ny; ++idx1)
+      {
+      int bin = static_cast<int>(*tmpPtr) - minValue;
+      fine[bin] += delta;
+      coarse[bin >> shift] += delta;
+      tmpPtr += inInc[1];
+      }
+    inPtr += inInc[2];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// For 8-bit and 16-bit integer types, the median is found with a histogram
+// of the neighborhood that is updated as the neighborhood slides along X.
+// A coarse histogram with one bin per 2^(bits/2) values makes the search
+// for the median take at most 2^(bits/2 + 1) steps.
+template <class T>
+void vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                      vtkImageData *inData,
+                                      vtkImageData *outData, T *outPtr,
+                                      int outExt[6], int id,
+                                      vtkDataArray *inArray)
+{
+  const int bits = 8*static_cast<int>(sizeof(T));
+  const int shift = bits/2;
+  const int numBins = (1 << bits);
+  const int minValue = static_cast<int>(vtkTypeTraits<T>::Min());
+  std::vector<int> fine(numBins, 0);
+  std::vector<int> coarse(numBins >> shift, 0);
+
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int numComp = inArray->GetNumberOfComponents();
+  int *inExt = inData->GetExtent();
+  vtkIdType inInc[3], outIncX, outIncY, outIncZ;
+  inData->GetIncrements(inArray, inInc);
+  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
+  T *inPtr = static_cast<T *>(inArray->GetVoidPointer(0));
+
+  // The neighborhood for each output voxel, clipped by the input extent
+  int hoodMin[3], hoodMax[3];
+  for (int j = 0; j < 3; j++)
+    {
+    hoodMin[j] = -kernelMiddle[j];
+    hoodMax[j] = hoodMin[j] + kernelSize[j] - 1;
+    }
+
+  unsigned long count = 0;
+  unsigned long target = static_cast<unsigned long>(
+    (outExt[5] - outExt[4] + 1)*(outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  int ymin = 0, ymax = 0, zmin = 0, zmax = 0;
+  T *slicePtr = 0;
+
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+    {
+    zmin = std::max(outIdx2 + hoodMin[2], inExt[4]);
+    zmax = std::min(outIdx2 + hoodMax[2], inExt[5]);
+    for (int outIdx1 = outExt[2];
+         !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      ymin = std::max(outIdx1 + hoodMin[1], inExt[2]);
+      ymax = std::min(outIdx1 + hoodMax[1], inExt[3]);
+      int area = (ymax - ymin + 1)*(zmax - zmin + 1);
+
+      for (int outIdxC = 0; outIdxC < numComp; outIdxC++)
+        {
+        slicePtr = inPtr + ((ymin - inExt[2])*inInc[1] +
+                            (zmin - inExt[4])*inInc[2] + outIdxC);
+        T *outPtr0 = outPtr + outIdxC;
+
+        // The samples in the histogram are from xmin to xmax
+        int xmin = std::max(outExt[0] + hoodMin[0], inExt[0]);
+        int xmax = xmin - 1;
+        for (int outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
+          {
+          int xlo = std::max(outIdx0 + hoodMin[0], inExt[0]);
+          int xhi = std::min(outIdx0 + hoodMax[0], inExt[1]);
+          for (; xmin < xlo; ++xmin)
+            {
+            vtkImageMedian3DHistogramSlice(
+              slicePtr + (xmin - inExt[0])*inInc[0], inInc,
+              ymax - ymin + 1, zmax - zmin + 1, -1, minValue, shift,
+              &fine[0], &coarse[0]);
+            }
+          while (xmax < xhi)
+            {
+            ++xmax;
+            vtkImageMedian3DHistogramSlice(
+              slicePtr + (xmax - inExt[0])*inInc[0], inInc,
+              ymax - ymin + 1, zmax - zmin + 1, 1, minValue, shift,
+              &fine[0], &coarse[0]);
+            }
+
+          // Find the sample at the middle of the sorted samples
+          int rank = (xmax - xmin + 1)*area/2;
+          int bin = 0;
+          while (rank >= coarse[bin])
+            {
+            rank -= coarse[bin];
+            bin++;
+            }
+          bin <<= shift;
+          while (rank >= fine[bin])
+            {
+            rank -= fine[bin];
+            bin++;
+            }
+
+          *outPtr0 = static_cast<T>(bin + minValue);
+          outPtr0 += numComp;
+          }
+
+        // Empty the histogram for the next row
+        for (; xmin <= xmax; ++xmin)
+          {
+          vtkImageMedian3DHistogramSlice(
+            slicePtr + (xmin - inExt[0])*inInc[0], inInc,
+            ymax - ymin + 1, zmax - zmin + 1, -1, minValue, shift,
+            &fine[0], &coarse[0]);
+          }
+        }
+
+      outPtr += numComp*(outExt[1] - outExt[0] + 1) + outIncY;
+      }
+    outPtr += outIncZ;
+    }
+}
+
 //-----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output region types.
@@ -400,6 +553,36 @@ void vtkImageMedian3D::ThreadedRequestData(
     return;
     }
 
+  // use a sliding histogram for 8-bit and 16-bit integers
+  switch (inArray->GetDataType())
+    {
+    case VTK_CHAR:
+      vtkImageMedian3DHistogramExecute(this, inData[0][0], outData[0],
+                                       static_cast<char *>(outPtr),
+                                       outExt, id, inArray);
+      return;
+    case VTK_SIGNED_CHAR:
+      vtkImageMedian3DHistogramExecute(this, inData[0][0], outData[0],
+                                       static_cast<signed char *>(outPtr),
+                                       outExt, id, inArray);
+      return;
+    case VTK_UNSIGNED_CHAR:
+      vtkImageMedian3DHistogramExecute(this, inData[0][0], outData[0],
+                                       static_cast<unsigned char *>(outPtr),
+                                       outExt, id, inArray);
+      return;
+    case VTK_SHORT:
+      vtkImageMedian3DHistogramExecute(this, inData[0][0], outData[0],
+                                       static_cast<short *>(outPtr),
+                                       outExt, id, inArray);
+      return;
+    case VTK_UNSIGNED_SHORT:
+      vtkImageMedian3DHistogramExecute(this, inData[0][0], outData[0],
+                                       static_cast<unsigned short *>(outPtr),
+                                       outExt, id, inArray);
+      return;
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
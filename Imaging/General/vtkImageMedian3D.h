@@ -19,6 +19,12 @@
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
 // into a 2D median.
+//
+// For 8-bit and 16-bit integer data, a histogram of the neighborhood is
+// kept as the neighborhood slides along each row, so the time per voxel
+// grows with the area of the kernel rather than its volume.  When the
+// neighborhood has an even number of samples, such as at the boundaries,
+// the larger of the two middle values is used.
 
 
 #ifndef __vtkImageMedian3D_h
@@ -0,0 +1,386 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSplatters.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the parallel splatters
+// .SECTION Description
+// Compares the output of vtkGaussianSplatter, vtkShepardMethod, and
+// vtkFastSplatter with the output of a simple serial splat of each point
+// in turn.  The volumes have many slices so that many slabs are used.
+
+#include "vtkDoubleArray.h"
+#include "vtkFastSplatter.h"
+#include "vtkFloatArray.h"
+#include "vtkGaussianSplatter.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkShepardMethod.h"
+
+#include <math.h>
+#include <vector>
+
+namespace {
+
+bool CompareValues(double value, double expected, const char *name,
+                   vtkIdType idx)
+{
+  double tol = 1e-12*(fabs(expected) + 1.0);
+  if (!(fabs(value - expected) <= tol) && value != expected)
+    {
+    cerr << name << " gave " << value << " instead of " << expected
+         << " at index " << idx << endl;
+    return false;
+    }
+  return true;
+}
+
+bool TestGaussianSplatter(vtkPolyData *data, int mode, bool normals)
+{
+  const int dims[3] = { 23, 19, 101 };
+  const double bounds[6] = { -0.1, 1.1, -0.1, 1.1, -0.1, 1.1 };
+  const double radius = 0.04;
+  const double exponentFactor = -3.0;
+  const double scaleFactor = 2.0;
+  const double eccentricity = 2.5;
+
+  vtkNew<vtkGaussianSplatter> splatter;
+  splatter->SetInputData(data);
+  splatter->SetSampleDimensions(dims[0], dims[1], dims[2]);
+  splatter->SetModelBounds(bounds[0], bounds[1], bounds[2], bounds[3],
+                           bounds[4], bounds[5]);
+  splatter->SetRadius(radius);
+  splatter->SetExponentFactor(exponentFactor);
+  splatter->SetScaleFactor(scaleFactor);
+  splatter->SetEccentricity(eccentricity);
+  splatter->SetNormalWarping(normals);
+  splatter->ScalarWarpingOn();
+  splatter->CappingOn();
+  splatter->SetCapValue(-1.0);
+  splatter->SetNullValue(-2.0);
+  splatter->SetAccumulationMode(mode);
+  splatter->Update();
+
+  // Splat each point serially
+  double spacing[3];
+  double maxDist = 0.0;
+  for (int i = 0; i < 3; i++)
+    {
+    spacing[i] = (bounds[2*i+1] - bounds[2*i])/(dims[i] - 1);
+    maxDist = (bounds[2*i+1] - bounds[2*i] > maxDist ?
+               bounds[2*i+1] - bounds[2*i] : maxDist);
+    }
+  maxDist *= radius;
+  double radius2 = maxDist*maxDist;
+  vtkIdType n = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  std::vector<double> expected(n, -2.0);
+  std::vector<bool> visited(n, false);
+
+  vtkDataArray *scalars = data->GetPointData()->GetScalars();
+  vtkDataArray *inNormals = data->GetPointData()->GetNormals();
+  for (vtkIdType ptId = 0; ptId < data->GetNumberOfPoints(); ptId++)
+    {
+    double p[3], nv[3];
+    data->GetPoint(ptId, p);
+    inNormals->GetTuple(ptId, nv);
+    double mag = sqrt(vtkMath::Dot(nv, nv));
+    double factor = scaleFactor*scalars->GetComponent(ptId, 0);
+    int min[3], max[3];
+    for (int i = 0; i < 3; i++)
+      {
+      double loc = (p[i] - bounds[2*i])/spacing[i];
+      min[i] = static_cast<int>(floor(loc - maxDist/spacing[i]));
+      max[i] = static_cast<int>(ceil(loc + maxDist/spacing[i]));
+      min[i] = (min[i] < 0 ? 0 : min[i]);
+      max[i] = (max[i] >= dims[i] ? dims[i] - 1 : max[i]);
+      }
+    for (int k = min[2]; k <= max[2]; k++)
+      {
+      for (int j = min[1]; j <= max[1]; j++)
+        {
+        for (int i = min[0]; i <= max[0]; i++)
+          {
+          double v[3];
+          v[0] = bounds[0] + spacing[0]*i - p[0];
+          v[1] = bounds[2] + spacing[1]*j - p[1];
+          v[2] = bounds[4] + spacing[2]*k - p[2];
+          double dist2 = vtkMath::Dot(v, v);
+          if (normals)
+            {
+            double z2 = vtkMath::Dot(v, nv)/mag;
+            z2 = z2*z2;
+            dist2 = (dist2 - z2)/(eccentricity*eccentricity) + z2;
+            }
+          if (dist2 <= radius2)
+            {
+            vtkIdType idx = i + dims[0]*(j + static_cast<vtkIdType>(dims[1])*k);
+            double value = factor*exp(exponentFactor*dist2/radius2);
+            if (!visited[idx])
+              {
+              visited[idx] = true;
+              expected[idx] = value;
+              }
+            else if (mode == VTK_ACCUMULATION_MODE_MIN)
+              {
+              expected[idx] = (expected[idx] < value ? expected[idx] : value);
+              }
+            else if (mode == VTK_ACCUMULATION_MODE_MAX)
+              {
+              expected[idx] = (expected[idx] > value ? expected[idx] : value);
+              }
+            else
+              {
+              expected[idx] += value;
+              }
+            }
+          }
+        }
+      }
+    }
+
+  vtkDataArray *result = splatter->GetOutput()->GetPointData()->GetScalars();
+  vtkIdType idx = 0;
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++)
+        {
+        double value = expected[idx];
+        if (i == 0 || i == dims[0] - 1 || j == 0 || j == dims[1] - 1 ||
+            k == 0 || k == dims[2] - 1)
+          {
+          value = -1.0;
+          }
+        if (!CompareValues(result->GetComponent(idx, 0), value,
+                           "vtkGaussianSplatter", idx))
+          {
+          return false;
+          }
+        idx++;
+        }
+      }
+    }
+
+  return true;
+}
+
+bool TestShepardMethod(vtkPolyData *data)
+{
+  const int dims[3] = { 17, 15, 83 };
+  const double bounds[6] = { -0.1, 1.1, -0.1, 1.1, -0.1, 1.1 };
+  const double maximumDistance = 0.06;
+
+  vtkNew<vtkShepardMethod> shepard;
+  shepard->SetInputData(data);
+  shepard->SetSampleDimensions(dims[0], dims[1], dims[2]);
+  shepard->SetModelBounds(bounds[0], bounds[1], bounds[2], bounds[3],
+                          bounds[4], bounds[5]);
+  shepard->SetMaximumDistance(maximumDistance);
+  shepard->SetNullValue(-5.0);
+  shepard->Update();
+
+  double spacing[3];
+  for (int i = 0; i < 3; i++)
+    {
+    spacing[i] = (bounds[2*i+1] - bounds[2*i])/(dims[i] - 1);
+    }
+  double maxDist = maximumDistance*(bounds[1] - bounds[0]);
+  vtkIdType n = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  std::vector<float> values(n, 0.0f);
+  std::vector<double> sum(n, 0.0);
+
+  vtkDataArray *scalars = data->GetPointData()->GetScalars();
+  for (vtkIdType ptId = 0; ptId < data->GetNumberOfPoints(); ptId++)
+    {
+    double p[3];
+    data->GetPoint(ptId, p);
+    double s = scalars->GetComponent(ptId, 0);
+    int min[3], max[3];
+    for (int i = 0; i < 3; i++)
+      {
+      min[i] = static_cast<int>((p[i] - maxDist - bounds[2*i])/spacing[i]);
+      max[i] = static_cast<int>((p[i] + maxDist - bounds[2*i])/spacing[i]);
+      min[i] = (min[i] < 0 ? 0 : min[i]);
+      max[i] = (max[i] >= dims[i] ? dims[i] - 1 : max[i]);
+      }
+    for (int k = min[2]; k <= max[2]; k++)
+      {
+      for (int j = min[1]; j <= max[1]; j++)
+        {
+        for (int i = min[0]; i <= max[0]; i++)
+          {
+          double x[3];
+          x[0] = spacing[0]*i + bounds[0];
+          x[1] = spacing[1]*j + bounds[2];
+          x[2] = spacing[2]*k + bounds[4];
+          vtkIdType idx = i + dims[0]*(j + static_cast<vtkIdType>(dims[1])*k);
+          double d2 = vtkMath::Distance2BetweenPoints(x, p);
+          sum[idx] += 1.0/d2;
+          values[idx] = static_cast<float>(values[idx] + s/d2);
+          }
+        }
+      }
+    }
+
+  vtkDataArray *result = shepard->GetOutput()->GetPointData()->GetScalars();
+  for (vtkIdType idx = 0; idx < n; idx++)
+    {
+    float value = (sum[idx] != 0.0 ?
+                   static_cast<float>(values[idx]/sum[idx]) : -5.0f);
+    if (static_cast<float>(result->GetComponent(idx, 0)) != value)
+      {
+      cerr << "vtkShepardMethod gave " << result->GetComponent(idx, 0)
+           << " instead of " << value << " at index " << idx << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+bool TestFastSplatter(vtkPolyData *data)
+{
+  const int dims[3] = { 21, 18, 77 };
+  const int splatDims[3] = { 5, 4, 7 };
+
+  vtkNew<vtkImageData> splatImage;
+  splatImage->SetDimensions(splatDims[0], splatDims[1], splatDims[2]);
+  splatImage->AllocateScalars(VTK_DOUBLE, 1);
+  double *splat = static_cast<double *>(splatImage->GetScalarPointer());
+  for (int i = 0; i < splatDims[0]*splatDims[1]*splatDims[2]; i++)
+    {
+    splat[i] = vtkMath::Random(0.0, 1.0);
+    }
+
+  vtkNew<vtkFastSplatter> splatter;
+  splatter->SetInputData(0, data);
+  splatter->SetInputData(1, splatImage.GetPointer());
+  splatter->SetOutputDimensions(dims[0], dims[1], dims[2]);
+  splatter->SetModelBounds(0.0, 1.0, 0.0, 1.0, 0.0, 1.0);
+  splatter->Update();
+
+  // Splat each point serially
+  vtkIdType n = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  std::vector<double> expected(n, 0.0);
+  int numPoints = 0;
+  for (vtkIdType ptId = 0; ptId < data->GetNumberOfPoints(); ptId++)
+    {
+    double p[3];
+    data->GetPoint(ptId, p);
+    int loc[3];
+    bool inside = true;
+    for (int i = 0; i < 3; i++)
+      {
+      loc[i] = static_cast<int>(p[i]*(dims[i] - 1) + 0.5);
+      inside &= (loc[i] >= 0 && loc[i] < dims[i]);
+      }
+    if (!inside)
+      {
+      continue;
+      }
+    numPoints++;
+    for (int k = 0; k < splatDims[2]; k++)
+      {
+      int z = loc[2] + k - splatDims[2]/2;
+      for (int j = 0; j < splatDims[1]; j++)
+        {
+        int y = loc[1] + j - splatDims[1]/2;
+        for (int i = 0; i < splatDims[0]; i++)
+          {
+          int x = loc[0] + i - splatDims[0]/2;
+          if (x >= 0 && x < dims[0] && y >= 0 && y < dims[1] &&
+              z >= 0 && z < dims[2])
+            {
+            expected[x + dims[0]*(y + dims[1]*z)] +=
+              splat[i + splatDims[0]*(j + splatDims[1]*k)];
+            }
+          }
+        }
+      }
+    }
+
+  if (splatter->GetNumberOfPointsSplatted() != numPoints)
+    {
+    cerr << "vtkFastSplatter splatted " <<
+      splatter->GetNumberOfPointsSplatted() << " points instead of "
+         << numPoints << endl;
+    return false;
+    }
+
+  // The sums are done in a different order, so allow for roundoff
+  double *result = static_cast<double *>(
+    splatter->GetOutput()->GetScalarPointer());
+  for (vtkIdType idx = 0; idx < n; idx++)
+    {
+    if (fabs(result[idx] - expected[idx]) > 1e-10)
+      {
+      cerr << "vtkFastSplatter gave " << result[idx] << " instead of "
+           << expected[idx] << " at index " << idx << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+}
+
+int TestSplatters(int, char *[])
+{
+  vtkMath::RandomSeed(24680);
+
+  // Points with scalars and normals, a few of which are outside the bounds
+  const vtkIdType numPts = 2000;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  vtkNew<vtkDoubleArray> normals;
+  normals->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    points->InsertNextPoint(vtkMath::Random(-0.05, 1.02),
+                            vtkMath::Random(-0.05, 1.02),
+                            vtkMath::Random(-0.05, 1.02));
+    scalars->InsertNextValue(vtkMath::Random(0.5, 2.0));
+    double n[3];
+    n[0] = vtkMath::Random(-1.0, 1.0);
+    n[1] = vtkMath::Random(-1.0, 1.0);
+    n[2] = vtkMath::Random(-1.0, 1.0) + 0.01;
+    normals->InsertNextTuple(n);
+    }
+  vtkNew<vtkPolyData> data;
+  data->SetPoints(points.GetPointer());
+  data->GetPointData()->SetScalars(scalars.GetPointer());
+  data->GetPointData()->SetNormals(normals.GetPointer());
+
+  for (int mode = VTK_ACCUMULATION_MODE_MIN;
+       mode <= VTK_ACCUMULATION_MODE_SUM; mode++)
+    {
+    if (!TestGaussianSplatter(data.GetPointer(), mode, false) ||
+        !TestGaussianSplatter(data.GetPointer(), mode, true))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  if (!TestShepardMethod(data.GetPointer()) ||
+      !TestFastSplatter(data.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPointSet.h"
+#include "vtkSplatterInternals.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedIntArray.h"
 
@@ -263,89 +264,129 @@ void vtkFastSplatterBucketPoints(const T *points, vtkIdType numPoints,
 
 //-----------------------------------------------------------------------------
 
+// Splat the buckets in one slice of the bucket image into the output.
+// Only the given output slices are written, so that slabs of the output
+// can be done in parallel.
 template<class T>
-void vtkFastSplatterConvolve(T *splat, const int splatDims[3],
-                             unsigned int *buckets, T *output,
-                             int *numPointsSplatted,
-                             const int imageDims[3])
+class vtkFastSplatterSlice
 {
-  int numPoints = 0;
+public:
+  const T *SplatPtr;
+  const int *SplatDims;
+  const unsigned int *Buckets;
+  T *Output;
+  const int *ImageDims;
+  int SplatCenter[3];
+
+  void GetSlices(vtkIdType k, int &zmin, int &zmax)
+  {
+    zmin = static_cast<int>(k) - this->SplatCenter[2];
+    zmax = zmin + this->SplatDims[2] - 1;
+  }
+
+  void Splat(vtkIdType k, int zmin, int zmax);
+};
 
-  // First, clear out the output image.
-  std::fill_n(output, imageDims[0]*imageDims[1]*imageDims[2],
-                 static_cast<T>(0));
-
-  int splatCenter[3];
-  splatCenter[0] = splatDims[0]/2;
-  splatCenter[1] = splatDims[1]/2;
-  splatCenter[2] = splatDims[2]/2;
+//-----------------------------------------------------------------------------
 
-  // Iterate over all entries in buckets and splat anything that is nonzero.
-  unsigned int *b = buckets;
-  for (int k = 0; k < imageDims[2]; k++)
+template<class T>
+void vtkFastSplatterSlice<T>::Splat(vtkIdType k, int zmin, int zmax)
+{
+  const int *splatDims = this->SplatDims;
+  const int *imageDims = this->ImageDims;
+  const int *splatCenter = this->SplatCenter;
+  const T *splat = this->SplatPtr;
+  T *output = this->Output;
+
+  const unsigned int *b = this->Buckets + k*imageDims[0]*imageDims[1];
+  for (int j = 0; j < imageDims[1]; j++)
     {
     // Figure out how splat projects on image in this slab, taking into
     // account overlap.
-    int splatProjMinZ = k - splatCenter[2];
-    int splatProjMaxZ = splatProjMinZ + splatDims[2];
-    if (splatProjMinZ < 0) splatProjMinZ = 0;
-    if (splatProjMaxZ > imageDims[2]) splatProjMaxZ = imageDims[2];
+    int splatProjMinY = j - splatCenter[1];
+    int splatProjMaxY = splatProjMinY + splatDims[1];
+    if (splatProjMinY < 0) splatProjMinY = 0;
+    if (splatProjMaxY > imageDims[1]) splatProjMaxY = imageDims[1];
 
-    for (int j = 0; j < imageDims[1]; j++)
+    for (int i = 0; i < imageDims[0]; i++)
       {
-      // Figure out how splat projects on image in this slab, taking into
-      // account overlap.
-      int splatProjMinY = j - splatCenter[1];
-      int splatProjMaxY = splatProjMinY + splatDims[1];
-      if (splatProjMinY < 0) splatProjMinY = 0;
-      if (splatProjMaxY > imageDims[1]) splatProjMaxY = imageDims[1];
-
-      for (int i = 0; i < imageDims[0]; i++)
+      // No need to splat 0.
+      if (*b == 0)
         {
-        // No need to splat 0.
-        if (*b == 0)
-          {
-          b++;
-          continue;
-          }
-
-        T value = static_cast<T>(*b);
-        numPoints += static_cast<int>(*b);
         b++;
+        continue;
+        }
+
+      T value = static_cast<T>(*b);
+      b++;
 
-        // Figure out how splat projects on image in this pixel, taking into
-        // account overlap.
-        int splatProjMinX = i - splatCenter[0];
-        int splatProjMaxX = splatProjMinX + splatDims[0];
-        if (splatProjMinX < 0) splatProjMinX = 0;
-        if (splatProjMaxX > imageDims[0]) splatProjMaxX = imageDims[0];
+      // Figure out how splat projects on image in this pixel, taking into
+      // account overlap.
+      int splatProjMinX = i - splatCenter[0];
+      int splatProjMaxX = splatProjMinX + splatDims[0];
+      if (splatProjMinX < 0) splatProjMinX = 0;
+      if (splatProjMaxX > imageDims[0]) splatProjMaxX = imageDims[0];
 
-        // Do the splat.
-        for (int imageZ = splatProjMinZ; imageZ < splatProjMaxZ; imageZ++)
+      // Do the splat.
+      for (int imageZ = zmin; imageZ <= zmax; imageZ++)
+        {
+        int imageZOffset = imageZ*imageDims[0]*imageDims[1];
+        int splatZ = imageZ - static_cast<int>(k) + splatCenter[2];
+        int splatZOffset = splatZ*splatDims[0]*splatDims[1];
+        for (int imageY = splatProjMinY; imageY < splatProjMaxY; imageY++)
           {
-          int imageZOffset = imageZ*imageDims[0]*imageDims[1];
-          int splatZ = imageZ - k + splatCenter[2];
-          int splatZOffset = splatZ*splatDims[0]*splatDims[1];
-          for (int imageY = splatProjMinY; imageY < splatProjMaxY; imageY++)
+          int imageYOffset = imageZOffset + imageY*imageDims[0];
+          int splatY = imageY - j + splatCenter[1];
+          int splatYOffset = splatZOffset + splatY*splatDims[0];
+          for (int imageX = splatProjMinX; imageX < splatProjMaxX; imageX++)
             {
-            int imageYOffset = imageZOffset + imageY*imageDims[0];
-            int splatY = imageY - j + splatCenter[1];
-            int splatYOffset = splatZOffset + splatY*splatDims[0];
-            for (int imageX = splatProjMinX; imageX < splatProjMaxX; imageX++)
-              {
-              int imageOffset = imageYOffset + imageX;
-              int splatX = imageX - i + splatCenter[0];
-              int splatOffset = splatYOffset + splatX;
-              output[imageOffset] += value * splat[splatOffset];
-              }
+            int imageOffset = imageYOffset + imageX;
+            int splatX = imageX - i + splatCenter[0];
+            int splatOffset = splatYOffset + splatX;
+            output[imageOffset] += value * splat[splatOffset];
             }
           }
         }
       }
     }
-  *numPointsSplatted = numPoints;
 }
 
+//-----------------------------------------------------------------------------
+
+template<class T>
+void vtkFastSplatterConvolve(T *splat, const int splatDims[3],
+                             unsigned int *buckets, T *output,
+                             int *numPointsSplatted,
+                             const int imageDims[3])
+{
+  vtkIdType imageSize =
+    static_cast<vtkIdType>(imageDims[0])*imageDims[1]*imageDims[2];
+
+  // First, clear out the output image.
+  std::fill_n(output, imageSize, static_cast<T>(0));
+
+  // Count the points that have been splatted.
+  int numPoints = 0;
+  for (vtkIdType i = 0; i < imageSize; i++)
+    {
+    numPoints += static_cast<int>(buckets[i]);
+    }
+
+  // Splat each slice of the buckets, with the output divided into slabs
+  // that are done in parallel.
+  vtkFastSplatterSlice<T> slice;
+  slice.SplatPtr = splat;
+  slice.SplatDims = splatDims;
+  slice.Buckets = buckets;
+  slice.Output = output;
+  slice.ImageDims = imageDims;
+  slice.SplatCenter[0] = splatDims[0]/2;
+  slice.SplatCenter[1] = splatDims[1]/2;
+  slice.SplatCenter[2] = splatDims[2]/2;
+  vtkSplatterExecute(slice, imageDims[2], imageDims[2], splatDims[2]);
+
+  *numPointsSplatted = numPoints;
+}
 
 //-----------------------------------------------------------------------------
 
@@ -32,6 +32,9 @@
 // Use input port 0 for the impulse data (vtkPointSet), and input port 1 for
 // the splat image (vtkImageData)
 //
+// The convolution is done in parallel with vtkSMPTools, by dividing the
+// output into slabs along z that are each written by a single thread.
+//
 // .SECTION Bugs
 //
 // Any point outside of the extents of the image is thrown away, even if it is
@@ -21,11 +21,190 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
+#include "vtkSplatterInternals.h"
 
+#include <algorithm>
+#include <vector>
 #include <math.h>
 
 vtkStandardNewMacro(vtkGaussianSplatter);
 
+namespace {
+
+//----------------------------------------------------------------------------
+// The magnitude of a normal, or one if the normal is zero
+inline double vtkGaussianSplatterMagnitude(const double n[3])
+{
+  double mag = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+  if ( mag != 1.0 )
+    {
+    mag = (mag == 0.0 ? 1.0 : sqrt(mag));
+    }
+  return mag;
+}
+
+//----------------------------------------------------------------------------
+// Gaussian sampling: the squared distance from the point to the sample
+inline double vtkGaussianSplatterDistance2(const double p[3],
+                                           const double cx[3])
+{
+  return ((cx[0]-p[0])*(cx[0]-p[0]) + (cx[1]-p[1])*(cx[1]-p[1]) +
+          (cx[2]-p[2])*(cx[2]-p[2]));
+}
+
+//----------------------------------------------------------------------------
+// Ellipsoidal Gaussian sampling: the squared distance, with the part
+// across the normal divided by the squared eccentricity
+inline double vtkGaussianSplatterEccentricDistance2(
+  const double p[3], const double n[3], double mag, double eccentricity2,
+  const double cx[3])
+{
+  double v[3];
+  v[0] = cx[0] - p[0];
+  v[1] = cx[1] - p[1];
+  v[2] = cx[2] - p[2];
+  double r2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+  double z2 = (v[0]*n[0] + v[1]*n[1] + v[2]*n[2])/mag;
+  z2 = z2*z2;
+  return (r2 - z2)/eccentricity2 + z2;
+}
+
+//----------------------------------------------------------------------------
+// Combine a splat value with what is already at the sample
+inline void vtkGaussianSplatterAccumulate(double *output, char *visited,
+                                          vtkIdType idx, double value,
+                                          int accumulationMode)
+{
+  if ( ! visited[idx] )
+    {
+    visited[idx] = 1;
+    output[idx] = value;
+    }
+  else
+    {
+    double s = output[idx];
+    switch (accumulationMode)
+      {
+      case VTK_ACCUMULATION_MODE_MIN:
+        output[idx] = (s < value ? s : value);
+        break;
+      case VTK_ACCUMULATION_MODE_MAX:
+        output[idx] = (s > value ? s : value);
+        break;
+      case VTK_ACCUMULATION_MODE_SUM:
+        output[idx] = s + value;
+        break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Splat the points into the volume.  The splat of a point only writes to
+// the slices that it is given, so different slabs can be done at once.
+class vtkGaussianSplatterSplat
+{
+public:
+  vtkPoints *Points;
+  vtkDataArray *Normals; // NULL unless normal warping is used
+  vtkDataArray *Scalars; // NULL unless scalar warping is used
+  double *Output;
+  char *Visited;
+  int Dimensions[3];
+  double Origin[3];
+  double Spacing[3];
+  double SplatDistance[3];
+  double Radius2;
+  double Eccentricity2;
+  double ScaleFactor;
+  double ExponentFactor;
+  int AccumulationMode;
+
+  void GetSlices(vtkIdType ptId, int &zmin, int &zmax)
+  {
+    double p[3];
+    this->Points->GetPoint(ptId, p);
+    double loc = (p[2] - this->Origin[2]) / this->Spacing[2];
+    zmin = static_cast<int>(floor(loc - this->SplatDistance[2]));
+    zmax = static_cast<int>(ceil(loc + this->SplatDistance[2]));
+  }
+
+  void Splat(vtkIdType ptId, int zmin, int zmax);
+};
+
+//----------------------------------------------------------------------------
+void vtkGaussianSplatterSplat::Splat(vtkIdType ptId, int zmin, int zmax)
+{
+  double p[3], n[3], cx[3];
+  this->Points->GetPoint(ptId, p);
+
+  // The normal, for elliptical splats
+  double mag = 1.0;
+  if ( this->Normals )
+    {
+    this->Normals->GetTuple(ptId, n);
+    mag = vtkGaussianSplatterMagnitude(n);
+    }
+
+  double factor = this->ScaleFactor;
+  if ( this->Scalars )
+    {
+    factor = this->ScaleFactor * this->Scalars->GetComponent(ptId, 0);
+    }
+
+  // Determine splat footprint
+  int min[2], max[2];
+  for (int i=0; i<2; i++)
+    {
+    double loc = (p[i] - this->Origin[i]) / this->Spacing[i];
+    min[i] = static_cast<int>(floor(loc - this->SplatDistance[i]));
+    max[i] = static_cast<int>(ceil(loc + this->SplatDistance[i]));
+    if ( min[i] < 0 )
+      {
+      min[i] = 0;
+      }
+    if ( max[i] >= this->Dimensions[i] )
+      {
+      max[i] = this->Dimensions[i] - 1;
+      }
+    }
+
+  // Loop over all sample points in volume within footprint and
+  // evaluate the splat
+  vtkIdType sliceSize =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+  for (int k=zmin; k<=zmax; k++)
+    {
+    cx[2] = this->Origin[2] + this->Spacing[2]*k;
+    for (int j=min[1]; j<=max[1]; j++)
+      {
+      cx[1] = this->Origin[1] + this->Spacing[1]*j;
+      for (int i=min[0]; i<=max[0]; i++)
+        {
+        cx[0] = this->Origin[0] + this->Spacing[0]*i;
+
+        double dist2 = (this->Normals ?
+          vtkGaussianSplatterEccentricDistance2(
+            p, n, mag, this->Eccentricity2, cx) :
+          vtkGaussianSplatterDistance2(p, cx));
+
+        if ( dist2 <= this->Radius2 )
+          {
+          vtkIdType idx = i + j*this->Dimensions[0] + k*sliceSize;
+          double value = factor * exp(
+            this->ExponentFactor*(dist2)/(this->Radius2));
+          vtkGaussianSplatterAccumulate(this->Output, this->Visited, idx,
+                                        value, this->AccumulationMode);
+          }//if within splat radius
+        }
+      }
+    }
+}
+
+}
+
 // Construct object with dimensions=(50,50,50); automatic computation of
 // bounds; a splat radius of 0.1; an exponent factor of -5; and normal and
 // scalar warping turned on.
@@ -56,6 +235,15 @@ vtkGaussianSplatter::vtkGaussianSplatter()
 
   this->AccumulationMode = VTK_ACCUMULATION_MODE_MAX;
   this->NullValue = 0.0;
+
+  this->Radius2 = 0.0;
+  this->Sample = &vtkGaussianSplatter::Gaussian;
+  this->SampleFactor = &vtkGaussianSplatter::PositionSampling;
+  this->Visited = NULL;
+  this->Eccentricity2 = this->Eccentricity * this->Eccentricity;
+  this->P = NULL;
+  this->N = NULL;
+  this->S = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -117,12 +305,9 @@ int vtkGaussianSplatter::RequestData(
     outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
   output->AllocateScalars(outInfo);
 
-  vtkIdType numPts, numNewPts, ptId, idx, i;
-  int j, k;
-  int min[3], max[3];
+  vtkIdType numPts, numNewPts, i;
   vtkPointData *pd;
   vtkDataArray *inNormals=NULL;
-  double loc[3], dist2, cx[3];
   vtkDoubleArray *newScalars =
     vtkDoubleArray::SafeDownCast(output->GetPointData()->GetScalars());
   newScalars->SetName("SplatterValues");
@@ -130,7 +315,6 @@ int vtkGaussianSplatter::RequestData(
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  int sliceSize=this->SampleDimensions[0]*this->SampleDimensions[1];
 
   vtkDebugMacro(<< "Splatting data");
 
@@ -146,19 +330,11 @@ int vtkGaussianSplatter::RequestData(
   //  automatically generated bounding box has been generated, increase
   //  its size slightly to acoomodate the radius of influence.
   //
-  this->Eccentricity2 = this->Eccentricity * this->Eccentricity;
-
   numNewPts = this->SampleDimensions[0] * this->SampleDimensions[1] *
               this->SampleDimensions[2];
-  for (i=0; i<numNewPts; i++)
-    {
-    newScalars->SetTuple(i,&this->NullValue);
-    }
-  this->Visited = new char[numNewPts];
-  for (i=0; i < numNewPts; i++)
-    {
-    this->Visited[i] = 0;
-    }
+  double *outPtr = newScalars->GetPointer(0);
+  std::fill(outPtr, outPtr + numNewPts, this->NullValue);
+  std::vector<char> visited(numNewPts, 0);
 
   output->SetDimensions(this->GetSampleDimensions());
   this->ComputeModelBounds(input,output, outInfo);
@@ -172,95 +348,65 @@ int vtkGaussianSplatter::RequestData(
     {
     inScalars = pd->GetScalars();
     }
-
-  //  Set up function pointers to sample functions
-  //
-  if ( this->NormalWarping && (inNormals=pd->GetNormals()) != NULL )
+  if ( this->NormalWarping )
     {
-    this->Sample = &vtkGaussianSplatter::EccentricGaussian;
-    }
-  else
-    {
-    this->Sample = &vtkGaussianSplatter::Gaussian;
+    inNormals = pd->GetNormals();
     }
 
-  if ( this->ScalarWarping && inScalars != NULL )
+  //  Set up the sample functions, which give the same values as the
+  //  parallel splat for a single point
+  //
+  this->Eccentricity2 = this->Eccentricity * this->Eccentricity;
+  this->Sample = ( inNormals != NULL ? &vtkGaussianSplatter::EccentricGaussian :
+                   &vtkGaussianSplatter::Gaussian );
+  this->SampleFactor = ( this->ScalarWarping && inScalars != NULL ?
+                         &vtkGaussianSplatter::ScalarSampling :
+                         &vtkGaussianSplatter::PositionSampling );
+
+  // The points are read concurrently, so take them from a vtkPoints
+  // rather than through vtkDataSet::GetPoint(), which is not thread safe
+  vtkSmartPointer<vtkPoints> points;
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if ( pointSet && pointSet->GetPoints() )
     {
-    this->SampleFactor = &vtkGaussianSplatter::ScalarSampling;
+    points = pointSet->GetPoints();
     }
   else
     {
-    this->SampleFactor = &vtkGaussianSplatter::PositionSampling;
-    this->S = 0.0; //position sampling does not require S to be defined
-                   //but this makes purify happy.
-    }
-
-  // Traverse all points - splatting each into the volume.
-  // For each point, determine which voxel it is in.  Then determine
-  // the subvolume that the splat is contained in, and process that.
-  //
-  int abortExecute=0;
-  vtkIdType progressInterval = numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abortExecute; ptId++)
-    {
-    if ( ! (ptId % progressInterval) )
+    points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPts);
+    for (i=0; i < numPts; i++)
       {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (static_cast<double>(ptId)/numPts);
-      abortExecute = this->GetAbortExecute();
-      }
-
-    this->P = input->GetPoint(ptId);
-    if ( inNormals != NULL )
-      {
-      this->N = inNormals->GetTuple(ptId);
-      }
-    if ( inScalars != NULL )
-      {
-      this->S = inScalars->GetComponent(ptId,0);
-      }
-
-    // Determine the voxel that the point is in
-    for (i=0; i<3; i++)
-      {
-      loc[i] = (this->P[i] - this->Origin[i]) / this->Spacing[i];
-      }
-
-    // Determine splat footprint
-    for (i=0; i<3; i++)
-      {
-      min[i] = static_cast<int>(floor(static_cast<double>(loc[i])-this->SplatDistance[i]));
-      max[i] = static_cast<int>(ceil(static_cast<double>(loc[i])+this->SplatDistance[i]));
-      if ( min[i] < 0 )
-        {
-        min[i] = 0;
-        }
-      if ( max[i] >= this->SampleDimensions[i] )
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
+      points->SetPoint(i, input->GetPoint(i));
       }
+    }
 
-    // Loop over all sample points in volume within footprint and
-    // evaluate the splat
-    for (k=min[2]; k<=max[2]; k++)
-      {
-      cx[2] = this->Origin[2] + this->Spacing[2]*k;
-      for (j=min[1]; j<=max[1]; j++)
-        {
-        cx[1] = this->Origin[1] + this->Spacing[1]*j;
-        for (i=min[0]; i<=max[0]; i++)
-          {
-          cx[0] = this->Origin[0] + this->Spacing[0]*i;
-          if ( (dist2=(this->*Sample)(cx)) <= this->Radius2 )
-            {
-            idx = i + j*this->SampleDimensions[0] + k*sliceSize;
-            this->SetScalar(idx,dist2, newScalars);
-            }//if within splat radius
-          }
-        }
-      }//within splat footprint
-    }//for all input points
+  vtkGaussianSplatterSplat splat;
+  splat.Points = points;
+  splat.Normals = inNormals;
+  splat.Scalars = (this->ScalarWarping ? inScalars : NULL);
+  splat.Output = outPtr;
+  splat.Visited = &visited[0];
+  this->Visited = splat.Visited;
+  for (i=0; i<3; i++)
+    {
+    splat.Dimensions[i] = this->SampleDimensions[i];
+    splat.Origin[i] = this->Origin[i];
+    splat.Spacing[i] = this->Spacing[i];
+    splat.SplatDistance[i] = this->SplatDistance[i];
+    }
+  splat.Radius2 = this->Radius2;
+  splat.Eccentricity2 = this->Eccentricity2;
+  splat.ScaleFactor = this->ScaleFactor;
+  splat.ExponentFactor = this->ExponentFactor;
+  splat.AccumulationMode = this->AccumulationMode;
+
+  // Bin the points into slabs of the volume, and splat the slabs in
+  // parallel.  The footprint of a splat covers at most this many slices.
+  int maxDepth = 2*static_cast<int>(ceil(this->SplatDistance[2])) + 2;
+  vtkSplatterExecute(splat, numPts, this->SampleDimensions[2], maxDepth);
+  this->UpdateProgress(1.0);
 
   // If capping is turned on, set the distances of the outside of the volume
   // to the CapValue.
@@ -272,9 +418,9 @@ int vtkGaussianSplatter::RequestData(
 
   vtkDebugMacro(<< "Splatted " << input->GetNumberOfPoints() << " points");
 
-  // Update self and release memeory
+  // Release the visited flags
   //
-  delete [] this->Visited;
+  this->Visited = NULL;
 
   return 1;
 }
@@ -469,8 +615,7 @@ void vtkGaussianSplatter::Cap(vtkDoubleArray *s)
 //
 double vtkGaussianSplatter::Gaussian (double cx[3])
 {
-  return ((cx[0]-P[0])*(cx[0]-P[0]) + (cx[1]-P[1])*(cx[1]-P[1]) +
-          (cx[2]-P[2])*(cx[2]-P[2]) );
+  return vtkGaussianSplatterDistance2(this->P, cx);
 }
 
 //----------------------------------------------------------------------------
@@ -479,34 +624,9 @@ double vtkGaussianSplatter::Gaussian (double cx[3])
 //
 double vtkGaussianSplatter::EccentricGaussian (double cx[3])
 {
-  double   v[3], r2, z2, rxy2, mag;
-
-  v[0] = cx[0] - this->P[0];
-  v[1] = cx[1] - this->P[1];
-  v[2] = cx[2] - this->P[2];
-
-  r2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
-
-  if ( (mag=this->N[0]*this->N[0]+
-            this->N[1]*this->N[1]+
-            this->N[2]*this->N[2]) != 1.0  )
-    {
-    if ( mag == 0.0 )
-      {
-      mag = 1.0;
-      }
-    else
-      {
-      mag = sqrt(mag);
-      }
-    }
-
-  z2 = (v[0]*this->N[0] + v[1]*this->N[1] + v[2]*this->N[2])/mag;
-  z2 = z2*z2;
-
-  rxy2 = r2 - z2;
-
-  return (rxy2/this->Eccentricity2 + z2);
+  return vtkGaussianSplatterEccentricDistance2(
+    this->P, this->N, vtkGaussianSplatterMagnitude(this->N),
+    this->Eccentricity2, cx);
 }
 
 //----------------------------------------------------------------------------
@@ -517,28 +637,8 @@ void vtkGaussianSplatter::SetScalar(int idx, double dist2,
     static_cast<double>
     (this->ExponentFactor*(dist2)/(this->Radius2)));
 
-  if ( ! this->Visited[idx] )
-    {
-    this->Visited[idx] = 1;
-    newScalars->SetTuple(idx,&v);
-    }
-  else
-    {
-    double s = newScalars->GetValue(idx);
-    switch (this->AccumulationMode)
-      {
-      case VTK_ACCUMULATION_MODE_MIN:
-        newScalars->SetTuple(idx,(s < v ? &s : &v));
-        break;
-      case VTK_ACCUMULATION_MODE_MAX:
-        newScalars->SetTuple(idx,(s > v ? &s : &v));
-        break;
-      case VTK_ACCUMULATION_MODE_SUM:
-        s += v;
-        newScalars->SetTuple(idx,&s);
-        break;
-      }
-    }//not first visit
+  vtkGaussianSplatterAccumulate(newScalars->GetPointer(0), this->Visited,
+                                idx, v, this->AccumulationMode);
 }
 
 //----------------------------------------------------------------------------
@@ -48,6 +48,12 @@
 // volume rendered to generate a visualization. It can be used to create
 // surfaces from point distributions, or to create structure (i.e.,
 // topology) when none exists.
+//
+// The splatting is done in parallel with vtkSMPTools.  The volume is
+// divided into slabs along z, the points are binned into the slabs that
+// their splats overlap, and then each slab is splatted by a single thread.
+// The points are splatted in their original order within each slab, so
+// the result is the same as for a serial splat.
 
 // .SECTION Caveats
 // The input to this filter is any dataset type. This filter can be used
@@ -211,6 +217,9 @@ protected:
   double CapValue; // value to use for capping
   int AccumulationMode; // how to combine scalar values
 
+  // Description:
+  // Sample the splat of a single point.  RequestData splats the points in
+  // parallel with the same arithmetic, and does not call these.
   double Gaussian(double x[3]);
   double EccentricGaussian(double x[3]);
   double ScalarSampling(double s)
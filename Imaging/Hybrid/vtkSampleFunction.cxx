@@ -22,6 +22,7 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
@@ -187,7 +188,7 @@ void vtkSampleFunction::ExecuteDataWithInformation(vtkDataObject *outp, vtkInfor
   vtkIdType idx, i, j, k;
   vtkFloatArray *newNormals=NULL;
   vtkIdType numPts;
-  double p[3], s;
+  double p[3];
   vtkImageData *output=this->GetOutput();
   int* extent =
     this->GetExecutive()->GetOutputInformation(0)->Get(
@@ -214,19 +215,43 @@ void vtkSampleFunction::ExecuteDataWithInformation(vtkDataObject *outp, vtkInfor
   double spacing[3];
   output->GetSpacing(spacing);
 
-  for ( idx=0, k=extent[4]; k <= extent[5]; k++ )
+  // The points are evaluated with the batch interface of the implicit
+  // function, a slab of slices at a time
+  vtkIdType sliceSize = static_cast<vtkIdType>(extent[1] - extent[0] + 1)*
+    (extent[3] - extent[2] + 1);
+  int slabSize = static_cast<int>(65536/(sliceSize > 0 ? sliceSize : 1));
+  slabSize = (slabSize > 1 ? slabSize : 1);
+  vtkNew<vtkDoubleArray> points;
+  points->SetNumberOfComponents(3);
+  vtkNew<vtkDoubleArray> values;
+  for ( idx=0, k=extent[4]; k <= extent[5]; k += slabSize )
     {
-    p[2] = this->ModelBounds[4] + k*spacing[2];
-    for ( j=extent[2]; j <= extent[3]; j++ )
+    int kmax = k + slabSize - 1;
+    kmax = (kmax < extent[5] ? kmax : extent[5]);
+    points->SetNumberOfTuples(sliceSize*(kmax - k + 1));
+    double *x = points->GetPointer(0);
+    for ( int kk=k; kk <= kmax; kk++ )
       {
-      p[1] = this->ModelBounds[2] + j*spacing[1];
-      for ( i=extent[0]; i <= extent[1]; i++ )
+      p[2] = this->ModelBounds[4] + kk*spacing[2];
+      for ( j=extent[2]; j <= extent[3]; j++ )
         {
-        p[0] = this->ModelBounds[0] + i*spacing[0];
-        s = this->ImplicitFunction->FunctionValue(p);
-        newScalars->SetTuple1(idx++,s);
+        p[1] = this->ModelBounds[2] + j*spacing[1];
+        for ( i=extent[0]; i <= extent[1]; i++ )
+          {
+          x[0] = this->ModelBounds[0] + i*spacing[0];
+          x[1] = p[1];
+          x[2] = p[2];
+          x += 3;
+          }
         }
       }
+    this->ImplicitFunction->FunctionValue(points.GetPointer(),
+                                          values.GetPointer());
+    vtkIdType n = values->GetNumberOfTuples();
+    for ( i=0; i < n; i++ )
+      {
+      newScalars->SetTuple1(idx++, values->GetValue(i));
+      }
     }
 
   // If normal computation turned on, compute them
@@ -22,9 +22,107 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
+#include "vtkSplatterInternals.h"
 
 vtkStandardNewMacro(vtkShepardMethod);
 
+namespace {
+
+//----------------------------------------------------------------------------
+// Add the weighted contributions of the points to the volume.  A point only
+// writes to the slices that it is given, so different slabs can be done at
+// once.
+class vtkShepardMethodSplat
+{
+public:
+  vtkPoints *Points;
+  vtkDataArray *Scalars;
+  float *Output;
+  double *Sum;
+  int Dimensions[3];
+  double Origin[3];
+  double Spacing[3];
+  double MaximumDistance;
+
+  // Compute the dimensional bounds in the data set along one axis
+  void GetRange(const double px[3], int i, int &min, int &max)
+  {
+    min = static_cast<int>(
+      static_cast<double>((px[i] - this->MaximumDistance) - this->Origin[i]) /
+      this->Spacing[i]);
+    max = static_cast<int>(
+      static_cast<double>((px[i] + this->MaximumDistance) - this->Origin[i]) /
+      this->Spacing[i]);
+  }
+
+  void GetSlices(vtkIdType ptId, int &zmin, int &zmax)
+  {
+    double px[3];
+    this->Points->GetPoint(ptId, px);
+    this->GetRange(px, 2, zmin, zmax);
+  }
+
+  void Splat(vtkIdType ptId, int zmin, int zmax);
+};
+
+//----------------------------------------------------------------------------
+void vtkShepardMethodSplat::Splat(vtkIdType ptId, int zmin, int zmax)
+{
+  double px[3], x[3];
+  int min[2], max[2];
+
+  this->Points->GetPoint(ptId, px);
+  double inScalar = this->Scalars->GetComponent(ptId,0);
+
+  for (int i=0; i<2; i++)
+    {
+    this->GetRange(px, i, min[i], max[i]);
+    if (min[i] < 0)
+      {
+      min[i] = 0;
+      }
+    if (max[i] >= this->Dimensions[i])
+      {
+      max[i] = this->Dimensions[i] - 1;
+      }
+    }
+
+  vtkIdType jkFactor =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+  for (int k = zmin; k <= zmax; k++)
+    {
+    x[2] = this->Spacing[2] * k + this->Origin[2];
+    for (int j = min[1]; j <= max[1]; j++)
+      {
+      x[1] = this->Spacing[1] * j + this->Origin[1];
+      for (int i = min[0]; i <= max[0]; i++)
+        {
+        x[0] = this->Spacing[0] * i + this->Origin[0];
+        vtkIdType idx = jkFactor*k + this->Dimensions[0]*j + i;
+
+        double distance2 = vtkMath::Distance2BetweenPoints(x,px);
+
+        if ( distance2 == 0.0 )
+          {
+          this->Sum[idx] = VTK_DOUBLE_MAX;
+          this->Output[idx] = VTK_FLOAT_MAX;
+          }
+        else
+          {
+          double s = this->Output[idx];
+          this->Sum[idx] += 1.0 / distance2;
+          this->Output[idx] = static_cast<float>(s+(inScalar/distance2));
+          }
+        }
+      }
+    }
+}
+
+}
+
 // Construct with sample dimensions=(50,50,50) and so that model bounds are
 // automatically computed from input. Null value for each unvisited output
 // point is 0.0. Maximum distance is 0.25.
@@ -156,14 +254,11 @@ int vtkShepardMethod::RequestData(
   output->AllocateScalars(outInfo);
 
   vtkIdType ptId, i;
-  int j, k;
-  double *px, x[3], s, *sum, spacing[3], origin[3];
+  double s, *sum, spacing[3], origin[3];
 
-  double maxDistance, distance2, inScalar;
+  double maxDistance;
   vtkDataArray *inScalars;
-  vtkIdType numPts, numNewPts, idx;
-  int min[3], max[3];
-  int jkFactor;
+  vtkIdType numPts, numNewPts;
   vtkFloatArray *newScalars =
     vtkFloatArray::SafeDownCast(output->GetPointData()->GetScalars());
 
@@ -202,97 +297,44 @@ int vtkShepardMethod::RequestData(
   outInfo->Set(vtkDataObject::SPACING(),spacing,3);
 
 
-  // Traverse all input points.
-  // Each input point affects voxels within maxDistance.
-  //
-  for (ptId=0; ptId < numPts; ptId++)
+  // The points are read concurrently, so take them from a vtkPoints
+  // rather than through vtkDataSet::GetPoint(), which is not thread safe
+  vtkSmartPointer<vtkPoints> points;
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if ( pointSet && pointSet->GetPoints() )
     {
-    if ( ! (ptId % 1000) )
-      {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (ptId/numPts);
-      if (this->GetAbortExecute())
-        {
-        break;
-        }
-      }
-
-    px = input->GetPoint(ptId);
-    inScalar = inScalars->GetComponent(ptId,0);
-
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
-      {
-      double amin = static_cast<double>(
-        (px[i] - maxDistance) - origin[i]) / spacing[i];
-      double amax = static_cast<double>(
-        (px[i] + maxDistance) - origin[i]) / spacing[i];
-      min[i] = static_cast<int>(amin);
-      max[i] = static_cast<int>(amax);
-
-      if (min[i] < amin)
-        {
-        min[i]++; // round upward to nearest integer to get min[i]
-        }
-      if (max[i] > amax)
-        {
-        max[i]--; // round downward to nearest integer to get max[i]
-        }
-
-      if (min[i] < 0)
-        {
-        min[i] = 0; // valid range check
-        }
-      if (max[i] >= this->SampleDimensions[i])
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
-      }
-
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
+    points = pointSet->GetPoints();
+    }
+  else
+    {
+    points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPts);
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      min[i] = static_cast<int>(
-        static_cast<double>((px[i] - maxDistance) - origin[i]) / spacing[i]);
-      max[i] = static_cast<int>(
-        static_cast<double>((px[i] + maxDistance) - origin[i]) / spacing[i]);
-      if (min[i] < 0)
-        {
-        min[i] = 0;
-        }
-      if (max[i] >= this->SampleDimensions[i])
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
+      points->SetPoint(ptId, input->GetPoint(ptId));
       }
+    }
 
-    jkFactor = this->SampleDimensions[0]*this->SampleDimensions[1];
-    for (k = min[2]; k <= max[2]; k++)
-      {
-      x[2] = spacing[2] * k + origin[2];
-      for (j = min[1]; j <= max[1]; j++)
-        {
-        x[1] = spacing[1] * j + origin[1];
-        for (i = min[0]; i <= max[0]; i++)
-          {
-          x[0] = spacing[0] * i + origin[0];
-          idx = jkFactor*k + this->SampleDimensions[0]*j + i;
-
-          distance2 = vtkMath::Distance2BetweenPoints(x,px);
-
-          if ( distance2 == 0.0 )
-            {
-            sum[idx] = VTK_DOUBLE_MAX;
-            newScalars->SetComponent(idx,0,VTK_FLOAT_MAX);
-            }
-          else
-            {
-            s = newScalars->GetComponent(idx,0);
-            sum[idx] += 1.0 / distance2;
-            newScalars->SetComponent(idx,0,s+(inScalar/distance2));
-            }
-          }
-        }
-      }
+  // Traverse all input points.
+  // Each input point affects voxels within maxDistance.  The points are
+  // binned into slabs of the volume, and the slabs are done in parallel.
+  //
+  vtkShepardMethodSplat splat;
+  splat.Points = points;
+  splat.Scalars = inScalars;
+  splat.Output = newScalars->GetPointer(0);
+  splat.Sum = sum;
+  splat.MaximumDistance = maxDistance;
+  for (i=0; i<3; i++)
+    {
+    splat.Dimensions[i] = this->SampleDimensions[i];
+    splat.Origin[i] = origin[i];
+    splat.Spacing[i] = spacing[i];
     }
+  int maxDepth = static_cast<int>(2*maxDistance/spacing[2]) + 2;
+  vtkSplatterExecute(splat, numPts, this->SampleDimensions[2], maxDepth);
+  this->UpdateProgress(1.0);
 
   // Run through scalars and compute final values
   //
@@ -20,6 +20,11 @@
 // "inverse distance weighted". Once the structured points are computed, the
 // usual visualization techniques (e.g., iso-contouring or volume rendering)
 // can be used visualize the structured points.
+//
+// The points are binned into slabs of the output volume along z, and the
+// slabs are computed in parallel with vtkSMPTools.  Each slab is done by a
+// single thread, in the order of the input points, so the result does not
+// depend on the number of threads.
 // .SECTION Caveats
 // The input to this filter is any dataset type. This filter can be used
 // to resample any form of data, i.e., the input data need not be
@@ -0,0 +1,210 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSplatterInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSplatterInternals - Parallel splatting by output slabs
+// .SECTION Description
+// This is a helper for the splatting filters.  The output volume is
+// divided into slabs of whole slices, and each item that is to be splatted
+// (usually an input point) is binned into the slabs that its footprint
+// overlaps.  The slabs are then splatted in parallel, each by one thread,
+// so that no two threads ever write to the same voxel and no locks or
+// atomics are needed.  Within a slab the items are splatted in the same
+// order as a serial loop would splat them, so the result does not depend
+// on the number of threads.
+//
+// The splat object must provide two methods, both of which will be called
+// concurrently for different items:
+//
+//   void GetSlices(vtkIdType id, int &zmin, int &zmax);
+//   void Splat(vtkIdType id, int zmin, int zmax);
+//
+// GetSlices() gives the range of slices that the footprint of the item
+// covers, which need not lie within the volume.  Splat() must write only
+// to the slices from zmin to zmax, which will have been clipped to the
+// volume and to the slab.
+
+#ifndef __vtkSplatterInternals_h
+#define __vtkSplatterInternals_h
+
+#include "vtkSMPTools.h"
+
+#include <vector>
+
+// The number of items in each chunk while binning
+#define VTK_SPLATTER_CHUNK_SIZE 65536
+
+// The desired number of slabs, if the footprints are thin enough
+#define VTK_SPLATTER_SLABS 64
+
+namespace {
+
+//----------------------------------------------------------------------------
+// The slabs and the items that have been binned into them.
+struct vtkSplatterSlabs
+{
+  int NumberOfSlices;
+  int Thickness;
+  int NumberOfSlabs;
+  vtkIdType NumberOfItems;
+  vtkIdType NumberOfChunks;
+  // The position of each chunk within each slab, for binning
+  std::vector<vtkIdType> Offsets;
+  // The start of each slab within Items
+  std::vector<vtkIdType> SlabStart;
+  std::vector<vtkIdType> Items;
+};
+
+//----------------------------------------------------------------------------
+// Count the items for each chunk and slab, or, if "fill" is set, place
+// the items into their slabs.
+template<class S>
+class vtkSplatterBinFunctor
+{
+public:
+  vtkSplatterBinFunctor(S &splat, vtkSplatterSlabs &slabs, bool fill)
+    : Splat(splat), Slabs(slabs), Fill(fill) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkSplatterSlabs &slabs = this->Slabs;
+    for (vtkIdType chunk = begin; chunk < end; chunk++)
+      {
+      vtkIdType *offsets = &slabs.Offsets[chunk*slabs.NumberOfSlabs];
+      vtkIdType first = chunk*VTK_SPLATTER_CHUNK_SIZE;
+      vtkIdType last = first + VTK_SPLATTER_CHUNK_SIZE;
+      last = (last < slabs.NumberOfItems ? last : slabs.NumberOfItems);
+      for (vtkIdType id = first; id < last; id++)
+        {
+        int zmin, zmax;
+        this->Splat.GetSlices(id, zmin, zmax);
+        zmin = (zmin > 0 ? zmin : 0);
+        zmax = (zmax < slabs.NumberOfSlices - 1 ?
+                zmax : slabs.NumberOfSlices - 1);
+        if (zmin <= zmax)
+          {
+          int smax = zmax/slabs.Thickness;
+          for (int s = zmin/slabs.Thickness; s <= smax; s++)
+            {
+            if (this->Fill)
+              {
+              slabs.Items[offsets[s]] = id;
+              }
+            offsets[s]++;
+            }
+          }
+        }
+      }
+  }
+
+private:
+  S &Splat;
+  vtkSplatterSlabs &Slabs;
+  bool Fill;
+};
+
+//----------------------------------------------------------------------------
+// Splat the items in a range of slabs.
+template<class S>
+class vtkSplatterSlabFunctor
+{
+public:
+  vtkSplatterSlabFunctor(S &splat, vtkSplatterSlabs &slabs)
+    : Splat(splat), Slabs(slabs) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkSplatterSlabs &slabs = this->Slabs;
+    for (vtkIdType s = begin; s < end; s++)
+      {
+      int slabMin = static_cast<int>(s)*slabs.Thickness;
+      int slabMax = slabMin + slabs.Thickness - 1;
+      slabMax = (slabMax < slabs.NumberOfSlices - 1 ?
+                 slabMax : slabs.NumberOfSlices - 1);
+      for (vtkIdType i = slabs.SlabStart[s]; i < slabs.SlabStart[s+1]; i++)
+        {
+        vtkIdType id = slabs.Items[i];
+        int zmin, zmax;
+        this->Splat.GetSlices(id, zmin, zmax);
+        zmin = (zmin > slabMin ? zmin : slabMin);
+        zmax = (zmax < slabMax ? zmax : slabMax);
+        this->Splat.Splat(id, zmin, zmax);
+        }
+      }
+  }
+
+private:
+  S &Splat;
+  vtkSplatterSlabs &Slabs;
+};
+
+//----------------------------------------------------------------------------
+// Splat "n" items into a volume with "numSlices" slices, where the
+// footprint of each item covers at most "maxDepth" slices.
+template<class S>
+void vtkSplatterExecute(S &splat, vtkIdType n, int numSlices, int maxDepth)
+{
+  if (n <= 0 || numSlices <= 0)
+    {
+    return;
+    }
+
+  // Make the slabs thick enough that each item is binned into at most
+  // a few of them, otherwise the bins would use too much memory
+  vtkSplatterSlabs slabs;
+  slabs.NumberOfSlices = numSlices;
+  slabs.Thickness = (numSlices + VTK_SPLATTER_SLABS - 1)/VTK_SPLATTER_SLABS;
+  if (slabs.Thickness < (maxDepth + 3)/4)
+    {
+    slabs.Thickness = (maxDepth + 3)/4;
+    }
+  slabs.NumberOfSlabs = (numSlices + slabs.Thickness - 1)/slabs.Thickness;
+  slabs.NumberOfItems = n;
+  slabs.NumberOfChunks = (n + VTK_SPLATTER_CHUNK_SIZE - 1)/
+    VTK_SPLATTER_CHUNK_SIZE;
+
+  // Count the items for each chunk of each slab
+  int numSlabs = slabs.NumberOfSlabs;
+  vtkIdType numChunks = slabs.NumberOfChunks;
+  slabs.Offsets.assign(numChunks*numSlabs, 0);
+  vtkSplatterBinFunctor<S> counter(splat, slabs, false);
+  vtkSMPTools::For(0, numChunks, 1, counter);
+
+  // Order the bins by slab and then by chunk, so that each slab lists
+  // its items in increasing order
+  slabs.SlabStart.resize(numSlabs + 1);
+  vtkIdType total = 0;
+  for (int s = 0; s < numSlabs; s++)
+    {
+    slabs.SlabStart[s] = total;
+    for (vtkIdType chunk = 0; chunk < numChunks; chunk++)
+      {
+      vtkIdType count = slabs.Offsets[chunk*numSlabs + s];
+      slabs.Offsets[chunk*numSlabs + s] = total;
+      total += count;
+      }
+    }
+  slabs.SlabStart[numSlabs] = total;
+
+  // Bin the items, and then splat each slab
+  slabs.Items.resize(total);
+  vtkSplatterBinFunctor<S> binner(splat, slabs, true);
+  vtkSMPTools::For(0, numChunks, 1, binner);
+  vtkSplatterSlabFunctor<S> splatter(splat, slabs);
+  vtkSMPTools::For(0, numSlabs, 1, splatter);
+}
+
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSplatterInternals.h
@@ -0,0 +1,206 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageBoxKernels.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the box kernel methods of the morphology and median filters
+// .SECTION Description
+// Compares the box kernel results of vtkImageContinuousDilate3D,
+// vtkImageContinuousErode3D, and vtkImageDilateErode3D, and the histogram
+// median of vtkImageMedian3D, with results computed by brute force.
+
+#include "vtkDataArray.h"
+#include "vtkImageContinuousDilate3D.h"
+#include "vtkImageContinuousErode3D.h"
+#include "vtkImageData.h"
+#include "vtkImageDilateErode3D.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+enum { BoxMax, BoxMin, BoxMedian, BoxDilateErode };
+
+// Compute the expected value for voxel (x,y,z) and component c
+double BruteForce(vtkImageData *image, int x, int y, int z, int c,
+                  const int size[3], int op)
+{
+  int ext[6];
+  image->GetExtent(ext);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  int dims[3];
+  image->GetDimensions(dims);
+
+  std::vector<double> values;
+  for (int k = z - size[2]/2; k < z - size[2]/2 + size[2]; k++)
+    {
+    for (int j = y - size[1]/2; j < y - size[1]/2 + size[1]; j++)
+      {
+      for (int i = x - size[0]/2; i < x - size[0]/2 + size[0]; i++)
+        {
+        if (i >= ext[0] && i <= ext[1] && j >= ext[2] && j <= ext[3] &&
+            k >= ext[4] && k <= ext[5])
+          {
+          vtkIdType v = (i - ext[0]) + dims[0]*((j - ext[2]) +
+                                                dims[1]*(k - ext[4]));
+          values.push_back(scalars->GetComponent(v, c));
+          }
+        }
+      }
+    }
+  std::sort(values.begin(), values.end());
+
+  vtkIdType v = (x - ext[0]) + dims[0]*((y - ext[2]) + dims[1]*(z - ext[4]));
+  double center = scalars->GetComponent(v, c);
+  switch (op)
+    {
+    case BoxMax:
+      return values.back();
+    case BoxMin:
+      return values.front();
+    case BoxMedian:
+      return values[values.size()/2];
+    }
+  // dilate 0 into 1
+  return ((center == 1.0 && values.front() == 0.0) ? 0.0 : center);
+}
+
+bool Compare(vtkImageData *image, vtkImageData *output, const int size[3],
+             int op, const char *name)
+{
+  int ext[6];
+  image->GetExtent(ext);
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  int nc = scalars->GetNumberOfComponents();
+  vtkIdType v = 0;
+  for (int z = ext[4]; z <= ext[5]; z++)
+    {
+    for (int y = ext[2]; y <= ext[3]; y++)
+      {
+      for (int x = ext[0]; x <= ext[1]; x++)
+        {
+        for (int c = 0; c < nc; c++)
+          {
+          double expected = BruteForce(image, x, y, z, c, size, op);
+          double value = scalars->GetComponent(v, c);
+          if (value != expected)
+            {
+            cerr << name << " with kernel " << size[0] << "x" << size[1]
+                 << "x" << size[2] << " gave " << value << " instead of "
+                 << expected << " at (" << x << "," << y << "," << z
+                 << ") component " << c << endl;
+            return false;
+            }
+          }
+        v++;
+        }
+      }
+    }
+  return true;
+}
+
+void FillImage(vtkImageData *image, int scalarType, int nc, double range)
+{
+  image->SetExtent(-3, 17, 2, 15, 0, 12);
+  image->AllocateScalars(scalarType, nc);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < nc; c++)
+      {
+      scalars->SetComponent(i, c, vtkMath::Floor(vtkMath::Random(0, range)));
+      }
+    }
+}
+
+}
+
+int TestImageBoxKernels(int, char *[])
+{
+  vtkMath::RandomSeed(97531);
+
+  static const int sizes[4][3] = {
+    { 3, 3, 1 }, { 5, 3, 4 }, { 1, 7, 2 }, { 9, 9, 9 } };
+
+  for (int s = 0; s < 4; s++)
+    {
+    const int *size = sizes[s];
+
+    // maximum and minimum of a two-component image
+    vtkNew<vtkImageData> image;
+    FillImage(image.GetPointer(), VTK_SHORT, 2, 1000.0);
+
+    vtkNew<vtkImageContinuousDilate3D> dilate;
+    dilate->SetInputData(image.GetPointer());
+    dilate->SetKernelSize(size[0], size[1], size[2]);
+    dilate->BoxKernelOn();
+    dilate->Update();
+    if (!Compare(image.GetPointer(), dilate->GetOutput(), size, BoxMax,
+                 "vtkImageContinuousDilate3D"))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkNew<vtkImageContinuousErode3D> erode;
+    erode->SetInputData(image.GetPointer());
+    erode->SetKernelSize(size[0], size[1], size[2]);
+    erode->BoxKernelOn();
+    erode->Update();
+    if (!Compare(image.GetPointer(), erode->GetOutput(), size, BoxMin,
+                 "vtkImageContinuousErode3D"))
+      {
+      return EXIT_FAILURE;
+      }
+
+    // dilation of one value into another
+    vtkNew<vtkImageData> binary;
+    FillImage(binary.GetPointer(), VTK_UNSIGNED_CHAR, 1, 1.02);
+    vtkNew<vtkImageDilateErode3D> dilateErode;
+    dilateErode->SetInputData(binary.GetPointer());
+    dilateErode->SetKernelSize(size[0], size[1], size[2]);
+    dilateErode->SetDilateValue(0);
+    dilateErode->SetErodeValue(1);
+    dilateErode->BoxKernelOn();
+    dilateErode->Update();
+    if (!Compare(binary.GetPointer(), dilateErode->GetOutput(), size,
+                 BoxDilateErode, "vtkImageDilateErode3D"))
+      {
+      return EXIT_FAILURE;
+      }
+
+    // median for 8-bit and 16-bit types
+    static const int medianTypes[3] = {
+      VTK_UNSIGNED_CHAR, VTK_SIGNED_CHAR, VTK_SHORT };
+    static const double medianRanges[3] = { 256.0, 128.0, 30000.0 };
+    for (int t = 0; t < 3; t++)
+      {
+      vtkNew<vtkImageData> data;
+      FillImage(data.GetPointer(), medianTypes[t], 2, medianRanges[t]);
+      vtkNew<vtkImageMedian3D> median;
+      median->SetInputData(data.GetPointer());
+      median->SetKernelSize(size[0], size[1], size[2]);
+      median->Update();
+      if (!Compare(data.GetPointer(), median->GetOutput(), size, BoxMedian,
+                   "vtkImageMedian3D"))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageConnectivityFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkImageConnectivityFilter
+// .SECTION Description
+// Compares the labels with those found by a flood fill from each voxel,
+// for each connectivity, with the image large enough to be split into
+// several slabs.  Also checks the sizes, the size rank order, and the
+// removal of small regions.
+
+#include "vtkIdTypeArray.h"
+#include "vtkImageConnectivityFilter.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Label by flood fill, in scan order of the first voxel of each region
+void FloodFill(vtkImageData *image, int connectivity,
+               std::vector<int> &labels, std::vector<vtkIdType> &sizes)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  unsigned char *ptr = static_cast<unsigned char *>(image->GetScalarPointer());
+  vtkIdType n = image->GetNumberOfPoints();
+  labels.assign(n, 0);
+  sizes.clear();
+
+  std::vector<vtkIdType> stack;
+  for (vtkIdType seed = 0; seed < n; seed++)
+    {
+    if (ptr[seed] == 0 || labels[seed] != 0)
+      {
+      continue;
+      }
+    sizes.push_back(0);
+    int label = static_cast<int>(sizes.size());
+    labels[seed] = label;
+    stack.push_back(seed);
+    while (!stack.empty())
+      {
+      vtkIdType v = stack.back();
+      stack.pop_back();
+      sizes.back()++;
+      int x = v % dims[0];
+      int y = (v / dims[0]) % dims[1];
+      int z = v / (dims[0]*dims[1]);
+      for (int dz = -1; dz <= 1; dz++)
+        {
+        for (int dy = -1; dy <= 1; dy++)
+          {
+          for (int dx = -1; dx <= 1; dx++)
+            {
+            int m = (dx != 0) + (dy != 0) + (dz != 0);
+            if (m == 0 || (m == 2 && connectivity < 18) ||
+                (m == 3 && connectivity < 26))
+              {
+              continue;
+              }
+            int xx = x + dx;
+            int yy = y + dy;
+            int zz = z + dz;
+            if (xx < 0 || xx >= dims[0] || yy < 0 || yy >= dims[1] ||
+                zz < 0 || zz >= dims[2])
+              {
+              continue;
+              }
+            vtkIdType u = xx + dims[0]*(yy + dims[1]*zz);
+            if (ptr[u] != 0 && labels[u] == 0)
+              {
+              labels[u] = label;
+              stack.push_back(u);
+              }
+            }
+          }
+        }
+      }
+    }
+}
+
+bool Check(vtkImageData *image, int connectivity, int mode,
+           vtkIdType minSize)
+{
+  std::vector<int> expected;
+  std::vector<vtkIdType> sizes;
+  FloodFill(image, connectivity, expected, sizes);
+
+  // renumber the expected labels as the filter should
+  std::vector<int> order;
+  for (size_t r = 0; r < sizes.size(); r++)
+    {
+    if (sizes[r] >= minSize)
+      {
+      order.push_back(static_cast<int>(r));
+      }
+    }
+  if (mode == vtkImageConnectivityFilter::SIZE_RANK)
+    {
+    for (size_t i = 1; i < order.size(); i++)
+      {
+      // insertion sort, which is stable
+      for (size_t j = i; j > 0 && sizes[order[j]] > sizes[order[j-1]]; j--)
+        {
+        std::swap(order[j], order[j-1]);
+        }
+      }
+    }
+  std::vector<int> labelMap(sizes.size() + 1, 0);
+  for (size_t i = 0; i < order.size(); i++)
+    {
+    labelMap[order[i] + 1] = static_cast<int>(i + 1);
+    }
+
+  vtkNew<vtkImageConnectivityFilter> filter;
+  filter->SetInputData(image);
+  filter->SetConnectivity(connectivity);
+  filter->SetLabelMode(mode);
+  filter->SetSizeRange(minSize, VTK_ID_MAX);
+  filter->SetLabelScalarTypeToInt();
+  filter->Update();
+
+  if (filter->GetNumberOfExtractedRegions() !=
+      static_cast<vtkIdType>(order.size()))
+    {
+    cerr << "Found " << filter->GetNumberOfExtractedRegions()
+         << " regions instead of " << order.size() << " with connectivity "
+         << connectivity << endl;
+    return false;
+    }
+  vtkIdTypeArray *regionSizes = filter->GetExtractedRegionSizes();
+  for (size_t i = 0; i < order.size(); i++)
+    {
+    if (regionSizes->GetValue(i) != sizes[order[i]])
+      {
+      cerr << "Region " << (i + 1) << " has size " << regionSizes->GetValue(i)
+           << " instead of " << sizes[order[i]] << endl;
+      return false;
+      }
+    }
+
+  int *ptr = static_cast<int *>(filter->GetOutput()->GetScalarPointer());
+  for (size_t v = 0; v < expected.size(); v++)
+    {
+    if (ptr[v] != labelMap[expected[v]])
+      {
+      cerr << "Voxel " << v << " has label " << ptr[v] << " instead of "
+           << labelMap[expected[v]] << " with connectivity " << connectivity
+           << " and label mode " << mode << endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+}
+
+int TestImageConnectivityFilter(int, char *[])
+{
+  vtkMath::RandomSeed(2468);
+
+  // the image is large enough to be split into several slabs
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 63, 0, 47, 0, 59);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char *ptr = static_cast<unsigned char *>(image->GetScalarPointer());
+  vtkIdType n = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    ptr[i] = (vtkMath::Random() < 0.3 ? 1 : 0);
+    }
+  // a region that spans all of the slabs
+  for (int z = 0; z < 60; z++)
+    {
+    ptr[10 + 64*(20 + 48*z)] = 1;
+    }
+
+  static const int connectivities[3] = { 6, 18, 26 };
+  for (int c = 0; c < 3; c++)
+    {
+    for (int mode = vtkImageConnectivityFilter::SCAN_ORDER;
+         mode <= vtkImageConnectivityFilter::SIZE_RANK; mode++)
+      {
+      if (!Check(image.GetPointer(), connectivities[c], mode, 1) ||
+          !Check(image.GetPointer(), connectivities[c], mode, 5))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,490 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageConnectivityFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkImageConnectivityFilter.h"
+
+#include "vtkDataObject.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTemplateAliasMacro.h"
+#include "vtkTypeTraits.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageConnectivityFilter);
+
+//----------------------------------------------------------------------------
+vtkImageConnectivityFilter::vtkImageConnectivityFilter()
+{
+  this->ScalarRange[0] = 0.5;
+  this->ScalarRange[1] = VTK_DOUBLE_MAX;
+  this->Connectivity = 6;
+  this->SizeRange[0] = 1;
+  this->SizeRange[1] = VTK_ID_MAX;
+  this->LabelMode = SCAN_ORDER;
+  this->LabelScalarType = VTK_UNSIGNED_SHORT;
+  this->ExtractedRegionSizes = vtkIdTypeArray::New();
+}
+
+//----------------------------------------------------------------------------
+vtkImageConnectivityFilter::~vtkImageConnectivityFilter()
+{
+  this->ExtractedRegionSizes->Delete();
+}
+
+//----------------------------------------------------------------------------
+const char *vtkImageConnectivityFilter::GetLabelScalarTypeAsString()
+{
+  return vtkImageScalarTypeNameMacro(this->LabelScalarType);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageConnectivityFilter::GetNumberOfExtractedRegions()
+{
+  return this->ExtractedRegionSizes->GetNumberOfTuples();
+}
+
+//----------------------------------------------------------------------------
+int vtkImageConnectivityFilter::RequestInformation(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **vtkNotUsed(inputVector),
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject::SetPointDataActiveScalarInfo(
+    outInfo, this->LabelScalarType, 1);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The regions can only be found from the whole input.
+int vtkImageConnectivityFilter::RequestUpdateExtent(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *vtkNotUsed(outputVector))
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  int inExt[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+
+  return 1;
+}
+
+namespace {
+
+//----------------------------------------------------------------------------
+// Find the root of the tree that contains voxel v, and point all the
+// voxels along the way directly to the root.
+inline vtkIdType vtkConnectivityFind(vtkIdType *parent, vtkIdType v)
+{
+  vtkIdType r = v;
+  while (parent[r] != r)
+    {
+    r = parent[r];
+    }
+  while (parent[v] != r)
+    {
+    vtkIdType t = parent[v];
+    parent[v] = r;
+    v = t;
+    }
+  return r;
+}
+
+//----------------------------------------------------------------------------
+// Join the trees that contain voxels u and v.  The root with the smaller
+// index becomes the root of both, so the parent of each voxel is never
+// after the voxel itself in the image.
+inline void vtkConnectivityUnion(vtkIdType *parent, vtkIdType u, vtkIdType v)
+{
+  u = vtkConnectivityFind(parent, u);
+  v = vtkConnectivityFind(parent, v);
+  if (u < v)
+    {
+    parent[v] = u;
+    }
+  else if (v < u)
+    {
+    parent[u] = v;
+    }
+}
+
+//----------------------------------------------------------------------------
+// The neighbors of a voxel that come before it in the image.
+struct vtkConnectivityNeighbor
+{
+  int Offset[3];
+  vtkIdType Step;
+};
+
+void vtkConnectivityNeighbors(
+  int connectivity, const int dims[3],
+  std::vector<vtkConnectivityNeighbor> &neighbors)
+{
+  neighbors.clear();
+  for (int dz = -1; dz <= 0; dz++)
+    {
+    for (int dy = -1; dy <= 1; dy++)
+      {
+      for (int dx = -1; dx <= 1; dx++)
+        {
+        int n = (dx != 0) + (dy != 0) + (dz != 0);
+        bool before =
+          (dz < 0 || (dz == 0 && (dy < 0 || (dy == 0 && dx < 0))));
+        if (before && (n == 1 || (n == 2 && connectivity >= 18) ||
+                       (n == 3 && connectivity >= 26)))
+          {
+          vtkConnectivityNeighbor neighbor;
+          neighbor.Offset[0] = dx;
+          neighbor.Offset[1] = dy;
+          neighbor.Offset[2] = dz;
+          neighbor.Step = dx + static_cast<vtkIdType>(dims[0])*(
+            dy + static_cast<vtkIdType>(dims[1])*dz);
+          neighbors.push_back(neighbor);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Join voxel (x,y,z) with its neighbors that are in the regions.  Only
+// the neighbors in slices from zmin onwards are checked.
+inline void vtkConnectivityJoin(
+  vtkIdType *parent, const int dims[3], int x, int y, int z, int zmin,
+  const std::vector<vtkConnectivityNeighbor> &neighbors, bool onlyBelow)
+{
+  vtkIdType v = x + static_cast<vtkIdType>(dims[0])*(
+    y + static_cast<vtkIdType>(dims[1])*z);
+  size_t n = neighbors.size();
+  for (size_t i = 0; i < n; i++)
+    {
+    const vtkConnectivityNeighbor &neighbor = neighbors[i];
+    int xx = x + neighbor.Offset[0];
+    int yy = y + neighbor.Offset[1];
+    int zz = z + neighbor.Offset[2];
+    if (xx >= 0 && xx < dims[0] && yy >= 0 && yy < dims[1] &&
+        zz >= zmin && (!onlyBelow || zz < z) &&
+        parent[v + neighbor.Step] >= 0)
+      {
+      vtkConnectivityUnion(parent, v, v + neighbor.Step);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The first pass, which labels the voxels of each slab independently.
+// Each voxel in the regions is given a parent, and all other voxels are
+// marked with -1.  The first slice of each slab is recorded so that the
+// slabs can be merged afterwards.
+template<class T>
+class vtkConnectivityFirstPass
+{
+public:
+  vtkConnectivityFirstPass(
+    T *inPtr, const vtkIdType inInc[3], const int dims[3],
+    const double range[2], vtkIdType *parent,
+    const std::vector<vtkConnectivityNeighbor> &neighbors,
+    std::vector<char> &slabStart) :
+    InPtr(inPtr), InInc(inInc), Dims(dims), Range(range), Parent(parent),
+    Neighbors(neighbors), SlabStart(slabStart) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const int *dims = this->Dims;
+    int zmin = static_cast<int>(begin);
+    this->SlabStart[zmin] = 1;
+    for (int z = zmin; z < end; z++)
+      {
+      for (int y = 0; y < dims[1]; y++)
+        {
+        const T *inPtr = this->InPtr + (y*this->InInc[1] + z*this->InInc[2]);
+        vtkIdType v = static_cast<vtkIdType>(dims[0])*(
+          y + static_cast<vtkIdType>(dims[1])*z);
+        for (int x = 0; x < dims[0]; x++)
+          {
+          double val = static_cast<double>(*inPtr);
+          inPtr += this->InInc[0];
+          if (val >= this->Range[0] && val <= this->Range[1])
+            {
+            this->Parent[v] = v;
+            vtkConnectivityJoin(
+              this->Parent, dims, x, y, z, zmin, this->Neighbors, false);
+            }
+          else
+            {
+            this->Parent[v] = -1;
+            }
+          v++;
+          }
+        }
+      }
+  }
+
+private:
+  const T *InPtr;
+  const vtkIdType *InInc;
+  const int *Dims;
+  const double *Range;
+  vtkIdType *Parent;
+  const std::vector<vtkConnectivityNeighbor> &Neighbors;
+  std::vector<char> &SlabStart;
+};
+
+//----------------------------------------------------------------------------
+// The last pass, which writes the labels.
+template<class T>
+class vtkConnectivityWriteLabels
+{
+public:
+  vtkConnectivityWriteLabels(
+    const vtkIdType *regions, const std::vector<vtkIdType> &labels,
+    T *outPtr) :
+    Regions(regions), Labels(labels), OutPtr(outPtr) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    // labels that do not fit in the output type are clamped
+    double maxval = vtkTypeTraits<T>::Max();
+    for (vtkIdType v = begin; v < end; v++)
+      {
+      vtkIdType r = this->Regions[v];
+      vtkIdType label = (r < 0 ? 0 : this->Labels[r]);
+      this->OutPtr[v] = static_cast<T>(label < maxval ? label : maxval);
+      }
+  }
+
+private:
+  const vtkIdType *Regions;
+  const std::vector<vtkIdType> &Labels;
+  T *OutPtr;
+};
+
+//----------------------------------------------------------------------------
+template<class T>
+void vtkConnectivityWrite(
+  const vtkIdType *regions, const std::vector<vtkIdType> &labels,
+  T *outPtr, vtkIdType n)
+{
+  vtkConnectivityWriteLabels<T> writeLabels(regions, labels, outPtr);
+  vtkSMPTools::For(0, n, writeLabels);
+}
+
+//----------------------------------------------------------------------------
+// Compare regions by decreasing size.
+struct vtkConnectivityLargerRegion
+{
+  vtkConnectivityLargerRegion(const std::vector<vtkIdType> &sizes) :
+    Sizes(sizes) {}
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    return (this->Sizes[a] > this->Sizes[b]);
+  }
+
+  const std::vector<vtkIdType> &Sizes;
+};
+
+//----------------------------------------------------------------------------
+template<class T>
+void vtkConnectivityExecute(
+  vtkImageConnectivityFilter *self, vtkImageData *inData, T *inPtr,
+  const int dims[3], vtkIdType *parent)
+{
+  std::vector<vtkConnectivityNeighbor> neighbors;
+  vtkConnectivityNeighbors(self->GetConnectivity(), dims, neighbors);
+
+  // Use slabs of at least 64k voxels, so that the merges are few
+  vtkIdType sliceSize = static_cast<vtkIdType>(dims[0])*dims[1];
+  vtkIdType grain = (65535 + sliceSize)/sliceSize;
+
+  vtkIdType inInc[3];
+  inData->GetIncrements(inInc);
+  std::vector<char> slabStart(dims[2], 0);
+  vtkConnectivityFirstPass<T> firstPass(
+    inPtr, inInc, dims, self->GetScalarRange(), parent, neighbors,
+    slabStart);
+  vtkSMPTools::For(0, dims[2], grain, firstPass);
+
+  // Merge the regions that touch across the slab boundaries
+  for (int z = 1; z < dims[2]; z++)
+    {
+    if (!slabStart[z])
+      {
+      continue;
+      }
+    vtkIdType v = sliceSize*z;
+    for (int y = 0; y < dims[1]; y++)
+      {
+      for (int x = 0; x < dims[0]; x++)
+        {
+        if (parent[v] >= 0)
+          {
+          vtkConnectivityJoin(parent, dims, x, y, z, z - 1, neighbors, true);
+          }
+        v++;
+        }
+      }
+    }
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkImageConnectivityFilter::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+
+  vtkImageData *outData = static_cast<vtkImageData *>(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData *inData = static_cast<vtkImageData *>(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  this->ExtractedRegionSizes->Initialize();
+
+  if (this->Connectivity != 6 && this->Connectivity != 18 &&
+      this->Connectivity != 26)
+    {
+    vtkErrorMacro("Execute: Connectivity must be 6, 18, or 26, not "
+                  << this->Connectivity);
+    return 0;
+    }
+  if (this->LabelScalarType != VTK_UNSIGNED_CHAR &&
+      this->LabelScalarType != VTK_SHORT &&
+      this->LabelScalarType != VTK_UNSIGNED_SHORT &&
+      this->LabelScalarType != VTK_INT)
+    {
+    vtkErrorMacro("Execute: LabelScalarType must be unsigned char, short, "
+                  "unsigned short, or int");
+    return 0;
+    }
+
+  // The labels are computed for the whole input extent
+  int extent[6];
+  inData->GetExtent(extent);
+  outData->SetExtent(extent);
+  outData->AllocateScalars(outInfo);
+  if (outData->GetNumberOfPoints() <= 0)
+    {
+    return 1;
+    }
+
+  int dims[3];
+  inData->GetDimensions(dims);
+  vtkIdType n = inData->GetNumberOfPoints();
+  std::vector<vtkIdType> regions(n);
+  vtkIdType *parent = &regions[0];
+
+  void *inPtr = inData->GetScalarPointerForExtent(extent);
+  switch (inData->GetScalarType())
+    {
+    vtkTemplateAliasMacro(
+      vtkConnectivityExecute(
+        this, inData, static_cast<VTK_TT *>(inPtr), dims, parent));
+
+    default:
+      vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+      return 0;
+    }
+  this->UpdateProgress(0.5);
+
+  // Number the regions.  Because the parent of each voxel comes before
+  // it, the parent's region is known by the time the voxel is reached.
+  std::vector<vtkIdType> sizes;
+  for (vtkIdType v = 0; v < n; v++)
+    {
+    vtkIdType p = parent[v];
+    if (p == v)
+      {
+      parent[v] = static_cast<vtkIdType>(sizes.size());
+      sizes.push_back(1);
+      }
+    else if (p >= 0)
+      {
+      parent[v] = parent[p];
+      sizes[parent[v]]++;
+      }
+    }
+
+  // Discard regions that are too large or too small
+  std::vector<vtkIdType> kept;
+  for (size_t r = 0; r < sizes.size(); r++)
+    {
+    if (sizes[r] >= this->SizeRange[0] && sizes[r] <= this->SizeRange[1])
+      {
+      kept.push_back(static_cast<vtkIdType>(r));
+      }
+    }
+  if (this->LabelMode == SIZE_RANK)
+    {
+    std::stable_sort(kept.begin(), kept.end(),
+                     vtkConnectivityLargerRegion(sizes));
+    }
+
+  std::vector<vtkIdType> labels(sizes.size(), 0);
+  vtkIdType numberOfLabels = static_cast<vtkIdType>(kept.size());
+  this->ExtractedRegionSizes->SetNumberOfValues(numberOfLabels);
+  for (vtkIdType i = 0; i < numberOfLabels; i++)
+    {
+    labels[kept[i]] = i + 1;
+    this->ExtractedRegionSizes->SetValue(i, sizes[kept[i]]);
+    }
+  if (numberOfLabels > outData->GetScalarTypeMax())
+    {
+    vtkWarningMacro("Execute: There are " << numberOfLabels << " regions, "
+                    "which is too many for the LabelScalarType "
+                    << this->GetLabelScalarTypeAsString());
+    }
+
+  void *outPtr = outData->GetScalarPointer();
+  switch (outData->GetScalarType())
+    {
+    vtkTemplateAliasMacro(
+      vtkConnectivityWrite(
+        parent, labels, static_cast<VTK_TT *>(outPtr), n));
+    }
+  this->UpdateProgress(1.0);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "ScalarRange: " << this->ScalarRange[0] << " "
+     << this->ScalarRange[1] << "\n";
+  os << indent << "Connectivity: " << this->Connectivity << "\n";
+  os << indent << "SizeRange: " << this->SizeRange[0] << " "
+     << this->SizeRange[1] << "\n";
+  os << indent << "LabelMode: "
+     << (this->LabelMode == SIZE_RANK ? "SizeRank" : "ScanOrder") << "\n";
+  os << indent << "LabelScalarType: "
+     << this->GetLabelScalarTypeAsString() << "\n";
+  os << indent << "NumberOfExtractedRegions: "
+     << this->GetNumberOfExtractedRegions() << "\n";
+}
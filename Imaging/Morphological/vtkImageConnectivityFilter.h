@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageConnectivityFilter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageConnectivityFilter - Label the connected regions of an image.
+// .SECTION Description
+// vtkImageConnectivityFilter labels every connected region of the voxels
+// whose values are within the ScalarRange, without the need for seeds.
+// The output is an image of labels, where zero is the background and the
+// regions are numbered starting at one.  Regions can be discarded based
+// on their size, and can be numbered either in the order in which they
+// are first met while scanning the image, or by decreasing size.
+//
+// The labeling is done in two passes.  In the first pass, the image is
+// split into slabs that are labeled in parallel with union-find, and then
+// the regions that touch across the boundaries between slabs are merged.
+// In the second pass, the regions are numbered and the output is written.
+// Only the first component of the input is used, and the filter needs one
+// vtkIdType of scratch space per voxel.
+// .SECTION see also
+// vtkImageThresholdConnectivity vtkImageSeedConnectivity
+
+#ifndef __vtkImageConnectivityFilter_h
+#define __vtkImageConnectivityFilter_h
+
+#include "vtkImagingMorphologicalModule.h" // For export macro
+#include "vtkImageAlgorithm.h"
+
+class vtkIdTypeArray;
+
+class VTKIMAGINGMORPHOLOGICAL_EXPORT vtkImageConnectivityFilter :
+  public vtkImageAlgorithm
+{
+public:
+  static vtkImageConnectivityFilter *New();
+  vtkTypeMacro(vtkImageConnectivityFilter, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The range of input values that are part of the regions, inclusive.
+  // The default range is [0.5, VTK_DOUBLE_MAX], i.e. all positive values
+  // of an integer image.
+  vtkSetVector2Macro(ScalarRange, double);
+  vtkGetVector2Macro(ScalarRange, double);
+
+  // Description:
+  // The neighbors of each voxel that are connected to it: 6 for the
+  // voxels that share a face, 18 for those that share a face or an edge,
+  // and 26 for those that share a face, an edge, or a corner.  The
+  // default is 6.  For 2D images, these give 4, 8, and 8 neighbors.
+  vtkSetMacro(Connectivity, int);
+  void SetConnectivityTo6() { this->SetConnectivity(6); }
+  void SetConnectivityTo18() { this->SetConnectivity(18); }
+  void SetConnectivityTo26() { this->SetConnectivity(26); }
+  vtkGetMacro(Connectivity, int);
+
+  // Description:
+  // Regions with fewer voxels than SizeRange[0] or more voxels than
+  // SizeRange[1] are set to the background.  By default, all regions
+  // are kept.
+  vtkSetVector2Macro(SizeRange, vtkIdType);
+  vtkGetVector2Macro(SizeRange, vtkIdType);
+
+  // Description:
+  // How the regions are numbered.  With SCAN_ORDER, the regions are
+  // numbered in the order of their first voxels in the image.  With
+  // SIZE_RANK, the largest region is numbered one, the next largest is
+  // numbered two, and so on.  The default is SCAN_ORDER.
+  vtkSetClampMacro(LabelMode, int, SCAN_ORDER, SIZE_RANK);
+  void SetLabelModeToScanOrder() { this->SetLabelMode(SCAN_ORDER); }
+  void SetLabelModeToSizeRank() { this->SetLabelMode(SIZE_RANK); }
+  vtkGetMacro(LabelMode, int);
+  enum LabelModeEnum
+  {
+    SCAN_ORDER = 0,
+    SIZE_RANK = 1
+  };
+
+  // Description:
+  // The scalar type for the labels, the default is unsigned short.  If
+  // there are more regions than this type can hold, the extra regions
+  // are all given the largest value of the type.
+  vtkSetMacro(LabelScalarType, int);
+  void SetLabelScalarTypeToUnsignedChar() {
+    this->SetLabelScalarType(VTK_UNSIGNED_CHAR); }
+  void SetLabelScalarTypeToShort() {
+    this->SetLabelScalarType(VTK_SHORT); }
+  void SetLabelScalarTypeToUnsignedShort() {
+    this->SetLabelScalarType(VTK_UNSIGNED_SHORT); }
+  void SetLabelScalarTypeToInt() {
+    this->SetLabelScalarType(VTK_INT); }
+  const char *GetLabelScalarTypeAsString();
+  vtkGetMacro(LabelScalarType, int);
+
+  // Description:
+  // After the filter has executed, get the number of regions that were
+  // kept, and the number of voxels in each of them.  The size of the
+  // region with label i is at index i-1 of the array.
+  vtkIdType GetNumberOfExtractedRegions();
+  vtkIdTypeArray *GetExtractedRegionSizes() {
+    return this->ExtractedRegionSizes; }
+
+protected:
+  vtkImageConnectivityFilter();
+  ~vtkImageConnectivityFilter();
+
+  double ScalarRange[2];
+  int Connectivity;
+  vtkIdType SizeRange[2];
+  int LabelMode;
+  int LabelScalarType;
+
+  vtkIdTypeArray *ExtractedRegionSizes;
+
+  virtual int RequestInformation(vtkInformation *, vtkInformationVector **,
+                                 vtkInformationVector *);
+  virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **,
+                                  vtkInformationVector *);
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
+
+private:
+  vtkImageConnectivityFilter(const vtkImageConnectivityFilter&);  // Not implemented.
+  void operator=(const vtkImageConnectivityFilter&);  // Not implemented.
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkImageEllipsoidSource.h"
+#include "vtkImageMorphologyInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -35,6 +36,8 @@ vtkImageContinuousErode3D::vtkImageContinuousErode3D()
   this->KernelSize[1] = 1;
   this->KernelSize[2] = 1;
 
+  this->BoxKernel = 0;
+
   this->Ellipse = vtkImageEllipsoidSource::New();
   // Setup the Ellipse to default size
   this->SetKernelSize(1, 1, 1);
@@ -54,6 +57,8 @@ vtkImageContinuousErode3D::~vtkImageContinuousErode3D()
 void vtkImageContinuousErode3D::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "BoxKernel: " << (this->BoxKernel ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -269,6 +274,33 @@ void vtkImageContinuousErode3DExecute(vtkImageContinuousErode3D *self,
     }
 }
 
+//----------------------------------------------------------------------------
+// This templated function computes the minimum over a box, which is much
+// faster than using a mask when the kernel is large.
+template <class T>
+void vtkImageContinuousErode3DBoxExecute(vtkImageContinuousErode3D *self,
+                                         vtkImageData *inData,
+                                         vtkDataArray *inArray,
+                                         vtkImageData *outData,
+                                         int *outExt, T *outPtr,
+                                         vtkInformation *inInfo)
+{
+  int clipExt[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), clipExt);
+  vtkIdType inInc[3], outInc[3];
+  inData->GetIncrements(inArray, inInc);
+  outData->GetIncrements(outInc);
+  T *inPtr = static_cast<T *>(inArray->GetVoidPointer(0));
+  int numComps = outData->GetNumberOfScalarComponents();
+
+  for (int idxC = 0; idxC < numComps; ++idxC)
+    {
+    vtkImageMorphologyBox<T, vtkImageMorphologyMin<T> >(
+      inPtr + idxC, inData->GetExtent(), inInc, outPtr + idxC, outExt,
+      outInc, clipExt, self->GetKernelSize(), self->GetKernelMiddle());
+    }
+}
+
 //----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output Data types.
@@ -319,6 +351,25 @@ void vtkImageContinuousErode3D::ThreadedRequestData(
     return;
     }
 
+  // use the fast method if the kernel is a box
+  if (this->BoxKernel ||
+      vtkImageMorphologyIsBox(
+        static_cast<unsigned char *>(mask->GetScalarPointer()),
+        mask->GetNumberOfPoints()))
+    {
+    switch (inArray->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkImageContinuousErode3DBoxExecute(this, inData[0][0], inArray,
+                                            outData[0], outExt,
+                                            static_cast<VTK_TT *>(outPtr),
+                                            inInfo));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      }
+    return;
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
@@ -43,11 +43,22 @@ public:
   // default middle of the neighborhood and computes the elliptical foot print.
   void SetKernelSize(int size0, int size1, int size2);
 
+  // Description:
+  // Use a box of size KernelSize instead of an ellipsoid.  The minimum
+  // over a box is computed one axis at a time with the van Herk/Gil-Werman
+  // algorithm, so the time per voxel does not depend on the kernel size.
+  // Kernels for which the ellipsoid fills the whole box, such as 3x3x1,
+  // always use this method.  The default is off.
+  vtkSetMacro(BoxKernel, int);
+  vtkBooleanMacro(BoxKernel, int);
+  vtkGetMacro(BoxKernel, int);
+
 protected:
   vtkImageContinuousErode3D();
   ~vtkImageContinuousErode3D();
 
   vtkImageEllipsoidSource *Ellipse;
+  int BoxKernel;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -15,11 +15,14 @@
 #include "vtkImageDilateErode3D.h"
 #include "vtkImageData.h"
 #include "vtkImageEllipsoidSource.h"
+#include "vtkImageMorphologyInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkImageDilateErode3D);
 
 //----------------------------------------------------------------------------
@@ -34,6 +37,7 @@ vtkImageDilateErode3D::vtkImageDilateErode3D()
 
   this->DilateValue = 0.0;
   this->ErodeValue = 255.0;
+  this->BoxKernel = 0;
 
   this->Ellipse = vtkImageEllipsoidSource::New();
   // Setup the Ellipse to default size
@@ -57,6 +61,7 @@ void vtkImageDilateErode3D::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "DilateValue: " << this->DilateValue << "\n";
   os << indent << "ErodeValue: " << this->ErodeValue << "\n";
+  os << indent << "BoxKernel: " << (this->BoxKernel ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -269,6 +274,82 @@ void vtkImageDilateErode3DExecute(vtkImageDilateErode3D *self,
     }
 }
 
+//----------------------------------------------------------------------------
+// This templated function handles kernels that are boxes.  It finds the
+// voxels that have the dilate value within the box by computing the
+// maximum over the box of an image that marks the dilate value.
+template <class T>
+void vtkImageDilateErode3DBoxExecute(vtkImageDilateErode3D *self,
+                                     vtkImageData *inData, int *inExt,
+                                     T *inPtr, vtkImageData *outData,
+                                     int *outExt, T *outPtr,
+                                     vtkInformation *inInfo)
+{
+  int clipExt[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), clipExt);
+  vtkIdType inInc[3], outInc[3];
+  inData->GetIncrements(inInc);
+  outData->GetIncrements(outInc);
+  int numComps = outData->GetNumberOfScalarComponents();
+  T erodeValue = static_cast<T>(self->GetErodeValue());
+  T dilateValue = static_cast<T>(self->GetDilateValue());
+
+  // The marks for the input, and their maximum for the output
+  vtkIdType markInc[3];
+  markInc[0] = 1;
+  markInc[1] = inExt[1] - inExt[0] + 1;
+  markInc[2] = markInc[1]*(inExt[3] - inExt[2] + 1);
+  std::vector<unsigned char> marks(markInc[2]*(inExt[5] - inExt[4] + 1));
+  vtkIdType hitInc[3];
+  hitInc[0] = 1;
+  hitInc[1] = outExt[1] - outExt[0] + 1;
+  hitInc[2] = hitInc[1]*(outExt[3] - outExt[2] + 1);
+  std::vector<unsigned char> hits(hitInc[2]*(outExt[5] - outExt[4] + 1));
+
+  for (int idxC = 0; idxC < numComps; ++idxC)
+    {
+    unsigned char *markPtr = &marks[0];
+    for (int idx2 = inExt[4]; idx2 <= inExt[5]; ++idx2)
+      {
+      for (int idx1 = inExt[2]; idx1 <= inExt[3]; ++idx1)
+        {
+        T *inPtr0 = inPtr + ((idx1 - inExt[2])*inInc[1] +
+                             (idx2 - inExt[4])*inInc[2] + idxC);
+        for (int idx0 = inExt[0]; idx0 <= inExt[1]; ++idx0)
+          {
+          *markPtr++ = (*inPtr0 == dilateValue);
+          inPtr0 += inInc[0];
+          }
+        }
+      }
+
+    vtkImageMorphologyBox<unsigned char, vtkImageMorphologyMax<unsigned char> >(
+      &marks[0], inExt, markInc, &hits[0], outExt, hitInc, clipExt,
+      self->GetKernelSize(), self->GetKernelMiddle());
+
+    unsigned char *hitPtr = &hits[0];
+    for (int idx2 = outExt[4]; idx2 <= outExt[5]; ++idx2)
+      {
+      for (int idx1 = outExt[2]; idx1 <= outExt[3]; ++idx1)
+        {
+        T *inPtr0 = inPtr + ((outExt[0] - inExt[0])*inInc[0] +
+                             (idx1 - inExt[2])*inInc[1] +
+                             (idx2 - inExt[4])*inInc[2] + idxC);
+        T *outPtr0 = outPtr + ((idx1 - outExt[2])*outInc[1] +
+                               (idx2 - outExt[4])*outInc[2] + idxC);
+        for (int idx0 = outExt[0]; idx0 <= outExt[1]; ++idx0)
+          {
+          *outPtr0 = ((*inPtr0 == erodeValue && *hitPtr) ?
+                      dilateValue : *inPtr0);
+          hitPtr++;
+          inPtr0 += inInc[0];
+          outPtr0 += outInc[0];
+          }
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output Data types.
@@ -306,6 +387,26 @@ void vtkImageDilateErode3D::ThreadedRequestData(
     return;
     }
 
+  // use the fast method if the kernel is a box
+  if (this->BoxKernel ||
+      vtkImageMorphologyIsBox(
+        static_cast<unsigned char *>(mask->GetScalarPointer()),
+        mask->GetNumberOfPoints()))
+    {
+    switch (inData[0][0]->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageDilateErode3DBoxExecute(this, inData[0][0], inExt,
+                                        static_cast<VTK_TT *>(inPtr),
+                                        outData[0], outExt,
+                                        static_cast<VTK_TT *>(outPtr),
+                                        inInfo));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      }
+    return;
+    }
+
   switch (inData[0][0]->GetScalarType())
     {
     vtkTemplateMacro(
@@ -53,6 +53,16 @@ public:
   vtkSetMacro(ErodeValue, double);
   vtkGetMacro(ErodeValue, double);
 
+  // Description:
+  // Use a box of size KernelSize instead of an ellipsoid.  The box is
+  // processed one axis at a time with the van Herk/Gil-Werman algorithm,
+  // so the time per voxel does not depend on the kernel size.  Kernels
+  // for which the ellipsoid fills the whole box, such as 3x3x1, always
+  // use this method.  The default is off.
+  vtkSetMacro(BoxKernel, int);
+  vtkBooleanMacro(BoxKernel, int);
+  vtkGetMacro(BoxKernel, int);
+
 protected:
   vtkImageDilateErode3D();
   ~vtkImageDilateErode3D();
@@ -60,6 +70,7 @@ protected:
   vtkImageEllipsoidSource *Ellipse;
   double DilateValue;
   double ErodeValue;
+  int BoxKernel;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageMorphologyInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageMorphologyInternals - Box minimum and maximum for images
+// .SECTION Description
+// This is a helper for the morphology filters.  It computes the minimum
+// or maximum over a box-shaped neighborhood with the van Herk/Gil-Werman
+// algorithm, one axis at a time, which takes a constant number of
+// comparisons per voxel regardless of the size of the box.
+
+#ifndef __vtkImageMorphologyInternals_h
+#define __vtkImageMorphologyInternals_h
+
+#include "vtkSystemIncludes.h"
+#include "vtkTypeTraits.h"
+
+#include <vector>
+
+namespace {
+
+//----------------------------------------------------------------------------
+template<class T>
+struct vtkImageMorphologyMax
+{
+  static T Identity() { return vtkTypeTraits<T>::Min(); }
+  static T Op(T a, T b) { return (b > a ? b : a); }
+};
+
+template<class T>
+struct vtkImageMorphologyMin
+{
+  static T Identity() { return vtkTypeTraits<T>::Max(); }
+  static T Op(T a, T b) { return (b < a ? b : a); }
+};
+
+//----------------------------------------------------------------------------
+// Apply the operation over a window of "size" samples along one line.
+// The window for output i covers input samples [i - middle, i - middle +
+// size - 1], and samples outside [clipMin, clipMax] are ignored.  The
+// "in" pointer is for index inMin, and "out" is for index outMin.
+template<class T, class OP>
+void vtkImageMorphologyLine(
+  const T *in, vtkIdType inInc, int inMin, T *out, vtkIdType outInc,
+  int outMin, int outMax, int clipMin, int clipMax, int size, int middle,
+  std::vector<T> &buffer)
+{
+  // the padded input, with blocks that start at the first window
+  int start = outMin - middle;
+  int m = outMax - outMin + size;
+  buffer.resize(3*m);
+  T *p = &buffer[0];
+  T *g = p + m;
+  T *h = g + m;
+  for (int j = 0; j < m; j++)
+    {
+    int idx = start + j;
+    p[j] = ((idx >= clipMin && idx <= clipMax) ?
+            in[(idx - inMin)*inInc] : OP::Identity());
+    }
+
+  // g accumulates forward from the start of each block, and h accumulates
+  // backward from the end of each block
+  for (int b = 0; b < m; b += size)
+    {
+    int e = (b + size < m ? b + size : m);
+    g[b] = p[b];
+    for (int j = b + 1; j < e; j++)
+      {
+      g[j] = OP::Op(g[j - 1], p[j]);
+      }
+    h[e - 1] = p[e - 1];
+    for (int j = e - 2; j >= b; j--)
+      {
+      h[j] = OP::Op(h[j + 1], p[j]);
+      }
+    }
+
+  // each window spans at most two blocks
+  for (int i = 0; i <= outMax - outMin; i++)
+    {
+    *out = OP::Op(h[i], g[i + size - 1]);
+    out += outInc;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the minimum or maximum over a box for one component.  The input
+// must cover the output extent grown by the box and clipped by clipExt,
+// and samples outside of clipExt are ignored.  The pointers are for the
+// first voxels of inExt and outExt, and the increments are in scalars.
+template<class T, class OP>
+void vtkImageMorphologyBox(
+  const T *inPtr, const int inExt[6], const vtkIdType inInc[3],
+  T *outPtr, const int outExt[6], const vtkIdType outInc[3],
+  const int clipExt[6], const int kernelSize[3], const int kernelMiddle[3])
+{
+  // The extent and increments of the source for the current axis
+  const T *srcPtr = inPtr;
+  int srcExt[6];
+  vtkIdType srcInc[3];
+  for (int j = 0; j < 6; j++)
+    {
+    srcExt[j] = inExt[j];
+    }
+  for (int j = 0; j < 3; j++)
+    {
+    srcInc[j] = inInc[j];
+    }
+
+  std::vector<T> temp[2];
+  std::vector<T> buffer;
+  for (int axis = 0; axis < 3; axis++)
+    {
+    // The result of this pass covers the output extent along the axes
+    // that are done, and the source extent along the others
+    int dstExt[6];
+    vtkIdType dstInc[3];
+    T *dstPtr;
+    for (int j = 0; j < 6; j++)
+      {
+      dstExt[j] = (j/2 <= axis ? outExt[j] : srcExt[j]);
+      }
+    if (axis == 2)
+      {
+      dstPtr = outPtr;
+      dstInc[0] = outInc[0];
+      dstInc[1] = outInc[1];
+      dstInc[2] = outInc[2];
+      }
+    else
+      {
+      std::vector<T> &t = temp[axis];
+      dstInc[0] = 1;
+      dstInc[1] = (dstExt[1] - dstExt[0] + 1);
+      dstInc[2] = dstInc[1]*(dstExt[3] - dstExt[2] + 1);
+      t.resize(dstInc[2]*(dstExt[5] - dstExt[4] + 1));
+      dstPtr = &t[0];
+      }
+
+    // The other two axes, which are looped over
+    int a1 = (axis == 0 ? 1 : 0);
+    int a2 = (axis == 2 ? 1 : 2);
+    int clipMin = (clipExt[2*axis] > srcExt[2*axis] ?
+                   clipExt[2*axis] : srcExt[2*axis]);
+    int clipMax = (clipExt[2*axis+1] < srcExt[2*axis+1] ?
+                   clipExt[2*axis+1] : srcExt[2*axis+1]);
+
+    for (int i2 = dstExt[2*a2]; i2 <= dstExt[2*a2+1]; i2++)
+      {
+      for (int i1 = dstExt[2*a1]; i1 <= dstExt[2*a1+1]; i1++)
+        {
+        const T *src = srcPtr + ((i1 - srcExt[2*a1])*srcInc[a1] +
+                                 (i2 - srcExt[2*a2])*srcInc[a2]);
+        T *dst = dstPtr + ((i1 - dstExt[2*a1])*dstInc[a1] +
+                           (i2 - dstExt[2*a2])*dstInc[a2]);
+        vtkImageMorphologyLine<T, OP>(
+          src, srcInc[axis], srcExt[2*axis], dst, dstInc[axis],
+          outExt[2*axis], outExt[2*axis+1], clipMin, clipMax,
+          kernelSize[axis], kernelMiddle[axis], buffer);
+        }
+      }
+
+    srcPtr = dstPtr;
+    for (int j = 0; j < 6; j++)
+      {
+      srcExt[j] = dstExt[j];
+      }
+    for (int j = 0; j < 3; j++)
+      {
+      srcInc[j] = dstInc[j];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Check whether a kernel mask has no zeros, i.e. whether it is a box.
+inline bool vtkImageMorphologyIsBox(const unsigned char *mask, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    if (mask[i] == 0)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImageMorphologyInternals.h
@@ -15,12 +15,15 @@
 #include "vtkImageAccumulate.h"
 
 #include "vtkImageData.h"
+#include "vtkImageHistogramInternals.h"
 #include "vtkImageStencilData.h"
 #include "vtkImageStencilIterator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <math.h>
@@ -124,55 +127,110 @@ vtkImageStencilData *vtkImageAccumulate::GetStencil()
 
 
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
+// The counts and sums for one thread.
+struct vtkImageAccumulateThreadData
+{
+  vtkImageHistogramPartial Bins;
+  double Sum[3];
+  double SumSqr[3];
+  double Min[3];
+  double Max[3];
+  vtkIdType VoxelCount;
+};
+
+//----------------------------------------------------------------------------
+// Accumulate slabs of the input into the thread local bins and statistics.
 template <class T>
-void vtkImageAccumulateExecute(vtkImageAccumulate *self,
-                               vtkImageData *inData, T *,
-                               vtkImageData *outData, vtkIdType *outPtr,
-                               double min[3], double max[3],
-                               double mean[3],
-                               double standardDeviation[3],
-                               vtkIdType *voxelCount,
-                               int* updateExtent)
+class vtkImageAccumulateFunctor
 {
-  // variables used to compute statistics (filter handles max 3 components)
-  double sum[3];
-  sum[0] = sum[1] = sum[2] = 0.0;
-  double sumSqr[3];
-  sumSqr[0] = sumSqr[1] = sumSqr[2] = 0.0;
-  min[0] = min[1] = min[2] = VTK_DOUBLE_MAX;
-  max[0] = max[1] = max[2] = VTK_DOUBLE_MIN;
-  standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-  *voxelCount = 0;
+public:
+  vtkImageAccumulateFunctor(vtkImageAccumulate *self, vtkImageData *inData,
+                            vtkImageData *outData, int extent[6], int axis)
+    : Self(self), InData(inData), Axis(axis)
+  {
+    for (int i = 0; i < 6; i++)
+      {
+      this->Extent[i] = extent[i];
+      }
+    outData->GetExtent(this->OutExtent);
+    outData->GetIncrements(this->OutIncs);
+    outData->GetOrigin(this->Origin);
+    outData->GetSpacing(this->Spacing);
+    this->NumberOfBins = outData->GetNumberOfPoints();
+    this->Stencil = self->GetStencil();
+    this->ReverseStencil = (self->GetReverseStencil() != 0);
+    this->IgnoreZero = (self->GetIgnoreZero() != 0);
+  }
+
+  void Initialize()
+  {
+    vtkImageAccumulateThreadData &data = this->ThreadData.Local();
+    for (int idxC = 0; idxC < 3; idxC++)
+      {
+      data.Sum[idxC] = 0.0;
+      data.SumSqr[idxC] = 0.0;
+      data.Min[idxC] = VTK_DOUBLE_MAX;
+      data.Max[idxC] = VTK_DOUBLE_MIN;
+      }
+    data.VoxelCount = 0;
+    data.Bins.Require(0, this->NumberOfBins - 1);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end);
+
+  // the thread local results are combined by vtkImageAccumulateExecute
+  void Reduce() {}
+
+  vtkSMPThreadLocal<vtkImageAccumulateThreadData> ThreadData;
+
+private:
+  vtkImageAccumulate *Self;
+  vtkImageData *InData;
+  vtkImageStencilData *Stencil;
+  bool ReverseStencil;
+  bool IgnoreZero;
+  int Extent[6];
+  int Axis;
+  int OutExtent[6];
+  vtkIdType OutIncs[3];
+  double Origin[3];
+  double Spacing[3];
+  vtkIdType NumberOfBins;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageAccumulateFunctor<T>::operator()(vtkIdType begin, vtkIdType end)
+{
+  vtkImageAccumulateThreadData &data = this->ThreadData.Local();
+  double *sum = data.Sum;
+  double *sumSqr = data.SumSqr;
+  double *min = data.Min;
+  double *max = data.Max;
+  vtkIdType *voxelCount = &data.VoxelCount;
+  vtkIdType *outPtr = &data.Bins.Bins[0];
 
   // input's number of components is used as output dimensionality
-  int numC = inData->GetNumberOfScalarComponents();
-
-  // get information for output data
-  int outExtent[6];
-  outData->GetExtent(outExtent);
-  vtkIdType outIncs[3];
-  outData->GetIncrements(outIncs);
-  double origin[3];
-  outData->GetOrigin(origin);
-  double spacing[3];
-  outData->GetSpacing(spacing);
-
-  // zero count in every bin
-  vtkIdType size = 1;
-  size *= (outExtent[1] - outExtent[0] + 1);
-  size *= (outExtent[3] - outExtent[2] + 1);
-  size *= (outExtent[5] - outExtent[4] + 1);
-  for (vtkIdType j = 0; j < size; j++)
+  int numC = this->InData->GetNumberOfScalarComponents();
+  int *outExtent = this->OutExtent;
+  vtkIdType *outIncs = this->OutIncs;
+  double *origin = this->Origin;
+  double *spacing = this->Spacing;
+  bool reverseStencil = this->ReverseStencil;
+  bool ignoreZero = this->IgnoreZero;
+
+  int extent[6];
+  for (int i = 0; i < 6; i++)
     {
-    outPtr[j] = 0;
+    extent[i] = this->Extent[i];
     }
+  extent[2*this->Axis] = static_cast<int>(begin);
+  extent[2*this->Axis + 1] = static_cast<int>(end - 1);
 
-  vtkImageStencilData *stencil = self->GetStencil();
-  bool reverseStencil = (self->GetReverseStencil() != 0);
-  bool ignoreZero = (self->GetIgnoreZero() != 0);
-
-  vtkImageStencilIterator<T> inIter(inData, stencil, updateExtent, self);
+  // only the first slab reports progress
+  vtkImageStencilIterator<T> inIter(
+    this->InData, this->Stencil, extent,
+    (begin == this->Extent[2*this->Axis] ? this->Self : NULL));
 
   while (!inIter.IsAtEnd())
     {
@@ -229,6 +287,75 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
 
     inIter.NextSpan();
     }
+}
+
+//----------------------------------------------------------------------------
+// This templated function executes the filter for any type of data.  Each
+// thread has its own bins, unless the histogram is so large compared to
+// the image that it is better to do all of the counting in one thread.
+template <class T>
+void vtkImageAccumulateExecute(vtkImageAccumulate *self,
+                               vtkImageData *inData, T *,
+                               vtkImageData *outData, vtkIdType *outPtr,
+                               double min[3], double max[3],
+                               double mean[3],
+                               double standardDeviation[3],
+                               vtkIdType *voxelCount,
+                               int* updateExtent)
+{
+  // split along the slowest axis that has more than one slice
+  int axis = 2;
+  while (axis > 0 && updateExtent[2*axis] == updateExtent[2*axis+1])
+    {
+    axis--;
+    }
+
+  vtkImageAccumulateFunctor<T> functor(self, inData, outData, updateExtent,
+                                       axis);
+  vtkIdType numBins = outData->GetNumberOfPoints();
+  vtkIdType numVoxels = 1;
+  for (int i = 0; i < 3; i++)
+    {
+    numVoxels *= updateExtent[2*i+1] - updateExtent[2*i] + 1;
+    }
+  if (numVoxels >= 4*numBins)
+    {
+    vtkSMPTools::For(updateExtent[2*axis], updateExtent[2*axis+1] + 1,
+                     functor);
+    }
+  else
+    {
+    functor.Initialize();
+    functor(updateExtent[2*axis], updateExtent[2*axis+1] + 1);
+    }
+
+  // variables used to compute statistics (filter handles max 3 components)
+  double sum[3];
+  sum[0] = sum[1] = sum[2] = 0.0;
+  double sumSqr[3];
+  sumSqr[0] = sumSqr[1] = sumSqr[2] = 0.0;
+  min[0] = min[1] = min[2] = VTK_DOUBLE_MAX;
+  max[0] = max[1] = max[2] = VTK_DOUBLE_MIN;
+  *voxelCount = 0;
+
+  // combine the results from all the threads
+  std::vector<const vtkImageHistogramPartial *> partials;
+  vtkSMPThreadLocal<vtkImageAccumulateThreadData>::iterator iter;
+  for (iter = functor.ThreadData.begin();
+       iter != functor.ThreadData.end(); ++iter)
+    {
+    vtkImageAccumulateThreadData &data = *iter;
+    for (int idxC = 0; idxC < 3; idxC++)
+      {
+      sum[idxC] += data.Sum[idxC];
+      sumSqr[idxC] += data.SumSqr[idxC];
+      min[idxC] = (data.Min[idxC] < min[idxC] ? data.Min[idxC] : min[idxC]);
+      max[idxC] = (data.Max[idxC] > max[idxC] ? data.Max[idxC] : max[idxC]);
+      }
+    *voxelCount += data.VoxelCount;
+    partials.push_back(&data.Bins);
+    }
+  vtkImageHistogramMerge(outPtr, numBins, partials);
 
   // initialize the statistics
   mean[0] = 0;
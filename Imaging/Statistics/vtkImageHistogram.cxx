@@ -18,12 +18,15 @@
 #include "vtkMath.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
+#include "vtkImageHistogramInternals.h"
 #include "vtkImageStencilData.h"
 #include "vtkImageStencilIterator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMultiThreader.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTemplateAliasMacro.h"
 
 #include <math.h>
@@ -36,6 +39,16 @@
 
 vtkStandardNewMacro(vtkImageHistogram);
 
+//----------------------------------------------------------------------------
+// The partial histograms, indexed by thread id for vtkMultiThreader, or
+// kept in thread local storage for vtkSMPTools.
+class vtkImageHistogramThreadData
+{
+public:
+  std::vector<vtkImageHistogramPartial> PerThread;
+  vtkSMPThreadLocal<vtkImageHistogramPartial> Local;
+};
+
 //----------------------------------------------------------------------------
 // Constructor sets default values
 vtkImageHistogram::vtkImageHistogram()
@@ -55,6 +68,8 @@ vtkImageHistogram::vtkImageHistogram()
   this->Histogram = vtkIdTypeArray::New();
   this->Total = 0;
 
+  this->ThreadData = new vtkImageHistogramThreadData;
+
   this->SetNumberOfInputPorts(2);
   this->SetNumberOfOutputPorts(1);
 }
@@ -66,6 +81,7 @@ vtkImageHistogram::~vtkImageHistogram()
     {
     this->Histogram->Delete();
     }
+  delete this->ThreadData;
 }
 
 //----------------------------------------------------------------------------
@@ -310,6 +326,49 @@ VTK_THREAD_RETURN_TYPE vtkImageHistogramThreadedExecute(void *arg)
   return VTK_THREAD_RETURN_VALUE;
 }
 
+//----------------------------------------------------------------------------
+// Run ThreadedRequestData for a range of pieces of the input extent, for
+// use with vtkSMPTools instead of vtkMultiThreader
+class vtkImageHistogramFunctor
+{
+public:
+  vtkImageHistogramFunctor(vtkImageHistogramThreadStruct *ts,
+                           int extent[6], int pieces)
+    : ThreadStruct(ts), NumberOfPieces(pieces)
+  {
+    for (int i = 0; i < 6; i++)
+      {
+      this->Extent[i] = extent[i];
+      }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkImageHistogramThreadStruct *ts = this->ThreadStruct;
+    for (vtkIdType piece = begin; piece < end; piece++)
+      {
+      int splitExt[6];
+      int total = ts->Algorithm->SplitExtent(
+        splitExt, this->Extent, static_cast<int>(piece), this->NumberOfPieces);
+
+      if (piece < total &&
+          splitExt[1] >= splitExt[0] &&
+          splitExt[3] >= splitExt[2] &&
+          splitExt[5] >= splitExt[4])
+        {
+        ts->Algorithm->ThreadedRequestData(
+          ts->Request, ts->InputsInfo, ts->OutputsInfo, NULL, NULL,
+          splitExt, static_cast<int>(piece));
+        }
+      }
+  }
+
+private:
+  vtkImageHistogramThreadStruct *ThreadStruct;
+  int NumberOfPieces;
+  int Extent[6];
+};
+
 //----------------------------------------------------------------------------
 template<class T>
 void vtkImageHistogramExecuteRange(
@@ -360,6 +419,84 @@ void vtkImageHistogramExecuteRange(
   range[1] = xmax;
 }
 
+//----------------------------------------------------------------------------
+// Compute the range of the data for slabs of the extent in parallel
+class vtkImageHistogramRangeFunctor
+{
+public:
+  struct Range
+  {
+    Range() { this->Value[0] = VTK_DOUBLE_MAX;
+              this->Value[1] = -VTK_DOUBLE_MAX; }
+    double Value[2];
+  };
+
+  vtkImageHistogramRangeFunctor(vtkImageData *data, int extent[6],
+                                int axis, int component)
+    : Data(data), Axis(axis), Component(component)
+  {
+    for (int i = 0; i < 6; i++)
+      {
+      this->Extent[i] = extent[i];
+      }
+  }
+
+  // the ranges are initialized by their constructor, but Initialize()
+  // must be present for vtkSMPTools to call Reduce()
+  void Initialize() {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    int extent[6];
+    for (int i = 0; i < 6; i++)
+      {
+      extent[i] = this->Extent[i];
+      }
+    extent[2*this->Axis] = static_cast<int>(begin);
+    extent[2*this->Axis + 1] = static_cast<int>(end - 1);
+
+    void *inPtr = this->Data->GetScalarPointerForExtent(extent);
+    double range[2];
+    switch (this->Data->GetScalarType())
+      {
+      vtkTemplateAliasMacro(
+        vtkImageHistogramExecuteRange(
+          this->Data, 0, static_cast<VTK_TT *>(inPtr),
+          extent, range, this->Component));
+      default:
+        return;
+      }
+
+    double *value = this->LocalRange.Local().Value;
+    value[0] = (value[0] < range[0] ? value[0] : range[0]);
+    value[1] = (value[1] > range[1] ? value[1] : range[1]);
+  }
+
+  void Reduce()
+  {
+    this->Result[0] = VTK_DOUBLE_MAX;
+    this->Result[1] = -VTK_DOUBLE_MAX;
+    vtkSMPThreadLocal<Range>::iterator iter = this->LocalRange.begin();
+    for (; iter != this->LocalRange.end(); ++iter)
+      {
+      const double *value = (*iter).Value;
+      this->Result[0] = (this->Result[0] < value[0] ?
+                         this->Result[0] : value[0]);
+      this->Result[1] = (this->Result[1] > value[1] ?
+                         this->Result[1] : value[1]);
+      }
+  }
+
+  double Result[2];
+
+private:
+  vtkImageData *Data;
+  int Extent[6];
+  int Axis;
+  int Component;
+  vtkSMPThreadLocal<Range> LocalRange;
+};
+
 //----------------------------------------------------------------------------
 template<class T>
 void vtkImageHistogramExecute(
@@ -579,11 +716,15 @@ int vtkImageHistogram::RequestData(
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  // clear the thread output pointers
+  // clear the partial histograms from any previous execution
   int n = this->GetNumberOfThreads();
-  for (int k = 0; k < n; k++)
+  this->ThreadData->PerThread.clear();
+  this->ThreadData->PerThread.resize(n);
+  vtkSMPThreadLocal<vtkImageHistogramPartial>::iterator iter;
+  for (iter = this->ThreadData->Local.begin();
+       iter != this->ThreadData->Local.end(); ++iter)
     {
-    this->ThreadOutput[k] = 0;
+    *iter = vtkImageHistogramPartial();
     }
 
   vtkInformation* info = inputVector[0]->GetInformationObject(0);
@@ -703,13 +844,40 @@ int vtkImageHistogram::RequestData(
       }
     }
 
-  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
-  this->Threader->SetSingleMethod(vtkImageHistogramThreadedExecute, &ts);
-
   // always shut off debugging to avoid threading problems with GetMacros
   int debug = this->Debug;
   this->Debug = 0;
-  this->Threader->SingleMethodExecute();
+  if (this->EnableSMP)
+    {
+    // split the input extent into pieces of about DesiredBytesPerPiece
+    vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+    vtkImageData *inData = vtkImageData::SafeDownCast(
+      inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    int extent[6];
+    inData->GetExtent(extent);
+    vtkIdType bytes = static_cast<vtkIdType>(inData->GetScalarSize())*
+      inData->GetNumberOfScalarComponents();
+    for (int i = 0; i < 3; i++)
+      {
+      bytes *= (extent[2*i+1] >= extent[2*i] ?
+                extent[2*i+1] - extent[2*i] + 1 : 0);
+      }
+    vtkIdType pieces = (bytes + this->DesiredBytesPerPiece - 1)/
+      this->DesiredBytesPerPiece;
+    pieces = (pieces < VTK_INT_MAX ? pieces : VTK_INT_MAX);
+    int splitExt[6];
+    int numPieces = this->SplitExtent(
+      splitExt, extent, 0, static_cast<int>(pieces > 1 ? pieces : 1));
+
+    vtkImageHistogramFunctor functor(&ts, extent, numPieces);
+    vtkSMPTools::For(0, numPieces, 1, functor);
+    }
+  else
+    {
+    this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+    this->Threader->SetSingleMethod(vtkImageHistogramThreadedExecute, &ts);
+    this->Threader->SingleMethodExecute();
+    }
   this->Debug = debug;
 
   // end of code copied from vtkThreadedImageAlgorithm
@@ -719,39 +887,40 @@ int vtkImageHistogram::RequestData(
   this->Histogram->SetNumberOfTuples(this->NumberOfBins);
   vtkIdType *histogram = this->Histogram->GetPointer(0);
 
-  // clear histogram to zero
-  int nx = this->NumberOfBins;
-  int ix;
-  for (ix = 0; ix < nx; ++ix)
+  // piece together the histogram results from each thread
+  std::vector<const vtkImageHistogramPartial *> partials;
+  if (this->EnableSMP)
     {
-    histogram[ix] = 0;
+    for (iter = this->ThreadData->Local.begin();
+         iter != this->ThreadData->Local.end(); ++iter)
+      {
+      partials.push_back(&(*iter));
+      }
     }
-
-  // piece together the histogram results from each thread
-  vtkIdType total = 0;
-  for (int j = 0; j < n; j++)
+  else
     {
-    vtkIdType *outPtr2 = this->ThreadOutput[j];
-    if (outPtr2)
+    for (int j = 0; j < n; j++)
       {
-      int xmin = this->ThreadBinRange[j][0];
-      int xmax = this->ThreadBinRange[j][1];
-      for (ix = xmin; ix <= xmax; ++ix)
-        {
-        vtkIdType c = *outPtr2++;
-        histogram[ix] += c;
-        total += c;
-        }
+      partials.push_back(&this->ThreadData->PerThread[j]);
       }
     }
+  int nx = this->NumberOfBins;
+  vtkImageHistogramMerge(histogram, nx, partials);
 
   // set the total
+  vtkIdType total = 0;
+  for (int ix = 0; ix < nx; ++ix)
+    {
+    total += histogram[ix];
+    }
   this->Total = total;
 
-  // delete the temporary memory
-  for (int j = 0; j < n; j++)
+  // release the partial histograms
+  this->ThreadData->PerThread.clear();
+  for (iter = this->ThreadData->Local.begin();
+       iter != this->ThreadData->Local.end(); ++iter)
     {
-    delete [] this->ThreadOutput[j];
+    *iter = vtkImageHistogramPartial();
     }
 
   // generate the output image
@@ -801,7 +970,7 @@ void vtkImageHistogram::ThreadedRequestData(
     scalarType != VTK_FLOAT && scalarType != VTK_DOUBLE);
 
   double scalarRange[2];
-  int *binRange = this->ThreadBinRange[threadId];
+  int binRange[2];
 
   // compute the scalar range of the data unless it is byte data,
   // this allows us to allocate less memory for the histogram
@@ -847,18 +1016,18 @@ void vtkImageHistogram::ThreadedRequestData(
   binRange[0] = vtkMath::Floor(minBinRange + 0.5);
   binRange[1] = vtkMath::Floor(maxBinRange + 0.5);
 
-  // allocate the histogram
-  int n = binRange[1] - binRange[0] + 1;
-  vtkIdType *histogram = new vtkIdType[n];
-  this->ThreadOutput[threadId] = histogram;
-  vtkIdType *tmpPtr = histogram;
-  do { *tmpPtr++ = 0; } while (--n);
+  // get the partial histogram for this thread, which can be indexed
+  // directly by bin number
+  vtkImageHistogramPartial *partial = (this->EnableSMP ?
+    &this->ThreadData->Local.Local() :
+    &this->ThreadData->PerThread[threadId]);
+  vtkIdType *histogram = partial->Require(binRange[0], binRange[1]);
 
   // generate the histogram
   if (useFastExecute)
     {
-    // adjust the pointer to allow direct indexing
-    histogram -= binRange[0] + vtkMath::Floor(binOrigin + 0.5);
+    // adjust the pointer to allow direct indexing by value
+    histogram -= vtkMath::Floor(binOrigin + 0.5);
 
     // fast path for integer data
     switch(scalarType)
@@ -873,9 +1042,6 @@ void vtkImageHistogram::ThreadedRequestData(
     }
   else
     {
-    // adjust the pointer to allow direct indexing
-    histogram -= binRange[0];
-
     // bin via floating point shift/scale
     switch (scalarType)
       {
@@ -900,17 +1066,17 @@ void vtkImageHistogram::ComputeImageScalarRange(
     return;
     }
 
+  // split along the slowest axis that has more than one slice
   int *extent = data->GetExtent();
-  void *inPtr = data->GetScalarPointerForExtent(extent);
-  int component = this->ActiveComponent;
-
-  switch (data->GetScalarType())
+  int axis = 2;
+  while (axis > 0 && extent[2*axis] == extent[2*axis+1])
     {
-    vtkTemplateAliasMacro(
-      vtkImageHistogramExecuteRange(
-        data, 0, static_cast<VTK_TT *>(inPtr),
-        extent, range, component));
-    default:
-      vtkErrorMacro(<< "Execute: Unknown ScalarType");
+    axis--;
     }
+
+  vtkImageHistogramRangeFunctor functor(
+    data, extent, axis, this->ActiveComponent);
+  vtkSMPTools::For(extent[2*axis], extent[2*axis+1] + 1, functor);
+  range[0] = functor.Result[0];
+  range[1] = functor.Result[1];
 }
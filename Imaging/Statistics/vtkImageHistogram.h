@@ -21,6 +21,12 @@
 // histogram will be the sum of the histograms of each of the individual
 // components, unless SetActiveComponent is used to choose a single
 // component.
+//
+// Each thread counts into its own partial histogram, which only covers
+// the bins for the range of values that the thread has seen, and the
+// partial histograms are summed in parallel by dividing the bins among
+// the threads.  When EnableSMP is On, the input is split into pieces
+// that are run on the vtkSMPTools backend.
 // .SECTION Thanks
 // Thanks to David Gobbi at the Seaman Family MR Centre and Dept. of Clinical
 // Neurosciences, Foothills Medical Centre, Calgary, for providing this class.
@@ -33,6 +39,7 @@
 
 class vtkImageStencilData;
 class vtkIdTypeArray;
+class vtkImageHistogramThreadData;
 
 class VTKIMAGINGSTATISTICS_EXPORT vtkImageHistogram : public vtkThreadedImageAlgorithm
 {
@@ -192,8 +199,7 @@ protected:
   vtkIdTypeArray *Histogram;
   vtkIdType Total;
 
-  vtkIdType *ThreadOutput[VTK_MAX_THREADS];
-  int ThreadBinRange[VTK_MAX_THREADS][2];
+  vtkImageHistogramThreadData *ThreadData;
 
 private:
   vtkImageHistogram(const vtkImageHistogram&);  // Not implemented.
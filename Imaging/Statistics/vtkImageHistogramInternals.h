@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageHistogramInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageHistogramInternals - Partial histograms for threads
+// .SECTION Description
+// This is a helper for the histogram filters.  Each thread counts into
+// its own partial histogram, which only covers the bins that the thread
+// has needed so far.  The partial histograms are then summed into the
+// final histogram with the bins divided among the threads, so that the
+// merge is done in parallel and without locks.
+
+#ifndef __vtkImageHistogramInternals_h
+#define __vtkImageHistogramInternals_h
+
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+//----------------------------------------------------------------------------
+// The bins counted by one thread.
+class vtkImageHistogramPartial
+{
+public:
+  vtkImageHistogramPartial() { this->Range[0] = 0; this->Range[1] = -1; }
+
+  // Make sure that the bins from lo to hi are present, and return a pointer
+  // that can be indexed by bin number.
+  vtkIdType *Require(vtkIdType lo, vtkIdType hi)
+  {
+    if (this->Range[0] > this->Range[1])
+      {
+      this->Bins.assign(hi - lo + 1, 0);
+      this->Range[0] = lo;
+      this->Range[1] = hi;
+      }
+    else if (lo < this->Range[0] || hi > this->Range[1])
+      {
+      lo = std::min(lo, this->Range[0]);
+      hi = std::max(hi, this->Range[1]);
+      std::vector<vtkIdType> bins(hi - lo + 1, 0);
+      std::copy(this->Bins.begin(), this->Bins.end(),
+                bins.begin() + (this->Range[0] - lo));
+      this->Bins.swap(bins);
+      this->Range[0] = lo;
+      this->Range[1] = hi;
+      }
+    return &this->Bins[0] - this->Range[0];
+  }
+
+  std::vector<vtkIdType> Bins;
+  vtkIdType Range[2];
+};
+
+//----------------------------------------------------------------------------
+// Sum the partial histograms into a range of the output bins.
+class vtkImageHistogramMergeFunctor
+{
+public:
+  vtkImageHistogramMergeFunctor(
+    vtkIdType *output,
+    const std::vector<const vtkImageHistogramPartial *> &partials)
+    : Output(output), Partials(partials) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::fill(this->Output + begin, this->Output + end, 0);
+    size_t n = this->Partials.size();
+    for (size_t j = 0; j < n; j++)
+      {
+      const vtkImageHistogramPartial *partial = this->Partials[j];
+      vtkIdType lo = std::max(begin, partial->Range[0]);
+      vtkIdType hi = std::min(end - 1, partial->Range[1]);
+      if (lo <= hi)
+        {
+        const vtkIdType *bins = &partial->Bins[0] - partial->Range[0];
+        for (vtkIdType i = lo; i <= hi; i++)
+          {
+          this->Output[i] += bins[i];
+          }
+        }
+      }
+  }
+
+private:
+  vtkIdType *Output;
+  const std::vector<const vtkImageHistogramPartial *> &Partials;
+};
+
+//----------------------------------------------------------------------------
+// Sum the partial histograms into an output histogram with n bins.
+void vtkImageHistogramMerge(
+  vtkIdType *output, vtkIdType n,
+  const std::vector<const vtkImageHistogramPartial *> &partials)
+{
+  vtkImageHistogramMergeFunctor functor(output, partials);
+  vtkSMPTools::For(0, n, 4096, functor);
+}
+
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImageHistogramInternals.h
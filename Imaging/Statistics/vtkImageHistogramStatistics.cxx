@@ -17,6 +17,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkIdTypeArray.h"
 
+#include <algorithm>
+
 #include <math.h>
 
 vtkStandardNewMacro(vtkImageHistogramStatistics);
@@ -40,11 +42,14 @@ vtkImageHistogramStatistics::vtkImageHistogramStatistics()
   this->AutoRangePercentiles[1] = 99;
   this->AutoRangeExpansionFactors[0] = 0.1;
   this->AutoRangeExpansionFactors[1] = 0.1;
+
+  this->CumulativeHistogram = vtkIdTypeArray::New();
 }
 
 //----------------------------------------------------------------------------
 vtkImageHistogramStatistics::~vtkImageHistogramStatistics()
 {
+  this->CumulativeHistogram->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -93,10 +98,13 @@ int vtkImageHistogramStatistics::RequestData(
   double mom2 = 0;
   int nx = this->Histogram->GetNumberOfTuples();
   vtkIdType *histogram = this->Histogram->GetPointer(0);
+  this->CumulativeHistogram->SetNumberOfTuples(nx);
+  vtkIdType *cumulative = this->CumulativeHistogram->GetPointer(0);
   for (int ix = 0; ix < nx; ++ix)
     {
     vtkIdType c = histogram[ix];
     sum += c;
+    cumulative[ix] = sum;
     double dc = static_cast<double>(c);
     mom1 += dc*ix;
     mom2 += dc*ix*ix;
@@ -168,3 +176,28 @@ int vtkImageHistogramStatistics::RequestData(
 
   return 1;
 }
+
+//----------------------------------------------------------------------------
+double vtkImageHistogramStatistics::GetPercentile(double percentile)
+{
+  vtkIdType n = this->CumulativeHistogram->GetNumberOfTuples();
+  vtkIdType *cumulative = this->CumulativeHistogram->GetPointer(0);
+  if (n == 0 || cumulative[n - 1] == 0)
+    {
+    return this->Minimum;
+    }
+
+  // the rank is computed the same way as for the median and the auto range
+  vtkIdType total = cumulative[n - 1];
+  double fraction = percentile*0.01;
+  fraction = (fraction > 0.0 ? fraction : 0.0);
+  vtkIdType rank = static_cast<vtkIdType>(total*fraction);
+
+  // like the median, find the last bin where the cumulative count is not
+  // greater than the rank, or the first bin if there is none
+  vtkIdType ix = std::upper_bound(cumulative, cumulative + n, rank) -
+    cumulative - 1;
+  ix = (ix > 0 ? ix : 0);
+
+  return ix*this->BinSpacing + this->BinOrigin;
+}
@@ -67,6 +67,15 @@ public:
   // computed when Update() is called.
   double GetStandardDeviation() { return this->StandardDeviation; }
 
+  // Description:
+  // Get the value at the given percentile, from 0 to 100.  This follows
+  // the same convention as the median and the AutoRange: the value is that
+  // of the last bin for which the number of samples in it and in the bins
+  // below it is not greater than percentile*0.01*Total, so GetPercentile(50)
+  // is equal to GetMedian().  A cumulative histogram is computed when
+  // Update() is called, so each call is a binary search of the bins.
+  double GetPercentile(double percentile);
+
   // Description:
   // Set the percentiles to use for automatic view range computation.
   // This allows one to compute a range that does not include outliers
@@ -114,6 +123,8 @@ protected:
   double AutoRangePercentiles[2];
   double AutoRangeExpansionFactors[2];
 
+  vtkIdTypeArray *CumulativeHistogram;
+
 private:
   vtkImageHistogramStatistics(const vtkImageHistogramStatistics&);  // Not implemented.
   void operator=(const vtkImageHistogramStatistics&);  // Not implemented.